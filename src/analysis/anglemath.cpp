@@ -0,0 +1,103 @@
+#include "anglemath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+}
+
+double norm0_360(double deg) {
+    double r = std::fmod(deg, 360.0);
+    if (r < 0) r += 360.0;
+    return r;
+}
+
+// wrap to (-180, 180]
+double wrapSigned180(double deg) {
+    double r = std::fmod(deg + 180.0, 360.0);
+    if (r <= 0) r += 360.0;
+    return r - 180.0;
+}
+
+// Circular mean in degrees, return [0,360)
+double circularMeanDeg(const std::vector<double>& angles) {
+    if (angles.empty()) return std::numeric_limits<double>::quiet_NaN();
+    double sx = 0.0, sy = 0.0;
+    for (double a : angles) {
+        double rad = a * kPi / 180.0;
+        sx += std::cos(rad);
+        sy += std::sin(rad);
+    }
+    double mean = std::atan2(sy, sx) * 180.0 / kPi; // [-180,180]
+    if (mean < 0) mean += 360.0;
+    return mean;
+}
+
+double robustCircularMeanDeg(const std::vector<double>& angles, std::size_t* usedCount) {
+    if (usedCount) *usedCount = angles.size();
+    if (angles.size() < 2) {
+        return angles.empty() ? std::numeric_limits<double>::quiet_NaN() : norm0_360(angles[0]);
+    }
+
+    // 先做一次圆均值
+    double mean0 = circularMeanDeg(angles);
+
+    // 用"最短角差"的绝对偏差做简单鲁棒过滤
+    double sumAbsDiff = 0.0;
+    for (double a : angles) sumAbsDiff += std::abs(wrapSigned180(a - mean0));
+    double mad = sumAbsDiff / angles.size();
+    double thr = std::max(5.0, 2.5 * mad); // 至少5°或2.5*MAD
+
+    std::vector<double> filtered;
+    filtered.reserve(angles.size());
+    for (double a : angles) {
+        double d = std::abs(wrapSigned180(a - mean0));
+        if (d <= thr) filtered.push_back(a);
+    }
+    if (filtered.size() < 2) filtered = angles; // 兜底
+
+    if (usedCount) *usedCount = filtered.size();
+    return circularMeanDeg(filtered);
+}
+
+int strokeDirectionFromDelta(double deltaDeg, double minStepDeg) {
+    if (std::abs(deltaDeg) <= minStepDeg) return 0;
+    return deltaDeg > 0 ? 1 : -1;
+}
+
+// Update unwrapped angle sequence from absolute [0,360) angle.
+// Returns shortest signed step (-180,180]
+double AngleTracker::update(double absDeg) {
+    absDeg = norm0_360(absDeg);
+    if (!m_hasUnwrapped) {
+        if (m_hasZero) {
+            // 对齐到离零位最近的一圈
+            double k = std::round((m_zeroUnwrapped - absDeg) / 360.0);
+            m_unwrapped = absDeg + 360.0 * k;
+        } else {
+            m_unwrapped = absDeg;
+        }
+        m_previousAbs = absDeg;
+        m_hasUnwrapped = true;
+        m_lastDelta = 0.0;
+        return 0.0;
+    }
+    double delta = wrapSigned180(absDeg - m_previousAbs);
+    m_unwrapped += delta;
+    m_previousAbs = absDeg;
+    m_lastDelta = delta;
+    return delta;
+}
+
+void AngleTracker::captureZero(double absDeg) {
+    update(absDeg);   // 初始化/对齐展开角序列
+    m_zeroUnwrapped = m_unwrapped;
+    m_zeroAbs = norm0_360(absDeg);
+    m_hasZero = true;
+}
+
+void AngleTracker::reset() {
+    *this = AngleTracker();
+}
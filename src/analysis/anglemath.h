@@ -0,0 +1,52 @@
+#ifndef ANGLEMATH_H
+#define ANGLEMATH_H
+
+#include <cstddef>
+#include <vector>
+
+// ================== 角度工具（识别核心库，不依赖Qt） ==================
+double norm0_360(double deg);                              // 归一化到 [0,360)
+double wrapSigned180(double deg);                          // 包裹到 (-180,180]
+double circularMeanDeg(const std::vector<double>& angles); // 圆统计均值（返回 [0,360)，空输入返回NaN）
+
+// 圆均值 + 一次"最短角差"绝对偏差剔除（阈值至少5°或2.5*MAD），返回 [0,360)
+// usedCount 可选：输出参与最终均值的样本数
+double robustCircularMeanDeg(const std::vector<double>& angles, std::size_t* usedCount = nullptr);
+
+// 根据一帧增量判定行程方向：1=正行程（顺时针），-1=反行程（逆时针），0=变化太小不判定
+int strokeDirectionFromDelta(double deltaDeg, double minStepDeg = 2.0);
+
+// —— 展开角（Unwrapped Angle）跟踪 ——
+// 持续更新"连续角"，避免在 0/360° 处跳变；相对角 = 展开角 - 归位时的展开角
+class AngleTracker {
+public:
+    // 用新的绝对角(0~360)更新展开角，返回本帧有符号增量（-180~180]
+    double update(double absDeg);
+
+    // 以当前绝对角为零位（相对角 0）
+    void captureZero(double absDeg);
+
+    // 只重置展开序列（保留零位），下一帧会按零位重新对齐到最近的一圈
+    void restartSequence() { m_hasUnwrapped = false; }
+
+    // 清空零位与展开序列
+    void reset();
+
+    bool   hasZero() const { return m_hasZero; }
+    double zeroAbs() const { return m_zeroAbs; }              // 仅用于显示（0~360）
+    double unwrapped() const { return m_unwrapped; }          // 当前帧的连续角（可为负/超360）
+    double zeroUnwrapped() const { return m_zeroUnwrapped; }  // 归位时的连续角
+    double lastDelta() const { return m_lastDelta; }          // 最近一次"最短路"角度增量
+    double relative() const { return m_unwrapped - m_zeroUnwrapped; }
+
+private:
+    bool   m_hasZero       = false;
+    double m_zeroAbs       = 0.0;
+    double m_unwrapped     = 0.0;
+    double m_zeroUnwrapped = 0.0;
+    double m_previousAbs   = 0.0;  // 上一帧的绝对角（0~360）
+    bool   m_hasUnwrapped  = false;
+    double m_lastDelta     = 0.0;
+};
+
+#endif // ANGLEMATH_H
@@ -0,0 +1,244 @@
+#include "autotune.h"
+#include "anglemath.h"
+#include "configio.h"
+#include "corelog.h"
+
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return {};
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+std::string dirOf(const std::string& path) {
+    size_t p = path.find_last_of("/\\");
+    return p == std::string::npos ? std::string() : path.substr(0, p + 1);
+}
+
+// 在 base 附近随机扰动。只采样当前流水线实际读取的参数：
+// 圆检测（HoughCircles）、直线回退（Canny + HoughLinesP）、指针最小长度
+PointerDetectionConfig sampleConfig(const PointerDetectionConfig& base, std::mt19937_64& rng) {
+    auto uni = [&rng](double lo, double hi) { return std::uniform_real_distribution<double>(lo, hi)(rng); };
+    auto uniInt = [&rng](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+
+    PointerDetectionConfig c = base;
+    c.dp = uni(1.0, 1.6);
+    c.param1 = uni(60, 160);
+    c.param2 = uni(15, 45);
+    c.minDist = uni(50, 200);
+    // 半径范围与相机视野有关，只在 base 的 ±30% 内调
+    c.minRadius = std::max(10, (int)std::lround(base.minRadius * uni(0.7, 1.3)));
+    if (base.maxRadius > 0) {
+        c.maxRadius = std::max(c.minRadius + 10, (int)std::lround(base.maxRadius * uni(0.7, 1.3)));
+    }
+
+    c.cannyLow = uni(20, 60);
+    c.cannyHigh = std::max(c.cannyLow + 20, uni(80, 180));
+    c.threshold = uniInt(20, 70);
+    c.minLineLength = uni(20, 90);
+    c.maxLineGap = uni(4, 20);
+    c.pointerMinLength = uniInt(30, 100);
+    return c;
+}
+
+bool dominates(const TuneScore& a, const TuneScore& b) {
+    bool noWorse = a.meanAbsErrDeg <= b.meanAbsErrDeg && a.failureRate <= b.failureRate && a.msPerFrame <= b.msPerFrame;
+    bool better = a.meanAbsErrDeg < b.meanAbsErrDeg || a.failureRate < b.failureRate || a.msPerFrame < b.msPerFrame;
+    return noWorse && better;
+}
+
+} // namespace
+
+std::vector<LabelledFrame> loadLabelledFrames(const std::string& labelsCsv) {
+    std::vector<LabelledFrame> frames;
+    std::ifstream in(labelsCsv);
+    if (!in) {
+        coreDebug() << "无法打开标注文件:" << labelsCsv;
+        return frames;
+    }
+
+    const std::string baseDir = dirOf(labelsCsv);
+    std::string line;
+    while (std::getline(in, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        size_t comma = line.find(',');
+        if (comma == std::string::npos) continue;
+
+        LabelledFrame f;
+        f.name = trim(line.substr(0, comma));
+        std::istringstream ss(line.substr(comma + 1));
+        if (!(ss >> f.angleDeg)) continue;  // 表头或格式不对的行
+
+        f.image = cv::imread(baseDir + f.name, cv::IMREAD_COLOR);
+        if (f.image.empty()) {
+            coreDebug() << "读取图像失败:" << f.name;
+            continue;
+        }
+        f.angleDeg = norm0_360(f.angleDeg);
+        frames.push_back(std::move(f));
+    }
+    coreDebug() << "载入标注图像" << frames.size() << "张";
+    return frames;
+}
+
+TuneScore evaluateConfig(const std::vector<LabelledFrame>& frames, const PointerDetectionConfig& config, double failErrDeg) {
+    TuneScore score;
+    if (frames.empty()) return score;
+
+    int failures = 0, ok = 0;
+    double errSum = 0.0;
+    const int64 t0 = cv::getTickCount();
+    for (const auto& f : frames) {
+        highPreciseDetector det(f.image, &config);
+        double a = det.getAngle();
+        double err = (a == -999) ? 1e9 : std::abs(wrapSigned180(a - f.angleDeg));
+        if (err > failErrDeg) {
+            ++failures;
+        } else {
+            errSum += err;
+            ++ok;
+        }
+    }
+    const double ms = (cv::getTickCount() - t0) * 1000.0 / cv::getTickFrequency();
+
+    score.failureRate = double(failures) / frames.size();
+    score.meanAbsErrDeg = ok > 0 ? errSum / ok : failErrDeg;
+    score.msPerFrame = ms / frames.size();
+    return score;
+}
+
+std::vector<TuneCandidate> randomSearch(const std::vector<LabelledFrame>& frames, const PointerDetectionConfig& base,
+                                        int iterations, std::uint64_t seed) {
+    iterations = std::max(1, iterations);
+    std::vector<TuneCandidate> candidates(iterations);
+
+    // 先串行采样（结果只取决于 seed），再并行评估
+    std::mt19937_64 rng(seed);
+    candidates[0].config = base;
+    for (int i = 1; i < iterations; ++i) {
+        candidates[i].config = sampleConfig(base, rng);
+    }
+
+    cv::parallel_for_(cv::Range(0, iterations), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; ++i) {
+            candidates[i].score = evaluateConfig(frames, candidates[i].config);
+        }
+    });
+
+    // 并行评估时各组抢同一批核，测出的耗时随线程数和调度变化，不能拿来比；逐组单独再测一遍
+    for (auto& c : candidates) {
+        c.score.msPerFrame = timeConfig(frames, c.config);
+    }
+    return candidates;
+}
+
+double timeConfig(const std::vector<LabelledFrame>& frames, const PointerDetectionConfig& config, int maxFrames) {
+    if (frames.empty()) return 0.0;
+    const int n = std::max(1, std::min<int>(maxFrames, (int)frames.size()));
+    const int64 t0 = cv::getTickCount();
+    for (int k = 0; k < n; ++k) {
+        highPreciseDetector det(frames[size_t(k) * frames.size() / n].image, &config);
+    }
+    return (cv::getTickCount() - t0) * 1000.0 / cv::getTickFrequency() / n;
+}
+
+std::vector<TuneCandidate> paretoFront(const std::vector<TuneCandidate>& candidates) {
+    std::vector<TuneCandidate> front;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        bool dominated = false;
+        for (size_t j = 0; j < candidates.size() && !dominated; ++j) {
+            dominated = (i != j) && dominates(candidates[j].score, candidates[i].score);
+        }
+        if (!dominated) front.push_back(candidates[i]);
+    }
+    std::sort(front.begin(), front.end(), [](const TuneCandidate& a, const TuneCandidate& b) {
+        if (a.score.meanAbsErrDeg != b.score.meanAbsErrDeg) return a.score.meanAbsErrDeg < b.score.meanAbsErrDeg;
+        return a.score.failureRate < b.score.failureRate;
+    });
+    return front;
+}
+
+int selectTunedConfig(const std::vector<TuneCandidate>& front, double maxFailureRate, double maxMsPerFrame) {
+    int best = -1;
+    for (int i = 0; i < (int)front.size(); ++i) {
+        const TuneScore& s = front[i].score;
+        if (s.failureRate > maxFailureRate) continue;
+        if (maxMsPerFrame > 0 && s.msPerFrame > maxMsPerFrame) continue;
+        if (best < 0 || s.meanAbsErrDeg < front[best].score.meanAbsErrDeg) best = i;
+    }
+    if (best >= 0) return best;
+
+    // 都不满足：宁可选最稳的，也不要误差最小但大半帧都失败的
+    for (int i = 0; i < (int)front.size(); ++i) {
+        const TuneScore& s = front[i].score;
+        if (best < 0 || s.failureRate < front[best].score.failureRate
+            || (s.failureRate == front[best].score.failureRate && s.meanAbsErrDeg < front[best].score.meanAbsErrDeg)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+bool writeParetoFront(const std::string& path, const std::vector<TuneCandidate>& front, int selected) {
+    cv::FileStorage fs(path, cv::FileStorage::WRITE);
+    if (!fs.isOpened()) return false;
+
+    fs << "selected" << selected;
+    fs << "front" << "[";
+    for (const auto& c : front) {
+        fs << "{";
+        fs << "meanAbsErrDeg" << c.score.meanAbsErrDeg
+           << "failureRate" << c.score.failureRate
+           << "msPerFrame" << c.score.msPerFrame;
+        fs << "config" << "{";
+        writePointerConfig(fs, c.config);
+        fs << "}";
+        fs << "}";
+    }
+    fs << "]";
+    return true;
+}
+
+bool loadParetoFront(const std::string& path, std::vector<TuneCandidate>& front, int& selected) {
+    front.clear();
+    selected = -1;
+    cv::FileStorage fs;
+    try {
+        if (!fs.open(path, cv::FileStorage::READ)) return false;
+    } catch (const cv::Exception& e) {
+        coreDebug() << "读取调参结果失败:" << e.what();
+        return false;
+    }
+
+    cv::FileNode list = fs["front"];
+    if (list.empty() || !list.isSeq()) return false;
+    for (const auto& node : list) {
+        TuneCandidate c;
+        cv::FileNode cfg = node["config"];
+        DialKind kind = PointerDetectionConfig().kind;
+        if (!cfg.empty() && cfg["kind"].isString()) dialKindFromName((std::string)cfg["kind"], kind);
+        c.config = (kind == DialKind::BYQ) ? BYQPipeline::defaultConfig() : YYQYPipeline::defaultConfig();
+        if (!readPointerConfig(cfg, c.config)) continue;
+        c.score.meanAbsErrDeg = (double)node["meanAbsErrDeg"];
+        c.score.failureRate = (double)node["failureRate"];
+        c.score.msPerFrame = (double)node["msPerFrame"];
+        front.push_back(c);
+    }
+    if (front.empty()) return false;
+
+    cv::FileNode sel = fs["selected"];
+    if (!sel.empty() && sel.isInt()) selected = (int)sel;
+    if (selected < 0 || selected >= (int)front.size()) selected = selectTunedConfig(front);
+    return true;
+}
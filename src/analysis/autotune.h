@@ -0,0 +1,60 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "pointerdetector.h"
+
+// ================== 指针识别参数自动调参 ==================
+// 在带标注的图像集上随机搜索 PointerDetectionConfig，
+// 按 精度 / 失败率 / 单帧耗时 三个指标取 Pareto 前沿，结果写成 json 供主程序加载。
+
+struct LabelledFrame {
+    std::string name;       // 文件名（仅用于日志）
+    cv::Mat image;          // BGR 图像
+    double angleDeg = 0.0;  // 标注的指针绝对角（0~360，与 highPreciseDetector::getAngle 同一定义）
+};
+
+struct TuneScore {
+    double meanAbsErrDeg = 0.0;  // 成功帧的平均角度误差（最短角差）
+    double failureRate = 1.0;    // 失败帧比例（检测不到或误差超过 failErrDeg）
+    double msPerFrame = 0.0;     // 平均单帧耗时
+};
+
+struct TuneCandidate {
+    PointerDetectionConfig config;
+    TuneScore score;
+};
+
+// 读取标注文件：每行 "文件名,角度"，文件名相对标注文件所在目录；# 开头为注释
+std::vector<LabelledFrame> loadLabelledFrames(const std::string& labelsCsv);
+
+// 用一组参数跑完整个图像集；误差超过 failErrDeg 的帧也算失败。
+// msPerFrame 是这次调用里的实测耗时，只有在没有别的检测同时运行时才有意义
+TuneScore evaluateConfig(const std::vector<LabelledFrame>& frames, const PointerDetectionConfig& config,
+                         double failErrDeg = 10.0);
+
+// 单独计时：串行跑最多 maxFrames 帧（均匀抽取），返回平均单帧耗时（ms）
+double timeConfig(const std::vector<LabelledFrame>& frames, const PointerDetectionConfig& config, int maxFrames = 32);
+
+// 以 base 为中心随机采样 iterations 组参数（第0组就是 base 本身）。
+// 精度和失败率各组并行评估；耗时在并行评估结束后逐组串行单独测，不受其他候选抢核影响
+std::vector<TuneCandidate> randomSearch(const std::vector<LabelledFrame>& frames, const PointerDetectionConfig& base,
+                                        int iterations, std::uint64_t seed = 0);
+
+// 三个指标都越小越好；返回不被其他候选支配的集合，按误差、失败率排序
+std::vector<TuneCandidate> paretoFront(const std::vector<TuneCandidate>& candidates);
+
+// 从前沿里选主程序用的那组：失败率不超过 maxFailureRate（maxMsPerFrame > 0 时耗时也不超过它）的候选中误差最小的；
+// 没有满足条件的就取失败率最低的（再比误差）。front 为空返回 -1
+int selectTunedConfig(const std::vector<TuneCandidate>& front, double maxFailureRate = 0.05, double maxMsPerFrame = 0.0);
+
+// Pareto 前沿读写（cv::FileStorage，扩展名决定格式，建议 .json）；selected 是选中那组在前沿里的下标，
+// 读到没有 selected 的旧文件时按 selectTunedConfig 的默认条件补选
+bool writeParetoFront(const std::string& path, const std::vector<TuneCandidate>& front, int selected);
+bool loadParetoFront(const std::string& path, std::vector<TuneCandidate>& front, int& selected);
+
+#endif // AUTOTUNE_H
@@ -0,0 +1,141 @@
+#include "circularstats.h"
+#include "anglemath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kDeg2Rad = kPi / 180.0;
+constexpr double kRad2Deg = 180.0 / kPi;
+// 正态分布下 E|x| = σ*sqrt(2/π)，平均绝对残差折算成 σ
+constexpr double kMeanAbsToSigma = 1.2533141373155;
+}
+
+CircularWindowStats::CircularWindowStats(std::size_t window) : m_window(std::max<std::size_t>(1, window)) {
+    m_ring.resize(m_window);
+}
+
+void CircularWindowStats::setWindow(std::size_t window) {
+    m_window = std::max<std::size_t>(1, window);
+    m_ring.assign(m_window, Sample());
+    clear();
+}
+
+void CircularWindowStats::clear() {
+    m_head = 0;
+    m_count = 0;
+    m_sinceRecompute = 0;
+    m_sumC = m_sumS = 0.0;
+    m_sumWC = m_sumWS = m_sumW = 0.0;
+    m_sumAbsRes = 0.0;
+    m_inliers = 0;
+    m_resCount = 0;
+    m_outlierRun = 0;
+    m_lastOutlier = false;
+    m_lastResidual = 0.0;
+}
+
+void CircularWindowStats::add(const Sample& smp, int sign) {
+    m_sumC += sign * smp.c;
+    m_sumS += sign * smp.s;
+    m_sumWC += sign * smp.w * smp.c;
+    m_sumWS += sign * smp.w * smp.s;
+    m_sumW += sign * smp.w;
+    m_sumAbsRes += sign * smp.absRes;
+    if (smp.hasResidual) m_resCount = (sign > 0) ? m_resCount + 1 : m_resCount - 1;
+    if (smp.inlier) m_inliers = (sign > 0) ? m_inliers + 1 : m_inliers - 1;
+}
+
+void CircularWindowStats::recompute() {
+    m_sumC = m_sumS = m_sumWC = m_sumWS = m_sumW = m_sumAbsRes = 0.0;
+    m_inliers = 0;
+    m_resCount = 0;
+    for (std::size_t k = 0; k < m_count; ++k) {
+        add(m_ring[(m_head + m_window - m_count + k) % m_window], +1);
+    }
+    m_sinceRecompute = 0;
+}
+
+bool CircularWindowStats::push(double angleDeg) {
+    const double rad = norm0_360(angleDeg) * kDeg2Rad;
+    Sample smp;
+    smp.c = std::cos(rad);
+    smp.s = std::sin(rad);
+
+    // 用入窗前的估计判定残差；窗口里样本太少时不判离群
+    double residual = 0.0;
+    bool outlier = false;
+    if (m_count >= 2) {
+        residual = wrapSigned180(angleDeg - robustMeanDeg());
+        const double absRes = std::abs(residual);
+        const double scale = robustScaleDeg();
+        const double outlierThr = std::max(minOutlierDeg, outlierK * scale);
+        outlier = absRes > outlierThr;
+
+        const double huberC = huberK * scale;
+        smp.w = outlier ? 0.0 : (absRes <= huberC ? 1.0 : huberC / absRes);
+        smp.absRes = std::min(absRes, outlierThr);  // 截断，离群点不把尺度撑大
+        smp.hasResidual = true;
+    } else {
+        smp.w = 1.0;
+    }
+    smp.inlier = !outlier;
+
+    // 连续离群超过半个窗口：认为指针已经移到新位置，从最近的样本重新起算
+    m_outlierRun = outlier ? m_outlierRun + 1 : 0;
+    if (outlier && m_outlierRun >= std::max<std::size_t>(3, m_window / 2)) {
+        clear();
+        return push(angleDeg);
+    }
+
+    if (m_count == m_window) {
+        add(m_ring[m_head], -1);
+    } else {
+        ++m_count;
+    }
+    m_ring[m_head] = smp;
+    add(smp, +1);
+    m_head = (m_head + 1) % m_window;
+
+    if (++m_sinceRecompute >= 16 * m_window) recompute();
+
+    m_lastOutlier = outlier;
+    m_lastResidual = residual;
+    return outlier;
+}
+
+double CircularWindowStats::meanDeg() const {
+    if (m_count == 0) return std::numeric_limits<double>::quiet_NaN();
+    return norm0_360(std::atan2(m_sumS, m_sumC) * kRad2Deg);
+}
+
+double CircularWindowStats::resultantLength() const {
+    if (m_count == 0) return 0.0;
+    return std::min(1.0, std::hypot(m_sumC, m_sumS) / m_count);
+}
+
+double CircularWindowStats::variance() const {
+    return m_count == 0 ? std::numeric_limits<double>::quiet_NaN() : 1.0 - resultantLength();
+}
+
+double CircularWindowStats::stdDevDeg() const {
+    if (m_count == 0) return std::numeric_limits<double>::quiet_NaN();
+    const double r = resultantLength();
+    if (r <= 1e-12) return std::numeric_limits<double>::infinity();
+    return std::sqrt(std::max(0.0, -2.0 * std::log(r))) * kRad2Deg;
+}
+
+double CircularWindowStats::robustMeanDeg() const {
+    if (m_count == 0) return std::numeric_limits<double>::quiet_NaN();
+    if (m_sumW <= 1e-9 || std::hypot(m_sumWC, m_sumWS) <= 1e-12) return meanDeg();
+    return norm0_360(std::atan2(m_sumWS, m_sumWC) * kRad2Deg);
+}
+
+double CircularWindowStats::robustScaleDeg() const {
+    if (m_resCount > 0) return std::max(minScaleDeg, kMeanAbsToSigma * m_sumAbsRes / m_resCount);
+    // 还没有残差样本（窗口里只有开头两个）：用圆标准差兜底
+    const double sd = m_count >= 2 ? stdDevDeg() : 0.0;
+    return std::max(minScaleDeg, std::isfinite(sd) ? std::min(sd, 180.0) : 180.0);
+}
@@ -0,0 +1,77 @@
+#ifndef CIRCULARSTATS_H
+#define CIRCULARSTATS_H
+
+#include <cstddef>
+#include <vector>
+
+// ================== 滑动窗口圆统计（流式，O(1) 更新） ==================
+// 保存最近 window 个角度样本，维护 sin/cos 累加和：
+//   - 圆均值 / 圆方差(1-R) / 圆标准差 sqrt(-2lnR)
+//   - 鲁棒 M 估计：样本入窗时按相对当前估计的残差给 Huber 权重（离群点权重 0），
+//     权重随样本一起保存，出窗时原样减掉，不回扫历史
+//   - 离群判定：残差超过 max(minOutlierDeg, outlierK*鲁棒尺度)，与 robustCircularMeanDeg 的阈值口径一致
+// 连续离群太多（指针真的移动了）会以最近的样本重新起算，避免估计卡在旧位置。
+// 有状态：结果取决于之前 push 过哪些样本、以什么顺序，每路数据（每个表位、实时预览）各自持有一个实例；
+// 单帧测量 measurePointerAngle 不经过这里。
+
+class CircularWindowStats {
+public:
+    explicit CircularWindowStats(std::size_t window = 15);
+
+    void setWindow(std::size_t window);   // 会清空已有样本
+    std::size_t window() const { return m_window; }
+    std::size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    void clear();
+
+    // 加入一个绝对角(任意范围，内部归一化)，返回该样本是否被判为离群
+    bool push(double angleDeg);
+
+    double meanDeg() const;          // 圆均值 [0,360)，空时 NaN
+    double resultantLength() const;  // 平均合成向量长度 R (0~1)
+    double variance() const;         // 圆方差 1-R (0~1)
+    double stdDevDeg() const;        // 圆标准差（度）
+
+    double robustMeanDeg() const;    // M 估计 [0,360)，没有有效权重时退回圆均值
+    double robustScaleDeg() const;   // 鲁棒尺度（残差平均绝对值折算成 σ）
+    std::size_t inlierCount() const { return m_inliers; }
+
+    bool lastOutlier() const { return m_lastOutlier; }
+    double lastResidualDeg() const { return m_lastResidual; }  // 最近样本相对入窗前估计的残差
+
+    // 参数：离群阈值 = max(minOutlierDeg, outlierK*尺度)；Huber 拐点 = huberK*尺度
+    double outlierK = 2.5;
+    double minOutlierDeg = 5.0;
+    double huberK = 1.5;
+    double minScaleDeg = 0.1;        // 尺度下限，防止样本完全一致时权重退化
+
+private:
+    struct Sample {
+        double c = 0.0, s = 0.0;     // cos / sin
+        double w = 0.0;              // M 估计权重
+        double absRes = 0.0;         // 截断后的残差绝对值（用于尺度）
+        bool inlier = true;
+        bool hasResidual = false;    // 入窗时窗口里已有 >=2 个样本，才有残差
+    };
+
+    void add(const Sample& smp, int sign);
+    void recompute();               // 重新求和，消除浮点累积误差
+
+    std::size_t m_window;
+    std::vector<Sample> m_ring;
+    std::size_t m_head = 0;          // 下一个写入位置
+    std::size_t m_count = 0;
+    std::size_t m_sinceRecompute = 0;
+
+    double m_sumC = 0.0, m_sumS = 0.0;
+    double m_sumWC = 0.0, m_sumWS = 0.0, m_sumW = 0.0;
+    double m_sumAbsRes = 0.0;
+    std::size_t m_inliers = 0;
+    std::size_t m_resCount = 0;
+    std::size_t m_outlierRun = 0;
+
+    bool m_lastOutlier = false;
+    double m_lastResidual = 0.0;
+};
+
+#endif // CIRCULARSTATS_H
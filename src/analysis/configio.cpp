@@ -0,0 +1,92 @@
+#include "configio.h"
+
+namespace {
+template <typename T>
+void readField(const cv::FileNode& node, const char* name, T& value) {
+    cv::FileNode n = node[name];
+    if (!n.empty() && n.isReal()) value = static_cast<T>((double)n);
+    else if (!n.empty() && n.isInt()) value = static_cast<T>((int)n);
+}
+}
+
+const char* dialKindName(DialKind kind) {
+    return kind == DialKind::BYQ ? "BYQ" : "YYQY";
+}
+
+bool dialKindFromName(const std::string& name, DialKind& kind) {
+    if (name == "YYQY" || name == "YYQY-13") {
+        kind = DialKind::YYQY;
+        return true;
+    }
+    if (name == "BYQ" || name == "BYQ-19") {
+        kind = DialKind::BYQ;
+        return true;
+    }
+    return false;
+}
+
+void writePointerConfig(cv::FileStorage& fs, const PointerDetectionConfig& c) {
+    fs << "kind" << dialKindName(c.kind);
+
+    // 圆形检测参数
+    fs << "dp" << c.dp << "minDist" << c.minDist << "param1" << c.param1 << "param2" << c.param2
+       << "minRadius" << c.minRadius << "maxRadius" << c.maxRadius;
+    // 直线检测参数
+    fs << "rho" << c.rho << "theta" << c.theta << "threshold" << c.threshold
+       << "minLineLength" << c.minLineLength << "maxLineGap" << c.maxLineGap;
+    // Canny边缘检测参数
+    fs << "cannyLow" << c.cannyLow << "cannyHigh" << c.cannyHigh;
+    // 指针识别特定参数
+    fs << "pointerSearchRadius" << c.pointerSearchRadius
+       << "pointerMinLength" << c.pointerMinLength << "angleOffset" << c.angleOffset;
+    // BYQ指针检测参数
+    fs << "pointerMaskRadius" << c.pointerMaskRadius << "axisExcludeMultiplier" << c.axisExcludeMultiplier
+       << "morphKernelWidth" << c.morphKernelWidth << "morphKernelHeight" << c.morphKernelHeight
+       << "gaussianKernelSize" << c.gaussianKernelSize << "gaussianSigma" << c.gaussianSigma
+       << "cannyLowThreshold" << c.cannyLowThreshold << "cannyHighThreshold" << c.cannyHighThreshold
+       << "houghThreshold" << c.houghThreshold << "minLineLengthRatio" << c.minLineLengthRatio
+       << "maxLineGapRatio" << c.maxLineGapRatio;
+}
+
+bool readPointerConfig(const cv::FileNode& node, PointerDetectionConfig& c) {
+    if (node.empty() || !node.isMap()) return false;
+
+    cv::FileNode kindNode = node["kind"];
+    if (!kindNode.empty() && kindNode.isString()) {
+        dialKindFromName((std::string)kindNode, c.kind);
+    }
+
+    readField(node, "dp", c.dp);
+    readField(node, "minDist", c.minDist);
+    readField(node, "param1", c.param1);
+    readField(node, "param2", c.param2);
+    readField(node, "minRadius", c.minRadius);
+    readField(node, "maxRadius", c.maxRadius);
+
+    readField(node, "rho", c.rho);
+    readField(node, "theta", c.theta);
+    readField(node, "threshold", c.threshold);
+    readField(node, "minLineLength", c.minLineLength);
+    readField(node, "maxLineGap", c.maxLineGap);
+
+    readField(node, "cannyLow", c.cannyLow);
+    readField(node, "cannyHigh", c.cannyHigh);
+
+    // 旧文件里的 usePointerFromCenter 忽略：检测阶段由流水线类型决定
+    readField(node, "pointerSearchRadius", c.pointerSearchRadius);
+    readField(node, "pointerMinLength", c.pointerMinLength);
+    readField(node, "angleOffset", c.angleOffset);
+
+    readField(node, "pointerMaskRadius", c.pointerMaskRadius);
+    readField(node, "axisExcludeMultiplier", c.axisExcludeMultiplier);
+    readField(node, "morphKernelWidth", c.morphKernelWidth);
+    readField(node, "morphKernelHeight", c.morphKernelHeight);
+    readField(node, "gaussianKernelSize", c.gaussianKernelSize);
+    readField(node, "gaussianSigma", c.gaussianSigma);
+    readField(node, "cannyLowThreshold", c.cannyLowThreshold);
+    readField(node, "cannyHighThreshold", c.cannyHighThreshold);
+    readField(node, "houghThreshold", c.houghThreshold);
+    readField(node, "minLineLengthRatio", c.minLineLengthRatio);
+    readField(node, "maxLineGapRatio", c.maxLineGapRatio);
+    return true;
+}
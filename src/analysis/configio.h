@@ -0,0 +1,20 @@
+#ifndef CONFIGIO_H
+#define CONFIGIO_H
+
+#include <opencv2/core.hpp>
+#include <string>
+
+#include "pointerdetector.h"
+
+// PointerDetectionConfig 的读写（cv::FileStorage，支持 .json/.yml）
+
+const char* dialKindName(DialKind kind);                         // "YYQY" / "BYQ"
+bool dialKindFromName(const std::string& name, DialKind& kind);
+
+// 写成一个 map 节点：fs << "config" << "{"; writePointerConfig(fs, c); fs << "}";
+void writePointerConfig(cv::FileStorage& fs, const PointerDetectionConfig& config);
+
+// 从 map 节点读取；缺少的字段保留 config 里原来的值（可以先填默认配置再读）
+bool readPointerConfig(const cv::FileNode& node, PointerDetectionConfig& config);
+
+#endif // CONFIGIO_H
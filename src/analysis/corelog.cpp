@@ -0,0 +1,33 @@
+#include "corelog.h"
+
+#include <atomic>
+
+namespace {
+std::atomic<CoreLogSink> g_sink{nullptr};
+thread_local bool t_muted = false;
+}
+
+void setCoreLogSink(CoreLogSink sink)
+{
+    g_sink.store(sink, std::memory_order_release);
+}
+
+CoreLogSink coreLogSink()
+{
+    return g_sink.load(std::memory_order_acquire);
+}
+
+CoreLogMute::CoreLogMute(bool on) : m_prev(t_muted)
+{
+    if (on) t_muted = true;
+}
+
+CoreLogMute::~CoreLogMute()
+{
+    t_muted = m_prev;
+}
+
+bool coreLogMuted()
+{
+    return t_muted;
+}
@@ -0,0 +1,55 @@
+#ifndef CORELOG_H
+#define CORELOG_H
+
+#include <sstream>
+#include <string>
+
+// 识别核心库的日志接口（不依赖Qt）
+// 用法与 qDebug() 相同：coreDebug() << "半径:" << r;
+// 未安装输出函数时不做任何格式化，避免拖慢检测热路径
+using CoreLogSink = void (*)(const std::string& message);
+
+void setCoreLogSink(CoreLogSink sink);  // 安装输出函数（传 nullptr 关闭日志）
+CoreLogSink coreLogSink();
+
+// 只让当前线程静音（后台探测不刷识别日志），不影响其他线程；on=false 时什么都不做
+class CoreLogMute {
+public:
+    explicit CoreLogMute(bool on = true);
+    ~CoreLogMute();
+    CoreLogMute(const CoreLogMute&) = delete;
+    CoreLogMute& operator=(const CoreLogMute&) = delete;
+
+private:
+    bool m_prev;
+};
+bool coreLogMuted();  // 当前线程是否静音
+
+class CoreLogLine {
+public:
+    CoreLogLine() : m_sink(coreLogMuted() ? nullptr : coreLogSink()) {}
+    CoreLogLine(const CoreLogLine&) = delete;
+    CoreLogLine& operator=(const CoreLogLine&) = delete;
+    ~CoreLogLine() {
+        if (m_sink) m_sink(m_stream.str());
+    }
+
+    template <typename T>
+    CoreLogLine& operator<<(const T& value) {
+        if (m_sink) {
+            if (!m_first) m_stream << ' ';  // 与qDebug一致，各项之间以空格分隔
+            m_stream << value;
+            m_first = false;
+        }
+        return *this;
+    }
+
+private:
+    CoreLogSink m_sink;
+    std::ostringstream m_stream;
+    bool m_first = true;
+};
+
+inline CoreLogLine coreDebug() { return {}; }
+
+#endif // CORELOG_H
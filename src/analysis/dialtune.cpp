@@ -0,0 +1,80 @@
+// 指针识别参数离线调参工具
+// 用法: dial_tune <YYQY|BYQ> <labels.csv> <out.json> [--iters N] [--seed S] [--max-fail R] [--max-ms M]
+//   labels.csv 每行 "文件名,角度"（文件名相对 labels.csv 所在目录）
+//   out.json   Pareto 前沿和选中的那组（失败率不超过 R、耗时不超过 M 的候选中误差最小的，默认 R=0.05、M 不限），
+//              放到 文档/PointerTuning_<类型>.json 主程序启动时会自动加载选中的那组
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "autotune.h"
+#include "configio.h"
+#include "corelog.h"
+
+static void printUsage() {
+    std::cerr << "usage: dial_tune <YYQY|BYQ> <labels.csv> <out.json> [--iters N] [--seed S] [--max-fail R] [--max-ms M]\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        printUsage();
+        return 1;
+    }
+
+    DialKind kind;
+    if (!dialKindFromName(argv[1], kind)) {
+        printUsage();
+        return 1;
+    }
+    const std::string labels = argv[2];
+    const std::string outPath = argv[3];
+
+    int iters = 200;
+    unsigned long long seed = 0;
+    double maxFail = 0.05, maxMs = 0.0;
+    for (int i = 4; i + 1 < argc; i += 2) {
+        std::string opt = argv[i];
+        if (opt == "--iters") iters = std::atoi(argv[i + 1]);
+        else if (opt == "--seed") seed = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (opt == "--max-fail") maxFail = std::atof(argv[i + 1]);
+        else if (opt == "--max-ms") maxMs = std::atof(argv[i + 1]);
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // 载入阶段打印日志；搜索阶段检测器会刷大量日志，关掉
+    setCoreLogSink([](const std::string& msg) { std::cerr << msg << "\n"; });
+    std::vector<LabelledFrame> frames = loadLabelledFrames(labels);
+    setCoreLogSink(nullptr);
+    if (frames.empty()) {
+        std::cerr << "no labelled frames loaded\n";
+        return 1;
+    }
+
+    const PointerDetectionConfig base =
+        (kind == DialKind::BYQ) ? BYQPipeline::defaultConfig() : YYQYPipeline::defaultConfig();
+
+    std::cerr << "searching " << iters << " configs on " << frames.size() << " frames...\n";
+    std::vector<TuneCandidate> all = randomSearch(frames, base, iters, seed);
+    std::vector<TuneCandidate> front = paretoFront(all);
+
+    const TuneScore& def = all.front().score;
+    std::printf("default : err %.3f deg  fail %.1f%%  %.2f ms/frame\n",
+                def.meanAbsErrDeg, def.failureRate * 100.0, def.msPerFrame);
+    const int selected = selectTunedConfig(front, maxFail, maxMs);
+    for (size_t i = 0; i < front.size(); ++i) {
+        const TuneScore& s = front[i].score;
+        std::printf("front[%zu]: err %.3f deg  fail %.1f%%  %.2f ms/frame%s\n",
+                    i, s.meanAbsErrDeg, s.failureRate * 100.0, s.msPerFrame, int(i) == selected ? "  <- selected" : "");
+    }
+
+    if (!writeParetoFront(outPath, front, selected)) {
+        std::cerr << "failed to write " << outPath << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include "measurementstore.h"
+
+#include <algorithm>
+#include <cmath>
+
+void MeasurementStore::reset(int points, int rounds)
+{
+    m_points = std::max(0, points);
+    m_rounds = std::max(0, rounds);
+    const int cells = m_points * m_rounds * StrokeCount;
+    m_angles.assign(cells, 0.0);
+    m_valid.assign((cells + 63) / 64, 0);
+    m_maxAngles.assign(m_rounds, 0.0);
+    m_maxValid.assign(m_rounds, 0);
+    m_maxCount = 0;
+    m_rowCount.assign(m_rounds * StrokeCount, 0);
+    m_pairSum.assign(m_points, 0.0);
+    m_pairCount.assign(m_points, 0);
+    m_cellsWithData = 0;
+    m_validCount = 0;
+    // 版本号不清零，保证 reset 之后的摘要和之前不同
+    m_roundVersion.resize(m_rounds, 0);
+    for (auto& v : m_roundVersion) ++v;
+}
+
+void MeasurementStore::setBit(int i, bool on)
+{
+    const std::uint64_t mask = std::uint64_t(1) << (i & 63);
+    if (on) {
+        m_valid[i >> 6] |= mask;
+    } else {
+        m_valid[i >> 6] &= ~mask;
+    }
+}
+
+bool MeasurementStore::valid(int point, int round, int stroke) const
+{
+    if (point < 0 || point >= m_points || round < 0 || round >= m_rounds) return false;
+    return bit(index(point, round, stroke));
+}
+
+void MeasurementStore::unaccount(int point, int round)
+{
+    if (bit(index(point, round, Forward)) || bit(index(point, round, Backward))) --m_cellsWithData;
+}
+
+void MeasurementStore::account(int point, int round)
+{
+    if (bit(index(point, round, Forward)) || bit(index(point, round, Backward))) ++m_cellsWithData;
+}
+
+void MeasurementStore::refreshPair(int point)
+{
+    // 轮数只有几轮，每次重加一遍；增减累加会残留舍入误差，同样的数据换个录入顺序（或回放）平均值就差最后几位
+    double sum = 0.0;
+    int count = 0;
+    for (int r = 0; r < m_rounds; ++r) {
+        const int f = index(point, r, Forward);
+        const int b = index(point, r, Backward);
+        if (bit(f) && bit(b)) {
+            sum += 0.5 * (m_angles[f] + m_angles[b]);
+            ++count;
+        }
+    }
+    m_pairSum[point] = sum;
+    m_pairCount[point] = count;
+}
+
+void MeasurementStore::set(int point, int round, int stroke, double angleDeg)
+{
+    if (point < 0 || point >= m_points || round < 0 || round >= m_rounds) return;
+    const int i = index(point, round, stroke);
+    const bool was = bit(i);
+    if (was && m_angles[i] == angleDeg) return;
+
+    unaccount(point, round);
+    m_angles[i] = angleDeg;
+    setBit(i, true);
+    if (!was) {
+        ++m_rowCount[round * StrokeCount + stroke];
+        ++m_validCount;
+    }
+    account(point, round);
+    refreshPair(point);
+    ++m_roundVersion[round];
+}
+
+void MeasurementStore::clear(int point, int round, int stroke)
+{
+    if (point < 0 || point >= m_points || round < 0 || round >= m_rounds) return;
+    const int i = index(point, round, stroke);
+    if (!bit(i)) return;
+
+    unaccount(point, round);
+    m_angles[i] = 0.0;
+    setBit(i, false);
+    --m_rowCount[round * StrokeCount + stroke];
+    --m_validCount;
+    account(point, round);
+    refreshPair(point);
+    ++m_roundVersion[round];
+}
+
+void MeasurementStore::clearRound(int round)
+{
+    if (round < 0 || round >= m_rounds) return;
+    for (int p = 0; p < m_points; ++p) {
+        clear(p, round, Forward);
+        clear(p, round, Backward);
+    }
+    setMaxAngle(round, 0.0);
+    ++m_roundVersion[round];
+}
+
+void MeasurementStore::setMaxAngle(int round, double angleDeg)
+{
+    if (round < 0 || round >= m_rounds) return;
+    const bool on = angleDeg > 0.0;
+    if (on == bool(m_maxValid[round]) && (!on || m_maxAngles[round] == angleDeg)) return;
+    m_maxCount += int(on) - int(m_maxValid[round]);
+    m_maxValid[round] = on;
+    m_maxAngles[round] = on ? angleDeg : 0.0;
+    ++m_roundVersion[round];
+}
+
+double MeasurementStore::averageMaxAngle(int upToRound) const
+{
+    double sum = 0.0;
+    int n = 0;
+    for (int r = 0; r <= upToRound && r < m_rounds; ++r) {
+        if (!m_maxValid[r]) continue;
+        sum += m_maxAngles[r];
+        ++n;
+    }
+    return n > 0 ? sum / n : 0.0;
+}
+
+void computeErrors(const MeasurementStore& store, const std::vector<double>& expectedDeg,
+                   double fsAngleDeg, double fsPressureMPa, ErrorField& out)
+{
+    const int P = store.points();
+    const int R = store.rounds();
+    out.points = P;
+    out.rounds = R;
+    out.angleErr.resize(size_t(P) * R * MeasurementStore::StrokeCount);
+    out.pressureErr.resize(out.angleErr.size());
+    out.hysteresisAngle.resize(size_t(P) * R);
+    out.hysteresisPressure.resize(out.hysteresisAngle.size());
+    if (P == 0 || R == 0) return;
+
+    // 与 angleToPressureByFS 同样先除后乘，结果逐位一致；fsAngle<=0 时压力误差全为 0（不写成 -0.0）
+    const bool toPressure = fsAngleDeg > 0.0;
+    const double fsA = toPressure ? fsAngleDeg : 1.0;
+    const double fsP = fsPressureMPa;
+
+    // 基准角按存储布局铺开，后面两段都是整块连续数组上的平铺循环
+    const int block = P * R;
+    const int n = block * MeasurementStore::StrokeCount;
+    std::vector<double> expected(n);
+    for (int row = 0; row < R * MeasurementStore::StrokeCount; ++row) {
+        for (int p = 0; p < P; ++p) expected[size_t(row) * P + p] = p < int(expectedDeg.size()) ? expectedDeg[p] : 0.0;
+    }
+
+    const double* __restrict a = store.data();
+    const double* __restrict e = expected.data();
+    double* __restrict ae = out.angleErr.data();
+    double* __restrict pe = out.pressureErr.data();
+    for (int i = 0; i < n; ++i) ae[i] = a[i] - e[i];
+    if (toPressure) {
+        for (int i = 0; i < n; ++i) pe[i] = (ae[i] / fsA) * fsP;
+    } else {
+        std::fill(out.pressureErr.begin(), out.pressureErr.end(), 0.0);
+    }
+
+    // 正行程块在前、反行程块在后，逐点相减就是每轮每点的正反差
+    const double* __restrict f = a;
+    const double* __restrict b = a + block;
+    double* __restrict ha = out.hysteresisAngle.data();
+    double* __restrict hp = out.hysteresisPressure.data();
+    for (int i = 0; i < block; ++i) ha[i] = std::fabs(f[i] - b[i]);
+    if (toPressure) {
+        for (int i = 0; i < block; ++i) hp[i] = (ha[i] / fsA) * fsP;
+    } else {
+        std::fill(out.hysteresisPressure.begin(), out.hysteresisPressure.end(), 0.0);
+    }
+}
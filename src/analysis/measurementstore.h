@@ -0,0 +1,115 @@
+#ifndef MEASUREMENTSTORE_H
+#define MEASUREMENTSTORE_H
+
+#include <cstdint>
+#include <vector>
+
+// ================== 检测数据存储（结构数组 + 有效位） ==================
+// 角度按 行程 × 轮次 × 检测点 连续存放：同一轮同一行程的各检测点是一段连续的 double，
+// 误差核在整块连续数组上平铺计算，编译器可以直接向量化；是否有数据单独放在位图里，不再用 0.0 当"空"。
+// 轮内计数、跨轮"正+反"对数平均、最大角度个数等汇总量在写入时维护，查询 O(1)。
+// 每轮带一个版本号，任何写入都会加一，界面据此判断该轮是否需要重算。
+
+class MeasurementStore {
+public:
+    enum Stroke { Forward = 0, Backward = 1, StrokeCount = 2 };
+
+    MeasurementStore() = default;
+    MeasurementStore(int points, int rounds) { reset(points, rounds); }
+
+    // 重新分配并清空
+    void reset(int points, int rounds);
+    int points() const { return m_points; }
+    int rounds() const { return m_rounds; }
+
+    // 单元格：某检测点某轮某行程的角度
+    void set(int point, int round, int stroke, double angleDeg);
+    void clear(int point, int round, int stroke);
+    void clearRound(int round);               // 清空一轮的角度和最大角度
+    bool valid(int point, int round, int stroke) const;
+    double angle(int point, int round, int stroke) const {
+        return m_angles[index(point, round, stroke)];
+    }
+    // 一行（某轮某行程）各检测点的角度，长度 points()；无数据的位置为 0
+    const double* row(int round, int stroke) const { return m_angles.data() + rowOffset(round, stroke); }
+    const double* data() const { return m_angles.data(); }   // 整块，[stroke][round][point]
+
+    // 每轮最大角度（<=0 视为未采集）
+    void setMaxAngle(int round, double angleDeg);
+    bool hasMaxAngle(int round) const { return round >= 0 && round < m_rounds && m_maxValid[round]; }
+    double maxAngle(int round) const { return hasMaxAngle(round) ? m_maxAngles[round] : 0.0; }
+    int maxAngleCount() const { return m_maxCount; }
+    double averageMaxAngle(int upToRound) const;   // 0..upToRound 轮里已采集的平均
+
+    // 汇总（O(1)）
+    int count(int round, int stroke) const { return m_rowCount[round * StrokeCount + stroke]; }
+    bool roundHasData(int round) const { return count(round, Forward) + count(round, Backward) > 0; }
+    bool roundComplete(int round) const {
+        return count(round, Forward) == m_points && count(round, Backward) == m_points && hasMaxAngle(round);
+    }
+    // 每个检测点每一轮都至少有一个行程的数据
+    bool allCellsHaveData() const { return m_cellsWithData == m_points * m_rounds; }
+    int validCount() const { return m_validCount; }
+    // 某检测点跨轮"正+反"都有数据的轮次，其 (正+反)/2 的平均；没有成对数据返回 0
+    double pairMean(int point) const {
+        return m_pairCount[point] > 0 ? m_pairSum[point] / m_pairCount[point] : 0.0;
+    }
+    int pairCount(int point) const { return m_pairCount[point]; }
+
+    std::uint64_t roundVersion(int round) const { return m_roundVersion[round]; }
+    void touch(int round) { if (round >= 0 && round < m_rounds) ++m_roundVersion[round]; }   // 存储外的本轮数据变了
+
+private:
+    int index(int point, int round, int stroke) const { return rowOffset(round, stroke) + point; }
+    int rowOffset(int round, int stroke) const { return (stroke * m_rounds + round) * m_points; }
+    bool bit(int i) const { return (m_valid[i >> 6] >> (i & 63)) & 1u; }
+    void setBit(int i, bool on);
+    // 写入前后调用：把该 (检测点, 轮) 的有数据状态从汇总里扣除/加回
+    void unaccount(int point, int round);
+    void account(int point, int round);
+    // 该检测点的成对和/个数按轮次顺序重新累加，结果只取决于当前数据，与写入、修改的先后无关
+    void refreshPair(int point);
+
+    int m_points = 0;
+    int m_rounds = 0;
+    std::vector<double> m_angles;          // [stroke][round][point]
+    std::vector<std::uint64_t> m_valid;    // 同样下标的有效位
+    std::vector<double> m_maxAngles;
+    std::vector<std::uint8_t> m_maxValid;
+    int m_maxCount = 0;
+
+    std::vector<int> m_rowCount;           // [round][stroke]
+    std::vector<double> m_pairSum;         // [point]
+    std::vector<int> m_pairCount;          // [point]
+    int m_cellsWithData = 0;
+    int m_validCount = 0;
+    std::vector<std::uint64_t> m_roundVersion;
+};
+
+// ================== 误差核 ==================
+// 一次算出所有单元格的角度误差、压力误差和每轮每点的正反行程差（迟滞），
+// 布局与 MeasurementStore 相同；无数据的单元格照样计算（值无意义），用 store.valid() 判断。
+// 角度→压力：压力 = 角度 / 满量程角度 × 满量程压力，与界面上的换算完全一致。
+struct ErrorField {
+    int points = 0;
+    int rounds = 0;
+    std::vector<double> angleErr;          // [stroke][round][point]：实测 - 基准
+    std::vector<double> pressureErr;       // [stroke][round][point]
+    std::vector<double> hysteresisAngle;   // [round][point]：|正 - 反|
+    std::vector<double> hysteresisPressure;
+
+    double angleError(int point, int round, int stroke) const {
+        return angleErr[(stroke * rounds + round) * points + point];
+    }
+    double pressureError(int point, int round, int stroke) const {
+        return pressureErr[(stroke * rounds + round) * points + point];
+    }
+    double hysteresisAngleAt(int point, int round) const { return hysteresisAngle[round * points + point]; }
+    double hysteresisPressureAt(int point, int round) const { return hysteresisPressure[round * points + point]; }
+};
+
+// expectedDeg：各检测点的比较基准角度（长度 points）；fsAngleDeg<=0 时压力误差为 0
+void computeErrors(const MeasurementStore& store, const std::vector<double>& expectedDeg,
+                   double fsAngleDeg, double fsPressureMPa, ErrorField& out);
+
+#endif // MEASUREMENTSTORE_H
@@ -0,0 +1,209 @@
+#include "multidial.h"
+#include "corelog.h"
+
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+std::vector<cv::Vec3f> detectDials(const cv::Mat& image, const PointerDetectionConfig* config, int maxDials) {
+    static const PointerDetectionConfig defaultConfig;
+    if (image.empty() || maxDials <= 0) return {};
+
+    std::vector<cv::Vec3f> circles = detectDialCandidates(image, config ? *config : defaultConfig);
+
+    // 大圆优先；圆心落在已保留的大圆内部的，视为同一块表的内圈/刻度圈，丢掉
+    std::sort(circles.begin(), circles.end(),
+              [](const cv::Vec3f& a, const cv::Vec3f& b) { return a[2] > b[2]; });
+    std::vector<cv::Vec3f> dials;
+    for (const auto& c : circles) {
+        bool nested = false;
+        for (const auto& d : dials) {
+            if (std::hypot(c[0] - d[0], c[1] - d[1]) < d[2]) {
+                nested = true;
+                break;
+            }
+        }
+        if (nested) continue;
+        dials.push_back(c);
+        if ((int)dials.size() >= maxDials) break;
+    }
+    coreDebug() << "多表检测: 候选圆" << circles.size() << "个, 保留表盘" << dials.size() << "个";
+    return dials;
+}
+
+void MultiDialReader::setMaxDials(int n) {
+    n = std::max(1, n);
+    if (n != m_maxDials) {
+        m_maxDials = n;
+        resetSlots();
+    }
+}
+
+DialSlot* MultiDialReader::slot(int id) {
+    for (auto& s : m_slots) {
+        if (s.id == id) return &s;
+    }
+    return nullptr;
+}
+
+void MultiDialReader::assignSlots(const std::vector<cv::Vec3f>& dials) {
+    if (m_slots.empty()) {
+        // 第一次：先按圆心y排序分行（相邻两个圆心y相差超过较小半径就另起一行），行内再按x排序后编号。
+        // 不能用"y差在容差内就比x"的比较函数直接排序：那样不满足传递性，排序结果不确定
+        std::vector<cv::Vec3f> byY = dials;
+        std::sort(byY.begin(), byY.end(), [](const cv::Vec3f& a, const cv::Vec3f& b) {
+            if (a[1] != b[1]) return a[1] < b[1];
+            return a[0] < b[0];
+        });
+        std::vector<cv::Vec3f> ordered;
+        ordered.reserve(byY.size());
+        size_t rowStart = 0;
+        for (size_t i = 1; i <= byY.size(); ++i) {
+            if (i < byY.size() && byY[i][1] - byY[i - 1][1] <= std::min(byY[i][2], byY[i - 1][2])) continue;
+            std::sort(byY.begin() + rowStart, byY.begin() + i, [](const cv::Vec3f& a, const cv::Vec3f& b) {
+                if (a[0] != b[0]) return a[0] < b[0];
+                return a[1] < b[1];
+            });
+            ordered.insert(ordered.end(), byY.begin() + rowStart, byY.begin() + i);
+            rowStart = i;
+        }
+        for (size_t i = 0; i < ordered.size(); ++i) {
+            DialSlot s;
+            s.id = (int)i;
+            s.circle = ordered[i];
+            m_slots.push_back(s);
+        }
+        return;
+    }
+
+    // 之后：每个表位就近匹配圆心（不超过半径的一半），保持编号不变
+    std::vector<bool> used(dials.size(), false);
+    for (auto& s : m_slots) {
+        int best = -1;
+        double bestDist = std::numeric_limits<double>::max();
+        for (size_t i = 0; i < dials.size(); ++i) {
+            if (used[i]) continue;
+            double d = std::hypot(dials[i][0] - s.circle[0], dials[i][1] - s.circle[1]);
+            if (d < bestDist) {
+                bestDist = d;
+                best = (int)i;
+            }
+        }
+        if (best >= 0 && bestDist < s.circle[2] * 0.5) {
+            used[best] = true;
+            s.circle = dials[best];
+            s.missedFrames = 0;
+        } else {
+            s.missedFrames++;
+        }
+    }
+
+    // 还有空位时，新出现的表盘追加为新表位
+    for (size_t i = 0; i < dials.size() && (int)m_slots.size() < m_maxDials; ++i) {
+        if (used[i]) continue;
+        DialSlot s;
+        s.id = (int)m_slots.size();
+        s.circle = dials[i];
+        m_slots.push_back(s);
+    }
+}
+
+std::vector<DialReading> readDials(const cv::Mat& bgr, const PointerDetectionConfig* config, int maxDials,
+                                   int measureCount) {
+    std::vector<DialReading> readings;
+    for (const auto& c : detectDials(bgr, config, maxDials)) {
+        DialReading r;
+        r.circle = c;
+        readings.push_back(r);
+    }
+
+    // 每块表裁出自己的ROI，单表检测器在ROI里只会看到这一块表
+    const bool muted = coreLogMuted();
+    cv::Rect frameRect(0, 0, bgr.cols, bgr.rows);
+    cv::parallel_for_(cv::Range(0, (int)readings.size()), [&](const cv::Range& range) {
+        CoreLogMute mute(muted);  // 调用线程静音时，并行的子线程也跟着静音
+        for (int i = range.start; i < range.end; ++i) {
+            DialReading& r = readings[i];
+            const float half = r.circle[2] * 1.2f;
+            cv::Rect roi((int)std::floor(r.circle[0] - half), (int)std::floor(r.circle[1] - half),
+                         (int)std::ceil(half * 2), (int)std::ceil(half * 2));
+            roi &= frameRect;
+            if (roi.empty()) continue;
+
+            r.abs = measurePointerAngle(bgr(roi), config, measureCount);
+        }
+    });
+    return readings;
+}
+
+const std::vector<DialSlot>& MultiDialReader::measure(const cv::Mat& bgr, const PointerDetectionConfig* config, int measureCount) {
+    return apply(readDials(bgr, config, m_maxDials, measureCount));
+}
+
+const std::vector<DialSlot>& MultiDialReader::apply(const std::vector<DialReading>& readings) {
+    std::vector<cv::Vec3f> dials;
+    dials.reserve(readings.size());
+    for (const auto& r : readings) dials.push_back(r.circle);
+    assignSlots(dials);
+
+    // 匹配上的表位圆心就是原样拷过来的读数圆心，按圆找回读数
+    for (auto& s : m_slots) {
+        s.lastAbs = -999;
+        if (s.missedFrames > 0) continue;
+        for (const auto& r : readings) {
+            if (r.circle == s.circle) {
+                s.lastAbs = r.abs;
+                break;
+            }
+        }
+    }
+
+    for (const auto& s : m_slots) {
+        coreDebug() << "表位" << (s.id + 1) << "绝对角:" << s.lastAbs << (s.missedFrames > 0 ? "（未匹配到表盘）" : "");
+    }
+    m_pendingUpdate = true;
+    return m_slots;
+}
+
+bool MultiDialReader::updateTrackers() {
+    if (!m_pendingUpdate) return false;
+    m_pendingUpdate = false;
+    for (auto& s : m_slots) {
+        if (s.lastAbs != -999) s.tracker.update(s.lastAbs);
+    }
+    return true;
+}
+
+int MultiDialReader::captureZeroAll() {
+    int zeroed = 0;
+    for (auto& s : m_slots) {
+        if (s.lastAbs == -999) continue;
+        s.tracker.reset();
+        s.tracker.captureZero(s.lastAbs);
+        ++zeroed;
+    }
+    return zeroed;
+}
+
+void drawDialSlots(cv::Mat& canvas, const std::vector<DialSlot>& slots, double scale) {
+    for (const auto& s : slots) {
+        const bool ok = (s.missedFrames == 0 && s.lastAbs != -999);
+        const cv::Scalar color = ok ? cv::Scalar(0, 255, 0) : cv::Scalar(0, 0, 255);
+        cv::Point center(cvRound(s.circle[0] * scale), cvRound(s.circle[1] * scale));
+        int radius = cvRound(s.circle[2] * scale);
+        cv::circle(canvas, center, radius, color, 2, cv::LINE_AA);
+
+        std::string text = "#" + std::to_string(s.id + 1);
+        if (ok && s.tracker.hasZero()) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), " %.2f", s.tracker.relative());
+            text += buf;
+        }
+        cv::putText(canvas, text, cv::Point(center.x - radius, center.y - radius - 8),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.6, color, 2);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef MULTIDIAL_H
+#define MULTIDIAL_H
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+#include "anglemath.h"
+#include "pointerdetector.h"
+
+// ================== 一个画面同时读取多块表 ==================
+// 工装上并排放多块表，共用一个相机。每块表占一个"表位"（slot）：
+// 表位编号在第一次检测时按从上到下、从左到右分配，之后按圆心就近匹配，编号保持不变；
+// 每个表位有独立的展开角/零位，指针检测按表位并行执行。
+
+struct DialSlot {
+    int id = 0;                 // 表位编号（0起，稳定不变）
+    cv::Vec3f circle;           // 最近一次匹配到的表盘圆 (x, y, r)
+    double lastAbs = -999;      // 最近一次测得的绝对角（0~360），-999 表示本帧失败
+    int missedFrames = 0;       // 连续未匹配到表盘的帧数
+    AngleTracker tracker;       // 该表位独立的展开角与零位
+};
+
+// 检测画面中所有表盘圆，去掉同心/嵌套的小圆，按半径从大到小最多返回 maxDials 个
+std::vector<cv::Vec3f> detectDials(const cv::Mat& image, const PointerDetectionConfig* config, int maxDials);
+
+// 一块表的单帧读数（还没分配表位）
+struct DialReading {
+    cv::Vec3f circle;
+    double abs = -999;          // 绝对角（0~360），-999 表示指针检测失败
+};
+
+// 检测表盘并在各自ROI里并行测指针绝对角。无状态，可以放在工作线程里跑，结果交给 MultiDialReader::apply
+std::vector<DialReading> readDials(const cv::Mat& bgr, const PointerDetectionConfig* config, int maxDials,
+                                   int measureCount = 1);
+
+class MultiDialReader {
+public:
+    void setMaxDials(int n);
+    int maxDials() const { return m_maxDials; }
+
+    // 忘掉所有表位（表数变化或工装换位后重新编号）
+    void resetSlots() { m_slots.clear(); m_pendingUpdate = false; }
+
+    // 检测表盘并分配表位，然后并行测每个表位的指针绝对角（写入 lastAbs，不更新展开角）
+    const std::vector<DialSlot>& measure(const cv::Mat& bgr, const PointerDetectionConfig* config, int measureCount = 1);
+
+    // 把 readDials 的结果分配到表位并写入 lastAbs，效果与 measure 相同
+    const std::vector<DialSlot>& apply(const std::vector<DialReading>& readings);
+
+    // 用各表位的 lastAbs 更新展开角（失败的表位跳过）。每次 measure 之后只生效一次，
+    // 没有新测量时什么都不做并返回 false，同一帧不会把展开角推进两次
+    bool updateTrackers();
+
+    // 以当前 lastAbs 为各表位零位，返回成功归位的表位数
+    int captureZeroAll();
+
+    std::vector<DialSlot>& slots() { return m_slots; }
+    const std::vector<DialSlot>& slots() const { return m_slots; }
+    DialSlot* slot(int id);
+
+private:
+    void assignSlots(const std::vector<cv::Vec3f>& dials);
+
+    int m_maxDials = 1;
+    std::vector<DialSlot> m_slots;
+    bool m_pendingUpdate = false;   // 最近一次 measure 的结果还没推进展开角
+};
+
+// 在画面上标出各表位的圆和编号（相对角有零位时一并显示）；scale 含义同 drawDetectionOverlay
+void drawDialSlots(cv::Mat& canvas, const std::vector<DialSlot>& slots, double scale = 1.0);
+
+#endif // MULTIDIAL_H
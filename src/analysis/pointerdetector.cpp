@@ -0,0 +1,1191 @@
+#include "pointerdetector.h"
+#include "anglemath.h"
+#include "corelog.h"
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+highPreciseDetector::highPreciseDetector(const cv::Mat& image, const PointerDetectionConfig* config) 
+    : m_angle(-999), m_config(config), m_kind(DialKind::BYQ), m_axisCenter(-1, -1), m_axisRadius(0), 
+      m_blackLine1(-1, -1, -1, -1), m_blackLine2(-1, -1, -1, -1), m_hasBlackLines(false) {
+    if (image.empty()) {
+        coreDebug() << "输入图像为空";
+        return;
+    }
+    
+    // 如果没有提供配置，使用默认配置（BYQ 流水线，和原来默认走银色指针检测一致）
+    static const PointerDetectionConfig defaultConfig;
+    if (m_config == nullptr) {
+        m_config = &defaultConfig;
+    }
+    
+    m_kind = m_config->kind;
+    
+    // 复制输入图像
+    m_image = image.clone();
+    
+    try {
+        // 表盘类型只在这里分派一次
+        switch (m_kind) {
+        case DialKind::BYQ:
+            run<BYQPipeline>();
+            break;
+        case DialKind::YYQY:
+        default:
+            run<YYQYPipeline>();
+            break;
+        }
+    } catch (const std::exception& e) {
+        coreDebug() << "检测过程中出错:" << e.what();
+    }
+}
+
+template <class Pipeline>
+void highPreciseDetector::run() {
+    // 检测圆形
+    detectCircles();
+    
+    // 指针按流水线从表盘中心找；没检测到表盘时退回整图直线检测
+    if (!m_circles.empty()) {
+        detectPointerFromCenter<Pipeline>();
+    } else {
+        detectLines();
+    }
+    
+    // 计算角度
+    if (!m_circles.empty() && !m_lines.empty()) {
+        calculateAngle();
+    }
+}
+
+PointerDetectionConfig YYQYPipeline::defaultConfig() {
+    PointerDetectionConfig c;
+    c.dp = 1.0;
+    c.minDist = 100;
+    c.param1 = 100;
+    c.param2 = 25;                  // 降低以检测更多圆候选
+    c.minRadius = 150;
+    c.maxRadius = 300;
+
+    // 白色指针检测参数 - 针对YYQY白色指针优化
+    c.pointerSearchRadius = 0.85;   // 搜索半径比例
+    c.pointerMinLength = 60;        // 降低最小长度，白色指针可能较短
+    c.cannyLow = 30;                // 保持低阈值
+    c.cannyHigh = 100;
+    c.rho = 1.0;                    // 距离分辨率
+    c.theta = CV_PI/180;            // 角度分辨率
+    c.threshold = 35;               // 降低直线检测阈值
+    c.minLineLength = 45;           // 降低最小线段长度
+    c.maxLineGap = 12;              // 适当增加间隙
+    c.kind = kind;
+    return c;
+}
+
+PointerDetectionConfig BYQPipeline::defaultConfig() {
+    PointerDetectionConfig c;
+    c.dp = 1.0;
+    c.minDist = 100;
+    c.param1 = 100;
+    c.param2 = 30;
+    c.minRadius = 50;
+    c.maxRadius = 0;
+
+    // BYQ指针检测参数 - 针对细指针末端检测
+
+    // 步骤1-2：掩码参数
+    c.pointerMaskRadius = 0.9;        // 表盘掩码半径比例
+    c.axisExcludeMultiplier = 1.8;    // 转轴排除区域倍数
+
+    // 步骤3：预处理参数
+    c.morphKernelWidth = 1;           // 形态学核宽度
+    c.morphKernelHeight = 2;          // 形态学核高度
+    c.gaussianKernelSize = 3;         // 高斯核大小
+    c.gaussianSigma = 0.8;            // 高斯标准差
+
+    // 步骤4：边缘检测参数
+    c.cannyLowThreshold = 30;         // Canny低阈值
+    c.cannyHighThreshold = 100;       // Canny高阈值
+
+    // 步骤5：HoughLinesP参数
+    c.houghThreshold = 20;            // 直线检测阈值
+    c.minLineLengthRatio = 0.12;      // 最小长度比例
+    c.maxLineGapRatio = 0.08;         // 最大间隙比例
+    c.kind = kind;
+    return c;
+}
+
+std::vector<cv::Vec3f> detectDialCandidates(const cv::Mat& image, const PointerDetectionConfig& config) {
+    cv::Mat gray;
+    if (image.channels() == 3) {
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        gray = image.clone();
+    }
+    
+    // 使用高斯模糊减少噪声
+    cv::GaussianBlur(gray, gray, cv::Size(9, 9), 2, 2);
+    
+    // 使用配置参数进行HoughCircles检测
+    std::vector<cv::Vec3f> circles;
+    cv::HoughCircles(gray, circles, cv::HOUGH_GRADIENT, 
+                     config.dp, 
+                     config.minDist, 
+                     config.param1, 
+                     config.param2, 
+                     config.minRadius, 
+                     config.maxRadius);
+    return circles;
+}
+
+void highPreciseDetector::detectCircles() {
+    std::vector<cv::Vec3f> circles = detectDialCandidates(m_image, *m_config);
+    
+    // 选择最大的圆作为表盘
+    if (!circles.empty()) {
+        cv::Vec3f maxCircle = circles[0];
+        float maxRadius = maxCircle[2];
+        
+        for (const auto& circle : circles) {
+            if (circle[2] > maxRadius) {
+                maxCircle = circle;
+                maxRadius = circle[2];
+            }
+        }
+        
+        m_circles.push_back(maxCircle);
+        coreDebug() << "检测到表盘: 中心(" << maxCircle[0] << "," << maxCircle[1] << ") 半径:" << maxRadius;
+    } else {
+        coreDebug() << "未检测到圆形表盘";
+    }
+}
+
+void highPreciseDetector::detectLines() {
+    cv::Mat gray, edges;
+    if (m_image.channels() == 3) {
+        cv::cvtColor(m_image, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        gray = m_image.clone();
+    }
+    
+    // 使用配置参数进行边缘检测
+    cv::Canny(gray, edges, m_config->cannyLow, m_config->cannyHigh, 3);
+    
+    // 使用配置参数进行HoughLinesP检测
+    std::vector<cv::Vec4i> lines;
+    cv::HoughLinesP(edges, lines, 
+                    m_config->rho, 
+                    m_config->theta, 
+                    m_config->threshold, 
+                    m_config->minLineLength, 
+                    m_config->maxLineGap);
+    
+    if (!lines.empty()) {
+        // 如果检测到表盘，选择距离表盘中心最近的直线作为指针
+        if (!m_circles.empty()) {
+            cv::Point2f center(m_circles[0][0], m_circles[0][1]);
+            cv::Vec4i bestLine;
+            double minDist = std::numeric_limits<double>::max();
+            
+            for (const auto& line : lines) {
+                cv::Point2f lineCenter((line[0] + line[2])/2.0f, (line[1] + line[3])/2.0f);
+                double dist = cv::norm(center - lineCenter);
+                
+                if (dist < minDist) {
+                    minDist = dist;
+                    bestLine = line;
+                }
+            }
+            
+            if (minDist < m_circles[0][2]) { // 确保直线在表盘内
+                m_lines.push_back(bestLine);
+                coreDebug() << "检测到指针: (" << bestLine[0] << "," << bestLine[1] << ") 到 (" << bestLine[2] << "," << bestLine[3] << ")";
+            }
+        } else {
+            // 如果没有检测到表盘，选择最长的直线
+            cv::Vec4i longestLine;
+            double maxLength = 0;
+            
+            for (const auto& line : lines) {
+                double length = sqrt(pow(line[2] - line[0], 2) + pow(line[3] - line[1], 2));
+                if (length > maxLength) {
+                    maxLength = length;
+                    longestLine = line;
+                }
+            }
+            
+            if (maxLength > 0) {
+                m_lines.push_back(longestLine);
+                coreDebug() << "检测到最长直线作为指针";
+            }
+        }
+    } else {
+        coreDebug() << "未检测到直线";
+    }
+}
+
+template <class Pipeline>
+void highPreciseDetector::detectPointerFromCenter() {
+    if (m_circles.empty()) {
+        coreDebug() << "没有检测到表盘，无法进行指针检测";
+        return;
+    }
+    
+    cv::Mat gray;
+    if (m_image.channels() == 3) {
+        cv::cvtColor(m_image, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        gray = m_image.clone();
+    }
+    
+    // 获取表盘中心和半径
+    cv::Point2f center(m_circles[0][0], m_circles[0][1]);
+    float radius = m_circles[0][2];
+    
+    cv::Vec4i bestPointer(-1, -1, -1, -1);
+    
+    // 检测算法由流水线类型在编译期决定
+    if constexpr (Pipeline::kind == DialKind::BYQ) {
+        // BYQ银色指针检测
+        coreDebug() << "检测BYQ银色指针，表盘中心:(" << center.x << "," << center.y << ") 半径:" << radius;
+        bestPointer = detectBYQPointer(gray, center, radius);
+    } else {
+        // YYQY白色指针检测
+        coreDebug() << "检测YYQY白色指针，表盘中心:(" << center.x << "," << center.y << ") 半径:" << radius;
+        bestPointer = detectWhitePointer(gray, center, radius);
+    }
+    
+    if (bestPointer[0] != -1) {
+        m_lines.clear();
+        m_lines.push_back(bestPointer);
+        double length = sqrt(pow(bestPointer[2] - bestPointer[0], 2) + pow(bestPointer[3] - bestPointer[1], 2));
+        coreDebug() << "检测到指针: (" << bestPointer[0] << "," << bestPointer[1] 
+                 << ") 到 (" << bestPointer[2] << "," << bestPointer[3] << "), 长度:" << length;
+    } else {
+        coreDebug() << "未能检测到指针，回退到传统方法";
+        detectLines();
+    }
+}
+
+// 前向声明：在后面匿名命名空间中定义的尖端细化函数
+namespace {
+cv::Point2f rayEdgeFarthest(const cv::Mat& edge,
+                            const cv::Mat& roiMask,
+                            const cv::Point2f& axisCenter,
+                            double angleDeg,
+                            float innerR,
+                            float outerR);
+}
+
+cv::Vec4i highPreciseDetector::detectWhitePointer(const cv::Mat& gray, const cv::Point2f& center, float radius) {
+    // 确保YYQY模式下不显示转轴中心
+    m_axisCenter = cv::Point2f(-1, -1);
+    
+    // 1. 创建表盘内部的掩码
+    cv::Mat mask = cv::Mat::zeros(gray.size(), CV_8UC1);
+    cv::circle(mask, cv::Point((int)center.x, (int)center.y), (int)(radius * 0.9), cv::Scalar(255), -1);
+    
+    // 2. 检测白色区域 - 使用阈值分割
+    cv::Mat whiteRegions;
+    cv::threshold(gray, whiteRegions, 180, 255, cv::THRESH_BINARY);  // 检测亮区域
+    whiteRegions.copyTo(whiteRegions, mask);  // 仅在表盘内部
+    
+    // 3. 形态学操作连接白色区域
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(3, 3));
+    cv::morphologyEx(whiteRegions, whiteRegions, cv::MORPH_CLOSE, kernel);
+    cv::morphologyEx(whiteRegions, whiteRegions, cv::MORPH_OPEN, kernel);
+    
+    // 4. 查找白色区域的轮廓
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(whiteRegions, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    
+    cv::Vec4i bestPointer(-1, -1, -1, -1);
+    double maxScore = 0;
+    
+    // 5. 分析每个轮廓，找到最可能的指针
+    for (const auto& contour : contours) {
+        if (contour.size() < 5) continue;  // 轮廓点太少
+        
+        // 计算轮廓的面积
+        double area = cv::contourArea(contour);
+        if (area < 100 || area > radius * radius * 0.3) continue;  // 面积过滤
+        
+        // 拟合椭圆或直线
+        cv::RotatedRect ellipse = cv::fitEllipse(contour);
+        
+        // 检查椭圆的长宽比，指针应该是细长的
+        float aspectRatio = ellipse.size.width / ellipse.size.height;
+        if (aspectRatio < 1) aspectRatio = 1.0f / aspectRatio;  // 确保>1
+        
+        if (aspectRatio < 2.0) continue;  // 不够细长，不像指针
+        
+        // 检查椭圆中心是否接近表盘中心
+        cv::Point2f ellipseCenter = ellipse.center;
+        double distToDialCenter = cv::norm(ellipseCenter - center);
+        if (distToDialCenter > radius * 0.5) continue;  // 中心偏离太远
+        
+        // 计算指针方向和端点 - 修复角度计算
+        double angle = ellipse.angle * CV_PI / 180.0;
+        double length = std::max(ellipse.size.width, ellipse.size.height) / 2.0;
+        
+        // OpenCV的椭圆角度定义：从x轴正方向逆时针测量
+        // 但是我们需要考虑长轴方向
+        if (ellipse.size.width < ellipse.size.height) {
+            // 如果高度>宽度，则长轴是垂直方向，需要调整角度
+            angle += CV_PI / 2.0;
+        }
+        
+        cv::Point2f direction(cos(angle), sin(angle));
+        cv::Point2f startPoint = ellipseCenter - direction * (float)length;
+        cv::Point2f endPoint = ellipseCenter + direction * (float)length;
+        
+        // 确保指针从表盘中心指向外围
+        double dist1 = cv::norm(startPoint - center);
+        double dist2 = cv::norm(endPoint - center);
+        if (dist1 > dist2) {
+            // 如果startPoint离表盘中心更远，说明方向反了
+            std::swap(startPoint, endPoint);
+        }
+        
+        // 进一步调整：确保startPoint是表盘中心附近的点
+        cv::Point2f vectorToCenter = center - ellipseCenter;
+        double distEllipseToCenter = cv::norm(vectorToCenter);
+        if (distEllipseToCenter > 10) {  // 椭圆中心不在表盘中心
+            // 将起点调整为更接近表盘中心的位置
+            cv::Point2f directionToCenter = vectorToCenter / (float)distEllipseToCenter;
+            startPoint = ellipseCenter + directionToCenter * std::min(30.0f, (float)distEllipseToCenter);
+            
+            // 重新计算指针方向（从调整后的起点到椭圆边缘的最远点）
+            cv::Point2f pointerDirection = endPoint - startPoint;
+            float pointerLength = cv::norm(pointerDirection);
+            if (pointerLength > 0) {
+                pointerDirection = pointerDirection / pointerLength;
+                endPoint = startPoint + pointerDirection * (float)length;
+            }
+        }
+        
+        // 计算得分：基于长度、位置和形状
+        double lengthScore = std::min(length / (radius * 0.8), 1.0);  // 长度得分
+        double positionScore = std::max(0.0, 1.0 - distToDialCenter / (radius * 0.3));  // 位置得分
+        double shapeScore = std::min(aspectRatio / 5.0, 1.0);  // 形状得分
+        
+        double totalScore = lengthScore * 0.4 + positionScore * 0.4 + shapeScore * 0.2;
+        
+        if (totalScore > maxScore) {
+            maxScore = totalScore;
+            bestPointer = cv::Vec4i((int)startPoint.x, (int)startPoint.y, 
+                                   (int)endPoint.x, (int)endPoint.y);
+        }
+    }
+    
+    // 6. 如果基于轮廓的方法失败，尝试基于亮度的射线方法
+    if (bestPointer[0] == -1) {
+        bestPointer = detectWhitePointerByBrightness(gray, center, radius);
+    }
+
+    // 7. 尖端细化：使用边缘图在当前方向上由外向内寻找最外侧边缘点，提升尖端稳定性
+    if (bestPointer[0] != -1) {
+        cv::Point2f startPt((float)bestPointer[0], (float)bestPointer[1]);
+        cv::Point2f endPt((float)bestPointer[2], (float)bestPointer[3]);
+        // 以 start->end 的方向确定角度（确保从中心指向外缘）
+        cv::Point2f dir = endPt - startPt;
+        double angleDeg = std::atan2(dir.y, dir.x) * 180.0 / CV_PI;
+        // 构建边缘图
+        cv::Mat edges;
+        cv::Canny(gray, edges, m_config ? m_config->cannyLow : 30, m_config ? m_config->cannyHigh : 100, 3);
+        // 构建 ROI 掩码（表盘内环），避免外部噪声
+        cv::Mat roiMask = cv::Mat::zeros(gray.size(), CV_8UC1);
+        cv::circle(roiMask, cv::Point((int)center.x, (int)center.y), (int)(radius * 0.95f), cv::Scalar(255), -1);
+        // 由外向内搜索该方向的最外侧边缘点
+        cv::Point2f refinedTip = rayEdgeFarthest(edges, roiMask, center, angleDeg, radius * 0.15f, radius * 0.95f);
+        if (refinedTip.x >= 0) {
+            bestPointer[2] = (int)std::lround(refinedTip.x);
+            bestPointer[3] = (int)std::lround(refinedTip.y);
+        }
+    }
+    
+    coreDebug() << "白色指针检测完成，最高得分:" << maxScore;
+    return bestPointer;
+}
+
+cv::Vec4i highPreciseDetector::detectWhitePointerByBrightness(const cv::Mat& gray, const cv::Point2f& center, float radius) {
+    cv::Vec4i bestPointer(-1, -1, -1, -1);
+    double maxScore = 0;
+    
+    // 在多个角度方向搜索最亮的射线
+    for (int angle = 0; angle < 360; angle += 2) {  // 更精细的角度搜索
+        double radian = angle * CV_PI / 180.0;
+        cv::Point2f direction(cos(radian), sin(radian));
+        
+        double totalBrightness = 0;
+        int validPoints = 0;
+        cv::Point2f farthestBrightPoint = center;
+        std::vector<cv::Point2f> brightPoints;  // 记录所有亮点
+        
+        // 从表盘中心附近开始搜索（跳过中心区域，避免干扰）
+        for (int step = 15; step < radius * 0.85; step += 2) {
+            cv::Point2f currentPoint = center + direction * (float)step;
+            
+            if (currentPoint.x < 0 || currentPoint.x >= gray.cols ||
+                currentPoint.y < 0 || currentPoint.y >= gray.rows) {
+                break;
+            }
+            
+            uchar brightness = gray.at<uchar>((int)currentPoint.y, (int)currentPoint.x);
+            
+            // 检测亮点（白色指针）
+            if (brightness > 170) {  // 降低阈值，检测更多亮点
+                totalBrightness += brightness;
+                validPoints++;
+                brightPoints.push_back(currentPoint);
+                
+                double distFromCenter = cv::norm(currentPoint - center);
+                if (distFromCenter > cv::norm(farthestBrightPoint - center)) {
+                    farthestBrightPoint = currentPoint;
+                }
+            }
+        }
+        
+        // 计算这个方向的得分
+        if (validPoints > 8) {  // 需要足够多的亮点
+            double avgBrightness = totalBrightness / validPoints;
+            double pointerLength = cv::norm(farthestBrightPoint - center);
+            double continuity = (double)validPoints / (pointerLength / 2.0);  // 连续性得分
+            
+            // 综合评分：亮度 + 长度 + 连续性
+            double score = (avgBrightness - 170) * 0.4 + 
+                          std::min(pointerLength / (radius * 0.7), 1.0) * 100 * 0.4 + 
+                          std::min(continuity, 1.0) * 100 * 0.2;
+            
+            if (score > maxScore && pointerLength > m_config->pointerMinLength) {
+                maxScore = score;
+                
+                // 使用更精确的端点：找到亮点的质心作为起点
+                cv::Point2f startPoint = center;
+                if (!brightPoints.empty()) {
+                    cv::Point2f centroid(0, 0);
+                    float totalWeight = 0;
+                    
+                    // 计算亮点的加权质心，距离表盘中心近的点权重更大
+                    for (const auto& point : brightPoints) {
+                        float weight = 1.0f / (1.0f + cv::norm(point - center) / 50.0f);
+                        centroid += point * weight;
+                        totalWeight += weight;
+                    }
+                    
+                    if (totalWeight > 0) {
+                        centroid = centroid / totalWeight;
+                        
+                        // 如果质心距离表盘中心合理，使用质心作为起点
+                        if (cv::norm(centroid - center) < radius * 0.4) {
+                            startPoint = centroid;
+                        }
+                    }
+                }
+                
+                bestPointer = cv::Vec4i((int)startPoint.x, (int)startPoint.y,
+                                       (int)farthestBrightPoint.x, (int)farthestBrightPoint.y);
+            }
+        }
+    }
+    
+    coreDebug() << "基于亮度的白色指针检测完成，最高得分:" << maxScore;
+    return bestPointer;
+}
+
+// ===== NEW: 基于"辐射扫描"的顶点寻找（适配白底、细指针） + 边缘细化为"最外侧顶点" =====
+namespace {
+// 在 masked ROI 内，从 axisCenter 向外做辐射扫描，寻找"从内到外的最长连续暗像素段"的末端，
+// 该末端视为指针的粗顶点；同时输出对应的最佳角度（度）。返回 (-1,-1) 表示失败。
+static cv::Point2f radialTipScan(const cv::Mat& gray,
+                                 const cv::Mat& roiMask,
+                                 const cv::Point2f& axisCenter,
+                                 float innerR,
+                                 float outerR,
+                                 double darkThresh,
+                                 double angleStepDeg,
+                                 int    minRunLenPx,
+                                 double* bestAngleOut = nullptr)
+{
+    auto inBounds = [&](int x, int y){
+        return (unsigned)x < (unsigned)gray.cols && (unsigned)y < (unsigned)gray.rows;
+    };
+
+    int bestRun = 0;
+    cv::Point2f bestTip(-1.f, -1.f);
+    double bestAngle = 0.0;
+
+    const double toRad = CV_PI/180.0;
+    // 粗扫：角度步进 angleStepDeg
+    for (double deg = 0.0; deg < 360.0; deg += angleStepDeg) {
+        double cs = std::cos(deg*toRad), sn = std::sin(deg*toRad);
+        int runLen = 0;
+        cv::Point2f tip(-1.f, -1.f);
+
+        for (float r = innerR; r <= outerR; r += 1.0f) {
+            int x = (int)std::lround(axisCenter.x + r*cs);
+            int y = (int)std::lround(axisCenter.y + r*sn);
+            if (!inBounds(x,y)) break;
+            if (roiMask.data && roiMask.type()==CV_8U && roiMask.at<uchar>(y,x)==0) {
+                // 出了感兴趣环区
+                if (runLen > bestRun) { bestRun = runLen; bestTip = tip; bestAngle = deg; }
+                runLen = 0; tip = cv::Point2f(-1,-1);
+                continue;
+            }
+            uchar val = gray.at<uchar>(y,x);
+            if (val < darkThresh) {
+                // 暗像素 -> 认为属于指针
+                runLen++;
+                tip = cv::Point2f((float)x,(float)y); // 记录末端
+            } else {
+                // 明 -> 断开
+                if (runLen > bestRun) { bestRun = runLen; bestTip = tip; bestAngle = deg; }
+                runLen = 0; tip = cv::Point2f(-1,-1);
+            }
+        }
+        if (runLen > bestRun) { bestRun = runLen; bestTip = tip; bestAngle = deg; }
+    }
+
+    if (bestRun < minRunLenPx || bestTip.x < 0) return cv::Point2f(-1.f,-1.f);
+
+    // 细化：在最佳角附近 ±2° 再做更细的角步进与半径半步
+    int refineBest = bestRun;
+    cv::Point2f refineTip = bestTip;
+    for (double deg = bestAngle-2.0; deg <= bestAngle+2.0; deg += std::max(0.2, angleStepDeg*0.3)) {
+        double cs = std::cos(deg*toRad), sn = std::sin(deg*toRad);
+        int runLen = 0;
+        cv::Point2f tip(-1.f, -1.f);
+        for (float r = innerR; r <= outerR; r += 0.5f) {
+            int x = (int)std::lround(axisCenter.x + r*cs);
+            int y = (int)std::lround(axisCenter.y + r*sn);
+            if (!inBounds(x,y)) break;
+            if (roiMask.data && roiMask.type()==CV_8U && roiMask.at<uchar>(y,x)==0) {
+                if (runLen > refineBest) { refineBest = runLen; refineTip = tip; }
+                runLen = 0; tip = cv::Point2f(-1,-1);
+                continue;
+            }
+            uchar val = gray.at<uchar>(y,x);
+            if (val < darkThresh) { runLen++; tip = cv::Point2f((float)x,(float)y); }
+            else {
+                if (runLen > refineBest) { refineBest = runLen; refineTip = tip; }
+                runLen = 0; tip = cv::Point2f(-1,-1);
+            }
+        }
+        if (runLen > refineBest) { refineBest = runLen; refineTip = tip; }
+    }
+
+    if (refineBest >= minRunLenPx && refineTip.x >= 0) {
+        if (bestAngleOut) *bestAngleOut = bestAngle; // 仍返回粗扫的角度以保持稳定
+        return refineTip;
+    }
+    if (bestAngleOut) *bestAngleOut = bestAngle;
+    return bestTip;
+}
+
+// 在给定角度上，沿射线"由外向内"搜索边缘图的第一个边缘像素，
+// 该点可理解为"最外侧的顶点"（更贴近真实几何边界）。
+static cv::Point2f rayEdgeFarthest(const cv::Mat& edge,
+                                   const cv::Mat& roiMask,
+                                   const cv::Point2f& axisCenter,
+                                   double angleDeg,
+                                   float innerR,
+                                   float outerR)
+{
+    auto inBounds = [&](int x, int y){
+        return (unsigned)x < (unsigned)edge.cols && (unsigned)y < (unsigned)edge.rows;
+    };
+    const double toRad = CV_PI/180.0;
+    double cs = std::cos(angleDeg*toRad), sn = std::sin(angleDeg*toRad);
+    for (float r = outerR; r >= innerR; r -= 0.5f) { // 从外往里找 -> 第一处就是"最边缘"
+        int x = (int)std::lround(axisCenter.x + r*cs);
+        int y = (int)std::lround(axisCenter.y + r*sn);
+        if (!inBounds(x,y)) continue;
+        if (roiMask.data && roiMask.type()==CV_8U && roiMask.at<uchar>(y,x)==0) continue;
+        if (edge.at<uchar>(y,x) > 0) {
+            return cv::Point2f((float)x,(float)y);
+        }
+    }
+    return cv::Point2f(-1.f,-1.f);
+}
+}
+void highPreciseDetector::calculateAngle() {
+    if (m_lines.empty()) {
+        m_angle = -999;
+        return;
+    }
+    
+    cv::Vec4i line = m_lines[0];
+    
+    // 计算直线的角度（相对于水平方向）
+    double dx = line[2] - line[0];
+    double dy = line[3] - line[1];
+    
+    // 使用atan2计算角度，结果范围是 -π 到 π
+    double angle_rad = atan2(dy, dx);
+    
+    // 转换为度数，范围 -180 到 180
+    double angle_deg = angle_rad * 180.0 / CV_PI;
+    
+    // 转换为 0 到 360 度范围
+    if (angle_deg < 0) {
+        angle_deg += 360;
+    }
+    
+    m_angle = angle_deg;
+    coreDebug() << "计算得到角度:" << m_angle << "度";
+}
+
+DetectionOverlay highPreciseDetector::overlay() const {
+    if (m_kind == DialKind::BYQ) {
+        return buildOverlay<BYQPipeline>();
+    }
+    return buildOverlay<YYQYPipeline>();
+}
+
+template <class Pipeline>
+DetectionOverlay highPreciseDetector::buildOverlay() const {
+    DetectionOverlay ov;
+    ov.circles = m_circles;
+    ov.absAngle = m_angle;
+    
+    const bool axisFound = Pipeline::hasAxis && m_axisCenter.x != -1 && m_axisCenter.y != -1;
+    ov.axisCenter = m_axisCenter;
+    // 转轴中心点（只在BYQ模式下且检测到转轴时显示）
+    ov.showAxis = axisFound && m_axisRadius > 0;
+    
+    // 如果检测到了两条黑线，记录共线（最左点到最右点）
+    if (ov.showAxis && m_hasBlackLines) {
+        // 收集两条黑线的四个端点
+        cv::Point2f p1(m_blackLine1[0], m_blackLine1[1]);
+        cv::Point2f p2(m_blackLine1[2], m_blackLine1[3]);
+        cv::Point2f p3(m_blackLine2[0], m_blackLine2[1]);
+        cv::Point2f p4(m_blackLine2[2], m_blackLine2[3]);
+        
+        // 计算共线方向（使用两条黑线的平均方向）
+        cv::Point2f dir1 = p2 - p1;
+        cv::Point2f dir2 = p4 - p3;
+        // 确保方向一致（点积为正）
+        if (dir1.x * dir2.x + dir1.y * dir2.y < 0) {
+            dir2 = -dir2;
+        }
+        cv::Point2f avgDir = dir1 + dir2;
+        float avgDirLen = cv::norm(avgDir);
+        if (avgDirLen > 0) {
+            avgDir = avgDir / avgDirLen;
+        } else {
+            avgDir = cv::Point2f(1, 0);  // 默认水平
+        }
+        
+        // 按照方向投影排序四个端点
+        std::vector<cv::Point2f> allPoints = {p1, p2, p3, p4};
+        std::sort(allPoints.begin(), allPoints.end(), 
+            [&avgDir](const cv::Point2f& a, const cv::Point2f& b) {
+                return (a.x * avgDir.x + a.y * avgDir.y) < (b.x * avgDir.x + b.y * avgDir.y);
+            });
+        
+        ov.hasAxisLine = true;
+        ov.axisLineFrom = allPoints[0];
+        ov.axisLineTo = allPoints[3];
+    }
+    
+    // 指针：BYQ检测到转轴时，从转轴中心画到指针顶点；其他情况画检测到的线段
+    ov.pointerFromAxis = axisFound;
+    for (const auto& line : m_lines) {
+        if (axisFound) {
+            // line[2], line[3] = 指针顶点坐标
+            cv::Point2f tipPoint(line[2], line[3]);
+            // 验证tipPoint有效：必须在圆心上方（y值小于圆心y值）且坐标有效
+            bool tipValid = (tipPoint.x > 0 && tipPoint.y > 0 && 
+                            !m_circles.empty() && tipPoint.y < m_circles[0][1]);
+            if (!tipValid) continue;
+        }
+        ov.pointers.push_back(line);
+    }
+    return ov;
+}
+
+void drawDetectionOverlay(cv::Mat& canvas, const DetectionOverlay& ov, double scale) {
+    // 坐标按 scale 缩放到画布分辨率，线宽/字号按画布像素给定
+    auto P = [scale](float x, float y) { return cv::Point(cvRound(x * scale), cvRound(y * scale)); };
+    
+    // 绘制检测到的圆形（表盘）
+    for (const auto& circle : ov.circles) {
+        cv::Point center = P(circle[0], circle[1]);
+        int radius = cvRound(circle[2] * scale);
+        // 绘制圆心（绿色）
+        cv::circle(canvas, center, 3, cv::Scalar(0, 255, 0), -1, 8, 0);
+        // 绘制圆周（蓝色）
+        cv::circle(canvas, center, radius, cv::Scalar(255, 0, 0), 2, cv::LINE_AA, 0);
+    }
+    
+    // 绘制BYQ转轴中心
+    if (ov.showAxis) {
+        cv::Point axisPoint = P(ov.axisCenter.x, ov.axisCenter.y);
+        
+        // 绘制转轴中心点（绿色小圆点）
+        cv::circle(canvas, axisPoint, 4, cv::Scalar(0, 255, 0), -1, 8, 0);
+        
+        if (ov.hasAxisLine) {
+            // 绘制青色共线（从最左点到最右点）
+            cv::line(canvas, P(ov.axisLineFrom.x, ov.axisLineFrom.y), P(ov.axisLineTo.x, ov.axisLineTo.y),
+                     cv::Scalar(255, 255, 0), 2, cv::LINE_AA);
+            
+            // 绘制从表盘圆心到转轴中心的绿色垂线
+            if (!ov.circles.empty()) {
+                cv::line(canvas, P(ov.circles[0][0], ov.circles[0][1]), axisPoint,
+                         cv::Scalar(0, 255, 0), 2, cv::LINE_AA);
+            }
+        }
+        
+        // 添加标注文字
+        cv::putText(canvas, "Axis", cv::Point(axisPoint.x + 10, axisPoint.y - 5), 
+                   cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 255, 0), 1);
+    }
+    
+    // 绘制检测到的直线（指针）
+    for (const auto& line : ov.pointers) {
+        if (ov.pointerFromAxis) {
+            // 从转轴中心到指针顶点的连线（红色细线）+ 顶点小圆（黄色）
+            cv::Point tip = P(line[2], line[3]);
+            cv::line(canvas, P(ov.axisCenter.x, ov.axisCenter.y), tip, cv::Scalar(0, 0, 255), 1, cv::LINE_AA);
+            cv::circle(canvas, tip, 5, cv::Scalar(0, 255, 255), -1, 8, 0);
+        } else {
+            cv::line(canvas, P(line[0], line[1]), P(line[2], line[3]), cv::Scalar(0, 0, 255), 2, cv::LINE_AA);
+        }
+    }
+    
+    if (ov.absAngle != -999) {
+        std::string angleText = "Abs: " + std::to_string(ov.absAngle) + "°";
+        cv::putText(canvas, angleText, cv::Point(10, 30), 
+                   cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(255, 255, 0), 2);
+    }
+}
+
+// ================== BYQ指针检测算法实现 ==================
+cv::Vec4i highPreciseDetector::detectBYQPointer(const cv::Mat& gray, const cv::Point2f& center, float radius) {
+    coreDebug() << "开始BYQ指针检测";
+    
+    // 初始化转轴中心
+    m_axisCenter = cv::Point2f(-1, -1);
+    
+    // 1. 首先检测转轴中心
+    cv::Point2f axisCenter = detectBYQAxis(gray, center, radius);
+    
+    if (axisCenter.x == -1) {
+        coreDebug() << "未找到BYQ转轴中心，使用表盘中心";
+        axisCenter = center;
+    } else {
+        // 保存转轴中心用于可视化
+        m_axisCenter = axisCenter;
+    }
+    
+    // 2. 检测银色指针末端
+    cv::Vec4i silverEnd = detectSilverPointerEnd(gray, axisCenter, center, radius);
+    
+    if (silverEnd[0] != -1) {
+        coreDebug() << "BYQ指针检测成功";
+        return silverEnd;
+    }
+    
+    coreDebug() << "BYQ指针检测失败";
+    return cv::Vec4i(-1, -1, -1, -1);
+}
+
+cv::Point2f highPreciseDetector::detectBYQAxis(const cv::Mat& gray, const cv::Point2f& dialCenter, float dialRadius) {
+    coreDebug() << "检测BYQ螺旋波登管转轴中心 - 使用LSD线段检测（支持表盘旋转）";
+    coreDebug() << "表盘中心:(" << dialCenter.x << "," << dialCenter.y << ") 半径:" << dialRadius;
+    
+    m_hasBlackLines = false;
+    m_blackLine1 = cv::Vec4i(-1, -1, -1, -1);
+    m_blackLine2 = cv::Vec4i(-1, -1, -1, -1);
+    
+    // 1. 创建环形掩码：只搜索表盘内部的下半部分环形区域
+    // 使用环形而非矩形裁剪，这样即使表盘旋转也能正确覆盖黑线区域
+    cv::Mat mask = cv::Mat::zeros(gray.size(), CV_8UC1);
+    
+    // 外圆：表盘边缘往内缩一点
+    int outerRadius = (int)(dialRadius * 0.95);
+    // 内圆：排除中心区域（转轴附近）
+    int innerRadius = (int)(dialRadius * 0.25);
+    
+    // 画外圆（填充）
+    cv::circle(mask, cv::Point((int)dialCenter.x, (int)dialCenter.y), outerRadius, cv::Scalar(255), -1);
+    // 挖掉内圆
+    cv::circle(mask, cv::Point((int)dialCenter.x, (int)dialCenter.y), innerRadius, cv::Scalar(0), -1);
+    
+    // 不再用矩形裁剪，让整个环形区域都参与搜索
+    // 这样即使表盘旋转45度，黑线仍然在搜索区域内
+    
+    coreDebug() << "黑线搜索区域: 环形区域 内径=" << innerRadius << " 外径=" << outerRadius;
+    
+    // 2. 应用掩码
+    cv::Mat roiGray;
+    gray.copyTo(roiGray, mask);
+    
+    // 3. 使用LSD检测直线段
+    cv::Ptr<cv::LineSegmentDetector> lsd = cv::createLineSegmentDetector(cv::LSD_REFINE_STD);
+    std::vector<cv::Vec4f> lines;
+    lsd->detect(roiGray, lines);
+    
+    coreDebug() << "LSD在环形区域检测到" << lines.size() << "条直线";
+    
+    struct LineInfo {
+        cv::Vec4f line;
+        float length;
+        float midX;
+        float midY;
+        float angle;  // 线段角度（弧度）
+        cv::Point2f p1, p2;  // 两个端点
+        float distFromCenter;  // 中点到圆心的距离
+    };
+    
+    std::vector<LineInfo> candidateLines;
+    
+    for (const auto& line : lines) {
+        cv::Point2f p1(line[0], line[1]);
+        cv::Point2f p2(line[2], line[3]);
+        
+        // 两端都必须在表盘圆内
+        float d1 = cv::norm(p1 - dialCenter);
+        float d2 = cv::norm(p2 - dialCenter);
+        if (d1 > dialRadius || d2 > dialRadius) continue;
+        
+        // 计算线段长度
+        float lineLen = cv::norm(p2 - p1);
+        if (lineLen < 15) continue;  // 太短的忽略
+        
+        // 计算中点
+        float midX = (p1.x + p2.x) / 2.0f;
+        float midY = (p1.y + p2.y) / 2.0f;
+        cv::Point2f midPoint(midX, midY);
+        
+        // 计算中点到圆心的距离（用于判断是否在下半部分）
+        float distFromCenter = cv::norm(midPoint - dialCenter);
+        
+        // 计算中点相对于圆心的角度（用于判断位置）
+        // 0度=右，90度=下，180度=左，-90度=上
+        float posAngle = std::atan2(midY - dialCenter.y, midX - dialCenter.x) * 180.0f / CV_PI;
+        
+        // 只保留大致在下半部分的线段（角度在 0° 到 180° 之间，允许±60度偏移）
+        // 这意味着允许表盘旋转最多60度
+        bool isInLowerHalf = (posAngle > -60 && posAngle < 240);
+        if (!isInLowerHalf) continue;
+        
+        // 计算线段方向角度（弧度，用于后续共线判断）
+        float angle = std::atan2(p2.y - p1.y, p2.x - p1.x);
+        float angleDeg = angle * 180.0f / CV_PI;
+        
+        LineInfo info = {line, lineLen, midX, midY, angle, p1, p2, distFromCenter};
+        candidateLines.push_back(info);
+        
+        coreDebug() << "  候选黑线: (" << p1.x << "," << p1.y << ")->(" << p2.x << "," << p2.y 
+                 << ") 长度=" << lineLen << " 方向角=" << angleDeg << "° 位置角=" << posAngle << "°";
+    }
+    
+    coreDebug() << "候选线段数:" << candidateLines.size();
+    
+    if (candidateLines.size() < 2) {
+        coreDebug() << "候选线段不足2条，检测失败";
+        m_axisRadius = 0;
+        return cv::Point2f(-1, -1);
+    }
+    
+    // 4. 找最佳配对：两条线段应该"共线"（同一条直线上的两段）
+    // 判断共线的标准：
+    //   a) 方向角度相近（角度差小于15度）
+    //   b) 一条线段的端点投影到另一条线段的延长线上的距离很小
+    //   c) 两条线段之间有间隙（不重叠），中间是转轴
+    
+    LineInfo bestLine1, bestLine2;
+    float bestScore = 0;
+    
+    for (size_t i = 0; i < candidateLines.size(); ++i) {
+        for (size_t j = i + 1; j < candidateLines.size(); ++j) {
+            const LineInfo& L1 = candidateLines[i];
+            const LineInfo& L2 = candidateLines[j];
+            
+            // a) 检查角度差（考虑180度对称性）
+            float angleDiff = std::abs(L1.angle - L2.angle);
+            if (angleDiff > CV_PI) angleDiff = 2 * CV_PI - angleDiff;
+            if (angleDiff > CV_PI / 2) angleDiff = CV_PI - angleDiff;  // 处理反向
+            float angleDiffDeg = angleDiff * 180.0f / CV_PI;
+            
+            if (angleDiffDeg > 15) continue;  // 角度差超过15度，不共线
+            
+            // b) 计算两线段中点之间的连线与线段方向的垂直距离
+            // 使用L1的方向作为参考
+            cv::Point2f dir1 = L1.p2 - L1.p1;
+            float len1 = cv::norm(dir1);
+            if (len1 < 1) continue;
+            dir1 = dir1 / len1;  // 单位方向向量
+            
+            cv::Point2f midToMid = cv::Point2f(L2.midX - L1.midX, L2.midY - L1.midY);
+            // 垂直距离 = |midToMid × dir1| = |midToMid.x * dir1.y - midToMid.y * dir1.x|
+            float perpDist = std::abs(midToMid.x * dir1.y - midToMid.y * dir1.x);
+            
+            if (perpDist > 25) continue;  // 垂直距离过大，不共线
+            
+            // c) 检查两线段之间有间隙
+            // 计算四个端点在方向上的投影
+            float proj1_p1 = L1.p1.x * dir1.x + L1.p1.y * dir1.y;
+            float proj1_p2 = L1.p2.x * dir1.x + L1.p2.y * dir1.y;
+            float proj2_p1 = L2.p1.x * dir1.x + L2.p1.y * dir1.y;
+            float proj2_p2 = L2.p2.x * dir1.x + L2.p2.y * dir1.y;
+            
+            float L1_min = std::min(proj1_p1, proj1_p2);
+            float L1_max = std::max(proj1_p1, proj1_p2);
+            float L2_min = std::min(proj2_p1, proj2_p2);
+            float L2_max = std::max(proj2_p1, proj2_p2);
+            
+            // 检查是否有间隙（不重叠）
+            float gap = 0;
+            if (L1_max < L2_min) {
+                gap = L2_min - L1_max;
+            } else if (L2_max < L1_min) {
+                gap = L1_min - L2_max;
+            }
+            // 如果没有间隙（重叠），跳过
+            if (gap < 5) continue;  // 间隙至少5像素
+            
+            // 计算得分：总长度 + 共线性（垂直距离越小越好）+ 间隙合理性
+            float lengthScore = L1.length + L2.length;
+            float collinearScore = std::max(0.0f, 50.0f - perpDist * 2);  // 垂直距离越小分越高
+            float gapScore = (gap > 10 && gap < 150) ? 30.0f : 0.0f;  // 间隙在合理范围内加分
+            
+            float score = lengthScore + collinearScore + gapScore;
+            
+            coreDebug() << "  配对 L" << i << "-L" << j << ": 角度差=" << angleDiffDeg 
+                     << "° 垂直距离=" << perpDist << " 间隙=" << gap << " 得分=" << score;
+            
+            if (score > bestScore) {
+                bestScore = score;
+                bestLine1 = L1;
+                bestLine2 = L2;
+            }
+        }
+    }
+    
+    if (bestScore > 0) {
+        // 保存黑线信息用于可视化
+        m_blackLine1 = cv::Vec4i((int)bestLine1.line[0], (int)bestLine1.line[1], 
+                                  (int)bestLine1.line[2], (int)bestLine1.line[3]);
+        m_blackLine2 = cv::Vec4i((int)bestLine2.line[0], (int)bestLine2.line[1], 
+                                  (int)bestLine2.line[2], (int)bestLine2.line[3]);
+        m_hasBlackLines = true;
+        
+        // 收集四个端点
+        std::vector<cv::Point2f> allPoints = {bestLine1.p1, bestLine1.p2, bestLine2.p1, bestLine2.p2};
+        
+        // 计算共线方向（使用两线段中点连线或平均方向）
+        cv::Point2f avgDir = (bestLine1.p2 - bestLine1.p1) + (bestLine2.p2 - bestLine2.p1);
+        float avgDirLen = cv::norm(avgDir);
+        if (avgDirLen < 1) {
+            coreDebug() << "方向向量计算失败";
+            m_axisRadius = 0;
+            return cv::Point2f(-1, -1);
+        }
+        avgDir = avgDir / avgDirLen;
+        
+        // 按照方向投影排序四个端点
+        std::sort(allPoints.begin(), allPoints.end(), 
+            [&avgDir](const cv::Point2f& a, const cv::Point2f& b) {
+                return (a.x * avgDir.x + a.y * avgDir.y) < (b.x * avgDir.x + b.y * avgDir.y);
+            });
+        
+        cv::Point2f leftMost = allPoints[0];
+        cv::Point2f rightMost = allPoints[3];
+        
+        coreDebug() << "黑线端点1: (" << leftMost.x << "," << leftMost.y << ")";
+        coreDebug() << "黑线端点2: (" << rightMost.x << "," << rightMost.y << ")";
+        
+        // 计算表盘圆心到共线的垂足作为转轴中心
+        // 这样可以保证绿线（圆心到转轴）垂直于青线（共线）
+        cv::Point2f lineDir = rightMost - leftMost;
+        float lineLenSq = lineDir.x * lineDir.x + lineDir.y * lineDir.y;
+        
+        cv::Point2f axisCenter(-1, -1);
+        if (lineLenSq > 1.0f) {
+            cv::Point2f toCenter = dialCenter - leftMost;
+            float t = (toCenter.x * lineDir.x + toCenter.y * lineDir.y) / lineLenSq;
+            axisCenter = leftMost + t * lineDir;
+        }
+        
+        if (axisCenter.x < 0) {
+            coreDebug() << "无法计算垂足，检测失败";
+            m_axisRadius = 0;
+            return cv::Point2f(-1, -1);
+        }
+        
+        m_axisRadius = cv::norm(dialCenter - axisCenter);
+        
+        coreDebug() << "表盘圆心: (" << dialCenter.x << "," << dialCenter.y << ")";
+        coreDebug() << "转轴中心(垂足): (" << axisCenter.x << "," << axisCenter.y << ")";
+        coreDebug() << "圆心到转轴距离: " << m_axisRadius;
+        
+        return axisCenter;
+    }
+    
+    // 检测失败
+    coreDebug() << "未能检测到共线的两条黑线，检测失败";
+    m_axisRadius = 0;
+    return cv::Point2f(-1, -1);
+}
+
+cv::Vec4i highPreciseDetector::detectSilverPointerEnd(const cv::Mat& gray,
+                                                      const cv::Point2f& axisCenter, const cv::Point2f& dialCenter, float dialRadius) {
+    coreDebug() << "检测银色指针末端 - 使用LSD线段检测（只在圆心上方区域）";
+    coreDebug() << "转轴中心:(" << axisCenter.x << "," << axisCenter.y << ") 圆心:(" << dialCenter.x << "," << dialCenter.y << ")";
+    
+    // 检查转轴中心是否有效
+    if (axisCenter.x < 0 || axisCenter.y < 0) {
+        coreDebug() << "转轴中心无效，无法检测指针";
+        return cv::Vec4i(-1, -1, -1, -1);
+    }
+    
+    // 1. 创建圆心上方区域的掩码（指针的直线部分只在这里）
+    cv::Mat mask = cv::Mat::zeros(gray.size(), CV_8UC1);
+    // 画表盘圆
+    cv::circle(mask, cv::Point((int)dialCenter.x, (int)dialCenter.y), (int)dialRadius, cv::Scalar(255), -1);
+    // 遮蔽圆心下方区域（保留圆心上方，同时允许延伸到圆心下方50像素以捕获更多指针）
+    int bottomLimit = (int)dialCenter.y - 20;
+    cv::rectangle(mask, cv::Point(0, bottomLimit), 
+                  cv::Point(gray.cols, gray.rows), cv::Scalar(0), -1);
+    // 也排除太靠近顶部边缘的区域（表盘边缘干扰）
+    int topMargin = (int)(dialCenter.y - dialRadius + 5);  // 减少顶部边距
+    cv::rectangle(mask, cv::Point(0, 0), 
+                  cv::Point(gray.cols, topMargin), cv::Scalar(0), -1);
+    
+    // 2. 应用掩码
+    cv::Mat roiGray;
+    gray.copyTo(roiGray, mask);
+    
+    // 3. 计算上半区域的平均亮度，用于自适应二值化阈值
+    cv::Scalar meanVal = cv::mean(roiGray, mask);
+    double avgBrightness = meanVal[0];
+    
+    // 5. 形态学操作：连接断开的指针，去除噪点
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+    cv::morphologyEx(roiGray, roiGray, cv::MORPH_CLOSE, kernel);
+    cv::morphologyEx(roiGray, roiGray, cv::MORPH_OPEN, kernel);
+    
+    // 6. 使用LSD检测直线段
+    cv::Ptr<cv::LineSegmentDetector> lsd = cv::createLineSegmentDetector(cv::LSD_REFINE_STD);
+    std::vector<cv::Vec4f> lines;
+    lsd->detect(roiGray, lines);
+    
+    coreDebug() << "LSD在圆心上方区域检测到" << lines.size() << "条直线";
+    
+    // 7. 筛选指针线段
+    cv::Vec4f bestLine(-1, -1, -1, -1);
+    float bestScore = 0;
+    
+    for (const auto& line : lines) {
+        cv::Point2f p1(line[0], line[1]);
+        cv::Point2f p2(line[2], line[3]);
+        
+        // 至少有一端在圆心上方（y值小于圆心y值）
+        bool p1Above = p1.y < dialCenter.y;
+        bool p2Above = p2.y < dialCenter.y;
+        if (!p1Above && !p2Above) continue;  // 两端都在圆心下方则跳过
+        
+        // 计算线段长度
+        float lineLen = cv::norm(p2 - p1);
+        if (lineLen < 20) continue;  // 太短的忽略（放宽到20像素）
+        
+        // 计算线段中点
+        cv::Point2f midPoint = (p1 + p2) * 0.5f;
+        
+        // 检查中点是否在表盘圆内
+        float distFromDialCenter = cv::norm(midPoint - dialCenter);
+        if (distFromDialCenter > dialRadius * 0.90f) continue;  // 放宽到95%
+        
+        // 计算线段方向向量
+        cv::Point2f lineDir = p2 - p1;
+        float lineDirLen = cv::norm(lineDir);
+        if (lineDirLen < 1) continue;
+        lineDir = lineDir / lineDirLen;
+        
+        // 计算从中点指向转轴中心的方向
+        cv::Point2f toAxis = axisCenter - midPoint;
+        float toAxisLen = cv::norm(toAxis);
+        if (toAxisLen < 1) continue;
+        toAxis = toAxis / toAxisLen;
+        
+        // 线段方向应该与指向转轴的方向一致（或相反，因为方向可能反的）
+        float dotProduct = std::abs(lineDir.x * toAxis.x + lineDir.y * toAxis.y);
+        if (dotProduct < 0.6f) continue;  // 方向偏差太大
+        
+        // 确定哪端离转轴更远（那就是指针末端）
+        float d1 = cv::norm(p1 - axisCenter);
+        float d2 = cv::norm(p2 - axisCenter);
+        
+        // 评分：长度 × 方向一致性
+        float score = lineLen * dotProduct;
+        
+        coreDebug() << "  候选线段: (" << p1.x << "," << p1.y << ")->(" << p2.x << "," << p2.y 
+                 << ") 长度=" << lineLen << " 方向一致性=" << dotProduct 
+                 << " d1=" << d1 << " d2=" << d2 << " 分数=" << score;
+        
+        if (score > bestScore) {
+            bestScore = score;
+            // d1 > d2 表示 p1 离转轴更远，p1 是末端（黄色点）
+            if (d1 > d2) {
+                bestLine = cv::Vec4f(axisCenter.x, axisCenter.y, p1.x, p1.y);  // p1离转轴远，是末端
+            } else {
+                bestLine = cv::Vec4f(axisCenter.x, axisCenter.y, p2.x, p2.y);  // p2离转轴远，是末端
+            }
+        }
+    }
+    
+    if (bestScore > 0) {
+        cv::Point2f tipPoint(bestLine[2], bestLine[3]);
+        coreDebug() << "最佳指针线段末端:(" << tipPoint.x << "," << tipPoint.y << ") 分数=" << bestScore;
+        
+        // 返回格式：[转轴中心x, 转轴中心y, 末端x, 末端y]
+        return cv::Vec4i((int)std::lround(bestLine[0]),
+                         (int)std::lround(bestLine[1]),
+                         (int)std::lround(bestLine[2]),
+                         (int)std::lround(bestLine[3]));
+    }
+    
+    coreDebug() << "未检测到指针";
+    return cv::Vec4i(-1, -1, -1, -1);
+}
+
+double measurePointerAngle(const cv::Mat& frame, const PointerDetectionConfig* config, int measureCount) {
+    std::vector<double> angles;
+    angles.reserve(std::max(1, measureCount));
+
+    coreDebug() << "开始进行" << measureCount << "次角度测量(圆统计均值)";
+    for (int i = 0; i < measureCount; ++i) {
+        try {
+            highPreciseDetector det(frame, config);
+            if (!det.getLine().empty()) {
+                double a = det.getAngle(); // 0~360
+                if (a != -999) {
+                    angles.push_back(norm0_360(a));
+                    coreDebug() << "第" << (i + 1) << "次测量角度:" << a;
+                } else {
+                    coreDebug() << "第" << (i + 1) << "次测量失败：角度计算错误";
+                }
+            } else {
+                coreDebug() << "第" << (i + 1) << "次测量失败：未检测到指针";
+            }
+        } catch (const std::exception& e) {
+            coreDebug() << "第" << (i + 1) << "次测量异常:" << e.what();
+        }
+    }
+
+    if (angles.empty()) {
+        coreDebug() << "所有测量都失败";
+        return -999;
+    }
+
+    // 只看这一帧的样本，和样本顺序、之前的调用都无关；跨帧的流式估计用 CircularWindowStats
+    std::size_t used = 0;
+    double mean = robustCircularMeanDeg(angles, &used);
+    coreDebug() << "圆均值:" << mean << " 样本数:" << used;
+    return mean; // 返回稳定 Abs 角 [0,360)
+}
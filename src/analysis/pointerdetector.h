@@ -0,0 +1,147 @@
+#ifndef POINTERDETECTOR_H
+#define POINTERDETECTOR_H
+
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+
+// 表盘类型：选定后决定走哪条检测流水线（YYQYPipeline / BYQPipeline）
+enum class DialKind {
+    YYQY,   // 白色指针，从表盘圆心出发
+    BYQ     // 银色细指针，偏心转轴（由底部两条黑线定位）
+};
+
+// 指针识别配置结构
+struct PointerDetectionConfig {
+    // 圆形检测参数
+    double dp = 1.0;                    // HoughCircles的累加器分辨率
+    double minDist = 100;               // 圆心之间的最小距离
+    double param1 = 100;                // Canny边缘检测的高阈值
+    double param2 = 30;                 // 圆心检测的累加器阈值
+    int minRadius = 50;                 // 最小圆半径
+    int maxRadius = 0;                  // 最大圆半径（0表示不限制）
+
+    // 直线检测参数
+    double rho = 1.0;                   // 距离分辨率
+    double theta = CV_PI/180;           // 角度分辨率
+    int threshold = 50;                 // 累加器阈值
+    double minLineLength = 30;          // 最小线段长度
+    double maxLineGap = 10;             // 最大线段间隙
+
+    // Canny边缘检测参数
+    double cannyLow = 50;               // Canny低阈值
+    double cannyHigh = 150;             // Canny高阈值
+
+    // 指针识别特定参数
+    double pointerSearchRadius = 0.9;   // 指针搜索半径比例（相对于表盘半径）
+    int pointerMinLength = 50;          // 指针最小长度
+    double angleOffset = 0.0;           // 角度偏移量
+
+    // BYQ指针检测关键参数
+    // 步骤1-2：掩码参数
+    double pointerMaskRadius = 0.9;     // 表盘掩码半径比例（调小=更靠近中心，调大=更靠近边缘）
+    double axisExcludeMultiplier = 1.8; // 转轴排除区域倍数（调小=排除区域小，调大=排除区域大）
+
+    // 步骤3：预处理参数
+    int morphKernelWidth = 1;           // 形态学核宽度（1-3，调大=线条更粗）
+    int morphKernelHeight = 2;          // 形态学核高度（1-5，调大=连接更多断点）
+    int gaussianKernelSize = 3;         // 高斯核大小（3,5,7，调大=更平滑）
+    double gaussianSigma = 0.8;         // 高斯标准差（0.5-2.0，调大=更模糊）
+
+    // 步骤4：边缘检测参数
+    int cannyLowThreshold = 30;         // Canny低阈值（20-50，调低=更多边缘）
+    int cannyHighThreshold = 100;       // Canny高阈值（80-150，调低=更多边缘）
+
+    // 步骤5：直线检测参数
+    int houghThreshold = 20;            // 直线检测阈值（10-40，调低=更多直线）
+    double minLineLengthRatio = 0.12;   // 最小线长比例（0.08-0.2，调小=检测更短线）
+    double maxLineGapRatio = 0.08;      // 最大间隙比例（0.05-0.15，调大=连接更多断线）
+
+    // 表盘类型标识
+    DialKind kind = DialKind::BYQ;      // 表盘类型（决定检测流水线）；默认 BYQ，与原来默认走银色指针检测一致
+};
+
+// ================== 各表盘类型的检测流水线（编译期确定） ==================
+// 每种表盘一个策略类型：用哪些阶段是编译期常量，
+// 检测器在构造时按 kind 分派一次，之后整条流水线内不再有类型判断。
+// 各阶段的阈值（Canny、Hough、形态学核、掩码比例……）仍是 PointerDetectionConfig 的运行时字段：
+// 要按现场光照调，自动调参工具算出的配置在运行时载入。
+struct YYQYPipeline {
+    static constexpr DialKind kind = DialKind::YYQY;
+    static constexpr bool hasAxis = false;          // 指针绕表盘圆心转，不找转轴；以表盘圆心为起点找白色指针
+    static PointerDetectionConfig defaultConfig();  // 针对白色指针优化的默认参数
+};
+
+struct BYQPipeline {
+    static constexpr DialKind kind = DialKind::BYQ;
+    static constexpr bool hasAxis = true;           // 偏心转轴，在表盘掩码内找银色指针末端，从转轴中心画到顶点
+    static PointerDetectionConfig defaultConfig();  // 针对银色指针末端和转轴检测优化的默认参数
+};
+
+// 检测结果的几何信息（不含渲染好的图像）；显示时再按目标分辨率用矢量图元绘制
+struct DetectionOverlay {
+    std::vector<cv::Vec3f> circles;     // 表盘圆 (x, y, r)
+    std::vector<cv::Vec4i> pointers;    // 指针线段（起点 -> 顶点）
+    bool showAxis = false;              // BYQ：检测到偏心转轴
+    cv::Point2f axisCenter{-1, -1};     // 转轴中心
+    bool pointerFromAxis = false;       // 指针从转轴中心画到顶点（否则画检测到的线段）
+    bool hasAxisLine = false;           // 底部两条黑线的共线
+    cv::Point2f axisLineFrom, axisLineTo;
+    double absAngle = -999;             // 绝对角（-999 表示失败）
+};
+
+// 把检测几何画到画布上；scale = 画布分辨率 / 原图分辨率（先缩小图像再画，线条保持清晰）
+void drawDetectionOverlay(cv::Mat& canvas, const DetectionOverlay& overlay, double scale = 1.0);
+
+class highPreciseDetector {
+private:
+    cv::Mat m_image;
+    std::vector<cv::Vec3f> m_circles;
+    std::vector<cv::Vec4i> m_lines;
+    double m_angle;
+    const PointerDetectionConfig* m_config;  // 配置参数指针
+    DialKind m_kind;           // 构造时确定的表盘类型
+    cv::Point2f m_axisCenter;  // BYQ转轴中心
+    float m_axisRadius;        // BYQ转轴半径
+
+    // BYQ底部两条黑线（用于自动计算转轴中心）
+    cv::Vec4i m_blackLine1;    // 第一条黑线
+    cv::Vec4i m_blackLine2;    // 第二条黑线
+    bool m_hasBlackLines;      // 是否检测到黑线
+
+public:
+    explicit highPreciseDetector(const cv::Mat& image, const PointerDetectionConfig* config = nullptr);
+    ~highPreciseDetector() = default;
+
+    const std::vector<cv::Vec3f>& getCircles() const { return m_circles; }
+    const std::vector<cv::Vec4i>& getLine() const { return m_lines; }
+    double getAngle() const { return m_angle; }
+    DetectionOverlay overlay() const;  // 检测结果的几何信息，用于显示
+
+private:
+    template <class Pipeline> void run();          // 整条检测流水线
+    template <class Pipeline> DetectionOverlay buildOverlay() const;  // 可视化几何
+
+    void detectCircles();
+    void detectLines();
+    void calculateAngle();
+    template <class Pipeline> void detectPointerFromCenter();  // 从圆心开始检测指针的新方法
+
+    // 白色指针检测专用方法
+    cv::Vec4i detectWhitePointer(const cv::Mat& gray, const cv::Point2f& center, float radius);
+    cv::Vec4i detectWhitePointerByBrightness(const cv::Mat& gray, const cv::Point2f& center, float radius);
+
+    // BYQ指针检测专用方法
+    cv::Vec4i detectBYQPointer(const cv::Mat& gray, const cv::Point2f& center, float radius);
+    cv::Point2f detectBYQAxis(const cv::Mat& gray, const cv::Point2f& dialCenter, float dialRadius);
+    cv::Vec4i detectSilverPointerEnd(const cv::Mat& gray, const cv::Point2f& axisCenter, const cv::Point2f& dialCenter, float dialRadius);
+};
+
+// 表盘圆候选（灰度 + 高斯模糊 + HoughCircles），未做筛选
+std::vector<cv::Vec3f> detectDialCandidates(const cv::Mat& image, const PointerDetectionConfig& config);
+
+// 对同一帧做多次检测，取圆统计均值（带一次MAD剔除），返回稳定 Abs 角 [0,360)；全部失败返回 -999。
+// 无状态：同一帧同样参数结果相同，与调用顺序无关。跨帧平滑请把结果喂给调用方自己持有的 CircularWindowStats
+double measurePointerAngle(const cv::Mat& frame, const PointerDetectionConfig* config, int measureCount = 3);
+
+#endif // POINTERDETECTOR_H
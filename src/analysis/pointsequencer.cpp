@@ -0,0 +1,61 @@
+#include "pointsequencer.h"
+
+#include <algorithm>
+#include <cmath>
+
+PressurePointSequencer::PressurePointSequencer(const std::vector<double>& detectionPoints, double fullScale,
+                                               double tolerance, int dwellMs)
+    : m_tolerance(std::max(1e-6, tolerance)), m_dwellMs(std::max(0, dwellMs)) {
+    for (int i = 0; i < (int)detectionPoints.size(); ++i) {
+        PointStep s;
+        s.pointIndex = i;
+        s.forward = true;
+        s.target = detectionPoints[i];
+        m_steps.push_back(s);
+    }
+
+    PointStep top;
+    top.pointIndex = -1;
+    top.isMax = true;
+    top.target = fullScale;
+    m_steps.push_back(top);
+
+    // 反行程从最高检测点往回走，与误差表的下标一一对应
+    for (int i = (int)detectionPoints.size() - 1; i >= 0; --i) {
+        PointStep s;
+        s.pointIndex = i;
+        s.forward = false;
+        s.target = detectionPoints[i];
+        m_steps.push_back(s);
+    }
+}
+
+bool PressurePointSequencer::update(const PressureReading& reading) {
+    if (finished() || !reading.valid) return false;
+    m_lastUs = reading.timestampUs;
+
+    if (std::abs(reading.pressure - m_steps[m_index].target) > m_tolerance) {
+        m_inBandSinceUs = -1;   // 超调/振荡出带：重新计时
+        return false;
+    }
+    if (m_inBandSinceUs < 0) m_inBandSinceUs = reading.timestampUs;
+    if (m_reported || stableMs() < m_dwellMs) return false;
+    m_reported = true;
+    return true;
+}
+
+void PressurePointSequencer::advance() {
+    if (!finished()) ++m_index;
+    m_inBandSinceUs = -1;
+    m_reported = false;
+}
+
+void PressurePointSequencer::retry() {
+    m_inBandSinceUs = -1;
+    m_reported = false;
+}
+
+double PressurePointSequencer::stableMs() const {
+    if (m_inBandSinceUs < 0) return 0.0;
+    return (m_lastUs - m_inBandSinceUs) / 1000.0;
+}
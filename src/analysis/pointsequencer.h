@@ -0,0 +1,51 @@
+#ifndef POINTSEQUENCER_H
+#define POINTSEQUENCER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "pressuresource.h"
+
+// ================== 检测点自动步进 ==================
+// 有可控压力源时，按 正行程各检测点 → 满量程(最大角度) → 反行程各检测点 的顺序下发目标压力。
+// 读数连续 dwellMs 毫秒落在 |p - 目标| <= tolerance 内才算到点（压力控制器会超调、振荡），
+// 到点后由调用方采集角度，再 advance() 到下一个点。
+
+struct PointStep {
+    int pointIndex = 0;       // 检测点下标；满量程步为 -1
+    bool forward = true;      // 正行程 / 反行程
+    bool isMax = false;       // 满量程（采集最大角度）
+    double target = 0.0;      // 目标压力 MPa
+};
+
+class PressurePointSequencer {
+public:
+    PressurePointSequencer() = default;
+    PressurePointSequencer(const std::vector<double>& detectionPoints, double fullScale,
+                           double tolerance, int dwellMs);
+
+    bool finished() const { return m_index >= (int)m_steps.size(); }
+    const PointStep* current() const { return finished() ? nullptr : &m_steps[m_index]; }
+    int stepIndex() const { return m_index; }
+    int stepCount() const { return (int)m_steps.size(); }
+
+    // 喂一个读数；当前步稳定够 dwellMs 时返回 true（每步只返回一次，直到 advance）
+    bool update(const PressureReading& reading);
+    void advance();
+    // 到点后采集失败：当前步重新计时，再稳定 dwellMs 后再报一次
+    void retry();
+
+    // 当前步已稳定多久（毫秒），用于界面显示
+    double stableMs() const;
+
+private:
+    std::vector<PointStep> m_steps;
+    double m_tolerance = 0.01;
+    int m_dwellMs = 2000;
+    int m_index = 0;
+    std::int64_t m_inBandSinceUs = -1;
+    std::int64_t m_lastUs = 0;
+    bool m_reported = false;
+};
+
+#endif // POINTSEQUENCER_H
@@ -0,0 +1,157 @@
+#include "pressurecontroller.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <locale>
+#include <sstream>
+
+namespace {
+const double kPi = 3.14159265358979323846;
+const double kMaxStepSec = 0.002;   // 积分步长上限，保证欠阻尼系统数值稳定
+} // namespace
+
+PressureControllerModel::PressureControllerModel(const PressureControllerParams& params, unsigned seed)
+    : m_params(params), m_rng(seed) {
+}
+
+void PressureControllerModel::reset(double pressure) {
+    m_target = m_setpoint = m_pressure = pressure;
+    m_velocity = 0.0;
+}
+
+void PressureControllerModel::step(double dtSec) {
+    if (dtSec <= 0.0) return;
+    const double wn = 2.0 * kPi * std::max(1e-3, m_params.naturalFreqHz);
+    const double zeta = std::max(0.0, m_params.damping);
+    const double ramp = std::max(1e-6, m_params.rampPerSec);
+
+    // 长时间未推进（比如界面卡住）时最多补 40 秒，步长始终不超过 kMaxStepSec
+    dtSec = std::min(dtSec, 40.0);
+    const int steps = int(std::ceil(dtSec / kMaxStepSec));
+    const double h = dtSec / steps;
+    for (int i = 0; i < steps; ++i) {
+        const double diff = m_target - m_setpoint;
+        const double maxMove = ramp * h;
+        m_setpoint += std::max(-maxMove, std::min(maxMove, diff));
+
+        // 半隐式欧拉：a = wn²(r - p) - 2ζwn·v
+        const double acc = wn * wn * (m_setpoint - m_pressure) - 2.0 * zeta * wn * m_velocity;
+        m_velocity += acc * h;
+        m_pressure += m_velocity * h;
+    }
+}
+
+double PressureControllerModel::measured() {
+    if (m_params.noiseMPa <= 0.0) return m_pressure;
+    std::normal_distribution<double> noise(0.0, m_params.noiseMPa);
+    return m_pressure + noise(m_rng);
+}
+
+bool PressureControllerModel::settled() const {
+    // 设定值已到位、压力在带内、且几乎不再移动
+    return std::abs(m_setpoint - m_target) < 1e-9 && std::abs(m_pressure - m_target) <= m_params.settleBand
+        && std::abs(m_velocity) <= m_params.settleBand;
+}
+
+// ---------------------------------------------------------------
+
+SimulatedControllerSource::SimulatedControllerSource(const PressureControllerParams& params)
+    : m_model(params, unsigned(std::chrono::steady_clock::now().time_since_epoch().count())) {
+}
+
+bool SimulatedControllerSource::start() {
+    m_model.reset(0.0);
+    m_last = std::chrono::steady_clock::now();
+    m_running = true;
+    return true;
+}
+
+void SimulatedControllerSource::advance() {
+    const auto now = std::chrono::steady_clock::now();
+    m_model.step(std::chrono::duration<double>(now - m_last).count());
+    m_last = now;
+}
+
+bool SimulatedControllerSource::read(PressureReading& out) {
+    if (!m_running) {
+        out.valid = false;
+        return false;
+    }
+    advance();
+    out.timestampUs = nowUs();
+    out.pressure = m_model.measured();
+    out.valid = true;
+    return true;
+}
+
+bool SimulatedControllerSource::setTarget(double pressure) {
+    if (!m_running) return false;
+    advance();
+    m_model.setTarget(pressure);
+    return true;
+}
+
+// ---------------------------------------------------------------
+
+namespace {
+
+std::string trimmed(const std::string& s) {
+    size_t b = 0, e = s.size();
+    while (b < e && std::isspace((unsigned char)s[b])) ++b;
+    while (e > b && std::isspace((unsigned char)s[e - 1])) --e;
+    return s.substr(b, e - b);
+}
+
+std::string number(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.5f", v);
+    return buf;
+}
+
+// "KEY <数字>"：取出 KEY 后面的数字（C 区域，不受系统小数点设置影响）
+bool parseKeyValue(const std::string& line, const std::string& key, double& value) {
+    const std::string t = trimmed(line);
+    if (t.size() <= key.size() || t.compare(0, key.size(), key) != 0) return false;
+    if (!std::isspace((unsigned char)t[key.size()])) return false;
+    std::istringstream is(t.substr(key.size()));
+    is.imbue(std::locale::classic());
+    is >> value;
+    return !is.fail() && std::isfinite(value);
+}
+
+} // namespace
+
+std::string PressureProtocol::measureQuery() { return "MEAS?"; }
+
+std::string PressureProtocol::setTargetCommand(double pressure) { return "SETP " + number(pressure); }
+
+bool PressureProtocol::parseMeasurement(const std::string& line, double& pressure) {
+    return parseKeyValue(line, "MEAS", pressure);
+}
+
+std::string PressureProtocol::handleCommand(const std::string& line, PressureControllerModel& model) {
+    std::string cmd = trimmed(line);
+    std::string upper = cmd;
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return (char)std::toupper(c); });
+    double v = 0.0;
+
+    if (upper == "MEAS?") return "MEAS " + number(model.measured());
+    if (upper == "SETP?") return "SETP " + number(model.target());
+    if (upper == "STAT?") return std::string("STAT ") + (model.settled() ? "1" : "0");
+    if (upper == "*IDN?") return "PressureSim,1.0";
+    if (parseKeyValue(upper, "SETP", v)) {
+        if (v < 0.0) return "ERR negative target";
+        model.setTarget(v);
+        return "OK";
+    }
+    if (parseKeyValue(upper, "RATE", v)) {
+        if (v <= 0.0) return "ERR bad rate";
+        PressureControllerParams p = model.params();
+        p.rampPerSec = v;
+        model.setParams(p);
+        return "OK";
+    }
+    return "ERR unknown command";
+}
@@ -0,0 +1,96 @@
+#ifndef PRESSURECONTROLLER_H
+#define PRESSURECONTROLLER_H
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "pressuresource.h"
+
+// ================== 压力控制器模型与通讯协议 ==================
+// 没有实验台时，用同一个模型在本进程里模拟（SimulatedControllerSource），
+// 或由独立的 pressure_sim 进程通过 TCP / pty 说同一套文本协议，走完整的通讯链路。
+
+// 控制器动态：设定值按升降速率爬坡，实际压力按二阶欠阻尼系统跟随设定值
+// （阻尼越小超调越大，固有频率越高稳定越快），再叠加读数噪声。
+struct PressureControllerParams {
+    double rampPerSec = 0.2;      // 设定值爬坡速率 MPa/s
+    double naturalFreqHz = 0.8;   // 二阶系统固有频率
+    double damping = 0.45;        // 阻尼比（<1 有超调）
+    double noiseMPa = 0.002;      // 读数噪声（标准差）
+    double settleBand = 0.005;    // |压力-目标| 在此范围内且几乎不动算稳定
+};
+
+class PressureControllerModel {
+public:
+    explicit PressureControllerModel(const PressureControllerParams& params = PressureControllerParams(),
+                                     unsigned seed = 1);
+
+    void setParams(const PressureControllerParams& params) { m_params = params; }
+    const PressureControllerParams& params() const { return m_params; }
+
+    void reset(double pressure = 0.0);
+    void setTarget(double pressure) { m_target = pressure; }
+    double target() const { return m_target; }
+
+    // 推进 dtSec 秒（内部按小步长积分）
+    void step(double dtSec);
+
+    double pressure() const { return m_pressure; }      // 真实压力（无噪声）
+    double measured();                                  // 带噪声的读数
+    double setpoint() const { return m_setpoint; }      // 爬坡中的设定值
+    bool settled() const;
+
+private:
+    PressureControllerParams m_params;
+    std::mt19937 m_rng;
+    double m_target = 0.0;
+    double m_setpoint = 0.0;
+    double m_pressure = 0.0;
+    double m_velocity = 0.0;
+};
+
+// 进程内模拟控制器：按真实时间推进模型
+class SimulatedControllerSource : public PressureSource {
+public:
+    explicit SimulatedControllerSource(const PressureControllerParams& params = PressureControllerParams());
+
+    std::string name() const override { return "控制器模拟器"; }
+    bool start() override;
+    void stop() override { m_running = false; }
+    bool read(PressureReading& out) override;
+    bool canControl() const override { return true; }
+    bool setTarget(double pressure) override;
+
+    PressureControllerModel& model() { return m_model; }
+
+private:
+    void advance();
+
+    PressureControllerModel m_model;
+    bool m_running = false;
+    std::chrono::steady_clock::time_point m_last;
+};
+
+// ---------------- 文本行协议 ----------------
+// 每行一条命令，\n 结尾，回复一行：
+//   MEAS?        -> MEAS <压力MPa>
+//   SETP <p>     -> OK
+//   SETP?        -> SETP <目标MPa>
+//   RATE <r>     -> OK            （爬坡速率 MPa/s）
+//   STAT?        -> STAT <0|1>    （1 = 已稳定）
+//   *IDN?        -> 设备标识
+// 出错回复 ERR <原因>。
+struct PressureProtocol {
+    static std::string measureQuery();
+    static std::string setTargetCommand(double pressure);
+
+    // 解析 "MEAS <p>"，成功返回 true
+    static bool parseMeasurement(const std::string& line, double& pressure);
+
+    // 服务端：处理一行命令并返回回复（不含换行）
+    static std::string handleCommand(const std::string& line, PressureControllerModel& model);
+};
+
+#endif // PRESSURECONTROLLER_H
@@ -0,0 +1,50 @@
+#include "pressuresource.h"
+
+#include <algorithm>
+
+SweepSimulatorSource::SweepSimulatorSource(double fullScale, double rampPerSec, double holdSec)
+    : m_fullScale(std::max(0.0, fullScale)),
+      m_rampPerSec(std::max(1e-6, rampPerSec)),
+      m_holdSec(std::max(0.0, holdSec)) {
+}
+
+bool SweepSimulatorSource::start() {
+    m_t0 = std::chrono::steady_clock::now();
+    m_running = true;
+    return true;
+}
+
+double SweepSimulatorSource::durationSec() const {
+    return 2.0 * m_fullScale / m_rampPerSec + 3.0 * m_holdSec;
+}
+
+double SweepSimulatorSource::pressureAt(double t) const {
+    const double ramp = m_fullScale / m_rampPerSec;
+    // 停留 → 升压 → 停留 → 降压 → 停留
+    if (t <= m_holdSec) return 0.0;
+    t -= m_holdSec;
+    if (t <= ramp) return t * m_rampPerSec;
+    t -= ramp;
+    if (t <= m_holdSec) return m_fullScale;
+    t -= m_holdSec;
+    if (t <= ramp) return m_fullScale - t * m_rampPerSec;
+    return 0.0;
+}
+
+bool SweepSimulatorSource::read(PressureReading& out) {
+    if (!m_running) {
+        out.valid = false;
+        return false;
+    }
+    const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_t0).count();
+    out.timestampUs = nowUs();
+    out.pressure = pressureAt(t);
+    out.valid = true;
+    return true;
+}
+
+bool SweepSimulatorSource::sweepFinished() const {
+    if (!m_running) return false;
+    const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_t0).count();
+    return t >= durationSec();
+}
@@ -0,0 +1,69 @@
+#ifndef PRESSURESOURCE_H
+#define PRESSURESOURCE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// ================== 压力参考源 ==================
+// 扫描标定时，每个角度样本都要配一个带时间戳的参考压力。
+// 压力来源可替换（压力控制器 / 模拟器），识别与标定代码只依赖这个接口。
+
+struct PressureReading {
+    std::int64_t timestampUs = 0;  // 自 1970 起的微秒（与角度记录同一时钟）
+    double pressure = 0.0;         // MPa
+    bool valid = false;
+};
+
+class PressureSource {
+public:
+    virtual ~PressureSource() = default;
+
+    virtual std::string name() const = 0;
+    virtual bool start() { return true; }   // 开始（模拟器从 0 开始计时）
+    virtual void stop() {}
+
+    // 取最近一次读数，不阻塞
+    virtual bool read(PressureReading& out) = 0;
+
+    // 一次完整扫描（升到满量程再降回）是否已经结束；真实控制器由操作者决定，返回 false
+    virtual bool sweepFinished() const { return false; }
+
+    // 可控压力源（压力控制器）：下发目标压力。只读的压力源返回 false
+    virtual bool canControl() const { return false; }
+    virtual bool setTarget(double /*pressure*/) { return false; }
+
+    // 最近一次出错信息（打开失败、通讯超时等）
+    virtual std::string lastError() const { return std::string(); }
+
+    static std::int64_t nowUs() {
+        using namespace std::chrono;
+        return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+    }
+};
+
+// 本地扫描模拟器：0 → 满量程 → 0 的匀速三角波，两端各停 holdSec 秒。
+// 没有实验台时用来跑通扫描标定流程。
+class SweepSimulatorSource : public PressureSource {
+public:
+    SweepSimulatorSource(double fullScale, double rampPerSec, double holdSec = 1.0);
+
+    std::string name() const override { return "扫描模拟器"; }
+    bool start() override;
+    void stop() override { m_running = false; }
+    bool read(PressureReading& out) override;
+    bool sweepFinished() const override;
+
+    // 第 t 秒时的压力（纯函数，便于离线检查）
+    double pressureAt(double tSec) const;
+    double durationSec() const;
+
+private:
+    double m_fullScale;
+    double m_rampPerSec;
+    double m_holdSec;
+    bool m_running = false;
+    std::chrono::steady_clock::time_point m_t0;
+};
+
+#endif // PRESSURESOURCE_H
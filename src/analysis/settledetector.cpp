@@ -0,0 +1,97 @@
+#include "settledetector.h"
+#include "anglemath.h"
+
+#include <algorithm>
+#include <cmath>
+
+SettleDetector::SettleDetector(const SettleConfig& config)
+    : m_config(config), m_stats(std::max(2, config.windowFrames)) {
+}
+
+void SettleDetector::setConfig(const SettleConfig& config) {
+    m_config = config;
+    m_stats.setWindow(std::max(2, config.windowFrames));
+    reset();
+}
+
+void SettleDetector::reset() {
+    m_stats.clear();
+    m_state = SettleState::Moving;
+    m_stableCount = 0;
+    m_countdownStartMs = 0;
+    m_armed = true;
+}
+
+void SettleDetector::holdAt(double absDeg) {
+    reset();
+    m_armed = false;
+    m_firedAbsDeg = absDeg;
+    m_state = SettleState::Disarmed;
+}
+
+SettleState SettleDetector::update(double absDeg, std::int64_t nowMs) {
+    if (absDeg == -999) {
+        // 识别失败不算稳定，倒计时取消
+        m_stats.clear();
+        m_stableCount = 0;
+        m_state = m_armed ? SettleState::Moving : SettleState::Disarmed;
+        return m_state;
+    }
+
+    m_stats.push(absDeg);
+
+    if (!m_armed) {
+        if (std::abs(wrapSigned180(absDeg - m_firedAbsDeg)) >= m_config.rearmMoveDeg) {
+            m_armed = true;
+            m_stableCount = 0;
+        } else {
+            m_state = SettleState::Disarmed;
+            return m_state;
+        }
+    }
+
+    const bool windowFull = m_stats.size() >= m_stats.window();
+    const bool quiet = windowFull && m_stats.stdDevDeg() <= m_config.maxStdDeg;
+    if (!quiet) {
+        m_stableCount = 0;
+        m_state = SettleState::Moving;
+        return m_state;
+    }
+
+    ++m_stableCount;
+    if (m_stableCount < m_config.stableFrames) {
+        m_state = SettleState::Settling;
+        return m_state;
+    }
+
+    if (m_state != SettleState::Countdown) {
+        m_countdownStartMs = nowMs;
+        m_state = SettleState::Countdown;
+    }
+    if (nowMs - m_countdownStartMs >= m_config.dwellMs) {
+        m_armed = false;
+        m_firedAbsDeg = m_stats.robustMeanDeg();
+        m_stableCount = 0;
+        m_state = SettleState::Fire;
+    }
+    return m_state;
+}
+
+int SettleDetector::remainingMs(std::int64_t nowMs) const {
+    if (m_state != SettleState::Countdown) return m_config.dwellMs;
+    return (int)std::max<std::int64_t>(0, m_config.dwellMs - (nowMs - m_countdownStartMs));
+}
+
+double SettleDetector::progress(std::int64_t nowMs) const {
+    switch (m_state) {
+    case SettleState::Settling:
+        return 0.5 * double(m_stableCount) / std::max(1, m_config.stableFrames);
+    case SettleState::Countdown:
+        if (m_config.dwellMs <= 0) return 1.0;
+        return 0.5 + 0.5 * double(m_config.dwellMs - remainingMs(nowMs)) / m_config.dwellMs;
+    case SettleState::Fire:
+        return 1.0;
+    default:
+        return 0.0;
+    }
+}
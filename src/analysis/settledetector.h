@@ -0,0 +1,63 @@
+#ifndef SETTLEDETECTOR_H
+#define SETTLEDETECTOR_H
+
+#include <cstdint>
+
+#include "circularstats.h"
+
+// ================== 指针稳定检测（自动采集） ==================
+// 对实时角度流做滑动窗口圆统计：窗口内圆标准差连续 stableFrames 帧低于阈值，
+// 进入倒计时 dwellMs，倒计时期间指针一动就取消；倒计时结束触发一次采集。
+// 触发后需要指针离开触发位置 rearmMoveDeg 以上才会重新布防，避免同一个检测点重复采集。
+// 时间由调用方传入（毫秒），核心库不依赖 Qt 计时器。
+
+struct SettleConfig {
+    int windowFrames = 5;        // 统计窗口帧数
+    double maxStdDeg = 0.15;     // 窗口圆标准差阈值（度）
+    int stableFrames = 8;        // 连续满足阈值的帧数 K
+    int dwellMs = 1500;          // 稳定后再等待的时间（倒计时）
+    double rearmMoveDeg = 3.0;   // 触发后指针至少移动这么多才允许下一次触发
+};
+
+enum class SettleState {
+    Disarmed,    // 刚触发过，等待指针离开
+    Moving,      // 指针在动 / 窗口未满 / 本帧无效
+    Settling,    // 标准差已低于阈值，累计稳定帧
+    Countdown,   // 已稳定，倒计时中
+    Fire         // 本帧触发采集（只返回一次）
+};
+
+class SettleDetector {
+public:
+    explicit SettleDetector(const SettleConfig& config = SettleConfig());
+
+    void setConfig(const SettleConfig& config);
+    const SettleConfig& config() const { return m_config; }
+
+    // 喂入一帧绝对角（-999 表示本帧识别失败），nowMs 为单调时钟毫秒数
+    SettleState update(double absDeg, std::int64_t nowMs);
+
+    // 重新开始（换表位、关闭自动采集时调用）；已布防
+    void reset();
+
+    // 当前位置已经采过（例如刚归位），指针离开后才布防
+    void holdAt(double absDeg);
+
+    SettleState state() const { return m_state; }
+    int stableCount() const { return m_stableCount; }
+    int remainingMs(std::int64_t nowMs) const;   // 倒计时剩余，非倒计时状态返回 dwellMs
+    double progress(std::int64_t nowMs) const;   // 0~1：稳定帧累计 + 倒计时的整体进度，用于界面
+    double windowStdDeg() const { return m_stats.size() > 1 ? m_stats.stdDevDeg() : -1.0; }
+    double settledAbsDeg() const { return m_stats.robustMeanDeg(); }
+
+private:
+    SettleConfig m_config;
+    CircularWindowStats m_stats;
+    SettleState m_state = SettleState::Moving;
+    int m_stableCount = 0;
+    std::int64_t m_countdownStartMs = 0;
+    bool m_armed = true;
+    double m_firedAbsDeg = 0.0;
+};
+
+#endif // SETTLEDETECTOR_H
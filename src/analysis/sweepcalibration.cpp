@@ -0,0 +1,186 @@
+#include "sweepcalibration.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 小规模最小二乘：法方程 + 列主元消元（x 已归一化到 0~1，阶数不高，条件数可以接受）
+bool polyFit(const std::vector<double>& x, const std::vector<double>& y, int degree, std::vector<double>& coeffs) {
+    const int n = degree + 1;
+    if ((int)x.size() < n) return false;
+
+    std::vector<double> a(n * (n + 1), 0.0);  // 增广矩阵 n×(n+1)
+    std::vector<double> powers(2 * n - 1);
+    for (size_t i = 0; i < x.size(); ++i) {
+        double pw = 1.0;
+        for (int k = 0; k < 2 * n - 1; ++k) {
+            powers[k] = pw;
+            pw *= x[i];
+        }
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) a[r * (n + 1) + c] += powers[r + c];
+            a[r * (n + 1) + n] += powers[r] * y[i];
+        }
+    }
+
+    for (int col = 0; col < n; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < n; ++r) {
+            if (std::abs(a[r * (n + 1) + col]) > std::abs(a[pivot * (n + 1) + col])) pivot = r;
+        }
+        if (std::abs(a[pivot * (n + 1) + col]) < 1e-12) return false;
+        if (pivot != col) {
+            for (int c = 0; c <= n; ++c) std::swap(a[col * (n + 1) + c], a[pivot * (n + 1) + c]);
+        }
+        for (int r = 0; r < n; ++r) {
+            if (r == col) continue;
+            const double f = a[r * (n + 1) + col] / a[col * (n + 1) + col];
+            for (int c = col; c <= n; ++c) a[r * (n + 1) + c] -= f * a[col * (n + 1) + c];
+        }
+    }
+    coeffs.resize(n);
+    for (int r = 0; r < n; ++r) coeffs[r] = a[r * (n + 1) + n] / a[r * (n + 1) + r];
+    return true;
+}
+
+double polyEval(const std::vector<double>& c, double x) {
+    double v = 0.0;
+    for (size_t k = c.size(); k-- > 0;) v = v * x + c[k];
+    return v;
+}
+
+// 在 p0 附近对某一行程做局部线性回归，返回 p0 处的角度
+bool localAngleAt(const std::vector<SweepSample>& samples, int direction, double p0, double halfWindow,
+                  double& angle, int& used) {
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    used = 0;
+    for (const auto& s : samples) {
+        if (s.direction != direction || std::abs(s.pressure - p0) > halfWindow) continue;
+        const double dx = s.pressure - p0;
+        sx += dx;
+        sy += s.angleDeg;
+        sxx += dx * dx;
+        sxy += dx * s.angleDeg;
+        ++used;
+    }
+    if (used == 0) return false;
+    const double det = used * sxx - sx * sx;
+    if (used < 3 || det <= 1e-12) {
+        angle = sy / used;  // 样本太少或压力几乎没变（端点停留）：取平均
+        return true;
+    }
+    // y = a + b*dx，p0 处就是截距 a
+    angle = (sy * sxx - sx * sxy) / det;
+    return true;
+}
+
+} // namespace
+
+void SweepRecorder::clear() {
+    m_samples.clear();
+    m_direction = 1;
+    m_extreme = 0.0;
+    m_peak = 0.0;
+}
+
+void SweepRecorder::add(std::int64_t timestampUs, double pressure, double angleDeg) {
+    if (m_samples.empty()) m_extreme = pressure;
+
+    if (m_direction > 0) {
+        if (pressure > m_extreme) m_extreme = pressure;
+        else if (pressure < m_extreme - m_deadband) {
+            m_direction = -1;   // 从最高点回落超过死区：进入反行程
+            m_extreme = pressure;
+        }
+    } else {
+        if (pressure < m_extreme) m_extreme = pressure;
+        else if (pressure > m_extreme + m_deadband) {
+            m_direction = 1;
+            m_extreme = pressure;
+        }
+    }
+    m_peak = std::max(m_peak, pressure);
+
+    SweepSample s;
+    s.timestampUs = timestampUs;
+    s.pressure = pressure;
+    s.angleDeg = angleDeg;
+    s.direction = m_direction;
+    m_samples.push_back(s);
+}
+
+double SweepResult::curveAngle(double pressure) const {
+    if (coeffs.empty() || fullScalePressure <= 0.0) return 0.0;
+    return polyEval(coeffs, pressure / fullScalePressure);
+}
+
+SweepResult fitSweep(const std::vector<SweepSample>& samples, const std::vector<double>& detectionPoints,
+                     double fullScalePressure, int polyDegree, double halfWindow) {
+    SweepResult res;
+    res.fullScalePressure = fullScalePressure;
+    if (samples.size() < 8 || fullScalePressure <= 0.0) return res;
+    if (halfWindow <= 0.0) halfWindow = 0.03 * fullScalePressure;
+
+    // 1) 整条标定曲线（正反行程合并）
+    std::vector<double> xs, ys;
+    xs.reserve(samples.size());
+    ys.reserve(samples.size());
+    for (const auto& s : samples) {
+        xs.push_back(s.pressure / fullScalePressure);
+        ys.push_back(s.angleDeg);
+        (s.direction > 0 ? res.forwardCount : res.backwardCount)++;
+    }
+    polyDegree = std::max(1, std::min(polyDegree, 5));
+    if (!polyFit(xs, ys, polyDegree, res.coeffs)) return res;
+
+    double ss = 0.0;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        const double r = ys[i] - polyEval(res.coeffs, xs[i]);
+        ss += r * r;
+    }
+    res.rmsResidualDeg = std::sqrt(ss / xs.size());
+
+    // 2) 满量程角度：满量程附近两个行程一起做局部回归，回退到曲线值
+    double fsAngle = 0.0;
+    int used = 0;
+    double fwdTop = 0.0, bwdTop = 0.0;
+    int nf = 0, nb = 0;
+    const bool hasF = localAngleAt(samples, 1, fullScalePressure, halfWindow, fwdTop, nf);
+    const bool hasB = localAngleAt(samples, -1, fullScalePressure, halfWindow, bwdTop, nb);
+    used = nf + nb;
+    if (hasF && hasB) fsAngle = (fwdTop * nf + bwdTop * nb) / used;
+    else if (hasF) fsAngle = fwdTop;
+    else if (hasB) fsAngle = bwdTop;
+    else fsAngle = res.curveAngle(fullScalePressure);
+    res.fullScaleAngle = fsAngle;
+    if (std::abs(fsAngle) < 1e-9) return res;
+
+    // 3) 各检测点：正/反行程分别局部回归，误差口径与误差表一致（角度误差按满量程换算成压力）
+    auto toMPa = [&](double deg) { return deg / fsAngle * fullScalePressure; };
+    for (double p : detectionPoints) {
+        SweepPointResult pt;
+        pt.pressure = p;
+        pt.expectedAngle = p / fullScalePressure * fsAngle;
+        pt.hasForward = localAngleAt(samples, 1, p, halfWindow, pt.forwardAngle, pt.forwardSamples);
+        pt.hasBackward = localAngleAt(samples, -1, p, halfWindow, pt.backwardAngle, pt.backwardSamples);
+        if (pt.hasForward) {
+            pt.forwardErrDeg = pt.forwardAngle - pt.expectedAngle;
+            pt.forwardErrMPa = toMPa(pt.forwardErrDeg);
+            res.maxAbsErrMPa = std::max(res.maxAbsErrMPa, std::abs(pt.forwardErrMPa));
+        }
+        if (pt.hasBackward) {
+            pt.backwardErrDeg = pt.backwardAngle - pt.expectedAngle;
+            pt.backwardErrMPa = toMPa(pt.backwardErrDeg);
+            res.maxAbsErrMPa = std::max(res.maxAbsErrMPa, std::abs(pt.backwardErrMPa));
+        }
+        if (pt.hasForward && pt.hasBackward) {
+            pt.hysteresisDeg = std::abs(pt.backwardAngle - pt.forwardAngle);
+            pt.hysteresisMPa = std::abs(toMPa(pt.hysteresisDeg));
+            res.maxHysteresisMPa = std::max(res.maxHysteresisMPa, pt.hysteresisMPa);
+        }
+        res.points.push_back(pt);
+    }
+    res.ok = true;
+    return res;
+}
@@ -0,0 +1,69 @@
+#ifndef SWEEPCALIBRATION_H
+#define SWEEPCALIBRATION_H
+
+#include <cstdint>
+#include <vector>
+
+// ================== 连续扫描标定 ==================
+// 压力连续升到满量程再降回，期间每帧记录 (参考压力, 相对角)。
+// 结束后用全部密集数据拟合标定曲线，并在各检测点做局部线性回归，
+// 得到正/反行程角度、误差与迟滞，代替多轮逐点手动采集。
+
+struct SweepSample {
+    std::int64_t timestampUs = 0;
+    double pressure = 0.0;      // MPa
+    double angleDeg = 0.0;      // 相对零位的角度（连续角）
+    int direction = 1;          // 1=升压（正行程） -1=降压（反行程）
+};
+
+// 按压力走势给样本分行程：相对本行程的极值回退超过 deadband 才换向，避免压力抖动来回切
+class SweepRecorder {
+public:
+    explicit SweepRecorder(double deadband = 0.01) : m_deadband(deadband) {}
+
+    void setDeadband(double deadband) { m_deadband = deadband; }
+    void clear();
+    void add(std::int64_t timestampUs, double pressure, double angleDeg);
+
+    const std::vector<SweepSample>& samples() const { return m_samples; }
+    int direction() const { return m_direction; }
+    double peakPressure() const { return m_peak; }
+
+private:
+    double m_deadband;
+    std::vector<SweepSample> m_samples;
+    int m_direction = 1;
+    double m_extreme = 0.0;     // 当前行程到目前为止的最高/最低压力
+    double m_peak = 0.0;
+};
+
+struct SweepPointResult {
+    double pressure = 0.0;
+    bool hasForward = false, hasBackward = false;
+    double forwardAngle = 0.0, backwardAngle = 0.0;     // 检测点处回归得到的角度
+    int forwardSamples = 0, backwardSamples = 0;        // 参与回归的样本数
+    double expectedAngle = 0.0;                         // 理论角度 = 压力/满量程 × 满量程角度
+    double forwardErrDeg = 0.0, backwardErrDeg = 0.0;
+    double forwardErrMPa = 0.0, backwardErrMPa = 0.0;
+    double hysteresisDeg = 0.0, hysteresisMPa = 0.0;   // |反 - 正|
+};
+
+struct SweepResult {
+    bool ok = false;
+    std::vector<double> coeffs;          // 标定曲线 angle = Σ c_k (p/满量程)^k，正反行程合并
+    double rmsResidualDeg = 0.0;         // 曲线拟合残差
+    double fullScalePressure = 0.0;
+    double fullScaleAngle = 0.0;         // 满量程处的角度（相当于"最大角度"）
+    std::vector<SweepPointResult> points;
+    double maxAbsErrMPa = 0.0;           // 各点正反行程误差绝对值的最大值
+    double maxHysteresisMPa = 0.0;
+    int forwardCount = 0, backwardCount = 0;
+
+    double curveAngle(double pressure) const;
+};
+
+// halfWindow：检测点两侧参与局部回归的压力范围（<=0 时取满量程的 3%）
+SweepResult fitSweep(const std::vector<SweepSample>& samples, const std::vector<double>& detectionPoints,
+                     double fullScalePressure, int polyDegree = 3, double halfWindow = 0.0);
+
+#endif // SWEEPCALIBRATION_H
@@ -0,0 +1,200 @@
+#include "anglerecorddialog.h"
+
+#include <QComboBox>
+#include <QDateTime>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPushButton>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <cmath>
+
+// ---------------- AnglePlotWidget ----------------
+
+AnglePlotWidget::AnglePlotWidget(QWidget* parent) : QWidget(parent)
+{
+    setMinimumSize(600, 320);
+    setAutoFillBackground(true);
+    QPalette pal = palette();
+    pal.setColor(QPalette::Window, Qt::white);
+    setPalette(pal);
+}
+
+void AnglePlotWidget::setRecords(std::vector<AngleRecord> records)
+{
+    m_records = std::move(records);
+    update();
+}
+
+void AnglePlotWidget::paintEvent(QPaintEvent*)
+{
+    QPainter p(this);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    const QRectF area = QRectF(rect()).adjusted(60, 15, -15, -35);
+    p.setPen(QColor(200, 200, 200));
+    p.drawRect(area);
+
+    if (m_records.size() < 2) {
+        p.setPen(Qt::gray);
+        p.drawText(area, Qt::AlignCenter, "暂无记录");
+        return;
+    }
+
+    const double t0 = double(m_records.front().timestampUs);
+    const double t1 = std::max(t0 + 1.0, double(m_records.back().timestampUs));
+    double yMin = 1e9, yMax = -1e9;
+    for (const auto& r : m_records) {
+        if (std::isnan(r.absDeg)) continue;
+        yMin = std::min(yMin, r.relativeDeg);
+        yMax = std::max(yMax, r.relativeDeg);
+    }
+    if (yMin > yMax) { yMin = 0; yMax = 1; }
+    const double pad = std::max(1.0, (yMax - yMin) * 0.05);
+    yMin -= pad;
+    yMax += pad;
+
+    auto mapX = [&](std::int64_t t) { return area.left() + (t - t0) / (t1 - t0) * area.width(); };
+    auto mapY = [&](double v) { return area.bottom() - (v - yMin) / (yMax - yMin) * area.height(); };
+
+    // 坐标轴刻度
+    p.setPen(Qt::darkGray);
+    QFont f = p.font();
+    f.setPointSize(8);
+    p.setFont(f);
+    for (int i = 0; i <= 4; ++i) {
+        double v = yMin + (yMax - yMin) * i / 4.0;
+        double y = mapY(v);
+        p.setPen(QColor(235, 235, 235));
+        p.drawLine(QPointF(area.left(), y), QPointF(area.right(), y));
+        p.setPen(Qt::darkGray);
+        p.drawText(QRectF(0, y - 8, area.left() - 6, 16), Qt::AlignRight | Qt::AlignVCenter, QString::number(v, 'f', 1) + "°");
+    }
+    p.drawText(QRectF(area.left(), area.bottom() + 4, 200, 16), Qt::AlignLeft,
+               QDateTime::fromMSecsSinceEpoch(qint64(t0 / 1000)).toString("HH:mm:ss"));
+    p.drawText(QRectF(area.right() - 200, area.bottom() + 4, 200, 16), Qt::AlignRight,
+               QDateTime::fromMSecsSinceEpoch(qint64(t1 / 1000)).toString("HH:mm:ss"));
+
+    // 曲线：点数多时按像素列抽稀，按行程方向分色（正行程蓝、反行程红、未判定灰）
+    const int columns = std::max(1, int(area.width()));
+    const size_t step = std::max<size_t>(1, m_records.size() / (size_t(columns) * 2));
+    QPointF prev;
+    bool hasPrev = false;
+    for (size_t i = 0; i < m_records.size(); i += step) {
+        const AngleRecord& r = m_records[i];
+        if (std::isnan(r.absDeg)) { hasPrev = false; continue; }
+        QPointF pt(mapX(r.timestampUs), mapY(r.relativeDeg));
+        if (hasPrev) {
+            QColor c = r.direction > 0 ? QColor(41, 128, 185) : r.direction < 0 ? QColor(192, 57, 43) : QColor(127, 140, 141);
+            p.setPen(QPen(c, 1.5));
+            p.drawLine(prev, pt);
+        }
+        prev = pt;
+        hasPrev = true;
+    }
+
+    // 采集/归位点不抽稀，全部标出
+    for (const auto& r : m_records) {
+        if (r.event == AngleRecordEvent::Live || std::isnan(r.absDeg)) continue;
+        p.setPen(Qt::NoPen);
+        p.setBrush(r.event == AngleRecordEvent::Zero ? QColor(243, 156, 18) : QColor(39, 174, 96));
+        p.drawEllipse(QPointF(mapX(r.timestampUs), mapY(r.relativeDeg)), 4, 4);
+    }
+}
+
+// ---------------- AngleRecordDialog ----------------
+
+AngleRecordDialog::AngleRecordDialog(AngleRecorder* recorder, QWidget* parent)
+    : QDialog(parent), m_recorder(recorder)
+{
+    setWindowTitle("角度记录曲线");
+    resize(900, 500);
+    buildUi();
+    refresh();
+}
+
+void AngleRecordDialog::buildUi()
+{
+    auto* layout = new QVBoxLayout(this);
+
+    auto* bar = new QHBoxLayout;
+    bar->addWidget(new QLabel("时间范围:", this));
+    m_rangeCombo = new QComboBox(this);
+    m_rangeCombo->addItem("最近1分钟", 60);
+    m_rangeCombo->addItem("最近5分钟", 300);
+    m_rangeCombo->addItem("最近30分钟", 1800);
+    m_rangeCombo->addItem("全部", 0);
+    m_rangeCombo->setCurrentIndex(1);
+    bar->addWidget(m_rangeCombo);
+    bar->addStretch();
+    m_infoLabel = new QLabel(this);
+    bar->addWidget(m_infoLabel);
+    auto* refreshBtn = new QPushButton("刷新", this);
+    auto* exportBtn = new QPushButton("导出CSV", this);
+    bar->addWidget(refreshBtn);
+    bar->addWidget(exportBtn);
+    layout->addLayout(bar);
+
+    m_plot = new AnglePlotWidget(this);
+    layout->addWidget(m_plot, 1);
+
+    auto* legend = new QLabel("<span style='color:#2980B9'>━ 正行程</span>&nbsp;&nbsp;"
+                              "<span style='color:#C0392B'>━ 反行程</span>&nbsp;&nbsp;"
+                              "<span style='color:#27AE60'>● 采集</span>&nbsp;&nbsp;"
+                              "<span style='color:#F39C12'>● 归位</span>", this);
+    layout->addWidget(legend);
+
+    connect(m_rangeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &AngleRecordDialog::refresh);
+    connect(refreshBtn, &QPushButton::clicked, this, &AngleRecordDialog::refresh);
+    connect(exportBtn, &QPushButton::clicked, this, &AngleRecordDialog::exportCsv);
+
+    // 打开期间每秒刷新一次
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(1000);
+    connect(m_refreshTimer, &QTimer::timeout, this, &AngleRecordDialog::refresh);
+    m_refreshTimer->start();
+}
+
+void AngleRecordDialog::refresh()
+{
+    if (!m_recorder || !m_recorder->isOpen()) {
+        m_infoLabel->setText("记录文件未打开");
+        m_plot->setRecords({});
+        return;
+    }
+
+    std::vector<AngleRecord> records = m_recorder->snapshot();
+    const int seconds = m_rangeCombo->currentData().toInt();
+    if (seconds > 0 && !records.empty()) {
+        const std::int64_t from = records.back().timestampUs - std::int64_t(seconds) * 1000000;
+        auto it = std::lower_bound(records.begin(), records.end(), from,
+                                   [](const AngleRecord& r, std::int64_t t) { return r.timestampUs < t; });
+        records.erase(records.begin(), it);
+    }
+    m_infoLabel->setText(QString("显示 %1 条 / 累计 %2 条").arg(records.size()).arg(m_recorder->totalWritten()));
+    m_plot->setRecords(std::move(records));
+}
+
+void AngleRecordDialog::exportCsv()
+{
+    if (!m_recorder || !m_recorder->isOpen()) return;
+
+    QString fileName = QFileDialog::getSaveFileName(this, "导出角度记录",
+        QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/角度记录_" +
+            QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + ".csv",
+        "CSV文件 (*.csv)");
+    if (fileName.isEmpty()) return;
+
+    QString error;
+    if (!m_recorder->exportCsv(fileName, &error)) {
+        QMessageBox::warning(this, "导出失败", QString("无法写入文件：%1").arg(error));
+        return;
+    }
+    QMessageBox::information(this, "导出成功", QString("角度记录已导出到：\n%1").arg(fileName));
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <QDialog>
+#include <vector>
+
+#include "anglerecorder.h"
+
+class QComboBox;
+class QLabel;
+class QTimer;
+
+// 角度记录曲线：相对角-时间，正/反行程分色，采集点打标记；可导出 CSV
+class AnglePlotWidget : public QWidget {
+public:
+    explicit AnglePlotWidget(QWidget* parent = nullptr);
+    void setRecords(std::vector<AngleRecord> records);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    std::vector<AngleRecord> m_records;
+};
+
+class AngleRecordDialog : public QDialog {
+    Q_OBJECT
+public:
+    AngleRecordDialog(AngleRecorder* recorder, QWidget* parent = nullptr);
+    ~AngleRecordDialog() override = default;
+
+private slots:
+    void refresh();
+    void exportCsv();
+
+private:
+    void buildUi();
+
+    AngleRecorder* m_recorder = nullptr;
+    AnglePlotWidget* m_plot = nullptr;
+    QComboBox* m_rangeCombo = nullptr;
+    QLabel* m_infoLabel = nullptr;
+    QTimer* m_refreshTimer = nullptr;
+};
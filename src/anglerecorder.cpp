@@ -0,0 +1,170 @@
+#include "anglerecorder.h"
+
+#include <QDebug>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QDir>
+#include <QTextStream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <new>
+
+namespace {
+const char kMagic[8] = {'A', 'N', 'G', 'R', 'I', 'N', 'G', '1'};
+constexpr std::uint32_t kVersion = 1;
+}
+
+AngleRecorder::~AngleRecorder()
+{
+    close();
+}
+
+bool AngleRecorder::open(const QString& path, quint64 capacity)
+{
+    close();
+    if (capacity == 0) return false;
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qDebug() << "角度记录文件打开失败:" << path << m_file.errorString();
+        return false;
+    }
+
+    const qint64 bytes = qint64(sizeof(Header) + capacity * sizeof(Slot));
+    bool reuse = false;
+    if (m_file.size() == bytes) {
+        Header existing;
+        m_file.seek(0);
+        if (m_file.read(reinterpret_cast<char*>(&existing), sizeof(Header)) == qint64(sizeof(Header))) {
+            reuse = std::memcmp(existing.magic, kMagic, sizeof(kMagic)) == 0 && existing.version == kVersion
+                    && existing.recordSize == sizeof(AngleRecord) && existing.capacity == capacity;
+        }
+    }
+    if (!reuse && !m_file.resize(bytes)) {
+        qDebug() << "角度记录文件分配失败:" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    uchar* base = m_file.map(0, bytes);
+    if (!base) {
+        qDebug() << "角度记录文件映射失败:" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    if (reuse) {
+        m_header = reinterpret_cast<Header*>(base);
+        m_slots = reinterpret_cast<Slot*>(base + sizeof(Header));
+        // 上次异常退出时可能留下"正在写"的槽位，序号归偶
+        for (quint64 i = 0; i < capacity; ++i) {
+            std::uint32_t s = m_slots[i].seq.load(std::memory_order_relaxed);
+            if (s & 1u) m_slots[i].seq.store(s + 1, std::memory_order_relaxed);
+        }
+    } else {
+        std::memset(base, 0, size_t(bytes));
+        m_header = new (base) Header;
+        std::memcpy(m_header->magic, kMagic, sizeof(kMagic));
+        m_header->version = kVersion;
+        m_header->recordSize = sizeof(AngleRecord);
+        m_header->capacity = capacity;
+        m_header->writeIndex.store(0, std::memory_order_relaxed);
+        m_slots = reinterpret_cast<Slot*>(base + sizeof(Header));
+        for (quint64 i = 0; i < capacity; ++i) new (&m_slots[i]) Slot{};
+    }
+    m_capacity = capacity;
+
+    qDebug() << "角度记录文件:" << path << "容量" << capacity << "帧" << (reuse ? "(续写)" : "(新建)")
+             << "已有" << totalWritten() << "条";
+    return true;
+}
+
+void AngleRecorder::close()
+{
+    if (m_header) {
+        m_file.unmap(reinterpret_cast<uchar*>(m_header));
+        m_header = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+    }
+    if (m_file.isOpen()) m_file.close();
+}
+
+void AngleRecorder::append(const AngleRecord& record) noexcept
+{
+    if (!m_header) return;
+
+    const std::uint64_t idx = m_header->writeIndex.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = m_slots[idx % m_capacity];
+
+    const std::uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq | 1u, std::memory_order_relaxed);       // 标记正在写
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.record = record;
+    slot.seq.store((seq | 1u) + 1, std::memory_order_release);  // 写完，序号变偶
+}
+
+quint64 AngleRecorder::totalWritten() const
+{
+    return m_header ? m_header->writeIndex.load(std::memory_order_acquire) : 0;
+}
+
+std::vector<AngleRecord> AngleRecorder::snapshot(quint64 maxCount) const
+{
+    std::vector<AngleRecord> out;
+    if (!m_header) return out;
+
+    const quint64 end = totalWritten();
+    const quint64 available = std::min<quint64>(end, m_capacity);
+    const quint64 count = std::min(available, maxCount);
+    out.reserve(size_t(count));
+
+    for (quint64 i = end - count; i < end; ++i) {
+        const Slot& slot = m_slots[i % m_capacity];
+        const std::uint32_t s1 = slot.seq.load(std::memory_order_acquire);
+        if (s1 & 1u) continue;
+        AngleRecord rec = slot.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != s1) continue;  // 读的过程中被覆盖
+        if (rec.timestampUs == 0) continue;                            // 未写过的槽位
+        out.push_back(rec);
+    }
+    return out;
+}
+
+bool AngleRecorder::exportCsv(const QString& csvPath, QString* error) const
+{
+    QFile out(csvPath);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (error) *error = out.errorString();
+        return false;
+    }
+
+    const std::vector<AngleRecord> records = snapshot();
+    QTextStream ts(&out);
+    ts.setEncoding(QStringConverter::Utf8);
+    ts << "time,timestamp_us,event,slot,abs_deg,unwrapped_deg,relative_deg,direction,confidence\n";
+    for (const AngleRecord& r : records) {
+        const char* ev = r.event == AngleRecordEvent::Capture ? "capture"
+                       : r.event == AngleRecordEvent::Zero    ? "zero"
+                                                              : "live";
+        ts << QDateTime::fromMSecsSinceEpoch(r.timestampUs / 1000).toString("yyyy-MM-dd HH:mm:ss.zzz") << ','
+           << r.timestampUs << ',' << ev << ',' << (r.slot + 1) << ','
+           << (std::isnan(r.absDeg) ? QString() : QString::number(r.absDeg, 'f', 3)) << ','
+           << QString::number(r.unwrappedDeg, 'f', 3) << ','
+           << QString::number(r.relativeDeg, 'f', 3) << ','
+           << int(r.direction) << ','
+           << QString::number(r.confidence, 'f', 4) << '\n';
+    }
+    qDebug() << "角度记录已导出:" << csvPath << records.size() << "条";
+    return true;
+}
+
+std::int64_t AngleRecorder::nowUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
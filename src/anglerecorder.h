@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// ================== 逐帧角度记录（内存映射环形文件） ==================
+// 每处理一帧就追加一条定长记录：时间戳、绝对角、展开角、相对角、行程方向、置信度。
+// 文件 = 64字节文件头 + capacity 个定长槽位，写满后从头覆盖（只保留最近 capacity 帧）。
+// 写入不加锁：写指针用原子 fetch_add 占位，每个槽位带序号（seqlock），
+// 读取端（导出/曲线）遇到正在写的槽位直接跳过，不会阻塞识别线程。
+// 文件映射由系统负责落盘，程序崩溃后历史仍可用于分析卡滞/回差。
+
+enum class AngleRecordEvent : std::uint8_t {
+    Live = 0,      // 实时探测帧
+    Capture = 1,   // "采集"按钮/自动采集
+    Zero = 2       // "归位"
+};
+
+struct AngleRecord {
+    std::int64_t timestampUs = 0;  // 自 1970 起的微秒
+    double absDeg = 0.0;           // 绝对角 0~360，识别失败为 NaN
+    double unwrappedDeg = 0.0;     // 展开角（连续角）
+    double relativeDeg = 0.0;      // 相对零位的角度
+    float confidence = 0.0f;       // 0~1（滑动窗口合成向量长度，失败帧为0）
+    std::int8_t direction = 0;     // 1=正行程 -1=反行程 0=未判定
+    std::uint8_t slot = 0;         // 表位编号
+    AngleRecordEvent event = AngleRecordEvent::Live;
+    std::uint8_t reserved = 0;
+};
+static_assert(sizeof(AngleRecord) == 40, "AngleRecord 是文件格式的一部分，改动需同时升级版本号");
+
+class AngleRecorder {
+public:
+    AngleRecorder() = default;
+    ~AngleRecorder();
+    AngleRecorder(const AngleRecorder&) = delete;
+    AngleRecorder& operator=(const AngleRecorder&) = delete;
+
+    // 打开/创建环形文件；已有文件且容量一致时接着写，否则重建
+    bool open(const QString& path, quint64 capacity = 1 << 18);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+    QString path() const { return m_file.fileName(); }
+
+    // 追加一条记录（无锁，可在识别线程调用）
+    void append(const AngleRecord& record) noexcept;
+
+    quint64 capacity() const { return m_capacity; }
+    quint64 totalWritten() const;   // 累计写入条数（含已被覆盖的）
+
+    // 取最近 maxCount 条（按时间顺序），正在写的槽位跳过
+    std::vector<AngleRecord> snapshot(quint64 maxCount = ~quint64(0)) const;
+
+    // 导出为 CSV（UTF-8，带表头）
+    bool exportCsv(const QString& csvPath, QString* error = nullptr) const;
+
+    static std::int64_t nowUs();
+
+private:
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t recordSize;
+        std::uint64_t capacity;
+        std::atomic<std::uint64_t> writeIndex;  // 下一个要写的全局序号
+        std::uint8_t reserved[32];
+    };
+    struct Slot {
+        std::atomic<std::uint32_t> seq;  // 奇数=正在写
+        std::uint32_t pad;
+        AngleRecord record;
+    };
+    static_assert(sizeof(Header) == 64, "文件头固定64字节");
+    static_assert(sizeof(Slot) == 48, "槽位固定48字节");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "需要无锁64位原子");
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "需要无锁32位原子");
+
+    QFile m_file;
+    Header* m_header = nullptr;
+    Slot* m_slots = nullptr;
+    quint64 m_capacity = 0;
+};
@@ -0,0 +1,352 @@
+#include "dialbatch.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <atomic>
+#include <climits>
+#include <memory>
+
+#include "dialrenderer.h"
+#include "gaugereport.h"
+#include "lotreport.h"
+
+namespace {
+
+// 一行 CSV 拆成字段：与 csvLine 相反，引号里的逗号不拆，"" 还原成 "
+QStringList parseCsvLine(const QString& line)
+{
+    QStringList fields;
+    QString field;
+    bool quoted = false;
+    for (int i = 0; i < line.size(); ++i) {
+        const QChar c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                field += '"';
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields << field;
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    fields << field;
+    return fields;
+}
+
+// 检测点行：标题后面到第一个空列为止都是数值
+bool parsePointRow(const QStringList& row, QVector<double>& values)
+{
+    values.clear();
+    for (int i = 1; i < row.size() && !row[i].trimmed().isEmpty(); ++i) {
+        bool ok = false;
+        const double v = row[i].trimmed().toDouble(&ok);
+        if (!ok) return false;
+        values.append(v);
+    }
+    return !values.isEmpty();
+}
+
+// 报表文件名带结论前缀（合格_ / 不合格_ / 未完成_），去掉前缀剩下表号；返回结论，没有前缀按合格算
+int takeVerdictPrefix(QString& name)
+{
+    if (name.startsWith(QStringLiteral("不合格_"))) {
+        name.remove(0, 4);
+        return 0;
+    }
+    if (name.startsWith(QStringLiteral("未完成_"))) {
+        name.remove(0, 4);
+        return -1;
+    }
+    if (name.startsWith(QStringLiteral("合格_"))) name.remove(0, 3);
+    return 1;
+}
+
+QString statusText(const DialBatchItem& item)
+{
+    if (!item.error.isEmpty()) return "失败：" + item.error;
+    if (!item.skipped.isEmpty()) return "跳过：" + item.skipped;
+    return "已生成";
+}
+
+// 表盘清单：概况 + 每块表一行（输入顺序）
+QVector<QStringList> listRows(const DialBatchSummary& s, const DialBatchOptions& options, int threads)
+{
+    QVector<QStringList> rows;
+    rows.reserve(s.items.size() + 4);
+    rows << QStringList{"表盘清单"};
+    rows << QStringList{"生成时间：", QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss"), "", "处理线程：",
+                        QString::number(threads), "", "格式：", options.format.toUpper()};
+    rows << QStringList{"共计：", QString::number(s.items.size()), "", "已生成：", QString::number(s.renderedCount),
+                        "", "跳过：", QString::number(s.skippedCount), "", "失败：", QString::number(s.failedCount),
+                        "", "耗时（ms）：", QString::number(s.elapsedMs)};
+    rows << QStringList();
+    rows << QStringList{"序号", "来源", "产品型号", "支组编号", "表号", "最大压力（MPa）", "总角度", "检测点数", "输出文件", "状态"};
+    for (int i = 0; i < s.items.size(); ++i) {
+        const DialBatchItem& it = s.items[i];
+        const bool loaded = !it.productModel.isEmpty();
+        rows << QStringList{QString::number(i + 1), it.source, it.productModel, it.groupNo, it.key,
+                            loaded ? QString::number(it.maxPressure, 'f', 1) : QString("--"),
+                            loaded ? QString::number(it.totalAngle, 'f', 2) : QString("--"),
+                            QString::number(it.points.size()),
+                            it.skipped.isEmpty() && it.error.isEmpty() ? QFileInfo(it.outputFile).fileName() : QString(),
+                            statusText(it)};
+    }
+    return rows;
+}
+
+// 检测记录 → 表盘参数，和误差表格的"最终数据"同一口径
+void fillFromRecord(DialBatchItem& item, const SessionRecord& rec, const GaugeReport& report)
+{
+    item.productModel = rec.productModel;
+    item.groupNo = rec.groupNo;
+    item.gaugeSerial = rec.gaugeSerial;
+    item.passed = report.passed;
+    item.maxPressure = modelFullScalePressureMPa(rec.productModel, rec.maxPressure);
+    item.totalAngle = rec.avgMaxAngle;
+    item.points = rec.detectionPoints;
+    item.pointsAngle = report.pointAngles;
+}
+
+// 按型号套配置、录制场景、写文件；失败原因写进 item.error
+void renderItem(DialRenderer& renderer, DialBatchItem& item, const QString& format)
+{
+    if (item.points.isEmpty() || item.points.size() != item.pointsAngle.size()) {
+        item.error = "检测点和角度数据不完整";
+        return;
+    }
+    if (item.totalAngle <= 0.0) {
+        item.error = "没有平均最大角度";
+        return;
+    }
+
+    BYQDialConfig byq;
+    YYQYDialConfig yyqy;
+    if (item.productModel == "BYQ-19") {
+        // BYQ 表盘按第 6 个节点取满量程角度
+        if (item.points.size() < 6) {
+            item.error = QString("BYQ-19 表盘需要至少 6 个检测点（只有 %1 个）").arg(item.points.size());
+            return;
+        }
+        byq.maxPressure = item.maxPressure;
+        byq.totalAngle = item.totalAngle;
+        byq.points = item.points;
+        byq.pointsAngle = item.pointsAngle;
+    } else if (item.productModel == "YYQY-13") {
+        yyqy.maxPressure = item.maxPressure;
+        yyqy.totalAngle = item.totalAngle;
+        yyqy.points = item.points;
+        yyqy.pointsAngle = item.pointsAngle;
+    } else {
+        item.error = QString("不支持的型号 %1").arg(item.productModel);
+        return;
+    }
+
+    const DialRenderer::Scene scene = renderer.buildScene(item.productModel, byq, yyqy);
+    if (format == "pdf" || format == "svg") {
+        const QString title = QString("%1 表盘 %2").arg(item.productModel, item.key);
+        DialRenderer::exportVector(scene, item.outputFile, title, item.error);
+        return;
+    }
+    const QImage img = renderer.render(scene);
+    QString formatName;
+    if (img.isNull() || !renderer.saveImage(img, item.outputFile, DialRenderer::outputDpi(item.productModel), formatName)) {
+        item.error = QString("写入 %1 失败").arg(item.outputFile);
+    }
+}
+
+} // namespace
+
+bool loadGaugeReportCsv(const QString& path, DialBatchItem& item, QString& error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        error = QString("无法打开 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    QTextStream in(&file);
+    in.setEncoding(QStringConverter::Utf8);   // 自动跳过 BOM
+
+    bool hasModel = false, hasAngle = false;
+    QVector<double> points, angles;
+    while (!in.atEnd()) {
+        const QStringList row = parseCsvLine(in.readLine());
+        const QString title = row.value(0).trimmed();
+        if (title == "产品型号：") {
+            item.productModel = row.value(1).trimmed();
+            hasModel = true;
+        } else if (title == "刻度盘图号：") {
+            item.groupNo = row.value(4).trimmed();
+        } else if (title == "平均最大总角度：") {
+            item.totalAngle = row.value(1).trimmed().toDouble(&hasAngle);
+        } else if (title == "检测点") {
+            if (!parsePointRow(row, points)) break;
+        } else if (title == "检测点对应的刻度盘角度") {
+            parsePointRow(row, angles);
+            break;   // 后面是逐轮数据，用不到
+        }
+    }
+    if (!hasModel || !hasAngle || points.isEmpty() || points.size() != angles.size()) {
+        error = QString("%1 不是 合格_.csv 排版的报表").arg(QFileInfo(path).fileName());
+        return false;
+    }
+
+    QString base = QFileInfo(path).completeBaseName();
+    item.passed = takeVerdictPrefix(base);
+    item.gaugeSerial = base;
+    item.maxPressure = modelFullScalePressureMPa(item.productModel, points.last());
+    item.points = points;
+    item.pointsAngle = angles;
+    return true;
+}
+
+bool runDialBatch(const DialBatchOptions& options, DialBatchSummary& summary, QString& error,
+                  const std::function<void(int, int)>& progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+    summary = DialBatchSummary();
+    const QString format = options.format.toLower();
+    if (!QStringList{"tif", "png", "pdf", "svg"}.contains(format)) {
+        error = QString("不支持的输出格式 %1（可选 tif、png、pdf、svg）").arg(options.format);
+        return false;
+    }
+    const QDir outDir(options.outDir);
+    if (!QDir().mkpath(options.outDir)) {
+        error = "无法创建输出目录 " + options.outDir;
+        return false;
+    }
+
+    // 任务列表；表号（文件名）在开工前按输入顺序定好
+    QVector<DialBatchItem>& items = summary.items;
+    QVector<qint64> ids;
+    const bool fromDatabase = options.files.isEmpty();
+    if (fromDatabase) {
+        SessionDatabase db("dial_batch_query");
+        if (!db.open(options.dbPath)) {
+            error = db.lastError();
+            return false;
+        }
+        const QVector<SessionSummary> list = db.querySessions(options.filter, INT_MAX);
+        if (!db.lastError().isEmpty()) {
+            error = db.lastError();
+            return false;
+        }
+        // 查询按保存时间倒序，清单按时间正序
+        for (auto it = list.crbegin(); it != list.crend(); ++it) {
+            DialBatchItem item;
+            item.source = QString("#%1").arg(it->id);
+            item.key = it->gaugeSerial.isEmpty() ? item.source : it->gaugeSerial;
+            items.append(item);
+            ids.append(it->id);
+        }
+    } else {
+        for (const QString& path : options.files) {
+            DialBatchItem item;
+            item.source = path;
+            item.key = QFileInfo(path).completeBaseName();
+            if (path.endsWith(".csv", Qt::CaseInsensitive)) takeVerdictPrefix(item.key);
+            items.append(item);
+        }
+    }
+    if (items.isEmpty()) {
+        error = "没有符合条件的检测记录";
+        return false;
+    }
+    QStringList keys;
+    for (const DialBatchItem& item : items) keys << item.key;
+    keys = uniqueFileKeys(keys);
+    for (int i = 0; i < items.size(); ++i) items[i].key = keys[i];
+
+    const int total = items.size();
+    const int threads = qBound(1, options.threads > 0 ? options.threads : QThread::idealThreadCount(), total);
+    DialBatchItem* results = items.data();   // 先取指针：各线程只写自己那一项，不触发 QVector 的共享检查
+    const qint64* idData = ids.constData();
+    std::atomic<int> next{0};
+    std::atomic<int> done{0};
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for (int w = 0; w < threads; ++w) {
+        pool.start([&, w]() {
+            // 渲染器带层缓存和商标缓存，每个工作线程一个；已经按表并行了，单张图内部不再分块
+            DialRenderer renderer;
+            renderer.setParallel(false);
+            if (!options.logoPath.isEmpty()) renderer.setLogoPath(options.logoPath);
+
+            std::unique_ptr<SessionDatabase> db;
+            QString dbError;
+            if (fromDatabase) {
+                db = std::make_unique<SessionDatabase>(QString("dial_batch_%1").arg(w));
+                if (!db->open(options.dbPath)) dbError = db->lastError();
+            }
+            for (int i = next++; i < total; i = next++) {
+                DialBatchItem& item = results[i];
+                bool loaded = false;
+                if (!fromDatabase && item.source.endsWith(".csv", Qt::CaseInsensitive)) {
+                    loaded = loadGaugeReportCsv(item.source, item, item.error);
+                } else {
+                    SessionRecord rec;
+                    double nominalFsAngle = 0.0, nominalFsPressure = 0.0;
+                    if (fromDatabase) {
+                        loaded = dbError.isEmpty() && db->loadSession(idData[i], rec);
+                        if (!loaded) item.error = dbError.isEmpty() ? db->lastError() : dbError;
+                        // 数据库里没有存配置的满量程角度，用平均最大角度作名义满量程（与批量报表一致）
+                        nominalFsAngle = rec.avgMaxAngle;
+                        nominalFsPressure = rec.maxPressure;
+                    } else {
+                        loaded = loadSessionFile(item.source, rec, nominalFsAngle, nominalFsPressure, item.error);
+                    }
+                    if (loaded) fillFromRecord(item, rec, buildGaugeReport(rec, nominalFsAngle, nominalFsPressure));
+                }
+
+                if (loaded) {
+                    // 界面里也要全部轮次完成才有"最终数据"
+                    if (item.passed < 0) {
+                        item.skipped = "检测未完成";
+                    } else if (item.passed == 0 && !options.includeFailed) {
+                        item.skipped = "不合格";
+                    } else {
+                        item.outputFile = outDir.filePath(safeFileName(item.productModel) + "_" + item.key + "." + format);
+                        renderItem(renderer, item, format);
+                    }
+                }
+                ++done;
+            }
+        });
+    }
+    // 调用线程只负责报进度
+    while (!pool.waitForDone(200)) {
+        if (progress) progress(done.load(), total);
+    }
+    if (progress) progress(total, total);
+
+    for (const DialBatchItem& item : items) {
+        if (!item.error.isEmpty()) {
+            ++summary.failedCount;
+        } else if (!item.skipped.isEmpty()) {
+            ++summary.skippedCount;
+        } else {
+            ++summary.renderedCount;
+        }
+    }
+    summary.elapsedMs = timer.elapsed();
+
+    summary.listFile = outDir.filePath("表盘清单.csv");
+    if (!writeCsv(summary.listFile, listRows(summary, options, threads), error)) return false;
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+#include "sessiondatabase.h"
+
+// ================== 按检测结果批量出表盘 ==================
+// 一批表各自的检测点和"检测点对应的刻度盘角度"（合格_.csv 报表、会话文件或检测记录数据库），
+// 按型号套进 BYQ-19 / YYQY-13 表盘配置，在线程池里并行渲染并写出成图，一整批无人值守跑完。
+// 每个工作线程一个 DialRenderer（层缓存、商标缓存不跨线程），单张图内部不再分块并行；
+// 文件名 <型号>_<表号>.<格式> 在开工前按输入顺序定好，与线程调度无关。
+// 表盘参数与界面"应用最终数据"一致：总角度 = 平均最大角度，最大压力 = 型号满量程，
+// 各点角度 = 跨轮正反平均角度（没有成对数据时用名义角度）。
+// 全部完成后按输入顺序写一份表盘清单。
+
+struct DialBatchOptions {
+    QStringList files;             // 合格_.csv 报表，或会话文件（.pgs / JSON）；为空时从数据库取
+    QString dbPath;                // 检测记录数据库
+    SessionFilter filter;          // 数据库查询条件
+    QString outDir;                // 输出目录（不存在则创建）
+    QString format = "tif";        // tif（CMYK）、png、pdf、svg
+    bool includeFailed = false;    // 不合格的表也出表盘（未完成的始终跳过）
+    int threads = 0;               // 0 = 按 CPU 核数
+    QString logoPath;              // YYQY 商标图片，空 = 程序目录下的 images/logo_region.png
+};
+
+struct DialBatchItem {
+    QString source;                // 数据库记录号或文件路径
+    QString key;                   // 文件名里的表号部分（批内唯一）
+    QString productModel;
+    QString groupNo;
+    QString gaugeSerial;
+    int passed = -1;               // -1=未完成 0=不合格 1=合格
+    double maxPressure = 0.0;      // 表盘最大压力（型号满量程）
+    double totalAngle = 0.0;       // 表盘总角度（平均最大角度）
+    QVector<double> points;        // 检测点压力
+    QVector<double> pointsAngle;   // 检测点对应的刻度盘角度
+    QString outputFile;
+    QString skipped;               // 非空表示按条件跳过（原因）
+    QString error;                 // 非空表示读取、校验或写出失败
+};
+
+struct DialBatchSummary {
+    QVector<DialBatchItem> items;  // 与输入顺序一致
+    int renderedCount = 0;
+    int skippedCount = 0;
+    int failedCount = 0;
+    qint64 elapsedMs = 0;
+    QString listFile;
+};
+
+// 阻塞运行；progress 在调用线程里周期性回调（已处理块数, 总块数）。
+// 渲染用到字体，调用前要有 QGuiApplication（无界面时用 offscreen 平台）
+bool runDialBatch(const DialBatchOptions& options, DialBatchSummary& summary, QString& error,
+                  const std::function<void(int, int)>& progress = {});
+
+// 读一份 合格_.csv 排版的报表（界面"导出Excel"、批量报表输出的 CSV）：型号、支组编号、平均最大总角度、
+// 检测点和对应角度；结论取文件名前缀（合格_ / 不合格_ / 未完成_，没有前缀按合格算），表号取去掉前缀的文件名
+bool loadGaugeReportCsv(const QString& path, DialBatchItem& item, QString& error);
@@ -0,0 +1,78 @@
+// 批量出表盘：按一批表的检测结果（各点角度、平均最大角度）并行生成 BYQ-19 / YYQY-13 表盘成图，外加表盘清单。不需要界面。
+// 用法：
+//   dial_batch --out <目录> [--db <检测记录库>] [--model 型号] [--group 支组编号] [--from yyyy-MM-dd] [--to yyyy-MM-dd]
+//              [--format tif|png|pdf|svg] [--include-failed] [--logo 商标图片] [--threads N] [文件...]
+// 给了文件就处理这些文件（合格_.csv 报表，或自动保存的 .pgs / 导出的 json 会话文件）；否则按条件从检测记录数据库取。
+
+#include <QCommandLineParser>
+#include <QDate>
+#include <QGuiApplication>
+#include <QTextStream>
+
+#include "dialbatch.h"
+
+int main(int argc, char* argv[])
+{
+    // 画字要有 QGuiApplication；没有显示器的机器上用 offscreen 平台
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("dial_batch");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("按检测结果批量生成表盘（并行）");
+    parser.addHelpOption();
+    QCommandLineOption outOpt("out", "输出目录", "dir");
+    QCommandLineOption dbOpt("db", "检测记录数据库", "path", SessionDatabase::defaultPath());
+    QCommandLineOption modelOpt("model", "产品型号", "model");
+    QCommandLineOption groupOpt("group", "支组编号", "group");
+    QCommandLineOption fromOpt("from", "起始日期 yyyy-MM-dd", "date");
+    QCommandLineOption toOpt("to", "截止日期 yyyy-MM-dd", "date");
+    QCommandLineOption formatOpt("format", "输出格式 tif（CMYK）/png/pdf/svg", "format", "tif");
+    QCommandLineOption failedOpt("include-failed", "不合格的表也出表盘");
+    QCommandLineOption logoOpt("logo", "YYQY 商标图片（默认程序目录下的 images/logo_region.png）", "path");
+    QCommandLineOption threadsOpt("threads", "工作线程数（默认按 CPU 核数）", "n", "0");
+    parser.addOptions({outOpt, dbOpt, modelOpt, groupOpt, fromOpt, toOpt, formatOpt, failedOpt, logoOpt, threadsOpt});
+    parser.addPositionalArgument("files", "合格_.csv 报表或会话文件（可选）", "[文件...]");
+    parser.process(app);
+
+    QTextStream out(stdout);
+    if (!parser.isSet(outOpt)) {
+        out << "请用 --out 指定输出目录" << Qt::endl;
+        return 2;
+    }
+
+    DialBatchOptions options;
+    options.files = parser.positionalArguments();
+    options.dbPath = parser.value(dbOpt);
+    options.filter.productModel = parser.value(modelOpt);
+    options.filter.groupNo = parser.value(groupOpt);
+    options.filter.from = QDate::fromString(parser.value(fromOpt), "yyyy-MM-dd");
+    options.filter.to = QDate::fromString(parser.value(toOpt), "yyyy-MM-dd");
+    options.outDir = parser.value(outOpt);
+    options.format = parser.value(formatOpt);
+    options.includeFailed = parser.isSet(failedOpt);
+    options.logoPath = parser.value(logoOpt);
+    options.threads = parser.value(threadsOpt).toInt();
+
+    int lastPercent = -1;
+    auto progress = [&](int done, int total) {
+        const int percent = total > 0 ? done * 100 / total : 100;
+        if (percent / 10 == lastPercent / 10) return;
+        lastPercent = percent;
+        out << "进度 " << done << "/" << total << "（" << percent << "%）" << Qt::endl;
+    };
+
+    DialBatchSummary summary;
+    QString error;
+    if (!runDialBatch(options, summary, error, progress)) {
+        out << "批量出表盘失败: " << error << Qt::endl;
+        return 1;
+    }
+    out << "共 " << summary.items.size() << " 块，已生成 " << summary.renderedCount << " 块，跳过 "
+        << summary.skippedCount << " 块，失败 " << summary.failedCount << " 块，耗时 " << summary.elapsedMs << " ms" << Qt::endl;
+    out << "表盘清单: " << summary.listFile << Qt::endl;
+    for (const DialBatchItem& item : summary.items) {
+        if (!item.error.isEmpty()) out << "  " << item.source << ": " << item.error << Qt::endl;
+    }
+    return summary.failedCount > 0 ? 3 : 0;
+}
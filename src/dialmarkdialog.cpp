@@ -12,6 +12,9 @@
 #include <QVector>
 #include <QSet>
 #include <QImageWriter>
+#include <QThread>
+#include <QProgressDialog>
+#include <memory>
 #include <iostream>
 #include <cmath>
 #include <vector>
@@ -41,9 +44,10 @@ AnnotationLabel::AnnotationLabel(QWidget *parent)
     setContextMenuPolicy(Qt::DefaultContextMenu);
 }
 
-void AnnotationLabel::setImage(const QPixmap &pixmap)
+void AnnotationLabel::setImage(const QPixmap &pixmap, const QSize &imageSize)
 {
     m_originalPixmap = pixmap;
+    m_imageSize = imageSize.isValid() ? imageSize : pixmap.size();
     // 重置缩放和偏移
     m_scaleFactor = 1.0;
     m_imageOffset = QPoint(0, 0);
@@ -51,7 +55,7 @@ void AnnotationLabel::setImage(const QPixmap &pixmap)
     // 如果图片太大，自动缩小到合适尺寸
     if (!pixmap.isNull()) {
         QSize labelSize = size();
-        QSize pixmapSize = pixmap.size();
+        QSize pixmapSize = m_imageSize;
         
         if (pixmapSize.width() > labelSize.width() || pixmapSize.height() > labelSize.height()) {
             double scaleX = (double)labelSize.width() / pixmapSize.width();
@@ -63,6 +67,17 @@ void AnnotationLabel::setImage(const QPixmap &pixmap)
     updateDisplay();
 }
 
+void AnnotationLabel::replaceImage(const QPixmap &pixmap, const QSize &imageSize)
+{
+    // 尺寸变了（或者之前没图）就按新图重新适配缩放
+    if (m_originalPixmap.isNull() || imageSize != m_imageSize) {
+        setImage(pixmap, imageSize);
+        return;
+    }
+    m_originalPixmap = pixmap;
+    updateDisplay();
+}
+
 void AnnotationLabel::addTextAnnotation(const QPoint &pos, const QString &text, const QColor &color, int fontSize, const QString &fontFamily, bool isBold, bool isItalic)
 {
     TextAnnotation annotation;
@@ -143,12 +158,21 @@ QPixmap AnnotationLabel::getAnnotatedImage() const
     
     QPixmap result = m_originalPixmap;
     QPainter painter(&result);
+    // 显示的是预览小图时，标注坐标仍按原图算
+    painter.scale(double(result.width()) / m_imageSize.width(), double(result.height()) / m_imageSize.height());
+    paintAnnotations(painter, m_annotations, m_scaleFactor);
+    
+    return result;
+}
+
+void AnnotationLabel::paintAnnotations(QPainter &painter, const QList<TextAnnotation> &annotations, double scaleFactor)
+{
     painter.setRenderHint(QPainter::Antialiasing);
     
     // 绘制所有标注
-    for (const TextAnnotation &annotation : m_annotations) {
+    for (const TextAnnotation &annotation : annotations) {
         QFont font(annotation.fontFamily);
-        int scaledFontSize = qMax(1, (int)(annotation.fontSize / m_scaleFactor));
+        int scaledFontSize = qMax(1, (int)(annotation.fontSize / scaleFactor));
         font.setPointSize(scaledFontSize);
         font.setBold(annotation.isBold);
         font.setItalic(annotation.isItalic);
@@ -158,8 +182,6 @@ QPixmap AnnotationLabel::getAnnotatedImage() const
         // 标注位置是相对于原始图片的坐标，直接使用
         painter.drawText(annotation.position, annotation.text);
     }
-    
-    return result;
 }
 
 void AnnotationLabel::paintEvent(QPaintEvent *event)
@@ -170,8 +192,8 @@ void AnnotationLabel::paintEvent(QPaintEvent *event)
     if (m_originalPixmap.isNull()) return;
     
     // 计算图片显示位置
-    QSize scaledSize(m_originalPixmap.width() * m_scaleFactor, 
-                    m_originalPixmap.height() * m_scaleFactor);
+    QSize scaledSize(m_imageSize.width() * m_scaleFactor, 
+                    m_imageSize.height() * m_scaleFactor);
     QRect imageRect;
     imageRect.setSize(scaledSize);
     
@@ -220,8 +242,8 @@ void AnnotationLabel::mousePressEvent(QMouseEvent *event)
         QPoint clickPos = event->pos();
         
         // 计算图片显示区域
-        QSize scaledSize(m_originalPixmap.width() * m_scaleFactor, 
-                        m_originalPixmap.height() * m_scaleFactor);
+        QSize scaledSize(m_imageSize.width() * m_scaleFactor, 
+                        m_imageSize.height() * m_scaleFactor);
         QRect imageRect;
         imageRect.setSize(scaledSize);
         imageRect.moveCenter(rect().center() + m_imageOffset);
@@ -321,8 +343,8 @@ void AnnotationLabel::contextMenuEvent(QContextMenuEvent *event)
     QPoint clickPos = event->pos();
     
     // 计算图片显示区域
-    QSize scaledSize(m_originalPixmap.width() * m_scaleFactor, 
-                    m_originalPixmap.height() * m_scaleFactor);
+    QSize scaledSize(m_imageSize.width() * m_scaleFactor, 
+                    m_imageSize.height() * m_scaleFactor);
     QRect imageRect;
     imageRect.setSize(scaledSize);
     imageRect.moveCenter(rect().center() + m_imageOffset);
@@ -386,8 +408,8 @@ void AnnotationLabel::mouseDoubleClickEvent(QMouseEvent *event)
 {
     if (event->button() == Qt::LeftButton) {
         // 计算图片显示区域
-        QSize scaledSize(m_originalPixmap.width() * m_scaleFactor, 
-                        m_originalPixmap.height() * m_scaleFactor);
+        QSize scaledSize(m_imageSize.width() * m_scaleFactor, 
+                        m_imageSize.height() * m_scaleFactor);
         QRect imageRect;
         imageRect.setSize(scaledSize);
         imageRect.moveCenter(rect().center() + m_imageOffset);
@@ -416,8 +438,8 @@ void AnnotationLabel::mouseDoubleClickEvent(QMouseEvent *event)
 void AnnotationLabel::updateDisplay()
 {
     if (!m_originalPixmap.isNull()) {
-        QSize scaledSize(m_originalPixmap.width() * m_scaleFactor, 
-                        m_originalPixmap.height() * m_scaleFactor);
+        QSize scaledSize(m_imageSize.width() * m_scaleFactor, 
+                        m_imageSize.height() * m_scaleFactor);
         setPixmap(m_originalPixmap.scaled(scaledSize, Qt::KeepAspectRatio, Qt::SmoothTransformation));
     }
     update();
@@ -488,6 +510,7 @@ void AnnotationLabel::wheelEvent(QWheelEvent *event)
     m_scaleFactor = qMax(0.1, qMin(5.0, m_scaleFactor));
     
     updateDisplay();
+    emit zoomChanged();
     event->accept();
 }
 
@@ -526,6 +549,7 @@ void AnnotationLabel::zoomIn()
     m_scaleFactor *= scaleFactor;
     m_scaleFactor = qMin(5.0, m_scaleFactor);  // 限制最大缩放
     updateDisplay();
+    emit zoomChanged();
 }
 
 void AnnotationLabel::zoomOut()
@@ -536,6 +560,7 @@ void AnnotationLabel::zoomOut()
     m_scaleFactor /= scaleFactor;
     m_scaleFactor = qMax(0.1, m_scaleFactor);  // 限制最小缩放
     updateDisplay();
+    emit zoomChanged();
 }
 
 void AnnotationLabel::resetZoom()
@@ -545,8 +570,12 @@ void AnnotationLabel::resetZoom()
     m_scaleFactor = 1.0;
     m_imageOffset = QPoint(0, 0);
     updateDisplay();
+    emit zoomChanged();
 }
 
+// 预览合并刷新的等待时间（毫秒）
+static constexpr int kPreviewDelayMs = 150;
+
 // DialMarkDialog 实现---初始化的函数
 DialMarkDialog::DialMarkDialog(QWidget *parent, const QString &dialType)
     : QDialog(parent)
@@ -564,6 +593,10 @@ DialMarkDialog::DialMarkDialog(QWidget *parent, const QString &dialType)
 
 DialMarkDialog::~DialMarkDialog()
 {
+    // 后台保存的绘制步骤里引用着本对象，等它跑完
+    if (m_saveThread) {
+        m_saveThread->wait();
+    }
 }
 
 void DialMarkDialog::setupUI()
@@ -883,6 +916,14 @@ void DialMarkDialog::setupUI()
     //             qDebug() << "角度已更新为：" << value;
     //         });
     
+    // 预览刷新合并：连着改配置、滚轮缩放、拖窗口大小时，停下来之后只画一次
+    m_previewTimer = new QTimer(this);
+    m_previewTimer->setSingleShot(true);
+    m_previewTimer->setInterval(kPreviewDelayMs);
+    connect(m_previewTimer, &QTimer::timeout, this, &DialMarkDialog::updatePreview);
+    // 放大后预览按新的显示尺寸重画，不然会糊
+    connect(m_imageLabel, &AnnotationLabel::zoomChanged, this, &DialMarkDialog::schedulePreview);
+    
     // 确保字体设置为默认黑体
     m_fontComboBox->setCurrentText("黑体");
     m_imageLabel->setCurrentFontFamily("黑体");
@@ -934,12 +975,12 @@ void DialMarkDialog::loadDialImageFromFile()
         QMessageBox::Yes | QMessageBox::No);
     
     if (reply == QMessageBox::Yes) {
-        // 生成新表盘
-        QPixmap newDial = QPixmap::fromImage(generateDialImage());// 生成表盘图片
-        if (!newDial.isNull()) {
-            m_imageLabel->setImage(newDial);
+        // 生成新表盘：先按窗口分辨率出预览，成图分辨率等保存/导出时再在后台渲染
+        m_showingGeneratedDial = true;
+        if (updatePreview()) {
             qDebug() << "成功生成新表盘";
         } else {
+            m_showingGeneratedDial = false;
             QMessageBox::warning(this, "错误", "生成表盘失败");
         }
     } else {
@@ -958,6 +999,7 @@ void DialMarkDialog::loadDialImageFromFile()
         if (!imagePath.isEmpty()) {
             QPixmap pixmap(imagePath);
             if (!pixmap.isNull()) {
+                m_showingGeneratedDial = false;
                 m_imageLabel->setImage(pixmap);
                 qDebug() << "成功加载表盘图片:" << imagePath;
             } else {
@@ -1218,61 +1260,99 @@ void DialMarkDialog::onTextChanged()
     }
 }
 
+void DialMarkDialog::runDialSaveJob(const QString& title, const QString& label, std::function<bool(QString&)> work)
+{
+    auto* dialog = new QProgressDialog(label, QString(), 0, 0, this);
+    dialog->setWindowTitle(title);
+    dialog->setWindowModality(Qt::WindowModal);
+    dialog->setCancelButton(nullptr);
+    dialog->setMinimumDuration(0);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    
+    auto ok = std::make_shared<bool>(false);
+    auto message = std::make_shared<QString>();
+    QThread* thread = QThread::create([work, ok, message]() {
+        *ok = work(*message);
+    });
+    m_saveThread = thread;
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    connect(thread, &QThread::finished, this, [this, dialog, title, ok, message]() {
+        dialog->close();
+        if (*ok) {
+            QMessageBox::information(this, title, *message);
+        } else {
+            QMessageBox::warning(this, title, *message);
+        }
+    });
+    
+    dialog->show();
+    thread->start();
+}
+
 void DialMarkDialog::exportImage()
 {
+    if (m_saveThread) {
+        QMessageBox::information(this, "提示", "正在保存，请稍候");
+        return;
+    }
+    
     QString fileName = QFileDialog::getSaveFileName(this,
         "导出标注图片", "annotated_dial.tif", 
         "CMYK TIFF (*.tif *.tiff);;PNG 图片 (*.png);;JPEG 图片 (*.jpg *.jpeg);;BMP 图片 (*.bmp)");
+    if (fileName.isEmpty()) return;
     
-    if (!fileName.isEmpty()) {
-        QPixmap annotatedImage = m_imageLabel->getAnnotatedImage();
-        if (!annotatedImage.isNull()) {
-            // 转换为QImage
-            QImage img = annotatedImage.toImage();
-            
-            // 根据表盘类型确定 DPI
-            double dpi = (m_dialType == "YYQY-13") ? 960.0 : 2400.0;
-            
-            // 确定文件格式
-            QString ext = QFileInfo(fileName).suffix().toLower();
-            if (ext.isEmpty()) {
-                fileName += ".tif";
-                ext = "tif";
+    // 确定文件格式
+    QString ext = QFileInfo(fileName).suffix().toLower();
+    if (ext.isEmpty()) {
+        fileName += ".tif";
+        ext = "tif";
+    }
+    
+    // 根据表盘类型确定 DPI
+    const double dpi = DialRenderer::outputDpi(m_dialType);
+    
+    auto finish = [fileName](bool success, const QString& formatName, QString& message) {
+        message = success ? QString("图片已导出为 %1: %2").arg(formatName, fileName) : QString("导出图片失败");
+        return success;
+    };
+    
+    if (m_showingGeneratedDial) {
+        // 界面上是预览小图：后台按成图分辨率重画，再按原图坐标叠上标注
+        // 标注字号照旧按屏幕 DPI 换算（和在界面上贴到图上时一样大）
+        const DialRenderer::Scene scene = buildDialScene();
+        const QList<TextAnnotation> annotations = m_imageLabel->getAnnotations();
+        const double scaleFactor = m_imageLabel->scaleFactor();
+        const int annotationDpm = dpi_to_dpm(m_imageLabel->logicalDpiY());
+        runDialSaveJob("导出标注图片", "正在按成图分辨率渲染并导出...",
+                       [this, scene, annotations, scaleFactor, annotationDpm, fileName, dpi, finish](QString& message) {
+            QImage img = m_dialRenderer.render(scene).convertToFormat(QImage::Format_RGB32);
+            if (img.isNull()) {
+                message = "生成表盘失败";
+                return false;
             }
+            img.setDotsPerMeterX(annotationDpm);
+            img.setDotsPerMeterY(annotationDpm);
+            QPainter painter(&img);
+            AnnotationLabel::paintAnnotations(painter, annotations, scaleFactor);
+            painter.end();
             
-            bool success = false;
             QString formatName;
-            
-            if (ext == "tif" || ext == "tiff") {
-                // 使用 CMYK TIFF 保存
-                success = saveCmykTiff(img, fileName, dpi);
-                formatName = "CMYK TIFF";
-            } else {
-                // 其他格式使用 Qt 保存
-                QByteArray fmt("png");
-                if (ext == "png") fmt = "png";
-                else if (ext == "jpg" || ext == "jpeg") fmt = "jpeg";
-                else if (ext == "bmp") fmt = "bmp";
-                
-                // 设置 DPI
-                int dpm = dpi_to_dpm(dpi);
-                img.setDotsPerMeterX(dpm);
-                img.setDotsPerMeterY(dpm);
-                
-                QImageWriter writer(fileName, fmt);
-                success = writer.write(img);
-                formatName = QString::fromLatin1(fmt.toUpper());
-            }
-            
-            if (success) {
-                QMessageBox::information(this, "成功", QString("图片已导出为 %1: %2").arg(formatName, fileName));
-            } else {
-                QMessageBox::warning(this, "错误", "导出图片失败");
-            }
-        } else {
-            QMessageBox::warning(this, "错误", "没有可导出的图片");
-        }
+            return finish(m_dialRenderer.saveImage(img, fileName, dpi, formatName), formatName, message);
+        });
+        return;
     }
+    
+    QPixmap annotatedImage = m_imageLabel->getAnnotatedImage();
+    if (annotatedImage.isNull()) {
+        QMessageBox::warning(this, "错误", "没有可导出的图片");
+        return;
+    }
+    // 转换为QImage（QPixmap 只能在界面线程用），编码写盘放到后台
+    const QImage img = annotatedImage.toImage();
+    runDialSaveJob("导出标注图片", "正在导出...", [this, img, fileName, dpi, finish](QString& message) {
+        QString formatName;
+        return finish(m_dialRenderer.saveImage(img, fileName, dpi, formatName), formatName, message);
+    });
 }
 
 void DialMarkDialog::updateAnnotationList()
@@ -1383,257 +1463,63 @@ void AnnotationPropertiesDialog::chooseColor()
     }
 }
 
-static inline int deg16(double deg){ return int(std::round(deg*16.0)); }
-static inline QPointF pol2(const QPointF& c, double angDeg, double r){
-    const double a = qDegreesToRadians(angDeg);
-    return QPointF(c.x() + r*std::cos(a), c.y() - r*std::sin(a)); // y 轴向下
-}
-
-
-//注意一下    v2ang 也需要在中间节点调用
-static inline double v2ang(double v, double vmax, double startDeg, double totalAngle,QVector<double> points,QVector<double> pointsAngle){
-    //  确保两端点完整（若已经在列表里则不会重复添加）
-    QVector<double> allP = points;
-    QVector<double> allA = pointsAngle;
-
-    if (allP.isEmpty() || allP.last()  != vmax) allP.append(vmax);
-    if (allA.isEmpty() || allA.last()  != totalAngle) allA.append(totalAngle);
-
-    //  参数合法性检查（超出范围则 clamp）
-    v = std::clamp(v, 0.0, vmax);
-
-    // 找到 v 所在的主段
-    int idx = 0;
-    for (int i = 0; i < allP.size() - 1; ++i) {
-        if (v >= allP[i] && v <= allP[i + 1]) {
-            idx = i;
-            break;
-        }
+void DialMarkDialog::schedulePreview()
+{
+    if (m_showingGeneratedDial && m_previewTimer) {
+        m_previewTimer->start();
     }
-
-    double pCurr = allP[idx];
-    double pNext = allP[idx + 1];
-    double aCurr = allA[idx];
-    double aNext = allA[idx + 1];
-
-    // 最后一段之前均分 5 份，最后一份单独处理
-    if(idx == allP.size() - 2){
-        // 最后一段
-        const double lastStep = 1.0; // 最后一段单独处理，步长为1.0
-        double angleStep = (aNext - aCurr) / ((pNext - pCurr) / lastStep);
-        return startDeg - (aCurr + (v - pCurr) * angleStep); // 注意这里是减去，因为顺时针方向角度减小
-    }else{
-        const double subDiv = 5.0;
-        double angleStep = (aNext - aCurr) / subDiv;
-        return startDeg - (aCurr + (v - pCurr) * angleStep);
-        }
 }
 
-// ======= 主入口：生成表盘图 =======
-QImage DialMarkDialog::generateDialImage()
+// ======= 主入口：按当前类型和配置录制表盘 =======
+DialRenderer::Scene DialMarkDialog::buildDialScene()
 {
-    if (m_dialType == "YYQY-13") {
-        return generateYYQYDialImage();
-    } else {
-        return generateBYQDialImage();
-    }
+    return m_dialRenderer.buildScene(m_dialType, m_byqConfig, m_yyqyConfig);
 }
 
-// ======= BYQ表盘生成 =======
-QImage DialMarkDialog::generateBYQDialImage()
-{
-    
-    // 使用优化后的配置参数
-    const int OUT_W = 2778;         // 图片宽度
-    const int OUT_H = 2363;         // 图片高度
-    const double OUT_DPI = 2400;    // 图片DPI
-
-    QImage img(OUT_W, OUT_H, QImage::Format_RGBA64);
-    img.fill(Qt::white);
-
-    // 2) 写入 DPI 元数据（TIFF 会映射为 X/YResolution）
-    const int dpm = dpi_to_dpm(OUT_DPI);
-    img.setDotsPerMeterX(dpm);
-    img.setDotsPerMeterY(dpm);
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-    // 3) 可选：嵌入 sRGB 色彩空间（印前/跨软件显示更一致）
-    // img.setColorSpace(QColorSpace::SRgb);
-#endif
-
-    // 4) 开始绘制——根据用户输入的角度和压力值
-    QPainter p(&img);
-    p.setRenderHint(QPainter::Antialiasing, true);
-    p.setRenderHint(QPainter::TextAntialiasing, true);
-
-    // 圆心位置
-    const QPointF C(OUT_W/2.0, OUT_H * 0.54);
-    
-    // 表盘半径
-    const double Rpx = std::min(OUT_W, OUT_H) * 0.4;
-    const double totalAngle = m_byqConfig.pointsAngle[5];  // 用户输入的角度
-    const double vmax = m_byqConfig.maxPressure;       // 用户输入的最大压力
-    const QVector<double>& points = m_byqConfig.points;           // 保存的分段点
-    const QVector<double>& pointsAngle = m_byqConfig.pointsAngle; // 保存的分段角度
-
-    // 角度系统：根据用户输入的角度-----使用自动保存的起始角度
-    const double startDeg = 90.0 + totalAngle/2.0;     // 起始角度（左上）
-    const double spanDeg = -totalAngle;                // 角度跨度（顺时针）
-
-    // 主刻度间隔：根据最大压力自动计算  
-    double majorStep = 5.0;  // 默认5MPa间隔
-    if (vmax <= 10.0) majorStep = 2.0;
-    else if (vmax <= 25.0) majorStep = 5.0;
-    else if (vmax <= 50.0) majorStep = 10.0;
-    else majorStep = 20.0;
-
-    // ① 先绘制刻度与数字
-    drawBYQTicksAndNumbers(p, C, Rpx, startDeg, totalAngle, spanDeg, vmax, majorStep, points, pointsAngle);
-    // ② 然后绘制彩色带
-    drawBYQColorBands(p, C, Rpx, startDeg, totalAngle, spanDeg, vmax, points, pointsAngle);
-    // ③ 最后绘制单位
-    drawBYQUnitMPa(p, C, Rpx);
-
-    p.end();
-    return img;
-}
-
-//BYQ刻度绘制
-void DialMarkDialog::drawBYQTicksAndNumbers(QPainter& p, const QPointF& C, double outerR,
-    double startDeg, double totalAngle, double spanDeg, double vmax, double majorStep, QVector<double> points, QVector<double> pointsAngle)
-{
-    const double r17_1 = outerR;                        // R17.1：最外圆
-    const double r16_1 = outerR * (16.1 / 17.1);       // R16.1：彩色带内圈
-    const double r15_1 = outerR * (15.1 / 17.1);       // R15.1：小刻度线外沿
-    const double r14_6 = outerR * (14.6 / 17.1);       // R14.6：大刻度线内沿
-    const double r13_0 = outerR * (12.8 / 17.1);       // R14.0：数字位置
-    // 刻度线宽：根据实际半径调整，保持合理比例
-    const double lineScale = outerR / 300.0;  // 基准缩放
-    const QColor black = QColor::fromCmyk(0, 0, 0, 100);
-    QPen penMinor(black, std::max(2.0, 0.5 * lineScale * 10), Qt::SolidLine, Qt::RoundCap);    // 小刻度：平直端点
-    QPen penMajor(black, std::max(2.5, 0.8 * lineScale * 10), Qt::SolidLine, Qt::RoundCap);   // 大刻度：圆形端点
-
-    // 次刻度（1 MPa间隔）
-    p.setPen(penMinor);
-    const double minorStep = 1.0;
-    for (double v = 0; v <= vmax + 1e-6; v += minorStep) {
-        const double ang = v2ang(v, vmax, startDeg, totalAngle, points, pointsAngle);
-        p.drawLine(pol2(C, ang, r16_1), pol2(C, ang, r15_1));
-    }
-
-    // 主刻度（5 MPa间隔）————需要改进
-    p.setPen(penMajor);
-    const double majorTickStep = 5.0;
-    for (double v = 0; v <= vmax + 1e-6; v += majorTickStep) {
-        const double ang = v2ang(v, vmax, startDeg, totalAngle, points, pointsAngle);
-        p.drawLine(pol2(C, ang, r16_1), pol2(C, ang, r14_6));
+bool DialMarkDialog::updatePreview()
+{
+    if (!m_showingGeneratedDial) return false;
+    // 后台正在用同一个渲染器出成图，等它结束再刷新
+    if (m_saveThread) {
+        schedulePreview();
+        return false;
     }
-
-    // 数字字体：直接使用合理的固定字体大小，不要基于比例计算
-    const int fontNumberPx = 4;  // 固定合理字体大小
-    QFont numFont("Arial", fontNumberPx, QFont::Bold);
-    p.setFont(numFont);
-    p.setPen(QPen(black, 1));
-
-    // 数字：0,10,20,30,40,50（每10MPa一个数字）
-    for (double v = 0; v <= vmax + 1e-6; v += majorStep) {
-        const double ang = v2ang(v, vmax, startDeg, totalAngle, points, pointsAngle);
-        const QPointF pos = pol2(C, ang, r13_0);
-        const QString t = QString::number(int(v));
-        QRectF br = p.fontMetrics().boundingRect(t);
-        br.moveCenter(pos);
-        p.drawText(br, Qt::AlignCenter, t);
+    
+    const DialRenderer::Scene scene = buildDialScene();
+    // 画到窗口大小就够；已经在看这张表盘并放大了的话按放大后的显示尺寸画
+    const double dpr = devicePixelRatioF();
+    QSize bound = m_imageLabel->size().expandedTo(QSize(800, 800));
+    if (m_imageLabel->imageSize() == scene.canvas) {
+        bound = bound.expandedTo(scene.canvas * m_imageLabel->scaleFactor());
     }
-}
-
-// ======= BYQ表盘绘制函数 =======
-void DialMarkDialog::drawBYQColorBands(QPainter& p, const QPointF& C, double outerR,
-    double startDeg,double totalAngle, double spanDeg, double vmax,QVector<double> points,QVector<double> pointsAngle)
-{
-    const double r17_1 = outerR;   // 彩带外沿
-    const double r16_1 = outerR * (16.1 / 17.1);   // 彩带内沿
-    const double r_mid = 0.5 * (r16_1 + r17_1);
-    const double bandWidth = (r17_1 - r16_1);
-
-    QRectF arcRect(C.x() - r_mid, C.y() - r_mid, 2*r_mid, 2*r_mid);
-
-    // 与刻度一致的"主刻度线宽"
-    const double lineScale = outerR / 300.0;
-    const double w_major = std::max(2.0, 0.4 * lineScale * 10);
-    const double deltaDeg = qRadiansToDegrees(std::atan((w_major * 0.8) / r_mid));
-    const bool clockwise = (spanDeg < 0);
-
-    // ③ 颜色分段 (CMYK色值)
-    const QColor Y07 = QColor::fromCmyk(0, 0, 100, 10);    // 黄色带
-    const QColor G02 = QColor::fromCmyk(100, 0, 100, 0);   // 绿色带
-    const QColor R03 = QColor::fromCmyk(0, 100, 100, 0);   // 红色带
-    struct Seg { double v0, v1; QColor c; };
-    const QVector<Seg> segs = {
-        { 0.0,  5.9, Y07},
-        { 5.9, 21.0, G02},
-        {21.0, vmax, R03}
-    };
-
-    QPen pen;
-    pen.setWidthF(bandWidth);
-    pen.setCapStyle(Qt::FlatCap);
-
-    // 只在两端做角度补偿
-    const double eps = 1e-9;
-    for (const auto& s : segs) {
-        
-        double a0 = v2ang(s.v0, vmax, startDeg, totalAngle, points, pointsAngle);
-        double a1 = v2ang(s.v1, vmax, startDeg, totalAngle, points, pointsAngle);
-        if (std::abs(s.v0 - 0.0) < eps) {
-            a0 -= (clockwise ? -deltaDeg : +deltaDeg);
-        }
-        if (std::abs(s.v1 - vmax) < eps) {
-            a1 -= (clockwise ? +deltaDeg : -deltaDeg);
-        }
-
-        pen.setColor(s.c);
-        p.setPen(pen);
-        p.setBrush(Qt::NoBrush);
-        p.drawArc(arcRect, deg16(a0), deg16(a1 - a0));
+    const QImage img = DialRenderer::renderPreview(scene, bound * dpr);
+    if (img.isNull()) {
+        qDebug() << "updatePreview: 生成预览失败";
+        return false;
     }
+    m_imageLabel->replaceImage(QPixmap::fromImage(img), scene.canvas);
+    return true;
 }
 
-// ======= 3) 中央单位与装饰 =======
-void DialMarkDialog::drawBYQUnitMPa(QPainter& p, const QPointF& C, double Rpx)
+void DialMarkDialog::resizeEvent(QResizeEvent *event)
 {
-    // 直接使用合理的固定字体大小
-    double r4_0 = Rpx * (4.0 / 17.1);
-    double r2_0 = Rpx * (2.0 / 17.1);
-    double fontPixelHeight = (r4_0 - r2_0) * 2;
-
-
-    QFont font("DIN Rounded");
-    font.setPixelSize(std::round(fontPixelHeight)); // 按像素高度设置
-    font.setBold(true); // 若图纸要求粗体，可设置
-    p.setFont(font);
-    const QColor blackBand = QColor::fromCmyk(0, 0, 0, 100);
-    p.setPen(QPen(blackBand, 1));
-
-    const QString MPa = "MPa";
-    QRectF textRect = p.fontMetrics().boundingRect(MPa);
-
-    double r3_0 = (r4_0 + r2_0) / 1.1;
-    QPointF pos = QPointF(C.x() - textRect.width() / 2.0,
-                          C.y() - r3_0 - textRect.height() / 2.0);
-
-    p.drawText(pos, MPa);
+    QDialog::resizeEvent(event);
+    schedulePreview();
 }
 
 void DialMarkDialog::saveGeneratedDial()
 {
-    // 生成表盘图像
-    QImage img = generateDialImage();
-
+    if (m_saveThread) {
+        QMessageBox::information(this, "提示", "正在保存，请稍候");
+        return;
+    }
+    
     // 选择保存路径（多格式）
     QString fileName = QFileDialog::getSaveFileName(
         this,
         "保存表盘图片",
         "",
-        "CMYK TIFF (*.tif *.tiff);;PNG 图片 (*.png);;JPEG 图片 (*.jpg *.jpeg);;BMP 图片 (*.bmp)"
+        "CMYK TIFF (*.tif *.tiff);;PNG 图片 (*.png);;JPEG 图片 (*.jpg *.jpeg);;BMP 图片 (*.bmp);;矢量 PDF (*.pdf);;矢量 SVG (*.svg)"
     );
     if (fileName.isEmpty()) return;
 
@@ -1644,438 +1530,38 @@ void DialMarkDialog::saveGeneratedDial()
         ext = "tif";
     }
 
-    // 根据表盘类型确定 DPI
-    double dpi = (m_dialType == "YYQY-13") ? 960.0 : 2400.0;
-
-    bool success = false;
-    QString formatName;
-    
-    if (ext == "tif" || ext == "tiff") {
-        // 使用 CMYK TIFF 保存
-        success = saveCmykTiff(img, fileName, dpi);
-        formatName = "CMYK TIFF";
-    } else {
-        // 其他格式使用 Qt 保存
-        QByteArray fmt("png");
-        if (ext == "png") fmt = "png";
-        else if (ext == "jpg" || ext == "jpeg") fmt = "jpeg";
-        else if (ext == "bmp") fmt = "bmp";
-        
-        // 设置 DPI
-        int dpm = qRound(dpi / 0.0254);
-        img.setDotsPerMeterX(dpm);
-        img.setDotsPerMeterY(dpm);
-        
-        QImageWriter writer(fileName, fmt);
-        success = writer.write(img);
-        formatName = QString::fromLatin1(fmt.toUpper());
-    }
-    
-    if (!success) {
-        QMessageBox::warning(this, "保存失败", "错误：保存失败");
-    } else {
-        QMessageBox::information(
-            this,
-            "保存成功",
-            QString("成功：已保存 %1: %2").arg(formatName, fileName)
-        );
-    }
-}
-
-// ======= YYQY表盘生成 =======
-
-QImage DialMarkDialog::generateYYQYDialImage()
-{
-    // YYQY表盘规格：1890x1890像素，960 DPI分辨率
-    const int S = 1890;  
-    const double OUT_DPI = 960;    // 图片DPI
-    
-    QImage img(S, S, QImage::Format_RGBA64);
-    img.fill(Qt::white);
-    
-    QPainter p(&img);
-    p.setRenderHint(QPainter::Antialiasing, true);
-    p.setRenderHint(QPainter::TextAntialiasing, true);
-    
-    const QPointF C(S/2.0, S/2.0);  // 圆心
-    const double outerR = 16.3 * S / 42.0;  // 外径半径（缩小表盘，留出边距）
-    
-    // 使用配置中的角度值
-    const double maxPressure = m_yyqyConfig.maxPressure; // 最大压力
-    double totalAngle = m_yyqyConfig.totalAngle;
-    const QVector<double>& points = m_yyqyConfig.points;           // 保存的分段点
-    const QVector<double>& pointsAngle = m_yyqyConfig.pointsAngle; // 保存的分段角度
-
-    qDebug() << "生成YYQY表盘，角度：" << totalAngle;
-    
-    // 绘制各个组件 - 调整绘制顺序，确保数字不被遮挡
-    drawYYQYLogo(p, C, outerR);                        // 绘制商标
-    drawYYQYTicks(p, C, outerR, totalAngle, maxPressure, points, pointsAngle);           // 先绘制刻度线
-    drawYYQYColorBands(p, C, outerR, totalAngle, maxPressure, points, pointsAngle);      // 然后绘制彩色带
-    drawYYQYNumbers(p, C, outerR, totalAngle, maxPressure, points, pointsAngle);         // 再绘制数字（确保在最上层）
-    drawYYQYCenterTexts(p, C, outerR);                 // 绘制中心文字
-    drawYYQYPositionDot(p, C, outerR, totalAngle);     // 最后绘制定位点
-    
-    p.end();
-    
-    // 绘制完成后再设置 DPI 元数据（避免影响字体渲染）
-    const int dpm = dpi_to_dpm(OUT_DPI);
-    img.setDotsPerMeterX(dpm);
-    img.setDotsPerMeterY(dpm);
-    
-    return img;
-}
-
-//实在不行就yyqy2ang
-static inline double yyqyV2Ang(double v, double vmax, double startDeg, double totalAngle, QVector<double> points, QVector<double> pointsAngle)
-{
-    // 复制并保证包含端点 0 和 vmax
-    QVector<double> allP = points;
-    QVector<double> allA = pointsAngle;
-
-    if (allP.isEmpty() || allP.first() != 0.0) {
-        allP.prepend(0.0);
-        allA.prepend(0.0);
-    }
-    if (allP.isEmpty() || allP.last() != vmax) {
-        allP.append(vmax);
-        allA.append(totalAngle);
-    }
-
-    // 基本合法性检查：长度、单调性
-    if (allP.size() != allA.size()) {
-        // 退化为线性映射
-        double frac = (vmax > 0.0) ? std::clamp(v / vmax, 0.0, 1.0) : 0.0;
-        return startDeg - frac * totalAngle;
-    }
-    for (int i = 1; i < allP.size(); ++i) {
-        if (allP[i] <= allP[i-1] || allA[i] < allA[i-1]) {
-            double frac = (vmax > 0.0) ? std::clamp(v / vmax, 0.0, 1.0) : 0.0;
-            return startDeg - frac * totalAngle;
-        }
-    }
-
-    // clamp v
-    v = std::clamp(v, 0.0, vmax);
-
-    // 处理边界值，保证 0 与 vmax 精确映射
-    if (v <= 0.0) return startDeg;
-    if (v >= vmax) return startDeg - totalAngle;
-
-    // 找到包含 v 的段并做线性插值
-    int idx = 0;
-    for (int i = 0; i < allP.size() - 1; ++i) {
-        if (v >= allP[i] && v <= allP[i+1]) {
-            idx = i;
-            break;
-        }
-    }
-
-    double p0 = allP[idx], p1 = allP[idx+1];
-    double a0 = allA[idx], a1 = allA[idx+1];
-
-    double t = (p1 == p0) ? 0.0 : (v - p0) / (p1 - p0);
-    double angSeg = a0 + t * (a1 - a0);
-
-    return startDeg - angSeg;
-}
-
-
-//绘制刻度线
-void DialMarkDialog::drawYYQYTicks(QPainter& p, const QPointF& C, double outerR, double totalAngle,double maxPressure,
-    QVector<double> points,QVector<double> pointsAngle)
-{
-    const double k = outerR / 16.3;  // 缩放系数
+    // 场景在界面线程按当前配置录制，渲染和写文件放到后台
+    const DialRenderer::Scene scene = buildDialScene();
     
-    const double r_band_outer = 16.3 * k;   // 外圆半径（与彩色带外沿对齐）
-    const double r_band_inner = 15.5 * k;   // 彩色带内沿
-    const double r_major_outer = r_band_inner;  // 大刻度外径 = 彩色带内沿
-    const double r_major_inner = 12.5 * k;  // 大刻度内径
-    const double r_minor_outer = r_band_inner;  // 小刻度外径 = 彩色带内沿
-    const double r_minor_inner = 13.8 * k;  // 小刻度内径
-    const double r_number = 10.0 * k;       // 数字半径，调整到更靠内避免被刻度线遮挡
-    
-    // 角度设置 - 表盘是左右对称的
-    const double startAngle = 90.0 + totalAngle / 2.0;  // 起始角度（从左上开始）
-    
-    // 计算刻度数量 - 根据配置的最大压力
-      // 使用配置的最大压力
-    const int totalPositions = (int)(maxPressure * 10) + 1;  // 总刻度位置（每0.1MPa一个位置）
-    const double anglePerPosition = totalAngle / (totalPositions - 1);  // 每个位置的角度-----要改成变化的
-    
-    // 大刻度位置：整数MPa对应的位置索引
-    QSet<int> majorPositions;
-    for (int i = 0; i <= (int)maxPressure; ++i) {
-        majorPositions.insert(i * 10);  // 每整数MPa对应位置索引
-    }
-    const QColor black = QColor::fromCmyk(0, 0, 0, 100);
-    QPen minorPen(black, 0.3 * k, Qt::SolidLine, Qt::RoundCap);  // 小刻度：圆角端点
-    QPen majorPen(black, 0.8 * k, Qt::SolidLine, Qt::RoundCap);  // 大刻度：圆角端点
-    
-    // 绘制小刻度线 - 在非大刻度位置
-    p.setPen(minorPen);
-    for (int i = 0; i < totalPositions; ++i) {
-        if (!majorPositions.contains(i)) {  // 不是大刻度位置才画小刻度
-            double angle = yyqyV2Ang(i * 0.1, maxPressure, startAngle, totalAngle, points, pointsAngle);  // 从左上逆时针
-            double rad = qDegreesToRadians(angle);
-            QPointF outer(C.x() + r_minor_outer * qCos(rad), 
-                         C.y() - r_minor_outer * qSin(rad));
-            QPointF inner(C.x() + r_minor_inner * qCos(rad), 
-                         C.y() - r_minor_inner * qSin(rad));
-            p.drawLine(outer, inner);
-        }
-    }
-    
-    // 绘制大刻度线（对应整数MPa）
-    p.setPen(majorPen);
-    for (int pos : majorPositions) {
-        double angle = yyqyV2Ang(static_cast<double>(pos) * 0.1, maxPressure, startAngle, totalAngle, points, pointsAngle);
-        double rad = qDegreesToRadians(angle);
-        QPointF outer(C.x() + r_major_outer * qCos(rad), 
-                     C.y() - r_major_outer * qSin(rad));
-        QPointF inner(C.x() + r_major_inner * qCos(rad), 
-                     C.y() - r_major_inner * qSin(rad));
-        p.drawLine(outer, inner);
+    // 矢量格式：不栅格化，直接把绘制步骤写成 PDF/SVG，由印刷厂按印刷分辨率输出
+    if (ext == "pdf" || ext == "svg") {
+        runDialSaveJob("保存表盘图片", QString("正在写入矢量 %1...").arg(ext.toUpper()),
+                       [this, scene, fileName, ext](QString& message) {
+            QString error;
+            if (!DialRenderer::exportVector(scene, fileName, QString("%1 表盘").arg(m_dialType), error)) {
+                message = QString("错误：%1").arg(error);
+                return false;
+            }
+            message = QString("成功：已保存矢量 %1: %2").arg(ext.toUpper(), fileName);
+            return true;
+        });
+        return;
     }
-}
 
-void DialMarkDialog::drawYYQYNumbers(QPainter& p, const QPointF& C, double outerR, double totalAngle, double maxPressure,
-    QVector<double> points, QVector<double> pointsAngle)
-{
-    const double k = outerR / 16.3;         // 缩放系数
-    const double r_number = 10.2 * k;       // 数字半径，调整到更靠内避免被刻度线遮挡
-    
-    // 角度设置 - 表盘是左右对称的
-    const double startAngle = 90.0 + totalAngle / 2.0;  // 起始角度（从左上开始）
-    
-    // 计算刻度数量 - 根据配置的最大压力
-    
-    const int totalPositions = (int)(maxPressure * 10) + 1;  // 总刻度位置（每0.1MPa一个位置）
-    
-    
-    // 绘制数字（3号黑体）
-    const QColor black = QColor::fromCmyk(0, 0, 0, 100);
-    int fontSize = (int)(108 * k);  // 大幅增加字体大小
-    fontSize = qMax(fontSize, 72);  // 最小72px
-    fontSize = qMin(fontSize, 168);  // 最大168px
-    QFont numberFont("SimHei", fontSize, QFont::Normal);  // 数字不加粗
-    p.setFont(numberFont);
-    p.setPen(black);
-    
-    // 绘制数字在对应的大刻度位置
-    for (int i = 0; i <= (int)maxPressure; ++i) {
-        int pos = i * 10;  // 每整数MPa对应的位置索引
-        double angle = yyqyV2Ang(static_cast<double>(pos) * 0.1, maxPressure, startAngle, totalAngle, points, pointsAngle);
-        double rad = qDegreesToRadians(angle);
-        
-        QPointF numberPos(C.x() + r_number * qCos(rad), 
-                         C.y() - r_number * qSin(rad));
-        
-        QString text = QString::number(i);
-        
-        // 对于数字0，稍微向上偏移避开定位点
-        if (i == 0) {
-            numberPos.ry() -= k * 0.8;  // 向上偏移
-            numberPos.rx() -= k * 1.0;  // 向左偏移一点点
-        } else if (i == 1) {
-            numberPos.rx() -= k * 0.8;  // 向左偏移一点点
+    // 根据表盘类型确定 DPI
+    const double dpi = DialRenderer::outputDpi(m_dialType);
+
+    runDialSaveJob("保存表盘图片", "正在按成图分辨率渲染表盘...", [this, scene, fileName, dpi](QString& message) {
+        // 生成表盘图像
+        const QImage img = m_dialRenderer.render(scene);
+        QString formatName;
+        if (img.isNull() || !m_dialRenderer.saveImage(img, fileName, dpi, formatName)) {
+            message = "错误：保存失败";
+            return false;
         }
-        
-        // 计算文本矩形大小
-        QFontMetrics fm(numberFont);
-        QRect textRect = fm.boundingRect(text);
-        QRectF drawRect(numberPos.x() - textRect.width()/2.0, 
-                       numberPos.y() - textRect.height()/2.0, 
-                       textRect.width(), textRect.height());
-        
-        p.drawText(drawRect, Qt::AlignCenter, text);
-    }
-}
-
-void DialMarkDialog::drawYYQYColorBands(QPainter& p, const QPointF& C, double outerR, double totalAngle, double maxPressure,
-                                        QVector<double> points, QVector<double> pointsAngle)
-{
-    const double k = outerR / 16.3;
-    const double r_band_outer = 16.3 * k;   // 彩色带外沿
-    const double r_band_inner = 15.5 * k;   // 彩色带内沿（与刻度外沿对齐）
-    const double bandWidth = r_band_outer - r_band_inner;
-    const double r_mid = (r_band_outer + r_band_inner) / 2.0;
-    
-    QRectF arcRect(C.x() - r_mid, C.y() - r_mid, 2 * r_mid, 2 * r_mid);
-    
-    // 角度设置 - 与刻度保持一致
-    const double startAngle = 90.0 + totalAngle / 2.0;  // 起始角度
-
-
-    // 计算不同刻度线宽对应的角度补偿
-    const double w_major = 0.8 * k;  // 大刻度线宽
-    const double w_minor = 0.3 * k;  // 小刻度线宽
-    const double deltaDeg_major = qRadiansToDegrees(std::atan((w_major * 0.5) / r_mid));
-    const double deltaDeg_minor = qRadiansToDegrees(std::atan((w_minor * 0.5) / r_mid));
-    
-    QPen pen;
-    pen.setWidthF(bandWidth);
-    pen.setCapStyle(Qt::FlatCap);
-    
-    // 0-warningPressure：黑色
-    double black_start_angle = startAngle;
-    double black_end_angle = yyqyV2Ang(m_yyqyConfig.warningPressure, maxPressure, startAngle, totalAngle, points, pointsAngle);
-    
-    // 起始端（0MPa）角度补偿：0位置是大刻度，使用大刻度线宽
-    black_start_angle += deltaDeg_major;
-    
-    // 颜色定义 (CMYK色值)
-    const QColor blackBand = QColor::fromCmyk(0, 0, 0, 100);       // 纯黑色
-    const QColor redBand = QColor::fromCmyk(0, 100, 100, 0);       // 红色带
-    
-    pen.setColor(blackBand);
-    p.setPen(pen);
-    p.setBrush(Qt::NoBrush);
-    p.drawArc(arcRect, deg16(black_start_angle), deg16(black_end_angle - black_start_angle));
-    
-    // warningPressure-maxPressure：红色
-    double red_start_angle = black_end_angle;  // 从警告压力开始（无补偿，避免断开）
-    double red_end_angle = yyqyV2Ang(m_yyqyConfig.maxPressure, maxPressure, startAngle, totalAngle, points, pointsAngle);
-    
-    // 结束端角度补偿：检查末尾位置是大刻度还是小刻度
-    // 末尾位置的压力值
-    double endPressureValue = maxPressure;
-    bool isEndMajorTick = (std::abs(endPressureValue - std::round(endPressureValue)) < 1e-6);
-    
-    if (isEndMajorTick) {
-        // 如果末尾是大刻度，使用大刻度线宽
-        red_end_angle -= deltaDeg_major;
-    } else {
-        // 如果末尾是小刻度，使用小刻度线宽
-        red_end_angle -= deltaDeg_minor;
-    }
-    
-    pen.setColor(redBand);
-    p.setPen(pen);
-    p.drawArc(arcRect, deg16(red_start_angle), deg16(red_end_angle - red_start_angle));
-}
-
-void DialMarkDialog::drawYYQYCenterTexts(QPainter& p, const QPointF& C, double outerR)
-{
-    const double k = outerR / 16.3;
-    const QColor blue =  QColor::fromCmyk(100, 0, 0, 0);
-    
-    // "MPa"文字在圆心正上方R3位置（2号黑体）- 修复字体大小
-    int mpaFontSize = (int)(108 * k);  // 2号字体大幅增加，从18*k改为36*k
-    mpaFontSize = qMax(mpaFontSize, 88);  // 最小28px
-    mpaFontSize = qMin(mpaFontSize, 88);  // 最大56px
-    QFont mpaFont("黑体", mpaFontSize);  // MPa文字加粗
-    //mpaFont.setStretch(QFont::Condensed);  // 设置为窄体（高高细细）
-    p.setFont(mpaFont);
-    const QColor blackBand = QColor::fromCmyk(0, 0, 0, 100);
-    p.setPen(blackBand);
-    
-    QPointF mpaPos(C.x(), C.y() - 3 * k);
-    QFontMetrics mpafm(mpaFont);
-    QRect mpaRect = mpafm.boundingRect("MPa");
-    QRectF mpaDrawRect(mpaPos.x() - mpaRect.width()/2.0, 
-                      mpaPos.y() - mpaRect.height()/2.0, 
-                      mpaRect.width(), mpaRect.height());
-    p.drawText(mpaDrawRect, Qt::AlignCenter, "MPa");
-    
-    // "禁油"和"氧气"文字（3号黑体）- 修复字体大小
-    int textFontSize = (int)(88 * k);  // 3号字体大幅增加，从20*k改为40*k
-    textFontSize = qMax(textFontSize, 88);  // 最小32px
-    textFontSize = qMin(textFontSize, 88);  // 最大64px
-    QFont textFont("黑体", textFontSize, QFont::Normal);
-    //textFont.setStretch(QFont::Condensed);  // 设置为窄体（高高细细）
-    p.setFont(textFont);
-
-    double text_r = 5 * k;  // R4位置
-    double text_y_offset = 0.7 * k;  // 相对圆心往下偏移
-    
-    // "禁油"文字在圆心左边
-    QPointF jinYouPos(C.x() - text_r, C.y() + text_y_offset);  // 添加向下偏移
-    QFontMetrics textfm(textFont);
-    QRect jinYouRect = textfm.boundingRect("禁油");
-    QRectF jinYouDrawRect(jinYouPos.x() - jinYouRect.width()/2.0, 
-                         jinYouPos.y() - jinYouRect.height()/2.0, 
-                         jinYouRect.width(), jinYouRect.height());
-    p.drawText(jinYouDrawRect, Qt::AlignCenter, "禁油");
-    
-    // "氧气"文字在圆心右边（有蓝色下划线）
-    QPointF yangQiPos(C.x() + text_r, C.y() + text_y_offset);  // 添加向下偏移
-    QRect yangQiRect = textfm.boundingRect("氧气");
-    QRectF yangQiDrawRect(yangQiPos.x() - yangQiRect.width()/2.0, 
-                         yangQiPos.y() - yangQiRect.height()/2.0, 
-                         yangQiRect.width(), yangQiRect.height());
-    p.setPen(blackBand);
-    p.drawText(yangQiDrawRect, Qt::AlignCenter, "氧气");
-    
-    // 绘制"氧气"的蓝色下划线（酞蓝色PB06，宽0.5，圆角）---改0.1
-    QPen underlinePen(blue, 0.45 * k, Qt::SolidLine);
-    p.setPen(underlinePen);
-    double underlineY = yangQiDrawRect.bottom() + k * 0.5;  //   - k * 0.1;  // 更靠近文字
-    // 下划线与文字一样宽，不留边距
-    p.drawLine(QPointF(yangQiDrawRect.left() + 0.3 * k, underlineY), 
-               QPointF(yangQiDrawRect.right() - 0.3 * k, underlineY));
-}
-
-void DialMarkDialog::drawYYQYPositionDot(QPainter& p, const QPointF& C, double outerR, double totalAngle)
-{
-    const double k = outerR / 16.3;
-    
-    // 定位点是两个条件的交点：
-    // 1. 角度：0刻度线减1度的位置
-    // 2. 距离：圆心垂直向下R10
-    const double startAngle = 90.0 + totalAngle / 2.0;  // 0刻度线的角度
-    double dotAngle = startAngle + 6.0;  // 0刻度减1度（向逆时针偏移）
-    const QColor blackBand = QColor::fromCmyk(0, 0, 0, 100);
-    
-    // 计算在该角度方向上，距离圆心R10的点
-    double r_dot = 11.4 * k;
-    double rad = qDegreesToRadians(dotAngle);
-    QPointF dotPos(C.x() + r_dot * qCos(rad), 
-                   C.y() - r_dot * qSin(rad));
-    
-    p.setPen(blackBand);
-    p.setBrush(blackBand);
-    double dotRadius = 0.3 * k;  // 缩小定位点
-    p.drawEllipse(dotPos, dotRadius, dotRadius);
-}
-
-void DialMarkDialog::drawYYQYLogo(QPainter& p, const QPointF& C, double outerR)
-{
-    const double k = outerR / 16.3;  // 缩放系数
-    
-    // 加载商标图片
-    QString logoPath = QApplication::applicationDirPath() + "/images/logo_region.png";
-    QPixmap logoPixmap(logoPath);
-    
-    if (logoPixmap.isNull()) {
-        qDebug() << "无法加载商标图片：" << logoPath;
-        return;
-    }
-    
-    QImage logoImage = logoPixmap.toImage();
-    
-    // 商标上边界在圆心向下R19的位置
-    double logoTopY = C.y() + 10.0 * k;  // 圆心向下R19
-    
-    // 商标大小不受刻度盘角度影响，只依赖于表盘缩放
-    double logoScale = k * 0.01913824057;  // 固定比例，不受角度影响
-    // 计算缩放后的商标尺寸
-    int scaledWidth = (int)(logoImage.width() * logoScale);
-    int scaledHeight = (int)(logoImage.height() * logoScale);
-    
-    // 缩放商标图像
-    QImage scaledLogo = logoImage.scaled(scaledWidth, scaledHeight, 
-                                        Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    
-    // 计算商标的中心位置（水平居中，上边界在指定位置）
-    QPointF logoPos(C.x() - scaledWidth / 2.0, logoTopY);
-    
-    // 绘制商标
-    const QColor blackBand = QColor::fromCmyk(0, 0, 0, 100);
-    p.setPen(blackBand);
-    p.drawImage(logoPos, scaledLogo);
-    
-    qDebug() << "商标已绘制在位置：" << logoPos << "，尺寸：" << scaledWidth << "x" << scaledHeight;
+        message = QString("成功：已保存 %1: %2").arg(formatName, fileName);
+        return true;
+    });
 }
 
 void DialMarkDialog::updateAngleComboBox()
@@ -2213,132 +1699,12 @@ void DialMarkDialog::applyFinalDataFromErrorTable()
     // 更新下拉框数据
     updateAngleComboBox();
 
-    // 关键：立即重新生成并替换显示的图片
+    // 关键：切到生成的表盘并刷新预览（合并刷新，成图分辨率等保存时再画）
     if (m_imageLabel) {
-        QImage img = generateDialImage();
-        if (!img.isNull()) {
-            m_imageLabel->setImage(QPixmap::fromImage(img));
-            qDebug() << "applyFinalDataFromErrorTable: 已应用最终数据并刷新显示";
-        } else {
-            qDebug() << "applyFinalDataFromErrorTable: 生成图像失败";
-        }
+        m_showingGeneratedDial = true;
+        schedulePreview();
+        qDebug() << "applyFinalDataFromErrorTable: 已应用最终数据，等待刷新预览";
     }
 
     updateMaxInfoLabel();  // 新增：导入后刷新“最大压力/最大角度”
 }
-// ======= RGB 到 CMYK 转换 =======
-void DialMarkDialog::rgbToCmyk(int r, int g, int b, int& c, int& m, int& y, int& k)
-{
-    // 归一化 RGB 到 0-1
-    double rf = r / 255.0;
-    double gf = g / 255.0;
-    double bf = b / 255.0;
-    
-    // 计算 K (黑色)
-    double kf = 1.0 - std::max({rf, gf, bf});
-    
-    // 避免除以零
-    if (kf >= 1.0) {
-        c = m = y = 0;
-        k = 255;
-        return;
-    }
-    
-    // 计算 CMY
-    double cf = (1.0 - rf - kf) / (1.0 - kf);
-    double mf = (1.0 - gf - kf) / (1.0 - kf);
-    double yf = (1.0 - bf - kf) / (1.0 - kf);
-    
-    // 转换到 0-255 范围
-    c = static_cast<int>(std::round(cf * 255.0));
-    m = static_cast<int>(std::round(mf * 255.0));
-    y = static_cast<int>(std::round(yf * 255.0));
-    k = static_cast<int>(std::round(kf * 255.0));
-    
-    // 限制范围
-    c = std::clamp(c, 0, 255);
-    m = std::clamp(m, 0, 255);
-    y = std::clamp(y, 0, 255);
-    k = std::clamp(k, 0, 255);
-}
-
-// ======= CMYK TIFF 保存 =======
-bool DialMarkDialog::saveCmykTiff(const QImage& img, const QString& fileName, double dpi)
-{
-#ifdef HAS_LIBTIFF
-    // 确保图像有效
-    if (img.isNull()) {
-        qDebug() << "saveCmykTiff: 图像为空";
-        return false;
-    }
-    
-    int width = img.width();
-    int height = img.height();
-    
-    // 打开 TIFF 文件
-    TIFF* tif = TIFFOpen(fileName.toUtf8().constData(), "w");
-    if (!tif) {
-        qDebug() << "saveCmykTiff: 无法打开文件" << fileName;
-        return false;
-    }
-    
-    // 设置 TIFF 标签
-    TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, width);
-    TIFFSetField(tif, TIFFTAG_IMAGELENGTH, height);
-    TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, 4);      // CMYK = 4 通道
-    TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 8);        // 每通道 8 位
-    TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
-    TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_SEPARATED);  // CMYK
-    TIFFSetField(tif, TIFFTAG_INKSET, INKSET_CMYK);
-    TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);   // 交织存储
-    TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_LZW);        // LZW 压缩
-    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(tif, width * 4));
-    
-    // 设置 DPI
-    TIFFSetField(tif, TIFFTAG_RESOLUTIONUNIT, RESUNIT_INCH);
-    TIFFSetField(tif, TIFFTAG_XRESOLUTION, dpi);
-    TIFFSetField(tif, TIFFTAG_YRESOLUTION, dpi);
-    
-    // 分配行缓冲区
-    std::vector<uint8_t> cmykRow(width * 4);
-    
-    // 转换并写入每一行
-    QImage rgbImg = img.convertToFormat(QImage::Format_RGB32);
-    
-    for (int y = 0; y < height; ++y) {
-        const QRgb* scanline = reinterpret_cast<const QRgb*>(rgbImg.constScanLine(y));
-        
-        for (int x = 0; x < width; ++x) {
-            QRgb pixel = scanline[x];
-            int r = qRed(pixel);
-            int g = qGreen(pixel);
-            int b = qBlue(pixel);
-            
-            int c, m, yk, k;
-            rgbToCmyk(r, g, b, c, m, yk, k);
-            
-            cmykRow[x * 4 + 0] = static_cast<uint8_t>(c);
-            cmykRow[x * 4 + 1] = static_cast<uint8_t>(m);
-            cmykRow[x * 4 + 2] = static_cast<uint8_t>(yk);
-            cmykRow[x * 4 + 3] = static_cast<uint8_t>(k);
-        }
-        
-        if (TIFFWriteScanline(tif, cmykRow.data(), y, 0) < 0) {
-            qDebug() << "saveCmykTiff: 写入行" << y << "失败";
-            TIFFClose(tif);
-            return false;
-        }
-    }
-    
-    TIFFClose(tif);
-    qDebug() << "saveCmykTiff: 成功保存 CMYK TIFF:" << fileName;
-    return true;
-    
-#else
-    // 没有 libtiff，回退到 Qt 的 RGB TIFF
-    qDebug() << "saveCmykTiff: libtiff 未启用，回退到 RGB TIFF";
-    QImageWriter writer(fileName, "tiff");
-    writer.setCompression(1);
-    return writer.write(img);
-#endif
-}
@@ -28,15 +28,12 @@
 #include <QInputDialog>
 #include <QShortcut>
 #include <QKeyEvent>
-
-// libtiff 支持（用于导出 CMYK TIFF）
-#ifdef HAS_LIBTIFF
-extern "C" {
-#include <tiffio.h>
-}
-#endif
+#include <QTimer>
+#include <QPointer>
+#include <QThread>
 
 #include "errortabledialog.h"
+#include "dialrenderer.h"
 
 // 文本标注项
 struct TextAnnotation {
@@ -54,29 +51,6 @@ struct TextAnnotation {
                       isBold(false), isItalic(false), isSelected(false) {}
 };
 
-// BYQ表盘配置
-struct BYQDialConfig {
-    double maxPressure;      // 最大压力值 (MPa)
-    double totalAngle;       // 表盘总角度 (度)
-    double majorStep;        // 主刻度步长 (MPa)
-    double minorStep;        // 次刻度步长 (MPa)
-    QVector<double> points;  // 中间节点的值
-    QVector<double> pointsAngle;  // 中间节点的角度值
-
-    BYQDialConfig() : maxPressure(25.0), totalAngle(95.0), majorStep(5.0), minorStep(1.0), points({0.0, 5.0, 10.0, 15.0, 20.0, 25.0}), pointsAngle({0.0, 15.0, 35.0, 56.0, 78.0, 95.0}) {}
-};
-
-// YYQY表盘配置
-struct YYQYDialConfig {
-    double maxPressure;      // 最大压力值 (MPa)
-    double totalAngle;       // 表盘总角度 (度)
-    double warningPressure;  // 警告压力值 (MPa) - 黑色到红色的分界点
-    QVector<double> points;  // 中间节点的角度值
-    QVector<double> pointsAngle;  // 中间节点的角度值
-
-    YYQYDialConfig() : maxPressure(6.3), totalAngle(270.0), warningPressure(4.0) ,points({0.0, 1.0, 2.0, 3.0, 4.0, 5.0}), pointsAngle({0.0, 45.0, 90.0, 135.0, 185.0, 232.5}) {}
-};
-
 // 自定义图片显示标签类，支持鼠标交互
 class AnnotationLabel : public QLabel
 {
@@ -84,7 +58,10 @@ class AnnotationLabel : public QLabel
 
 public:
     explicit AnnotationLabel(QWidget *parent = nullptr);
-    void setImage(const QPixmap &pixmap);
+    // imageSize 是原图尺寸：显示的是低分辨率预览时，缩放和标注坐标都按原图算（不传就是 pixmap 本身的尺寸）
+    void setImage(const QPixmap &pixmap, const QSize &imageSize = QSize());
+    // 换一张同尺寸的图（比如预览刷新），保留当前缩放和拖动位置
+    void replaceImage(const QPixmap &pixmap, const QSize &imageSize);
     void addTextAnnotation(const QPoint &pos, const QString &text, const QColor &color, 
                           int fontSize, const QString &fontFamily = "黑体", 
                           bool isBold = false, bool isItalic = false);
@@ -103,6 +80,10 @@ public:
     void updateSelectedAnnotation(const QString &text, const QColor &color, int fontSize, 
                                  const QString &fontFamily, bool isBold = false, bool isItalic = false);
     QPixmap getAnnotatedImage() const;
+    // 按原图坐标把标注画到 painter 上（字号按显示缩放折算，和 getAnnotatedImage 一致），可在工作线程调用
+    static void paintAnnotations(QPainter &painter, const QList<TextAnnotation> &annotations, double scaleFactor);
+    double scaleFactor() const { return m_scaleFactor; }
+    QSize imageSize() const { return m_imageSize; }
     int getSelectedAnnotation() const { return m_selectedAnnotation; }
     void setSelectedAnnotation(int index);
     
@@ -125,9 +106,11 @@ signals:
     void annotationClicked(int index);
     void annotationAdded(const QPoint &pos);
     void annotationRightClicked(int index, const QPoint &globalPos);
+    void zoomChanged();
 
 private:
     QPixmap m_originalPixmap;
+    QSize m_imageSize;       // 原图尺寸（标注坐标系）
     QList<TextAnnotation> m_annotations;
     QColor m_currentColor;
     int m_currentFontSize;
@@ -210,6 +193,9 @@ private slots:
     void updateAnnotationList();
     void exportImage();
 
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+
 private:
     AnnotationLabel *m_imageLabel;
     QScrollArea *m_scrollArea;
@@ -234,40 +220,24 @@ private:
 
 
 
-    // 表盘生成相关
-    QImage generateDialImage();
-    QImage generateBYQDialImage();   // BYQ类型表盘
-    QImage generateYYQYDialImage();  // YYQY类型表盘
+    // 表盘生成相关：绘制、分层缓存、成图写出都在 DialRenderer 里，这里只管配置、预览和保存流程
+    DialRenderer m_dialRenderer;
+    DialRenderer::Scene buildDialScene();  // 按当前类型和配置录制（界面线程）
     
-    // BYQ表盘绘制方法
-    void drawBYQTicksAndNumbers(QPainter& p, const QPointF& C, double outerR,
-                                double startDeg,double totalAngle, double spanDeg, double vmax, double majorStep,
-                                QVector<double> points,QVector<double> pointsAngle);
-    void drawBYQColorBands(QPainter& p, const QPointF& C, double outerR,
-                           double startDeg, double totalAngle, double spanDeg, double vmax,
-                           QVector<double> points,QVector<double> pointsAngle);
-    void drawBYQUnitMPa(QPainter& p, const QPointF& C, double outerR);
+    // 界面预览：同一张场景按窗口分辨率缩小重放成 8 位小图，配置/缩放/窗口大小变了合并到停下来再刷新一次；
+    // 成图分辨率的 16 位整图只在保存、导出时在后台渲染
+    void schedulePreview();
+    bool updatePreview();
+    QTimer *m_previewTimer = nullptr;
+    bool m_showingGeneratedDial = false;   // 界面上显示的是生成的表盘（预览）而不是读入的图片
     
-    // YYQY表盘绘制方法  
-    void drawYYQYTicks(QPainter& p, const QPointF& C, double outerR, double totalAngle,double maxPressure,
-                       QVector<double> points,QVector<double> pointsAngle);
-    void drawYYQYNumbers(QPainter& p, const QPointF& C, double outerR, double totalAngle, double maxPressure,
-                         QVector<double> points, QVector<double> pointsAngle);
-    void drawYYQYColorBands(QPainter& p, const QPointF& C, double outerR, double totalAngle,double maxPressure,
-                                        QVector<double> points,QVector<double> pointsAngle);
-    void drawYYQYCenterTexts(QPainter& p, const QPointF& C, double outerR);
-    void drawYYQYPositionDot(QPainter& p, const QPointF& C, double outerR, double totalAngle);
-    void drawYYQYLogo(QPainter& p, const QPointF& C, double outerR);  // 绘制商标
+    // 后台保存：work 在工作线程里渲染并写文件，message 返回提示文本；界面线程显示进度框，结束后弹出结果
+    void runDialSaveJob(const QString& title, const QString& label, std::function<bool(QString&)> work);
+    QPointer<QThread> m_saveThread;
     
     void saveGeneratedDial();
     void updateMaxInfoLabel();          // 新增：刷新显示文本
     
-    // CMYK TIFF 保存（需要 libtiff）
-    bool saveCmykTiff(const QImage& img, const QString& fileName, double dpi);
-    
-    // RGB 到 CMYK 转换
-    static void rgbToCmyk(int r, int g, int b, int& c, int& m, int& y, int& k);
-    
     // 表盘配置参数
     struct DialConfig {
         int imageSize = 800;           // 图片尺寸
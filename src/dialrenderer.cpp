@@ -0,0 +1,1068 @@
+#include "dialrenderer.h"
+#include "dialvectorexport.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFileInfo>
+#include <QImageWriter>
+#include <QPainter>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// libtiff 支持（用于导出 CMYK TIFF）
+#ifdef HAS_LIBTIFF
+extern "C" {
+#include <tiffio.h>
+}
+#endif
+
+static inline int dpi_to_dpm(double dpi) { return qRound(dpi / 0.0254); } // = dpi*39.370079
+// QImage 在给定 dots-per-meter 下报告的逻辑 DPI（字体磅值按它换算）；dpm <= 0 表示 QImage 默认值
+static int imageLogicalDpi(int dpm)
+{
+    QImage probe(1, 1, QImage::Format_RGBA64_Premultiplied);
+    if (dpm > 0) {
+        probe.setDotsPerMeterX(dpm);
+        probe.setDotsPerMeterY(dpm);
+    }
+    return probe.logicalDpiY();
+}
+
+static inline int deg16(double deg){ return int(std::round(deg*16.0)); }
+static inline QPointF pol2(const QPointF& c, double angDeg, double r){
+    const double a = qDegreesToRadians(angDeg);
+    return QPointF(c.x() + r*std::cos(a), c.y() - r*std::sin(a)); // y 轴向下
+}
+
+
+//注意一下    v2ang 也需要在中间节点调用
+static inline double v2ang(double v, double vmax, double startDeg, double totalAngle,QVector<double> points,QVector<double> pointsAngle){
+    //  确保两端点完整（若已经在列表里则不会重复添加）
+    QVector<double> allP = points;
+    QVector<double> allA = pointsAngle;
+
+    if (allP.isEmpty() || allP.last()  != vmax) allP.append(vmax);
+    if (allA.isEmpty() || allA.last()  != totalAngle) allA.append(totalAngle);
+
+    //  参数合法性检查（超出范围则 clamp）
+    v = std::clamp(v, 0.0, vmax);
+
+    // 找到 v 所在的主段
+    int idx = 0;
+    for (int i = 0; i < allP.size() - 1; ++i) {
+        if (v >= allP[i] && v <= allP[i + 1]) {
+            idx = i;
+            break;
+        }
+    }
+
+    double pCurr = allP[idx];
+    double pNext = allP[idx + 1];
+    double aCurr = allA[idx];
+    double aNext = allA[idx + 1];
+
+    // 最后一段之前均分 5 份，最后一份单独处理
+    if(idx == allP.size() - 2){
+        // 最后一段
+        const double lastStep = 1.0; // 最后一段单独处理，步长为1.0
+        double angleStep = (aNext - aCurr) / ((pNext - pCurr) / lastStep);
+        return startDeg - (aCurr + (v - pCurr) * angleStep); // 注意这里是减去，因为顺时针方向角度减小
+    }else{
+        const double subDiv = 5.0;
+        double angleStep = (aNext - aCurr) / subDiv;
+        return startDeg - (aCurr + (v - pCurr) * angleStep);
+        }
+}
+
+// ======= 表盘分层缓存 =======
+// 层缓存键：几何参数 + 本层用到的配置值 + 分段点（带上个数，免得两组分段点拼起来一样）
+template <size_t N>
+static DialRenderer::LayerKey dialLayerKey(const double (&geo)[N], std::initializer_list<double> values,
+                                           const QVector<double>& points = {}, const QVector<double>& pointsAngle = {})
+{
+    DialRenderer::LayerKey key;
+    key.inputs.reserve(int(N + values.size()) + 2 + points.size() + pointsAngle.size());
+    key.inputs.append(QVector<double>(std::begin(geo), std::end(geo)));
+    key.inputs.append(QVector<double>(values.begin(), values.end()));
+    key.inputs << double(points.size()) << points << double(pointsAngle.size()) << pointsAngle;
+    key.hash = qHashRange(key.inputs.cbegin(), key.inputs.cend());
+    return key;
+}
+
+// 预乘图里 alpha 不为 0 的最小外接矩形
+static QRect opaqueBounds(const QImage& img)
+{
+    const int w = img.width();
+    int top = -1, bottom = -1, left = w, right = -1;
+    for (int y = 0; y < img.height(); ++y) {
+        const QRgba64* row = reinterpret_cast<const QRgba64*>(img.constScanLine(y));
+        int x0 = 0;
+        while (x0 < w && row[x0].alpha() == 0) ++x0;
+        if (x0 == w) continue;
+        int x1 = w - 1;
+        while (x1 > x0 && row[x1].alpha() == 0) --x1;
+        if (top < 0) top = y;
+        bottom = y;
+        left = std::min(left, x0);
+        right = std::max(right, x1);
+    }
+    return top < 0 ? QRect() : QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+DialRenderer::Layer DialRenderer::cachedLayer(const QString& name, const LayerKey& key, const QSize& canvas,
+                                              int paintDpm, const DisplayList& steps)
+{
+    Layer& layer = m_layers[name];
+    if (layer.valid && layer.key == key && layer.canvas == canvas && layer.paintDpm == paintDpm) {
+        return layer;
+    }
+    
+    // 在整张透明画布上画（坐标和直接画在成图上一样），只留有内容的那一块
+    QImage full(canvas, QImage::Format_RGBA64_Premultiplied);
+    full.fill(Qt::transparent);
+    if (paintDpm > 0) {
+        full.setDotsPerMeterX(paintDpm);
+        full.setDotsPerMeterY(paintDpm);
+    }
+    renderSteps(full, steps);
+    
+    layer.key = key;
+    layer.canvas = canvas;
+    layer.paintDpm = paintDpm;
+    layer.valid = true;
+    layer.rect = opaqueBounds(full);
+    layer.image = layer.rect.isNull() ? QImage() : full.copy(layer.rect);
+    return layer;
+}
+
+QImage DialRenderer::composeLayers(const QSize& canvas, int paintDpm, int outDpm, const QVector<Layer>& layers)
+{
+    // 各层输入和画布都没变时直接用上次合成好的图
+    QVector<LayerKey> keys;
+    keys.reserve(layers.size() + 1);
+    for (const Layer& layer : layers) keys << layer.key;
+    LayerKey frame;
+    frame.inputs = {double(canvas.width()), double(canvas.height()), double(paintDpm), double(outDpm)};
+    keys << frame;
+    if (!m_composed.isNull() && keys == m_composedKeys) {
+        return m_composed;
+    }
+    
+    QImage img(canvas, QImage::Format_RGBA64);
+    img.fill(Qt::white);
+    if (paintDpm > 0) {
+        img.setDotsPerMeterX(paintDpm);
+        img.setDotsPerMeterY(paintDpm);
+    }
+    // 按原来的绘制顺序逐层叠加（整数位置，不重采样）
+    DisplayList steps;
+    for (const Layer& layer : layers) {
+        if (layer.image.isNull()) continue;
+        steps << [layer](QPainter& p) { p.drawImage(layer.rect.topLeft(), layer.image); };
+    }
+    renderSteps(img, steps);
+    img.setDotsPerMeterX(outDpm);
+    img.setDotsPerMeterY(outDpm);
+    
+    m_composed = img;
+    m_composedKeys = keys;
+    return img;
+}
+
+// ======= 主入口：生成表盘图 =======
+DialRenderer::Scene DialRenderer::buildScene(const QString& dialType, const BYQDialConfig& byq, const YYQYDialConfig& yyqy)
+{
+    if (dialType == "YYQY-13") {
+        return buildYYQYScene(yyqy);
+    } else {
+        return buildBYQScene(byq);
+    }
+}
+
+double DialRenderer::outputDpi(const QString& dialType)
+{
+    return (dialType == "YYQY-13") ? 960.0 : 2400.0;
+}
+
+void DialRenderer::setLogoPath(const QString& path)
+{
+    if (path == m_logoPath) return;
+    m_logoPath = path;
+    m_logoSourceLoaded = false;
+    m_logoSource = QImage();
+    m_scaledLogo = QImage();
+}
+
+void DialRenderer::renderSteps(QImage& img, const DisplayList& steps) const
+{
+    if (m_parallel) {
+        renderDisplayListTiled(img, steps);
+    } else {
+        renderDisplayList(img, steps);
+    }
+}
+
+// 栅格输出：各层按键缓存，只重画键变了的层，再按原顺序叠加
+QImage DialRenderer::render(const Scene& scene)
+{
+    QVector<Layer> layers;
+    for (const SceneLayer& layer : scene.layers) {
+        layers << cachedLayer(layer.name, layer.key, scene.canvas, scene.paintDpm, layer.steps);
+    }
+    return composeLayers(scene.canvas, scene.paintDpm, scene.outDpm, layers);
+}
+
+// 矢量输出：同一份显示列表整体重放到 PDF / SVG
+bool DialRenderer::exportVector(const Scene& scene, const QString& fileName, const QString& title, QString& error)
+{
+    DialVectorOptions options;
+    options.canvas = scene.canvas;
+    options.paintDpi = imageLogicalDpi(scene.paintDpm);
+    options.outDpi = imageLogicalDpi(scene.outDpm);
+    options.title = title;
+    DisplayList steps;
+    for (const SceneLayer& layer : scene.layers) steps += layer.steps;
+    
+    if (fileName.endsWith(".svg", Qt::CaseInsensitive)) {
+        return exportDisplayListSvg(fileName, steps, options, error);
+    }
+    return exportDisplayListPdf(fileName, steps, options, error);
+}
+
+// 预览：整张显示列表前面加一步缩放，重放到窗口大小的 8 位图上。
+// 图的 DPI 和成图一样，字体磅值换算出的像素数也一样，缩放之后几何和成图逐处对应；不走分层缓存
+QImage DialRenderer::renderPreview(const Scene& scene, const QSize& bound)
+{
+    const QSize size = scene.canvas.scaled(bound, Qt::KeepAspectRatio).boundedTo(scene.canvas);
+    if (size.isEmpty()) return QImage();
+    
+    QImage img(size, QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::white);
+    if (scene.paintDpm > 0) {
+        img.setDotsPerMeterX(scene.paintDpm);
+        img.setDotsPerMeterY(scene.paintDpm);
+    }
+    const double sx = double(size.width()) / scene.canvas.width();
+    const double sy = double(size.height()) / scene.canvas.height();
+    DisplayList steps;
+    steps << [sx, sy](QPainter& p) {
+        p.scale(sx, sy);
+        p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    };
+    for (const SceneLayer& layer : scene.layers) steps += layer.steps;
+    renderDisplayListTiled(img, steps);
+    return img;
+}
+
+// ======= BYQ表盘生成 =======
+DialRenderer::Scene DialRenderer::buildBYQScene(const BYQDialConfig& config)
+{
+    // 使用优化后的配置参数
+    const int OUT_W = 2778;         // 图片宽度
+    const int OUT_H = 2363;         // 图片高度
+    const double OUT_DPI = 2400;    // 图片DPI
+
+    // 2) DPI 元数据（TIFF 会映射为 X/YResolution）；BYQ 在绘制前就按 2400 DPI，字体磅值按它换算
+    const int dpm = dpi_to_dpm(OUT_DPI);
+    const QSize canvas(OUT_W, OUT_H);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    // 3) 可选：嵌入 sRGB 色彩空间（印前/跨软件显示更一致）
+    // img.setColorSpace(QColorSpace::SRgb);
+#endif
+
+    // 4) 开始绘制——根据用户输入的角度和压力值
+    // 圆心位置
+    const QPointF C(OUT_W/2.0, OUT_H * 0.54);
+    
+    // 表盘半径
+    const double Rpx = std::min(OUT_W, OUT_H) * 0.4;
+    const double totalAngle = config.pointsAngle[5];  // 用户输入的角度
+    const double vmax = config.maxPressure;       // 用户输入的最大压力
+    const QVector<double>& points = config.points;           // 保存的分段点
+    const QVector<double>& pointsAngle = config.pointsAngle; // 保存的分段角度
+
+    // 角度系统：根据用户输入的角度-----使用自动保存的起始角度
+    const double startDeg = 90.0 + totalAngle/2.0;     // 起始角度（左上）
+    const double spanDeg = -totalAngle;                // 角度跨度（顺时针）
+
+    // 主刻度间隔：根据最大压力自动计算  
+    double majorStep = 5.0;  // 默认5MPa间隔
+    if (vmax <= 10.0) majorStep = 2.0;
+    else if (vmax <= 25.0) majorStep = 5.0;
+    else if (vmax <= 50.0) majorStep = 10.0;
+    else majorStep = 20.0;
+
+    // 每层录成显示列表（参数按值捕获）；键是本层的输入参数，栅格输出按它缓存，矢量输出直接重放
+    const double geo[] = {double(OUT_W), double(OUT_H), double(dpm), C.x(), C.y(), Rpx};
+    Scene scene;
+    scene.canvas = canvas;
+    scene.paintDpm = dpm;
+    scene.outDpm = dpm;
+    // ① 先绘制刻度与数字
+    scene.layers << SceneLayer{"byq.ticks",
+        dialLayerKey(geo, {startDeg, totalAngle, spanDeg, vmax, majorStep}, points, pointsAngle),
+        {[=](QPainter& p) { drawBYQTicksAndNumbers(p, C, Rpx, startDeg, totalAngle, spanDeg, vmax, majorStep, points, pointsAngle); }}};
+    // ② 然后绘制彩色带
+    scene.layers << SceneLayer{"byq.bands",
+        dialLayerKey(geo, {startDeg, totalAngle, spanDeg, vmax}, points, pointsAngle),
+        {[=](QPainter& p) { drawBYQColorBands(p, C, Rpx, startDeg, totalAngle, spanDeg, vmax, points, pointsAngle); }}};
+    // ③ 最后绘制单位（只跟几何有关，配置怎么改都不用重画）
+    scene.layers << SceneLayer{"byq.unit", dialLayerKey(geo, {}),
+        {[=](QPainter& p) { drawBYQUnitMPa(p, C, Rpx); }}};
+    return scene;
+}
+
+//BYQ刻度绘制
+void DialRenderer::drawBYQTicksAndNumbers(QPainter& p, const QPointF& C, double outerR,
+    double startDeg, double totalAngle, double spanDeg, double vmax, double majorStep, QVector<double> points, QVector<double> pointsAngle)
+{
+    const double r17_1 = outerR;                        // R17.1：最外圆
+    const double r16_1 = outerR * (16.1 / 17.1);       // R16.1：彩色带内圈
+    const double r15_1 = outerR * (15.1 / 17.1);       // R15.1：小刻度线外沿
+    const double r14_6 = outerR * (14.6 / 17.1);       // R14.6：大刻度线内沿
+    const double r13_0 = outerR * (12.8 / 17.1);       // R14.0：数字位置
+    // 刻度线宽：根据实际半径调整，保持合理比例
+    const double lineScale = outerR / 300.0;  // 基准缩放
+    const QColor black = QColor::fromCmyk(0, 0, 0, 100);
+    QPen penMinor(black, std::max(2.0, 0.5 * lineScale * 10), Qt::SolidLine, Qt::RoundCap);    // 小刻度：平直端点
+    QPen penMajor(black, std::max(2.5, 0.8 * lineScale * 10), Qt::SolidLine, Qt::RoundCap);   // 大刻度：圆形端点
+
+    // 次刻度（1 MPa间隔）
+    p.setPen(penMinor);
+    const double minorStep = 1.0;
+    for (double v = 0; v <= vmax + 1e-6; v += minorStep) {
+        const double ang = v2ang(v, vmax, startDeg, totalAngle, points, pointsAngle);
+        p.drawLine(pol2(C, ang, r16_1), pol2(C, ang, r15_1));
+    }
+
+    // 主刻度（5 MPa间隔）————需要改进
+    p.setPen(penMajor);
+    const double majorTickStep = 5.0;
+    for (double v = 0; v <= vmax + 1e-6; v += majorTickStep) {
+        const double ang = v2ang(v, vmax, startDeg, totalAngle, points, pointsAngle);
+        p.drawLine(pol2(C, ang, r16_1), pol2(C, ang, r14_6));
+    }
+
+    // 数字字体：直接使用合理的固定字体大小，不要基于比例计算
+    const int fontNumberPx = 4;  // 固定合理字体大小
+    QFont numFont("Arial", fontNumberPx, QFont::Bold);
+    p.setFont(numFont);
+    p.setPen(QPen(black, 1));
+
+    // 数字：0,10,20,30,40,50（每10MPa一个数字）
+    for (double v = 0; v <= vmax + 1e-6; v += majorStep) {
+        const double ang = v2ang(v, vmax, startDeg, totalAngle, points, pointsAngle);
+        const QPointF pos = pol2(C, ang, r13_0);
+        const QString t = QString::number(int(v));
+        QRectF br = p.fontMetrics().boundingRect(t);
+        br.moveCenter(pos);
+        p.drawText(br, Qt::AlignCenter, t);
+    }
+}
+
+// ======= BYQ表盘绘制函数 =======
+void DialRenderer::drawBYQColorBands(QPainter& p, const QPointF& C, double outerR,
+    double startDeg,double totalAngle, double spanDeg, double vmax,QVector<double> points,QVector<double> pointsAngle)
+{
+    const double r17_1 = outerR;   // 彩带外沿
+    const double r16_1 = outerR * (16.1 / 17.1);   // 彩带内沿
+    const double r_mid = 0.5 * (r16_1 + r17_1);
+    const double bandWidth = (r17_1 - r16_1);
+
+    QRectF arcRect(C.x() - r_mid, C.y() - r_mid, 2*r_mid, 2*r_mid);
+
+    // 与刻度一致的"主刻度线宽"
+    const double lineScale = outerR / 300.0;
+    const double w_major = std::max(2.0, 0.4 * lineScale * 10);
+    const double deltaDeg = qRadiansToDegrees(std::atan((w_major * 0.8) / r_mid));
+    const bool clockwise = (spanDeg < 0);
+
+    // ③ 颜色分段 (CMYK色值)
+    const QColor Y07 = QColor::fromCmyk(0, 0, 100, 10);    // 黄色带
+    const QColor G02 = QColor::fromCmyk(100, 0, 100, 0);   // 绿色带
+    const QColor R03 = QColor::fromCmyk(0, 100, 100, 0);   // 红色带
+    struct Seg { double v0, v1; QColor c; };
+    const QVector<Seg> segs = {
+        { 0.0,  5.9, Y07},
+        { 5.9, 21.0, G02},
+        {21.0, vmax, R03}
+    };
+
+    QPen pen;
+    pen.setWidthF(bandWidth);
+    pen.setCapStyle(Qt::FlatCap);
+
+    // 只在两端做角度补偿
+    const double eps = 1e-9;
+    for (const auto& s : segs) {
+        
+        double a0 = v2ang(s.v0, vmax, startDeg, totalAngle, points, pointsAngle);
+        double a1 = v2ang(s.v1, vmax, startDeg, totalAngle, points, pointsAngle);
+        if (std::abs(s.v0 - 0.0) < eps) {
+            a0 -= (clockwise ? -deltaDeg : +deltaDeg);
+        }
+        if (std::abs(s.v1 - vmax) < eps) {
+            a1 -= (clockwise ? +deltaDeg : -deltaDeg);
+        }
+
+        pen.setColor(s.c);
+        p.setPen(pen);
+        p.setBrush(Qt::NoBrush);
+        p.drawArc(arcRect, deg16(a0), deg16(a1 - a0));
+    }
+}
+
+// ======= 3) 中央单位与装饰 =======
+void DialRenderer::drawBYQUnitMPa(QPainter& p, const QPointF& C, double Rpx)
+{
+    // 直接使用合理的固定字体大小
+    double r4_0 = Rpx * (4.0 / 17.1);
+    double r2_0 = Rpx * (2.0 / 17.1);
+    double fontPixelHeight = (r4_0 - r2_0) * 2;
+
+
+    QFont font("DIN Rounded");
+    font.setPixelSize(std::round(fontPixelHeight)); // 按像素高度设置
+    font.setBold(true); // 若图纸要求粗体，可设置
+    p.setFont(font);
+    const QColor blackBand = QColor::fromCmyk(0, 0, 0, 100);
+    p.setPen(QPen(blackBand, 1));
+
+    const QString MPa = "MPa";
+    QRectF textRect = p.fontMetrics().boundingRect(MPa);
+
+    double r3_0 = (r4_0 + r2_0) / 1.1;
+    QPointF pos = QPointF(C.x() - textRect.width() / 2.0,
+                          C.y() - r3_0 - textRect.height() / 2.0);
+
+    p.drawText(pos, MPa);
+}
+
+
+// ======= YYQY表盘生成 =======
+
+DialRenderer::Scene DialRenderer::buildYYQYScene(const YYQYDialConfig& config)
+{
+    // YYQY表盘规格：1890x1890像素，960 DPI分辨率
+    const int S = 1890;  
+    const double OUT_DPI = 960;    // 图片DPI
+    
+    const QSize canvas(S, S);
+    
+    const QPointF C(S/2.0, S/2.0);  // 圆心
+    const double outerR = 16.3 * S / 42.0;  // 外径半径（缩小表盘，留出边距）
+    
+    // 使用配置中的角度值
+    const double maxPressure = config.maxPressure; // 最大压力
+    double totalAngle = config.totalAngle;
+    const QVector<double>& points = config.points;           // 保存的分段点
+    const QVector<double>& pointsAngle = config.pointsAngle; // 保存的分段角度
+    const double warningPressure = config.warningPressure;   // 彩色带黑红分界
+
+    qDebug() << "生成YYQY表盘，角度：" << totalAngle;
+    
+    // 商标录制前先读好、缩放好（原图和缩放结果都有缓存），步骤里只贴图
+    QPointF logoPos;
+    const QImage logo = loadYYQYLogo(C, outerR, logoPos);
+    
+    // 绘制各个组件 - 调整绘制顺序，确保数字不被遮挡。
+    // 每层的键是输入参数；YYQY 按默认 DPI 绘制（paintDpm = 0），画完再写 960 DPI（避免影响字体渲染）
+    const double geo[] = {double(S), C.x(), C.y(), outerR};
+    Scene scene;
+    scene.canvas = canvas;
+    scene.paintDpm = 0;
+    scene.outDpm = dpi_to_dpm(OUT_DPI);
+    if (!logo.isNull()) {
+        // 商标图按 cacheKey 区分；64 位键拆成两个 32 位存，转成 double 不丢位
+        const quint64 logoKey = quint64(logo.cacheKey());
+        const double logoHi = double(quint32(logoKey >> 32)), logoLo = double(quint32(logoKey));
+        scene.layers << SceneLayer{"yyqy.logo", dialLayerKey(geo, {logoPos.x(), logoPos.y(), logoHi, logoLo}),
+            {[=](QPainter& p) { drawYYQYLogo(p, logoPos, logo); }}};                                                // 绘制商标
+    }
+    scene.layers << SceneLayer{"yyqy.ticks", dialLayerKey(geo, {totalAngle, maxPressure}, points, pointsAngle),
+        {[=](QPainter& p) { drawYYQYTicks(p, C, outerR, totalAngle, maxPressure, points, pointsAngle); }}};         // 先绘制刻度线
+    scene.layers << SceneLayer{"yyqy.bands",
+        dialLayerKey(geo, {totalAngle, maxPressure, warningPressure}, points, pointsAngle),
+        {[=](QPainter& p) { drawYYQYColorBands(p, C, outerR, totalAngle, maxPressure, warningPressure, points, pointsAngle); }}};    // 然后绘制彩色带
+    scene.layers << SceneLayer{"yyqy.numbers", dialLayerKey(geo, {totalAngle, maxPressure}, points, pointsAngle),
+        {[=](QPainter& p) { drawYYQYNumbers(p, C, outerR, totalAngle, maxPressure, points, pointsAngle); }}};       // 再绘制数字（确保在最上层）
+    scene.layers << SceneLayer{"yyqy.center", dialLayerKey(geo, {}),
+        {[=](QPainter& p) { drawYYQYCenterTexts(p, C, outerR); }}};                                                // 绘制中心文字
+    scene.layers << SceneLayer{"yyqy.dot", dialLayerKey(geo, {totalAngle}),
+        {[=](QPainter& p) { drawYYQYPositionDot(p, C, outerR, totalAngle); }}};                                    // 最后绘制定位点
+    return scene;
+}
+
+//实在不行就yyqy2ang
+static inline double yyqyV2Ang(double v, double vmax, double startDeg, double totalAngle, QVector<double> points, QVector<double> pointsAngle)
+{
+    // 复制并保证包含端点 0 和 vmax
+    QVector<double> allP = points;
+    QVector<double> allA = pointsAngle;
+
+    if (allP.isEmpty() || allP.first() != 0.0) {
+        allP.prepend(0.0);
+        allA.prepend(0.0);
+    }
+    if (allP.isEmpty() || allP.last() != vmax) {
+        allP.append(vmax);
+        allA.append(totalAngle);
+    }
+
+    // 基本合法性检查：长度、单调性
+    if (allP.size() != allA.size()) {
+        // 退化为线性映射
+        double frac = (vmax > 0.0) ? std::clamp(v / vmax, 0.0, 1.0) : 0.0;
+        return startDeg - frac * totalAngle;
+    }
+    for (int i = 1; i < allP.size(); ++i) {
+        if (allP[i] <= allP[i-1] || allA[i] < allA[i-1]) {
+            double frac = (vmax > 0.0) ? std::clamp(v / vmax, 0.0, 1.0) : 0.0;
+            return startDeg - frac * totalAngle;
+        }
+    }
+
+    // clamp v
+    v = std::clamp(v, 0.0, vmax);
+
+    // 处理边界值，保证 0 与 vmax 精确映射
+    if (v <= 0.0) return startDeg;
+    if (v >= vmax) return startDeg - totalAngle;
+
+    // 找到包含 v 的段并做线性插值
+    int idx = 0;
+    for (int i = 0; i < allP.size() - 1; ++i) {
+        if (v >= allP[i] && v <= allP[i+1]) {
+            idx = i;
+            break;
+        }
+    }
+
+    double p0 = allP[idx], p1 = allP[idx+1];
+    double a0 = allA[idx], a1 = allA[idx+1];
+
+    double t = (p1 == p0) ? 0.0 : (v - p0) / (p1 - p0);
+    double angSeg = a0 + t * (a1 - a0);
+
+    return startDeg - angSeg;
+}
+
+
+//绘制刻度线
+void DialRenderer::drawYYQYTicks(QPainter& p, const QPointF& C, double outerR, double totalAngle,double maxPressure,
+    QVector<double> points,QVector<double> pointsAngle)
+{
+    const double k = outerR / 16.3;  // 缩放系数
+    
+    const double r_band_outer = 16.3 * k;   // 外圆半径（与彩色带外沿对齐）
+    const double r_band_inner = 15.5 * k;   // 彩色带内沿
+    const double r_major_outer = r_band_inner;  // 大刻度外径 = 彩色带内沿
+    const double r_major_inner = 12.5 * k;  // 大刻度内径
+    const double r_minor_outer = r_band_inner;  // 小刻度外径 = 彩色带内沿
+    const double r_minor_inner = 13.8 * k;  // 小刻度内径
+    const double r_number = 10.0 * k;       // 数字半径，调整到更靠内避免被刻度线遮挡
+    
+    // 角度设置 - 表盘是左右对称的
+    const double startAngle = 90.0 + totalAngle / 2.0;  // 起始角度（从左上开始）
+    
+    // 计算刻度数量 - 根据配置的最大压力
+      // 使用配置的最大压力
+    const int totalPositions = (int)(maxPressure * 10) + 1;  // 总刻度位置（每0.1MPa一个位置）
+    const double anglePerPosition = totalAngle / (totalPositions - 1);  // 每个位置的角度-----要改成变化的
+    
+    // 大刻度位置：整数MPa对应的位置索引
+    QSet<int> majorPositions;
+    for (int i = 0; i <= (int)maxPressure; ++i) {
+        majorPositions.insert(i * 10);  // 每整数MPa对应位置索引
+    }
+    const QColor black = QColor::fromCmyk(0, 0, 0, 100);
+    QPen minorPen(black, 0.3 * k, Qt::SolidLine, Qt::RoundCap);  // 小刻度：圆角端点
+    QPen majorPen(black, 0.8 * k, Qt::SolidLine, Qt::RoundCap);  // 大刻度：圆角端点
+    
+    // 绘制小刻度线 - 在非大刻度位置
+    p.setPen(minorPen);
+    for (int i = 0; i < totalPositions; ++i) {
+        if (!majorPositions.contains(i)) {  // 不是大刻度位置才画小刻度
+            double angle = yyqyV2Ang(i * 0.1, maxPressure, startAngle, totalAngle, points, pointsAngle);  // 从左上逆时针
+            double rad = qDegreesToRadians(angle);
+            QPointF outer(C.x() + r_minor_outer * qCos(rad), 
+                         C.y() - r_minor_outer * qSin(rad));
+            QPointF inner(C.x() + r_minor_inner * qCos(rad), 
+                         C.y() - r_minor_inner * qSin(rad));
+            p.drawLine(outer, inner);
+        }
+    }
+    
+    // 绘制大刻度线（对应整数MPa）
+    p.setPen(majorPen);
+    for (int pos : majorPositions) {
+        double angle = yyqyV2Ang(static_cast<double>(pos) * 0.1, maxPressure, startAngle, totalAngle, points, pointsAngle);
+        double rad = qDegreesToRadians(angle);
+        QPointF outer(C.x() + r_major_outer * qCos(rad), 
+                     C.y() - r_major_outer * qSin(rad));
+        QPointF inner(C.x() + r_major_inner * qCos(rad), 
+                     C.y() - r_major_inner * qSin(rad));
+        p.drawLine(outer, inner);
+    }
+}
+
+void DialRenderer::drawYYQYNumbers(QPainter& p, const QPointF& C, double outerR, double totalAngle, double maxPressure,
+    QVector<double> points, QVector<double> pointsAngle)
+{
+    const double k = outerR / 16.3;         // 缩放系数
+    const double r_number = 10.2 * k;       // 数字半径，调整到更靠内避免被刻度线遮挡
+    
+    // 角度设置 - 表盘是左右对称的
+    const double startAngle = 90.0 + totalAngle / 2.0;  // 起始角度（从左上开始）
+    
+    // 计算刻度数量 - 根据配置的最大压力
+    
+    const int totalPositions = (int)(maxPressure * 10) + 1;  // 总刻度位置（每0.1MPa一个位置）
+    
+    
+    // 绘制数字（3号黑体）
+    const QColor black = QColor::fromCmyk(0, 0, 0, 100);
+    int fontSize = (int)(108 * k);  // 大幅增加字体大小
+    fontSize = qMax(fontSize, 72);  // 最小72px
+    fontSize = qMin(fontSize, 168);  // 最大168px
+    QFont numberFont("SimHei", fontSize, QFont::Normal);  // 数字不加粗
+    p.setFont(numberFont);
+    p.setPen(black);
+    
+    // 绘制数字在对应的大刻度位置
+    for (int i = 0; i <= (int)maxPressure; ++i) {
+        int pos = i * 10;  // 每整数MPa对应的位置索引
+        double angle = yyqyV2Ang(static_cast<double>(pos) * 0.1, maxPressure, startAngle, totalAngle, points, pointsAngle);
+        double rad = qDegreesToRadians(angle);
+        
+        QPointF numberPos(C.x() + r_number * qCos(rad), 
+                         C.y() - r_number * qSin(rad));
+        
+        QString text = QString::number(i);
+        
+        // 对于数字0，稍微向上偏移避开定位点
+        if (i == 0) {
+            numberPos.ry() -= k * 0.8;  // 向上偏移
+            numberPos.rx() -= k * 1.0;  // 向左偏移一点点
+        } else if (i == 1) {
+            numberPos.rx() -= k * 0.8;  // 向左偏移一点点
+        }
+        
+        // 计算文本矩形大小
+        QFontMetrics fm(numberFont);
+        QRect textRect = fm.boundingRect(text);
+        QRectF drawRect(numberPos.x() - textRect.width()/2.0, 
+                       numberPos.y() - textRect.height()/2.0, 
+                       textRect.width(), textRect.height());
+        
+        p.drawText(drawRect, Qt::AlignCenter, text);
+    }
+}
+
+void DialRenderer::drawYYQYColorBands(QPainter& p, const QPointF& C, double outerR, double totalAngle, double maxPressure,
+                                      double warningPressure, QVector<double> points, QVector<double> pointsAngle)
+{
+    const double k = outerR / 16.3;
+    const double r_band_outer = 16.3 * k;   // 彩色带外沿
+    const double r_band_inner = 15.5 * k;   // 彩色带内沿（与刻度外沿对齐）
+    const double bandWidth = r_band_outer - r_band_inner;
+    const double r_mid = (r_band_outer + r_band_inner) / 2.0;
+    
+    QRectF arcRect(C.x() - r_mid, C.y() - r_mid, 2 * r_mid, 2 * r_mid);
+    
+    // 角度设置 - 与刻度保持一致
+    const double startAngle = 90.0 + totalAngle / 2.0;  // 起始角度
+
+
+    // 计算不同刻度线宽对应的角度补偿
+    const double w_major = 0.8 * k;  // 大刻度线宽
+    const double w_minor = 0.3 * k;  // 小刻度线宽
+    const double deltaDeg_major = qRadiansToDegrees(std::atan((w_major * 0.5) / r_mid));
+    const double deltaDeg_minor = qRadiansToDegrees(std::atan((w_minor * 0.5) / r_mid));
+    
+    QPen pen;
+    pen.setWidthF(bandWidth);
+    pen.setCapStyle(Qt::FlatCap);
+    
+    // 0-warningPressure：黑色
+    double black_start_angle = startAngle;
+    double black_end_angle = yyqyV2Ang(warningPressure, maxPressure, startAngle, totalAngle, points, pointsAngle);
+    
+    // 起始端（0MPa）角度补偿：0位置是大刻度，使用大刻度线宽
+    black_start_angle += deltaDeg_major;
+    
+    // 颜色定义 (CMYK色值)
+    const QColor blackBand = QColor::fromCmyk(0, 0, 0, 100);       // 纯黑色
+    const QColor redBand = QColor::fromCmyk(0, 100, 100, 0);       // 红色带
+    
+    pen.setColor(blackBand);
+    p.setPen(pen);
+    p.setBrush(Qt::NoBrush);
+    p.drawArc(arcRect, deg16(black_start_angle), deg16(black_end_angle - black_start_angle));
+    
+    // warningPressure-maxPressure：红色
+    double red_start_angle = black_end_angle;  // 从警告压力开始（无补偿，避免断开）
+    double red_end_angle = yyqyV2Ang(maxPressure, maxPressure, startAngle, totalAngle, points, pointsAngle);
+    
+    // 结束端角度补偿：检查末尾位置是大刻度还是小刻度
+    // 末尾位置的压力值
+    double endPressureValue = maxPressure;
+    bool isEndMajorTick = (std::abs(endPressureValue - std::round(endPressureValue)) < 1e-6);
+    
+    if (isEndMajorTick) {
+        // 如果末尾是大刻度，使用大刻度线宽
+        red_end_angle -= deltaDeg_major;
+    } else {
+        // 如果末尾是小刻度，使用小刻度线宽
+        red_end_angle -= deltaDeg_minor;
+    }
+    
+    pen.setColor(redBand);
+    p.setPen(pen);
+    p.drawArc(arcRect, deg16(red_start_angle), deg16(red_end_angle - red_start_angle));
+}
+
+void DialRenderer::drawYYQYCenterTexts(QPainter& p, const QPointF& C, double outerR)
+{
+    const double k = outerR / 16.3;
+    const QColor blue =  QColor::fromCmyk(100, 0, 0, 0);
+    
+    // "MPa"文字在圆心正上方R3位置（2号黑体）- 修复字体大小
+    int mpaFontSize = (int)(108 * k);  // 2号字体大幅增加，从18*k改为36*k
+    mpaFontSize = qMax(mpaFontSize, 88);  // 最小28px
+    mpaFontSize = qMin(mpaFontSize, 88);  // 最大56px
+    QFont mpaFont("黑体", mpaFontSize);  // MPa文字加粗
+    //mpaFont.setStretch(QFont::Condensed);  // 设置为窄体（高高细细）
+    p.setFont(mpaFont);
+    const QColor blackBand = QColor::fromCmyk(0, 0, 0, 100);
+    p.setPen(blackBand);
+    
+    QPointF mpaPos(C.x(), C.y() - 3 * k);
+    QFontMetrics mpafm(mpaFont);
+    QRect mpaRect = mpafm.boundingRect("MPa");
+    QRectF mpaDrawRect(mpaPos.x() - mpaRect.width()/2.0, 
+                      mpaPos.y() - mpaRect.height()/2.0, 
+                      mpaRect.width(), mpaRect.height());
+    p.drawText(mpaDrawRect, Qt::AlignCenter, "MPa");
+    
+    // "禁油"和"氧气"文字（3号黑体）- 修复字体大小
+    int textFontSize = (int)(88 * k);  // 3号字体大幅增加，从20*k改为40*k
+    textFontSize = qMax(textFontSize, 88);  // 最小32px
+    textFontSize = qMin(textFontSize, 88);  // 最大64px
+    QFont textFont("黑体", textFontSize, QFont::Normal);
+    //textFont.setStretch(QFont::Condensed);  // 设置为窄体（高高细细）
+    p.setFont(textFont);
+
+    double text_r = 5 * k;  // R4位置
+    double text_y_offset = 0.7 * k;  // 相对圆心往下偏移
+    
+    // "禁油"文字在圆心左边
+    QPointF jinYouPos(C.x() - text_r, C.y() + text_y_offset);  // 添加向下偏移
+    QFontMetrics textfm(textFont);
+    QRect jinYouRect = textfm.boundingRect("禁油");
+    QRectF jinYouDrawRect(jinYouPos.x() - jinYouRect.width()/2.0, 
+                         jinYouPos.y() - jinYouRect.height()/2.0, 
+                         jinYouRect.width(), jinYouRect.height());
+    p.drawText(jinYouDrawRect, Qt::AlignCenter, "禁油");
+    
+    // "氧气"文字在圆心右边（有蓝色下划线）
+    QPointF yangQiPos(C.x() + text_r, C.y() + text_y_offset);  // 添加向下偏移
+    QRect yangQiRect = textfm.boundingRect("氧气");
+    QRectF yangQiDrawRect(yangQiPos.x() - yangQiRect.width()/2.0, 
+                         yangQiPos.y() - yangQiRect.height()/2.0, 
+                         yangQiRect.width(), yangQiRect.height());
+    p.setPen(blackBand);
+    p.drawText(yangQiDrawRect, Qt::AlignCenter, "氧气");
+    
+    // 绘制"氧气"的蓝色下划线（酞蓝色PB06，宽0.5，圆角）---改0.1
+    QPen underlinePen(blue, 0.45 * k, Qt::SolidLine);
+    p.setPen(underlinePen);
+    double underlineY = yangQiDrawRect.bottom() + k * 0.5;  //   - k * 0.1;  // 更靠近文字
+    // 下划线与文字一样宽，不留边距
+    p.drawLine(QPointF(yangQiDrawRect.left() + 0.3 * k, underlineY), 
+               QPointF(yangQiDrawRect.right() - 0.3 * k, underlineY));
+}
+
+void DialRenderer::drawYYQYPositionDot(QPainter& p, const QPointF& C, double outerR, double totalAngle)
+{
+    const double k = outerR / 16.3;
+    
+    // 定位点是两个条件的交点：
+    // 1. 角度：0刻度线减1度的位置
+    // 2. 距离：圆心垂直向下R10
+    const double startAngle = 90.0 + totalAngle / 2.0;  // 0刻度线的角度
+    double dotAngle = startAngle + 6.0;  // 0刻度减1度（向逆时针偏移）
+    const QColor blackBand = QColor::fromCmyk(0, 0, 0, 100);
+    
+    // 计算在该角度方向上，距离圆心R10的点
+    double r_dot = 11.4 * k;
+    double rad = qDegreesToRadians(dotAngle);
+    QPointF dotPos(C.x() + r_dot * qCos(rad), 
+                   C.y() - r_dot * qSin(rad));
+    
+    p.setPen(blackBand);
+    p.setBrush(blackBand);
+    double dotRadius = 0.3 * k;  // 缩小定位点
+    p.drawEllipse(dotPos, dotRadius, dotRadius);
+}
+
+QImage DialRenderer::loadYYQYLogo(const QPointF& C, double outerR, QPointF& logoPos)
+{
+    const double k = outerR / 16.3;  // 缩放系数
+    
+    // 加载商标图片：只在第一次读盘，之后用缓存的原图
+    if (!m_logoSourceLoaded) {
+        const QString logoPath = m_logoPath.isEmpty()
+            ? QCoreApplication::applicationDirPath() + "/images/logo_region.png" : m_logoPath;
+        QImage logoImage(logoPath);
+        if (logoImage.isNull()) {
+            qDebug() << "无法加载商标图片：" << logoPath;
+        } else {
+            // 直接读成 QImage（任何线程都能用），格式换成原来经 QPixmap 中转后的样子，缩放结果不变
+            m_logoSource = logoImage.convertToFormat(logoImage.hasAlphaChannel()
+                ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+        }
+        m_logoSourceLoaded = true;
+    }
+    if (m_logoSource.isNull()) {
+        return QImage();
+    }
+    
+    const QImage& logoImage = m_logoSource;
+    
+    // 商标上边界在圆心向下R19的位置
+    double logoTopY = C.y() + 10.0 * k;  // 圆心向下R19
+    
+    // 商标大小不受刻度盘角度影响，只依赖于表盘缩放
+    double logoScale = k * 0.01913824057;  // 固定比例，不受角度影响
+    // 计算缩放后的商标尺寸
+    int scaledWidth = (int)(logoImage.width() * logoScale);
+    int scaledHeight = (int)(logoImage.height() * logoScale);
+    
+    // 缩放商标图像（尺寸不变就用上次缩放好的）
+    if (m_scaledLogo.isNull() || m_scaledLogoRequest != QSize(scaledWidth, scaledHeight)) {
+        m_scaledLogo = logoImage.scaled(scaledWidth, scaledHeight, 
+                                        Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        m_scaledLogoRequest = QSize(scaledWidth, scaledHeight);
+        qDebug() << "商标已缩放，尺寸：" << scaledWidth << "x" << scaledHeight;
+    }
+    
+    // 计算商标的中心位置（水平居中，上边界在指定位置）
+    logoPos = QPointF(C.x() - scaledWidth / 2.0, logoTopY);
+    return m_scaledLogo;
+}
+
+void DialRenderer::drawYYQYLogo(QPainter& p, const QPointF& logoPos, const QImage& scaledLogo)
+{
+    // 绘制商标
+    const QColor blackBand = QColor::fromCmyk(0, 0, 0, 100);
+    p.setPen(blackBand);
+    p.drawImage(logoPos, scaledLogo);
+}
+
+// 按后缀写栅格图：tif/tiff 走 CMYK TIFF，其余用 Qt 写并带上 DPI
+bool DialRenderer::saveImage(QImage img, const QString& fileName, double dpi, QString& formatName) const
+{
+    const QString ext = QFileInfo(fileName).suffix().toLower();
+    if (ext == "tif" || ext == "tiff") {
+        // 使用 CMYK TIFF 保存
+        formatName = "CMYK TIFF";
+        return saveCmykTiff(img, fileName, dpi, m_parallel);
+    }
+    
+    // 其他格式使用 Qt 保存
+    QByteArray fmt("png");
+    if (ext == "png") fmt = "png";
+    else if (ext == "jpg" || ext == "jpeg") fmt = "jpeg";
+    else if (ext == "bmp") fmt = "bmp";
+    
+    // 设置 DPI
+    int dpm = dpi_to_dpm(dpi);
+    img.setDotsPerMeterX(dpm);
+    img.setDotsPerMeterY(dpm);
+    
+    formatName = QString::fromLatin1(fmt.toUpper());
+    QImageWriter writer(fileName, fmt);
+    return writer.write(img);
+}
+
+// ======= RGB 到 CMYK 转换 =======
+void DialRenderer::rgbToCmyk(int r, int g, int b, int& c, int& m, int& y, int& k)
+{
+    // 归一化 RGB 到 0-1
+    double rf = r / 255.0;
+    double gf = g / 255.0;
+    double bf = b / 255.0;
+    
+    // 计算 K (黑色)
+    double kf = 1.0 - std::max({rf, gf, bf});
+    
+    // 避免除以零
+    if (kf >= 1.0) {
+        c = m = y = 0;
+        k = 255;
+        return;
+    }
+    
+    // 计算 CMY
+    double cf = (1.0 - rf - kf) / (1.0 - kf);
+    double mf = (1.0 - gf - kf) / (1.0 - kf);
+    double yf = (1.0 - bf - kf) / (1.0 - kf);
+    
+    // 转换到 0-255 范围
+    c = static_cast<int>(std::round(cf * 255.0));
+    m = static_cast<int>(std::round(mf * 255.0));
+    y = static_cast<int>(std::round(yf * 255.0));
+    k = static_cast<int>(std::round(kf * 255.0));
+    
+    // 限制范围
+    c = std::clamp(c, 0, 255);
+    m = std::clamp(m, 0, 255);
+    y = std::clamp(y, 0, 255);
+    k = std::clamp(k, 0, 255);
+}
+
+// ======= 一段行转 CMYK（查表，结果与逐像素调用 rgbToCmyk 相同） =======
+void DialRenderer::rgbRowsToCmyk(const QImage& img, int y0, int y1, uint8_t* dst)
+{
+    // C/M/Y 各自只取决于（该通道值, 三通道最大值），K 只取决于最大值：
+    // 用 rgbToCmyk 本身把所有组合算一遍存成表，取整和限幅都原样保留
+    struct CmykTables {
+        uint8_t cmy[256][256];   // [最大值][通道值]
+        uint8_t k[256];          // [最大值]
+    };
+    static const CmykTables tables = [] {
+        CmykTables t{};
+        for (int mx = 0; mx < 256; ++mx) {
+            for (int v = 0; v <= mx; ++v) {   // 通道值不会超过最大值
+                int c, m, y, k;
+                rgbToCmyk(v, mx, 0, c, m, y, k);
+                t.cmy[mx][v] = static_cast<uint8_t>(c);
+                t.k[mx] = static_cast<uint8_t>(k);
+            }
+        }
+        return t;
+    }();
+    
+    const int width = img.width();
+    uint8_t* out = dst;
+    auto put = [&](QRgb pixel) {
+        const int r = qRed(pixel), g = qGreen(pixel), b = qBlue(pixel);
+        const int mx = std::max({r, g, b});
+        const uint8_t* row = tables.cmy[mx];
+        out[0] = row[r];
+        out[1] = row[g];
+        out[2] = row[b];
+        out[3] = tables.k[mx];
+        out += 4;
+    };
+    
+    switch (img.format()) {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        for (int y = y0; y < y1; ++y) {
+            const QRgb* src = reinterpret_cast<const QRgb*>(img.constScanLine(y));
+            for (int x = 0; x < width; ++x) put(src[x]);
+        }
+        break;
+    default: {
+        // 其他格式（成图是 RGBA64）只把这一段行转成 RGB32：直接包住原图这几行、不复制（带调色板的格式才复制），
+        // 取整和半透明的处理都由 convertToFormat 决定，与整张图先转 RGB32 再逐像素 rgbToCmyk 逐字节一致
+        const QImage rows = img.colorCount() > 0
+            ? img.copy(0, y0, width, y1 - y0)
+            : QImage(img.constScanLine(y0), width, y1 - y0, img.bytesPerLine(), img.format());
+        const QImage block = rows.convertToFormat(QImage::Format_RGB32);
+        for (int y = 0; y < block.height(); ++y) {
+            const QRgb* src = reinterpret_cast<const QRgb*>(block.constScanLine(y));
+            for (int x = 0; x < width; ++x) put(src[x]);
+        }
+        break;
+    }
+    }
+}
+
+// ======= CMYK TIFF 保存 =======
+bool DialRenderer::saveCmykTiff(const QImage& img, const QString& fileName, double dpi, bool parallel)
+{
+#ifdef HAS_LIBTIFF
+    // 确保图像有效
+    if (img.isNull()) {
+        qDebug() << "saveCmykTiff: 图像为空";
+        return false;
+    }
+    
+    int width = img.width();
+    int height = img.height();
+    
+    // 打开 TIFF 文件
+    TIFF* tif = TIFFOpen(fileName.toUtf8().constData(), "w");
+    if (!tif) {
+        qDebug() << "saveCmykTiff: 无法打开文件" << fileName;
+        return false;
+    }
+    
+    // 设置 TIFF 标签
+    TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, width);
+    TIFFSetField(tif, TIFFTAG_IMAGELENGTH, height);
+    TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, 4);      // CMYK = 4 通道
+    TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 8);        // 每通道 8 位
+    TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
+    TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_SEPARATED);  // CMYK
+    TIFFSetField(tif, TIFFTAG_INKSET, INKSET_CMYK);
+    TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);   // 交织存储
+    TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_LZW);        // LZW 压缩
+    // 条带大约 4MB：转换只用一个条带大小的缓冲，条带内的行再分给各线程
+    const qsizetype rowBytes = qsizetype(width) * 4;
+    const uint32_t rowsPerStrip = uint32_t(std::clamp<qsizetype>((4 << 20) / rowBytes, 1, height));
+    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, rowsPerStrip);
+    
+    // 设置 DPI
+    TIFFSetField(tif, TIFFTAG_RESOLUTIONUNIT, RESUNIT_INCH);
+    TIFFSetField(tif, TIFFTAG_XRESOLUTION, dpi);
+    TIFFSetField(tif, TIFFTAG_YRESOLUTION, dpi);
+    
+    // 逐条带：查表转成 CMYK 放进条带缓冲（并行时按行块分给线程池），再整块交给 libtiff 压缩写出
+    std::vector<uint8_t> strip(size_t(rowBytes) * rowsPerStrip);
+    const int threads = parallel ? QThread::idealThreadCount() : 1;
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    const tstrip_t strips = TIFFNumberOfStrips(tif);
+    for (tstrip_t s = 0; s < strips; ++s) {
+        const int y0 = int(s * rowsPerStrip);
+        const int rows = std::min<int>(rowsPerStrip, height - y0);
+        const int rowsPerTask = std::max(16, (rows + threads - 1) / threads);
+        if (threads > 1 && rows > rowsPerTask) {
+            for (int r0 = 0; r0 < rows; r0 += rowsPerTask) {
+                const int r1 = std::min(rows, r0 + rowsPerTask);
+                pool.start([&img, &strip, rowBytes, y0, r0, r1]() {
+                    rgbRowsToCmyk(img, y0 + r0, y0 + r1, strip.data() + r0 * rowBytes);
+                });
+            }
+            pool.waitForDone();
+        } else {
+            rgbRowsToCmyk(img, y0, y0 + rows, strip.data());
+        }
+        if (TIFFWriteEncodedStrip(tif, s, strip.data(), rows * rowBytes) < 0) {
+            qDebug() << "saveCmykTiff: 写入条带" << s << "失败";
+            TIFFClose(tif);
+            return false;
+        }
+    }
+    
+    TIFFClose(tif);
+    qDebug() << "saveCmykTiff: 成功保存 CMYK TIFF:" << fileName;
+    return true;
+    
+#else
+    // 没有 libtiff，回退到 Qt 的 RGB TIFF
+    qDebug() << "saveCmykTiff: libtiff 未启用，回退到 RGB TIFF";
+    QImageWriter writer(fileName, "tiff");
+    writer.setCompression(1);
+    return writer.write(img);
+#endif
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include <QHash>
+#include <QImage>
+#include <QPointF>
+#include <QSize>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+
+#include "tiledrender.h"
+
+class QPainter;
+
+// BYQ表盘配置
+struct BYQDialConfig {
+    double maxPressure;      // 最大压力值 (MPa)
+    double totalAngle;       // 表盘总角度 (度)
+    double majorStep;        // 主刻度步长 (MPa)
+    double minorStep;        // 次刻度步长 (MPa)
+    QVector<double> points;  // 中间节点的值
+    QVector<double> pointsAngle;  // 中间节点的角度值
+
+    BYQDialConfig() : maxPressure(25.0), totalAngle(95.0), majorStep(5.0), minorStep(1.0), points({0.0, 5.0, 10.0, 15.0, 20.0, 25.0}), pointsAngle({0.0, 15.0, 35.0, 56.0, 78.0, 95.0}) {}
+};
+
+// YYQY表盘配置
+struct YYQYDialConfig {
+    double maxPressure;      // 最大压力值 (MPa)
+    double totalAngle;       // 表盘总角度 (度)
+    double warningPressure;  // 警告压力值 (MPa) - 黑色到红色的分界点
+    QVector<double> points;  // 中间节点的角度值
+    QVector<double> pointsAngle;  // 中间节点的角度值
+
+    YYQYDialConfig() : maxPressure(6.3), totalAngle(270.0), warningPressure(4.0) ,points({0.0, 1.0, 2.0, 3.0, 4.0, 5.0}), pointsAngle({0.0, 45.0, 90.0, 135.0, 185.0, 232.5}) {}
+};
+
+// ================== 表盘成图渲染（不依赖界面） ==================
+// 按配置录制表盘场景（每层一张显示列表 + 输入参数），再栅格化成印刷分辨率的整图、写 CMYK TIFF / PNG，
+// 或整体重放成 PDF / SVG。标注对话框和批量出图工具共用这一份绘制代码。
+// 录制出的场景自带全部参数和贴图，不引用渲染器本身，可以交给别的线程渲染；
+// 一个渲染器对象（层缓存、商标缓存）同一时间只能在一个线程里用，批量出图时每个工作线程各开一个。
+class DialRenderer
+{
+public:
+    // 层的输入参数（几何 + 本层用到的配置值 + 分段点）：缓存命中时整组逐值比较，哈希只用来快速排除
+    struct LayerKey {
+        QVector<double> inputs;
+        size_t hash = 0;
+        bool operator==(const LayerKey& o) const { return hash == o.hash && inputs == o.inputs; }
+        bool operator!=(const LayerKey& o) const { return !(*this == o); }
+    };
+    struct SceneLayer {
+        QString name;
+        LayerKey key;
+        DisplayList steps;
+    };
+    struct Scene {
+        QSize canvas;
+        int paintDpm = 0;    // 绘制时的 dots-per-meter（0 = QImage 默认），字体磅值按它换算
+        int outDpm = 0;      // 成图写入的 dots-per-meter（决定物理尺寸）
+        QVector<SceneLayer> layers;
+    };
+
+    // dialType 为 "YYQY-13" 时画 YYQY 表盘，其余画 BYQ 表盘
+    Scene buildScene(const QString& dialType, const BYQDialConfig& byq, const YYQYDialConfig& yyqy);
+    Scene buildBYQScene(const BYQDialConfig& config);
+    Scene buildYYQYScene(const YYQYDialConfig& config);
+
+    // 成图分辨率：各层按键缓存，只重画键变了的层，再按原顺序叠加
+    QImage render(const Scene& scene);
+    // 预览：整张场景缩小到 bound 以内重放成 8 位小图，不走缓存
+    static QImage renderPreview(const Scene& scene, const QSize& bound);
+    // 矢量输出：按后缀写 PDF 或 SVG
+    static bool exportVector(const Scene& scene, const QString& fileName, const QString& title, QString& error);
+    // 栅格输出：按后缀写，tif/tiff 为 CMYK TIFF，其余用 Qt 写并带上 DPI；formatName 给提示用
+    bool saveImage(QImage img, const QString& fileName, double dpi, QString& formatName) const;
+
+    // 各型号成图 DPI：YYQY-13 为 960，其余 2400
+    static double outputDpi(const QString& dialType);
+
+    // 单张图内部是否再分块并行（横条光栅化、CMYK 转换）；外层已经按表并行时关掉，免得线程数翻倍
+    void setParallel(bool parallel) { m_parallel = parallel; }
+    // 商标图片路径，默认是程序目录下的 images/logo_region.png
+    void setLogoPath(const QString& path);
+
+    // CMYK TIFF 保存（需要 libtiff，否则退回 RGB TIFF）
+    static bool saveCmykTiff(const QImage& img, const QString& fileName, double dpi, bool parallel = true);
+    // RGB 到 CMYK 转换
+    static void rgbToCmyk(int r, int g, int b, int& c, int& m, int& y, int& k);
+    // [y0, y1) 行转成交织的 CMYK 字节（每像素 4 字节），可在多个线程里对不同行并行调用
+    static void rgbRowsToCmyk(const QImage& img, int y0, int y1, uint8_t* dst);
+
+private:
+    // BYQ表盘绘制方法
+    static void drawBYQTicksAndNumbers(QPainter& p, const QPointF& C, double outerR,
+                                       double startDeg,double totalAngle, double spanDeg, double vmax, double majorStep,
+                                       QVector<double> points,QVector<double> pointsAngle);
+    static void drawBYQColorBands(QPainter& p, const QPointF& C, double outerR,
+                                  double startDeg, double totalAngle, double spanDeg, double vmax,
+                                  QVector<double> points,QVector<double> pointsAngle);
+    static void drawBYQUnitMPa(QPainter& p, const QPointF& C, double outerR);
+
+    // YYQY表盘绘制方法
+    static void drawYYQYTicks(QPainter& p, const QPointF& C, double outerR, double totalAngle,double maxPressure,
+                              QVector<double> points,QVector<double> pointsAngle);
+    static void drawYYQYNumbers(QPainter& p, const QPointF& C, double outerR, double totalAngle, double maxPressure,
+                                QVector<double> points, QVector<double> pointsAngle);
+    static void drawYYQYColorBands(QPainter& p, const QPointF& C, double outerR, double totalAngle,double maxPressure,
+                                   double warningPressure, QVector<double> points,QVector<double> pointsAngle);
+    static void drawYYQYCenterTexts(QPainter& p, const QPointF& C, double outerR);
+    static void drawYYQYPositionDot(QPainter& p, const QPointF& C, double outerR, double totalAngle);
+    QImage loadYYQYLogo(const QPointF& C, double outerR, QPointF& logoPos);  // 读入并缩放商标
+    static void drawYYQYLogo(QPainter& p, const QPointF& logoPos, const QImage& scaledLogo);  // 绘制商标
+
+    // 表盘分层缓存：每层（商标、刻度、彩色带、数字、中心文字……）连同输入参数一起缓存渲染结果，
+    // 配置变化时只重画输入变了的层，再按原顺序叠加
+    struct Layer {
+        LayerKey key;
+        QSize canvas;
+        int paintDpm = 0;
+        bool valid = false;
+        QRect rect;        // 在整图中的位置（有内容的最小外接矩形）
+        QImage image;      // 预乘透明底，只有 rect 那么大
+    };
+    Layer cachedLayer(const QString& name, const LayerKey& key, const QSize& canvas, int paintDpm, const DisplayList& steps);
+    QImage composeLayers(const QSize& canvas, int paintDpm, int outDpm, const QVector<Layer>& layers);
+    void renderSteps(QImage& img, const DisplayList& steps) const;
+
+    QHash<QString, Layer> m_layers;
+    QImage m_composed;                 // 上次合成的整图
+    QVector<LayerKey> m_composedKeys;  // 合成它的各层输入，末尾一项是画布尺寸和 DPM
+    QString m_logoPath;
+    QImage m_logoSource;               // 商标原图（只读一次磁盘）
+    bool m_logoSourceLoaded = false;
+    QImage m_scaledLogo;               // 缩放后的商标
+    QSize m_scaledLogoRequest;
+    bool m_parallel = true;
+};
@@ -0,0 +1,130 @@
+#include "dialvectorexport.h"
+
+#include <QBuffer>
+#include <QFileInfo>
+#include <QPageLayout>
+#include <QPageSize>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSvgGenerator>
+
+namespace {
+
+// 逻辑 DPI（字体磅值换算用）换成栅格绘制时的值，页面尺寸和坐标仍按成图 DPI
+class DialPdfWriter : public QPdfWriter
+{
+public:
+    DialPdfWriter(const QString& fileName, int fontDpi) : QPdfWriter(fileName), m_fontDpi(fontDpi) {}
+
+protected:
+    int metric(PaintDeviceMetric id) const override
+    {
+        if (id == PdmDpiX || id == PdmDpiY) return m_fontDpi;
+        return QPdfWriter::metric(id);
+    }
+
+private:
+    int m_fontDpi;
+};
+
+void replay(QPainter& p, const DisplayList& steps)
+{
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setRenderHint(QPainter::TextAntialiasing, true);
+    for (const auto& step : steps) step(p);
+}
+
+bool validOptions(const DialVectorOptions& options, QString& error)
+{
+    if (options.canvas.isEmpty() || options.paintDpi <= 0 || options.outDpi <= 0) {
+        error = "表盘尺寸或 DPI 无效";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool exportDisplayListPdf(const QString& fileName, const DisplayList& steps, const DialVectorOptions& options, QString& error)
+{
+    if (!validOptions(options, error)) return false;
+
+    DialPdfWriter writer(fileName, options.paintDpi);
+    writer.setTitle(options.title);
+    writer.setCreator("PressureGauge");
+    writer.setResolution(options.outDpi);
+    // 页面正好是成图的物理尺寸，无边距：设备坐标 (0,0)-(宽,高) 对应栅格图的每个像素
+    const QSizeF pageMm(options.canvas.width() * 25.4 / options.outDpi, options.canvas.height() * 25.4 / options.outDpi);
+    writer.setPageLayout(QPageLayout(QPageSize(pageMm, QPageSize::Millimeter, QString(), QPageSize::ExactMatch),
+                                     QPageLayout::Portrait, QMarginsF()));
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+    // 印刷用：CMYK 颜色原样写成 DeviceCMYK
+    writer.setColorModel(QPdfWriter::ColorModel::CMYK);
+#endif
+
+    QPainter p;
+    if (!p.begin(&writer)) {
+        error = QString("无法写入 %1").arg(fileName);
+        return false;
+    }
+    replay(p, steps);
+    p.end();
+
+    if (QFileInfo(fileName).size() <= 0) {
+        error = QString("写入 %1 失败").arg(fileName);
+        return false;
+    }
+    return true;
+}
+
+bool exportDisplayListSvg(const QString& fileName, const DisplayList& steps, const DialVectorOptions& options, QString& error)
+{
+    if (!validOptions(options, error)) return false;
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QSvgGenerator generator;
+    generator.setOutputDevice(&buffer);
+    generator.setTitle(options.title);
+    generator.setSize(options.canvas);
+    generator.setViewBox(QRect(QPoint(0, 0), options.canvas));
+    // SVG 引擎按这个分辨率把字体磅值换成像素，要和栅格绘制时一致
+    generator.setResolution(options.paintDpi);
+
+    QPainter p;
+    if (!p.begin(&generator)) {
+        error = "无法生成 SVG";
+        return false;
+    }
+    replay(p, steps);
+    p.end();
+
+    // 根元素的物理尺寸是按 setResolution 算的；两个 DPI 不同时（YYQY）改成按成图 DPI
+    QByteArray svg = buffer.data();
+    if (options.paintDpi != options.outDpi) {
+        static const QRegularExpression sizeAttrs(QStringLiteral("<svg width=\"[^\"]*\" height=\"[^\"]*\""));
+        const QString physical = QString("<svg width=\"%1mm\" height=\"%2mm\"")
+                                     .arg(options.canvas.width() * 25.4 / options.outDpi, 0, 'f', 3)
+                                     .arg(options.canvas.height() * 25.4 / options.outDpi, 0, 'f', 3);
+        QString text = QString::fromUtf8(svg);
+        const QRegularExpressionMatch match = sizeAttrs.match(text);
+        if (match.hasMatch()) {
+            text.replace(match.capturedStart(), match.capturedLength(), physical);
+            svg = text.toUtf8();
+        }
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = QString("无法写入 %1: %2").arg(fileName, file.errorString());
+        return false;
+    }
+    file.write(svg);
+    if (!file.commit()) {
+        error = QString("写入 %1 失败: %2").arg(fileName, file.errorString());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <QSize>
+#include <QString>
+
+#include "tiledrender.h"
+
+// ================== 表盘矢量导出（PDF / SVG） ==================
+// 把栅格化用的同一张显示列表重放到 QPdfWriter / QSvgGenerator：设备坐标就是栅格图的像素坐标，
+// 字体磅值按栅格绘制时的 DPI（paintDpi）换算，物理尺寸按成图 DPI（outDpi）算，所以和 TIFF 成图一一对应。
+// PDF 里 QColor::fromCmyk 的颜色按 DeviceCMYK 写出（Qt 6.8 起支持，更早的 Qt 会转成 RGB）；
+// SVG 本身没有 CMYK，写的是等效的 sRGB。商标这类贴图以位图嵌入。
+
+struct DialVectorOptions {
+    QSize canvas;          // 栅格图尺寸（像素），即矢量文件的坐标范围
+    int paintDpi = 96;     // 栅格绘制时的逻辑 DPI
+    int outDpi = 96;       // 成图 DPI
+    QString title;
+};
+
+bool exportDisplayListPdf(const QString& fileName, const DisplayList& steps, const DialVectorOptions& options, QString& error);
+bool exportDisplayListSvg(const QString& fileName, const DisplayList& steps, const DialVectorOptions& options, QString& error);
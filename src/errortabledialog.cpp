@@ -1,18 +1,21 @@
 #include "errortabledialog.h"
+#include "sessionhistorydialog.h"
+#include "gaugereport.h"
+#include "xlsxexportjob.h"
 #include <QSplitter>
 #include <QScrollArea>
 #include <QToolTip>
 #include <QInputDialog>
 #include <QTimer>
+#include <QMap>
+#include <QFileInfo>
 #include <cmath>
 #include <algorithm>
 
 // ======== NEW: 预检阈值计算辅助函数（仅本文件可见） ========
 // 按型号获取满量程压力（MPa）：YYQY=6.3，BYQ=25；其他回退到配置值
 static inline double modelFullScalePressure(const PressureGaugeConfig& cfg) {
-    if (cfg.productModel == "YYQY-13")return 6.3;
-    if (cfg.productModel == "BYQ-19") return 25.0;
-    return cfg.maxPressure;
+    return modelFullScalePressureMPa(cfg.productModel, cfg.maxPressure);
 }
 
 // 型号级"预检"迟滞限值（MPa）：YYQY-13=0.3，BYQ-19=2.0；其他回退到配置里的迟滞限值-----预检也要改
@@ -38,14 +41,6 @@ static inline double precheckHysteresisAngleDeg(const PressureGaugeConfig& cfg,
     return (modelPrecheckHysteresisLimitMPa(cfg) / fsPressure) * safeRoundMax;
 }
 
-// 读取一轮中"首个有效正/反行程角度"，没有数据则返回 false
-static inline bool firstValidAnglesOfRound(const MeasurementData& rd, double& fwd, double& bwd) {
-    bool hasF = false, hasB = false;
-    for (double a : rd.forwardAngles) { if (a != 0.0) { fwd = a; hasF = true; break; } }
-    for (double a : rd.backwardAngles){ if (a != 0.0) { bwd = a; hasB = true; break; } }
-    return hasF && hasB;
-}
-
 // 通用角度->压力换算：压力 = 角度 * (满量程压力 / 满量程角度)
 static inline double angleToPressureByFS(double angleErrDeg, double fsAngleDeg, double fsPressureMPa) {
     if (fsAngleDeg <= 0.0) return 0.0;
@@ -81,21 +76,14 @@ ErrorTableDialog::ErrorTableDialog(QWidget *parent)
         // 初始化配置数据
         m_config = PressureGaugeConfig();
         
-        // 初始化轮次数据
-        m_maxAngles.resize(m_totalRounds);  // 动态轮数
+        // 采集数据的单格变化合并到下一轮事件循环再刷新界面
+        m_sessionRefreshTimer.setSingleShot(true);
+        m_sessionRefreshTimer.setInterval(0);
+        connect(&m_sessionRefreshTimer, &QTimer::timeout, this, &ErrorTableDialog::flushSessionRefresh);
         
         qDebug() << "配置数据初始化完成";
         
-        // 先创建基本的检测点数据，再初始化轮次数据
-        for (double pressure : m_config.detectionPoints) {
-            DetectionPoint point;
-            point.pressure = pressure;
-            m_detectionData.append(point);
-        }
-        
-        qDebug() << "检测点数据创建完成，数量:" << m_detectionData.size();
-        
-        // 现在可以安全地初始化轮次数据
+        // 自己的会话按默认检测点分配（订阅主界面后改读主界面的会话）
         initializeRoundData();
         
         qDebug() << "轮次数据初始化完成";
@@ -104,6 +92,9 @@ ErrorTableDialog::ErrorTableDialog(QWidget *parent)
         setupUI();
         qDebug() << "setupUI完成";
         
+        // 界面建好后再接会话的变化信号（整体重置会刷新界面）
+        connectSession(&m_ownSession);
+        
                 // 延迟初始化数据
         QTimer::singleShot(100, this, [this]() {
             qDebug() << "开始延迟初始化";
@@ -357,24 +348,17 @@ void ErrorTableDialog::setupDataArea()
     statusLayout->addStretch();
     layout->addLayout(statusLayout);
     
-    // 数据表格
-    m_dataTable = new QTableWidget(0, 10);
-    QStringList headers;
-    headers << "检测点(MPa)" << "最终角度(°)" << "正行程角度(°)" << "正行程角度误差(°)" << "正行程误差(MPa)"
-            << "反行程角度(°)" << "反行程角度误差(°)" << "反行程误差(MPa)" << "迟滞误差角度(°)" << "迟滞误差(MPa)";
-    m_dataTable->setHorizontalHeaderLabels(headers);
+    // 数据表格：模型只对变化的单元格发 dataChanged，每次确认读数不再重建整张表
+    m_dataModel = new ErrorDataTableModel(this);
+    m_dataTable = new QTableView(this);
+    m_dataTable->setModel(m_dataModel);
     
     // 设置列宽 - 第一列加宽，其他列适当调整
-    m_dataTable->setColumnWidth(0, 120);  // 检测点列加宽
-    m_dataTable->setColumnWidth(1, 100);  // 最终角度
-    m_dataTable->setColumnWidth(2, 120);  // 正行程角度
-    m_dataTable->setColumnWidth(3, 120);  // 正行程角度误差
-    m_dataTable->setColumnWidth(4, 120);  // 正行程误差(MPa)
-    m_dataTable->setColumnWidth(5, 120);  // 反行程角度
-    m_dataTable->setColumnWidth(6, 120);  // 反行程角度误差
-    m_dataTable->setColumnWidth(7, 120);  // 反行程误差(MPa)
-    m_dataTable->setColumnWidth(8, 120);  // 迟滞误差角度
-    m_dataTable->setColumnWidth(9, 120);  // 迟滞误差(MPa)
+    m_dataTable->setColumnWidth(ErrorDataTableModel::ColPressure, 120);  // 检测点列加宽
+    m_dataTable->setColumnWidth(ErrorDataTableModel::ColFinalAngle, 100);  // 最终角度
+    for (int col = ErrorDataTableModel::ColForwardAngle; col < ErrorDataTableModel::ColumnCount; ++col) {
+        m_dataTable->setColumnWidth(col, 120);
+    }
     
     // 设置表格属性
     m_dataTable->setAlternatingRowColors(true);
@@ -389,8 +373,9 @@ void ErrorTableDialog::setupDataArea()
     
     layout->addWidget(m_dataTable);
     
-    connect(m_dataTable, &QTableWidget::cellClicked, this, &ErrorTableDialog::onTableCellClicked);
-    // cellChanged信号连接将在updateDataTable中处理，避免初始化时的问题
+    connect(m_dataTable, &QTableView::clicked, this, &ErrorTableDialog::onTableCellClicked);
+    // 只有用户在表格里编辑正/反行程角度才会触发，程序写入不会回调
+    connect(m_dataModel, &ErrorDataTableModel::angleEdited, this, &ErrorTableDialog::onDataTableCellChanged);
 }
 
 void ErrorTableDialog::setupAnalysisArea()
@@ -402,6 +387,7 @@ void ErrorTableDialog::setupAnalysisArea()
     
     m_analysisText = new QTextEdit();
     m_analysisText->setReadOnly(true);
+    m_analysisText->setUndoRedoEnabled(false);  // 报告按段增量替换，不需要撤销栈
     m_analysisText->setMaximumHeight(120);  // 限制高度
     // 使用系统默认字体，避免字体不存在的问题
     QFont font = m_analysisText->font();
@@ -448,6 +434,7 @@ void ErrorTableDialog::setupButtons()
     // m_calculateBtn = new QPushButton("计算");
     m_exportExcelBtn = new QPushButton("导出Excel");
     m_saveConfigBtn = new QPushButton("自动保存");
+    m_historyBtn = new QPushButton("历史记录");
     m_closeBtn = new QPushButton("关闭");
     
     // 设置按钮的最大宽度让界面更紧凑
@@ -456,6 +443,7 @@ void ErrorTableDialog::setupButtons()
     // m_calculateBtn->setMaximumWidth(60);
     m_exportExcelBtn->setMaximumWidth(80);
     m_saveConfigBtn->setMaximumWidth(80);
+    m_historyBtn->setMaximumWidth(80);
     m_closeBtn->setMaximumWidth(60);
     
     m_buttonLayout->addWidget(m_clearBtn);
@@ -465,6 +453,7 @@ void ErrorTableDialog::setupButtons()
     m_buttonLayout->addWidget(m_exportExcelBtn);
     m_buttonLayout->addStretch();
     m_buttonLayout->addWidget(m_saveConfigBtn);
+    m_buttonLayout->addWidget(m_historyBtn);
     m_buttonLayout->addStretch();
     m_buttonLayout->addWidget(m_closeBtn);
     
@@ -473,6 +462,7 @@ void ErrorTableDialog::setupButtons()
     // connect(m_calculateBtn, &QPushButton::clicked, this, &ErrorTableDialog::calculateErrors);
     connect(m_exportExcelBtn, &QPushButton::clicked, this, &ErrorTableDialog::exportToExcel);
     connect(m_saveConfigBtn, &QPushButton::clicked, this, &ErrorTableDialog::saveConfig);
+    connect(m_historyBtn, &QPushButton::clicked, this, &ErrorTableDialog::showSessionHistory);
     connect(m_closeBtn, &QPushButton::clicked, this, &QDialog::accept);
     
     // 连接输入框的实时更新信号
@@ -557,32 +547,10 @@ void ErrorTableDialog::updateDetectionPointsTable()
         // 强制重新连接信号（确保信号连接）
         connect(m_detectionPointsTable, &QTableWidget::cellChanged, this, &ErrorTableDialog::onDetectionPointsChanged);
         
-        // 只有在检测数据为空或数量不匹配时才重新创建
-        if (m_detectionData.size() != m_config.detectionPoints.size()) {
-            qDebug() << "检测数据数量不匹配，重新创建检测数据";
-            
-            // 保存已有的测量数据
-            QMap<double, DetectionPoint> oldData;
-            for (const auto& point : m_detectionData) {
-                oldData[point.pressure] = point;
-            }
-            
-            // 重新创建检测数据
-            m_detectionData.clear();
-            for (double pressure : m_config.detectionPoints) {
-                DetectionPoint point;
-                point.pressure = pressure;
-                
-                // 如果之前有这个检测点的数据，则保留
-                if (oldData.contains(pressure)) {
-                    point = oldData[pressure];
-                }
-                
-                m_detectionData.append(point);
-            }
-        }
+        // 检测点数变了：自己的会话跟着调整采集位数（订阅主界面时形状由主界面决定）
+        if (!m_session) resizeOwnSession();
         
-        qDebug() << "updateDetectionPointsTable 完成，检测数据数量:" << m_detectionData.size();
+        qDebug() << "updateDetectionPointsTable 完成，检测点数量:" << pointCount();
         
     } catch (const std::exception& e) {
         qDebug() << "updateDetectionPointsTable 异常:" << e.what();
@@ -593,166 +561,108 @@ void ErrorTableDialog::updateDetectionPointsTable()
 
 void ErrorTableDialog::updateDataTable()
 {
-    qDebug() << "updateDataTable 开始，当前轮次:" << (m_currentRound + 1);
-    
-    if (!m_dataTable) {
+    updateDataTableRows(nullptr);
+}
+
+void ErrorTableDialog::updateDataTableRows(const QSet<int> *rows)
+{
+    if (!m_dataModel) {
         qDebug() << "m_dataTable 还没有初始化";
         return;
     }
     
     try {
-        qDebug() << "设置数据表格行数:" << m_detectionData.size();
-        m_dataTable->setRowCount(m_detectionData.size());
-    
-        for (int i = 0; i < m_detectionData.size(); ++i) {
-          const DetectionPoint &point = m_detectionData[i];
-        
-        // 检测点压力
-        m_dataTable->setItem(i, 0, new QTableWidgetItem(QString::number(point.pressure, 'f', 1)));
-
-        // 检测点对应的刻度盘角度（最终角度）= 已完成"正+反"成对数据的实测平均（跨轮）
-        double finalAngle = calculateFinalMeasuredAngleForDetectionPoint(i);
-        m_dataTable->setItem(i, 1, new QTableWidgetItem(QString::number(finalAngle, 'f', 2)));
+        // 行数只在检测点配置变化时改变；其余情况逐格比较，只刷新变化的单元格
+        m_dataModel->setRowCount(pointCount());
         
-        // 获取当前轮次的数据
-        double currentForwardAngle = 0.0;
-        double currentBackwardAngle = 0.0;
-        bool hasForwardData = false;
-        bool hasBackwardData = false;
-        
-        if (m_currentRound < point.roundData.size()) {
-            const MeasurementData &currentRoundData = point.roundData[m_currentRound];
-            
-            // 获取正行程数据（取第一个非零值）
-            for (double angle : currentRoundData.forwardAngles) {
-                if (angle != 0.0) {
-                    currentForwardAngle = angle;
-                    hasForwardData = true;
-                    break;
-                }
-            }
-            
-            // 获取反行程数据（取第一个非零值）
-            for (double angle : currentRoundData.backwardAngles) {
-                if (angle != 0.0) {
-                    currentBackwardAngle = angle;
-                    hasBackwardData = true;
-                    break;
-                }
+        // 与检测点无关的量在循环外算一次（都是 O(1) 或按轮数，不随表格行数增长）
+        const MeasurementStore &data = store();
+        const bool allCompleted = isAllRoundsCompleted();
+        const double fsAngle = allCompleted ? calculateAverageMaxAngle() : 0.0;  // 最终阶段：用平均最大角度换算压力误差
+        const double fsPressure = modelFullScalePressure(m_config);
+        const int round = m_currentRound;
+        
+        // 阶段、换算用的满量程角度都没变时，某个检测点的数据变化只影响它自己那一行
+        // （最终角度只取该点的跨轮成对平均，误差只和该点的最终角度比）；这些量一变，所有行的误差都要重算
+        if (rows && (allCompleted != m_tableAllCompleted || fsAngle != m_tableFsAngle
+                     || m_config.maxAngle != m_tableConfigMaxAngle)) {
+            rows = nullptr;
+        }
+        m_tableAllCompleted = allCompleted;
+        m_tableFsAngle = fsAngle;
+        m_tableConfigMaxAngle = m_config.maxAngle;
+        
+        // 最终阶段才显示误差：比较基准取各点"最终角度"(实测对数平均)，没有时退化到理论角度，
+        // 误差核一次算出整表的角度/压力误差，下面各行只按 (检测点, 当前轮, 行程) 取值
+        std::vector<double> finalAngles(pointCount());
+        for (int i = 0; i < pointCount(); ++i) finalAngles[i] = calculateFinalMeasuredAngleForDetectionPoint(i);
+        if (allCompleted) {
+            // 误差核按会话的采集位数排布；多出来的采集位不会被读到
+            std::vector<double> expected(data.points(), 0.0);
+            for (int i = 0; i < pointCount() && i < data.points(); ++i) {
+                expected[i] = (finalAngles[i] > 0.0) ? finalAngles[i] : pressureToAngle(m_config.detectionPoints[i]);
             }
+            computeErrors(data, expected, fsAngle, fsPressure, m_tableErrors);
         }
         
-        // 正行程角度
-        if (hasForwardData) {
-            m_dataTable->setItem(i, 2, new QTableWidgetItem(QString::number(currentForwardAngle, 'f', 2)));
-        } else {
-            m_dataTable->setItem(i, 2, new QTableWidgetItem("--"));
-        }
-        
-        // 正行程角度误差 - 所有轮次完成后计算
-        if (hasForwardData && isAllRoundsCompleted()) {
-            // 最终阶段：与"最终角度"(实测对数平均)比较；若无最终角度则退化到理论角度
-            double expected = (finalAngle > 0.0) ? finalAngle : pressureToAngle(point.pressure);
-            double angleError = calculateAngleError(currentForwardAngle, expected);
-            m_dataTable->setItem(i, 3, new QTableWidgetItem(QString::number(angleError, 'f', 2)));
-        } else {
-            m_dataTable->setItem(i, 3, new QTableWidgetItem("--"));
-        }
-        
-        // 正行程误差(压力) - 所有轮次完成后计算
-        if (hasForwardData && isAllRoundsCompleted()) {
-            double expected = (finalAngle > 0.0) ? finalAngle : pressureToAngle(point.pressure);
-            double angleError = calculateAngleError(currentForwardAngle, expected);
-            // 最终阶段：用平均最大角度换算压力误差
-            const double fsAngle = calculateAverageMaxAngle();
-            const double fsPressure = modelFullScalePressure(m_config);
-            double pressureError = angleToPressureByFS(angleError, fsAngle, fsPressure);
-            m_dataTable->setItem(i, 4, new QTableWidgetItem(QString::number(pressureError, 'f', 3)));
-        } else {
-            m_dataTable->setItem(i, 4, new QTableWidgetItem("--"));
-        }
-        
-        // 反行程角度
-        if (hasBackwardData) {
-            m_dataTable->setItem(i, 5, new QTableWidgetItem(QString::number(currentBackwardAngle, 'f', 2)));
-        } else {
-            m_dataTable->setItem(i, 5, new QTableWidgetItem("--"));
-        }
-        
-        // 反行程角度误差 - 所有轮次完成后计算
-        if (hasBackwardData && isAllRoundsCompleted()) {
-            double expected = (finalAngle > 0.0) ? finalAngle : pressureToAngle(point.pressure);
-            double angleError = calculateAngleError(currentBackwardAngle, expected);
-            m_dataTable->setItem(i, 6, new QTableWidgetItem(QString::number(angleError, 'f', 2)));
-        } else {
-            m_dataTable->setItem(i, 6, new QTableWidgetItem("--"));
-        }
+        ErrorDataTableModel::Row row;
+        auto put = [&row](int col, double value, bool valid) {
+            row[col].value = value;
+            row[col].valid = valid;
+        };
         
-        // 反行程误差(压力) - 所有轮次完成后计算
-        if (hasBackwardData && isAllRoundsCompleted()) {
-            double expected = (finalAngle > 0.0) ? finalAngle : pressureToAngle(point.pressure);
-            double angleError = calculateAngleError(currentBackwardAngle, expected);
-            // 最终阶段：用平均最大角度换算压力误差
-            const double fsAngle = calculateAverageMaxAngle();
-            const double fsPressure = modelFullScalePressure(m_config);
-            double pressureError = angleToPressureByFS(angleError, fsAngle, fsPressure);
-            m_dataTable->setItem(i, 7, new QTableWidgetItem(QString::number(pressureError, 'f', 3)));
-        } else {
-            m_dataTable->setItem(i, 7, new QTableWidgetItem("--"));
-        }
+        // 只填要刷新的行
+        auto fillRow = [&](int i) {
+            const double pressure = m_config.detectionPoints[i];
+            
+            // 检测点压力
+            put(ErrorDataTableModel::ColPressure, pressure, true);
+            
+            // 检测点对应的刻度盘角度（最终角度）= 已完成"正+反"成对数据的实测平均（跨轮）
+            put(ErrorDataTableModel::ColFinalAngle, finalAngles[i], true);
+            
+            // 当前轮次的正/反行程：角度 / 角度误差 / 压力误差（误差在所有轮次完成后显示）
+            auto putStroke = [&](MeasurementStore::Stroke stroke, int colAngle, int colAngleErr, int colErr) {
+                const bool has = data.valid(i, round, stroke);
+                put(colAngle, has ? data.angle(i, round, stroke) : 0.0, has);
+                const bool showErr = has && allCompleted;
+                put(colAngleErr, showErr ? m_tableErrors.angleError(i, round, stroke) : 0.0, showErr);
+                put(colErr, showErr ? m_tableErrors.pressureError(i, round, stroke) : 0.0, showErr);
+            };
+            putStroke(MeasurementStore::Forward, ErrorDataTableModel::ColForwardAngle,
+                      ErrorDataTableModel::ColForwardAngleErr, ErrorDataTableModel::ColForwardErr);
+            putStroke(MeasurementStore::Backward, ErrorDataTableModel::ColBackwardAngle,
+                      ErrorDataTableModel::ColBackwardAngleErr, ErrorDataTableModel::ColBackwardErr);
+            
+            // 迟滞误差角度 - 所有轮次完成后计算；迟滞误差(压力) - 固定值
+            put(ErrorDataTableModel::ColHysteresisAngle, allCompleted ? calculateHysteresisAngle(i) : 0.0, allCompleted);
+            put(ErrorDataTableModel::ColHysteresisErr, getFixedHysteresisError(i), true);
+            
+            m_dataModel->setRow(i, row);
+        };
         
-        // 迟滞误差角度 - 所有轮次完成后计算
-        if (isAllRoundsCompleted()) {
-            double hysteresisAngle = calculateHysteresisAngle(i);
-            m_dataTable->setItem(i, 8, new QTableWidgetItem(QString::number(hysteresisAngle, 'f', 2)));
+        if (rows) {
+            for (int i : *rows) {
+                if (i >= 0 && i < pointCount()) fillRow(i);
+            }
         } else {
-            m_dataTable->setItem(i, 8, new QTableWidgetItem("--"));
+            for (int i = 0; i < pointCount(); ++i) fillRow(i);
         }
         
-        // 迟滞误差(压力) - 固定值
-        double fixedHysteresisError = getFixedHysteresisError(i);
-        m_dataTable->setItem(i, 9, new QTableWidgetItem(QString::number(fixedHysteresisError, 'f', 3)));
-    }
-    
-        qDebug() << "设置表格编辑权限";
-        // 临时断开cellChanged信号，避免在设置权限时触发信号
-        disconnect(m_dataTable, &QTableWidget::cellChanged, this, &ErrorTableDialog::onDataTableCellChanged);
-        
-        // 设置表格编辑权限：正行程角度(列2)和反行程角度(列5)可编辑，其他只读
-        for (int i = 0; i < m_dataTable->rowCount(); ++i) {
-            for (int j = 0; j < m_dataTable->columnCount(); ++j) {
-                QTableWidgetItem *item = m_dataTable->item(i, j);
-                if (item) {
-                    if (j == 2 || j == 5) {  // 正行程角度(列2)和反行程角度(列5)可编辑
-                        item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable);
-                        item->setBackground(QColor(230, 255, 230));  // 淡绿色背景表示可编辑
-                    } else {
-                        item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);  // 只读
-                        item->setBackground(QColor(245, 245, 245));  // 淡灰色背景表示只读
-                    }
-                }
+        // 最终数据（表盘用的各点角度）同样只改变了的那几个点
+        if (allCompleted) {
+            if (rows) {
+                updateFinalDataPoints(*rows);
+            } else {
+                setFinalData();
             }
         }
         
-        // 使用QTimer::singleShot延迟连接信号，确保表格完全初始化后再连接
-        QTimer::singleShot(0, this, [this]() {
-            // 确保没有重复连接
-            disconnect(m_dataTable, &QTableWidget::cellChanged, this, &ErrorTableDialog::onDataTableCellChanged);
-            connect(m_dataTable, &QTableWidget::cellChanged, this, &ErrorTableDialog::onDataTableCellChanged);
-            qDebug() << "cellChanged信号已连接";
-        });
-        
-        qDebug() << "updateDataTable 完成";
-        
     } catch (const std::exception& e) {
         qDebug() << "updateDataTable 异常:" << e.what();
     } catch (...) {
         qDebug() << "updateDataTable 未知异常";
     }
-    if (isAllRoundsCompleted()) {
-        setFinalData();
-    }
-    
 }
 
 double ErrorTableDialog::pressureToAngle(double pressure) const
@@ -775,68 +685,27 @@ double ErrorTableDialog::calculateAngleError(double actualAngle, double expected
 double ErrorTableDialog::calculatePressureError(double angleError) const
 {
     // 修正：角度->压力换算使用"动态满量程角度"
-    // 预检阶段：使用当前轮 m_maxAngles[m_currentRound]
+    // 预检阶段：使用当前轮的最大角度
     // 最终阶段：使用所有轮的最大角度平均值 calculateAverageMaxAngle()
     const double fsPressure = modelFullScalePressure(m_config);
-    double fsAngle = 0.0;
-    if (isAllRoundsCompleted()) {
-        fsAngle = calculateAverageMaxAngle();
-    } else {
-        if (m_currentRound >= 0 && m_currentRound < m_maxAngles.size())
-            fsAngle = m_maxAngles[m_currentRound];
-    }
+    const double fsAngle = isAllRoundsCompleted() ? calculateAverageMaxAngle() : session().maxAngle(m_currentRound);
     return angleToPressureByFS(angleError, fsAngle, fsPressure);
 }
 
 void ErrorTableDialog::addAngleData(double angle, bool isForward)
 {
-    if (m_currentPressureIndex >= 0 && m_currentPressureIndex < m_detectionData.size()) {
-        DetectionPoint &point = m_detectionData[m_currentPressureIndex];
-        
-        // 向后兼容：更新老的数据结构
-        if (isForward) {
-            point.forwardAngle = angle;
-            point.hasForward = true;
-        } else {
-            point.backwardAngle = angle;
-            point.hasBackward = true;
-        }
-        
-        // 新的多轮次数据结构：将数据添加到当前轮次
-        if (m_currentRound >= 0 && m_currentRound < point.roundData.size()) {
-            MeasurementData &currentRoundData = point.roundData[m_currentRound];
-            
-            if (isForward) {
-                // 找到第一个空的正行程位置
-                for (int i = 0; i < currentRoundData.forwardAngles.size(); ++i) {
-                    if (currentRoundData.forwardAngles[i] == 0.0) {
-                        currentRoundData.forwardAngles[i] = angle;
-                        qDebug() << "添加第" << (m_currentRound + 1) << "轮第" << (i + 1) << "次正行程数据:" << angle;
-                        break;
-                    }
-                }
-            } else {
-                // 找到第一个空的反行程位置
-                for (int i = 0; i < currentRoundData.backwardAngles.size(); ++i) {
-                    if (currentRoundData.backwardAngles[i] == 0.0) {
-                        currentRoundData.backwardAngles[i] = angle;
-                        qDebug() << "添加第" << (m_currentRound + 1) << "轮第" << (i + 1) << "次反行程数据:" << angle;
-                        break;
-                    }
-                }
-            }
-        }
-        
-        updateDataTable();
-        validateAndCheckErrors();
-        updateCurrentRoundDisplay();
+    // 写到当前检测点当前轮；表格随会话的变化信号刷新
+    if (m_currentPressureIndex >= 0 && m_currentPressureIndex < pointCount()) {
+        qDebug() << "添加第" << (m_currentRound + 1) << "轮" << (isForward ? "正行程" : "反行程")
+                 << "检测点" << (m_currentPressureIndex + 1) << "数据:" << angle;
+        writeAngle(m_currentPressureIndex, isForward, angle);
     }
 }
 
 void ErrorTableDialog::setCurrentPressurePoint(double pressure)
 {
-    for (int i = 0; i < m_detectionData.size(); ++i) {
-        if (std::abs(m_detectionData[i].pressure - pressure) < 0.01) {
+    for (int i = 0; i < pointCount(); ++i) {
+        if (std::abs(m_config.detectionPoints[i] - pressure) < 0.01) {
             m_currentPressureIndex = i;
             m_currentPointLabel->setText(QString("当前检测点: %1 MPa").arg(pressure, 0, 'f', 1));
             break;
@@ -876,27 +745,8 @@ void ErrorTableDialog::setDialType(const QString &dialType)
         m_maxMeasurementsPerRound = 6;  // BYQ每轮6次测量
     }
     
-    // 安全地重新创建检测数据
-    try {
-        m_detectionData.clear();
-        for (double pressure : m_config.detectionPoints) {
-            DetectionPoint point;
-            point.pressure = pressure;
-            m_detectionData.append(point);
-        }
-        
-        qDebug() << "检测点数据已重新创建，数量:" << m_detectionData.size();
-        
-        // 重新初始化轮次数据（必须在创建m_detectionData之后）
-        initializeRoundData();
-        
-    } catch (const std::exception& e) {
-        qDebug() << "重新创建检测数据异常:" << e.what();
-        return;  // 如果出错，直接返回，不继续执行
-    } catch (...) {
-        qDebug() << "重新创建检测数据未知异常";
-        return;
-    }
+    // 检测点变了，自己的会话按新的检测点重建（订阅主界面时数据由主界面重置）
+    initializeRoundData();
     
     // 更新界面显示（仅在UI组件已初始化时）
     if (m_productModelEdit) {  // 检查UI是否已初始化
@@ -909,7 +759,6 @@ void ErrorTableDialog::setDialType(const QString &dialType)
     }
     
     qDebug() << "表盘类型设置完成，检测点数量:" << m_config.detectionPoints.size() 
-             << "检测数据数量:" << m_detectionData.size()
              << "每轮测量次数:" << m_maxMeasurementsPerRound;
              
     // 设置表盘类型后，检查是否需要自动加载之前的数据
@@ -918,43 +767,42 @@ void ErrorTableDialog::setDialType(const QString &dialType)
 
 void ErrorTableDialog::checkAndLoadPreviousData()
 {
-    QString fileName = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/PressureGauge_AutoSave.json";
+    QString fileName = autoSaveFilePath(true);
     
     if (QFile::exists(fileName)) {
         qDebug() << "发现自动保存文件，检查是否有相同表盘类型的数据:" << fileName;
-        try {
-            QFile file(fileName);
-            if (file.open(QIODevice::ReadOnly)) {
-                QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-                QJsonObject config = doc.object();
-                
-                // 检查保存的表盘类型是否与当前设置的相同
-                QString savedDialType = config["productModel"].toString();
-                if (savedDialType == m_config.productModel) {
-                    // 检查是否有有效的测量数据
-                    bool hasValidMeasurementData = config.contains("detectionData") && 
-                                                  config["detectionData"].toArray().size() > 0;
-                    
-                    if (hasValidMeasurementData) {
-                        qDebug() << "找到相同表盘类型的测量数据，询问是否加载";
-                        int ret = QMessageBox::question(this, "发现历史数据", 
-                                                        QString("发现 %1 的历史测量数据，是否加载？").arg(savedDialType),
-                                                        QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
-                        if (ret == QMessageBox::Yes) {
-                            loadConfigFromFile(fileName);
-                            qDebug() << "用户选择加载历史数据";
-                        } else {
-                            qDebug() << "用户选择不加载历史数据";
-                        }
-                    } else {
-                        qDebug() << "自动保存文件存在但无有效测量数据";
+        // 型号和有没有数据都在文件头里，只读头部，不解析整份数据
+        SessionFileHeader header;
+        QString error;
+        if (!readSessionFileHeader(fileName, header, error)) {
+            qDebug() << "检查历史数据失败:" << error;
+            return;
+        }
+        
+        // 检查保存的表盘类型是否与当前设置的相同
+        QString savedDialType = header.productModel;
+        if (savedDialType == m_config.productModel) {
+            // 检查是否有有效的测量数据
+            if (header.dataPoints > 0) {
+                qDebug() << "找到相同表盘类型的测量数据，询问是否加载";
+                int ret = QMessageBox::question(this, "发现历史数据", 
+                                                QString("发现 %1 的历史测量数据，是否加载？").arg(savedDialType),
+                                                QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+                if (ret == QMessageBox::Yes) {
+                    try {
+                        loadConfigFromFile(fileName);
+                        qDebug() << "用户选择加载历史数据";
+                    } catch (const std::exception& e) {
+                        qDebug() << "加载历史数据失败:" << e.what();
                     }
                 } else {
-                    qDebug() << "保存的表盘类型(" << savedDialType << ")与当前类型(" << m_config.productModel << ")不匹配";
+                    qDebug() << "用户选择不加载历史数据";
                 }
+            } else {
+                qDebug() << "自动保存文件存在但无有效测量数据";
             }
-        } catch (const std::exception& e) {
-            qDebug() << "检查历史数据失败:" << e.what();
+        } else {
+            qDebug() << "保存的表盘类型(" << savedDialType << ")与当前类型(" << m_config.productModel << ")不匹配";
         }
     } else {
         qDebug() << "未找到自动保存文件";
@@ -981,12 +829,15 @@ void ErrorTableDialog::onDetectionPointsChanged()
 {
     qDebug() << "检测点配置发生变化";
     
-    // 保存当前的测量数据
-    QMap<double, DetectionPoint> oldData;
-    for (const auto& point : m_detectionData) {
-        oldData[point.pressure] = point;
+    // 订阅主界面时采集位由主界面按表盘检测点排好，已经有数据时不能在这里改检测点，否则数据会落到别的压力上
+    if (m_session && m_session->store().validCount() > 0) {
+        QMessageBox::warning(this, "提示", "当前会话已有采集数据，不能修改检测点。请先清空数据再修改。");
+        updateDetectionPointsTable();   // 表格恢复成原来的检测点
+        return;
     }
     
+    const QVector<double> oldPoints = m_config.detectionPoints;
+    
     // 更新检测点配置
     m_config.detectionPoints.clear();
     
@@ -1004,56 +855,66 @@ void ErrorTableDialog::onDetectionPointsChanged()
     // 排序检测点
     std::sort(m_config.detectionPoints.begin(), m_config.detectionPoints.end());
     
-    // 重建检测数据，保留已有的测量数据
-    m_detectionData.clear();
-    for (double pressure : m_config.detectionPoints) {
-        DetectionPoint point;
-        point.pressure = pressure;
-        
-        // 如果之前有这个检测点的数据，则保留
-        if (oldData.contains(pressure)) {
-            point = oldData[pressure];
-        }
-        
-        m_detectionData.append(point);
-    }
+    // 自己的会话：已有的数据按压力跟着检测点走（压力没变的点保留，新增的点为空，删掉的点数据丢掉）
+    if (!m_session) remapOwnSessionByPressure(oldPoints);
     
     // 更新界面
     updateDetectionPointsTable();
     updateDataTable();
     validateAndCheckErrors();
     
-    qDebug() << "检测点配置更新完成，当前检测点数量:" << m_config.detectionPoints.size() 
-             << "检测数据数量:" << m_detectionData.size();
+    qDebug() << "检测点配置更新完成，当前检测点数量:" << m_config.detectionPoints.size();
+}
+
+// 检测点 i 的数据就是会话的采集位 i：检测点增删、重排后，把各点的数据按压力搬到新的位置
+void ErrorTableDialog::remapOwnSessionByPressure(const QVector<double> &oldPoints)
+{
+    QMap<double, int> oldIndex;
+    for (int i = 0; i < oldPoints.size() && i < m_ownSession.slotsPerRound(); ++i) oldIndex.insert(oldPoints[i], i);
+    
+    const QVector<SessionRound> oldRounds = m_ownSession.data();
+    QVector<SessionRound> rounds(m_totalRounds);
+    for (int round = 0; round < m_totalRounds; ++round) {
+        SessionRound &r = rounds[round];
+        r.forwardAngles.fill(0.0, pointCount());
+        r.backwardAngles.fill(0.0, pointCount());
+        r.forwardValid.fill(false, pointCount());
+        r.backwardValid.fill(false, pointCount());
+        if (round >= oldRounds.size()) continue;
+        const SessionRound &old = oldRounds[round];
+        r.maxAngle = old.maxAngle;
+        r.isCompleted = old.isCompleted;
+        for (int i = 0; i < pointCount(); ++i) {
+            const auto it = oldIndex.constFind(m_config.detectionPoints[i]);
+            if (it == oldIndex.constEnd()) continue;
+            r.forwardAngles[i] = old.forwardAngles[*it];
+            r.backwardAngles[i] = old.backwardAngles[*it];
+            r.forwardValid[i] = old.forwardValid[*it];
+            r.backwardValid[i] = old.backwardValid[*it];
+        }
+    }
+    m_ownSession.load(rounds);
 }
 
 
 void ErrorTableDialog::clearAllData()
 {
-    // 清空所有检测点数据
-    for (DetectionPoint &point : m_detectionData) {
-        // 清空向后兼容的数据
-        point.hasForward = false;
-        point.hasBackward = false;
-        point.forwardAngle = 0.0;
-        point.backwardAngle = 0.0;
-        
-        // 清空多轮次数据
-        for (MeasurementData &roundData : point.roundData) {
-            roundData.forwardAngles.fill(0.0);
-            roundData.backwardAngles.fill(0.0);
-            roundData.maxAngle = 0.0;
-            roundData.isCompleted = false;
-        }
+    // 订阅了主界面：数据归主界面的会话，由主界面确认后清空并记日志，清空后这里会收到整体重置
+    if (m_session) {
+        emit clearRequested();
+        return;
     }
     
-    // 清空最大角度数据
-    m_maxAngles.clear();
-    m_maxAngles.resize(m_totalRounds);  // 重新分配动态轮数
+    // 清空所有检测点数据和最大角度（整体重置会刷新表格）
+    m_ownSession.reset(m_totalRounds, pointCount());
     
     // 重置当前轮次
     m_currentRound = 0;
     
+    // 清空后是一块新表，下次保存在数据库里新建记录
+    m_dbSessionId = -1;
+    m_sessionStartedAt = QDateTime();
+    
     updateDataTable();
     updateAnalysisText();
     updateCurrentRoundDisplay();
@@ -1069,6 +930,49 @@ void ErrorTableDialog::clearAllData()
 //     updateAnalysisText();
 // }
 
+// ================== 误差分析报告（按轮缓存、增量刷新） ==================
+// 报告由"表头 + 各轮片段 + 总结"组成，文档里每段占一个 QTextFrame。
+// 每次刷新只对输入变了的轮次重新生成片段，并只替换对应 frame 的内容，
+// 不再整篇 setHtml（也就不会把滚动位置打回顶部）。
+
+// 跨轮共享的输入：最终角度、平均最大角度、是否全部完成、型号限值
+ErrorTableDialog::ReportContext ErrorTableDialog::buildReportContext() const
+{
+    ReportContext ctx;
+    ctx.completedAll = isAllRoundsCompleted();
+    ctx.avgMaxAngle = calculateAverageMaxAngle();
+    ctx.fsPressure = modelFullScalePressure(m_config);
+    ctx.expectedAngles.reserve(pointCount());
+    ctx.fixedHysteresis.reserve(pointCount());
+
+    size_t sig = qHash(m_config.productModel);
+    sig = qHash(ctx.completedAll, sig);
+    sig = qHash(ctx.avgMaxAngle, sig);
+    sig = qHash(m_config.maxAngle, sig);
+    for (int i = 0; i < pointCount(); ++i) {
+        // "最终角度"：该点跨轮已完成"正+反"的对数平均（若不存在则回退到理论角度）
+        const double finalAngle = calculateFinalMeasuredAngleForDetectionPoint(i);
+        const double expected = (finalAngle > 0.0) ? finalAngle : pressureToAngle(m_config.detectionPoints[i]);
+        ctx.expectedAngles.append(expected);
+        ctx.fixedHysteresis.append(getFixedHysteresisError(i));
+        sig = qHash(m_config.detectionPoints[i], sig);
+        sig = qHash(expected, sig);
+    }
+    // 误差核按会话的采集位数排布；检测点比采集位少/多时多出来的位置不会被读到（store.valid 为假）
+    std::vector<double> expected(store().points(), 0.0);
+    std::copy_n(ctx.expectedAngles.cbegin(), std::min<int>(ctx.expectedAngles.size(), store().points()), expected.begin());
+    computeErrors(store(), expected, ctx.avgMaxAngle, ctx.fsPressure, ctx.errors);
+    ctx.signature = sig;
+    return ctx;
+}
+
+// 某一轮输入的摘要：本轮的角度和最大角度每改一次，存储里该轮的版本号就加一
+size_t ErrorTableDialog::roundSignature(int round) const
+{
+    if (round < 0 || round >= store().rounds()) return 0;
+    return qHash(quint64(store().roundVersion(round)));
+}
+
 void ErrorTableDialog::validateAndCheckErrors()
 {
     updateAnalysisText();
@@ -1076,13 +980,30 @@ void ErrorTableDialog::validateAndCheckErrors()
 
 void ErrorTableDialog::updateAnalysisText()
 {
-    QString analysis = formatAnalysisResult();
-    m_analysisText->setHtml(analysis);
-}
+    if (!m_analysisText) return;
 
+    const ReportContext ctx = buildReportContext();
+    const bool contextChanged = (ctx.signature != m_reportContextSig);
+    m_reportContextSig = ctx.signature;
+    if (m_roundReports.size() != m_totalRounds) {
+        m_roundReports.clear();
+        m_roundReports.resize(m_totalRounds);
+    }
 
-//误差检测结果
-QString ErrorTableDialog::formatAnalysisResult()
+    // 只重算输入变了的轮次；跨轮输入变了（如最终角度、平均最大角度）则全部重算
+    QVector<int> dirtyRounds;
+    for (int round = 0; round < m_totalRounds; ++round) {
+        RoundReport &rep = m_roundReports[round];
+        const size_t sig = roundSignature(round);
+        if (rep.computed && !contextChanged && rep.signature == sig) continue;
+        rep.signature = sig;
+        formatRoundAnalysis(round, ctx, rep);
+        dirtyRounds.append(round);
+    }
+    renderAnalysisDocument(dirtyRounds);
+}
+
+QString ErrorTableDialog::formatReportHeader() const
 {
     QString result = "<h3>误差检测结果</h3>";
     
@@ -1102,186 +1023,118 @@ QString ErrorTableDialog::formatAnalysisResult()
     }
     result += "</p>";
     
-    bool allPointsValid = true;       // 仅在最终阶段用于综合结论
-    bool precheckAllOk = true;        // 预检阶段综合结论
-    int validPointsCount = 0;
-    
     // 显示每轮每个检测点的详细误差信息
     result += "<hr><h4>详细误差分析</h4>";
-    
-    // 遍历所有轮次
-    for (int round = 0; round < m_totalRounds; ++round) {
-        bool roundHasData = false;
-        
-        // 检查当前轮次是否有数据
-        for (const DetectionPoint &point : m_detectionData) {
-            if (round < point.roundData.size()) {
-                const MeasurementData &roundData = point.roundData[round];
-                for (double angle : roundData.forwardAngles) {
-                    if (angle != 0.0) { roundHasData = true; break; }
-                }
-                if (!roundHasData) {
-                    for (double angle : roundData.backwardAngles) {
-                        if (angle != 0.0) { roundHasData = true; break; }
-                    }
-                }
-            }
-            if (roundHasData) break;
-        }
-        
-        if (!roundHasData) continue; // 跳过没有数据的轮次
-        
-        result += QString("<h5>第%1轮误差分析</h5>").arg(round + 1);
-        
-        // 遍历所有检测点
-        const bool completedAll = isAllRoundsCompleted();
-        // 若未完成全部轮次，且该轮已采过最大角度，则计算本轮"预检迟滞阈值角度"
-        double precheckThreshDeg = 0.0;
-        if (!completedAll && round < m_maxAngles.size() && m_maxAngles[round] > 0.0) {
-            precheckThreshDeg = precheckHysteresisAngleDeg(m_config, m_maxAngles[round]);
-            result += QString("<p style='color:#888;'>（预检）本轮迟滞阈值角度 ≈ %1°</p>")
-                      .arg(precheckThreshDeg, 0, 'f', 2);
+    return result;
+}
+
+// 生成一轮的报告片段，并统计本轮的有效点数/合格情况供总结使用
+void ErrorTableDialog::formatRoundAnalysis(int round, const ReportContext &ctx, RoundReport &rep) const
+{
+    rep.computed = true;
+    rep.hasData = false;
+    rep.validCount = 0;
+    rep.allValid = true;
+    rep.precheckOk = true;
+    rep.html.clear();
+
+    // 检查当前轮次是否有数据
+    const MeasurementStore &data = store();
+    rep.hasData = round < data.rounds() && data.roundHasData(round);
+    if (!rep.hasData) return; // 跳过没有数据的轮次
+
+    QString &result = rep.html;
+    result += QString("<h5>第%1轮误差分析</h5>").arg(round + 1);
+    
+    // 若未完成全部轮次，且该轮已采过最大角度，则计算本轮"预检迟滞阈值角度"
+    const bool completedAll = ctx.completedAll;
+    double precheckThreshDeg = 0.0;
+    if (!completedAll && data.hasMaxAngle(round)) {
+        precheckThreshDeg = precheckHysteresisAngleDeg(m_config, data.maxAngle(round));
+        result += QString("<p style='color:#888;'>（预检）本轮迟滞阈值角度 ≈ %1°</p>")
+                  .arg(precheckThreshDeg, 0, 'f', 2);
+    }
+
+    // 单个读数的一行：最终阶段按 MPa 误差与限值判断，预检阶段只按角度偏差与预检阈值比较（避免虚高的MPa）
+    auto appendMeasurement = [&](int i, int measurement, double angle, const char *stroke) {
+        const double pressure = m_config.detectionPoints[i];
+        const double expectedAngle = ctx.expectedAngles[i];
+        if (completedAll) {
+            double angleError = calculateAngleError(angle, expectedAngle);
+            double pressureError = std::abs(angleToPressureByFS(angleError, ctx.avgMaxAngle, ctx.fsPressure));
+            const bool over = (pressureError > ctx.fixedHysteresis[i]);
+            result += QString("<p><b>%1 MPa 第%2轮第%3次%4:</b> 角度 %5° → 误差 %6 MPa")
+                      .arg(pressure, 0, 'f', 1).arg(round + 1).arg(measurement + 1).arg(stroke)
+                      .arg(angle, 0, 'f', 2).arg(pressureError, 0, 'f', 3);
+            result += over ? QString(" <span style='color: red; font-weight: bold;'>[超标]</span>")
+                           : QString(" <span style='color: green;'>[合格]</span>");
+            result += "</p>";
+            if (over) rep.allValid = false;
+        } else if (precheckThreshDeg > 0.0) {
+            double diffDeg = std::abs(angle - expectedAngle);
+            bool over = (diffDeg > precheckThreshDeg);
+            result += QString("<p><b>%1 MPa 第%2轮第%3次%4（预检）:</b> 角度 %5° → 偏差 %6° / 阈值 %7°")
+                      .arg(pressure, 0, 'f', 1).arg(round + 1).arg(measurement + 1).arg(stroke)
+                      .arg(angle, 0, 'f', 2).arg(diffDeg, 0, 'f', 2).arg(precheckThreshDeg, 0, 'f', 2);
+            result += over ? QString(" <span style='color: red; font-weight: bold;'>[超标]</span>")
+                           : QString(" <span style='color: green;'>[合格]</span>");
+            result += "</p>";
+            if (over) rep.precheckOk = false;
         }
+        rep.validCount++;
+    };
 
-        for (int i = 0; i < m_detectionData.size(); ++i) {
-            const DetectionPoint &point = m_detectionData[i];
-            // "最终角度"：该点跨轮已完成"正+反"的对数平均（若不存在则回退到理论角度）
-            double finalAngle = calculateFinalMeasuredAngleForDetectionPoint(i);
-            double expectedAngle = (finalAngle > 0.0) ? finalAngle : pressureToAngle(point.pressure);
-            
-            if (round < point.roundData.size()) {
-                const MeasurementData &roundData = point.roundData[round];
-                // 预检：如正反首个有效角度差超过阈值，则立即提示
-                if (!completedAll && precheckThreshDeg > 0.0) {
-                    double fwd=0.0, bwd=0.0;
-                    if (firstValidAnglesOfRound(roundData, fwd, bwd)) {
-                        double diffDeg = std::abs(fwd - bwd);
-                        if (diffDeg > precheckThreshDeg) {
-                            result += QString("<p><span style='color:red;font-weight:bold;'>（预检）第%1轮 %2 MPa 正/反差 %3° &gt; 阈值 %4° [超标]</span></p>")
-                                      .arg(round + 1).arg(point.pressure, 0, 'f', 1).arg(diffDeg, 0, 'f', 2).arg(precheckThreshDeg, 0, 'f', 2);
-                            precheckAllOk = false;
-                        }
-                    }
-                }
-                
-                // 检查正行程数据
-                for (int measurement = 0; measurement < roundData.forwardAngles.size(); ++measurement) {
-                    double angle = roundData.forwardAngles[measurement];
-                    if (angle != 0.0) {
-                        if (completedAll) {
-                            // 最终阶段：计算MPa，并按基本误差限值判断
-                            double angleError = calculateAngleError(angle, expectedAngle);
-                            double fsAngle = calculateAverageMaxAngle();
-                            const double fsPressure = modelFullScalePressure(m_config);
-                            double pressureError = std::abs(angleToPressureByFS(angleError, fsAngle, fsPressure));
-                            double fixedHysteresisError = getFixedHysteresisError(i);
-                            const bool over = (pressureError > fixedHysteresisError);
-                            result += QString("<p><b>%1 MPa 第%2轮第%3次正行程:</b> 角度 %4° → 误差 %5 MPa")
-                                      .arg(point.pressure, 0, 'f', 1).arg(round + 1).arg(measurement + 1)
-                                      .arg(angle, 0, 'f', 2).arg(pressureError, 0, 'f', 3);
-                            result += over ? QString(" <span style='color: red; font-weight: bold;'>[超标]</span>")
-                                           : QString(" <span style='color: green;'>[合格]</span>");
-                            result += "</p>";
-                            if (over) allPointsValid = false;
-                        } else {
-                            // 预检阶段：仅按角度偏差与"预检阈值角度"比较，避免虚高的MPa
-                            if (precheckThreshDeg > 0.0) {
-                                double diffDeg = std::abs(angle - expectedAngle);
-                                bool over = (diffDeg > precheckThreshDeg);
-                                result += QString("<p><b>%1 MPa 第%2轮第%3次正行程（预检）:</b> 角度 %4° → 偏差 %5° / 阈值 %6°")
-                                          .arg(point.pressure, 0, 'f', 1).arg(round + 1).arg(measurement + 1)
-                                          .arg(angle, 0, 'f', 2).arg(diffDeg, 0, 'f', 2).arg(precheckThreshDeg, 0, 'f', 2);
-                                result += over ? QString(" <span style='color: red; font-weight: bold;'>[超标]</span>")
-                                               : QString(" <span style='color: green;'>[合格]</span>");
-                                result += "</p>";
-                                if (over) precheckAllOk = false;
-                            }
-                        }
-                        validPointsCount++;
-                    }
-                }
-                
-                // 检查反行程数据
-                for (int measurement = 0; measurement < roundData.backwardAngles.size(); ++measurement) {
-                    double angle = roundData.backwardAngles[measurement];
-                    if (angle != 0.0) {
-                        if (completedAll) {
-                            double angleError = calculateAngleError(angle, expectedAngle);
-                            double fsAngle = calculateAverageMaxAngle();
-                            const double fsPressure = modelFullScalePressure(m_config);
-                            double pressureError = std::abs(angleToPressureByFS(angleError, fsAngle, fsPressure));
-                            double fixedHysteresisError = getFixedHysteresisError(i);
-                            const bool over = (pressureError > fixedHysteresisError);
-                            result += QString("<p><b>%1 MPa 第%2轮第%3次反行程:</b> 角度 %4° → 误差 %5 MPa")
-                                      .arg(point.pressure, 0, 'f', 1).arg(round + 1).arg(measurement + 1)
-                                      .arg(angle, 0, 'f', 2).arg(pressureError, 0, 'f', 3);
-                            result += over ? QString(" <span style='color: red; font-weight: bold;'>[超标]</span>")
-                                           : QString(" <span style='color: green;'>[合格]</span>");
-                            result += "</p>";
-                            if (over) allPointsValid = false;
-                        } else {
-                            if (precheckThreshDeg > 0.0) {
-                                double diffDeg = std::abs(angle - expectedAngle);
-                                bool over = (diffDeg > precheckThreshDeg);
-                                result += QString("<p><b>%1 MPa 第%2轮第%3次反行程（预检）:</b> 角度 %4° → 偏差 %5° / 阈值 %6°")
-                                          .arg(point.pressure, 0, 'f', 1).arg(round + 1).arg(measurement + 1)
-                                          .arg(angle, 0, 'f', 2).arg(diffDeg, 0, 'f', 2).arg(precheckThreshDeg, 0, 'f', 2);
-                                result += over ? QString(" <span style='color: red; font-weight: bold;'>[超标]</span>")
-                                               : QString(" <span style='color: green;'>[合格]</span>");
-                                result += "</p>";
-                                if (over) precheckAllOk = false;
-                            }
-                        }
-                        validPointsCount++;
-                    }
-                }
+    for (int i = 0; i < pointCount(); ++i) {
+        const bool hasForward = data.valid(i, round, MeasurementStore::Forward);
+        const bool hasBackward = data.valid(i, round, MeasurementStore::Backward);
+
+        // 预检：如正反角度差超过阈值，则立即提示
+        if (!completedAll && precheckThreshDeg > 0.0 && hasForward && hasBackward) {
+            const double diffDeg = ctx.errors.hysteresisAngleAt(i, round);
+            if (diffDeg > precheckThreshDeg) {
+                result += QString("<p><span style='color:red;font-weight:bold;'>（预检）第%1轮 %2 MPa 正/反差 %3° &gt; 阈值 %4° [超标]</span></p>")
+                          .arg(round + 1).arg(m_config.detectionPoints[i], 0, 'f', 1).arg(diffDeg, 0, 'f', 2).arg(precheckThreshDeg, 0, 'f', 2);
+                rep.precheckOk = false;
             }
         }
-        result += QString("<p><b>迟滞误差检测，</b> 合格或者超标：</p>");
+        
+        // 每个检测点每轮每个行程一个读数
+        if (hasForward) appendMeasurement(i, 0, data.angle(i, round, MeasurementStore::Forward), "正行程");
+        if (hasBackward) appendMeasurement(i, 0, data.angle(i, round, MeasurementStore::Backward), "反行程");
+    }
+    result += QString("<p><b>迟滞误差检测，</b> 合格或者超标：</p>");
 
-        if (round < m_maxAngles.size() && m_maxAngles[round] > 0) {
-            
-            for (int i = 0; i < m_detectionData.size(); ++i) {
-                const DetectionPoint &point = m_detectionData[i];
-                if (round < point.roundData.size()) {
-                    const MeasurementData &roundData = point.roundData[round];
-                    // 找到正行程和反行程的有效数据
-                    double forwardAngle = 0.0, backwardAngle = 0.0;
-                    bool hasForward = false, hasBackward = false;
-                    
-                    for (double angle : roundData.forwardAngles) {
-                        if (angle != 0.0) { forwardAngle = angle; hasForward = true; break; }
-                    }
-                    for (double angle : roundData.backwardAngles) {
-                        if (angle != 0.0) { backwardAngle = angle; hasBackward = true; break; }
-                    }
-                    
-                    if (hasForward && hasBackward) {
-                        double fixedHysteresisError = getFixedHysteresisError(i);
-                        double angleDiff = std::abs(forwardAngle - backwardAngle);
-                        //角度转PM
-                        double fsAngle = calculateAverageMaxAngle();
-                        const double fsPressure = modelFullScalePressure(m_config);
-                        double pressureError = std::abs(angleToPressureByFS(angleDiff, fsAngle, fsPressure));
-                        if (pressureError > fixedHysteresisError) {
-                            
-                            result += QString(" <span style='color: red; font-weight: bold;'>[超标]</span>");
-                            allPointsValid = false;
-                        } else {
-                            result += QString(" <span style='color: green;'>[合格]</span>");
-                            // 如果是"预检阶段"，此处只给出固定值提示，不改变预检逻辑
-                            if (!completedAll) { /* 保持现有输出格式 */ }
-                        }
-                    }
+    if (data.hasMaxAngle(round)) {
+        for (int i = 0; i < pointCount(); ++i) {
+            // 正行程和反行程都有有效数据才判断；|正-反| 换算成 MPa 已在误差核里算好
+            if (data.valid(i, round, MeasurementStore::Forward) && data.valid(i, round, MeasurementStore::Backward)) {
+                const double pressureError = ctx.errors.hysteresisPressureAt(i, round);
+                if (pressureError > ctx.fixedHysteresis[i]) {
+                    result += QString(" <span style='color: red; font-weight: bold;'>[超标]</span>");
+                    rep.allValid = false;
+                } else {
+                    result += QString(" <span style='color: green;'>[合格]</span>");
                 }
             }
-            result += "</p>";
         }
-        
-        result += "<hr>";
+        result += "</p>";
     }
     
-    // 总结
+    result += "<hr>";
+}
+
+QString ErrorTableDialog::formatReportSummary() const
+{
+    bool allPointsValid = true;       // 仅在最终阶段用于综合结论
+    bool precheckAllOk = true;        // 预检阶段综合结论
+    int validPointsCount = 0;
+    for (const RoundReport &rep : m_roundReports) {
+        validPointsCount += rep.validCount;
+        allPointsValid = allPointsValid && rep.allValid;
+        precheckAllOk = precheckAllOk && rep.precheckOk;
+    }
+
+    QString result;
     if (!isAllRoundsCompleted()) {
         // 预检阶段总结
         if (validPointsCount == 0) {
@@ -1302,246 +1155,124 @@ QString ErrorTableDialog::formatAnalysisResult()
         result += "<p style='color: red; font-size: 16px; font-weight: bold;'>✗ 检测不合格</p>";
         result += "<p style='color: red;'>请调整超标检测点的刻度盘角度</p>";
     }
-    
     return result;
 }
 
+//误差检测结果（完整 HTML，由缓存的各段拼成）
+QString ErrorTableDialog::formatAnalysisResult()
+{
+    QString result = formatReportHeader();
+    for (const RoundReport &rep : m_roundReports) result += rep.html;
+    return result + formatReportSummary();
+}
+
+// 把片段写进文档：有数据的轮次集合没变时只替换变化的 frame，否则整体重排一次
+void ErrorTableDialog::renderAnalysisDocument(const QVector<int> &dirtyRounds)
+{
+    QVector<int> layout;
+    for (int round = 0; round < m_roundReports.size(); ++round) {
+        if (m_roundReports[round].hasData) layout.append(round);
+    }
+    const QString header = formatReportHeader();
+    const QString summary = formatReportSummary();
+
+    auto replaceFrame = [](QTextFrame *frame, const QString &html) {
+        QTextCursor cursor = frame->firstCursorPosition();
+        cursor.setPosition(frame->lastPosition(), QTextCursor::KeepAnchor);
+        cursor.removeSelectedText();
+        cursor.insertHtml(html);
+    };
+
+    QTextDocument *doc = m_analysisText->document();
+    if (!m_reportHeaderFrame || layout != m_reportLayout) {
+        // 首次或某轮从无到有/被清空：重建各段 frame
+        doc->clear();
+        m_reportRoundFrames.fill(nullptr, m_roundReports.size());
+        QTextFrameFormat ff;
+        ff.setBorder(0);
+        ff.setMargin(0);
+        ff.setPadding(0);
+        QTextCursor cursor(doc);
+        cursor.beginEditBlock();
+        auto addFrame = [&](const QString &html) {
+            cursor.movePosition(QTextCursor::End);
+            QTextFrame *frame = cursor.insertFrame(ff);
+            cursor.insertHtml(html);
+            return frame;
+        };
+        m_reportHeaderFrame = addFrame(header);
+        for (int round : layout) m_reportRoundFrames[round] = addFrame(m_roundReports[round].html);
+        m_reportSummaryFrame = addFrame(summary);
+        cursor.endEditBlock();
+        m_reportLayout = layout;
+        m_reportHeaderHtml = header;
+        m_reportSummaryHtml = summary;
+        return;
+    }
+
+    QTextCursor batch(doc);
+    batch.beginEditBlock();
+    if (header != m_reportHeaderHtml) {
+        replaceFrame(m_reportHeaderFrame, header);
+        m_reportHeaderHtml = header;
+    }
+    for (int round : dirtyRounds) {
+        if (round < m_reportRoundFrames.size() && m_reportRoundFrames[round])
+            replaceFrame(m_reportRoundFrames[round], m_roundReports[round].html);
+    }
+    if (summary != m_reportSummaryHtml) {
+        replaceFrame(m_reportSummaryFrame, summary);
+        m_reportSummaryHtml = summary;
+    }
+    batch.endEditBlock();
+}
+
 void ErrorTableDialog::exportToExcel()
 {
     // 在导出之前，先更新配置信息，确保最新的输入值被保存
     updateConfigFromUI();
     
-    QString fileName = QFileDialog::getSaveFileName(this, "导出CSV文件", "", "CSV文件 (*.csv)");
+    QString selectedFilter;
+    QString fileName = QFileDialog::getSaveFileName(this, "导出Excel文件", "", "Excel工作簿 (*.xlsx);;CSV文件 (*.csv);;会话数据 JSON (*.json)", &selectedFilter);
     if (fileName.isEmpty()) return;
     
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "错误", "无法创建文件");
-        return;
-    }
-    
-    file.write("\xEF\xBB\xBF");
-    
-    QTextStream out(&file);
-    out.setEncoding(QStringConverter::Utf8);
-    
-    // 写入产品信息 - 按照新格式
-    out << QString("产品型号：,%1,,产品名称：,%2,,,\n").arg(m_config.productModel, m_config.productName);
-    out << QString("刻度盘图号：,%1,,支组编号：,%2,,,\n").arg(m_config.dialDrawingNo, m_config.groupNo);
-    // 新增：写入平均最大总角度（度）
-    
-    double avgMaxAngle = calculateAverageMaxAngle();
-    out << QString("平均最大总角度：,%1,,,\n").arg(avgMaxAngle, 0, 'f', 2);
-    
-    out << "\n"; // 空行
-    
-    // 收集所有检测点数据（只显示一次）
-    QStringList detectionPoints, theoreticalAngles;
-    for (int i = 0; i < m_detectionData.size(); ++i) {
-        const DetectionPoint &point = m_detectionData[i];
-        // 检测点
-        detectionPoints << QString::number(point.pressure, 'f', 1);
-        // "检测点对应的刻度盘角度" = 实测最终角度（若无则以理论角度代替）
-        double finalAngle = calculateFinalMeasuredAngleForDetectionPoint(i);
-        if (finalAngle != 0.0) {
-            theoreticalAngles << QString::number(finalAngle, 'f', 2);
+    // 整份会话数据导出成 JSON，给别的程序交换用（与老的自动保存文件同格式）
+    if (fileName.endsWith(".json", Qt::CaseInsensitive) || selectedFilter.contains("json")) {
+        if (!fileName.endsWith(".json", Qt::CaseInsensitive)) fileName += ".json";
+        QString error;
+        if (writeSessionJson(fileName, buildSessionFileData(), error)) {
+            QMessageBox::information(this, "成功", QString("会话数据已导出到:\n%1").arg(fileName));
         } else {
-            theoreticalAngles << QString::number(pressureToAngle(point.pressure), 'f', 2);
+            QMessageBox::warning(this, "错误", error);
         }
+        return;
     }
     
-    // 写入检测点和最终角度（只显示一次）
-    out << QString("检测点,%1,,,\n").arg(detectionPoints.join(","));
-    out << QString("检测点对应的刻度盘角度,%1,,,\n").arg(theoreticalAngles.join(","));
-    out << "\n"; // 空行
-    
+    // 排版与合格_.csv 一致；没有成对数据的检测点按配置的满量程换算理论角度
+    const QVector<QStringList> rows = buildGaugeReport(buildSessionRecord(), m_config.maxAngle, m_config.maxPressure).rows;
     
-    // 为每轮数据写入
-    for (int round = 0; round < m_totalRounds; ++round) {
-        // 新增：轮次标题
-        out << QString("第%1轮,,,,\n").arg(round + 1);
-        // 收集当前轮次的所有检测点数据
-        QStringList forwardAngles, forwardAngleErrors, forwardPressureErrors;
-        QStringList backwardAngles, backwardAngleErrors, backwardPressureErrors;
-        QStringList roundHystAngles, roundHystPressure; // 该轮迟滞误差
-        
-        for (int i = 0; i < m_detectionData.size(); ++i) {
-            const DetectionPoint &point = m_detectionData[i];
-            // "最终角度"：该点跨轮已完成"正+反"的对数平均（若不存在则回退到理论角度）
-            double finalAngle = calculateFinalMeasuredAngleForDetectionPoint(i);
-            double expectedAngle = (finalAngle > 0.0) ? finalAngle : pressureToAngle(point.pressure);
-            
-            // 获取当前轮次的数据
-            double currentForwardAngle = 0.0;
-            double currentBackwardAngle = 0.0;
-            bool hasForwardData = false;
-            bool hasBackwardData = false;
-            
-            if (round < point.roundData.size()) {
-                const MeasurementData &currentRoundData = point.roundData[round];
-                
-                // 获取正行程数据（取第一个非零值）
-                for (double angle : currentRoundData.forwardAngles) {
-                    if (angle != 0.0) {
-                        currentForwardAngle = angle;
-                        hasForwardData = true;
-                        break;
-                    }
-                }
-                
-                // 获取反行程数据（取第一个非零值）
-                for (double angle : currentRoundData.backwardAngles) {
-                    if (angle != 0.0) {
-                        currentBackwardAngle = angle;
-                        hasBackwardData = true;
-                        break;
-                    }
-                }
-            }
-            
-            // 正行程数据
-            if (hasForwardData) {
-                forwardAngles << QString::number(currentForwardAngle, 'f', 2);
-                double angleError = calculateAngleError(currentForwardAngle, expectedAngle);
-                forwardAngleErrors << QString::number(angleError, 'f', 2);
-                // 按轮换算：预检用该轮最大角度，最终用平均最大角度
-                double fsAngle = isAllRoundsCompleted()
-                                   ? calculateAverageMaxAngle()
-                                   : ((round < m_maxAngles.size()) ? m_maxAngles[round] : 0.0);
-                const double fsPressure = modelFullScalePressure(m_config);
-                double pressureError = angleToPressureByFS(angleError, fsAngle, fsPressure);
-                forwardPressureErrors << QString::number(pressureError, 'f', 3);
-            } else {
-                forwardAngles << "--";
-                forwardAngleErrors << "--";
-                forwardPressureErrors << "--";
-            }
-            
-            // 反行程数据
-            if (hasBackwardData) {
-                backwardAngles << QString::number(currentBackwardAngle, 'f', 2);
-                double angleError = calculateAngleError(currentBackwardAngle, expectedAngle);
-                backwardAngleErrors << QString::number(angleError, 'f', 2);
-                // 按轮换算：预检用该轮最大角度，最终用平均最大角度
-                double fsAngle = isAllRoundsCompleted()
-                                   ? calculateAverageMaxAngle()
-                                   : ((round < m_maxAngles.size()) ? m_maxAngles[round] : 0.0);
-                const double fsPressure = modelFullScalePressure(m_config);
-                double pressureError = angleToPressureByFS(angleError, fsAngle, fsPressure);
-                backwardPressureErrors << QString::number(pressureError, 'f', 3);
-            } else {
-                backwardAngles << "--";
-                backwardAngleErrors << "--";
-                backwardPressureErrors << "--";
-            }
-
-            // 新增：该轮迟滞误差（角度与MPa），按点计算（需要正反行程都有）
-            if (hasForwardData && hasBackwardData) {
-                double angleDiff = std::abs(currentForwardAngle - currentBackwardAngle);
-                roundHystAngles << QString::number(angleDiff, 'f', 2);
-                double fsAngle = isAllRoundsCompleted()
-                                   ? calculateAverageMaxAngle()
-                                   : ((round < m_maxAngles.size()) ? m_maxAngles[round] : 0.0);
-                const double fsPressure = modelFullScalePressure(m_config);
-                double hystMPa = angleToPressureByFS(angleDiff, fsAngle, fsPressure);
-                roundHystPressure << QString::number(std::abs(hystMPa), 'f', 3);
-            } else {
-                roundHystAngles << "--";
-                roundHystPressure << "--";
-            }
-        }
-        
-        // 按照垂直格式写入当前轮次的数据
-        out << QString("正行程角度,%1,,,\n").arg(forwardAngles.join(","));
-        out << QString("正行程角度误差,%1,,,\n").arg(forwardAngleErrors.join(","));
-        out << QString("正行程误差（MPa）,%1,,,\n").arg(forwardPressureErrors.join(","));
-        //out << "\n";
-        out << QString("反行程角度,%1,,,\n").arg(backwardAngles.join(","));
-        out << QString("反行程角度误差,%1,,,\n").arg(backwardAngleErrors.join(","));
-        out << QString("反行程误差（MPa）,%1,,,\n").arg(backwardPressureErrors.join(","));
-        // 新增：该轮迟滞误差（角度与MPa）
-        out << QString("该轮迟滞误差角度,%1,,,\n").arg(roundHystAngles.join(","));
-        out << QString("该轮迟滞误差（MPa）,%1,,,\n").arg(roundHystPressure.join(","));
-        out << "\n";
-    }
-    // 计算并显示迟滞误差（只显示一次，在最后两行）
-    QStringList hysteresisAngles, hysteresisPressureErrors;
-    for (int i = 0; i < m_detectionData.size(); ++i) {
-        const DetectionPoint &point = m_detectionData[i];
-        // "最终角度"：该点跨轮已完成"正+反"的对数平均（若不存在则回退到理论角度）
-        double finalAngle = calculateFinalMeasuredAngleForDetectionPoint(i);
-        double expectedAngle = (finalAngle > 0.0) ? finalAngle : pressureToAngle(point.pressure);
-        
-        // 计算所有轮次的平均迟滞误差
-        double totalAngleDiff = 0.0;
-        int validRoundCount = 0;
-        
-        for (int round = 0; round < point.roundData.size() && round < m_totalRounds; ++round) {
-            const MeasurementData &currentRoundData = point.roundData[round];
-            
-            double currentForwardAngle = 0.0;
-            double currentBackwardAngle = 0.0;
-            bool hasForwardData = false;
-            bool hasBackwardData = false;
-            
-            // 获取正行程数据
-            for (double angle : currentRoundData.forwardAngles) {
-                if (angle != 0.0) {
-                    currentForwardAngle = angle;
-                    hasForwardData = true;
-                    break;
-                }
-            }
-            
-            // 获取反行程数据
-            for (double angle : currentRoundData.backwardAngles) {
-                if (angle != 0.0) {
-                    currentBackwardAngle = angle;
-                    hasBackwardData = true;
-                    break;
-                }
-            }
-            
-            // 计算迟滞误差
-            if (hasForwardData && hasBackwardData) {
-                double angleDiff = std::abs(currentForwardAngle - currentBackwardAngle);
-                totalAngleDiff += angleDiff;
-                validRoundCount++;
-            }
-        }
-        
-        if (validRoundCount > 0) {
-            double avgAngleDiff = totalAngleDiff / validRoundCount;
-            hysteresisAngles << QString::number(avgAngleDiff, 'f', 2);
-            // 使用固定迟滞误差值
-            double fsAngle = calculateAverageMaxAngle();
-            const double fsPressure = modelFullScalePressure(m_config);
-            double pressureError = std::abs(angleToPressureByFS(avgAngleDiff, fsAngle, fsPressure));
-            hysteresisPressureErrors << QString::number(pressureError, 'f', 3);
-        } else {
-            hysteresisAngles << "--";
-            hysteresisPressureErrors << "--";
+    const bool asCsv = fileName.endsWith(".csv", Qt::CaseInsensitive)
+                       || (selectedFilter.contains("csv") && !fileName.endsWith(".xlsx", Qt::CaseInsensitive));
+    if (asCsv) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            QMessageBox::warning(this, "错误", "无法创建文件");
+            return;
         }
+        file.write("\xEF\xBB\xBF");
+        QTextStream out(&file);
+        out.setEncoding(QStringConverter::Utf8);
+        for (const QStringList &row : rows) out << row.join(",") << "\n";
+        QMessageBox::information(this, "成功", QString("%1轮测量数据已导出到CSV文件，按照指定格式排列，可用Excel打开").arg(m_totalRounds));
+        return;
     }
     
-    out << QString("迟滞误差角度,%1,,,\n").arg(hysteresisAngles.join(","));
-    out << QString("迟滞误差（MPa）,%1,,,\n").arg(hysteresisPressureErrors.join(","));
-    // // === 修正：导出迟滞误差角度 = 该点迟滞误差(MPa) / 满量程压力 * 实测平均总角度 ===
-    // QStringList hysteresisAnglesFixed;
-    // double avgMaxAngle = calculateAverageMaxAngle(); // 实测平均总角度
-    // const double fsPressure = modelFullScalePressure(m_config);
-    // for (int i = 0; i < m_detectionData.size(); ++i) {
-    //     if (avgMaxAngle > 0.0 && fsPressure > 0.0) {
-    //         double angleDeg = (getFixedHysteresisError(i) / fsPressure) * avgMaxAngle;
-    //         hysteresisAnglesFixed << QString::number(angleDeg, 'f', 2);
-    //     } else {
-    //         hysteresisAnglesFixed << "--";
-    //     }
-    // }
-    // out << QString("迟滞误差角度,%1,,,\n").arg(hysteresisAnglesFixed.join(","));
-    // out << QString("迟滞误差（MPa）,%1,,,\n").arg(hysteresisPressureErrors.join(","));
-    
-    QMessageBox::information(this, "成功", QString("%1轮测量数据已导出到CSV文件，按照指定格式排列，可用Excel打开").arg(m_totalRounds));
+    // 真正的 xlsx 工作簿，在后台线程里写，进度框可取消
+    if (!fileName.endsWith(".xlsx", Qt::CaseInsensitive)) fileName += ".xlsx";
+    XlsxExportJob::Sheet sheet;
+    sheet.name = m_config.groupNo.isEmpty() ? QString("误差表") : m_config.groupNo;
+    sheet.rows = rows;
+    (new XlsxExportJob(fileName, {sheet}))->start(this);
 }
 
 QString ErrorTableDialog::generateExportData()
@@ -1563,39 +1294,45 @@ QString ErrorTableDialog::generateExportData()
     data += "--------\n";
     data += QString("检测点\t正行程角度\t反行程角度\t角度差\t正行程误差(°)\t反行程误差(°)\t正行程误差(MPa)\t反行程误差(MPa)\n");
     
-    for (int i = 0; i < m_detectionData.size(); ++i) {
-        const DetectionPoint &point = m_detectionData[i];
+    // 当前轮各检测点的正/反行程读数
+    const MeasurementSession &current = session();
+    for (int i = 0; i < pointCount(); ++i) {
+        const double pressure = m_config.detectionPoints[i];
+        const bool hasForward = current.hasAngle(m_currentRound, MeasurementSession::Forward, i);
+        const bool hasBackward = current.hasAngle(m_currentRound, MeasurementSession::Backward, i);
+        const double forwardAngle = current.angle(m_currentRound, MeasurementSession::Forward, i);
+        const double backwardAngle = current.angle(m_currentRound, MeasurementSession::Backward, i);
         // "最终角度"：该点跨轮已完成"正+反"的对数平均（若不存在则回退到理论角度）
         double finalAngle = calculateFinalMeasuredAngleForDetectionPoint(i);
-        double expectedAngle = (finalAngle > 0.0) ? finalAngle : pressureToAngle(point.pressure);
+        double expectedAngle = (finalAngle > 0.0) ? finalAngle : pressureToAngle(pressure);
         
-        data += QString("%1").arg(point.pressure, 0, 'f', 1);
+        data += QString("%1").arg(pressure, 0, 'f', 1);
         
-        if (point.hasForward) {
-            data += QString("\t%1").arg(point.forwardAngle, 0, 'f', 2);
+        if (hasForward) {
+            data += QString("\t%1").arg(forwardAngle, 0, 'f', 2);
         } else {
             data += "\t--";
         }
         
-        if (point.hasBackward) {
-            data += QString("\t%1").arg(point.backwardAngle, 0, 'f', 2);
+        if (hasBackward) {
+            data += QString("\t%1").arg(backwardAngle, 0, 'f', 2);
         } else {
             data += "\t--";
         }
         
-        if (point.hasForward && point.hasBackward) {
-            double angleDiff = std::abs(point.forwardAngle - point.backwardAngle);
+        if (hasForward && hasBackward) {
+            double angleDiff = std::abs(forwardAngle - backwardAngle);
             data += QString("\t%1").arg(angleDiff, 0, 'f', 2);
         } else {
             data += "\t--";
         }
         
-        if (point.hasForward) {
-            double angleError = calculateAngleError(point.forwardAngle, expectedAngle);
+        if (hasForward) {
+            double angleError = calculateAngleError(forwardAngle, expectedAngle);
             // 单行导出沿用动态满量程角度（预检用当前轮，最终用平均）
             double fsAngle = isAllRoundsCompleted()
                                ? calculateAverageMaxAngle()
-                               : ((m_currentRound >=0 && m_currentRound < m_maxAngles.size()) ? m_maxAngles[m_currentRound] : 0.0);
+                               : current.maxAngle(m_currentRound);
             const double fsPressure = modelFullScalePressure(m_config);
             double pressureError = angleToPressureByFS(angleError, fsAngle, fsPressure);
             data += QString("\t%1\t\t%2").arg(angleError, 0, 'f', 2).arg(pressureError, 0, 'f', 3);
@@ -1603,12 +1340,12 @@ QString ErrorTableDialog::generateExportData()
             data += "\t--\t\t--";
         }
         
-        if (point.hasBackward) {
-            double angleError = calculateAngleError(point.backwardAngle, expectedAngle);
+        if (hasBackward) {
+            double angleError = calculateAngleError(backwardAngle, expectedAngle);
             // 同上
             double fsAngle = isAllRoundsCompleted()
                                ? calculateAverageMaxAngle()
-                               : ((m_currentRound >=0 && m_currentRound < m_maxAngles.size()) ? m_maxAngles[m_currentRound] : 0.0);
+                               : current.maxAngle(m_currentRound);
             const double fsPressure = modelFullScalePressure(m_config);
             double pressureError = angleToPressureByFS(angleError, fsAngle, fsPressure);
             data += QString("\t%1\t%2").arg(angleError, 0, 'f', 2).arg(pressureError, 0, 'f', 3);
@@ -1625,206 +1362,249 @@ QString ErrorTableDialog::generateExportData()
 void ErrorTableDialog::saveConfig()
 {
     // 自动保存到默认位置，不再弹出文件选择对话框
-    QString fileName = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/PressureGauge_AutoSave.json";
+    QString fileName = autoSaveFilePath(false);
     
     try {
+        // 先写数据库（会回填 m_dbSessionId），再写会话文件，这样恢复文件里记的是这条记录
+        const bool archived = archiveSession();
         saveConfigToFile(fileName);
-        QMessageBox::information(this, "成功", QString("数据已自动保存到:\n%1").arg(fileName));
+        QString msg = QString("数据已自动保存到:\n%1").arg(fileName);
+        msg += archived ? QString("\n检测记录 #%1 已写入数据库").arg(m_dbSessionId)
+                        : QString("\n写入检测记录数据库失败: %1").arg(m_sessionDb.lastError());
+        QMessageBox::information(this, "成功", msg);
     } catch (const std::exception& e) {
         QMessageBox::warning(this, "错误", QString("自动保存失败: %1").arg(e.what()));
     }
 }
 
-void ErrorTableDialog::saveConfigToFile(const QString &fileName)
+SessionRecord ErrorTableDialog::buildSessionRecord() const
 {
-    QJsonObject config;
-    config["productModel"] = m_config.productModel;
-    config["productName"] = m_config.productName;
-    config["dialDrawingNo"] = m_config.dialDrawingNo;
-    config["groupNo"] = m_config.groupNo;
-    config["maxPressure"] = m_config.maxPressure;
-    config["maxAngle"] = m_config.maxAngle;
-    //config["basicErrorLimit"] = m_config.basicErrorLimit;
-    //config["hysteresisErrorLimit"] = m_config.hysteresisErrorLimit;
-    
-    QJsonArray points;
-    for (double pressure : m_config.detectionPoints) {
-        points.append(pressure);
-    }
-    config["detectionPoints"] = points;
-    
-    // 保存测量数据（包含多轮次数据）
-    QJsonArray detectionData;
-    for (const DetectionPoint &point : m_detectionData) {
-        QJsonObject pointObj;
-        pointObj["pressure"] = point.pressure;
-        pointObj["forwardAngle"] = point.forwardAngle;  // 向后兼容
-        pointObj["backwardAngle"] = point.backwardAngle;  // 向后兼容
-        pointObj["hasForward"] = point.hasForward;  // 向后兼容
-        pointObj["hasBackward"] = point.hasBackward;  // 向后兼容
-        
-        // 保存多轮次数据
-        QJsonArray roundDataArray;
-        for (const MeasurementData &roundData : point.roundData) {
-            QJsonObject roundObj;
-            
-            QJsonArray forwardAngles;
-            for (double angle : roundData.forwardAngles) {
-                forwardAngles.append(angle);
-            }
-            roundObj["forwardAngles"] = forwardAngles;
-            
-            QJsonArray backwardAngles;
-            for (double angle : roundData.backwardAngles) {
-                backwardAngles.append(angle);
+    SessionRecord rec;
+    rec.id = m_dbSessionId;
+    rec.productModel = m_config.productModel;
+    rec.productName = m_config.productName;
+    rec.dialDrawingNo = m_config.dialDrawingNo;
+    rec.groupNo = m_config.groupNo;
+    rec.maxPressure = modelFullScalePressure(m_config);
+    rec.startedAt = m_sessionStartedAt;
+    rec.savedAt = QDateTime::currentDateTime();
+    rec.totalRounds = m_totalRounds;
+    rec.currentRound = m_currentRound;
+    rec.detectionPoints = m_config.detectionPoints;
+    const MeasurementStore &data = store();
+    rec.roundMaxAngles.resize(m_totalRounds);
+    for (int round = 0; round < m_totalRounds; ++round) rec.roundMaxAngles[round] = data.maxAngle(round);
+    rec.avgMaxAngle = calculateAverageMaxAngle();
+
+    // 误差与表格里一致：全部轮次完成后，相对"最终角度"换算到压力
+    const bool allCompleted = isAllRoundsCompleted();
+    const double fsPressure = modelFullScalePressure(m_config);
+    for (int i = 0; i < pointCount(); ++i) {
+        const double pressure = m_config.detectionPoints[i];
+        double expected = 0.0;
+        if (allCompleted) {
+            const double finalAngle = calculateFinalMeasuredAngleForDetectionPoint(i);
+            expected = (finalAngle > 0.0) ? finalAngle : pressureToAngle(pressure);
+        }
+        for (int round = 0; round < m_totalRounds; ++round) {
+            for (int stroke = 1; stroke >= -1; stroke -= 2) {
+                const int side = stroke > 0 ? MeasurementStore::Forward : MeasurementStore::Backward;
+                if (!data.valid(i, round, side)) continue;
+                SessionReading r;
+                r.round = round;
+                r.pointIndex = i;
+                r.pressure = pressure;
+                r.stroke = stroke;
+                r.seq = 0;   // 每轮每个行程一个读数
+                r.angle = data.angle(i, round, side);
+                if (allCompleted) {
+                    r.hasError = true;
+                    r.errorMPa = angleToPressureByFS(calculateAngleError(r.angle, expected), rec.avgMaxAngle, fsPressure);
+                    rec.maxAbsErrMPa = std::max(rec.maxAbsErrMPa, std::abs(r.errorMPa));
+                }
+                rec.readings.append(r);
             }
-            roundObj["backwardAngles"] = backwardAngles;
-            
-            roundObj["maxAngle"] = roundData.maxAngle;
-            roundDataArray.append(roundObj);
         }
-        pointObj["roundData"] = roundDataArray;
-        
-        detectionData.append(pointObj);
     }
-    config["detectionData"] = detectionData;
-    
-    // 保存轮次管理数据
-    config["currentRound"] = m_currentRound;
-    config["maxMeasurementsPerRound"] = m_maxMeasurementsPerRound;
-    
-    QJsonArray maxAnglesArray;
-    for (double maxAngle : m_maxAngles) {
-        maxAnglesArray.append(maxAngle);
+
+    // 合格判定沿用分析报告的逐轮结论
+    if (allCompleted) {
+        bool ok = !m_roundReports.isEmpty();
+        for (const RoundReport &rep : m_roundReports) ok = ok && rep.computed && rep.allValid;
+        rec.passed = ok ? 1 : 0;
+    }
+    return rec;
+}
+
+bool ErrorTableDialog::archiveSession()
+{
+    if (!m_sessionStartedAt.isValid()) m_sessionStartedAt = QDateTime::currentDateTime();
+    SessionRecord rec = buildSessionRecord();
+    if (!m_sessionDb.saveSession(rec)) return false;
+    m_dbSessionId = rec.id;
+    return true;
+}
+
+void ErrorTableDialog::showSessionHistory()
+{
+    SessionHistoryDialog dialog(&m_sessionDb, this);
+    dialog.setFilter(m_config.productModel, m_config.groupNo);
+    dialog.exec();
+}
+
+QString ErrorTableDialog::autoSaveFilePath(bool forLoad)
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    const QString path = dir + "/PressureGauge_AutoSave.pgs";
+    // 老版本存的是 JSON：还没有二进制文件时从它恢复，下次保存就写成二进制
+    if (forLoad && !QFile::exists(path) && QFile::exists(dir + "/PressureGauge_AutoSave.json")) {
+        return dir + "/PressureGauge_AutoSave.json";
+    }
+    return path;
+}
+
+SessionFileData ErrorTableDialog::buildSessionFileData() const
+{
+    SessionFileData data;
+    data.productModel = m_config.productModel;
+    data.productName = m_config.productName;
+    data.dialDrawingNo = m_config.dialDrawingNo;
+    data.groupNo = m_config.groupNo;
+    data.maxPressure = m_config.maxPressure;
+    data.maxAngle = m_config.maxAngle;
+    data.detectionPoints = m_config.detectionPoints;
+    
+    // 检测数据按 [点][轮][次] 紧排：会话里每个检测点每轮每个行程一个读数，放在第一次的位置（与主界面会话一致）
+    const MeasurementSession &current = session();
+    const int slots = qMax(1, m_maxMeasurementsPerRound);
+    data.resizeData(pointCount(), m_totalRounds, slots);
+    for (int i = 0; i < pointCount(); ++i) {
+        data.pressures[i] = m_config.detectionPoints[i];
+        // 向后兼容：单次角度取当前轮
+        const bool hasForward = current.hasAngle(m_currentRound, MeasurementSession::Forward, i);
+        const bool hasBackward = current.hasAngle(m_currentRound, MeasurementSession::Backward, i);
+        data.legacyForward[i] = current.angle(m_currentRound, MeasurementSession::Forward, i);
+        data.legacyBackward[i] = current.angle(m_currentRound, MeasurementSession::Backward, i);
+        data.legacyFlags[i] = quint8((hasForward ? 1 : 0) | (hasBackward ? 2 : 0));
+        for (int round = 0; round < m_totalRounds; ++round) {
+            const qsizetype cell = data.slotIndex(i, round, 0);
+            data.forwardAngles[cell] = current.angle(round, MeasurementSession::Forward, i);
+            data.backwardAngles[cell] = current.angle(round, MeasurementSession::Backward, i);
+            data.forwardValid[cell] = current.hasAngle(round, MeasurementSession::Forward, i);
+            data.backwardValid[cell] = current.hasAngle(round, MeasurementSession::Backward, i);
+            data.pointRoundMax[qsizetype(i) * m_totalRounds + round] = current.maxAngle(round);
+        }
     }
-    config["maxAngles"] = maxAnglesArray;
     
-    QJsonDocument doc(config);
+    // 轮次管理数据
+    data.currentRound = m_currentRound;
+    data.maxMeasurementsPerRound = m_maxMeasurementsPerRound;
+    data.maxAngles.resize(m_totalRounds);
+    for (int round = 0; round < m_totalRounds; ++round) data.maxAngles[round] = current.maxAngle(round);
     
-    QFile file(fileName);
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(doc.toJson());
-        qDebug() << "数据已保存到:" << fileName;
-    } else {
+    // 对应检测记录数据库里的哪条记录：恢复后再保存时更新同一条，而不是新建
+    data.dbSessionId = m_dbSessionId;
+    data.startedAt = m_sessionStartedAt;
+    return data;
+}
+
+void ErrorTableDialog::saveConfigToFile(const QString &fileName)
+{
+    // .json 是给别的程序交换用的，其余一律写二进制会话文件
+    QString error;
+    const SessionFileData data = buildSessionFileData();
+    const bool ok = fileName.endsWith(".json", Qt::CaseInsensitive) ? writeSessionJson(fileName, data, error)
+                                                                      : writeSessionFile(fileName, data, error);
+    if (!ok) {
+        qDebug() << "保存失败:" << error;
         throw std::runtime_error("无法保存配置文件");
     }
+    qDebug() << "数据已保存到:" << fileName;
 }
 
 void ErrorTableDialog::loadConfigFromFile(const QString &fileName)
 {
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly)) {
+    // 二进制和 JSON 按文件内容自动识别
+    SessionFileData data;
+    QString error;
+    if (!readSessionFile(fileName, data, error)) {
+        qDebug() << "读取失败:" << error;
         throw std::runtime_error("无法读取配置文件");
     }
     
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-    QJsonObject config = doc.object();
-    
-    m_config.productModel = config["productModel"].toString();
-    m_config.productName = config["productName"].toString();
-    m_config.dialDrawingNo = config["dialDrawingNo"].toString();
-    m_config.groupNo = config["groupNo"].toString();
-    m_config.maxPressure = config["maxPressure"].toDouble();
-    m_config.maxAngle = config["maxAngle"].toDouble();
-    //m_config.basicErrorLimit = config["basicErrorLimit"].toDouble();
-    //m_config.hysteresisErrorLimit = config["hysteresisErrorLimit"].toDouble();
-    
-    m_config.detectionPoints.clear();
-    QJsonArray points = config["detectionPoints"].toArray();
-    for (const QJsonValue &value : points) {
-        m_config.detectionPoints.append(value.toDouble());
-    }
-    
-    // 加载测量数据
-    m_detectionData.clear();
-    if (config.contains("detectionData")) {
-        QJsonArray detectionData = config["detectionData"].toArray();
-        for (const QJsonValue &value : detectionData) {
-            QJsonObject pointObj = value.toObject();
-            DetectionPoint point;
-            point.pressure = pointObj["pressure"].toDouble();
-            point.forwardAngle = pointObj["forwardAngle"].toDouble();  // 向后兼容
-            point.backwardAngle = pointObj["backwardAngle"].toDouble();  // 向后兼容
-            point.hasForward = pointObj["hasForward"].toBool();  // 向后兼容
-            point.hasBackward = pointObj["hasBackward"].toBool();  // 向后兼容
-            
-            // 加载多轮次数据
-            if (pointObj.contains("roundData")) {
-                QJsonArray roundDataArray = pointObj["roundData"].toArray();
-                point.roundData.clear();
-                point.roundData.resize(m_totalRounds);  // 确保有足够的轮次数据
-                
-                for (int i = 0; i < roundDataArray.size() && i < m_totalRounds; ++i) {
-                    QJsonObject roundObj = roundDataArray[i].toObject();
-                    
-                    // 加载正行程数据
-                    if (roundObj.contains("forwardAngles")) {
-                        QJsonArray forwardAngles = roundObj["forwardAngles"].toArray();
-                        point.roundData[i].forwardAngles.clear();
-                        for (const QJsonValue &angle : forwardAngles) {
-                            point.roundData[i].forwardAngles.append(angle.toDouble());
-                        }
-                    }
-                    
-                    // 加载反行程数据
-                    if (roundObj.contains("backwardAngles")) {
-                        QJsonArray backwardAngles = roundObj["backwardAngles"].toArray();
-                        point.roundData[i].backwardAngles.clear();
-                        for (const QJsonValue &angle : backwardAngles) {
-                            point.roundData[i].backwardAngles.append(angle.toDouble());
-                        }
-                    }
-                    
-                    // 加载最大角度
-                    point.roundData[i].maxAngle = roundObj["maxAngle"].toDouble();
-                }
-            } else {
-                // 如果没有多轮次数据，初始化空的轮次数据
-                point.roundData.clear();
-                point.roundData.resize(5);
-            }
-            
-            m_detectionData.append(point);
-        }
-    } else {
-        // 如果没有测量数据，创建空的检测点数据
-        for (double pressure : m_config.detectionPoints) {
-            DetectionPoint point;
-            point.pressure = pressure;
-            m_detectionData.append(point);
-        }
-    }
+    m_config.productModel = data.productModel;
+    m_config.productName = data.productName;
+    m_config.dialDrawingNo = data.dialDrawingNo;
+    m_config.groupNo = data.groupNo;
+    m_config.maxPressure = data.maxPressure;
+    m_config.maxAngle = data.maxAngle;
+    m_config.detectionPoints = data.detectionPoints;
     
     // 加载轮次管理数据
-    if (config.contains("currentRound")) {
-        m_currentRound = config["currentRound"].toInt();
-    }
-    if (config.contains("maxMeasurementsPerRound")) {
-        m_maxMeasurementsPerRound = config["maxMeasurementsPerRound"].toInt();
-    }
-    if (config.contains("maxAngles")) {
-        QJsonArray maxAnglesArray = config["maxAngles"].toArray();
-        m_maxAngles.clear();
-        m_maxAngles.resize(5);
-        for (int i = 0; i < maxAnglesArray.size() && i < 5; ++i) {
-            m_maxAngles[i] = maxAnglesArray[i].toDouble();
-        }
+    m_currentRound = qBound(0, data.currentRound, m_totalRounds - 1);
+    if (data.maxMeasurementsPerRound > 0) {
+        m_maxMeasurementsPerRound = data.maxMeasurementsPerRound;
     }
     
-    // 确保所有检测点都有完整的轮次数据
-    for (DetectionPoint &point : m_detectionData) {
-        if (point.roundData.size() != m_totalRounds) {
-            point.roundData.resize(m_totalRounds);
-        }
-        for (MeasurementData &roundData : point.roundData) {
-            if (roundData.forwardAngles.size() != m_maxMeasurementsPerRound) {
-                roundData.forwardAngles.resize(m_maxMeasurementsPerRound);
+    // 测量数据装进自己的会话：每个检测点每轮每个行程取第一个读数（超出总轮数的丢掉）
+    QVector<SessionRound> rounds(m_totalRounds);
+    const int sessionPoints = qMax(pointCount(), data.dataPoints);
+    for (int round = 0; round < m_totalRounds; ++round) {
+        SessionRound &r = rounds[round];
+        r.forwardAngles.fill(0.0, sessionPoints);
+        r.backwardAngles.fill(0.0, sessionPoints);
+        r.forwardValid.fill(false, sessionPoints);
+        r.backwardValid.fill(false, sessionPoints);
+        if (round < data.maxAngles.size()) {
+            r.maxAngle = data.maxAngles[round];
+        } else if (data.dataPoints > 0 && round < data.rounds) {
+            r.maxAngle = data.pointRoundMax[round];   // 老文件只在各点里记了最大角度
+        }
+    }
+    // 从 from 开始的 slots 次里第一个有读数的，写进 angle/valid；返回装不下而丢掉的读数个数
+    auto firstReading = [&data](const QVector<double> &angles, const QVector<quint8> &valid, qsizetype from,
+                                double &angle, bool &has) {
+        int dropped = 0;
+        for (int k = 0; k < data.slots; ++k) {
+            if (!valid[from + k]) continue;
+            if (has) {
+                ++dropped;
+                continue;
             }
-            if (roundData.backwardAngles.size() != m_maxMeasurementsPerRound) {
-                roundData.backwardAngles.resize(m_maxMeasurementsPerRound);
+            angle = angles[from + k];
+            has = true;
+        }
+        return dropped;
+    };
+    int dropped = 0;
+    for (int i = 0; i < data.dataPoints; ++i) {
+        for (int round = 0; round < data.rounds; ++round) {
+            const qsizetype from = data.slotIndex(i, round, 0);
+            if (round >= m_totalRounds) {
+                for (int k = 0; k < data.slots; ++k) dropped += data.forwardValid[from + k] + data.backwardValid[from + k];
+                continue;
             }
+            SessionRound &r = rounds[round];
+            dropped += firstReading(data.forwardAngles, data.forwardValid, from, r.forwardAngles[i], r.forwardValid[i]);
+            dropped += firstReading(data.backwardAngles, data.backwardValid, from, r.backwardAngles[i], r.backwardValid[i]);
         }
     }
+    if (m_session) {
+        // 订阅主界面时显示的是主界面的会话，文件里的测量数据不覆盖它（主界面有自己的会话日志恢复）
+        qDebug() << "误差表格已订阅主界面会话，只加载配置，测量数据保留在表格自己的会话里";
+    }
+    // 旧文件一个检测点每轮可以存好几次读数，会话每格只有一个：多出来的读数不能悄悄丢掉
+    if (dropped > 0) {
+        qDebug() << "会话文件中有" << dropped << "个读数无法装入（同一检测点同一轮多次读数或超出总轮数）";
+        QMessageBox::warning(this, "提示",
+                             QString("文件 %1 中有 %2 个读数未加载：\n"
+                                     "每个检测点每轮每个行程只保留第一个读数，超出总轮数（%3 轮）的轮次不加载。")
+                                 .arg(QFileInfo(fileName).fileName()).arg(dropped).arg(m_totalRounds));
+    }
+    m_ownSession.load(rounds);
+    
+    m_dbSessionId = data.dbSessionId;
+    m_sessionStartedAt = data.startedAt;
     
     updateUIFromConfig();
     updateDetectionPointsTable();
@@ -1844,28 +1624,23 @@ void ErrorTableDialog::autoLoadPreviousData()
         return;
     }
     
-    QString fileName = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/PressureGauge_AutoSave.json";
+    QString fileName = autoSaveFilePath(true);
     
     if (QFile::exists(fileName)) {
         qDebug() << "发现自动保存文件，检查是否有有效数据:" << fileName;
         try {
-            QFile file(fileName);
-            if (file.open(QIODevice::ReadOnly)) {
-                QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-                QJsonObject config = doc.object();
-                
-                // 检查是否有有效的检测点数据或测量数据
-                bool hasValidDetectionPoints = config.contains("detectionPoints") && 
-                                             config["detectionPoints"].toArray().size() > 0;
-                bool hasValidMeasurementData = config.contains("detectionData") && 
-                                              config["detectionData"].toArray().size() > 0;
-                
-                if (hasValidDetectionPoints || hasValidMeasurementData) {
-                    loadConfigFromFile(fileName);
-                    qDebug() << "自动加载完成，有有效数据";
-                } else {
-                    qDebug() << "自动保存文件存在但无有效数据，保持当前默认配置";
-                }
+            // 先只读文件头判断有没有检测点或测量数据，有才整份加载
+            SessionFileHeader header;
+            QString error;
+            if (!readSessionFileHeader(fileName, header, error)) {
+                throw std::runtime_error(error.toStdString());
+            }
+            
+            if (header.hasData()) {
+                loadConfigFromFile(fileName);
+                qDebug() << "自动加载完成，有有效数据";
+            } else {
+                qDebug() << "自动保存文件存在但无有效数据，保持当前默认配置";
             }
         } catch (const std::exception& e) {
             qDebug() << "自动加载失败:" << e.what();
@@ -1876,107 +1651,44 @@ void ErrorTableDialog::autoLoadPreviousData()
     }
 }
 
-void ErrorTableDialog::onTableCellClicked(int row, int column)
+void ErrorTableDialog::onTableCellClicked(const QModelIndex &index)
 {
-    if (row >= 0 && row < m_detectionData.size()) {
+    const int row = index.row();
+    const int column = index.column();
+    if (row >= 0 && row < pointCount()) {
         m_currentPressureIndex = row;
-        double pressure = m_detectionData[row].pressure;
+        double pressure = m_config.detectionPoints[row];
         m_currentPointLabel->setText(QString("当前检测点: %1 MPa").arg(pressure, 0, 'f', 1));
         
         // 根据点击的列设置测量方向
-        if (column == 2) {  // 正行程角度列
+        if (column == ErrorDataTableModel::ColForwardAngle) {  // 正行程角度列
             m_isForwardDirection = true;
-        } else if (column == 5) {  // 反行程角度列
+        } else if (column == ErrorDataTableModel::ColBackwardAngle) {  // 反行程角度列
             m_isForwardDirection = false;
         }
     }
 }
 
-void ErrorTableDialog::onDataTableCellChanged(int row, int column)
+void ErrorTableDialog::onDataTableCellChanged(int row, int column, double value)
 {
-    if (row < 0 || row >= m_detectionData.size()) return;
+    if (row < 0 || row >= pointCount()) return;
     
-    QTableWidgetItem *item = m_dataTable->item(row, column);
-    if (!item) return;
+    const bool forward = (column == ErrorDataTableModel::ColForwardAngle);
+    if (!forward && column != ErrorDataTableModel::ColBackwardAngle) return;
     
-    bool ok;
-    double value = item->text().toDouble(&ok);
-    if (!ok) return;
-    
-    DetectionPoint &point = m_detectionData[row];
-    
-    // 临时断开cellChanged信号，避免递归调用
-    disconnect(m_dataTable, &QTableWidget::cellChanged, this, &ErrorTableDialog::onDataTableCellChanged);
-    
-    // 根据列判断修改哪个数据
-    if (column == 2) { // 正行程角度
-        point.forwardAngle = value;
-        point.hasForward = true;
-        
-        // 只更新相关的计算列，不重新生成整个表格
-        double finalAngle = calculateFinalMeasuredAngleForDetectionPoint(row);
-        double expected = (finalAngle > 0.0) ? finalAngle : pressureToAngle(point.pressure);
-        double angleError = calculateAngleError(point.forwardAngle, expected);
-        // 预检 / 最终阶段动态换算
-        double fsAngle = isAllRoundsCompleted()
-                           ? calculateAverageMaxAngle()
-                           : ((m_currentRound >=0 && m_currentRound < m_maxAngles.size()) ? m_maxAngles[m_currentRound] : 0.0);
-        const double fsPressure = modelFullScalePressure(m_config);
-        double pressureError = angleToPressureByFS(angleError, fsAngle, fsPressure);
-        
-        m_dataTable->item(row, 3)->setText(QString::number(angleError, 'f', 2));
-        m_dataTable->item(row, 4)->setText(QString::number(pressureError, 'f', 3));
-        
-        // 更新迟滞误差（如果有反行程数据）
-        if (point.hasBackward) {
-            // 迟滞误差角度 - 所有轮次完成后计算
-            if (isAllRoundsCompleted()) {
-                double hysteresisAngle = calculateHysteresisAngle(row);
-                m_dataTable->item(row, 8)->setText(QString::number(hysteresisAngle, 'f', 2));
-            }
-            
-            // 迟滞误差(压力) - 固定值
-            double fixedHysteresisError = getFixedHysteresisError(row);
-            m_dataTable->setItem(row, 9, new QTableWidgetItem(QString::number(fixedHysteresisError, 'f', 3)));
-        }
-        
-    } else if (column == 5) { // 反行程角度
-        point.backwardAngle = value;
-        point.hasBackward = true;
-        
-        // 只更新相关的计算列
-        double finalAngle = calculateFinalMeasuredAngleForDetectionPoint(row);
-        double expected = (finalAngle > 0.0) ? finalAngle : pressureToAngle(point.pressure);
-        double angleError = calculateAngleError(point.backwardAngle, expected);
-        // 预检 / 最终阶段动态换算
-        double fsAngle = isAllRoundsCompleted()
-                           ? calculateAverageMaxAngle()
-                           : ((m_currentRound >=0 && m_currentRound < m_maxAngles.size()) ? m_maxAngles[m_currentRound] : 0.0);
-        const double fsPressure = modelFullScalePressure(m_config);
-        double pressureError = angleToPressureByFS(angleError, fsAngle, fsPressure);
-        
-        m_dataTable->item(row, 6)->setText(QString::number(angleError, 'f', 2));
-        m_dataTable->item(row, 7)->setText(QString::number(pressureError, 'f', 3));
-        
-        // 更新迟滞误差（如果有正行程数据）
-        if (point.hasForward) {
-            // 迟滞误差角度 - 所有轮次完成后计算
-            if (isAllRoundsCompleted()) {
-                double hysteresisAngle = calculateHysteresisAngle(row);
-                m_dataTable->item(row, 8)->setText(QString::number(hysteresisAngle, 'f', 2));
-            }
-            
-            // 迟滞误差(压力) - 固定值
-            double fixedHysteresisError = getFixedHysteresisError(row);
-            m_dataTable->setItem(row, 9, new QTableWidgetItem(QString::number(fixedHysteresisError, 'f', 3)));
-        }
+    // 写进会话；这一行的误差/迟滞列和分析结果随会话的变化信号只刷新这一行
+    writeAngle(row, forward, value);
+}
+
+// 表格里的写入都落到会话上：订阅主界面时交给主界面写（它还要记日志），否则写自己的会话
+void ErrorTableDialog::writeAngle(int pointIndex, bool forward, double value)
+{
+    if (m_session) {
+        emit angleEdited(pointIndex, forward, value);
+    } else {
+        m_ownSession.setAngle(m_currentRound, forward ? MeasurementSession::Forward : MeasurementSession::Backward,
+                              pointIndex, value);
     }
-    
-    // 重新连接信号
-    connect(m_dataTable, &QTableWidget::cellChanged, this, &ErrorTableDialog::onDataTableCellChanged);
-    
-    // 更新分析结果
-    validateAndCheckErrors();
 }
 
 // ================== 轮次管理方法实现 ==================
@@ -1984,25 +1696,29 @@ void ErrorTableDialog::onDataTableCellChanged(int row, int column)
 void ErrorTableDialog::initializeRoundData()
 {
     m_currentRound = 0;
-    m_maxAngles.fill(0.0);
     
-    // 为所有检测点初始化轮次数据
-    for (DetectionPoint &point : m_detectionData) {
-        point.roundData.clear();
-        point.roundData.resize(m_totalRounds);  // 动态轮数
-        
-        // 为每轮初始化数据
-        for (int round = 0; round < m_totalRounds; ++round) {
-            point.roundData[round].forwardAngles.resize(m_maxMeasurementsPerRound);
-            point.roundData[round].backwardAngles.resize(m_maxMeasurementsPerRound);
-            point.roundData[round].maxAngle = 0.0;
-        }
-    }
+    // 自己的会话重新分配成空的；订阅主界面时形状和数据由主界面的会话决定
+    if (!m_session) m_ownSession.reset(m_totalRounds, pointCount());
     
     qDebug() << "轮次数据已初始化，最大测量次数:" << m_maxMeasurementsPerRound;
     // 注意：不在这里调用updateCurrentRoundDisplay()，因为UI可能还没有初始化
 }
 
+// 轮数或检测点数变了：按新形状换入，已有的数据保留
+void ErrorTableDialog::resizeOwnSession()
+{
+    if (m_ownSession.rounds() == m_totalRounds && m_ownSession.slotsPerRound() == pointCount()) return;
+    QVector<SessionRound> rounds = m_ownSession.data();
+    rounds.resize(m_totalRounds);
+    for (SessionRound &r : rounds) {
+        r.forwardAngles.resize(pointCount());
+        r.backwardAngles.resize(pointCount());
+        r.forwardValid.resize(pointCount());
+        r.backwardValid.resize(pointCount());
+    }
+    m_ownSession.load(rounds);
+}
+
 void ErrorTableDialog::setTotalRounds(int rounds)
 {
     if (rounds < 1 || rounds > 10) {
@@ -2014,23 +1730,8 @@ void ErrorTableDialog::setTotalRounds(int rounds)
         qDebug() << "设置总轮数从" << m_totalRounds << "改为" << rounds;
         m_totalRounds = rounds;
         
-        // 重新调整最大角度数组大小
-        m_maxAngles.resize(m_totalRounds);
-        
-        // 重新调整所有检测点的轮次数据
-        for (DetectionPoint &point : m_detectionData) {
-            point.roundData.resize(m_totalRounds);
-            
-            // 为新增的轮次初始化数据
-            for (int round = 0; round < m_totalRounds; ++round) {
-                if (point.roundData[round].forwardAngles.size() != m_maxMeasurementsPerRound) {
-                    point.roundData[round].forwardAngles.resize(m_maxMeasurementsPerRound);
-                }
-                if (point.roundData[round].backwardAngles.size() != m_maxMeasurementsPerRound) {
-                    point.roundData[round].backwardAngles.resize(m_maxMeasurementsPerRound);
-                }
-            }
-        }
+        // 自己的会话跟着调整轮数（订阅主界面时主界面会整体重置它的会话）
+        if (!m_session) resizeOwnSession();
         
         // 如果当前轮次超出新的总轮数，重置为0
         if (m_currentRound >= m_totalRounds) {
@@ -2068,23 +1769,10 @@ void ErrorTableDialog::resetCurrentRound()
 {
     qDebug() << "重置当前轮次(" << m_currentRound + 1 << ")数据";
     
-    // 重置当前轮次的所有检测点数据
-    for (DetectionPoint &point : m_detectionData) {
-        if (m_currentRound < point.roundData.size()) {
-            MeasurementData &currentData = point.roundData[m_currentRound];
-            currentData.forwardAngles.fill(0.0);
-            currentData.backwardAngles.fill(0.0);
-            currentData.maxAngle = 0.0;
-        }
-    }
-    
-    // 重置当前轮次的最大角度
-    if (m_currentRound < m_maxAngles.size()) {
-        m_maxAngles[m_currentRound] = 0.0;
-    }
+    // 重置当前轮次的所有检测点数据和最大角度（表格随会话的变化信号刷新）
+    session().clearRound(m_currentRound);
     
     // 更新界面显示
-    updateDataTable();
     updateCurrentRoundDisplay();
     
     QMessageBox::information(this, "归位", QString("第%1轮数据已重置").arg(m_currentRound + 1));
@@ -2095,27 +1783,7 @@ void ErrorTableDialog::saveCurrentRound()
     qDebug() << "保存当前轮次(" << m_currentRound + 1 << ")数据";
     
     // 检查当前轮次是否有有效数据
-    bool hasValidData = false;
-    for (const DetectionPoint &point : m_detectionData) {
-        if (m_currentRound < point.roundData.size()) {
-            const MeasurementData &currentData = point.roundData[m_currentRound];
-            for (double angle : currentData.forwardAngles) {
-                if (angle != 0.0) {
-                    hasValidData = true;
-                    break;
-                }
-            }
-            if (hasValidData) break;
-            
-            for (double angle : currentData.backwardAngles) {
-                if (angle != 0.0) {
-                    hasValidData = true;
-                    break;
-                }
-            }
-            if (hasValidData) break;
-        }
-    }
+    const bool hasValidData = m_currentRound < store().rounds() && store().roundHasData(m_currentRound);
     
     if (!hasValidData) {
         QMessageBox::warning(this, "警告", "当前轮次没有有效的测量数据！");
@@ -2143,54 +1811,27 @@ void ErrorTableDialog::saveCurrentRound()
 
 void ErrorTableDialog::addMaxAngleData(double maxAngle)
 {
-    if (m_currentRound >= 0 && m_currentRound < m_maxAngles.size()) {
-        m_maxAngles[m_currentRound] = maxAngle;
+    if (session().hasRound(m_currentRound)) {
+        // 满量程角度和表格随会话的变化信号更新
+        session().setMaxAngle(m_currentRound, maxAngle);
         qDebug() << "添加第" << (m_currentRound + 1) << "轮最大角度:" << maxAngle;
         
-        // 更新所有检测点的当前轮次最大角度
-        for (DetectionPoint &point : m_detectionData) {
-            if (m_currentRound < point.roundData.size()) {
-                point.roundData[m_currentRound].maxAngle = maxAngle;
-            }
-        }
-        
-        // 计算5轮最大角度的平均值并更新配置
-        updateMaxAngleFromRounds();
-        
         updateCurrentRoundDisplay();
     }
 }
 
 double ErrorTableDialog::calculateAverageMaxAngle() const
 {
-    double sum = 0.0;
-    int count = 0;
-    
-    for (int i = 0; i <= m_currentRound && i < m_maxAngles.size(); ++i) {
-        if (m_maxAngles[i] != 0.0) {
-            sum += m_maxAngles[i];
-            count++;
-        }
-    }
-    return count > 0 ? sum / count : 0.0;
+    // 0..当前轮里已采集的最大角度平均
+    return store().averageMaxAngle(m_currentRound);
 }
 
 // 计算所有轮次最大角度的平均值并更新配置
 void ErrorTableDialog::updateMaxAngleFromRounds()
 {
-    double sum = 0.0;
-    int count = 0;
-    
     // 统计所有轮次的最大角度
-    for (int i = 0; i < m_maxAngles.size(); ++i) {
-        if (m_maxAngles[i] != 0.0) {
-            sum += m_maxAngles[i];
-            count++;
-        }
-    }
-    
-    if (count > 0) {
-        double avgMaxAngle = sum / count;
+    if (store().maxAngleCount() > 0) {
+        double avgMaxAngle = store().averageMaxAngle(store().rounds() - 1);
         m_config.maxAngle = avgMaxAngle;
         qDebug() << "更新满量程角度为" << m_totalRounds << "轮平均值:" << avgMaxAngle << "度";
         
@@ -2252,57 +1893,28 @@ QString ErrorTableDialog::generateMultiRoundExportData()
 {
     QString result;
     
-    // 生成标题行
+    // 生成标题行：每个检测点每轮每个行程一个读数
     QStringList headers;
     headers << "检测点";
-    
-    // 为每轮添加标题列
     for (int round = 1; round <= m_totalRounds; ++round) {
-        for (int measurement = 1; measurement <= m_maxMeasurementsPerRound; ++measurement) {
-            headers << QString("第%1轮第%2次正行程").arg(round).arg(measurement);
-        }
-        for (int measurement = 1; measurement <= m_maxMeasurementsPerRound; ++measurement) {
-            headers << QString("第%1轮第%2次反行程").arg(round).arg(measurement);
-        }
+        headers << QString("第%1轮正行程").arg(round) << QString("第%1轮反行程").arg(round);
     }
     
     result = headers.join(",") + "\n";
     
     // 为每个检测点生成数据行
-    for (int pointIndex = 0; pointIndex < m_detectionData.size(); ++pointIndex) {
-        const DetectionPoint &point = m_detectionData[pointIndex];
+    const MeasurementStore &data = store();
+    for (int pointIndex = 0; pointIndex < pointCount(); ++pointIndex) {
         QStringList rowData;
         
         // 检测点压力值
-        rowData << QString::number(point.pressure, 'f', 1);
+        rowData << QString::number(m_config.detectionPoints[pointIndex], 'f', 1);
         
         // 遍历所有轮次数据
         for (int round = 0; round < m_totalRounds; ++round) {
-            if (round < point.roundData.size()) {
-                const MeasurementData &roundData = point.roundData[round];
-                
-                // 正行程数据
-                for (int measurement = 0; measurement < m_maxMeasurementsPerRound; ++measurement) {
-                    if (measurement < roundData.forwardAngles.size() && roundData.forwardAngles[measurement] != 0.0) {
-                        rowData << QString::number(roundData.forwardAngles[measurement], 'f', 2);
-                    } else {
-                        rowData << "--";
-                    }
-                }
-                
-                // 反行程数据
-                for (int measurement = 0; measurement < m_maxMeasurementsPerRound; ++measurement) {
-                    if (measurement < roundData.backwardAngles.size() && roundData.backwardAngles[measurement] != 0.0) {
-                        rowData << QString::number(roundData.backwardAngles[measurement], 'f', 2);
-                    } else {
-                        rowData << "--";
-                    }
-                }
-            } else {
-                // 如果该轮没有数据，填充空值
-                for (int i = 0; i < m_maxMeasurementsPerRound * 2; ++i) {
-                    rowData << "--";
-                }
+            for (int stroke : {MeasurementStore::Forward, MeasurementStore::Backward}) {
+                rowData << (data.valid(pointIndex, round, stroke)
+                            ? QString::number(data.angle(pointIndex, round, stroke), 'f', 2) : QString("--"));
             }
         }
         
@@ -2336,25 +1948,14 @@ void ErrorTableDialog::updateRoundInfoDisplay()
 {
     if (!m_roundInfoLabel) return;
     
-    if (m_currentRound >= 0 && m_currentRound < m_maxAngles.size()) {
-        // 统计当前轮次的数据量
+    if (m_currentRound >= 0 && m_currentRound < m_totalRounds) {
+        // 统计当前轮次的数据量：每个检测点正反行程各一个读数
+        const MeasurementStore &data = store();
         int totalData = 0;
-        int maxPossibleData = m_detectionData.size() * m_maxMeasurementsPerRound * 2; // 正反行程
-        
-        for (const DetectionPoint &point : m_detectionData) {
-            if (m_currentRound < point.roundData.size()) {
-                const MeasurementData &roundData = point.roundData[m_currentRound];
-                
-                // 计算正行程数据量
-                for (double angle : roundData.forwardAngles) {
-                    if (angle != 0.0) totalData++;
-                }
-                
-                // 计算反行程数据量
-                for (double angle : roundData.backwardAngles) {
-                    if (angle != 0.0) totalData++;
-                }
-            }
+        int maxPossibleData = pointCount() * 2;
+        for (int i = 0; i < pointCount(); ++i) {
+            totalData += int(data.valid(i, m_currentRound, MeasurementStore::Forward))
+                       + int(data.valid(i, m_currentRound, MeasurementStore::Backward));
         }
         
         m_roundInfoLabel->setText(QString("%1/%2 数据").arg(totalData).arg(maxPossibleData));
@@ -2389,98 +1990,104 @@ int ErrorTableDialog::getCurrentRound() const
     return m_currentRound;
 }
 
-// 批量设置主界面数据
-void ErrorTableDialog::setMainWindowData(const QVector<QVector<double>>& allRoundsForward, 
-                                        const QVector<QVector<double>>& allRoundsBackward, 
-                                        const QVector<double>& allRoundsMaxAngles)
+// ================== 订阅主界面的采集数据 ==================
+// 检测点 i 对应采集位 i。表格不留数据副本：会话的变化信号只标记要刷新的行，刷新时直接读会话。
+
+void ErrorTableDialog::setMeasurementSession(MeasurementSession *session)
 {
-    qDebug() << "开始批量设置主界面数据到误差表格";
-    
-    // 确保有足够的检测点数据
-    if (m_detectionData.isEmpty()) {
-        qDebug() << "检测点数据为空，无法设置数据";
-        return;
-    }
-    
-    // 根据表盘类型确定检测点数量
-    int detectionPointCount = m_detectionData.size();
-    qDebug() << "检测点数量:" << detectionPointCount;
-    
-    // 为每个检测点设置对应的数据
-    for (int pointIndex = 0; pointIndex < detectionPointCount; ++pointIndex) {
-        DetectionPoint &point = m_detectionData[pointIndex];
-        
-        // 确保轮次数据结构存在
-        if (point.roundData.size() != m_totalRounds) {
-            point.roundData.resize(m_totalRounds);
-        }
-        
-        // 设置所有轮次的数据
-        for (int round = 0; round < m_totalRounds; ++round) {
-            if (round < allRoundsForward.size() && round < allRoundsBackward.size()) {
-                // 初始化轮次数据
-                if (point.roundData[round].forwardAngles.size() != m_maxMeasurementsPerRound) {
-                    point.roundData[round].forwardAngles.resize(m_maxMeasurementsPerRound);
-                }
-                if (point.roundData[round].backwardAngles.size() != m_maxMeasurementsPerRound) {
-                    point.roundData[round].backwardAngles.resize(m_maxMeasurementsPerRound);
-                }
-                
-                // 清空当前轮次数据
-                point.roundData[round].forwardAngles.fill(0.0);
-                point.roundData[round].backwardAngles.fill(0.0);
-                
-                // 根据检测点索引获取对应的数据
-                // 检测点0对应采集数据1，检测点1对应采集数据2，以此类推
-                if (pointIndex < allRoundsForward[round].size()) {
-                    point.roundData[round].forwardAngles[0] = allRoundsForward[round][pointIndex];
-                }
-                
-                if (pointIndex < allRoundsBackward[round].size()) {
-                    point.roundData[round].backwardAngles[0] = allRoundsBackward[round][pointIndex];
-                }
-                
-                // 设置最大角度（所有检测点共享同一个最大角度）
-                if (round < allRoundsMaxAngles.size()) {
-                    point.roundData[round].maxAngle = allRoundsMaxAngles[round];
-                    if (round < m_maxAngles.size()) {
-                        m_maxAngles[round] = allRoundsMaxAngles[round];
-                    }
-                }
-                
-                // 设置完成状态
-                point.roundData[round].isCompleted = (allRoundsForward[round].size() > pointIndex || allRoundsBackward[round].size() > pointIndex);
-                
-                qDebug() << "检测点" << (pointIndex + 1) << "第" << (round + 1) << "轮: 正行程" 
-                         << point.roundData[round].forwardAngles[0] << ", 反行程" << point.roundData[round].backwardAngles[0];
-            }
-        }
-        
-        // 更新显示的数据（向后兼容）
-        if (!point.roundData.isEmpty() && m_currentRound < point.roundData.size()) {
-            const MeasurementData &currentRoundData = point.roundData[m_currentRound];
-            if (!currentRoundData.forwardAngles.isEmpty()) {
-                point.forwardAngle = currentRoundData.forwardAngles[0];
-                point.hasForward = (point.forwardAngle != 0.0);
-            }
-            if (!currentRoundData.backwardAngles.isEmpty()) {
-                point.backwardAngle = currentRoundData.backwardAngles[0];
-                point.hasBackward = (point.backwardAngle != 0.0);
-            }
-        }
-    }
-    
-    // 更新界面显示
+    if (m_session == session) return;
+    disconnect(&this->session(), nullptr, this, nullptr);
+    // 取消订阅时把正在显示的数据留在自己的会话里，关掉前窗口内容不变
+    if (!session && m_session) m_ownSession.load(m_session->data());
+    m_session = session;
+    connectSession(&this->session());
+}
+
+// 只接当前读的那个会话的信号，接上后整体重读一次
+void ErrorTableDialog::connectSession(MeasurementSession *session)
+{
+    connect(session, &MeasurementSession::angleChanged, this, &ErrorTableDialog::onSessionAngleChanged);
+    connect(session, &MeasurementSession::angleCleared, this, &ErrorTableDialog::onSessionAngleCleared);
+    connect(session, &MeasurementSession::maxAngleChanged, this, &ErrorTableDialog::onSessionMaxAngleChanged);
+    connect(session, &MeasurementSession::roundCleared, this, &ErrorTableDialog::onSessionRoundCleared);
+    connect(session, &MeasurementSession::layoutReset, this, &ErrorTableDialog::loadFromSession);
+    loadFromSession();
+}
+
+// 整体重读：首次订阅、主界面重新初始化或切换表位时
+void ErrorTableDialog::loadFromSession()
+{
+    qDebug() << "从采集会话整体读取数据到误差表格";
+
+    m_sessionRefreshTimer.stop();
+    m_dirtyRows.clear();
+    m_dirtyAllRows = false;
+    m_dirtyCurrentRound = false;
+
+    updateMaxAngleFromRounds();
     updateDataTable();
     updateCurrentRoundDisplay();
     updateRoundInfoDisplay();
-    
-    // 更新误差分析结果
     validateAndCheckErrors();
-    qDebug() << "批量数据设置完成";
+}
+
+void ErrorTableDialog::onSessionAngleChanged(int round, int stroke, int slot, double angle)
+{
+    Q_UNUSED(stroke);
+    Q_UNUSED(angle);
+    if (round < 0 || round >= m_totalRounds || slot < 0 || slot >= pointCount()) return;
+    scheduleSessionRefresh(round, slot);
+}
+
+void ErrorTableDialog::onSessionAngleCleared(int round, int stroke, int slot)
+{
+    Q_UNUSED(stroke);
+    if (round < 0 || round >= m_totalRounds || slot < 0 || slot >= pointCount()) return;
+    scheduleSessionRefresh(round, slot);
+}
 
-    //setFinalData();
+void ErrorTableDialog::onSessionMaxAngleChanged(int round, double angle)
+{
+    Q_UNUSED(angle);
+    if (round < 0 || round >= m_totalRounds) return;
+    updateMaxAngleFromRounds();
+    scheduleSessionRefresh(round, -1);   // 平均最大角度变了，整表的压力换算都跟着变
+}
 
+void ErrorTableDialog::onSessionRoundCleared(int round)
+{
+    if (round < 0 || round >= m_totalRounds) return;
+    scheduleSessionRefresh(round, -1);
+}
+
+// row < 0 表示整表都要刷新
+void ErrorTableDialog::scheduleSessionRefresh(int round, int row)
+{
+    if (row < 0) {
+        m_dirtyAllRows = true;
+    } else {
+        m_dirtyRows.insert(row);
+    }
+    if (round == m_currentRound) m_dirtyCurrentRound = true;
+    if (!m_sessionRefreshTimer.isActive()) m_sessionRefreshTimer.start();
+}
+
+void ErrorTableDialog::flushSessionRefresh()
+{
+    if (m_dirtyAllRows) {
+        updateDataTable();
+    } else if (!m_dirtyRows.isEmpty()) {
+        updateDataTableRows(&m_dirtyRows);
+    }
+    if (m_dirtyCurrentRound) {
+        updateRoundInfoDisplay();
+    }
+    m_dirtyRows.clear();
+    m_dirtyAllRows = false;
+    m_dirtyCurrentRound = false;
+
+    // 报告按轮缓存，只有版本号变了的轮次会重新生成
+    validateAndCheckErrors();
 }
 
 // ================== 新增的计算函数 ==================
@@ -2488,30 +2095,15 @@ void ErrorTableDialog::setMainWindowData(const QVector<QVector<double>>& allRoun
 // 计算指定检测点所有轮次正反行程角度的平均值 --需要使用
 double ErrorTableDialog::calculateAverageAngleForDetectionPoint(int pointIndex) const
 {
-    if (pointIndex < 0 || pointIndex >= m_detectionData.size()) {
-        return 0.0;
-    }
-    
-    const DetectionPoint &point = m_detectionData[pointIndex];
+    const MeasurementStore &data = store();
     double totalAngle = 0.0;
     int validCount = 0;
     
-    // 遍历所有轮次数据
-    for (int round = 0; round < point.roundData.size(); ++round) {
-        const MeasurementData &roundData = point.roundData[round];
-        
-        // 正行程数据
-        for (double angle : roundData.forwardAngles) {
-            if (angle != 0.0) {
-                totalAngle += angle;
-                validCount++;
-            }
-        }
-        
-        // 反行程数据
-        for (double angle : roundData.backwardAngles) {
-            if (angle != 0.0) {
-                totalAngle += angle;
+    // 遍历所有轮次的正/反行程数据
+    for (int round = 0; round < data.rounds(); ++round) {
+        for (int stroke : {MeasurementStore::Forward, MeasurementStore::Backward}) {
+            if (data.valid(pointIndex, round, stroke)) {
+                totalAngle += data.angle(pointIndex, round, stroke);
                 validCount++;
             }
         }
@@ -2523,94 +2115,33 @@ double ErrorTableDialog::calculateAverageAngleForDetectionPoint(int pointIndex)
 // 新增：计算"最终角度"（该检测点跨轮已完成"正+反"成对数据后的平均）
 double ErrorTableDialog::calculateFinalMeasuredAngleForDetectionPoint(int pointIndex) const
 {
-    if (pointIndex < 0 || pointIndex >= m_detectionData.size()) return 0.0;
-    const DetectionPoint &point = m_detectionData[pointIndex];
-    double totalPairMean = 0.0;
-    int pairCount = 0;
-
-    for (int round = 0; round < point.roundData.size(); ++round) {
-        const MeasurementData &rd = point.roundData[round];
-        double fwd = 0.0, bwd = 0.0;
-        bool hasF = false, hasB = false;
-        for (double a : rd.forwardAngles) { if (a != 0.0) { fwd = a; hasF = true; break; } }
-        for (double a : rd.backwardAngles){ if (a != 0.0) { bwd = a; hasB = true; break; } }
-        if (hasF && hasB) {
-            totalPairMean += 0.5 * (fwd + bwd);
-            pairCount++;
-        }
-    }
-    return (pairCount > 0) ? (totalPairMean / pairCount) : 0.0;
+    // 成对数据的和/个数在写入会话时增量维护
+    if (pointIndex < 0 || pointIndex >= store().points()) return 0.0;
+    return store().pairMean(pointIndex);
 }
 
 // 检查是否所有轮次都已完成
 bool ErrorTableDialog::isAllRoundsCompleted() const
 {
-    // 检查是否有至少一轮的最大角度数据
-    bool hasMaxAngleData = false;
-    for (double maxAngle : m_maxAngles) {
-        if (maxAngle != 0.0) {
-            hasMaxAngleData = true;
-            break;
-        }
-    }
-    
-    if (!hasMaxAngleData) {
-        return false;
-    }
-    
-    // 检查所有检测点是否都有数据
-    for (const DetectionPoint &point : m_detectionData) {
-        for (int round = 0; round < point.roundData.size(); ++round) {
-            const MeasurementData &roundData = point.roundData[round];
-            
-            // 检查是否有正行程或反行程数据
-            bool hasData = false;
-            for (double angle : roundData.forwardAngles) {
-                if (angle != 0.0) {
-                    hasData = true;
-                    break;
-                }
-            }
-            if (!hasData) {
-                for (double angle : roundData.backwardAngles) {
-                    if (angle != 0.0) {
-                        hasData = true;
-                        break;
-                    }
-                }
-            }
-            
-            if (!hasData) {
+    // 至少有一轮最大角度数据，且每个检测点每一轮都有正行程或反行程数据（两项计数都在会话的存储里维护）
+    const MeasurementStore &data = store();
+    if (data.maxAngleCount() == 0) return false;
+    if (data.points() == pointCount() && data.rounds() == m_totalRounds) return data.allCellsHaveData();
+    // 检测点数和会话的采集位数不一致（改过检测点配置）：只看表格里的检测点
+    for (int i = 0; i < pointCount(); ++i) {
+        for (int round = 0; round < m_totalRounds; ++round) {
+            if (!data.valid(i, round, MeasurementStore::Forward) && !data.valid(i, round, MeasurementStore::Backward))
                 return false;
-            }
         }
     }
-    
     return true;
 }
 
 // 获取固定迟滞误差值和以及行程误差值
 double ErrorTableDialog::getFixedHysteresisError(int pointIndex) const
 {
-    if (m_config.productModel == "YYQY-13") {
-        // YYQY表盘：第一个检测点0.1，其他都是0.3
-        if (pointIndex == 0) {
-            return 0.1;
-        } else {
-            return 0.3;
-        }
-    } else if (m_config.productModel == "BYQ-19") {
-        // BYQ表盘：根据检测点返回固定值
-        switch (pointIndex) {
-            case 0: return 0.5;  // 检测点0
-            case 1: return 1.0;  // 检测点5
-            case 2: return 2.0;  // 检测点10
-            case 3: return 1.0;  // 检测点15
-            case 4: return 2.0;  // 检测点20
-            default: return 0.0;
-        }
-    }
-    return 0.0;
+    // 限值表与批量报表共用（gaugereport）
+    return modelPointErrorLimitMPa(m_config.productModel, pointIndex);
 }
 
 // 计算迟滞误差角度
@@ -2666,7 +2197,7 @@ void ErrorTableDialog::setFinalData() {
     }
 
     // 3. 检查是否每个检测点都有有效的最终角度
-    for (int i = 0; i < m_detectionData.size(); i++) {
+    for (int i = 0; i < pointCount(); i++) {
         double finalAngle = calculateFinalMeasuredAngleForDetectionPoint(i);
         if(i == 0 && finalAngle >= 4.5 && finalAngle <= -4.5)  return;
     }
@@ -2690,7 +2221,26 @@ void ErrorTableDialog::setFinalData() {
     }
 }
 
-// 构造 BYQ_final_data：收集当前检测点（按 m_detectionData 顺序）并使用实测平均最大角度
+// 只有几个检测点的读数变了：平均最大角度没变（变了会整表刷新走 setFinalData），只改这几个点的最终角度
+void ErrorTableDialog::updateFinalDataPoints(const QSet<int> &rows)
+{
+    auto patch = [&](QVector<double> &pointsAngle) {
+        if (pointsAngle.size() != pointCount()) return false;
+        for (int i : rows) {
+            if (i < 0 || i >= pointCount()) continue;
+            double finalAng = calculateFinalMeasuredAngleForDetectionPoint(i);
+            if (finalAng <= 0.0) finalAng = pressureToAngle(m_config.detectionPoints[i]);
+            pointsAngle[i] = finalAng;
+        }
+        return true;
+    };
+    const bool patched = (m_config.productModel == "YYQY-13") ? patch(m_yyqyFinalData.pointsAngle)
+                       : (m_config.productModel == "BYQ-19") ? patch(m_byqFinalData.pointsAngle)
+                       : true;
+    if (!patched) setFinalData();   // 还没建过或检测点数变了
+}
+
+// 构造 BYQ_final_data：收集当前检测点（按检测点顺序）并使用实测平均最大角度
 BYQ_final_data ErrorTableDialog::buildBYQFinalData() const
 {
     BYQ_final_data out;
@@ -2700,14 +2250,14 @@ BYQ_final_data ErrorTableDialog::buildBYQFinalData() const
     out.points.clear();
     out.pointsAngle.clear();
 
-    for (int i = 0; i < m_detectionData.size(); ++i) {
-        const DetectionPoint &pt = m_detectionData[i];
-        out.points.append(pt.pressure);
+    for (int i = 0; i < pointCount(); ++i) {
+        const double pressure = m_config.detectionPoints[i];
+        out.points.append(pressure);
         // 最终角度按现有逻辑计算（跨轮正反成对平均）
         double finalAng = calculateFinalMeasuredAngleForDetectionPoint(i);
         if (finalAng <= 0.0) {
             // 回退：使用理论角度（以配置的满量程角为基准）
-            finalAng = pressureToAngle(pt.pressure);
+            finalAng = pressureToAngle(pressure);
         }
         out.pointsAngle.append(finalAng);
     }
@@ -2725,14 +2275,14 @@ YYQY_final_data ErrorTableDialog::buildYYQYFinalData() const
     out.points.clear();
     out.pointsAngle.clear();
 
-    // 如果是 YYQY 型号，则直接按 m_detectionData 顺序输出
+    // 如果是 YYQY 型号，则直接按检测点顺序输出
     // 否则也按现有检测点列表输出，调用者可根据型号选择使用哪个函数
-    for (int i = 0; i < m_detectionData.size(); ++i) {
-        const DetectionPoint &pt = m_detectionData[i];
-        out.points.append(pt.pressure);
+    for (int i = 0; i < pointCount(); ++i) {
+        const double pressure = m_config.detectionPoints[i];
+        out.points.append(pressure);
         double finalAng = calculateFinalMeasuredAngleForDetectionPoint(i);
         if (finalAng <= 0.0) {
-            finalAng = pressureToAngle(pt.pressure);
+            finalAng = pressureToAngle(pressure);
         }
         out.pointsAngle.append(finalAng);
     }
@@ -25,33 +25,18 @@
 #include <QStandardPaths>
 #include <QCheckBox>
 #include <QTimer>
+#include <QTableView>
+#include <QTextFrame>
+#include <QPointer>
+#include <QSet>
 
+#include "errortablemodel.h"
+#include "sessiondatabase.h"
+#include "analysis/measurementstore.h"
+#include "measurementsession.h"
+#include "sessionfile.h"
 
 
-// 单次测量数据结构（与主界面RoundData保持一致）
-struct MeasurementData {
-    QVector<double> forwardAngles;    // 正行程角度数据（YYQY每轮6次，BYQ每轮5次）
-    QVector<double> backwardAngles;   // 反行程角度数据（YYQY每轮6次，BYQ每轮5次）
-    double maxAngle;                  // 该轮次最大角度测量值
-    bool isCompleted;                 // 该轮是否完成
-    
-    MeasurementData() : maxAngle(0.0), isCompleted(false) {}
-};
-
-// 检测点数据结构
-struct DetectionPoint {
-    double pressure;                     // 压力值(MPa)
-    QVector<MeasurementData> roundData;  // 5轮测量数据
-    double forwardAngle;                 // 当前正行程角度（向后兼容）
-    double backwardAngle;                // 当前反行程角度（向后兼容）
-    bool hasForward;                     // 是否有正行程数据（向后兼容）
-    bool hasBackward;                    // 是否有反行程数据（向后兼容）
-    
-    DetectionPoint() : pressure(0.0), forwardAngle(0.0), backwardAngle(0.0), 
-                      hasForward(false), hasBackward(false) {
-        roundData.resize(5);  // 预分配5轮数据
-    }
-};
 
 // 压力表配置参数
 struct PressureGaugeConfig {
@@ -124,10 +109,9 @@ public:
     void setTotalRounds(int rounds);  // 设置总轮数
     int getTotalRounds() const;       // 获取总轮数
     
-    // 批量设置主界面数据
-    void setMainWindowData(const QVector<QVector<double>>& allRoundsForward, 
-                          const QVector<QVector<double>>& allRoundsBackward, 
-                          const QVector<double>& allRoundsMaxAngles);
+    // 订阅主界面的采集数据：先整体读一次，之后按"第 r 轮某行程第 i 个采集位"增量更新；
+    // 传 nullptr 取消订阅，改用表格自己的会话（保留当前显示的数据）
+    void setMeasurementSession(MeasurementSession *session);
     void clearAllData();
 
     void setFinalData();  // 新增：构造并保存最终数据（BYQ/YYQY）
@@ -140,6 +124,11 @@ public:
     BYQ_final_data buildBYQFinalData() const;
     YYQY_final_data buildYYQYFinalData() const;
 
+signals:
+    // 表格里手动修改了某检测点当前轮的正/反行程角度（主界面据此更新会话并记日志）
+    void angleEdited(int pointIndex, bool forward, double value);
+    // 订阅主界面时按了"清空"：数据归主界面的会话，由主界面确认、清空并记日志
+    void clearRequested();
 
 private slots:
     void onConfigChanged();
@@ -148,12 +137,21 @@ private slots:
     // void calculateErrors();
     void exportToExcel();
     void saveConfig();
-    void onTableCellClicked(int row, int column);
-    void onDataTableCellChanged(int row, int column);
+    void showSessionHistory();
+    void onTableCellClicked(const QModelIndex &index);
+    void onDataTableCellChanged(int row, int column, double value);
     void validateAndCheckErrors();
     
     // 轮次切换相关槽函数
     void onRoundChanged(int roundIndex);    // 轮次切换槽函数
+    
+    // 采集数据变化（来自 MeasurementSession）
+    void loadFromSession();
+    void onSessionAngleChanged(int round, int stroke, int slot, double angle);
+    void onSessionAngleCleared(int round, int stroke, int slot);
+    void onSessionMaxAngleChanged(int round, double angle);
+    void onSessionRoundCleared(int round);
+    void flushSessionRefresh();
 
 private:
     // UI组件
@@ -178,7 +176,8 @@ private:
     
     // 数据表格
     QGroupBox *m_dataGroup;
-    QTableWidget *m_dataTable;
+    QTableView *m_dataTable = nullptr;
+    ErrorDataTableModel *m_dataModel = nullptr;
     QLabel *m_currentPointLabel;
     
     // 轮次切换界面
@@ -188,7 +187,7 @@ private:
     
     // 误差分析结果
     QGroupBox *m_analysisGroup;
-    QTextEdit *m_analysisText;
+    QTextEdit *m_analysisText = nullptr;
     
     // 操作按钮
     QHBoxLayout *m_buttonLayout;
@@ -198,12 +197,12 @@ private:
     QPushButton *m_exportExcelBtn;
     // QPushButton *m_exportTextBtn;  // 用户要求移除
     QPushButton *m_saveConfigBtn;
+    QPushButton *m_historyBtn;
     // QPushButton *m_loadConfigBtn;   // 用户要求移除
     QPushButton *m_closeBtn;
     
     // 数据
-    PressureGaugeConfig m_config;     //压力表使用的配置
-    QList<DetectionPoint> m_detectionData;    //多个点的完整数据
+    PressureGaugeConfig m_config;     //压力表使用的配置（检测点 i 就是会话的采集位 i）
 
     int m_currentPressureIndex;
     bool m_isForwardDirection;
@@ -213,7 +212,36 @@ private:
     int m_currentRound;              // 当前轮次（0到m_totalRounds-1）
     int m_totalRounds;               // 总轮数（可配置，默认5轮）
     int m_maxMeasurementsPerRound;   // 每轮最大测量次数（YYQY=6, BYQ=5）
-    QVector<double> m_maxAngles;     // 每轮的最大角度测量值
+    
+    // 测量数据只存在会话里（每个检测点每轮每个行程一个角度 + 每轮最大角度），表格和报告都通过下面的访问函数读。
+    // 订阅了主界面就读主界面当前表位的会话，否则（单独打开、从文件恢复）读自己的会话。
+    MeasurementSession m_ownSession;
+    QPointer<MeasurementSession> m_session;  // 订阅的会话；为空时用 m_ownSession
+    MeasurementSession &session() { return m_session ? *m_session : m_ownSession; }
+    const MeasurementSession &session() const { return m_session ? *m_session : m_ownSession; }
+    const MeasurementStore &store() const { return session().store(); }
+    int pointCount() const { return m_config.detectionPoints.size(); }
+    void connectSession(MeasurementSession *session);
+    void resizeOwnSession();                 // 自己的会话按当前轮数/检测点数调整形状，保留已有数据
+    void remapOwnSessionByPressure(const QVector<double> &oldPoints);   // 检测点改了：自己的会话数据按压力对到新检测点
+    void writeAngle(int pointIndex, bool forward, double value);   // 表格里的写入：订阅时交给主界面写
+    
+    // 连续几格变化（如扫描结果整轮写入）合并到下一次事件循环统一刷新界面
+    QTimer m_sessionRefreshTimer;
+    QSet<int> m_dirtyRows;                   // 只需重填的数据表行
+    bool m_dirtyAllRows = false;
+    bool m_dirtyCurrentRound = false;        // 当前轮的数据量显示要更新
+    void scheduleSessionRefresh(int round, int row);
+    // 数据表上次整表刷新时的阶段；阶段没变时单格变化只影响对应检测点那一行
+    bool m_tableAllCompleted = false;
+    double m_tableFsAngle = 0.0;
+    double m_tableConfigMaxAngle = 0.0;
+    ErrorField m_tableErrors;                // 数据表的误差列，每次刷新用误差核整体算一遍
+    
+    // 检测记录数据库：每块表一条记录，自动保存时写入/更新
+    SessionDatabase m_sessionDb;
+    qint64 m_dbSessionId = -1;       // 当前这块表在数据库里的记录，<0 表示还没写过
+    QDateTime m_sessionStartedAt;
     
     // 私有方法
     void setupUI();
@@ -228,6 +256,8 @@ private:
     void updateUIFromConfig();
     void updateDetectionPointsTable();
     void updateDataTable();
+    void updateDataTableRows(const QSet<int> *rows);   // rows 为空指针时整表刷新；否则只重算这几行
+    void updateFinalDataPoints(const QSet<int> &rows); // 最终数据里只更新这几个检测点的角度
     void updateAnalysisText();
     
     
@@ -248,9 +278,48 @@ private:
     double calculateHysteresisAngle(int pointIndex) const;
     
     QString formatAnalysisResult();
+
+    // 误差分析报告：按轮缓存片段，只重算/重绘输入变化的轮次
+    struct ReportContext {
+        bool completedAll = false;
+        double avgMaxAngle = 0.0;
+        double fsPressure = 0.0;
+        QVector<double> expectedAngles;    // 各检测点的比较基准角度
+        QVector<double> fixedHysteresis;   // 各检测点的迟滞限值(MPa)
+        ErrorField errors;                 // 按平均最大角度换算的整表误差
+        size_t signature = 0;
+    };
+    struct RoundReport {
+        bool computed = false;
+        size_t signature = 0;   // 本轮输入摘要
+        bool hasData = false;
+        int validCount = 0;
+        bool allValid = true;
+        bool precheckOk = true;
+        QString html;
+    };
+    ReportContext buildReportContext() const;
+    size_t roundSignature(int round) const;
+    QString formatReportHeader() const;
+    QString formatReportSummary() const;
+    void formatRoundAnalysis(int round, const ReportContext &ctx, RoundReport &rep) const;
+    void renderAnalysisDocument(const QVector<int> &dirtyRounds);
+
+    QVector<RoundReport> m_roundReports;
+    size_t m_reportContextSig = 0;
+    QVector<int> m_reportLayout;                  // 文档里当前有片段的轮次
+    QTextFrame *m_reportHeaderFrame = nullptr;
+    QTextFrame *m_reportSummaryFrame = nullptr;
+    QVector<QTextFrame*> m_reportRoundFrames;
+    QString m_reportHeaderHtml;
+    QString m_reportSummaryHtml;
     QString generateExportData();
     
+    static QString autoSaveFilePath(bool forLoad);   // forLoad 时没有二进制文件就退回老的 JSON
+    SessionFileData buildSessionFileData() const;
     void saveConfigToFile(const QString &fileName);
+    SessionRecord buildSessionRecord() const;
+    bool archiveSession();
     void loadConfigFromFile(const QString &fileName);
     void autoLoadPreviousData();
     void checkAndLoadPreviousData();
@@ -0,0 +1,133 @@
+#include "errortablemodel.h"
+
+#include <QBrush>
+#include <QColor>
+#include <cmath>
+
+ErrorDataTableModel::ErrorDataTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int ErrorDataTableModel::precision(int column)
+{
+    switch (column) {
+    case ColPressure:
+        return 1;
+    case ColForwardErr:
+    case ColBackwardErr:
+    case ColHysteresisErr:
+        return 3;
+    default:
+        return 2;
+    }
+}
+
+bool ErrorDataTableModel::sameDisplay(const Cell &a, const Cell &b, int column)
+{
+    if (a.valid != b.valid) return false;
+    if (!a.valid) return true;
+    // 按显示精度比较：界面上看不出差别的变化不触发重绘
+    const double scale = std::pow(10.0, precision(column));
+    return std::llround(a.value * scale) == std::llround(b.value * scale);
+}
+
+void ErrorDataTableModel::setRowCount(int rows)
+{
+    if (rows < 0 || rows == m_rows.size()) return;
+    beginResetModel();
+    m_rows.resize(rows);
+    endResetModel();
+}
+
+void ErrorDataTableModel::setRow(int row, const Row &cells)
+{
+    if (row < 0 || row >= m_rows.size()) return;
+
+    Row &cur = m_rows[row];
+    int first = -1, last = -1;
+    for (int c = 0; c < ColumnCount; ++c) {
+        // 新值总是存下（EditRole、导出要用准确值），只是显示不变的格子不发通知
+        const bool unchanged = sameDisplay(cur[c], cells[c], c);
+        cur[c] = cells[c];
+        if (unchanged) continue;
+        if (first < 0) first = c;
+        last = c;
+    }
+    if (first >= 0) emit dataChanged(index(row, first), index(row, last), {Qt::DisplayRole, Qt::EditRole});
+}
+
+void ErrorDataTableModel::setCell(int row, int column, double value, bool valid)
+{
+    if (row < 0 || row >= m_rows.size() || column < 0 || column >= ColumnCount) return;
+
+    Cell next;
+    next.value = value;
+    next.valid = valid;
+    const bool unchanged = sameDisplay(m_rows[row][column], next, column);
+    m_rows[row][column] = next;
+    if (unchanged) return;
+    const QModelIndex idx = index(row, column);
+    emit dataChanged(idx, idx, {Qt::DisplayRole, Qt::EditRole});
+}
+
+int ErrorDataTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int ErrorDataTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ErrorDataTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) return QVariant();
+    const Cell &c = m_rows[index.row()][index.column()];
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return c.valid ? QString::number(c.value, 'f', precision(index.column())) : QString("--");
+    case Qt::EditRole:
+        return c.valid ? QVariant(c.value) : QVariant(QString());
+    case Qt::BackgroundRole:
+        // 淡绿色 = 可编辑（正/反行程角度），淡灰色 = 只读
+        return isEditableColumn(index.column()) ? QBrush(QColor(230, 255, 230)) : QBrush(QColor(245, 245, 245));
+    default:
+        return QVariant();
+    }
+}
+
+QVariant ErrorDataTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+    if (orientation == Qt::Vertical) return section + 1;
+
+    static const char *headers[ColumnCount] = {
+        "检测点(MPa)", "最终角度(°)", "正行程角度(°)", "正行程角度误差(°)", "正行程误差(MPa)",
+        "反行程角度(°)", "反行程角度误差(°)", "反行程误差(MPa)", "迟滞误差角度(°)", "迟滞误差(MPa)"
+    };
+    return (section >= 0 && section < ColumnCount) ? QString::fromUtf8(headers[section]) : QVariant();
+}
+
+Qt::ItemFlags ErrorDataTableModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) return Qt::NoItemFlags;
+    Qt::ItemFlags f = Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+    if (isEditableColumn(index.column())) f |= Qt::ItemIsEditable;
+    return f;
+}
+
+bool ErrorDataTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (role != Qt::EditRole || !index.isValid() || !isEditableColumn(index.column())) return false;
+
+    bool ok = false;
+    const double v = value.toString().toDouble(&ok);
+    if (!ok) return false;
+
+    setCell(index.row(), index.column(), v);
+    emit angleEdited(index.row(), index.column(), v);
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef ERRORTABLEMODEL_H
+#define ERRORTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include <array>
+
+// 误差表"采集数据"区的表格模型。
+// 每个单元格只存数值+是否有效（无效显示"--"），文字在 data() 里按列精度现格式化；
+// 写入时总是保存新值，但按显示精度比较，只有显示结果变了的单元格才发 dataChanged，
+// 每确认一个读数不再重建整张表、也不再反复 new 单元格对象。
+class ErrorDataTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        ColPressure = 0,        // 检测点(MPa)
+        ColFinalAngle,          // 最终角度
+        ColForwardAngle,        // 正行程角度（可编辑）
+        ColForwardAngleErr,     // 正行程角度误差
+        ColForwardErr,          // 正行程误差(MPa)
+        ColBackwardAngle,       // 反行程角度（可编辑）
+        ColBackwardAngleErr,    // 反行程角度误差
+        ColBackwardErr,         // 反行程误差(MPa)
+        ColHysteresisAngle,     // 迟滞误差角度
+        ColHysteresisErr,       // 迟滞误差(MPa)
+        ColumnCount
+    };
+
+    struct Cell {
+        double value = 0.0;
+        bool valid = false;
+    };
+    using Row = std::array<Cell, ColumnCount>;
+
+    explicit ErrorDataTableModel(QObject *parent = nullptr);
+
+    // 行数变化时才重置模型（检测点配置改变），平时只做单元格级更新
+    void setRowCount(int rows);
+    // 整行写入：与旧值逐格比较，只对变化的列区间发一次 dataChanged
+    void setRow(int row, const Row &cells);
+    void setCell(int row, int column, double value, bool valid = true);
+    const Cell &cell(int row, int column) const { return m_rows[row][column]; }
+
+    static bool isEditableColumn(int column) { return column == ColForwardAngle || column == ColBackwardAngle; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+
+signals:
+    // 用户在表格里手动修改了正/反行程角度
+    void angleEdited(int row, int column, double value);
+
+private:
+    static int precision(int column);
+    static bool sameDisplay(const Cell &a, const Cell &b, int column);
+
+    QVector<Row> m_rows;
+};
+
+#endif // ERRORTABLEMODEL_H
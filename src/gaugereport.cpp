@@ -0,0 +1,208 @@
+#include "gaugereport.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+#include "analysis/measurementstore.h"
+
+namespace {
+
+// 与误差表格里的换算一致：压力 = 角度 / 满量程角度 × 满量程压力
+double angleToPressureByFS(double angleErrDeg, double fsAngleDeg, double fsPressureMPa)
+{
+    if (fsAngleDeg <= 0.0) return 0.0;
+    return (angleErrDeg / fsAngleDeg) * fsPressureMPa;
+}
+
+QString angleText(double v) { return QString::number(v, 'f', 2); }
+QString mpaText(double v) { return QString::number(v, 'f', 3); }
+
+// 一行：标题 + 各检测点 + 三个空列（与原 CSV 的 ",,," 结尾一致）
+QStringList pointRow(const QString& title, const QStringList& values)
+{
+    QStringList row;
+    row << title << values << QString() << QString() << QString();
+    return row;
+}
+
+} // namespace
+
+double modelFullScalePressureMPa(const QString& productModel, double fallback)
+{
+    if (productModel == "YYQY-13") return 6.3;
+    if (productModel == "BYQ-19") return 25.0;
+    return fallback;
+}
+
+double modelPointErrorLimitMPa(const QString& productModel, int pointIndex)
+{
+    if (productModel == "YYQY-13") {
+        // YYQY表盘：第一个检测点0.1，其他都是0.3
+        return pointIndex == 0 ? 0.1 : 0.3;
+    }
+    if (productModel == "BYQ-19") {
+        // BYQ表盘：检测点 0/5/10/15/20 MPa
+        switch (pointIndex) {
+            case 0: return 0.5;
+            case 1: return 1.0;
+            case 2: return 2.0;
+            case 3: return 1.0;
+            case 4: return 2.0;
+            default: return 0.0;
+        }
+    }
+    return 0.0;
+}
+
+GaugeReport buildGaugeReport(const SessionRecord& rec, double nominalFsAngle, double nominalFsPressure)
+{
+    const int P = rec.detectionPoints.size();
+    const int R = qMax(0, rec.totalRounds);
+
+    // 读数按 (检测点, 轮, 行程) 放进存储，同一格有多次时取序号最小的那次（与表格"取第一个非零值"一致）
+    MeasurementStore store(P, R);
+    std::vector<int> firstSeq(size_t(P) * R * MeasurementStore::StrokeCount, INT_MAX);
+    for (const SessionReading& r : rec.readings) {
+        if (r.pointIndex < 0 || r.pointIndex >= P || r.round < 0 || r.round >= R || r.angle == 0.0) continue;
+        const int stroke = r.stroke > 0 ? MeasurementStore::Forward : MeasurementStore::Backward;
+        int& seq = firstSeq[(size_t(stroke) * R + r.round) * P + r.pointIndex];
+        if (r.seq >= seq) continue;
+        seq = r.seq;
+        store.set(r.pointIndex, r.round, stroke, r.angle);
+    }
+    for (int round = 0; round < R && round < rec.roundMaxAngles.size(); ++round) {
+        store.setMaxAngle(round, rec.roundMaxAngles[round]);
+    }
+
+    const bool allCompleted = store.maxAngleCount() > 0 && store.allCellsHaveData();
+    const double fsPressure = rec.maxPressure;
+    auto nominalAngle = [&](double pressure) {
+        return nominalFsPressure > 0.0 ? (pressure / nominalFsPressure) * nominalFsAngle : 0.0;
+    };
+    auto roundFsAngle = [&](int round) {
+        if (allCompleted) return rec.avgMaxAngle;
+        return round < rec.roundMaxAngles.size() ? rec.roundMaxAngles[round] : 0.0;
+    };
+
+    GaugeReport report;
+    QVector<QStringList>& rows = report.rows;
+    rows.reserve(8 + R * 10 + 2);
+    rows << QStringList{"产品型号：", rec.productModel, "", "产品名称：", rec.productName, "", "", ""};
+    rows << QStringList{"刻度盘图号：", rec.dialDrawingNo, "", "支组编号：", rec.groupNo, "", "", ""};
+    rows << QStringList{"平均最大总角度：", angleText(rec.avgMaxAngle), "", "", ""};
+    rows << QStringList();
+
+    // 比较基准：跨轮"正+反"的平均角度，没有成对数据时用名义角度
+    QVector<double> expected(P);
+    QStringList pointTexts, pointAngles;
+    for (int i = 0; i < P; ++i) {
+        const double pressure = rec.detectionPoints[i];
+        const double finalAngle = store.pairMean(i);
+        expected[i] = (finalAngle > 0.0) ? finalAngle : nominalAngle(pressure);
+        pointTexts << QString::number(pressure, 'f', 1);
+        pointAngles << angleText(finalAngle != 0.0 ? finalAngle : nominalAngle(pressure));
+    }
+    rows << pointRow("检测点", pointTexts);
+    report.pointAngles = expected;
+    rows << pointRow("检测点对应的刻度盘角度", pointAngles);
+    rows << QStringList();
+
+    for (int round = 0; round < R; ++round) {
+        const double fsAngle = roundFsAngle(round);
+        QStringList fwd, fwdErr, fwdMPa, bwd, bwdErr, bwdMPa, hystAngle, hystMPa;
+        for (int i = 0; i < P; ++i) {
+            const bool hasF = store.valid(i, round, MeasurementStore::Forward);
+            const bool hasB = store.valid(i, round, MeasurementStore::Backward);
+            const double f = store.angle(i, round, MeasurementStore::Forward);
+            const double b = store.angle(i, round, MeasurementStore::Backward);
+
+            if (hasF) {
+                const double err = f - expected[i];
+                fwd << angleText(f);
+                fwdErr << angleText(err);
+                fwdMPa << mpaText(angleToPressureByFS(err, fsAngle, fsPressure));
+            } else {
+                fwd << "--";
+                fwdErr << "--";
+                fwdMPa << "--";
+            }
+            if (hasB) {
+                const double err = b - expected[i];
+                bwd << angleText(b);
+                bwdErr << angleText(err);
+                bwdMPa << mpaText(angleToPressureByFS(err, fsAngle, fsPressure));
+            } else {
+                bwd << "--";
+                bwdErr << "--";
+                bwdMPa << "--";
+            }
+            if (hasF && hasB) {
+                const double diff = std::abs(f - b);
+                hystAngle << angleText(diff);
+                hystMPa << mpaText(std::abs(angleToPressureByFS(diff, fsAngle, fsPressure)));
+            } else {
+                hystAngle << "--";
+                hystMPa << "--";
+            }
+        }
+
+        rows << QStringList{QString("第%1轮").arg(round + 1), "", "", "", ""};
+        rows << pointRow("正行程角度", fwd);
+        rows << pointRow("正行程角度误差", fwdErr);
+        rows << pointRow("正行程误差（MPa）", fwdMPa);
+        rows << pointRow("反行程角度", bwd);
+        rows << pointRow("反行程角度误差", bwdErr);
+        rows << pointRow("反行程误差（MPa）", bwdMPa);
+        rows << pointRow("该轮迟滞误差角度", hystAngle);
+        rows << pointRow("该轮迟滞误差（MPa）", hystMPa);
+        rows << QStringList();
+    }
+
+    // 跨轮平均迟滞（只算正反都有的轮次），统一按平均最大角度换算
+    QStringList hystAngles, hystPressures;
+    for (int i = 0; i < P; ++i) {
+        double total = 0.0;
+        int n = 0;
+        for (int round = 0; round < R; ++round) {
+            if (!store.valid(i, round, MeasurementStore::Forward) || !store.valid(i, round, MeasurementStore::Backward)) continue;
+            total += std::abs(store.angle(i, round, MeasurementStore::Forward) - store.angle(i, round, MeasurementStore::Backward));
+            ++n;
+        }
+        if (n > 0) {
+            const double avg = total / n;
+            hystAngles << angleText(avg);
+            hystPressures << mpaText(std::abs(angleToPressureByFS(avg, rec.avgMaxAngle, fsPressure)));
+        } else {
+            hystAngles << "--";
+            hystPressures << "--";
+        }
+    }
+    rows << pointRow("迟滞误差角度", hystAngles);
+    rows << pointRow("迟滞误差（MPa）", hystPressures);
+
+    // 合格判定：只有全部轮次完成后才有结论，统一按平均最大角度换算
+    report.completed = allCompleted;
+    report.pointMaxAbsErrMPa.fill(0.0, P);
+    if (!allCompleted) return report;
+
+    bool ok = true;
+    for (const SessionReading& r : rec.readings) {
+        if (r.pointIndex < 0 || r.pointIndex >= P || r.round < 0 || r.round >= R || r.angle == 0.0) continue;
+        const double err = std::abs(angleToPressureByFS(r.angle - expected[r.pointIndex], rec.avgMaxAngle, fsPressure));
+        report.maxAbsErrMPa = std::max(report.maxAbsErrMPa, err);
+        report.pointMaxAbsErrMPa[r.pointIndex] = std::max(report.pointMaxAbsErrMPa[r.pointIndex], err);
+        if (err > modelPointErrorLimitMPa(rec.productModel, r.pointIndex)) ok = false;
+    }
+    for (int round = 0; round < R; ++round) {
+        if (!store.hasMaxAngle(round)) continue;
+        for (int i = 0; i < P; ++i) {
+            if (!store.valid(i, round, MeasurementStore::Forward) || !store.valid(i, round, MeasurementStore::Backward)) continue;
+            const double diff = std::abs(store.angle(i, round, MeasurementStore::Forward) - store.angle(i, round, MeasurementStore::Backward));
+            if (angleToPressureByFS(diff, rec.avgMaxAngle, fsPressure) > modelPointErrorLimitMPa(rec.productModel, i)) ok = false;
+        }
+    }
+    report.passed = ok ? 1 : 0;
+    return report;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <QStringList>
+#include <QVector>
+
+#include "sessiondatabase.h"
+
+// ================== 单块表的导出报表与合格判定 ==================
+// 排版与"导出Excel"按钮、合格_.csv 相同：表头信息、检测点与对应角度，然后逐轮的正反行程角度/误差/迟滞，
+// 最后是跨轮平均迟滞。每个元素是一行单元格，空列表表示空行；数值已按界面精度格式化（角度两位、MPa 三位），
+// 没有数据的位置写 "--"。
+// 误差的计算口径与误差表格一致：全部轮次完成前按该轮最大角度换算压力（预检），完成后按平均最大角度；
+// 比较基准是该点跨轮"正+反"的平均角度，没有成对数据时用 压力/nominalFsPressure×nominalFsAngle。
+// 合格判定与误差表格的最终结论一致：每个读数的误差和每轮的正反行程差都不超过该检测点的限值。
+// 只用到记录里的数据，不依赖界面，可以在工作线程里并行调用。
+
+struct GaugeReport {
+    QVector<QStringList> rows;
+    bool completed = false;              // 全部轮次都有数据
+    int passed = -1;                     // -1=未完成 0=不合格 1=合格
+    double maxAbsErrMPa = 0.0;           // 完成后所有读数里最大的 |误差|
+    QVector<double> pointMaxAbsErrMPa;   // 各检测点的最大 |误差|
+    QVector<double> pointAngles;         // 各检测点的刻度盘角度（比较基准，和误差表格"最终数据"同一口径，出表盘用）
+};
+
+GaugeReport buildGaugeReport(const SessionRecord& rec, double nominalFsAngle, double nominalFsPressure);
+
+// 按型号的满量程压力（MPa）：YYQY-13=6.3，BYQ-19=25，其他用 fallback
+double modelFullScalePressureMPa(const QString& productModel, double fallback);
+// 按型号、检测点序号的误差限值（MPa），基本误差和迟滞误差共用；未知型号返回 0
+double modelPointErrorLimitMPa(const QString& productModel, int pointIndex);
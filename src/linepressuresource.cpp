@@ -0,0 +1,162 @@
+#include "linepressuresource.h"
+
+#include <QDebug>
+#include <QTcpSocket>
+
+#ifdef HAS_QT_SERIALPORT
+#include <QSerialPort>
+#endif
+
+namespace {
+const std::int64_t kQueryTimeoutUs = 1000000;   // 1 秒没回复就重发
+const std::int64_t kStaleUs = 2000000;          // 超过 2 秒的读数不再使用
+const int kConnectTimeoutMs = 3000;
+} // namespace
+
+LinePressureSource::LinePressureSource(const QString& address)
+    : m_address(address.trimmed())
+{
+}
+
+LinePressureSource::~LinePressureSource()
+{
+    stop();
+}
+
+std::string LinePressureSource::name() const
+{
+    return QString("压力控制器(%1)").arg(m_address).toStdString();
+}
+
+bool LinePressureSource::serialSupported()
+{
+#ifdef HAS_QT_SERIALPORT
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LinePressureSource::start()
+{
+    stop();
+    m_lastError.clear();
+    m_latest = PressureReading();
+
+    if (m_address.startsWith("serial:", Qt::CaseInsensitive)) {
+#ifdef HAS_QT_SERIALPORT
+        QString port = m_address.mid(7);
+        int baud = 9600;
+        const int at = port.lastIndexOf('@');
+        if (at > 0) {
+            baud = port.mid(at + 1).toInt();
+            port = port.left(at);
+        }
+        auto serial = std::make_unique<QSerialPort>(port);
+        serial->setBaudRate(baud > 0 ? baud : 9600);
+        if (!serial->open(QIODevice::ReadWrite)) {
+            m_lastError = QString("串口 %1 打开失败: %2").arg(port, serial->errorString());
+            return false;
+        }
+        m_device = std::move(serial);
+#else
+        m_lastError = "当前构建没有 Qt SerialPort 模块，请改用 TCP 地址";
+        return false;
+#endif
+    } else {
+        const int colon = m_address.lastIndexOf(':');
+        const QString host = colon > 0 ? m_address.left(colon) : m_address;
+        const quint16 port = colon > 0 ? m_address.mid(colon + 1).toUShort() : 5025;
+        auto socket = std::make_unique<QTcpSocket>();
+        socket->connectToHost(host, port ? port : 5025);
+        if (!socket->waitForConnected(kConnectTimeoutMs)) {
+            m_lastError = QString("连接 %1 失败: %2").arg(m_address, socket->errorString());
+            return false;
+        }
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        m_device = std::move(socket);
+    }
+
+    QObject::connect(m_device.get(), &QIODevice::readyRead, [this]() { onReadyRead(); });
+    qDebug() << "压力控制器已连接:" << m_address;
+    return sendLine(QByteArray::fromStdString(PressureProtocol::measureQuery()));
+}
+
+void LinePressureSource::stop()
+{
+    if (!m_device) return;
+    m_device->disconnect();
+    m_device->waitForBytesWritten(500);   // 最后一条 SETP 发出去再关
+    m_device->close();
+    m_device.reset();
+    m_buffer.clear();
+    m_querySentUs = -1;
+}
+
+bool LinePressureSource::sendLine(const QByteArray& line)
+{
+    if (!m_device || !m_device->isOpen()) return false;
+    if (line.startsWith("MEAS?")) m_querySentUs = nowUs();
+    if (m_device->write(line + "\n") < 0) {
+        m_lastError = "发送失败: " + m_device->errorString();
+        return false;
+    }
+    return true;
+}
+
+void LinePressureSource::onReadyRead()
+{
+    m_buffer += m_device->readAll();
+    int nl;
+    while ((nl = m_buffer.indexOf('\n')) >= 0) {
+        handleLine(m_buffer.left(nl));
+        m_buffer.remove(0, nl + 1);
+    }
+    if (m_buffer.size() > 4096) m_buffer.clear();   // 对端乱发数据时别无限增长
+}
+
+void LinePressureSource::handleLine(const QByteArray& line)
+{
+    double p = 0.0;
+    if (PressureProtocol::parseMeasurement(line.toStdString(), p)) {
+        const std::int64_t now = nowUs();
+        m_latest.timestampUs = m_querySentUs >= 0 ? (m_querySentUs + now) / 2 : now;
+        m_latest.pressure = p;
+        m_latest.valid = true;
+        m_querySentUs = -1;
+    } else if (line.startsWith("ERR")) {
+        m_lastError = QString::fromUtf8(line.trimmed());
+        qDebug() << "压力控制器返回错误:" << m_lastError;
+    }
+}
+
+bool LinePressureSource::read(PressureReading& out)
+{
+    if (!m_device) {
+        out.valid = false;
+        return false;
+    }
+    // readyRead 还没派发时先把已到的数据处理掉
+    if (m_device->bytesAvailable() > 0) onReadyRead();
+
+    const std::int64_t now = nowUs();
+    if (m_querySentUs < 0 || now - m_querySentUs > kQueryTimeoutUs)
+        sendLine(QByteArray::fromStdString(PressureProtocol::measureQuery()));
+
+    if (!m_latest.valid || now - m_latest.timestampUs > kStaleUs) {
+        out.valid = false;
+        return false;
+    }
+    out = m_latest;
+    return true;
+}
+
+bool LinePressureSource::setTarget(double pressure)
+{
+    return sendLine(QByteArray::fromStdString(PressureProtocol::setTargetCommand(pressure)));
+}
+
+bool LinePressureSource::setRampRate(double mpaPerSec)
+{
+    return sendLine("RATE " + QByteArray::number(mpaPerSec, 'f', 4));
+}
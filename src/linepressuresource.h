@@ -0,0 +1,46 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <memory>
+
+#include "analysis/pressurecontroller.h"
+
+class QIODevice;
+
+// 通过文本行协议（见 analysis/pressurecontroller.h）连接压力控制器。
+// 地址格式：
+//   host:port                TCP，例如 127.0.0.1:5025（pressure_sim 默认端口）
+//   serial:<端口>[@波特率]    串口，例如 serial:COM3@9600、serial:/dev/pts/3（需要 Qt SerialPort）
+// 读数异步：read() 取最近一次回复，同时在没有未完成查询时发下一条 MEAS?，
+// 时间戳取查询发出与回复收到的中点。需要 Qt 事件循环（预览循环里的 processEvents 即可）。
+class LinePressureSource : public PressureSource {
+public:
+    explicit LinePressureSource(const QString& address);
+    ~LinePressureSource() override;
+
+    std::string name() const override;
+    bool start() override;
+    void stop() override;
+    bool read(PressureReading& out) override;
+    bool canControl() const override { return true; }
+    bool setTarget(double pressure) override;
+    std::string lastError() const override { return m_lastError.toStdString(); }
+
+    // 设置控制器升降速率（RATE 命令）
+    bool setRampRate(double mpaPerSec);
+
+    static bool serialSupported();
+
+private:
+    bool sendLine(const QByteArray& line);
+    void onReadyRead();
+    void handleLine(const QByteArray& line);
+
+    QString m_address;
+    std::unique_ptr<QIODevice> m_device;
+    QByteArray m_buffer;
+    QString m_lastError;
+
+    PressureReading m_latest;
+    std::int64_t m_querySentUs = -1;   // 未完成的 MEAS? 发出时间，-1 表示没有
+};
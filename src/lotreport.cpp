@@ -0,0 +1,354 @@
+#include "lotreport.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QSet>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <memory>
+
+#include "gaugereport.h"
+#include "sessionfile.h"
+#include "xlsxwriter.h"
+
+namespace {
+
+QString passedText(int passed)
+{
+    return passed < 0 ? QString("未完成") : (passed ? QString("合格") : QString("不合格"));
+}
+
+// 含逗号/引号/换行的字段才加引号，普通报表与界面导出的 CSV 逐字节相同
+QString csvLine(const QStringList& row)
+{
+    QStringList fields;
+    fields.reserve(row.size());
+    for (const QString& f : row) {
+        if (f.contains(',') || f.contains('"') || f.contains('\n')) {
+            fields << '"' + QString(f).replace("\"", "\"\"") + '"';
+        } else {
+            fields << f;
+        }
+    }
+    return fields.join(',');
+}
+
+} // namespace
+
+QString safeFileName(const QString& name)
+{
+    QString s = name.trimmed();
+    for (QChar& c : s) {
+        if (c.unicode() < 0x20 || QStringLiteral("\\/:*?\"<>|").contains(c)) c = '_';
+    }
+    return s;
+}
+
+QStringList uniqueFileKeys(const QStringList& keys)
+{
+    QStringList out;
+    out.reserve(keys.size());
+    QSet<QString> used;
+    for (const QString& k : keys) {
+        QString base = safeFileName(k);
+        if (base.isEmpty()) base = "未编号";
+        QString key = base;
+        for (int n = 2; used.contains(key.toLower()); ++n) key = QString("%1_%2").arg(base).arg(n);
+        used.insert(key.toLower());
+        out << key;
+    }
+    return out;
+}
+
+bool writeCsv(const QString& path, const QVector<QStringList>& rows, QString& error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        error = QString("无法创建文件 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    file.write("\xEF\xBB\xBF");
+    QTextStream out(&file);
+    out.setEncoding(QStringConverter::Utf8);
+    for (const QStringList& row : rows) out << csvLine(row) << "\n";
+    out.flush();
+    if (file.error() != QFileDevice::NoError) {
+        error = QString("写入 %1 失败: %2").arg(path, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+namespace {
+
+void assignUniqueKeys(QVector<LotGaugeResult>& gauges)
+{
+    QStringList keys;
+    for (const LotGaugeResult& g : gauges) keys << g.key;
+    keys = uniqueFileKeys(keys);
+    for (int i = 0; i < gauges.size(); ++i) gauges[i].key = keys[i];
+}
+
+bool writeXlsx(const QString& path, const QString& sheetName, const QVector<QStringList>& rows, QString& error)
+{
+    XlsxWriter writer;
+    if (writer.open(path)) {
+        writer.beginSheet(sheetName);
+        for (const QStringList& row : rows) writer.writeRow(row);
+        if (writer.close()) return true;
+    }
+    error = writer.errorString();
+    return false;
+}
+
+bool writeTable(const QString& path, bool xlsx, const QString& sheetName, const QVector<QStringList>& rows, QString& error)
+{
+    return xlsx ? writeXlsx(path, sheetName, rows, error) : writeCsv(path, rows, error);
+}
+
+// 批次汇总：概况、每块表一行、各型号各检测点的误差统计（只统计已完成的表）
+QVector<QStringList> summaryRows(const LotReportSummary& s, int threads)
+{
+    const int total = s.gauges.size();
+    QVector<QStringList> rows;
+    rows.reserve(total + 32);
+    rows << QStringList{"批次汇总"};
+    rows << QStringList{"生成时间：", QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss"), "", "处理线程：",
+                        QString::number(threads), "", "耗时(ms)：", QString::number(s.elapsedMs)};
+    rows << QStringList{"记录数：", QString::number(total), "", "已完成：", QString::number(s.completedCount),
+                        "", "合格：", QString::number(s.passedCount), "", "合格率：",
+                        QString("%1%").arg(s.completedCount ? 100.0 * s.passedCount / s.completedCount : 0.0, 0, 'f', 1),
+                        "", "失败：", QString::number(s.failedCount)};
+    rows << QStringList();
+
+    rows << QStringList{"序号", "来源", "表号", "产品型号", "支组编号", "保存时间", "平均最大角度(°)", "最大误差(MPa)", "结论", "报表文件"};
+    for (int i = 0; i < total; ++i) {
+        const LotGaugeResult& g = s.gauges[i];
+        rows << QStringList{QString::number(i + 1), g.source, g.gaugeSerial, g.productModel, g.groupNo,
+                            g.savedAt.toString("yyyy-MM-dd HH:mm:ss"), QString::number(g.avgMaxAngle, 'f', 2),
+                            g.passed < 0 ? QString("--") : QString::number(g.maxAbsErrMPa, 'f', 3),
+                            g.error.isEmpty() ? passedText(g.passed) : "失败: " + g.error,
+                            QFileInfo(g.outputFile).fileName()};
+    }
+    rows << QStringList();
+
+    struct PointStat {
+        double pressure = 0.0;
+        int count = 0;
+        double sumMax = 0.0;
+        double maxAbs = 0.0;
+    };
+    QMap<QPair<QString, int>, PointStat> stats;
+    for (const LotGaugeResult& g : s.gauges) {
+        if (!g.error.isEmpty() || g.passed < 0) continue;
+        for (int p = 0; p < g.pointMaxAbsErrMPa.size(); ++p) {
+            PointStat& st = stats[qMakePair(g.productModel, p)];
+            st.pressure = p < g.points.size() ? g.points[p] : 0.0;
+            ++st.count;
+            st.sumMax += g.pointMaxAbsErrMPa[p];
+            st.maxAbs = std::max(st.maxAbs, g.pointMaxAbsErrMPa[p]);
+        }
+    }
+    rows << QStringList{"产品型号", "检测点", "压力(MPa)", "已完成表数", "平均最大|误差|(MPa)", "最大|误差|(MPa)", "限值(MPa)"};
+    for (auto it = stats.cbegin(); it != stats.cend(); ++it) {
+        const PointStat& st = it.value();
+        rows << QStringList{it.key().first, QString::number(it.key().second + 1), QString::number(st.pressure, 'f', 1),
+                            QString::number(st.count), QString::number(st.sumMax / st.count, 'f', 3),
+                            QString::number(st.maxAbs, 'f', 3),
+                            QString::number(modelPointErrorLimitMPa(it.key().first, it.key().second), 'f', 1)};
+    }
+    return rows;
+}
+
+} // namespace
+
+bool loadSessionFile(const QString& path, SessionRecord& rec, double& nominalFsAngle, double& nominalFsPressure,
+                     QString& error)
+{
+    SessionFileData data;
+    if (!readSessionFile(path, data, error)) return false;
+
+    rec = SessionRecord();
+    rec.id = data.dbSessionId;
+    rec.productModel = data.productModel;
+    rec.productName = data.productName;
+    rec.dialDrawingNo = data.dialDrawingNo;
+    rec.groupNo = data.groupNo;
+    nominalFsAngle = data.maxAngle;
+    nominalFsPressure = data.maxPressure;
+    rec.maxPressure = modelFullScalePressureMPa(rec.productModel, nominalFsPressure);
+    rec.startedAt = data.startedAt;
+    rec.savedAt = QFileInfo(path).lastModified();
+    rec.currentRound = data.currentRound;
+
+    // 轮数取各检测点保存的轮次数（界面保存时每个点都按总轮数存）
+    const int rounds = data.rounds;
+    rec.totalRounds = rounds;
+
+    if (data.dataPoints == 0) rec.detectionPoints = data.detectionPoints;
+    for (int i = 0; i < data.dataPoints; ++i) {
+        const double pressure = data.pressures[i];
+        rec.detectionPoints.append(pressure);
+        for (int round = 0; round < rounds; ++round) {
+            for (int stroke = 1; stroke >= -1; stroke -= 2) {
+                const QVector<double>& angles = stroke > 0 ? data.forwardAngles : data.backwardAngles;
+                const QVector<quint8>& valid = stroke > 0 ? data.forwardValid : data.backwardValid;
+                for (int k = 0; k < data.slots; ++k) {
+                    const qsizetype cell = data.slotIndex(i, round, k);
+                    if (!valid[cell]) continue;   // 空位
+                    const double angle = angles[cell];
+                    SessionReading r;
+                    r.round = round;
+                    r.pointIndex = i;
+                    r.pressure = pressure;
+                    r.stroke = stroke;
+                    r.seq = k;
+                    r.angle = angle;
+                    rec.readings.append(r);
+                }
+            }
+        }
+    }
+
+    // 平均最大角度与界面一致：只算到当前轮为止已采集的
+    rec.roundMaxAngles.fill(0.0, rounds);
+    for (int r = 0; r < rounds && r < data.maxAngles.size(); ++r) rec.roundMaxAngles[r] = data.maxAngles[r];
+    double sum = 0.0;
+    int count = 0;
+    for (int r = 0; r <= rec.currentRound && r < rec.roundMaxAngles.size(); ++r) {
+        if (rec.roundMaxAngles[r] == 0.0) continue;
+        sum += rec.roundMaxAngles[r];
+        ++count;
+    }
+    rec.avgMaxAngle = count > 0 ? sum / count : 0.0;
+    return true;
+}
+
+bool runLotReport(const LotReportOptions& options, LotReportSummary& summary, QString& error,
+                  const std::function<void(int, int)>& progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+    summary = LotReportSummary();
+    const QDir outDir(options.outDir);
+    if (!QDir().mkpath(options.outDir)) {
+        error = "无法创建输出目录 " + options.outDir;
+        return false;
+    }
+
+    // 任务列表；表号（文件名）在开工前按输入顺序定好
+    QVector<LotGaugeResult>& gauges = summary.gauges;
+    QVector<qint64> ids;
+    const bool fromDatabase = options.files.isEmpty();
+    if (fromDatabase) {
+        SessionDatabase db("lot_report_query");
+        if (!db.open(options.dbPath)) {
+            error = db.lastError();
+            return false;
+        }
+        const QVector<SessionSummary> list = db.querySessions(options.filter, INT_MAX);
+        if (!db.lastError().isEmpty()) {
+            error = db.lastError();
+            return false;
+        }
+        // 查询按保存时间倒序，批次报表按时间正序
+        for (auto it = list.crbegin(); it != list.crend(); ++it) {
+            LotGaugeResult g;
+            g.source = QString("#%1").arg(it->id);
+            g.key = it->gaugeSerial.isEmpty() ? g.source : it->gaugeSerial;
+            gauges.append(g);
+            ids.append(it->id);
+        }
+    } else {
+        for (const QString& path : options.files) {
+            LotGaugeResult g;
+            g.source = path;
+            g.key = QFileInfo(path).completeBaseName();
+            gauges.append(g);
+        }
+    }
+    if (gauges.isEmpty()) {
+        error = "没有符合条件的检测记录";
+        return false;
+    }
+    assignUniqueKeys(gauges);
+
+    const int total = gauges.size();
+    const int threads = qBound(1, options.threads > 0 ? options.threads : QThread::idealThreadCount(), total);
+    const QString ext = options.xlsx ? ".xlsx" : ".csv";
+    LotGaugeResult* results = gauges.data();   // 先取指针：各线程只写自己那一项，不触发 QVector 的共享检查
+    const qint64* idData = ids.constData();
+    std::atomic<int> next{0};
+    std::atomic<int> done{0};
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for (int w = 0; w < threads; ++w) {
+        pool.start([&, w]() {
+            // 数据库连接不能跨线程，每个工作线程一个（SQLite WAL 下并发读不互相阻塞）
+            std::unique_ptr<SessionDatabase> db;
+            QString dbError;
+            if (fromDatabase) {
+                db = std::make_unique<SessionDatabase>(QString("lot_report_%1").arg(w));
+                if (!db->open(options.dbPath)) dbError = db->lastError();
+            }
+            for (int i = next++; i < total; i = next++) {
+                LotGaugeResult& g = results[i];
+                SessionRecord rec;
+                double nominalFsAngle = 0.0, nominalFsPressure = 0.0;
+                bool loaded = false;
+                if (fromDatabase) {
+                    loaded = dbError.isEmpty() && db->loadSession(idData[i], rec);
+                    if (!loaded) g.error = dbError.isEmpty() ? db->lastError() : dbError;
+                    // 数据库里没有存配置的满量程角度，用平均最大角度作名义满量程（与批量导出Excel一致）
+                    nominalFsAngle = rec.avgMaxAngle;
+                    nominalFsPressure = rec.maxPressure;
+                } else {
+                    loaded = loadSessionFile(g.source, rec, nominalFsAngle, nominalFsPressure, g.error);
+                }
+
+                if (loaded) {
+                    const GaugeReport report = buildGaugeReport(rec, nominalFsAngle, nominalFsPressure);
+                    g.productModel = rec.productModel;
+                    g.groupNo = rec.groupNo;
+                    g.gaugeSerial = rec.gaugeSerial;
+                    g.savedAt = rec.savedAt;
+                    g.avgMaxAngle = rec.avgMaxAngle;
+                    g.passed = report.passed;
+                    g.maxAbsErrMPa = report.maxAbsErrMPa;
+                    g.points = rec.detectionPoints;
+                    g.pointMaxAbsErrMPa = report.pointMaxAbsErrMPa;
+                    g.outputFile = outDir.filePath(passedText(report.passed) + "_" + g.key + ext);
+                    writeTable(g.outputFile, options.xlsx, g.key, report.rows, g.error);
+                }
+                ++done;
+            }
+        });
+    }
+    // 调用线程只负责报进度
+    while (!pool.waitForDone(200)) {
+        if (progress) progress(done.load(), total);
+    }
+    if (progress) progress(total, total);
+
+    for (const LotGaugeResult& g : gauges) {
+        if (!g.error.isEmpty()) {
+            ++summary.failedCount;
+        } else if (g.passed >= 0) {
+            ++summary.completedCount;
+            if (g.passed == 1) ++summary.passedCount;
+        }
+    }
+    summary.elapsedMs = timer.elapsed();
+
+    summary.summaryFile = outDir.filePath(QString("批次汇总") + ext);
+    if (!writeTable(summary.summaryFile, options.xlsx, "批次汇总", summaryRows(summary, threads), error)) return false;
+    return true;
+}
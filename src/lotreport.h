@@ -0,0 +1,64 @@
+#pragma once
+#include <QDateTime>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+#include "sessiondatabase.h"
+
+// ================== 整批检测记录的批量报表 ==================
+// 一批表（检测记录数据库里按条件查出的记录，或保存下来的会话文件）在线程池里并行处理：
+// 每个工作线程自己读记录（数据库各开一个连接）、算误差和合格判定、写这块表的报表，
+// 线程之间只共享一个原子下标和按序号预分配好的结果数组，没有锁，速度随核数线性增长。
+// 每块表输出一份 合格_.csv 排版的报表（CSV 或 XLSX），文件名是 <结论>_<表号>；
+// 全部完成后按输入顺序写批次汇总（每块表一行 + 各型号各检测点的误差统计）。
+
+struct LotReportOptions {
+    QStringList files;             // 会话文件（自动保存的 .pgs 或导出的 JSON）；为空时从数据库取
+    QString dbPath;                // 检测记录数据库
+    SessionFilter filter;          // 数据库查询条件
+    QString outDir;                // 输出目录（不存在则创建）
+    bool xlsx = false;             // 每块表输出 .xlsx 而不是 .csv
+    int threads = 0;               // 0 = 按 CPU 核数
+};
+
+struct LotGaugeResult {
+    QString source;                // 数据库记录号或会话文件路径
+    QString key;                   // 文件名里的表号部分（批内唯一）
+    QString productModel;
+    QString groupNo;
+    QString gaugeSerial;
+    QDateTime savedAt;
+    double avgMaxAngle = 0.0;
+    int passed = -1;               // -1=未完成 0=不合格 1=合格
+    double maxAbsErrMPa = 0.0;
+    QVector<double> points;        // 检测点压力
+    QVector<double> pointMaxAbsErrMPa;
+    QString outputFile;
+    QString error;                 // 非空表示这块表读取或写出失败
+};
+
+struct LotReportSummary {
+    QVector<LotGaugeResult> gauges;   // 与输入顺序一致
+    int failedCount = 0;              // 读取/写出失败的块数
+    int completedCount = 0;
+    int passedCount = 0;
+    qint64 elapsedMs = 0;
+    QString summaryFile;
+};
+
+// 阻塞运行；progress 在调用线程里周期性回调（已完成块数, 总块数）
+bool runLotReport(const LotReportOptions& options, LotReportSummary& summary, QString& error,
+                  const std::function<void(int, int)>& progress = {});
+
+// 读一个会话文件（二进制 .pgs 或 JSON，按内容识别）成检测记录；nominalFsAngle/Pressure 回填文件里配置的满量程
+bool loadSessionFile(const QString& path, SessionRecord& rec, double& nominalFsAngle, double& nominalFsPressure,
+                     QString& error);
+
+// 批量工具共用的文件名/表格工具
+// 文件名里不允许的字符换成下划线
+QString safeFileName(const QString& name);
+// 按输入顺序去重（不区分大小写，Windows 文件名不区分），空的记作"未编号"，重名的加 _2、_3，结果与线程调度无关
+QStringList uniqueFileKeys(const QStringList& keys);
+// 写 UTF-8（带 BOM）的 CSV，字段规则与界面导出的 合格_.csv 相同
+bool writeCsv(const QString& path, const QVector<QStringList>& rows, QString& error);
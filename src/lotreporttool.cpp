@@ -0,0 +1,72 @@
+// 批量报表：一整批检测记录并行算误差、判合格，每块表一份 合格_.csv 排版的报表，外加批次汇总。不需要界面。
+// 用法：
+//   lot_report --out <目录> [--db <检测记录库>] [--model 型号] [--group 支组编号] [--from yyyy-MM-dd] [--to yyyy-MM-dd]
+//              [--xlsx] [--threads N] [会话文件...]
+// 给了会话文件（自动保存的 .pgs 或导出的 json）就处理这些文件；否则按条件从检测记录数据库取（默认文档目录下的库）。
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDate>
+#include <QTextStream>
+
+#include "lotreport.h"
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("lot_report");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("整批检测记录的批量报表（并行）");
+    parser.addHelpOption();
+    QCommandLineOption outOpt("out", "输出目录", "dir");
+    QCommandLineOption dbOpt("db", "检测记录数据库", "path", SessionDatabase::defaultPath());
+    QCommandLineOption modelOpt("model", "产品型号", "model");
+    QCommandLineOption groupOpt("group", "支组编号", "group");
+    QCommandLineOption fromOpt("from", "起始日期 yyyy-MM-dd", "date");
+    QCommandLineOption toOpt("to", "截止日期 yyyy-MM-dd", "date");
+    QCommandLineOption xlsxOpt("xlsx", "每块表输出 xlsx（默认 csv）");
+    QCommandLineOption threadsOpt("threads", "工作线程数（默认按 CPU 核数）", "n", "0");
+    parser.addOptions({outOpt, dbOpt, modelOpt, groupOpt, fromOpt, toOpt, xlsxOpt, threadsOpt});
+    parser.addPositionalArgument("files", "会话文件（可选）", "[文件...]");
+    parser.process(app);
+
+    QTextStream out(stdout);
+    if (!parser.isSet(outOpt)) {
+        out << "请用 --out 指定输出目录" << Qt::endl;
+        return 2;
+    }
+
+    LotReportOptions options;
+    options.files = parser.positionalArguments();
+    options.dbPath = parser.value(dbOpt);
+    options.filter.productModel = parser.value(modelOpt);
+    options.filter.groupNo = parser.value(groupOpt);
+    options.filter.from = QDate::fromString(parser.value(fromOpt), "yyyy-MM-dd");
+    options.filter.to = QDate::fromString(parser.value(toOpt), "yyyy-MM-dd");
+    options.outDir = parser.value(outOpt);
+    options.xlsx = parser.isSet(xlsxOpt);
+    options.threads = parser.value(threadsOpt).toInt();
+
+    int lastPercent = -1;
+    auto progress = [&](int done, int total) {
+        const int percent = total > 0 ? done * 100 / total : 100;
+        if (percent / 10 == lastPercent / 10) return;
+        lastPercent = percent;
+        out << "进度 " << done << "/" << total << "（" << percent << "%）" << Qt::endl;
+    };
+
+    LotReportSummary summary;
+    QString error;
+    if (!runLotReport(options, summary, error, progress)) {
+        out << "批量报表失败: " << error << Qt::endl;
+        return 1;
+    }
+    out << "共 " << summary.gauges.size() << " 块，已完成 " << summary.completedCount << " 块，合格 "
+        << summary.passedCount << " 块，失败 " << summary.failedCount << " 块，耗时 " << summary.elapsedMs << " ms" << Qt::endl;
+    out << "批次汇总: " << summary.summaryFile << Qt::endl;
+    for (const LotGaugeResult& g : summary.gauges) {
+        if (!g.error.isEmpty()) out << "  " << g.source << ": " << g.error << Qt::endl;
+    }
+    return summary.failedCount > 0 ? 3 : 0;
+}
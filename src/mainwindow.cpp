@@ -6,6 +6,8 @@
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <cmath>   // NEW: for fmod/atan2/cos/sin
+#include <limits>
+#include <algorithm>
 
 #include <pylon/usb/BaslerUsbInstantCamera.h>
 #include <stdio.h>
@@ -14,6 +16,12 @@
 #include <stdlib.h>
 #include "settingdialog.h"
 #include "helpdialog.h"
+#include "analysis/autotune.h"
+#include "anglerecorddialog.h"
+#include "sweepcalibrationdialog.h"
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QFileInfo>
 // #include "Opencv_hp.h"
 
 using namespace Pylon;
@@ -30,6 +38,13 @@ MainWindow::MainWindow(QWidget *parent) :
 {
     ui->setupUi(this);
     ui->mainToolBar->setIconSize(QSize(48, 48));
+
+    // 先有一个表位的会话，后面的初始化都可能写它；表数确定后由 resetSlotSessions 补齐
+    m_slotSessions.append(new MeasurementSession(this));
+    m_session = m_slotSessions.front();
+
+    // 识别核心库不依赖Qt，日志统一转发到 qDebug
+    setCoreLogSink([](const std::string& msg) { qDebug().noquote() << QString::fromStdString(msg); });
     ui->centralWidget->installEventFilter(this);
 
     QFont bigFont = this->font();
@@ -79,6 +94,13 @@ MainWindow::MainWindow(QWidget *parent) :
     // connect(ui->actionCloseAlgo, &QAction::triggered, this, &MainWindow::algoArea);
 
     setupDialTypeSelector();   // 设置表盘类型选择器
+    setupMultiDialSelector();  // 设置同框多表选择器
+    setupAutoCapture();        // 设置自动采集
+    setupAngleRecorder();      // 设置逐帧角度记录
+
+    // 扫描标定入口放在工具栏
+    QAction *sweepAction = ui->mainToolBar->addAction("扫描标定");
+    connect(sweepAction, &QAction::triggered, this, &MainWindow::showSweepCalibrationDialog);
     initPointerConfigs();      // 初始化指针识别配置
     initializeDataArrays();    // 初始化数据数组
     updateDataDisplayVisibility();  // 初始化显示状态
@@ -101,85 +123,123 @@ MainWindow::MainWindow(QWidget *parent) :
         qDebug() << "使用默认轮数: 2轮";
     }
     
+    // 轮数/表盘都就绪后再回放日志，回放会覆盖上面的默认会话
+    setupSessionJournal();
+    
     qDebug() << "UI initialized with default expanded layout, 轮数设置为" << m_totalRounds << "轮";
 }
 
-// ========================= NEW: Angle helper implementations =========================
-double MainWindow::norm0_360(double deg) {
-    double r = std::fmod(deg, 360.0);
-    if (r < 0) r += 360.0;
-    return r;
+// ========================= Angle helper implementations =========================
+// 展开角/零位由识别核心库的 AngleTracker 维护，这里只负责行程方向
+void MainWindow::updateStrokeDirectionFromDelta(double deltaDeg) {
+    int dir = strokeDirectionFromDelta(deltaDeg);
+    if (dir != 0) {
+        m_strokeDirection = dir;        // 1=顺时针 正行程，-1=逆时针 反行程
+        m_isForwardStroke = (dir > 0);
+        m_hasPreviousAngle = true;
+    }
 }
 
-// wrap to (-180, 180]
-double MainWindow::wrapSigned180(double deg) {
-    double r = std::fmod(deg + 180.0, 360.0);
-    if (r <= 0) r += 360.0;
-    return r - 180.0;
+// One-stop: feed absolute angle -> maintain unwrapped + direction -> return relative (continuous)
+double MainWindow::processAbsAngle(double absDeg) {
+    double delta = 0.0;
+    if (isMultiDialMode()) {
+        // 多表：各表位的绝对角已由 measureAngleMultipleTimes 测好（absDeg 就是当前表位的那个），
+        // 这里统一推进展开角；同一次测量只推进一次
+        if (!m_multiDial.updateTrackers()) {
+            qDebug() << "processAbsAngle: 多表模式下没有新的表位测量，展开角不变";
+        } else if (const DialSlot* s = m_multiDial.slot(m_activeSlot); s && s->lastAbs != -999) {
+            delta = s->tracker.lastDelta();
+        }
+    } else {
+        delta = m_angleTracker.update(absDeg);
+    }
+    updateStrokeDirectionFromDelta(delta);
+    const AngleTracker* tracker = activeTracker();
+    return tracker ? tracker->relative() : 0.0;
 }
 
-// Circular mean in degrees, return [0,360)
-double MainWindow::circularMeanDeg(const std::vector<double>& angles) {
-    if (angles.empty()) return std::numeric_limits<double>::quiet_NaN();
-    double sx = 0.0, sy = 0.0;
-    for (double a : angles) {
-        double rad = a * CV_PI / 180.0;
-        sx += std::cos(rad);
-        sy += std::sin(rad);
+AngleTracker* MainWindow::activeTracker() {
+    if (isMultiDialMode()) {
+        DialSlot* s = m_multiDial.slot(m_activeSlot);
+        return s ? &s->tracker : nullptr;   // 当前表位还没检测到
     }
-    double mean = std::atan2(sy, sx) * 180.0 / CV_PI; // [-180,180]
-    if (mean < 0) mean += 360.0;
-    return mean;
+    return &m_angleTracker;
 }
 
-// Update unwrapped angle sequence from absolute [0,360) angle.
-// Returns shortest signed step (-180,180]
-double MainWindow::updateUnwrappedFromAbs(double absDeg) {
-    absDeg = norm0_360(absDeg);
-    if (!m_hasUnwrapped) {
-        // m_unwrappedAngle = absDeg;
-        if(m_hasZero) {
-            double k = std::round((m_zeroUnwrapped - absDeg) / 360.0);
-            m_unwrappedAngle = absDeg + 360.0 * k;
-        } else {
-            m_unwrappedAngle = absDeg;
+const AngleTracker* MainWindow::activeTracker() const {
+    if (isMultiDialMode()) {
+        for (const DialSlot& s : m_multiDial.slots()) {
+            if (s.id == m_activeSlot) return &s.tracker;
         }
-        m_previousAbs = absDeg;
-        m_hasUnwrapped = true;
-        m_lastDelta = 0.0;
-        return 0.0;
+        return nullptr;
     }
-    double delta = wrapSigned180(absDeg - m_previousAbs);
-    m_unwrappedAngle += delta;
-    m_previousAbs = absDeg;
-    m_lastDelta = delta;
-    return delta;
+    return &m_angleTracker;
 }
 
-void MainWindow::updateStrokeDirectionFromDelta(double deltaDeg) {
-    const double minAngleThreshold = 2.0; // deg
-    if (std::abs(deltaDeg) > minAngleThreshold) {
-        if (deltaDeg > 0) {
-            m_strokeDirection = 1;  // 顺时针 正行程
-            m_isForwardStroke = true;
-        } else {
-            m_strokeDirection = -1; // 逆时针 反行程
-            m_isForwardStroke = false;
+bool MainWindow::activeHasZero() const {
+    const AngleTracker* tracker = activeTracker();
+    return tracker && tracker->hasZero();
+}
+
+void MainWindow::storeSlotRelatives() {
+    m_slotCapturedRel.fill(std::numeric_limits<double>::quiet_NaN(), m_multiDial.maxDials());
+    for (const auto& s : m_multiDial.slots()) {
+        if (s.id < m_slotCapturedRel.size() && s.lastAbs != -999 && s.tracker.hasZero()) {
+            m_slotCapturedRel[s.id] = s.tracker.relative();
         }
-        m_hasPreviousAngle = true;
     }
 }
 
-// One-stop: feed absolute angle -> maintain unwrapped + direction -> return relative (continuous)
-double MainWindow::processAbsAngle(double absDeg) {
-    double delta = updateUnwrappedFromAbs(absDeg);
-    updateStrokeDirectionFromDelta(delta);
-    return currentRelativeAngle();
+void MainWindow::appendToOtherSlots(bool isForward, const StepTarget* step) {
+    if (!isMultiDialMode()) return;
+    const int stroke = isForward ? MeasurementSession::Forward : MeasurementSession::Backward;
+    for (int slot = 0; slot < m_slotSessions.size(); ++slot) {
+        if (slot == m_activeSlot || slot >= m_slotCapturedRel.size()) continue;
+        MeasurementSession* session = m_slotSessions[slot];
+        double rel = m_slotCapturedRel[slot];
+        if (std::isnan(rel) || !session->hasRound(m_currentRound)) {
+            qDebug() << "表位" << (slot + 1) << "本次无有效读数，跳过";
+            continue;
+        }
+        // 逐点步进：各表位都写到到点的那个检测点
+        if (step) {
+            if (step->slot >= session->slotsPerRound()) continue;
+            session->setAngle(m_currentRound, stroke, step->slot, rel);
+            journalSlot(JournalOp::Reading, slot, m_currentRound, isForward, step->slot, rel, step);
+            continue;
+        }
+        // 与 addAngleToCurrentRound 相同的填写顺序：正行程从前往后，反行程从后往前
+        const int n = session->slotsPerRound();
+        for (int k = 0; k < n; ++k) {
+            int i = isForward ? k : n - 1 - k;
+            if (!session->hasAngle(m_currentRound, stroke, i)) {
+                session->setAngle(m_currentRound, stroke, i, rel);
+                journalSlot(JournalOp::Reading, slot, m_currentRound, isForward, i, rel);
+                qDebug() << "表位" << (slot + 1) << "第" << (m_currentRound + 1) << "轮"
+                         << (isForward ? "正行程" : "反行程") << "采集数据" << (i + 1) << ":" << rel;
+                break;
+            }
+        }
+    }
+}
+QString MainWindow::feedLiveStats(double absDeg) {
+    bool outlier = m_liveStats.push(absDeg);
+    if (outlier) {
+        qDebug() << "本帧角度离群:" << absDeg << "残差" << m_liveStats.lastResidualDeg();
+    }
+    if (m_liveStats.size() < 3) return QString();
+    return QString(" | 稳定值: %1° ±%2°%3")
+        .arg(m_liveStats.robustMeanDeg(), 0, 'f', 2)
+        .arg(m_liveStats.robustScaleDeg(), 0, 'f', 2)
+        .arg(outlier ? " (离群)" : "");
 }
-// ======================= END NEW: Angle helper implementations =======================
+// ======================= END Angle helper implementations =======================
 
 MainWindow::~MainWindow()
 {
+    m_liveProbePool.waitForDone();  // 探测线程还在跑的话等它结束，它的结果会随窗口一起丢掉
+
     // 删除未使用的按钮动画定时器清理代码
     // if (m_buttonAnimationTimer) {
     //     m_buttonAnimationTimer->stop();
@@ -380,6 +440,8 @@ void MainWindow::startPreview(){
                 ui->srcDisplay->update();
                 // 在预览模式下显示当前已采集数量/设置的总数量
                 updateCollectionDisplay();
+                // 实时探测：自动采集（指针稳定后自动采集当前检测点）/ 逐帧角度记录
+                if (m_autoCaptureCheck->isChecked() || m_recordCheck->isChecked() || sweepActive()) liveProbeTick();
                 float wScale = roundf(ui->srcDisplay->width()*100.0/Width->GetValue())/100.0;
                 float hScale = roundf(ui->srcDisplay->height()*100.0/Height->GetValue())/100.0;
 
@@ -754,17 +816,33 @@ void MainWindow::algoArea(){
 
 
 void MainWindow::onCaptureZero()
+{
+    captureCurrentAngle(true);
+}
+
+// 提示框只在手动操作时弹；自动采集从预览循环里调用，弹模态框会重入事件循环，改成状态栏提示
+void MainWindow::reportOperationProblem(bool interactive, const QString& title, const QString& text)
+{
+    qDebug() << title << text;
+    if (interactive) {
+        QMessageBox::warning(this, title, text);
+    } else {
+        ui->statusBar->showMessage(text, 5000);
+    }
+}
+
+bool MainWindow::captureCurrentAngle(bool interactive)
 {
     qDebug() << "开始测量角度差...";
     
-    if (!m_hasZero) {
-        QMessageBox::information(this, "提示", "请先点击『归位』按钮设定零位");
-        return;
+    if (!activeHasZero()) {
+        reportOperationProblem(interactive, "提示", "请先点击『归位』按钮设定零位");
+        return false;
     }
 
     if (m_lastRgb.empty()) {
-        QMessageBox::warning(this, "提示", "还没有获取到图像，请确保预览正在运行");
-        return;
+        reportOperationProblem(interactive, "提示", "还没有获取到图像，请确保预览正在运行");
+        return false;
     }
 
     try {
@@ -774,57 +852,98 @@ void MainWindow::onCaptureZero()
         // 使用多次测量提高精度（返回稳定 Abs 角 0~360）
         double absNow = measureAngleMultipleTimes(frame, 3);
         if (absNow == -999) {
-            QMessageBox::warning(this, "错误", "计算角度失败");
-            return;
+            reportOperationProblem(interactive, "错误", "计算角度失败");
+            return false;
         }
 
         // 统一用展开角与相对角
         double rel = processAbsAngle(absNow);  // 更新展开角 & 行程方向
         m_lastCalculatedDelta = rel;           // "确定"按钮直接用
+        recordAngles(absNow, AngleRecordEvent::Capture);
+        if (isMultiDialMode()) storeSlotRelatives();
 
         qDebug() << "采集按钮 - Abs:" << absNow
-                 << " Unwrapped:" << m_unwrappedAngle
-                 << " ZeroUnwrapped:" << m_zeroUnwrapped
+                 << " Unwrapped:" << (activeTracker() ? activeTracker()->unwrapped() : 0.0)
+                 << " ZeroUnwrapped:" << (activeTracker() ? activeTracker()->zeroUnwrapped() : 0.0)
                  << " Relative:" << rel
                  << " 行程:" << getStrokeDirectionString();
 
-        ui->labelAngle->setText(
-            QString("零位: 0° | 当前(Abs): %1° | 相对: %2° | 行程: %3")
-                .arg(absNow, 0, 'f', 2)
-                .arg(rel, 0, 'f', 2)
-                .arg(getStrokeDirectionString()));
-
-        // 右侧显示检测示意图 - 创建单次检测器用于可视化
-        highPreciseDetector visDetector(frame, m_currentConfig);
-        visDetector.showScale1Result();
-        cv::Mat vis = visDetector.visual();
-        
-        // 在图像上叠加"相对角（连续）"
-        if (visDetector.getAngle() != -999) {
-            // 注意：这里使用我们刚算好的 rel；不再做手工环绕判断
-            std::string relativeAngleText = "Relative: " + std::to_string(rel) + "°";
-            cv::putText(vis, relativeAngleText, cv::Point(10, 60), 
-                       cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0, 255, 255), 2);
+        QString angleText = QString("零位: 0° | 当前(Abs): %1° | 相对: %2° | 行程: %3")
+                                .arg(absNow, 0, 'f', 2)
+                                .arg(rel, 0, 'f', 2)
+                                .arg(getStrokeDirectionString());
+        angleText += feedLiveStats(absNow);
+        if (isMultiDialMode()) {
+            for (int i = 0; i < m_slotCapturedRel.size(); ++i) {
+                angleText += std::isnan(m_slotCapturedRel[i])
+                                 ? QString(" | 表位%1: --").arg(i + 1)
+                                 : QString(" | 表位%1: %2°").arg(i + 1).arg(m_slotCapturedRel[i], 0, 'f', 2);
+            }
+        }
+        ui->labelAngle->setText(angleText);
+
+        // 右侧显示检测示意图 - 结果区可见时才创建单次检测器用于可视化
+        if (resultPanelVisible()) {
+            highPreciseDetector visDetector(frame, m_currentConfig);
+            std::vector<std::string> texts;
+            if (visDetector.getAngle() != -999) {
+                // 叠加"相对角（连续）"：使用刚算好的 rel，不再做手工环绕判断
+                texts.push_back("Relative: " + std::to_string(rel) + "°");
+            }
+            showDetectionResult(frame, visDetector.overlay(), texts);
         }
-        
-        cv::cvtColor(vis, vis, cv::COLOR_BGR2RGB);
-        QImage q(vis.data, vis.cols, vis.rows, vis.step, QImage::Format_RGB888);
-        ui->destDisplay->setPixmap(QPixmap::fromImage(q)
-                                   .scaled(ui->destDisplay->size(),
-                                           Qt::KeepAspectRatio,
-                                           Qt::SmoothTransformation));
         
         // 更新采集计数
         currentCapturedCount++;
         updateCollectionDisplay();
+        return true;
         
     } catch (const std::exception& e) {
         qDebug() << "测量角度时发生异常:" << e.what();
-        QMessageBox::critical(this, "错误", QString("测量角度失败: %1").arg(e.what()));
+        reportOperationProblem(interactive, "错误", QString("测量角度失败: %1").arg(e.what()));
     } catch (...) {
         qDebug() << "测量角度时发生未知异常";
-        QMessageBox::critical(this, "错误", "测量角度时发生未知错误");
+        reportOperationProblem(interactive, "错误", "测量角度时发生未知错误");
+    }
+    return false;
+}
+
+bool MainWindow::resultPanelVisible() const
+{
+    return ui->destDisplay->isVisible() && ui->destDisplay->width() > 0 && ui->destDisplay->height() > 0;
+}
+
+// 右侧结果区显示：先把原图缩到控件分辨率，再按检测几何画矢量图元，
+// 不再在全分辨率图上画完再整体平滑缩放
+void MainWindow::showDetectionResult(const cv::Mat& bgr, const DetectionOverlay& overlay,
+                                     const std::vector<std::string>& texts, bool blendLsi)
+{
+    if (bgr.empty() || !resultPanelVisible()) return;  // 结果区不可见时不画
+
+    const QSize target = ui->destDisplay->size();
+    const double scale = std::min(double(target.width()) / bgr.cols, double(target.height()) / bgr.rows);
+    cv::Mat view;
+    cv::resize(bgr, view,
+               cv::Size(std::max(1, cvRound(bgr.cols * scale)), std::max(1, cvRound(bgr.rows * scale))),
+               0, 0, cv::INTER_AREA);
+
+    if (blendLsi) {
+        cv::Mat enhanced = spatial_LSI(view, 5);
+        cv::addWeighted(view, 0.7, enhanced, 0.3, 0, view);
     }
+
+    drawDetectionOverlay(view, overlay, scale);
+    if (isMultiDialMode()) drawDialSlots(view, m_multiDial.slots(), scale);
+
+    int y = 60;
+    for (const auto& text : texts) {
+        cv::putText(view, text, cv::Point(10, y), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0, 255, 255), 2);
+        y += 30;
+    }
+
+    cv::cvtColor(view, view, cv::COLOR_BGR2RGB);
+    QImage q(view.data, view.cols, view.rows, view.step, QImage::Format_RGB888);
+    ui->destDisplay->setPixmap(QPixmap::fromImage(q));
 }
 
 bool MainWindow::grabOneFrame(cv::Mat& outBgr)
@@ -881,37 +1000,52 @@ void MainWindow::onResetZero()
         }
         
         // NEW: 归位基于"展开角"初始化；记录连续零位
-        updateUnwrappedFromAbs(angle);   // 初始化/对齐展开角序列
-        m_zeroUnwrapped = m_unwrappedAngle;
-        m_zeroAngle = angle;             // 仅用于 UI 显示（可保留）
-        m_hasZero = true;
+        if (isMultiDialMode()) {
+            // 多表：各表位同时归位，编号按当前画面重新分配
+            m_multiDial.resetSlots();
+            m_multiDial.measure(frame, m_currentConfig, 1);
+            int zeroed = m_multiDial.captureZeroAll();
+            if (!m_multiDial.slot(m_activeSlot) || !activeHasZero()) {
+                QMessageBox::warning(this, "错误", QString("当前表位%1未检测到表盘或指针").arg(m_activeSlot + 1));
+                return;
+            }
+            qDebug() << "多表归位完成:" << zeroed << "/" << m_multiDial.maxDials() << "个表位";
+        } else {
+            m_angleTracker.captureZero(angle);   // 初始化/对齐展开角序列，记录连续零位
+        }
+        recordAngles(angle, AngleRecordEvent::Zero);
+        // 零位就是采集数据1，自动采集要等指针离开零位后才布防
+        m_settle.holdAt(isMultiDialMode() ? m_multiDial.slot(m_activeSlot)->lastAbs : angle);
         
         // 重置方向跟踪
         resetStrokeTracking();
         
         qDebug() << "零位设置成功 Abs:" << angle
-                 << " Unwrapped:" << m_unwrappedAngle
-                 << " ZeroUnwrapped:" << m_zeroUnwrapped
+                 << " Unwrapped:" << (activeTracker() ? activeTracker()->unwrapped() : 0.0)
+                 << " ZeroUnwrapped:" << (activeTracker() ? activeTracker()->zeroUnwrapped() : 0.0)
                  << "（归位=Relative 0°）";
         
         // 归位操作：清空当前轮次所有数据，然后添加零度数据到采集数据1
-        if (m_currentRound < m_allRoundsData.size()) {
-            RoundData &currentRound = m_allRoundsData[m_currentRound];
-            
+        if (m_session->hasRound(m_currentRound)) {
             // 清空当前轮次的所有数据
-            currentRound.forwardAngles.fill(0.0);
-            currentRound.backwardAngles.fill(0.0);
-            currentRound.maxAngle = 0.0;
-            currentRound.isCompleted = false;
+            m_session->clearRound(m_currentRound);
+            journalRoundReset(m_activeSlot, m_currentRound);
             
-            // 将归位的0度数据写入采集数据1（第一个正行程位置）
-            if (!currentRound.forwardAngles.isEmpty()) {
-                currentRound.forwardAngles[0] = 0.0;  // 零度写入采集数据1
-                qDebug() << "归位操作：第" << (m_currentRound + 1) << "轮采集数据1已设置为0.0度";
+            // 归位的0度数据就是采集数据1（第一个正行程位置）
+            if (m_session->slotsPerRound() > 0) {
+                m_session->setAngle(m_currentRound, MeasurementSession::Forward, 0, 0.0);
+                journalSlot(JournalOp::Reading, m_activeSlot, m_currentRound, true, 0, 0.0);
             }
+            qDebug() << "归位操作：第" << (m_currentRound + 1) << "轮采集数据1已设置为0.0度";
             
             qDebug() << "第" << (m_currentRound + 1) << "轮数据已清空，零度已写入采集数据1";
         }
+        // 其他表位的会话同样清空当前轮次
+        for (int slot = 0; slot < m_slotSessions.size(); ++slot) {
+            if (slot == m_activeSlot || !m_slotSessions[slot]->hasRound(m_currentRound)) continue;
+            m_slotSessions[slot]->clearRound(m_currentRound);
+            journalRoundReset(slot, m_currentRound);
+        }
         
         // 重置最大角度采集状态
         m_maxAngleCaptured = false;
@@ -919,9 +1053,6 @@ void MainWindow::onResetZero()
         m_tempMaxAngle = 0.0;
         m_tempCurrentAngle = 0.0;
         
-        // 同时更新误差表格（如果打开的话）
-        updateErrorTableWithAllRounds();
-        
         // 更新检测点标签显示
         updateDetectionPointLabels();
         
@@ -931,24 +1062,8 @@ void MainWindow::onResetZero()
         // 更新界面显示 - 显示为0度（全局0度参考点）
         ui->labelAngle->setText(QString("零位已设置: 0°"));
         
-        // 显示检测结果到右侧区域
-        det.showScale1Result();
-        cv::Mat vis = det.visual();
-        
-        // 在图像上显示归位时的0度（相对角）
-        std::string zeroAngleText = "Zero: 0°";
-        cv::putText(vis, zeroAngleText, cv::Point(10, 60), 
-                   cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0, 255, 255), 2);
-        // 同时叠加 Relative: 0°
-        std::string relativeAngleText = "Relative: 0°";
-        cv::putText(vis, relativeAngleText, cv::Point(10, 90), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0,255,255), 2);
-        
-        cv::cvtColor(vis, vis, cv::COLOR_BGR2RGB);
-        QImage q(vis.data, vis.cols, vis.rows, vis.step, QImage::Format_RGB888);
-        ui->destDisplay->setPixmap(QPixmap::fromImage(q)
-                                   .scaled(ui->destDisplay->size(),
-                                           Qt::KeepAspectRatio,
-                                           Qt::SmoothTransformation));
+        // 显示检测结果到右侧区域：归位时的0度（相对角）
+        showDetectionResult(frame, det.overlay(), {"Zero: 0°", "Relative: 0°"});
         
         QMessageBox::information(this, "成功", QString("零位设置成功！\n当前角度设为: 0°"));
         
@@ -978,26 +1093,16 @@ void MainWindow::runAlgoOnce()
             throw std::runtime_error("未检测到表盘或指针");
 
         double angle = det.getAngle();          // 角度
-        det.showScale1Result();
-        cv::Mat vis = det.visual();             // 可视化结果
-
-        cv::Mat enhanced = spatial_LSI(bgr, 5);
-        cv::Mat mix;
-        cv::addWeighted(vis, 0.7, enhanced, 0.3, 0, mix);
-
-        cv::cvtColor(mix, mix, cv::COLOR_BGR2RGB);
-        QImage img(mix.data, mix.cols, mix.rows, mix.step, QImage::Format_RGB888);
-        ui->destDisplay->setPixmap(QPixmap::fromImage(
-                img).scaled(ui->destDisplay->size(),
-                             Qt::KeepAspectRatio,
-                             Qt::SmoothTransformation));
+        // 多表：整幅画面的检测只用来画叠加图，角度按表位ROI单独测（测一次，展开角也只推进一次）
+        if (isMultiDialMode()) angle = measureAngleMultipleTimes(bgr, 1);
+        std::vector<std::string> texts;
 
         // 更新角度标签
         if (angle != -999) {
             // 统一通过展开角维护方向与相对角
-            double rel = m_hasZero ? processAbsAngle(angle) : 0.0;
+            double rel = activeHasZero() ? processAbsAngle(angle) : 0.0;
             QString txt;
-            if (m_hasZero) {
+            if (activeHasZero()) {
                 txt = QString("零位: 0° | 当前(Abs): %1° | 相对: %2° | 行程: %3")
                         .arg(angle, 0, 'f', 2)
                         .arg(rel, 0, 'f', 2)
@@ -1005,26 +1110,35 @@ void MainWindow::runAlgoOnce()
             } else {
                 txt = QString("当前(Abs): %1°").arg(angle, 0, 'f', 2);
             }
+            txt += feedLiveStats(angle);
             ui->labelAngle->setText(txt);
 
             // 在可视化图上叠加 Relative
-            if (m_hasZero) {
-                std::string relativeAngleText = "Relative: " + std::to_string(rel) + "°";
-                cv::putText(vis, relativeAngleText, cv::Point(10, 60), 
-                           cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0, 255, 255), 2);
+            if (activeHasZero()) {
+                texts.push_back("Relative: " + std::to_string(rel) + "°");
             }
+        } else if (isMultiDialMode()) {
+            ui->labelAngle->setText(QString("表位%1未检测到指针").arg(m_activeSlot + 1));
         }
+
+        // 可视化结果（叠加散斑衬比增强图），在显示分辨率上合成
+        showDetectionResult(bgr, det.overlay(), texts, true);
     }
     catch (const std::exception &e) {
         qDebug() << "识别错误:" << e.what();
-        cv::Mat gray;
-        cv::cvtColor(rgbFrame, gray, cv::COLOR_RGB2GRAY);
-        cv::Mat lsi = spatial_LSI(gray, 5);
-        QImage img(lsi.data, lsi.cols, lsi.rows, lsi.step, QImage::Format_Grayscale8);
-        ui->destDisplay->setPixmap(QPixmap::fromImage(
-                img).scaled(ui->destDisplay->size(),
-                             Qt::KeepAspectRatio,
-                             Qt::SmoothTransformation));
+        if (resultPanelVisible()) {
+            // 同样先缩到显示分辨率再做散斑衬比增强
+            const QSize target = ui->destDisplay->size();
+            const double scale = std::min(double(target.width()) / rgbFrame.cols, double(target.height()) / rgbFrame.rows);
+            cv::Mat gray;
+            cv::cvtColor(rgbFrame, gray, cv::COLOR_RGB2GRAY);
+            cv::resize(gray, gray,
+                       cv::Size(std::max(1, cvRound(gray.cols * scale)), std::max(1, cvRound(gray.rows * scale))),
+                       0, 0, cv::INTER_AREA);
+            cv::Mat lsi = spatial_LSI(gray, 5);
+            QImage img(lsi.data, lsi.cols, lsi.rows, lsi.step, QImage::Format_RGB888);  // spatial_LSI 返回三通道灰度
+            ui->destDisplay->setPixmap(QPixmap::fromImage(img));
+        }
         ui->labelAngle->setText("未检测到表盘或指针");
     }
 }
@@ -1062,8 +1176,12 @@ void MainWindow::showErrorTableDialog()
         
         // 连接关闭信号，在对话框关闭时清空指针
         connect(m_errorTableDialog, &QDialog::finished, this, [this]() {
+            // 关掉的表格不再订阅会话变化
+            if (m_errorTableDialog) m_errorTableDialog->setMeasurementSession(nullptr);
             m_errorTableDialog = nullptr;
         });
+        connect(m_errorTableDialog, &ErrorTableDialog::angleEdited, this, &MainWindow::onErrorTableAngleEdited);
+        connect(m_errorTableDialog, &ErrorTableDialog::clearRequested, this, &MainWindow::onClearData);
         
         // 设置轮数与主窗口同步
         m_errorTableDialog->setTotalRounds(m_totalRounds);
@@ -1074,8 +1192,8 @@ void MainWindow::showErrorTableDialog()
             m_errorTableDialog->setDialType(m_currentDialType);
         }
         
-        // 同步所有轮次的数据到误差表格
-        updateErrorTableWithAllRounds();
+        // 订阅共用的采集数据：先整体读一次，之后每次采集只收到变化的那一格
+        m_errorTableDialog->setMeasurementSession(m_session);
         
         m_errorTableDialog->show();
         
@@ -1121,757 +1239,767 @@ void MainWindow::setupDialTypeSelector()
     connect(m_dialTypeCombo, &QComboBox::currentTextChanged, this, &MainWindow::onDialTypeChanged);
 }
 
-void MainWindow::initPointerConfigs()
+void MainWindow::setupMultiDialSelector()
 {
-    // YYQY表盘配置 - 针对白色指针优化
-    m_yyqyConfig.dp = 1.0;
-    m_yyqyConfig.minDist = 100;  
-    m_yyqyConfig.param1 = 100;
-    m_yyqyConfig.param2 = 25;              // 降低以检测更多圆候选
-    m_yyqyConfig.minRadius = 150;  
-    m_yyqyConfig.maxRadius = 300;
-    
-    // 白色指针检测参数 - 针对YYQY白色指针优化
-    m_yyqyConfig.usePointerFromCenter = true;  // 使用专门的白色指针检测
-    m_yyqyConfig.pointerSearchRadius = 0.85;   // 搜索半径比例
-    m_yyqyConfig.pointerMinLength = 60;        // 降低最小长度，白色指针可能较短
-    m_yyqyConfig.cannyLow = 30;               // 保持低阈值
-    m_yyqyConfig.cannyHigh = 100;
-    m_yyqyConfig.rho = 1.0;                   // 距离分辨率
-    m_yyqyConfig.theta = CV_PI/180;           // 角度分辨率
-    m_yyqyConfig.threshold = 35;              // 降低直线检测阈值
-    m_yyqyConfig.minLineLength = 45;          // 降低最小线段长度
-    m_yyqyConfig.maxLineGap = 12;             // 适当增加间隙
-    m_yyqyConfig.silverThresholdLow = 0;      // YYQY不使用银色检测
-    m_yyqyConfig.dialType = "YYQY";           // 设置表盘类型
-    
-    // BYQ表盘配置 - 针对银色指针末端和转轴检测优化
-    m_byqConfig.dp = 1.0;
-    m_byqConfig.minDist = 100;
-    m_byqConfig.param1 = 100;
-    m_byqConfig.param2 = 30;
-    m_byqConfig.minRadius = 50;
-    m_byqConfig.maxRadius = 0;
-    
-    // BYQ指针检测参数 - 针对细指针末端检测
-    m_byqConfig.usePointerFromCenter = true;
-    
-    // 步骤1-2：掩码参数
-    m_byqConfig.pointerMaskRadius = 0.9;        // 表盘掩码半径比例
-    m_byqConfig.axisExcludeMultiplier = 1.8;    // 转轴排除区域倍数
-    
-    // 步骤3：预处理参数
-    m_byqConfig.morphKernelWidth = 1;           // 形态学核宽度
-    m_byqConfig.morphKernelHeight = 2;          // 形态学核高度
-    m_byqConfig.gaussianKernelSize = 3;         // 高斯核大小
-    m_byqConfig.gaussianSigma = 0.8;            // 高斯标准差
-    
-    // 步骤4：边缘检测参数
-    m_byqConfig.cannyLowThreshold = 30;         // Canny低阈值
-    m_byqConfig.cannyHighThreshold = 100;       // Canny高阈值
-    
-    // 步骤5：HoughLinesP参数
-    m_byqConfig.houghThreshold = 20;            // 直线检测阈值
-    m_byqConfig.minLineLengthRatio = 0.12;      // 最小长度比例
-    m_byqConfig.maxLineGapRatio = 0.08;         // 最大间隙比例
-    m_byqConfig.dialType = "BYQ";             // 设置表盘类型
-    
-    // 设置默认配置
-    m_currentConfig = &m_yyqyConfig;
-    
-    qDebug() << "指针识别配置初始化完成 - 白色指针优化版本";
+    // 同框表数：工装上并排放了几块表（1=单表，保持原来的流程）
+    QLabel *countLabel = new QLabel("同框表数:", this);
+    m_dialCountSpin = new QSpinBox(this);
+    m_dialCountSpin->setRange(1, 6);
+    m_dialCountSpin->setValue(1);
+
+    // 当前表位：主界面/误差表格显示哪一块表的会话
+    QLabel *slotLabel = new QLabel("当前表位:", this);
+    m_activeSlotCombo = new QComboBox(this);
+    m_activeSlotCombo->addItem("表位1");
+    m_activeSlotCombo->setEnabled(false);
+
+    QFont font = countLabel->font();
+    font.setPointSize(12);
+    font.setBold(true);
+    countLabel->setFont(font);
+    slotLabel->setFont(font);
+    m_dialCountSpin->setFont(font);
+    m_activeSlotCombo->setFont(font);
+    m_dialCountSpin->setMaximumHeight(30);
+    m_activeSlotCombo->setMaximumHeight(30);
+
+    ui->statusBar->addPermanentWidget(countLabel);
+    ui->statusBar->addPermanentWidget(m_dialCountSpin);
+    ui->statusBar->addPermanentWidget(slotLabel);
+    ui->statusBar->addPermanentWidget(m_activeSlotCombo);
+
+    connect(m_dialCountSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::onDialCountChanged);
+    connect(m_activeSlotCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onActiveSlotChanged);
 }
 
-void MainWindow::switchPointerConfig(const QString& dialType)
+void MainWindow::setupAutoCapture()
 {
-    if (dialType == "YYQY-13") {
-        m_currentConfig = &m_yyqyConfig;
-        qDebug() << "切换到YYQY-13指针识别配置";
-    } else if (dialType == "BYQ-19") {
-        m_currentConfig = &m_byqConfig;
-        qDebug() << "切换到BYQ-19指针识别配置";
+    // 自动采集：指针稳定（窗口标准差连续K帧低于阈值）后倒计时，结束时自动"采集+确定"
+    m_liveProbePool.setMaxThreadCount(1);
+    m_autoCaptureCheck = new QCheckBox("自动采集", this);
+    QLabel *dwellLabel = new QLabel("等待(s):", this);
+    m_autoDwellSpin = new QDoubleSpinBox(this);
+    m_autoDwellSpin->setRange(0.0, 10.0);
+    m_autoDwellSpin->setSingleStep(0.5);
+    m_autoDwellSpin->setDecimals(1);
+    m_autoDwellSpin->setValue(saveSettings->autoCaptureDwellMs / 1000.0);
+
+    QFont font = m_autoCaptureCheck->font();
+    font.setPointSize(12);
+    font.setBold(true);
+    m_autoCaptureCheck->setFont(font);
+    dwellLabel->setFont(font);
+    m_autoDwellSpin->setFont(font);
+    m_autoDwellSpin->setMaximumHeight(30);
+
+    ui->statusBar->addPermanentWidget(m_autoCaptureCheck);
+    ui->statusBar->addPermanentWidget(dwellLabel);
+    ui->statusBar->addPermanentWidget(m_autoDwellSpin);
+
+    connect(m_autoCaptureCheck, &QCheckBox::toggled, this, &MainWindow::onAutoCaptureToggled);
+    connect(m_autoDwellSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double sec) {
+        saveSettings->autoCaptureDwellMs = int(sec * 1000);
+        if (m_autoCaptureCheck->isChecked()) onAutoCaptureToggled(true);  // 按新等待时间重新开始
+    });
+    m_autoClock.start();
+}
+
+void MainWindow::onAutoCaptureToggled(bool enabled)
+{
+    SettleConfig cfg;
+    cfg.maxStdDeg = saveSettings->autoCaptureMaxStdDeg;
+    cfg.stableFrames = saveSettings->autoCaptureStableFrames;
+    cfg.dwellMs = saveSettings->autoCaptureDwellMs;
+    m_settle.setConfig(cfg);
+    m_lastAutoProbeMs = -1;
+
+    if (enabled) {
+        // 如果已经归位且指针还停在上次读数的位置（刚采过），先不触发
+        if (activeHasZero()) m_settle.holdAt(norm0_360(activeTracker()->unwrapped()));
+        qDebug() << "自动采集已开启 阈值σ:" << cfg.maxStdDeg << "° 稳定帧:" << cfg.stableFrames << "等待:" << cfg.dwellMs << "ms";
+        ui->statusBar->showMessage("自动采集已开启：指针稳定后自动采集当前检测点", 3000);
+    } else {
+        qDebug() << "自动采集已关闭";
     }
 }
 
-void MainWindow::onDialTypeChanged(const QString &dialType)
+void MainWindow::liveProbeTick()
 {
-    m_currentDialType = dialType;
-    switchPointerConfig(dialType);  // 切换指针识别配置
-    
-    // 重新初始化数据数组和显示
-    initializeDataArrays();
-    
-    // 更新检测点标签显示
-    updateDetectionPointLabels();
-    
-    qDebug() << "表盘类型切换为:" << dialType << "需要数据数量:" << m_requiredDataCount;
+    if (m_liveProbeRunning || m_autoCaptureBusy || m_lastRgb.empty()) return;
+
+    // 识别较慢，限制到约15帧/秒，避免拖慢预览
+    const qint64 now = m_autoClock.elapsed();
+    if (m_lastAutoProbeMs >= 0 && now - m_lastAutoProbeMs < 66) return;
+    m_lastAutoProbeMs = now;
+
+    // 识别放到探测线程里做，界面线程只处理结果。帧和参数按值带过去（m_lastRgb 每帧都是新 clone，不会被改写），
+    // 工作线程不碰任何 MainWindow 成员；上一帧没处理完就跳过这一帧
+    m_liveProbeRunning = true;
+    const cv::Mat rgb = m_lastRgb;
+    const PointerDetectionConfig config = *m_currentConfig;
+    const bool multi = isMultiDialMode();
+    const int maxDials = m_multiDial.maxDials();
+    m_liveProbePool.start([this, rgb, config, multi, maxDials, now]() {
+        CoreLogMute mute;  // 探测时不刷识别日志
+        LiveProbeResult result;
+        result.timeMs = now;
+        try {
+            cv::Mat frame;
+            cv::cvtColor(rgb, frame, cv::COLOR_RGB2BGR);
+            if (multi) {
+                result.dials = readDials(frame, &config, maxDials, 1);
+            } else {
+                result.absDeg = measurePointerAngle(frame, &config, 1);
+            }
+        } catch (...) {
+            result.absDeg = -999;
+            result.dials.clear();
+        }
+        result.multi = multi;
+        result.maxDials = maxDials;
+        QMetaObject::invokeMethod(this, [this, result]() { onLiveProbeResult(result); }, Qt::QueuedConnection);
+    });
 }
 
-highPreciseDetector::highPreciseDetector(const cv::Mat& image, const PointerDetectionConfig* config) 
-    : m_angle(-999), m_config(config), m_axisCenter(-1, -1), m_axisRadius(0), 
-      m_blackLine1(-1, -1, -1, -1), m_blackLine2(-1, -1, -1, -1), m_hasBlackLines(false) {
-    if (image.empty()) {
-        qDebug() << "输入图像为空";
-        return;
-    }
-    
-    // 如果没有提供配置，使用默认配置
-    static PointerDetectionConfig defaultConfig;
-    if (m_config == nullptr) {
-        m_config = &defaultConfig;
+void MainWindow::onLiveProbeResult(const LiveProbeResult& result)
+{
+    m_liveProbeRunning = false;
+    // 结果回来之前改了同框表数，这一帧作废
+    if (result.multi != isMultiDialMode() || result.maxDials != m_multiDial.maxDials()) return;
+
+    double absNow = result.absDeg;
+    if (result.multi) {
+        m_multiDial.apply(result.dials);
+        const DialSlot* s = m_multiDial.slot(m_activeSlot);
+        absNow = s ? s->lastAbs : -999;
     }
-    
-    // 复制输入图像
-    m_image = image.clone();
-    m_visual = image.clone();
-    
-    try {
-        // 检测圆形
-        detectCircles();
-        
-        // 根据配置选择指针检测方法
-        if (m_config->usePointerFromCenter && !m_circles.empty()) {
-            detectPointerFromCenter();
-        } else {
-            detectLines();
-        }
-        
-        // 计算角度
-        if (!m_circles.empty() && !m_lines.empty()) {
-            calculateAngle();
-        }
-    } catch (const std::exception& e) {
-        qDebug() << "检测过程中出错:" << e.what();
+
+    m_autoCaptureBusy = true;
+    updateLiveTrackers(absNow);
+    if (m_recordCheck->isChecked()) recordAngles(absNow, AngleRecordEvent::Live);
+
+    // 扫描标定：当前表位的相对角交给扫描对话框，与参考压力配对
+    if (sweepActive() && absNow != -999 && activeHasZero()) {
+        m_sweepDialog->addAngleSample(liveTracker(isMultiDialMode() ? m_activeSlot : 0).relative());
     }
-}
 
-void highPreciseDetector::detectCircles() {
-    cv::Mat gray;
-    if (m_image.channels() == 3) {
-        cv::cvtColor(m_image, gray, cv::COLOR_BGR2GRAY);
-    } else {
-        gray = m_image.clone();
-    }
-    
-    // 使用高斯模糊减少噪声
-    cv::GaussianBlur(gray, gray, cv::Size(9, 9), 2, 2);
-    
-    // 使用配置参数进行HoughCircles检测
-    std::vector<cv::Vec3f> circles;
-    cv::HoughCircles(gray, circles, cv::HOUGH_GRADIENT, 
-                     m_config->dp, 
-                     m_config->minDist, 
-                     m_config->param1, 
-                     m_config->param2, 
-                     m_config->minRadius, 
-                     m_config->maxRadius);
-    
-    // 选择最大的圆作为表盘
-    if (!circles.empty()) {
-        cv::Vec3f maxCircle = circles[0];
-        float maxRadius = maxCircle[2];
-        
-        for (const auto& circle : circles) {
-            if (circle[2] > maxRadius) {
-                maxCircle = circle;
-                maxRadius = circle[2];
-            }
-        }
-        
-        m_circles.push_back(maxCircle);
-        qDebug() << "检测到表盘: 中心(" << maxCircle[0] << "," << maxCircle[1] << ") 半径:" << maxRadius;
-    } else {
-        qDebug() << "未检测到圆形表盘";
+    // 未归位/最大角度模式下仍需手动；逐点步进时由压力到点触发采集，不再看指针稳定
+    if (!m_autoCaptureCheck->isChecked() || !activeHasZero() || m_maxAngleCaptureMode || steppingActive()) {
+        m_autoCaptureBusy = false;
+        return;
     }
-}
 
-void highPreciseDetector::detectLines() {
-    cv::Mat gray, edges;
-    if (m_image.channels() == 3) {
-        cv::cvtColor(m_image, gray, cv::COLOR_BGR2GRAY);
-    } else {
-        gray = m_image.clone();
-    }
-    
-    // 使用配置参数进行边缘检测
-    cv::Canny(gray, edges, m_config->cannyLow, m_config->cannyHigh, 3);
-    
-    // 使用配置参数进行HoughLinesP检测
-    std::vector<cv::Vec4i> lines;
-    cv::HoughLinesP(edges, lines, 
-                    m_config->rho, 
-                    m_config->theta, 
-                    m_config->threshold, 
-                    m_config->minLineLength, 
-                    m_config->maxLineGap);
-    
-    if (!lines.empty()) {
-        // 如果检测到表盘，选择距离表盘中心最近的直线作为指针
-        if (!m_circles.empty()) {
-            cv::Point2f center(m_circles[0][0], m_circles[0][1]);
-            cv::Vec4i bestLine;
-            double minDist = std::numeric_limits<double>::max();
-            
-            for (const auto& line : lines) {
-                cv::Point2f lineCenter((line[0] + line[2])/2.0f, (line[1] + line[3])/2.0f);
-                double dist = cv::norm(center - lineCenter);
-                
-                if (dist < minDist) {
-                    minDist = dist;
-                    bestLine = line;
-                }
-            }
-            
-            if (minDist < m_circles[0][2]) { // 确保直线在表盘内
-                m_lines.push_back(bestLine);
-                qDebug() << "检测到指针: (" << bestLine[0] << "," << bestLine[1] << ") 到 (" << bestLine[2] << "," << bestLine[3] << ")";
-            }
+    const qint64 now = result.timeMs;
+    SettleState st = m_settle.update(absNow, now);
+    switch (st) {
+    case SettleState::Settling:
+        drawAutoCaptureCountdown(m_settle.progress(now),
+                                 QString("%1/%2").arg(m_settle.stableCount()).arg(m_settle.config().stableFrames));
+        break;
+    case SettleState::Countdown:
+        drawAutoCaptureCountdown(m_settle.progress(now),
+                                 QString::number(m_settle.remainingMs(now) / 1000.0, 'f', 1));
+        break;
+    case SettleState::Fire: {
+        qDebug() << "指针已稳定，自动采集 Abs:" << m_settle.settledAbsDeg() << "窗口σ:" << m_settle.windowStdDeg();
+        drawAutoCaptureCountdown(1.0, "OK");
+        // 与手动操作一致：先"采集"再"确定"，行程方向/多表位都沿用原逻辑；出问题只在状态栏提示，不弹框
+        if (captureCurrentAngle(false)) {
+            confirmCurrentData(false);
+            ui->statusBar->showMessage("已自动采集当前检测点", 2000);
         } else {
-            // 如果没有检测到表盘，选择最长的直线
-            cv::Vec4i longestLine;
-            double maxLength = 0;
-            
-            for (const auto& line : lines) {
-                double length = sqrt(pow(line[2] - line[0], 2) + pow(line[3] - line[1], 2));
-                if (length > maxLength) {
-                    maxLength = length;
-                    longestLine = line;
-                }
-            }
-            
-            if (maxLength > 0) {
-                m_lines.push_back(longestLine);
-                qDebug() << "检测到最长直线作为指针";
-            }
+            qDebug() << "自动采集失败，等待指针重新稳定";
         }
-    } else {
-        qDebug() << "未检测到直线";
+        break;
     }
+    default:
+        break;
+    }
+    m_autoCaptureBusy = false;
 }
 
-void highPreciseDetector::detectPointerFromCenter() {
-    if (m_circles.empty()) {
-        qDebug() << "没有检测到表盘，无法进行指针检测";
-        return;
+void MainWindow::setupAngleRecorder()
+{
+    // 逐帧角度记录：环形文件放在文档目录，程序重启后接着写
+    const QString path = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/PressureGauge_Angles.ring";
+    if (!m_angleRecorder.open(path)) {
+        qDebug() << "角度记录不可用";
     }
-    
-    cv::Mat gray;
-    if (m_image.channels() == 3) {
-        cv::cvtColor(m_image, gray, cv::COLOR_BGR2GRAY);
-    } else {
-        gray = m_image.clone();
+
+    m_recordCheck = new QCheckBox("记录角度", this);
+    QPushButton *plotButton = new QPushButton("角度曲线", this);
+    QFont font = m_recordCheck->font();
+    font.setPointSize(12);
+    font.setBold(true);
+    m_recordCheck->setFont(font);
+    plotButton->setFont(font);
+    plotButton->setMaximumHeight(30);
+    m_recordCheck->setEnabled(m_angleRecorder.isOpen());
+
+    ui->statusBar->addPermanentWidget(m_recordCheck);
+    ui->statusBar->addPermanentWidget(plotButton);
+
+    connect(m_recordCheck, &QCheckBox::toggled, this, [this](bool on) {
+        m_lastAutoProbeMs = -1;
+        qDebug() << (on ? "开始逐帧记录角度" : "停止逐帧记录角度");
+    });
+    connect(plotButton, &QPushButton::clicked, this, [this]() {
+        auto *dlg = new AngleRecordDialog(&m_angleRecorder, this);
+        dlg->setAttribute(Qt::WA_DeleteOnClose);
+        dlg->show();
+    });
+}
+
+void MainWindow::setupSessionJournal()
+{
+    const QString path = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/PressureGauge_Session.journal";
+    if (!m_journal.open(path)) {
+        qDebug() << "采集会话日志不可用:" << m_journal.lastError();
+        return;
     }
-    
-    // 获取表盘中心和半径
-    cv::Point2f center(m_circles[0][0], m_circles[0][1]);
-    float radius = m_circles[0][2];
-    
-    cv::Vec4i bestPointer(-1, -1, -1, -1);
-    
-    // 根据配置参数选择检测算法
-    if (m_config->silverThresholdLow > 0) {
-        // BYQ银色指针检测
-        qDebug() << "检测BYQ银色指针，表盘中心:(" << center.x << "," << center.y << ") 半径:" << radius;
-        bestPointer = detectBYQPointer(gray, center, radius);
-    } else {
-        // YYQY白色指针检测
-        qDebug() << "检测YYQY白色指针，表盘中心:(" << center.x << "," << center.y << ") 半径:" << radius;
-        bestPointer = detectWhitePointer(gray, center, radius);
+
+    m_journalReplaying = true;
+    const int applied = m_journal.replay([this](const JournalEntry& e) { applyJournalEntry(e); });
+    m_journalReplaying = false;
+
+    // 恢复后的状态立刻压成快照，日志从空开始
+    compactJournal();
+    if (applied <= 1) return;   // 只有 Begin：上次没有采集数据
+
+    m_maxAngle = m_session->maxAngle(m_currentRound);
+    m_maxAngleCaptured = m_maxAngle != 0.0;
+    updateDetectionPointLabels();
+    updateDataTable();
+    ui->statusBar->showMessage(QString("已从会话日志恢复上次的采集数据（当前第%1轮），继续采集前请重新归位").arg(m_currentRound + 1), 8000);
+    qDebug() << "会话日志恢复完成：" << applied << "条记录，当前第" << (m_currentRound + 1) << "轮";
+}
+
+MeasurementSession* MainWindow::slotSession(int slot) const
+{
+    return (slot >= 0 && slot < m_slotSessions.size()) ? m_slotSessions[slot] : nullptr;
+}
+
+// 写某表位某轮：每个表位都有自己的会话，一律走会话的写入函数（订阅了当前表位的误差表格只收到这一格的变化）
+void MainWindow::setSessionAngle(int slot, int round, bool isForward, int index, double angle)
+{
+    if (MeasurementSession* session = slotSession(slot)) {
+        session->setAngle(round, isForward ? MeasurementSession::Forward : MeasurementSession::Backward, index, angle);
     }
-    
-    if (bestPointer[0] != -1) {
-        m_lines.clear();
-        m_lines.push_back(bestPointer);
-        double length = sqrt(pow(bestPointer[2] - bestPointer[0], 2) + pow(bestPointer[3] - bestPointer[1], 2));
-        qDebug() << "检测到指针: (" << bestPointer[0] << "," << bestPointer[1] 
-                 << ") 到 (" << bestPointer[2] << "," << bestPointer[3] << "), 长度:" << length;
+}
+
+void MainWindow::setSessionMaxAngle(int slot, int round, double angle)
+{
+    if (MeasurementSession* session = slotSession(slot)) session->setMaxAngle(round, angle);
+}
+
+void MainWindow::clearSessionRound(int slot, int round)
+{
+    if (MeasurementSession* session = slotSession(slot)) session->clearRound(round);
+}
+
+void MainWindow::journalAppend(const JournalEntry& entry)
+{
+    if (m_journalReplaying || !m_journal.isOpen()) return;
+    m_journal.append(entry);
+    // 日志攒多了就压成快照，回放时间不随会话变长
+    if (m_journal.pendingRecords() >= 256) compactJournal();
+}
+
+void MainWindow::journalSlot(JournalOp op, int slot, int round, bool isForward, int index, double angle,
+                             const StepTarget* step)
+{
+    JournalEntry e;
+    e.op = op;
+    e.slot = quint8(slot);
+    e.round = quint8(round);
+    e.stroke = isForward ? 1 : -1;
+    e.index = quint8(index);
+    e.value = angle;
+    if (step) {
+        e.hasReference = true;
+        e.refPressure = step->pressure;
+        e.refTimestampUs = step->timestampUs;
+    }
+    noteReference(e);
+    journalAppend(e);
+}
+
+void MainWindow::journalMaxAngle(int slot, int round, double angle, const StepTarget* step)
+{
+    JournalEntry e;
+    e.op = JournalOp::MaxAngle;
+    e.slot = quint8(slot);
+    e.round = quint8(round);
+    e.value = angle;
+    if (step) {
+        e.hasReference = true;
+        e.refPressure = step->pressure;
+        e.refTimestampUs = step->timestampUs;
+    }
+    noteReference(e);
+    journalAppend(e);
+}
+
+// 格子的键：表位 / 轮 / 行程 / 采集位；最大角度用采集位 0xFF
+quint32 MainWindow::referenceKey(const JournalEntry& e)
+{
+    const bool isMax = e.op == JournalOp::MaxAngle;
+    return (quint32(e.slot) << 24) | (quint32(e.round) << 16)
+         | (quint32(!isMax && e.stroke > 0) << 8) | (isMax ? 0xFFu : quint32(e.index));
+}
+
+// 同一格后来的记录不带参考压力（手动修改、重新采集）时，原来的参考压力作废
+void MainWindow::noteReference(const JournalEntry& e)
+{
+    if (e.op != JournalOp::Reading && e.op != JournalOp::Edit && e.op != JournalOp::MaxAngle) return;
+    if (e.hasReference) {
+        m_referenceEntries.insert(referenceKey(e), e);
     } else {
-        qDebug() << "未能检测到指针，回退到传统方法";
-        detectLines();
+        m_referenceEntries.remove(referenceKey(e));
     }
 }
 
-// 前向声明：在后面匿名命名空间中定义的尖端细化函数
-namespace {
-cv::Point2f rayEdgeFarthest(const cv::Mat& edge,
-                            const cv::Mat& roiMask,
-                            const cv::Point2f& axisCenter,
-                            double angleDeg,
-                            float innerR,
-                            float outerR);
+const JournalEntry* MainWindow::referenceFor(const JournalEntry& e) const
+{
+    const auto it = m_referenceEntries.constFind(referenceKey(e));
+    return (it != m_referenceEntries.constEnd() && it->value == e.value) ? &*it : nullptr;
 }
 
-cv::Vec4i highPreciseDetector::detectWhitePointer(const cv::Mat& gray, const cv::Point2f& center, float radius) {
-    // 确保YYQY模式下不显示转轴中心
-    m_axisCenter = cv::Point2f(-1, -1);
-    
-    // 1. 创建表盘内部的掩码
-    cv::Mat mask = cv::Mat::zeros(gray.size(), CV_8UC1);
-    cv::circle(mask, cv::Point((int)center.x, (int)center.y), (int)(radius * 0.9), cv::Scalar(255), -1);
-    
-    // 2. 检测白色区域 - 使用阈值分割
-    cv::Mat whiteRegions;
-    cv::threshold(gray, whiteRegions, 180, 255, cv::THRESH_BINARY);  // 检测亮区域
-    whiteRegions.copyTo(whiteRegions, mask);  // 仅在表盘内部
-    
-    // 3. 形态学操作连接白色区域
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(3, 3));
-    cv::morphologyEx(whiteRegions, whiteRegions, cv::MORPH_CLOSE, kernel);
-    cv::morphologyEx(whiteRegions, whiteRegions, cv::MORPH_OPEN, kernel);
-    
-    // 4. 查找白色区域的轮廓
-    std::vector<std::vector<cv::Point>> contours;
-    cv::findContours(whiteRegions, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-    
-    cv::Vec4i bestPointer(-1, -1, -1, -1);
-    double maxScore = 0;
-    
-    // 5. 分析每个轮廓，找到最可能的指针
-    for (const auto& contour : contours) {
-        if (contour.size() < 5) continue;  // 轮廓点太少
-        
-        // 计算轮廓的面积
-        double area = cv::contourArea(contour);
-        if (area < 100 || area > radius * radius * 0.3) continue;  // 面积过滤
-        
-        // 拟合椭圆或直线
-        cv::RotatedRect ellipse = cv::fitEllipse(contour);
-        
-        // 检查椭圆的长宽比，指针应该是细长的
-        float aspectRatio = ellipse.size.width / ellipse.size.height;
-        if (aspectRatio < 1) aspectRatio = 1.0f / aspectRatio;  // 确保>1
-        
-        if (aspectRatio < 2.0) continue;  // 不够细长，不像指针
-        
-        // 检查椭圆中心是否接近表盘中心
-        cv::Point2f ellipseCenter = ellipse.center;
-        double distToDialCenter = cv::norm(ellipseCenter - center);
-        if (distToDialCenter > radius * 0.5) continue;  // 中心偏离太远
-        
-        // 计算指针方向和端点 - 修复角度计算
-        double angle = ellipse.angle * CV_PI / 180.0;
-        double length = std::max(ellipse.size.width, ellipse.size.height) / 2.0;
-        
-        // OpenCV的椭圆角度定义：从x轴正方向逆时针测量
-        // 但是我们需要考虑长轴方向
-        if (ellipse.size.width < ellipse.size.height) {
-            // 如果高度>宽度，则长轴是垂直方向，需要调整角度
-            angle += CV_PI / 2.0;
-        }
-        
-        cv::Point2f direction(cos(angle), sin(angle));
-        cv::Point2f startPoint = ellipseCenter - direction * (float)length;
-        cv::Point2f endPoint = ellipseCenter + direction * (float)length;
-        
-        // 确保指针从表盘中心指向外围
-        double dist1 = cv::norm(startPoint - center);
-        double dist2 = cv::norm(endPoint - center);
-        if (dist1 > dist2) {
-            // 如果startPoint离表盘中心更远，说明方向反了
-            std::swap(startPoint, endPoint);
-        }
-        
-        // 进一步调整：确保startPoint是表盘中心附近的点
-        cv::Point2f vectorToCenter = center - ellipseCenter;
-        double distEllipseToCenter = cv::norm(vectorToCenter);
-        if (distEllipseToCenter > 10) {  // 椭圆中心不在表盘中心
-            // 将起点调整为更接近表盘中心的位置
-            cv::Point2f directionToCenter = vectorToCenter / (float)distEllipseToCenter;
-            startPoint = ellipseCenter + directionToCenter * std::min(30.0f, (float)distEllipseToCenter);
-            
-            // 重新计算指针方向（从调整后的起点到椭圆边缘的最远点）
-            cv::Point2f pointerDirection = endPoint - startPoint;
-            float pointerLength = cv::norm(pointerDirection);
-            if (pointerLength > 0) {
-                pointerDirection = pointerDirection / pointerLength;
-                endPoint = startPoint + pointerDirection * (float)length;
-            }
-        }
-        
-        // 计算得分：基于长度、位置和形状
-        double lengthScore = std::min(length / (radius * 0.8), 1.0);  // 长度得分
-        double positionScore = std::max(0.0, 1.0 - distToDialCenter / (radius * 0.3));  // 位置得分
-        double shapeScore = std::min(aspectRatio / 5.0, 1.0);  // 形状得分
-        
-        double totalScore = lengthScore * 0.4 + positionScore * 0.4 + shapeScore * 0.2;
-        
-        if (totalScore > maxScore) {
-            maxScore = totalScore;
-            bestPointer = cv::Vec4i((int)startPoint.x, (int)startPoint.y, 
-                                   (int)endPoint.x, (int)endPoint.y);
-        }
-    }
-    
-    // 6. 如果基于轮廓的方法失败，尝试基于亮度的射线方法
-    if (bestPointer[0] == -1) {
-        bestPointer = detectWhitePointerByBrightness(gray, center, radius);
-    }
+void MainWindow::journalRoundReset(int slot, int round)
+{
+    JournalEntry e;
+    e.op = JournalOp::RoundReset;
+    e.slot = quint8(slot);
+    e.round = quint8(round);
+    journalAppend(e);
+}
 
-    // 7. 尖端细化：使用边缘图在当前方向上由外向内寻找最外侧边缘点，提升尖端稳定性
-    if (bestPointer[0] != -1) {
-        cv::Point2f startPt((float)bestPointer[0], (float)bestPointer[1]);
-        cv::Point2f endPt((float)bestPointer[2], (float)bestPointer[3]);
-        // 以 start->end 的方向确定角度（确保从中心指向外缘）
-        cv::Point2f dir = endPt - startPt;
-        double angleDeg = std::atan2(dir.y, dir.x) * 180.0 / CV_PI;
-        // 构建边缘图
-        cv::Mat edges;
-        cv::Canny(gray, edges, m_config ? m_config->cannyLow : 30, m_config ? m_config->cannyHigh : 100, 3);
-        // 构建 ROI 掩码（表盘内环），避免外部噪声
-        cv::Mat roiMask = cv::Mat::zeros(gray.size(), CV_8UC1);
-        cv::circle(roiMask, cv::Point((int)center.x, (int)center.y), (int)(radius * 0.95f), cv::Scalar(255), -1);
-        // 由外向内搜索该方向的最外侧边缘点
-        cv::Point2f refinedTip = rayEdgeFarthest(edges, roiMask, center, angleDeg, radius * 0.15f, radius * 0.95f);
-        if (refinedTip.x >= 0) {
-            bestPointer[2] = (int)std::lround(refinedTip.x);
-            bestPointer[3] = (int)std::lround(refinedTip.y);
-        }
+void MainWindow::compactJournal()
+{
+    if (m_journalReplaying || !m_journal.isOpen()) return;
+    if (!m_journal.compact(journalSnapshot())) {
+        qDebug() << "会话日志压缩失败:" << m_journal.lastError();
     }
-    
-    qDebug() << "白色指针检测完成，最高得分:" << maxScore;
-    return bestPointer;
 }
 
-cv::Vec4i highPreciseDetector::detectWhitePointerByBrightness(const cv::Mat& gray, const cv::Point2f& center, float radius) {
-    cv::Vec4i bestPointer(-1, -1, -1, -1);
-    double maxScore = 0;
-    
-    // 在多个角度方向搜索最亮的射线
-    for (int angle = 0; angle < 360; angle += 2) {  // 更精细的角度搜索
-        double radian = angle * CV_PI / 180.0;
-        cv::Point2f direction(cos(radian), sin(radian));
-        
-        double totalBrightness = 0;
-        int validPoints = 0;
-        cv::Point2f farthestBrightPoint = center;
-        std::vector<cv::Point2f> brightPoints;  // 记录所有亮点
-        
-        // 从表盘中心附近开始搜索（跳过中心区域，避免干扰）
-        for (int step = 15; step < radius * 0.85; step += 2) {
-            cv::Point2f currentPoint = center + direction * (float)step;
-            
-            if (currentPoint.x < 0 || currentPoint.x >= gray.cols ||
-                currentPoint.y < 0 || currentPoint.y >= gray.rows) {
-                break;
-            }
-            
-            uchar brightness = gray.at<uchar>((int)currentPoint.y, (int)currentPoint.x);
-            
-            // 检测亮点（白色指针）
-            if (brightness > 170) {  // 降低阈值，检测更多亮点
-                totalBrightness += brightness;
-                validPoints++;
-                brightPoints.push_back(currentPoint);
-                
-                double distFromCenter = cv::norm(currentPoint - center);
-                if (distFromCenter > cv::norm(farthestBrightPoint - center)) {
-                    farthestBrightPoint = currentPoint;
+QVector<JournalEntry> MainWindow::journalSnapshot() const
+{
+    QVector<JournalEntry> out;
+    JournalEntry begin;
+    begin.op = JournalOp::Begin;
+    begin.dialType = m_currentDialType;
+    begin.totalRounds = quint8(m_totalRounds);
+    begin.perRound = quint8(m_maxMeasurementsPerRound);
+    begin.slotCount = quint8(m_multiDial.maxDials());
+    out.append(begin);
+
+    // 当前表位紧跟 Begin：回放时先切过去，下面当前表位的完成标记才会落到它的会话上
+    if (m_activeSlot != 0) {
+        JournalEntry active;
+        active.op = JournalOp::ActiveSlot;
+        active.slot = quint8(m_activeSlot);
+        out.append(active);
+    }
+
+    for (int slot = 0; slot < m_slotSessions.size(); ++slot) {
+        const QVector<RoundData> session = m_slotSessions[slot]->data();
+        for (int round = 0; round < session.size(); ++round) {
+            const RoundData &data = session[round];
+            for (int stroke = 0; stroke < 2; ++stroke) {
+                const QVector<double> &angles = stroke == 0 ? data.forwardAngles : data.backwardAngles;
+                const QVector<bool> &valid = stroke == 0 ? data.forwardValid : data.backwardValid;
+                for (int i = 0; i < angles.size(); ++i) {
+                    if (!valid[i]) continue;
+                    JournalEntry e;
+                    e.op = JournalOp::Reading;
+                    e.slot = quint8(slot);
+                    e.round = quint8(round);
+                    e.stroke = stroke == 0 ? 1 : -1;
+                    e.index = quint8(i);
+                    e.value = angles[i];
+                    const JournalEntry* ref = referenceFor(e);
+                    out.append(ref ? *ref : e);
                 }
             }
-        }
-        
-        // 计算这个方向的得分
-        if (validPoints > 8) {  // 需要足够多的亮点
-            double avgBrightness = totalBrightness / validPoints;
-            double pointerLength = cv::norm(farthestBrightPoint - center);
-            double continuity = (double)validPoints / (pointerLength / 2.0);  // 连续性得分
-            
-            // 综合评分：亮度 + 长度 + 连续性
-            double score = (avgBrightness - 170) * 0.4 + 
-                          std::min(pointerLength / (radius * 0.7), 1.0) * 100 * 0.4 + 
-                          std::min(continuity, 1.0) * 100 * 0.2;
-            
-            if (score > maxScore && pointerLength > m_config->pointerMinLength) {
-                maxScore = score;
-                
-                // 使用更精确的端点：找到亮点的质心作为起点
-                cv::Point2f startPoint = center;
-                if (!brightPoints.empty()) {
-                    cv::Point2f centroid(0, 0);
-                    float totalWeight = 0;
-                    
-                    // 计算亮点的加权质心，距离表盘中心近的点权重更大
-                    for (const auto& point : brightPoints) {
-                        float weight = 1.0f / (1.0f + cv::norm(point - center) / 50.0f);
-                        centroid += point * weight;
-                        totalWeight += weight;
-                    }
-                    
-                    if (totalWeight > 0) {
-                        centroid = centroid / totalWeight;
-                        
-                        // 如果质心距离表盘中心合理，使用质心作为起点
-                        if (cv::norm(centroid - center) < radius * 0.4) {
-                            startPoint = centroid;
-                        }
-                    }
-                }
-                
-                bestPointer = cv::Vec4i((int)startPoint.x, (int)startPoint.y,
-                                       (int)farthestBrightPoint.x, (int)farthestBrightPoint.y);
+            if (data.maxAngle != 0.0) {
+                JournalEntry e;
+                e.op = JournalOp::MaxAngle;
+                e.slot = quint8(slot);
+                e.round = quint8(round);
+                e.value = data.maxAngle;
+                const JournalEntry* ref = referenceFor(e);
+                out.append(ref ? *ref : e);
+            }
+            if (slot == m_activeSlot && data.isCompleted) {
+                JournalEntry e;
+                e.op = JournalOp::RoundChange;
+                e.round = quint8(round);
+                e.completed = qint8(round);
+                out.append(e);
             }
         }
     }
-    
-    qDebug() << "基于亮度的白色指针检测完成，最高得分:" << maxScore;
-    return bestPointer;
+
+    JournalEntry current;
+    current.op = JournalOp::RoundChange;
+    current.round = quint8(m_currentRound);
+    out.append(current);
+    return out;
 }
 
-// ===== NEW: 基于"辐射扫描"的顶点寻找（适配白底、细指针） + 边缘细化为"最外侧顶点" =====
-namespace {
-// 在 masked ROI 内，从 axisCenter 向外做辐射扫描，寻找"从内到外的最长连续暗像素段"的末端，
-// 该末端视为指针的粗顶点；同时输出对应的最佳角度（度）。返回 (-1,-1) 表示失败。
-static cv::Point2f radialTipScan(const cv::Mat& gray,
-                                 const cv::Mat& roiMask,
-                                 const cv::Point2f& axisCenter,
-                                 float innerR,
-                                 float outerR,
-                                 double darkThresh,
-                                 double angleStepDeg,
-                                 int    minRunLenPx,
-                                 double* bestAngleOut = nullptr)
+void MainWindow::applyJournalEntry(const JournalEntry& e)
 {
-    auto inBounds = [&](int x, int y){
-        return (unsigned)x < (unsigned)gray.cols && (unsigned)y < (unsigned)gray.rows;
-    };
+    switch (e.op) {
+    case JournalOp::Begin:
+        // 会话开头：表盘类型/轮数/表数与记录一致后重建空会话
+        if (!e.dialType.isEmpty() && e.dialType != m_currentDialType) {
+            m_dialTypeCombo->setCurrentText(e.dialType);
+        }
+        if (e.slotCount >= 1 && e.slotCount != m_multiDial.maxDials()) {
+            m_dialCountSpin->setValue(e.slotCount);   // 触发 onDialCountChanged
+        }
+        // 走 setTotalRounds：空会话、数据表、标签和误差表格的轮数一起更新
+        setTotalRounds((e.totalRounds >= 1 && e.totalRounds <= 10) ? e.totalRounds : m_totalRounds);
+        if (e.perRound >= 1 && e.perRound != m_maxMeasurementsPerRound) {
+            qDebug() << "会话日志每轮次数" << e.perRound << "与表盘默认" << m_maxMeasurementsPerRound << "不同，按日志恢复";
+            m_maxMeasurementsPerRound = e.perRound;
+            resetSlotSessions();
+        }
+        break;
+    case JournalOp::ActiveSlot:
+        // 换表位会把当前会话换进换出，后面的记录照常按表位号写入
+        if (e.slot < m_activeSlotCombo->count()) m_activeSlotCombo->setCurrentIndex(e.slot);
+        break;
+    case JournalOp::Reading:
+    case JournalOp::Edit:
+        setSessionAngle(e.slot, e.round, e.stroke > 0, e.index, e.value);
+        noteReference(e);
+        break;
+    case JournalOp::MaxAngle:
+        setSessionMaxAngle(e.slot, e.round, e.value);
+        noteReference(e);
+        break;
+    case JournalOp::RoundReset:
+        clearSessionRound(e.slot, e.round);
+        break;
+    case JournalOp::RoundChange:
+        if (e.completed >= 0) m_session->setCompleted(e.completed, true);
+        if (e.round < m_totalRounds) m_currentRound = e.round;
+        break;
+    }
+}
+
+AngleTracker& MainWindow::liveTracker(int slot)
+{
+    if (slot >= int(m_liveTrackers.size())) m_liveTrackers.resize(slot + 1);
+    return m_liveTrackers[slot];
+}
 
-    int bestRun = 0;
-    cv::Point2f bestTip(-1.f, -1.f);
-    double bestAngle = 0.0;
-
-    const double toRad = CV_PI/180.0;
-    // 粗扫：角度步进 angleStepDeg
-    for (double deg = 0.0; deg < 360.0; deg += angleStepDeg) {
-        double cs = std::cos(deg*toRad), sn = std::sin(deg*toRad);
-        int runLen = 0;
-        cv::Point2f tip(-1.f, -1.f);
-
-        for (float r = innerR; r <= outerR; r += 1.0f) {
-            int x = (int)std::lround(axisCenter.x + r*cs);
-            int y = (int)std::lround(axisCenter.y + r*sn);
-            if (!inBounds(x,y)) break;
-            if (roiMask.data && roiMask.type()==CV_8U && roiMask.at<uchar>(y,x)==0) {
-                // 出了感兴趣环区
-                if (runLen > bestRun) { bestRun = runLen; bestTip = tip; bestAngle = deg; }
-                runLen = 0; tip = cv::Point2f(-1,-1);
-                continue;
-            }
-            uchar val = gray.at<uchar>(y,x);
-            if (val < darkThresh) {
-                // 暗像素 -> 认为属于指针
-                runLen++;
-                tip = cv::Point2f((float)x,(float)y); // 记录末端
-            } else {
-                // 明 -> 断开
-                if (runLen > bestRun) { bestRun = runLen; bestTip = tip; bestAngle = deg; }
-                runLen = 0; tip = cv::Point2f(-1,-1);
-            }
+void MainWindow::syncLiveTrackers()
+{
+    if (isMultiDialMode()) {
+        for (const DialSlot& s : m_multiDial.slots()) liveTracker(s.id) = s.tracker;
+    } else {
+        liveTracker(0) = m_angleTracker;
+    }
+}
+
+void MainWindow::updateLiveTrackers(double absDeg)
+{
+    if (isMultiDialMode()) {
+        for (const DialSlot& s : m_multiDial.slots()) {
+            if (s.lastAbs != -999) liveTracker(s.id).update(s.lastAbs);
         }
-        if (runLen > bestRun) { bestRun = runLen; bestTip = tip; bestAngle = deg; }
-    }
-
-    if (bestRun < minRunLenPx || bestTip.x < 0) return cv::Point2f(-1.f,-1.f);
-
-    // 细化：在最佳角附近 ±2° 再做更细的角步进与半径半步
-    int refineBest = bestRun;
-    cv::Point2f refineTip = bestTip;
-    for (double deg = bestAngle-2.0; deg <= bestAngle+2.0; deg += std::max(0.2, angleStepDeg*0.3)) {
-        double cs = std::cos(deg*toRad), sn = std::sin(deg*toRad);
-        int runLen = 0;
-        cv::Point2f tip(-1.f, -1.f);
-        for (float r = innerR; r <= outerR; r += 0.5f) {
-            int x = (int)std::lround(axisCenter.x + r*cs);
-            int y = (int)std::lround(axisCenter.y + r*sn);
-            if (!inBounds(x,y)) break;
-            if (roiMask.data && roiMask.type()==CV_8U && roiMask.at<uchar>(y,x)==0) {
-                if (runLen > refineBest) { refineBest = runLen; refineTip = tip; }
-                runLen = 0; tip = cv::Point2f(-1,-1);
-                continue;
-            }
-            uchar val = gray.at<uchar>(y,x);
-            if (val < darkThresh) { runLen++; tip = cv::Point2f((float)x,(float)y); }
-            else {
-                if (runLen > refineBest) { refineBest = runLen; refineTip = tip; }
-                runLen = 0; tip = cv::Point2f(-1,-1);
-            }
+    } else if (absDeg != -999) {
+        liveTracker(0).update(absDeg);
+    }
+}
+
+void MainWindow::recordAngles(double absDeg, AngleRecordEvent event)
+{
+    const bool live = (event == AngleRecordEvent::Live);
+    if (!live) syncLiveTrackers();  // 采集/归位刚更新了展开角，实时跟踪器跟上
+    if (!m_angleRecorder.isOpen()) return;
+
+    const std::int64_t ts = AngleRecorder::nowUs();
+    auto makeRecord = [&](int slot, double abs, const AngleTracker& tracker) {
+        if (slot >= int(m_recordStats.size())) m_recordStats.resize(slot + 1);
+        AngleRecord r;
+        r.timestampUs = ts;
+        r.slot = std::uint8_t(slot);
+        r.event = event;
+        if (abs == -999) {
+            r.absDeg = std::numeric_limits<double>::quiet_NaN();
+            r.unwrappedDeg = tracker.unwrapped();
+            r.relativeDeg = tracker.hasZero() ? tracker.relative() : 0.0;
+            return r;
+        }
+        // 实时帧：逐帧增量很小，方向判定阈值放低；采集帧沿用采集时的判定阈值
+        r.absDeg = norm0_360(abs);
+        r.unwrappedDeg = tracker.unwrapped();
+        r.relativeDeg = tracker.hasZero() ? tracker.relative() : 0.0;
+        r.direction = std::int8_t(live ? strokeDirectionFromDelta(tracker.lastDelta(), 0.1)
+                                       : strokeDirectionFromDelta(tracker.lastDelta()));
+        m_recordStats[slot].push(abs);
+        r.confidence = float(m_recordStats[slot].resultantLength());
+        return r;
+    };
+
+    if (isMultiDialMode()) {
+        for (const DialSlot& s : m_multiDial.slots()) {
+            m_angleRecorder.append(makeRecord(s.id, s.lastAbs, live ? liveTracker(s.id) : s.tracker));
         }
-        if (runLen > refineBest) { refineBest = runLen; refineTip = tip; }
+    } else {
+        m_angleRecorder.append(makeRecord(0, absDeg, live ? liveTracker(0) : m_angleTracker));
     }
+}
 
-    if (refineBest >= minRunLenPx && refineTip.x >= 0) {
-        if (bestAngleOut) *bestAngleOut = bestAngle; // 仍返回粗扫的角度以保持稳定
-        return refineTip;
+void MainWindow::showSweepCalibrationDialog()
+{
+    if (m_sweepDialog) {
+        m_sweepDialog->show();
+        m_sweepDialog->raise();
+        m_sweepDialog->activateWindow();
+        return;
     }
-    if (bestAngleOut) *bestAngleOut = bestAngle;
-    return bestTip;
+    if (!activeHasZero()) {
+        QMessageBox::information(this, "提示", "请先点击『归位』按钮设定零位，再开始扫描标定");
+    }
+
+    // 满量程压力与误差表一致：YYQY-13=6.3MPa，BYQ-19=25MPa
+    const double fullScale = (m_currentDialType == "BYQ-19") ? 25.0 : 6.3;
+    m_sweepDialog = new SweepCalibrationDialog(m_currentDialType, m_detectionPoints, fullScale, this);
+    m_sweepDialog->setAttribute(Qt::WA_DeleteOnClose);
+    connect(m_sweepDialog, &SweepCalibrationDialog::applyToRound, this, &MainWindow::onSweepApplied);
+    connect(m_sweepDialog, &SweepCalibrationDialog::pointReached, this, &MainWindow::onPressurePointReached);
+    syncLiveTrackers();
+    m_lastAutoProbeMs = -1;
+    m_sweepDialog->show();
 }
 
-// 在给定角度上，沿射线"由外向内"搜索边缘图的第一个边缘像素，
-// 该点可理解为"最外侧的顶点"（更贴近真实几何边界）。
-static cv::Point2f rayEdgeFarthest(const cv::Mat& edge,
-                                   const cv::Mat& roiMask,
-                                   const cv::Point2f& axisCenter,
-                                   double angleDeg,
-                                   float innerR,
-                                   float outerR)
+void MainWindow::onSweepApplied(const QVector<double>& forward, const QVector<double>& backward, double maxAngle)
 {
-    auto inBounds = [&](int x, int y){
-        return (unsigned)x < (unsigned)edge.cols && (unsigned)y < (unsigned)edge.rows;
-    };
-    const double toRad = CV_PI/180.0;
-    double cs = std::cos(angleDeg*toRad), sn = std::sin(angleDeg*toRad);
-    for (float r = outerR; r >= innerR; r -= 0.5f) { // 从外往里找 -> 第一处就是"最边缘"
-        int x = (int)std::lround(axisCenter.x + r*cs);
-        int y = (int)std::lround(axisCenter.y + r*sn);
-        if (!inBounds(x,y)) continue;
-        if (roiMask.data && roiMask.type()==CV_8U && roiMask.at<uchar>(y,x)==0) continue;
-        if (edge.at<uchar>(y,x) > 0) {
-            return cv::Point2f((float)x,(float)y);
+    if (!m_session->hasRound(m_currentRound)) return;
+
+    // 整轮换成扫描结果：先清空，再写入扫到的点（NaN = 该点没扫到，留空）
+    // 检测点与采集位一一对应（反行程数组同样按检测点顺序存放）
+    m_session->clearRound(m_currentRound);
+    journalRoundReset(m_activeSlot, m_currentRound);
+    const int slots = m_session->slotsPerRound();
+    for (int i = 0; i < slots && i < forward.size(); ++i) {
+        if (std::isnan(forward[i])) continue;
+        m_session->setAngle(m_currentRound, MeasurementSession::Forward, i, forward[i]);
+        journalSlot(JournalOp::Reading, m_activeSlot, m_currentRound, true, i, forward[i]);
+    }
+    for (int i = 0; i < slots && i < backward.size(); ++i) {
+        if (std::isnan(backward[i])) continue;
+        m_session->setAngle(m_currentRound, MeasurementSession::Backward, i, backward[i]);
+        journalSlot(JournalOp::Reading, m_activeSlot, m_currentRound, false, i, backward[i]);
+    }
+    m_session->setMaxAngle(m_currentRound, std::abs(maxAngle));
+    m_session->setCompleted(m_currentRound, true);
+    journalMaxAngle(m_activeSlot, m_currentRound, std::abs(maxAngle));
+    JournalEntry done;
+    done.op = JournalOp::RoundChange;
+    done.round = quint8(m_currentRound);
+    done.completed = qint8(m_currentRound);
+    journalAppend(done);
+    m_maxAngle = std::abs(maxAngle);
+    m_maxAngleCaptured = true;
+
+    updateDataTable();
+    ui->statusBar->showMessage(QString("扫描结果已写入第%1轮").arg(m_currentRound + 1), 3000);
+    qDebug() << "扫描标定结果写入第" << (m_currentRound + 1) << "轮，满量程角度:" << maxAngle;
+}
+
+void MainWindow::onPressurePointReached(int pointIndex, bool forward, bool isMax, double pressure, qint64 timestampUs)
+{
+    qDebug() << "压力到点:" << pressure << "MPa" << (isMax ? "满量程" : forward ? "正行程" : "反行程")
+             << "检测点" << (pointIndex + 1) << "时间戳(us):" << timestampUs;
+
+    // 检测点跟随压力源走，误差表的当前点一起切换
+    if (!isMax) {
+        setCurrentDetectionPoint(pointIndex);
+        if (m_errorTableDialog && pointIndex < m_detectionPoints.size())
+            m_errorTableDialog->setCurrentPressurePoint(m_detectionPoints[pointIndex]);
+    }
+
+    // 无人值守：走"采集 + 确定"的非交互路径（不弹框），读数写到压力源所在的检测点和行程，
+    // 日志里和到点时的参考压力记在一起；满量程步写最大角度
+    StepTarget step;
+    step.slot = pointIndex;
+    step.forward = forward;
+    step.pressure = pressure;
+    step.timestampUs = timestampUs;
+
+    bool ok = false;
+    double rel = 0.0;
+    if (captureCurrentAngle(false)) {
+        rel = m_lastCalculatedDelta;
+        if (isMax) {
+            m_tempMaxAngle = std::abs(rel);
+            m_tempCurrentAngle = rel;
+            m_maxAngleCaptureMode = true;
+            confirmCurrentData(false, &step);
+            ok = !m_maxAngleCaptureMode;
+            m_maxAngleCaptureMode = false;
+        } else {
+            confirmCurrentData(false, &step);
+            const int stroke = forward ? MeasurementSession::Forward : MeasurementSession::Backward;
+            ok = m_session->hasAngle(m_currentRound, stroke, pointIndex)
+                 && m_session->angle(m_currentRound, stroke, pointIndex) == rel;
         }
     }
-    return cv::Point2f(-1.f,-1.f);
+
+    if (ok) {
+        ui->statusBar->showMessage(QString("参考压力 %1 MPa 已采集: %2°").arg(pressure, 0, 'f', 3).arg(rel, 0, 'f', 2), 3000);
+    }
+    if (m_sweepDialog) m_sweepDialog->confirmPoint(ok, rel);
 }
+
+void MainWindow::onErrorTableAngleEdited(int pointIndex, bool forward, double value)
+{
+    // 误差表格的检测点 i 就是采集位 i；写回共用的会话后表格自己会收到这一格的变化
+    const int round = m_errorTableDialog ? m_errorTableDialog->getCurrentRound() : m_currentRound;
+    if (!m_session->hasRound(round) || pointIndex < 0 || pointIndex >= m_session->slotsPerRound()) return;
+
+    m_session->setAngle(round, forward ? MeasurementSession::Forward : MeasurementSession::Backward, pointIndex, value);
+    journalSlot(JournalOp::Edit, m_activeSlot, round, forward, pointIndex, value);
+    updateDataTable();
+    qDebug() << "误差表格修改: 第" << (round + 1) << "轮" << (forward ? "正行程" : "反行程")
+             << "采集数据" << (pointIndex + 1) << "=" << value;
 }
-void highPreciseDetector::calculateAngle() {
-    if (m_lines.empty()) {
-        m_angle = -999;
-        return;
+
+void MainWindow::drawAutoCaptureCountdown(double progress, const QString& text)
+{
+    QPixmap pm = ui->srcDisplay->pixmap();
+    if (pm.isNull()) return;
+
+    // 右上角画一个进度环：前半圈=稳定帧累计，后半圈=等待倒计时
+    const int r = 28;
+    const QRect box(pm.width() - 2 * r - 12, 12, 2 * r, 2 * r);
+    QPainter painter(&pm);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 140));
+    painter.drawEllipse(box);
+    painter.setPen(QPen(progress < 0.5 ? QColor(255, 200, 0) : QColor(0, 220, 0), 5));
+    painter.drawArc(box.adjusted(4, 4, -4, -4), 90 * 16, -int(std::clamp(progress, 0.0, 1.0) * 360 * 16));
+    painter.setPen(Qt::white);
+    QFont f = painter.font();
+    f.setPointSize(11);
+    f.setBold(true);
+    painter.setFont(f);
+    painter.drawText(box, Qt::AlignCenter, text);
+    painter.end();
+
+    ui->srcDisplay->setPixmap(pm);
+}
+
+void MainWindow::onDialCountChanged(int count)
+{
+    // 表数变化后表位重新编号，零位和各表位会话都要重来
+    m_multiDial.setMaxDials(count);
+    m_slotCapturedRel.clear();
+    m_liveStats.clear();
+
+    m_activeSlotCombo->blockSignals(true);
+    m_activeSlotCombo->clear();
+    for (int i = 0; i < count; ++i) {
+        m_activeSlotCombo->addItem(QString("表位%1").arg(i + 1));
     }
+    m_activeSlotCombo->setCurrentIndex(0);
+    m_activeSlotCombo->setEnabled(count > 1);
+    m_activeSlotCombo->blockSignals(false);
+    m_activeSlot = 0;
+
+    initializeRoundsData();
+    resetStrokeTracking();
+    updateDataTable();
+
+    ui->labelAngle->setText(count > 1 ? QString("同框%1块表，请重新归位").arg(count) : QString("请重新归位"));
+    qDebug() << "同框表数设置为:" << count;
+}
+
+void MainWindow::onActiveSlotChanged(int index)
+{
+    if (index < 0 || index == m_activeSlot || index >= m_slotSessions.size()) return;
+
+    // 各表位的会话各自常驻，切换只换指向；误差表格改订阅新表位的会话（会整体重读一次）
+    m_activeSlot = index;
+    m_session = m_slotSessions[index];
+    if (m_errorTableDialog) m_errorTableDialog->setMeasurementSession(m_session);
+    m_liveStats.clear();
+    m_settle.reset();
+
+    resetStrokeTracking();
+    updateDataTable();
+    updateDetectionPointLabels();
+
+    JournalEntry active;
+    active.op = JournalOp::ActiveSlot;
+    active.slot = quint8(index);
+    journalAppend(active);
+
+    ui->statusBar->showMessage(QString("已切换到表位%1").arg(index + 1), 3000);
+    qDebug() << "切换当前表位:" << (index + 1);
+}
+
+void MainWindow::initPointerConfigs()
+{
+    // 各表盘类型的默认参数由对应的检测流水线给出
+    m_yyqyConfig = YYQYPipeline::defaultConfig();   // YYQY - 针对白色指针优化
+    m_byqConfig = BYQPipeline::defaultConfig();     // BYQ - 针对银色指针末端和转轴检测优化
+    
+    // 如果文档目录下有 dial_tune 生成的调参结果，用文件里选定的那组（失败率达标的候选中误差最小的）
+    const QString docDir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    auto loadTuned = [&docDir](const QString& fileName, PointerDetectionConfig& config) {
+        const QString path = docDir + "/" + fileName;
+        if (!QFileInfo::exists(path)) return;
+        std::vector<TuneCandidate> front;
+        int selected = -1;
+        if (loadParetoFront(path.toStdString(), front, selected) && front[selected].config.kind == config.kind) {
+            const TuneCandidate& tuned = front[selected];
+            config = tuned.config;
+            qDebug() << "已加载调参结果:" << path << "第" << selected << "组 平均误差" << tuned.score.meanAbsErrDeg
+                     << "失败率" << tuned.score.failureRate << "耗时" << tuned.score.msPerFrame << "ms";
+        } else {
+            qDebug() << "调参结果无效，使用默认参数:" << path;
+        }
+    };
+    loadTuned("PointerTuning_YYQY.json", m_yyqyConfig);
+    loadTuned("PointerTuning_BYQ.json", m_byqConfig);
     
-    cv::Vec4i line = m_lines[0];
-    
-    // 计算直线的角度（相对于水平方向）
-    double dx = line[2] - line[0];
-    double dy = line[3] - line[1];
-    
-    // 使用atan2计算角度，结果范围是 -π 到 π
-    double angle_rad = atan2(dy, dx);
-    
-    // 转换为度数，范围 -180 到 180
-    double angle_deg = angle_rad * 180.0 / CV_PI;
+    // 设置默认配置
+    m_currentConfig = &m_yyqyConfig;
     
-    // 转换为 0 到 360 度范围
-    if (angle_deg < 0) {
-        angle_deg += 360;
+    qDebug() << "指针识别配置初始化完成 - 白色指针优化版本";
+}
+
+void MainWindow::switchPointerConfig(const QString& dialType)
+{
+    m_liveStats.clear();  // 换表型后历史角度没有参考意义
+    if (dialType == "YYQY-13") {
+        m_currentConfig = &m_yyqyConfig;
+        qDebug() << "切换到YYQY-13指针识别配置";
+    } else if (dialType == "BYQ-19") {
+        m_currentConfig = &m_byqConfig;
+        qDebug() << "切换到BYQ-19指针识别配置";
     }
-    
-    m_angle = angle_deg;
-    qDebug() << "计算得到角度:" << m_angle << "度";
 }
 
-void highPreciseDetector::showScale1Result() {
-    m_visual = m_image.clone();
+void MainWindow::onDialTypeChanged(const QString &dialType)
+{
+    m_currentDialType = dialType;
+    switchPointerConfig(dialType);  // 切换指针识别配置
     
-    // 绘制检测到的圆形（表盘）
-    for (const auto& circle : m_circles) {
-        cv::Point center(cvRound(circle[0]), cvRound(circle[1]));
-        int radius = cvRound(circle[2]);
-        // 绘制圆心（绿色）
-        cv::circle(m_visual, center, 3, cv::Scalar(0, 255, 0), -1, 8, 0);
-        // 绘制圆周（蓝色）
-        cv::circle(m_visual, center, radius, cv::Scalar(255, 0, 0), 2, 8, 0);
-    }
+    // 重新初始化数据数组和显示
+    initializeDataArrays();
     
-    // 绘制BYQ转轴中心（只在BYQ模式下且检测到转轴时显示）
-    if (m_config && m_config->dialType == "BYQ" && m_axisCenter.x != -1 && m_axisCenter.y != -1 && m_axisRadius > 0) {
-        cv::Point axisPoint(cvRound(m_axisCenter.x), cvRound(m_axisCenter.y));
-        
-        // 绘制转轴中心点（绿色小圆点）
-        cv::circle(m_visual, axisPoint, 4, cv::Scalar(0, 255, 0), -1, 8, 0);
-        
-        // 如果检测到了两条黑线，绘制共线和垂线
-        if (m_hasBlackLines) {
-            // 收集两条黑线的四个端点
-            cv::Point2f p1(m_blackLine1[0], m_blackLine1[1]);
-            cv::Point2f p2(m_blackLine1[2], m_blackLine1[3]);
-            cv::Point2f p3(m_blackLine2[0], m_blackLine2[1]);
-            cv::Point2f p4(m_blackLine2[2], m_blackLine2[3]);
-            
-            // 计算共线方向（使用两条黑线的平均方向）
-            cv::Point2f dir1 = p2 - p1;
-            cv::Point2f dir2 = p4 - p3;
-            // 确保方向一致（点积为正）
-            if (dir1.x * dir2.x + dir1.y * dir2.y < 0) {
-                dir2 = -dir2;
-            }
-            cv::Point2f avgDir = dir1 + dir2;
-            float avgDirLen = cv::norm(avgDir);
-            if (avgDirLen > 0) {
-                avgDir = avgDir / avgDirLen;
-            } else {
-                avgDir = cv::Point2f(1, 0);  // 默认水平
-            }
-            
-            // 按照方向投影排序四个端点
-            std::vector<cv::Point2f> allPoints = {p1, p2, p3, p4};
-            std::sort(allPoints.begin(), allPoints.end(), 
-                [&avgDir](const cv::Point2f& a, const cv::Point2f& b) {
-                    return (a.x * avgDir.x + a.y * avgDir.y) < (b.x * avgDir.x + b.y * avgDir.y);
-                });
-            
-            cv::Point2f leftMost = allPoints[0];
-            cv::Point2f rightMost = allPoints[3];
-            
-            // 绘制青色共线（从最左点到最右点）
-            cv::line(m_visual, 
-                     cv::Point(cvRound(leftMost.x), cvRound(leftMost.y)),
-                     cv::Point(cvRound(rightMost.x), cvRound(rightMost.y)),
-                     cv::Scalar(255, 255, 0), 2, cv::LINE_AA);
-            
-            // 绘制从表盘圆心到转轴中心（m_axisCenter）的绿色垂线
-            // m_axisCenter 已经是 detectBYQAxis 计算好的垂足或间隙中点
-            if (!m_circles.empty()) {
-                cv::Point2f dialCenter(m_circles[0][0], m_circles[0][1]);
-                cv::line(m_visual, 
-                         cv::Point(cvRound(dialCenter.x), cvRound(dialCenter.y)),
-                         cv::Point(cvRound(m_axisCenter.x), cvRound(m_axisCenter.y)),
-                         cv::Scalar(0, 255, 0), 2, cv::LINE_AA);
-            }
-        }
-        
-        // 添加标注文字
-        std::string axisText = "Axis";
-        cv::putText(m_visual, axisText, cv::Point(axisPoint.x + 10, axisPoint.y - 5), 
-                   cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 255, 0), 1);
-    }
-    
-    // 绘制检测到的直线（指针）
-    for (const auto& line : m_lines) {
-        // 在BYQ模式下，如果检测到转轴中心，绘制从转轴中心到指针顶点的连线
-        if (m_config && m_config->dialType == "BYQ" && m_axisCenter.x != -1 && m_axisCenter.y != -1) {
-            // 新的辐射扫描算法返回的数据格式：
-            // line[0], line[1] = 转轴中心坐标（从detectSilverPointerEnd返回）
-            // line[2], line[3] = 指针顶点坐标
-            cv::Point2f tipPoint(line[2], line[3]);
-            
-            // 验证tipPoint有效：必须在圆心上方（y值小于圆心y值）且坐标有效
-            bool tipValid = (tipPoint.x > 0 && tipPoint.y > 0 && 
-                            !m_circles.empty() && tipPoint.y < m_circles[0][1]);
-            
-            if (tipValid) {
-                // 绘制从转轴中心到黄色点的连线（红色极细线）
-                cv::line(m_visual, 
-                    cv::Point(cvRound(m_axisCenter.x), cvRound(m_axisCenter.y)), 
-                    cv::Point(cvRound(tipPoint.x), cvRound(tipPoint.y)), 
-                    cv::Scalar(0, 0, 255), 1, cv::LINE_AA);
-            
-                // 在指针顶点处绘制一个小圆圈（黄色）
-                cv::circle(m_visual, cv::Point(cvRound(tipPoint.x), cvRound(tipPoint.y)), 5, cv::Scalar(0, 255, 255), -1, 8, 0);
-            }
-        } else {
-            // 其他模式或未检测到转轴时，使用原来的绘制方式
-            cv::line(m_visual, 
-                    cv::Point(line[0], line[1]), 
-                    cv::Point(line[2], line[3]), 
-                    cv::Scalar(0, 0, 255), 3, cv::LINE_AA);
-        }
-    }
+    // 更新检测点标签显示
+    updateDetectionPointLabels();
     
-    if (m_angle != -999) {
-        std::string angleText = "Abs: " + std::to_string(m_angle) + "°";
-        cv::putText(m_visual, angleText, cv::Point(10, 30), 
-                   cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(255, 255, 0), 2);
-    }
+    qDebug() << "表盘类型切换为:" << dialType << "需要数据数量:" << m_requiredDataCount;
 }
 
 void MainWindow::setupExpandedLayout()
@@ -1905,10 +2033,11 @@ void MainWindow::setupExpandedLayout()
 }
 
 void MainWindow::updatePointerDirection(double currentAngle) {
-    // NEW: 方向判断统一基于最近一次展开角增量 m_lastDelta
+    // NEW: 方向判断统一基于最近一次展开角增量
     Q_UNUSED(currentAngle);
     const double minAngleThreshold = 2.0;
-    double angleDelta = m_lastDelta; // 已由 processAbsAngle 更新
+    const AngleTracker* tracker = activeTracker();
+    double angleDelta = tracker ? tracker->lastDelta() : 0.0; // 已由 processAbsAngle 更新
     if (std::abs(angleDelta) > minAngleThreshold) {
         if (angleDelta > 0) {
             m_strokeDirection = 1;
@@ -1945,58 +2074,14 @@ void MainWindow::resetStrokeTracking() {
 }
 
 double MainWindow::measureAngleMultipleTimes(const cv::Mat& frame, int measureCount) {
-    std::vector<double> angles;
-    angles.reserve(std::max(1, measureCount));
-
-    qDebug() << "开始进行" << measureCount << "次角度测量(圆统计均值)";
-    for (int i = 0; i < measureCount; ++i) {
-        try {
-            highPreciseDetector det(frame, m_currentConfig);
-            if (!det.getLine().empty()) {
-                double a = det.getAngle(); // 0~360
-                if (a != -999) {
-                    angles.push_back(norm0_360(a));
-                    qDebug() << "第" << (i + 1) << "次测量角度:" << a;
-                } else {
-                    qDebug() << "第" << (i + 1) << "次测量失败：角度计算错误";
-                }
-            } else {
-                qDebug() << "第" << (i + 1) << "次测量失败：未检测到指针";
-            }
-        } catch (const std::exception& e) {
-            qDebug() << "第" << (i + 1) << "次测量异常:" << e.what();
-        }
+    // 多次检测 + 圆统计均值，实现在识别核心库
+    if (isMultiDialMode()) {
+        // 多表：各表位并行测量，返回当前表位的绝对角
+        m_multiDial.measure(frame, m_currentConfig, measureCount);
+        const DialSlot* s = m_multiDial.slot(m_activeSlot);
+        return s ? s->lastAbs : -999;
     }
-
-    if (angles.empty()) {
-        qDebug() << "所有测量都失败";
-        return -999;
-    }
-    if (angles.size() == 1) {
-        qDebug() << "仅有1次有效测量，直接返回:" << angles[0];
-        return angles[0];
-    }
-
-    // 先做一次圆均值
-    double mean0 = circularMeanDeg(angles);
-
-    // 用"最短角差"的绝对偏差做简单鲁棒过滤
-    double sumAbsDiff = 0.0;
-    for (double a : angles) sumAbsDiff += std::abs(wrapSigned180(a - mean0));
-    double mad = sumAbsDiff / angles.size();
-    double thr = std::max(5.0, 2.5 * mad); // 至少5°或2.5*MAD
-
-    std::vector<double> filtered;
-    filtered.reserve(angles.size());
-    for (double a : angles) {
-        double d = std::abs(wrapSigned180(a - mean0));
-        if (d <= thr) filtered.push_back(a);
-    }
-    if (filtered.size() < 2) filtered = angles; // 兜底
-
-    double mean = circularMeanDeg(filtered);
-    qDebug() << "圆均值:" << mean << " 样本数:" << filtered.size();
-    return mean; // 返回稳定 Abs 角 [0,360)
+    return measurePointerAngle(frame, m_currentConfig, measureCount);
 }
 
 
@@ -2047,12 +2132,12 @@ void MainWindow::updateDataDisplayVisibility()
 void MainWindow::updateDataTable()
 {
     // 获取当前轮次数据
-    if (m_currentRound >= m_allRoundsData.size()) {
+    if (!m_session->hasRound(m_currentRound)) {
         qDebug() << "当前轮次超出范围，无法更新数据表格";
         return;
     }
     
-    const RoundData &currentRound = m_allRoundsData[m_currentRound];
+    const RoundData currentRound = m_session->round(m_currentRound);
     
     // 更新正行程数据显示
     QLabel* forwardLabels[6] = {
@@ -2061,13 +2146,10 @@ void MainWindow::updateDataTable()
     };
     
     for (int i = 0; i < 6; ++i) {
-        if (i < currentRound.forwardAngles.size() && currentRound.forwardAngles[i] != 0.0) {
+        // 第一个位置归位后就是 0°，和其他读数一样显示
+        if (m_session->hasAngle(m_currentRound, MeasurementSession::Forward, i)) {
             forwardLabels[i]->setText(QString::number(currentRound.forwardAngles[i], 'f', 2) + "°");
             forwardLabels[i]->setStyleSheet("QLabel { border: 1px solid #ccc; padding: 3px; background-color: #d4edda; }");
-        } else if (i < currentRound.forwardAngles.size() && currentRound.forwardAngles[i] == 0.0 && i == 0) {
-            // 第一个位置显示0度（归位数据）
-            forwardLabels[i]->setText("0.00°");
-            forwardLabels[i]->setStyleSheet("QLabel { border: 1px solid #ccc; padding: 3px; background-color: #d4edda; }");
         }
     }
     
@@ -2080,7 +2162,7 @@ void MainWindow::updateDataTable()
     for (int i = 0; i < 6; ++i) {
         int dataIndex = i;  // 直接映射：采集数据1对应数组位置1，采集数据6对应数组位置6
         
-        if (dataIndex >= 0 && dataIndex < currentRound.backwardAngles.size() && currentRound.backwardAngles[dataIndex] != 0.0) {
+        if (m_session->hasAngle(m_currentRound, MeasurementSession::Backward, dataIndex)) {
             reverseLabels[i]->setText(QString::number(currentRound.backwardAngles[dataIndex], 'f', 2) + "°");
             reverseLabels[i]->setStyleSheet("QLabel { border: 1px solid #ccc; padding: 3px; background-color: #cce7ff; }");
             qDebug() << "反行程显示：采集数据" << (i + 1) << "显示数据" << currentRound.backwardAngles[dataIndex] << "（来自数组位置" << (dataIndex + 1) << "）";
@@ -2133,25 +2215,37 @@ void MainWindow::addDataToCurrentStroke(double angle)
 // 确定按钮点击处理
 void MainWindow::onConfirmData()
 {
-    if (!m_hasZero) {
-        QMessageBox::warning(this, "警告", "请先进行归位操作！");
+    confirmCurrentData(true);
+}
+
+void MainWindow::confirmCurrentData(bool interactive, const StepTarget* step)
+{
+    if (!activeHasZero()) {
+        reportOperationProblem(interactive, "警告", "请先进行归位操作！");
         return;
     }
     
     // 检查是否处于最大角度采集模式
     if (m_maxAngleCaptureMode) {
         // 最大角度采集模式：保存最大角度
-        if (m_currentRound < m_allRoundsData.size()) {
-            m_allRoundsData[m_currentRound].maxAngle = m_tempMaxAngle;
+        if (m_session->hasRound(m_currentRound)) {
+            m_session->setMaxAngle(m_currentRound, m_tempMaxAngle);
             m_maxAngle = m_tempMaxAngle;
             m_maxAngleCaptured = true;
+            journalMaxAngle(m_activeSlot, m_currentRound, m_tempMaxAngle, step);
+            for (int slot = 0; slot < m_slotSessions.size() && slot < m_slotCapturedRel.size(); ++slot) {
+                if (slot == m_activeSlot || std::isnan(m_slotCapturedRel[slot])) continue;
+                if (m_slotSessions[slot]->hasRound(m_currentRound)) {
+                    m_slotSessions[slot]->setMaxAngle(m_currentRound, std::abs(m_slotCapturedRel[slot]));
+                    journalMaxAngle(slot, m_currentRound, std::abs(m_slotCapturedRel[slot]), step);
+                }
+            }
             
             // 退出最大角度采集模式
             m_maxAngleCaptureMode = false;
             
             // 更新界面显示
             updateDataTable();
-            updateErrorTableWithAllRounds();
             
             // 减少弹窗：只在状态栏显示成功信息
             ui->statusBar->showMessage(
@@ -2160,16 +2254,7 @@ void MainWindow::onConfirmData()
                 .arg(m_tempCurrentAngle, 0, 'f', 2), 3000); // 显示3秒
             
             // 检查是否应该自动切换到反行程
-            const RoundData &currentRound = m_allRoundsData[m_currentRound];
-            bool forwardComplete = true;
-            for (int i = 0; i < currentRound.forwardAngles.size(); ++i) {
-                if (currentRound.forwardAngles[i] == 0.0) {
-                    forwardComplete = false;
-                    break;
-                }
-            }
-            
-            if (forwardComplete) {
+            if (m_session->strokeComplete(m_currentRound, MeasurementSession::Forward)) {
                 m_isForwardStroke = false;  // 自动切换到反行程
                 // 减少弹窗：只在状态栏显示切换信息
                 ui->statusBar->showMessage("正行程完成，已自动切换到反行程", 3000);
@@ -2184,28 +2269,36 @@ void MainWindow::onConfirmData()
     
     qDebug() << "确定按钮 - 直接使用采集按钮保存的角度差:" << angleDelta << "度";
     
-    // 更新指针方向（使用当前检测到的角度）
-    cv::Mat frame;
-    if (!grabOneFrame(frame)) {
-        QMessageBox::warning(this, "警告", "无法获取图像！");
-        return;
+    // 更新指针方向（使用当前检测到的角度）。
+    // 自动采集紧接在"采集"之后调用，展开角和方向刚用同一帧更新过，不再重测
+    if (interactive) {
+        cv::Mat frame;
+        if (!grabOneFrame(frame)) {
+            QMessageBox::warning(this, "警告", "无法获取图像！");
+            return;
+        }
+
+        double currentAngle = measureAngleMultipleTimes(frame, 3);
+        processAbsAngle(currentAngle); // 更新展开角 & 方向
     }
     
-    double currentAngle = measureAngleMultipleTimes(frame, 3);
-    processAbsAngle(currentAngle); // 更新展开角 & 方向
-    
-    // 检查当前轮次数据状态
-    if (m_currentRound < m_allRoundsData.size()) {
-        const RoundData &currentRound = m_allRoundsData[m_currentRound];
-        
-        // 检查正行程是否已完成
-        bool forwardComplete = true;
-        for (int i = 0; i < currentRound.forwardAngles.size(); ++i) {
-            if (currentRound.forwardAngles[i] == 0.0) {
-                forwardComplete = false;
-                break;
-            }
+    // 逐点步进：压力源已经决定了检测点和行程，直接写到那一格（不按空位顺序找）
+    if (step) {
+        if (!m_session->hasRound(m_currentRound) || step->slot < 0 || step->slot >= m_session->slotsPerRound()) {
+            reportOperationProblem(interactive, "提示", QString("检测点%1超出当前轮的采集位").arg(step->slot + 1));
+            return;
         }
+        m_isForwardStroke = step->forward;
+        const int stroke = step->forward ? MeasurementSession::Forward : MeasurementSession::Backward;
+        m_session->setAngle(m_currentRound, stroke, step->slot, angleDelta);
+        journalSlot(JournalOp::Reading, m_activeSlot, m_currentRound, step->forward, step->slot, angleDelta, step);
+        appendToOtherSlots(step->forward, step);
+        updateDataTable();
+        qDebug() << "逐点步进写入第" << (m_currentRound + 1) << "轮" << (step->forward ? "正行程" : "反行程")
+                 << "采集数据" << (step->slot + 1) << ":" << angleDelta << "参考压力" << step->pressure << "MPa";
+    } else if (m_session->hasRound(m_currentRound)) {
+        // 检查正行程是否已完成
+        const bool forwardComplete = m_session->strokeComplete(m_currentRound, MeasurementSession::Forward);
         
         // 确定数据应该填写到哪个行程
         bool shouldAddToForward = true;
@@ -2227,32 +2320,22 @@ void MainWindow::onConfirmData()
         }
         
         // 添加到当前轮次数据中
-        addAngleToCurrentRound(angleDelta, shouldAddToForward);
+        addAngleToCurrentRound(angleDelta, shouldAddToForward, interactive);
+        appendToOtherSlots(shouldAddToForward);
     } else {
         // 添加到当前轮次数据中（使用当前状态）
-        addAngleToCurrentRound(angleDelta, m_isForwardStroke);
-    }
-    
-    // 同时更新误差表格（如果打开的话）
-    updateErrorTableWithAllRounds();
-    
-    // 计算当前数据位置
-    int currentDataPosition = 0;
-    if (m_currentRound < m_allRoundsData.size()) {
-        const RoundData &currentRound = m_allRoundsData[m_currentRound];
-        
-        if (m_isForwardStroke) {
-            // 正行程：从前往后计算位置
-            for (int i = 0; i < currentRound.forwardAngles.size(); ++i) {
-                if (currentRound.forwardAngles[i] != 0.0) {
-                    currentDataPosition = i + 1;
-                }
-            }
-        } else {
-            for (int i = 0; i < currentRound.backwardAngles.size(); ++i) {
-                if (currentRound.backwardAngles[i] != 0.0) {
-                    currentDataPosition = i + 1;
-                }
+        addAngleToCurrentRound(angleDelta, m_isForwardStroke, interactive);
+        appendToOtherSlots(m_isForwardStroke);
+    }
+    
+    // 计算当前数据位置（逐点步进就是写入的那一格）
+    int currentDataPosition = step ? step->slot + 1 : 0;
+    if (!step && m_session->hasRound(m_currentRound)) {
+        // 有读数的最后一个采集位（0° 也是读数）
+        const int stroke = m_isForwardStroke ? MeasurementSession::Forward : MeasurementSession::Backward;
+        for (int i = 0; i < m_session->slotsPerRound(); ++i) {
+            if (m_session->hasAngle(m_currentRound, stroke, i)) {
+                currentDataPosition = i + 1;
             }
         }
     }
@@ -2270,27 +2353,14 @@ void MainWindow::onConfirmData()
 void MainWindow::onSaveData()
 {
     // 检查当前轮次是否完成
-    if (m_currentRound < m_allRoundsData.size()) {
-        RoundData &currentRound = m_allRoundsData[m_currentRound];
-        
+    if (m_session->hasRound(m_currentRound)) {
         // 标记当前轮次为已完成
-        currentRound.isCompleted = true;
+        m_session->setCompleted(m_currentRound, true);
+        const int completedRound = m_currentRound;
         
         // 统计数据数量
-        int forwardCount = 0;
-        int backwardCount = 0;
-        
-        for (int i = 0; i < currentRound.forwardAngles.size(); ++i) {
-            if (currentRound.forwardAngles[i] != 0.0) {
-                forwardCount++;
-            }
-        }
-        
-        for (int i = 0; i < currentRound.backwardAngles.size(); ++i) {
-            if (currentRound.backwardAngles[i] != 0.0) {
-                backwardCount++;
-            }
-        }
+        const int forwardCount = m_session->angleCount(m_currentRound, MeasurementSession::Forward);
+        const int backwardCount = m_session->angleCount(m_currentRound, MeasurementSession::Backward);
         
         // 减少弹窗：只在状态栏显示保存信息
         ui->statusBar->showMessage(
@@ -2311,24 +2381,26 @@ void MainWindow::onSaveData()
             m_tempCurrentAngle = 0.0;
             
             // 初始化新轮次的数据
-            if (m_currentRound < m_allRoundsData.size()) {
-                m_allRoundsData[m_currentRound].forwardAngles.fill(0.0);
-                m_allRoundsData[m_currentRound].backwardAngles.fill(0.0);
-                m_allRoundsData[m_currentRound].maxAngle = 0.0;
-                m_allRoundsData[m_currentRound].isCompleted = false;
-            }
+            m_session->clearRound(m_currentRound);
         } else {
             // 减少弹窗：只在状态栏显示完成信息
             ui->statusBar->showMessage(
                 QString("所有%1轮数据采集已完成！").arg(m_totalRounds), 5000);
         }
         
+        // 轮次切换：记一条日志，并在轮次边界压缩一次快照
+        JournalEntry change;
+        change.op = JournalOp::RoundChange;
+        change.round = quint8(m_currentRound);
+        change.completed = qint8(completedRound);
+        journalAppend(change);
+        compactJournal();
+        
         // 更新检测点标签显示
         updateDetectionPointLabels();
         
         // 更新界面显示
         updateDataTable();
-        updateErrorTableWithAllRounds();
     }
     
     qDebug() << "保存完成，当前轮次：" << (m_currentRound + 1);
@@ -2349,9 +2421,10 @@ void MainWindow::onClearData()
         return;
     }
     
-    // 重置零点相关状态
-    m_hasZero = false;
-    m_zeroAngle = 0.0;
+    // 重置零点与展开角状态
+    m_angleTracker.reset();
+    m_multiDial.resetSlots();
+    m_slotCapturedRel.clear();
     
     // 重置指针运动状态
     m_hasPreviousAngle = false;
@@ -2370,13 +2443,6 @@ void MainWindow::onClearData()
     // 重置角度差
     m_lastCalculatedDelta = 0.0;
     
-    // 重置展开角状态
-    m_hasUnwrapped = false;
-    m_unwrappedAngle = 0.0;
-    m_zeroUnwrapped = 0.0;
-    m_previousAbs = 0.0;
-    m_lastDelta = 0.0;
-    
     // 重新初始化5轮数据结构
     initializeRoundsData();
     
@@ -2455,29 +2521,20 @@ void MainWindow::onMaxAngleCapture()
 {
     qDebug() << "最大角度采集按钮被点击";
     
-    if (!m_hasZero) {
+    if (!activeHasZero()) {
         QMessageBox::warning(this, "警告", "请先进行归位操作！");
         return;
     }
     
     // 检查当前轮次数据状态
-    if (m_currentRound >= m_allRoundsData.size()) {
+    if (!m_session->hasRound(m_currentRound)) {
         QMessageBox::warning(this, "错误", "当前轮次超出范围！");
         return;
     }
     
-    const RoundData &currentRound = m_allRoundsData[m_currentRound]; 
-    
     // 检查正行程数据是否已完成
-    bool forwardComplete = true;
-    int forwardCount = 0;
-    for (int i = 0; i < currentRound.forwardAngles.size(); ++i) {
-        if (currentRound.forwardAngles[i] != 0.0) {
-            forwardCount++;
-        } else {
-            forwardComplete = false;
-        }
-    }
+    const bool forwardComplete = m_session->strokeComplete(m_currentRound, MeasurementSession::Forward);
+    const int forwardCount = m_session->angleCount(m_currentRound, MeasurementSession::Forward);
     
     // 根据表盘类型确定需要的数据数量
     int requiredForwardCount = 0;
@@ -2514,22 +2571,10 @@ void MainWindow::onMaxAngleCapture()
             return;
         }
         
-        // 显示检测结果到右侧区域（与采集按钮功能一致）
-        det.showScale1Result();
-        cv::Mat vis = det.visual();
-        
-        // 在图像上显示"连续相对角"
+        // 显示检测结果到右侧区域（与采集按钮功能一致），叠加"连续相对角"
         double relForVis = 0.0;
-        if (det.getAngle() != -999) relForVis = currentRelativeAngle();
-        std::string relativeAngleText = "Relative: " + std::to_string(relForVis) + "°";
-        cv::putText(vis, relativeAngleText, cv::Point(10, 60), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0,255,255), 2);
-        
-        cv::cvtColor(vis, vis, cv::COLOR_BGR2RGB);
-        QImage q(vis.data, vis.cols, vis.rows, vis.step, QImage::Format_RGB888);
-        ui->destDisplay->setPixmap(QPixmap::fromImage(q)
-                                   .scaled(ui->destDisplay->size(),
-                                           Qt::KeepAspectRatio,
-                                           Qt::SmoothTransformation));
+        if (det.getAngle() != -999 && activeTracker()) relForVis = activeTracker()->relative();
+        showDetectionResult(frame, det.overlay(), {"Relative: " + std::to_string(relForVis) + "°"});
         
         // 获取当前角度
         double currentAngle = det.getAngle();
@@ -2538,8 +2583,18 @@ void MainWindow::onMaxAngleCapture()
             return;
         }
         
+        // 多表：按表位重新测量，当前表位的角度以表位ROI的结果为准
+        if (isMultiDialMode()) {
+            currentAngle = measureAngleMultipleTimes(frame, 1);
+            if (currentAngle == -999) {
+                QMessageBox::warning(this, "错误", QString("表位%1无法计算角度！").arg(m_activeSlot + 1));
+                return;
+            }
+        }
+
         // 使用展开角得到连续相对角
         double rel = processAbsAngle(currentAngle);
+        if (isMultiDialMode()) storeSlotRelatives();
         
         // 更新界面显示当前角度
         ui->labelAngle->setText(
@@ -2567,401 +2622,10 @@ void MainWindow::onMaxAngleCapture()
     }
 }
 
-// ================== BYQ指针检测算法实现 ==================
-cv::Vec4i highPreciseDetector::detectBYQPointer(const cv::Mat& gray, const cv::Point2f& center, float radius) {
-    qDebug() << "开始BYQ指针检测";
-    
-    // 初始化转轴中心
-    m_axisCenter = cv::Point2f(-1, -1);
-    
-    // 1. 首先检测转轴中心
-    cv::Point2f axisCenter = detectBYQAxis(gray, center, radius);
-    
-    if (axisCenter.x == -1) {
-        qDebug() << "未找到BYQ转轴中心，使用表盘中心";
-        axisCenter = center;
-    } else {
-        // 保存转轴中心用于可视化
-        m_axisCenter = axisCenter;
-    }
-    
-    // 2. 检测银色指针末端
-    cv::Vec4i silverEnd = detectSilverPointerEnd(gray, axisCenter, center, radius);
-    
-    if (silverEnd[0] != -1) {
-        qDebug() << "BYQ指针检测成功";
-        return silverEnd;
-    }
-    
-    qDebug() << "BYQ指针检测失败";
-    return cv::Vec4i(-1, -1, -1, -1);
-}
-
-cv::Point2f highPreciseDetector::detectBYQAxis(const cv::Mat& gray, const cv::Point2f& dialCenter, float dialRadius) {
-    qDebug() << "检测BYQ螺旋波登管转轴中心 - 使用LSD线段检测（支持表盘旋转）";
-    qDebug() << "表盘中心:(" << dialCenter.x << "," << dialCenter.y << ") 半径:" << dialRadius;
-    
-    m_hasBlackLines = false;
-    m_blackLine1 = cv::Vec4i(-1, -1, -1, -1);
-    m_blackLine2 = cv::Vec4i(-1, -1, -1, -1);
-    
-    // 1. 创建环形掩码：只搜索表盘内部的下半部分环形区域
-    // 使用环形而非矩形裁剪，这样即使表盘旋转也能正确覆盖黑线区域
-    cv::Mat mask = cv::Mat::zeros(gray.size(), CV_8UC1);
-    
-    // 外圆：表盘边缘往内缩一点
-    int outerRadius = (int)(dialRadius * 0.95);
-    // 内圆：排除中心区域（转轴附近）
-    int innerRadius = (int)(dialRadius * 0.25);
-    
-    // 画外圆（填充）
-    cv::circle(mask, cv::Point((int)dialCenter.x, (int)dialCenter.y), outerRadius, cv::Scalar(255), -1);
-    // 挖掉内圆
-    cv::circle(mask, cv::Point((int)dialCenter.x, (int)dialCenter.y), innerRadius, cv::Scalar(0), -1);
-    
-    // 不再用矩形裁剪，让整个环形区域都参与搜索
-    // 这样即使表盘旋转45度，黑线仍然在搜索区域内
-    
-    qDebug() << "黑线搜索区域: 环形区域 内径=" << innerRadius << " 外径=" << outerRadius;
-    
-    // 2. 应用掩码
-    cv::Mat roiGray;
-    gray.copyTo(roiGray, mask);
-    
-    // 3. 使用LSD检测直线段
-    cv::Ptr<cv::LineSegmentDetector> lsd = cv::createLineSegmentDetector(cv::LSD_REFINE_STD);
-    std::vector<cv::Vec4f> lines;
-    lsd->detect(roiGray, lines);
-    
-    qDebug() << "LSD在环形区域检测到" << lines.size() << "条直线";
-    
-    struct LineInfo {
-        cv::Vec4f line;
-        float length;
-        float midX;
-        float midY;
-        float angle;  // 线段角度（弧度）
-        cv::Point2f p1, p2;  // 两个端点
-        float distFromCenter;  // 中点到圆心的距离
-    };
-    
-    std::vector<LineInfo> candidateLines;
-    
-    for (const auto& line : lines) {
-        cv::Point2f p1(line[0], line[1]);
-        cv::Point2f p2(line[2], line[3]);
-        
-        // 两端都必须在表盘圆内
-        float d1 = cv::norm(p1 - dialCenter);
-        float d2 = cv::norm(p2 - dialCenter);
-        if (d1 > dialRadius || d2 > dialRadius) continue;
-        
-        // 计算线段长度
-        float lineLen = cv::norm(p2 - p1);
-        if (lineLen < 15) continue;  // 太短的忽略
-        
-        // 计算中点
-        float midX = (p1.x + p2.x) / 2.0f;
-        float midY = (p1.y + p2.y) / 2.0f;
-        cv::Point2f midPoint(midX, midY);
-        
-        // 计算中点到圆心的距离（用于判断是否在下半部分）
-        float distFromCenter = cv::norm(midPoint - dialCenter);
-        
-        // 计算中点相对于圆心的角度（用于判断位置）
-        // 0度=右，90度=下，180度=左，-90度=上
-        float posAngle = std::atan2(midY - dialCenter.y, midX - dialCenter.x) * 180.0f / CV_PI;
-        
-        // 只保留大致在下半部分的线段（角度在 0° 到 180° 之间，允许±60度偏移）
-        // 这意味着允许表盘旋转最多60度
-        bool isInLowerHalf = (posAngle > -60 && posAngle < 240);
-        if (!isInLowerHalf) continue;
-        
-        // 计算线段方向角度（弧度，用于后续共线判断）
-        float angle = std::atan2(p2.y - p1.y, p2.x - p1.x);
-        float angleDeg = angle * 180.0f / CV_PI;
-        
-        LineInfo info = {line, lineLen, midX, midY, angle, p1, p2, distFromCenter};
-        candidateLines.push_back(info);
-        
-        qDebug() << "  候选黑线: (" << p1.x << "," << p1.y << ")->(" << p2.x << "," << p2.y 
-                 << ") 长度=" << lineLen << " 方向角=" << angleDeg << "° 位置角=" << posAngle << "°";
-    }
-    
-    qDebug() << "候选线段数:" << candidateLines.size();
-    
-    if (candidateLines.size() < 2) {
-        qDebug() << "候选线段不足2条，检测失败";
-        m_axisRadius = 0;
-        return cv::Point2f(-1, -1);
-    }
-    
-    // 4. 找最佳配对：两条线段应该"共线"（同一条直线上的两段）
-    // 判断共线的标准：
-    //   a) 方向角度相近（角度差小于15度）
-    //   b) 一条线段的端点投影到另一条线段的延长线上的距离很小
-    //   c) 两条线段之间有间隙（不重叠），中间是转轴
-    
-    LineInfo bestLine1, bestLine2;
-    float bestScore = 0;
-    
-    for (size_t i = 0; i < candidateLines.size(); ++i) {
-        for (size_t j = i + 1; j < candidateLines.size(); ++j) {
-            const LineInfo& L1 = candidateLines[i];
-            const LineInfo& L2 = candidateLines[j];
-            
-            // a) 检查角度差（考虑180度对称性）
-            float angleDiff = std::abs(L1.angle - L2.angle);
-            if (angleDiff > CV_PI) angleDiff = 2 * CV_PI - angleDiff;
-            if (angleDiff > CV_PI / 2) angleDiff = CV_PI - angleDiff;  // 处理反向
-            float angleDiffDeg = angleDiff * 180.0f / CV_PI;
-            
-            if (angleDiffDeg > 15) continue;  // 角度差超过15度，不共线
-            
-            // b) 计算两线段中点之间的连线与线段方向的垂直距离
-            // 使用L1的方向作为参考
-            cv::Point2f dir1 = L1.p2 - L1.p1;
-            float len1 = cv::norm(dir1);
-            if (len1 < 1) continue;
-            dir1 = dir1 / len1;  // 单位方向向量
-            
-            cv::Point2f midToMid = cv::Point2f(L2.midX - L1.midX, L2.midY - L1.midY);
-            // 垂直距离 = |midToMid × dir1| = |midToMid.x * dir1.y - midToMid.y * dir1.x|
-            float perpDist = std::abs(midToMid.x * dir1.y - midToMid.y * dir1.x);
-            
-            if (perpDist > 25) continue;  // 垂直距离过大，不共线
-            
-            // c) 检查两线段之间有间隙
-            // 计算四个端点在方向上的投影
-            float proj1_p1 = L1.p1.x * dir1.x + L1.p1.y * dir1.y;
-            float proj1_p2 = L1.p2.x * dir1.x + L1.p2.y * dir1.y;
-            float proj2_p1 = L2.p1.x * dir1.x + L2.p1.y * dir1.y;
-            float proj2_p2 = L2.p2.x * dir1.x + L2.p2.y * dir1.y;
-            
-            float L1_min = std::min(proj1_p1, proj1_p2);
-            float L1_max = std::max(proj1_p1, proj1_p2);
-            float L2_min = std::min(proj2_p1, proj2_p2);
-            float L2_max = std::max(proj2_p1, proj2_p2);
-            
-            // 检查是否有间隙（不重叠）
-            float gap = 0;
-            if (L1_max < L2_min) {
-                gap = L2_min - L1_max;
-            } else if (L2_max < L1_min) {
-                gap = L1_min - L2_max;
-            }
-            // 如果没有间隙（重叠），跳过
-            if (gap < 5) continue;  // 间隙至少5像素
-            
-            // 计算得分：总长度 + 共线性（垂直距离越小越好）+ 间隙合理性
-            float lengthScore = L1.length + L2.length;
-            float collinearScore = std::max(0.0f, 50.0f - perpDist * 2);  // 垂直距离越小分越高
-            float gapScore = (gap > 10 && gap < 150) ? 30.0f : 0.0f;  // 间隙在合理范围内加分
-            
-            float score = lengthScore + collinearScore + gapScore;
-            
-            qDebug() << "  配对 L" << i << "-L" << j << ": 角度差=" << angleDiffDeg 
-                     << "° 垂直距离=" << perpDist << " 间隙=" << gap << " 得分=" << score;
-            
-            if (score > bestScore) {
-                bestScore = score;
-                bestLine1 = L1;
-                bestLine2 = L2;
-            }
-        }
-    }
-    
-    if (bestScore > 0) {
-        // 保存黑线信息用于可视化
-        m_blackLine1 = cv::Vec4i((int)bestLine1.line[0], (int)bestLine1.line[1], 
-                                  (int)bestLine1.line[2], (int)bestLine1.line[3]);
-        m_blackLine2 = cv::Vec4i((int)bestLine2.line[0], (int)bestLine2.line[1], 
-                                  (int)bestLine2.line[2], (int)bestLine2.line[3]);
-        m_hasBlackLines = true;
-        
-        // 收集四个端点
-        std::vector<cv::Point2f> allPoints = {bestLine1.p1, bestLine1.p2, bestLine2.p1, bestLine2.p2};
-        
-        // 计算共线方向（使用两线段中点连线或平均方向）
-        cv::Point2f avgDir = (bestLine1.p2 - bestLine1.p1) + (bestLine2.p2 - bestLine2.p1);
-        float avgDirLen = cv::norm(avgDir);
-        if (avgDirLen < 1) {
-            qDebug() << "方向向量计算失败";
-            m_axisRadius = 0;
-            return cv::Point2f(-1, -1);
-        }
-        avgDir = avgDir / avgDirLen;
-        
-        // 按照方向投影排序四个端点
-        std::sort(allPoints.begin(), allPoints.end(), 
-            [&avgDir](const cv::Point2f& a, const cv::Point2f& b) {
-                return (a.x * avgDir.x + a.y * avgDir.y) < (b.x * avgDir.x + b.y * avgDir.y);
-            });
-        
-        cv::Point2f leftMost = allPoints[0];
-        cv::Point2f rightMost = allPoints[3];
-        
-        qDebug() << "黑线端点1: (" << leftMost.x << "," << leftMost.y << ")";
-        qDebug() << "黑线端点2: (" << rightMost.x << "," << rightMost.y << ")";
-        
-        // 计算表盘圆心到共线的垂足作为转轴中心
-        // 这样可以保证绿线（圆心到转轴）垂直于青线（共线）
-        cv::Point2f lineDir = rightMost - leftMost;
-        float lineLenSq = lineDir.x * lineDir.x + lineDir.y * lineDir.y;
-        
-        cv::Point2f axisCenter(-1, -1);
-        if (lineLenSq > 1.0f) {
-            cv::Point2f toCenter = dialCenter - leftMost;
-            float t = (toCenter.x * lineDir.x + toCenter.y * lineDir.y) / lineLenSq;
-            axisCenter = leftMost + t * lineDir;
-        }
-        
-        if (axisCenter.x < 0) {
-            qDebug() << "无法计算垂足，检测失败";
-            m_axisRadius = 0;
-            return cv::Point2f(-1, -1);
-        }
-        
-        m_axisRadius = cv::norm(dialCenter - axisCenter);
-        
-        qDebug() << "表盘圆心: (" << dialCenter.x << "," << dialCenter.y << ")";
-        qDebug() << "转轴中心(垂足): (" << axisCenter.x << "," << axisCenter.y << ")";
-        qDebug() << "圆心到转轴距离: " << m_axisRadius;
-        
-        return axisCenter;
-    }
-    
-    // 检测失败
-    qDebug() << "未能检测到共线的两条黑线，检测失败";
-    m_axisRadius = 0;
-    return cv::Point2f(-1, -1);
-}
-
-cv::Vec4i highPreciseDetector::detectSilverPointerEnd(const cv::Mat& gray,
-                                                      const cv::Point2f& axisCenter, const cv::Point2f& dialCenter, float dialRadius) {
-    qDebug() << "检测银色指针末端 - 使用LSD线段检测（只在圆心上方区域）";
-    qDebug() << "转轴中心:(" << axisCenter.x << "," << axisCenter.y << ") 圆心:(" << dialCenter.x << "," << dialCenter.y << ")";
-    
-    // 检查转轴中心是否有效
-    if (axisCenter.x < 0 || axisCenter.y < 0) {
-        qDebug() << "转轴中心无效，无法检测指针";
-        return cv::Vec4i(-1, -1, -1, -1);
-    }
-    
-    // 1. 创建圆心上方区域的掩码（指针的直线部分只在这里）
-    cv::Mat mask = cv::Mat::zeros(gray.size(), CV_8UC1);
-    // 画表盘圆
-    cv::circle(mask, cv::Point((int)dialCenter.x, (int)dialCenter.y), (int)dialRadius, cv::Scalar(255), -1);
-    // 遮蔽圆心下方区域（保留圆心上方，同时允许延伸到圆心下方50像素以捕获更多指针）
-    int bottomLimit = (int)dialCenter.y - 20;
-    cv::rectangle(mask, cv::Point(0, bottomLimit), 
-                  cv::Point(gray.cols, gray.rows), cv::Scalar(0), -1);
-    // 也排除太靠近顶部边缘的区域（表盘边缘干扰）
-    int topMargin = (int)(dialCenter.y - dialRadius + 5);  // 减少顶部边距
-    cv::rectangle(mask, cv::Point(0, 0), 
-                  cv::Point(gray.cols, topMargin), cv::Scalar(0), -1);
-    
-    // 2. 应用掩码
-    cv::Mat roiGray;
-    gray.copyTo(roiGray, mask);
-    
-    // 3. 计算上半区域的平均亮度，用于自适应二值化阈值
-    cv::Scalar meanVal = cv::mean(roiGray, mask);
-    double avgBrightness = meanVal[0];
-    
-    // 5. 形态学操作：连接断开的指针，去除噪点
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
-    cv::morphologyEx(roiGray, roiGray, cv::MORPH_CLOSE, kernel);
-    cv::morphologyEx(roiGray, roiGray, cv::MORPH_OPEN, kernel);
-    
-    // 6. 使用LSD检测直线段
-    cv::Ptr<cv::LineSegmentDetector> lsd = cv::createLineSegmentDetector(cv::LSD_REFINE_STD);
-    std::vector<cv::Vec4f> lines;
-    lsd->detect(roiGray, lines);
-    
-    qDebug() << "LSD在圆心上方区域检测到" << lines.size() << "条直线";
-    
-    // 7. 筛选指针线段
-    cv::Vec4f bestLine(-1, -1, -1, -1);
-    float bestScore = 0;
-    
-    for (const auto& line : lines) {
-        cv::Point2f p1(line[0], line[1]);
-        cv::Point2f p2(line[2], line[3]);
-        
-        // 至少有一端在圆心上方（y值小于圆心y值）
-        bool p1Above = p1.y < dialCenter.y;
-        bool p2Above = p2.y < dialCenter.y;
-        if (!p1Above && !p2Above) continue;  // 两端都在圆心下方则跳过
-        
-        // 计算线段长度
-        float lineLen = cv::norm(p2 - p1);
-        if (lineLen < 20) continue;  // 太短的忽略（放宽到20像素）
-        
-        // 计算线段中点
-        cv::Point2f midPoint = (p1 + p2) * 0.5f;
-        
-        // 检查中点是否在表盘圆内
-        float distFromDialCenter = cv::norm(midPoint - dialCenter);
-        if (distFromDialCenter > dialRadius * 0.90f) continue;  // 放宽到95%
-        
-        // 计算线段方向向量
-        cv::Point2f lineDir = p2 - p1;
-        float lineDirLen = cv::norm(lineDir);
-        if (lineDirLen < 1) continue;
-        lineDir = lineDir / lineDirLen;
-        
-        // 计算从中点指向转轴中心的方向
-        cv::Point2f toAxis = axisCenter - midPoint;
-        float toAxisLen = cv::norm(toAxis);
-        if (toAxisLen < 1) continue;
-        toAxis = toAxis / toAxisLen;
-        
-        // 线段方向应该与指向转轴的方向一致（或相反，因为方向可能反的）
-        float dotProduct = std::abs(lineDir.x * toAxis.x + lineDir.y * toAxis.y);
-        if (dotProduct < 0.6f) continue;  // 方向偏差太大
-        
-        // 确定哪端离转轴更远（那就是指针末端）
-        float d1 = cv::norm(p1 - axisCenter);
-        float d2 = cv::norm(p2 - axisCenter);
-        
-        // 评分：长度 × 方向一致性
-        float score = lineLen * dotProduct;
-        
-        qDebug() << "  候选线段: (" << p1.x << "," << p1.y << ")->(" << p2.x << "," << p2.y 
-                 << ") 长度=" << lineLen << " 方向一致性=" << dotProduct 
-                 << " d1=" << d1 << " d2=" << d2 << " 分数=" << score;
-        
-        if (score > bestScore) {
-            bestScore = score;
-            // d1 > d2 表示 p1 离转轴更远，p1 是末端（黄色点）
-            if (d1 > d2) {
-                bestLine = cv::Vec4f(axisCenter.x, axisCenter.y, p1.x, p1.y);  // p1离转轴远，是末端
-            } else {
-                bestLine = cv::Vec4f(axisCenter.x, axisCenter.y, p2.x, p2.y);  // p2离转轴远，是末端
-            }
-        }
-    }
-    
-    if (bestScore > 0) {
-        cv::Point2f tipPoint(bestLine[2], bestLine[3]);
-        qDebug() << "最佳指针线段末端:(" << tipPoint.x << "," << tipPoint.y << ") 分数=" << bestScore;
-        
-        // 返回格式：[转轴中心x, 转轴中心y, 末端x, 末端y]
-        return cv::Vec4i((int)std::lround(bestLine[0]),
-                         (int)std::lround(bestLine[1]),
-                         (int)std::lround(bestLine[2]),
-                         (int)std::lround(bestLine[3]));
-    }
-    
-    qDebug() << "未检测到指针";
-    return cv::Vec4i(-1, -1, -1, -1);
-}
-
 // 测量并保存最大角度
 void MainWindow::measureAndSaveMaxAngle()
 {
-    if (!m_hasZero) {
+    if (!activeHasZero()) {
         QMessageBox::warning(this, "警告", "请先进行归位操作！");
         return;
     }
@@ -2987,13 +2651,10 @@ void MainWindow::measureAndSaveMaxAngle()
     m_maxAngleCaptured = true;  // 设置最大角度已采集标志
     
     // 将最大角度保存到当前轮次数据中
-    if (m_currentRound < m_allRoundsData.size()) {
-        m_allRoundsData[m_currentRound].maxAngle = maxAngle;
-    }
-    
-    // 如果误差检测表格窗口打开，将最大角度数据传递给它
-    if (m_errorTableDialog) {
-        m_errorTableDialog->addMaxAngleData(maxAngle);
+    // 误差检测表格订阅了会话，会收到这一轮最大角度的变化
+    if (m_session->hasRound(m_currentRound)) {
+        m_session->setMaxAngle(m_currentRound, maxAngle);
+        journalMaxAngle(m_activeSlot, m_currentRound, maxAngle);
     }
     
     // 更新界面显示
@@ -3003,19 +2664,9 @@ void MainWindow::measureAndSaveMaxAngle()
     qDebug() << "最大角度测量完成:" << maxAngle << "最大角度采集状态已设置为true";
     
     // 检查是否应该自动切换到反行程
-    if (m_currentRound < m_allRoundsData.size()) {
-        const RoundData &currentRound = m_allRoundsData[m_currentRound];
-        
+    if (m_session->hasRound(m_currentRound)) {
         // 检查正行程是否已完成
-        bool forwardComplete = true;
-        for (int i = 0; i < currentRound.forwardAngles.size(); ++i) {
-            if (currentRound.forwardAngles[i] == 0.0) {
-                forwardComplete = false;
-                break;
-            }
-        }
-        
-        if (forwardComplete) {
+        if (m_session->strokeComplete(m_currentRound, MeasurementSession::Forward)) {
             m_isForwardStroke = false;  // 自动切换到反行程
             
             // 根据表盘类型确定需要的数据数量
@@ -3066,14 +2717,29 @@ void MainWindow::updateMaxAngleDisplay()
 
 // ================== 5轮数据管理方法实现 ==================
 
+// 表位会话按表数补齐/删掉，全部重置成空会话；当前表位越界时回到表位1
+void MainWindow::resetSlotSessions()
+{
+    const int count = std::max(1, m_multiDial.maxDials());
+    if (m_activeSlot >= count) m_activeSlot = 0;
+    while (m_slotSessions.size() < count) m_slotSessions.append(new MeasurementSession(this));
+    MeasurementSession* active = m_slotSessions[m_activeSlot];
+    while (m_slotSessions.size() > count) delete m_slotSessions.takeLast();
+
+    for (MeasurementSession* session : m_slotSessions) {
+        session->reset(m_totalRounds, m_maxMeasurementsPerRound);
+    }
+    m_referenceEntries.clear();
+    if (m_session != active) {
+        m_session = active;
+        if (m_errorTableDialog) m_errorTableDialog->setMeasurementSession(m_session);
+    }
+}
+
 void MainWindow::initializeRoundsData()
 {
     qDebug() << "初始化" << m_totalRounds << "轮数据结构";
     
-    // 初始化多轮数据
-    m_allRoundsData.clear();
-    m_allRoundsData.resize(m_totalRounds);
-    
     // 根据当前表盘类型设置测量次数和检测点
     if (m_currentDialType == "YYQY-13") {
         m_maxMeasurementsPerRound = 6;
@@ -3087,15 +2753,8 @@ void MainWindow::initializeRoundsData()
         m_detectionPoints = {0.0, 1.0, 2.0, 3.0};
     }
     
-    // 为每轮初始化数据结构
-    for (int round = 0; round < m_totalRounds; ++round) {
-        m_allRoundsData[round].forwardAngles.resize(m_maxMeasurementsPerRound);
-        m_allRoundsData[round].backwardAngles.resize(m_maxMeasurementsPerRound);
-        m_allRoundsData[round].forwardAngles.fill(0.0);
-        m_allRoundsData[round].backwardAngles.fill(0.0);
-        m_allRoundsData[round].maxAngle = 0.0;
-        m_allRoundsData[round].isCompleted = false;
-    }
+    // 初始化多轮数据（误差表格会收到整体重置）；各表位会话结构相同，各自独立
+    resetSlotSessions();
     
     // 重置状态
     m_currentRound = 0;
@@ -3109,6 +2768,9 @@ void MainWindow::initializeRoundsData()
     // 更新检测点标签显示
     updateDetectionPointLabels();
     
+    // 新会话：快照里只剩 Begin，旧日志作废
+    compactJournal();
+    
     qDebug() << m_totalRounds << "轮数据结构初始化完成，表盘类型:" << m_currentDialType 
              << "每轮测量次数:" << m_maxMeasurementsPerRound
              << "检测点数量:" << m_detectionPoints.size();
@@ -3281,26 +2943,19 @@ void MainWindow::resetAllButtonsStyle()
     }
 }
 
-void MainWindow::addAngleToCurrentRound(double angle, bool isForward)
+void MainWindow::addAngleToCurrentRound(double angle, bool isForward, bool interactive)
 {
-    if (m_currentRound >= m_allRoundsData.size()) {
+    if (!m_session->hasRound(m_currentRound)) {
         qDebug() << "当前轮次超出范围:" << m_currentRound;
         return;
     }
     
-    RoundData &currentRound = m_allRoundsData[m_currentRound];
+    // 写入一律走 m_session->setAngle，这样误差表格只收到这一格的变化；空位看 hasAngle，0° 也是读数
+    const int slots = m_session->slotsPerRound();
     
     if (isForward) {
         // 检查是否已经完成正行程数据采集
-        bool forwardComplete = true;
-        for (int i = 0; i < currentRound.forwardAngles.size(); ++i) {
-            if (currentRound.forwardAngles[i] == 0.0) {
-                forwardComplete = false;
-                break;
-            }
-        }
-        
-        if (forwardComplete) {
+        if (m_session->strokeComplete(m_currentRound, MeasurementSession::Forward)) {
             // 根据表盘类型确定需要的数据数量
             int requiredForwardCount = 0;
             if (m_currentDialType == "YYQY-13") {
@@ -3311,7 +2966,7 @@ void MainWindow::addAngleToCurrentRound(double angle, bool isForward)
                 requiredForwardCount = 6;  // 默认6个
             }
             
-            QMessageBox::warning(this, "提示", 
+            reportOperationProblem(interactive, "提示",
                 QString("正行程数据已采集完成（%1个数据），请进行最大角度采集或切换到反行程！\n表盘类型：%2")
                 .arg(requiredForwardCount)
                 .arg(m_currentDialType));
@@ -3319,22 +2974,13 @@ void MainWindow::addAngleToCurrentRound(double angle, bool isForward)
         }
         
         // 找到第一个空的正行程位置
-        for (int i = 0; i < currentRound.forwardAngles.size(); ++i) {
-            if (currentRound.forwardAngles[i] == 0.0) {
-                // 允许添加数据到空位置（包括0度数据）
-                currentRound.forwardAngles[i] = angle;
+        for (int i = 0; i < slots; ++i) {
+            if (!m_session->hasAngle(m_currentRound, MeasurementSession::Forward, i)) {
+                m_session->setAngle(m_currentRound, MeasurementSession::Forward, i, angle);
+                journalSlot(JournalOp::Reading, m_activeSlot, m_currentRound, true, i, angle);
                 qDebug() << "添加第" << (m_currentRound + 1) << "轮正行程第" << (i + 1) << "次数据:" << angle;
                 
-                // 检查是否完成正行程数据采集
-                bool allForwardFilled = true;
-                for (int j = 0; j < currentRound.forwardAngles.size(); ++j) {
-                    if (currentRound.forwardAngles[j] == 0.0) {
-                        allForwardFilled = false;
-                        break;
-                    }
-                }
-                
-                if (allForwardFilled) {
+                if (m_session->strokeComplete(m_currentRound, MeasurementSession::Forward)) {
                     qDebug() << "正行程数据采集完成，可以进行最大角度采集";
                 }
                 break;
@@ -3342,31 +2988,26 @@ void MainWindow::addAngleToCurrentRound(double angle, bool isForward)
         }
     } else {
         // 检查是否已经完成反行程数据采集
-        bool backwardComplete = true;
-        for (int i = 0; i < currentRound.backwardAngles.size(); ++i) {
-            if (currentRound.backwardAngles[i] == 0.0) {
-                backwardComplete = false;
-                break;
-            }
-        }
-        
-        if (backwardComplete) {
-            QMessageBox::warning(this, "提示", "反行程数据已采集完成！");
+        if (m_session->strokeComplete(m_currentRound, MeasurementSession::Backward)) {
+            reportOperationProblem(interactive, "提示", "反行程数据已采集完成！");
             return;
         }
         
         // 反行程从最后一个位置开始往回填写（采集数据6,5,4,3,2,1）
-        for (int i = currentRound.backwardAngles.size() - 1; i >= 0; --i) {
-            if (currentRound.backwardAngles[i] == 0.0) {
-                currentRound.backwardAngles[i] = angle;
+        for (int i = slots - 1; i >= 0; --i) {
+            if (!m_session->hasAngle(m_currentRound, MeasurementSession::Backward, i)) {
+                m_session->setAngle(m_currentRound, MeasurementSession::Backward, i, angle);
+                journalSlot(JournalOp::Reading, m_activeSlot, m_currentRound, false, i, angle);
                 int displayPosition = i + 1;
                 qDebug() << "添加第" << (m_currentRound + 1) << "轮反行程采集数据" << displayPosition << "（数组位置" << (i + 1) << "）:" << angle;
                 
-                // 打印当前反行程数组状态
+                // 打印当前反行程数组状态（空位显示 --）
                 QString arrayState = "反行程数组状态：[";
-                for (int j = 0; j < currentRound.backwardAngles.size(); ++j) {
-                    arrayState += QString::number(currentRound.backwardAngles[j], 'f', 2);
-                    if (j < currentRound.backwardAngles.size() - 1) arrayState += ", ";
+                for (int j = 0; j < slots; ++j) {
+                    arrayState += m_session->hasAngle(m_currentRound, MeasurementSession::Backward, j)
+                        ? QString::number(m_session->angle(m_currentRound, MeasurementSession::Backward, j), 'f', 2)
+                        : QString("--");
+                    if (j < slots - 1) arrayState += ", ";
                 }
                 arrayState += "]";
                 qDebug() << arrayState;
@@ -3379,53 +3020,6 @@ void MainWindow::addAngleToCurrentRound(double angle, bool isForward)
     updateDataTable();
 }
 
-void MainWindow::updateErrorTableWithAllRounds()
-{
-    if (!m_errorTableDialog) {
-        return;  // 如果表格窗口没有打开，就不更新
-    }
-    
-    qDebug() << "开始同步5轮数据到误差表格";
-    
-    // 准备数据数组
-    QVector<QVector<double>> allRoundsForward;
-    QVector<QVector<double>> allRoundsBackward;
-    QVector<double> allRoundsMaxAngles;
-    
-    // 从m_allRoundsData中提取数据
-    for (int round = 0; round < m_allRoundsData.size(); ++round) {
-        const RoundData &roundData = m_allRoundsData[round];
-        
-        QVector<double> forwardData;
-        QVector<double> backwardData;
-        
-        // 提取正行程数据（只提取非零值）
-        for (int i = 0; i < roundData.forwardAngles.size(); ++i) {
-            if (roundData.forwardAngles[i] != 0.0) {
-                forwardData.append(roundData.forwardAngles[i]);
-            }
-        }
-        
-        // 提取反行程数据（只提取非零值）
-        for (int i = 0; i < roundData.backwardAngles.size(); ++i) {
-            if (roundData.backwardAngles[i] != 0.0) {
-                backwardData.append(roundData.backwardAngles[i]);
-            }
-        }
-        
-        allRoundsForward.append(forwardData);
-        allRoundsBackward.append(backwardData);
-        allRoundsMaxAngles.append(roundData.maxAngle);
-        
-        qDebug() << "第" << (round + 1) << "轮数据: 正行程" << forwardData.size() 
-                 << "个, 反行程" << backwardData.size() << "个, 最大角度" << roundData.maxAngle;
-    }
-    
-    // 使用批量设置方法
-    m_errorTableDialog->setMainWindowData(allRoundsForward, allRoundsBackward, allRoundsMaxAngles);
-    qDebug() << "所有轮次数据同步完成";
-}
-
 void MainWindow::setCurrentDetectionPoint(int pointIndex)
 {
     if (pointIndex >= 0 && pointIndex < m_detectionPoints.size()) {
@@ -14,6 +14,11 @@
 #include <QScreen>
 #include <QComboBox>
 #include <QLabel>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QDoubleSpinBox>
+#include <QElapsedTimer>
+#include <QThreadPool>
 #include <memory>
 #include <cmath>  // 新增：角度计算需要
 
@@ -22,6 +27,17 @@
 #include "errortabledialog.h"
 
 #include "helpdialog.h"  // 新增
+#include "anglerecorder.h"
+#include "sessionjournal.h"
+#include "measurementsession.h"
+#include "sweepcalibrationdialog.h"
+#include <QPointer>
+#include "analysis/pointerdetector.h"  // 表盘识别核心库（仅依赖OpenCV）
+#include "analysis/anglemath.h"
+#include "analysis/circularstats.h"
+#include "analysis/settledetector.h"
+#include "analysis/multidial.h"
+#include "analysis/corelog.h"
 namespace Ui {
 class MainWindow;
 }
@@ -37,60 +53,6 @@ enum ConvolutionType {
   CONVOLUTION_VALID
 };
 
-using namespace cv;
-
-// 指针识别配置结构
-struct PointerDetectionConfig {
-    // 圆形检测参数
-    double dp = 1.0;                    // HoughCircles的累加器分辨率
-    double minDist = 100;               // 圆心之间的最小距离
-    double param1 = 100;                // Canny边缘检测的高阈值
-    double param2 = 30;                 // 圆心检测的累加器阈值
-    int minRadius = 50;                 // 最小圆半径
-    int maxRadius = 0;                  // 最大圆半径（0表示不限制）
-    
-    // 直线检测参数
-    double rho = 1.0;                   // 距离分辨率
-    double theta = CV_PI/180;           // 角度分辨率
-    int threshold = 50;                 // 累加器阈值
-    double minLineLength = 30;          // 最小线段长度
-    double maxLineGap = 10;             // 最大线段间隙
-    
-    // Canny边缘检测参数
-    double cannyLow = 50;               // Canny低阈值
-    double cannyHigh = 150;             // Canny高阈值
-    
-    // 指针识别特定参数
-    bool usePointerFromCenter = true;   // 是否从圆心开始识别指针
-    double pointerSearchRadius = 0.9;   // 指针搜索半径比例（相对于表盘半径）
-    int pointerMinLength = 50;          // 指针最小长度
-    double angleOffset = 0.0;           // 角度偏移量
-    
-    int silverThresholdLow = 150;       // 银色区域下阈值
-    // BYQ指针检测关键参数
-    // 步骤1-2：掩码参数
-    double pointerMaskRadius = 0.9;     // 表盘掩码半径比例（调小=更靠近中心，调大=更靠近边缘）
-    double axisExcludeMultiplier = 1.8; // 转轴排除区域倍数（调小=排除区域小，调大=排除区域大）
-    
-    // 步骤3：预处理参数
-    int morphKernelWidth = 1;           // 形态学核宽度（1-3，调大=线条更粗）
-    int morphKernelHeight = 2;          // 形态学核高度（1-5，调大=连接更多断点）
-    int gaussianKernelSize = 3;         // 高斯核大小（3,5,7，调大=更平滑）
-    double gaussianSigma = 0.8;         // 高斯标准差（0.5-2.0，调大=更模糊）
-    
-    // 步骤4：边缘检测参数
-    int cannyLowThreshold = 30;         // Canny低阈值（20-50，调低=更多边缘）
-    int cannyHighThreshold = 100;       // Canny高阈值（80-150，调低=更多边缘）
-    
-    // 步骤5：直线检测参数
-    int houghThreshold = 20;            // 直线检测阈值（10-40，调低=更多直线）
-    double minLineLengthRatio = 0.12;   // 最小线长比例（0.08-0.2，调小=检测更短线）
-    double maxLineGapRatio = 0.08;      // 最大间隙比例（0.05-0.15，调大=连接更多断线）
-    
-    // 表盘类型标识
-    QString dialType = "YYQY";          // 表盘类型（"YYQY"或"BYQ"）
-};
-
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -124,6 +86,39 @@ private:
     QLabel *m_dialTypeLabel;
     QString m_currentDialType;
 
+    // 同框多表相关（一个相机同时读取并排的几块表）
+    QSpinBox  *m_dialCountSpin;
+    QComboBox *m_activeSlotCombo;
+
+    // 自动采集（指针稳定后自动采集当前检测点）
+    QCheckBox      *m_autoCaptureCheck;
+    QDoubleSpinBox *m_autoDwellSpin;
+    SettleDetector  m_settle;
+    QElapsedTimer   m_autoClock;
+    qint64          m_lastAutoProbeMs = -1;
+    bool            m_autoCaptureBusy = false;
+
+    // 实时探测在单独的线程里识别（同一时刻最多一帧），结果排队回到界面线程处理
+    struct LiveProbeResult {
+        qint64 timeMs = 0;                   // 取帧时刻（m_autoClock）
+        bool multi = false;
+        int maxDials = 1;
+        double absDeg = -999;                // 单表：绝对角
+        std::vector<DialReading> dials;      // 多表：各表盘读数
+    };
+    QThreadPool     m_liveProbePool;
+    bool            m_liveProbeRunning = false;
+    void onLiveProbeResult(const LiveProbeResult& result);
+
+    // 逐帧角度记录（内存映射环形文件），用于事后分析卡滞/回差
+    AngleRecorder   m_angleRecorder;
+    QCheckBox      *m_recordCheck;
+    std::vector<CircularWindowStats> m_recordStats;  // 各表位的置信度窗口
+    std::vector<AngleTracker> m_liveTrackers;        // 各表位实时帧的展开角
+
+    // 连续扫描标定
+    QPointer<SweepCalibrationDialog> m_sweepDialog;
+
     HelpDialog* m_helpDialog = nullptr;  // 新增：帮助对话框单实例
     
     // 指针识别配置
@@ -135,39 +130,50 @@ private:
     void setNoCamera();
     void readJson();
     void temporal_LSI();
-    Mat spatial_LSI(Mat speckle,int m);
+    cv::Mat spatial_LSI(cv::Mat speckle,int m);
     void updateCollectionDisplay();
     void setupDialTypeSelector();
     void setupExpandedLayout();  // 设置展开的布局
     void initPointerConfigs();   // 初始化指针识别配置
     void switchPointerConfig(const QString& dialType);  // 切换指针识别配置
+    void setupMultiDialSelector();  // 设置同框表数/当前表位选择器
+    void setupAutoCapture();        // 设置自动采集开关与等待时间
+    void liveProbeTick();           // 预览循环每帧调用：实时识别，记录角度；自动采集时做稳定检测、倒计时、触发采集
+    void setupAngleRecorder();      // 打开逐帧角度记录文件，设置记录开关/曲线按钮
+    void recordAngles(double absDeg, AngleRecordEvent event);  // 记录当前帧（多表时记录所有表位）
+    AngleTracker& liveTracker(int slot);       // 实时探测帧用的展开角（与"采集"的跟踪器分开推进）
+    void syncLiveTrackers();                   // 采集/归位后把实时跟踪器对齐到采集跟踪器
+    void updateLiveTrackers(double absDeg);    // 用本帧结果推进实时跟踪器
+    bool sweepActive() const { return m_sweepDialog && m_sweepDialog->isSweeping(); }
+    bool steppingActive() const { return m_sweepDialog && m_sweepDialog->isStepping(); }
+    void drawAutoCaptureCountdown(double progress, const QString& text);  // 在预览图上画倒计时
     void updateDataDisplayVisibility();  // 根据表盘类型更新数据显示
 
     // ================== 角度相关（新增：连续展开角修复边界问题） ==================
-    // 归位状态
-    bool   m_hasZero   = false;
-    double m_zeroAngle = 0.0;       // 仅用于显示（0~360）
+    // 零位与展开角（Unwrapped Angle）：持续更新"连续角"，避免在 0/360° 处跳变
+    AngleTracker m_angleTracker;
     double m_angleOffset = 0.0;     // 角度偏移量，用于校准
-    Mat m_lastRgb;
-
-    // —— 新增：展开角（Unwrapped Angle）机制 —— 
-    // 持续更新“连续角”，避免在 0/360° 处跳变
-    double m_unwrappedAngle = 0.0;  // 当前帧的连续角（单位：度，可为负/超360）
-    double m_zeroUnwrapped  = 0.0;  // 归位时的连续角（设为相对角 0 的参考）
-    double m_previousAbs    = 0.0;  // 上一帧的绝对角（0~360）
-    bool   m_hasUnwrapped   = false;// 是否已初始化展开角序列
-    double m_lastDelta      = 0.0;  // 最近一次“最短路”角度增量（-180,180]
+    cv::Mat m_lastRgb;
 
-    // 角度工具函数（静态）
-    static double norm0_360(double deg);                         // 归一化到 [0,360)
-    static double wrapSigned180(double deg);                     // 包裹到 (-180,180]
-    static double circularMeanDeg(const std::vector<double>& angles); // 圆统计均值（返回 [0,360)）
-
-    // 用新的绝对角(0~360)更新展开角，返回本帧有符号增量（-180~180]
-    double updateUnwrappedFromAbs(double absDeg);
-
-    // 当前相对角（连续、可负/可超360）= m_unwrappedAngle - m_zeroUnwrapped
-    double currentRelativeAngle() const { return m_unwrappedAngle - m_zeroUnwrapped; }
+    // 同框多表：每个表位独立的展开角/零位由 m_multiDial 维护
+    MultiDialReader m_multiDial;
+    int m_activeSlot = 0;               // 当前显示/操作的表位
+    QVector<double> m_slotCapturedRel;  // "采集"时各表位的相对角，"确定"时写入各自会话
+    bool isMultiDialMode() const { return m_multiDial.maxDials() > 1; }
+    // 当前表位的展开角跟踪器；多表模式下当前表位还没检测到时返回 nullptr
+    AngleTracker* activeTracker();
+    const AngleTracker* activeTracker() const;
+    bool activeHasZero() const;          // 当前表位存在且已归位
+    void storeSlotRelatives();                 // 记录各表位当前相对角
+    // 逐点步进到点后的一次确认：读数写到第 slot 个采集位，并和到点时的参考压力一起记日志
+    struct StepTarget {
+        int slot = 0;
+        bool forward = true;
+        double pressure = 0.0;      // MPa
+        qint64 timestampUs = 0;
+    };
+    // 把各表位的相对角写入各自会话（当前表位除外）；step 非空时写到指定采集位
+    void appendToOtherSlots(bool isForward, const StepTarget* step = nullptr);
 
     // 一站式：传入当前绝对角，内部完成展开与方向更新，返回“相对角(连续)”
     double processAbsAngle(double absDeg);
@@ -175,6 +181,10 @@ private:
     // 根据一帧增量更新行程方向（不改变展开角）
     void updateStrokeDirectionFromDelta(double deltaDeg);
 
+    // 当前表位最近若干帧绝对角的滑动窗口统计（稳定值 ± 标准差、离群判定）
+    CircularWindowStats m_liveStats{15};
+    QString feedLiveStats(double absDeg);      // 加入一帧，返回界面显示用的"稳定值±σ"文字
+
     // ================== 最大角度采集临时变量 ==================
     double m_tempMaxAngle = 0.0;        // 临时存储最大角度（通常取相对角幅值）
     double m_tempCurrentAngle = 0.0;    // 临时存储当前绝对角
@@ -195,19 +205,38 @@ private:
     int    m_strokeDirection = 0;        // 运动方向：1=正行程，-1=反行程，0=未知
     
     // 多轮数据采集相关
-    struct RoundData {
-        QVector<double> forwardAngles;    // 正行程角度数据（存“归位后的连续相对角”）
-        QVector<double> backwardAngles;   // 反行程角度数据（存“归位后的连续相对角”）
-        double maxAngle = 0.0;            // 该轮最大角度（通常取相对角绝对值）
-        bool isCompleted = false;         // 该轮是否完成
-    };
+    using RoundData = SessionRound;
     
-    QVector<RoundData> m_allRoundsData;  // 多轮完整数据
+    QVector<MeasurementSession*> m_slotSessions;  // 各表位独立的测量会话（父对象是主窗口，至少一个）
+    MeasurementSession* m_session = nullptr;      // 当前表位的会话，即 m_slotSessions[m_activeSlot]；误差表格订阅它的变化
+    void resetSlotSessions();                     // 按表数重建各表位的空会话（轮数/每轮次数取当前设置）
     int m_totalRounds = 2;               // 总轮数（可配置，默认2轮）
     int m_currentRound = 0;              // 当前轮次（0到m_totalRounds-1）
     int m_currentDetectionPoint = 0;     // 当前检测点索引
     int m_maxMeasurementsPerRound = 6;   // 每轮最大测量次数（YYQY=6, BYQ=5）
     
+    // 采集会话日志：每次改动追加一条记录，启动时回放恢复（崩溃/断电不丢当前这块表）
+    SessionJournal m_journal;
+    bool m_journalReplaying = false;     // 回放期间不再写日志
+    void setupSessionJournal();
+    void journalAppend(const JournalEntry& entry);
+    void journalSlot(JournalOp op, int slot, int round, bool isForward, int index, double angle,
+                     const StepTarget* step = nullptr);
+    void journalMaxAngle(int slot, int round, double angle, const StepTarget* step = nullptr);
+    // 带参考压力的读数/最大角度记录按格子留一份，压缩快照时原样写回，参考压力不会在压缩时丢掉
+    QHash<quint32, JournalEntry> m_referenceEntries;
+    static quint32 referenceKey(const JournalEntry& entry);
+    void noteReference(const JournalEntry& entry);
+    const JournalEntry* referenceFor(const JournalEntry& entry) const;   // 同一格、同一个值才算
+    void journalRoundReset(int slot, int round);
+    void compactJournal();                        // 用当前状态重写快照
+    QVector<JournalEntry> journalSnapshot() const;
+    void applyJournalEntry(const JournalEntry& entry);
+    MeasurementSession* slotSession(int slot) const;          // 某表位的会话，越界返回 nullptr
+    void setSessionAngle(int slot, int round, bool isForward, int index, double angle);
+    void setSessionMaxAngle(int slot, int round, double angle);
+    void clearSessionRound(int slot, int round);
+    
     // 检测点配置
     QVector<double> m_detectionPoints;   // 检测点压力值列表
     
@@ -223,10 +252,13 @@ private:
     ErrorTableDialog* m_errorTableDialog = nullptr;  // 误差检测表格对话框指针
 
     bool grabOneFrame(cv::Mat &outBar);
+    bool resultPanelVisible() const;   // 右侧结果区是否可见（不可见时不生成叠加图）
+    void showDetectionResult(const cv::Mat& bgr, const DetectionOverlay& overlay,
+                             const std::vector<std::string>& texts, bool blendLsi = false);
     void runAlgoOnce();
-    static void conv2(const Mat &img, const Mat& kernel, ConvolutionType type, Mat& dest);
+    static void conv2(const cv::Mat &img, const cv::Mat& kernel, ConvolutionType type, cv::Mat& dest);
     
-    // 指针运动方向检测方法（实现中将仅依据 m_lastDelta 判定方向）
+    // 指针运动方向检测方法（实现中将仅依据展开角最近一次增量判定方向）
     void updatePointerDirection(double currentAngle);
     QString getStrokeDirectionString() const;
     void resetStrokeTracking();  // 重置行程跟踪
@@ -244,8 +276,11 @@ private:
     
     // 多轮数据管理方法
     void initializeRoundsData();           // 初始化多轮数据结构
-    void addAngleToCurrentRound(double angle, bool isForward);  // 添加角度到当前轮次
-    void updateErrorTableWithAllRounds();  // 更新误差表格显示所有轮次数据
+    void addAngleToCurrentRound(double angle, bool isForward, bool interactive = true);  // 添加角度到当前轮次
+    // "采集"/"确定"的实现；interactive=false 时（自动采集）不弹模态框，问题只显示在状态栏
+    bool captureCurrentAngle(bool interactive);
+    void confirmCurrentData(bool interactive, const StepTarget* step = nullptr);
+    void reportOperationProblem(bool interactive, const QString& title, const QString& text);
     void setCurrentDetectionPoint(int pointIndex);  // 设置当前检测点
     QString getCurrentStatusInfo() const;   // 获取当前状态信息
     
@@ -286,50 +321,14 @@ private slots:
     void onMaxAngleCapture();       // 最大角度采集槽函数
     void onSetRounds2();            // 设置2轮槽函数
     void onSetRounds5();            // 设置5轮槽函数
+    void onDialCountChanged(int count);     // 同框表数变化
+    void onActiveSlotChanged(int index);    // 切换当前表位
+    void onAutoCaptureToggled(bool enabled); // 自动采集开关
+    void showSweepCalibrationDialog();       // 打开扫描标定
+    void onSweepApplied(const QVector<double>& forward, const QVector<double>& backward, double maxAngle);
+    void onPressurePointReached(int pointIndex, bool forward, bool isMax, double pressure, qint64 timestampUs);  // 压力控制器到点，自动采集
+    void onErrorTableAngleEdited(int pointIndex, bool forward, double value);  // 误差表格里手动改了角度
 
 };
 
-class highPreciseDetector {
-private:
-    cv::Mat m_image;
-    cv::Mat m_visual;
-    std::vector<cv::Vec3f> m_circles;
-    std::vector<cv::Vec4i> m_lines;
-    double m_angle;
-    const PointerDetectionConfig* m_config;  // 配置参数指针
-    cv::Point2f m_axisCenter;  // BYQ转轴中心
-    float m_axisRadius;        // BYQ转轴半径
-    static double s_lastValidAngle;  // 上次有效角度，用于稳定性检查
-    
-    // BYQ底部两条黑线（用于自动计算转轴中心）
-    cv::Vec4i m_blackLine1;    // 第一条黑线
-    cv::Vec4i m_blackLine2;    // 第二条黑线
-    bool m_hasBlackLines;      // 是否检测到黑线
-    
-public:
-    explicit highPreciseDetector(const cv::Mat& image, const PointerDetectionConfig* config = nullptr);
-    ~highPreciseDetector() = default;
-
-    const std::vector<cv::Vec3f>& getCircles() const { return m_circles; }
-    const std::vector<cv::Vec4i>& getLine() const { return m_lines; }
-    double getAngle() const { return m_angle; }
-    void showScale1Result();
-    cv::Mat visual() const { return m_visual; }
-    
-private:
-    void detectCircles();
-    void detectLines();
-    void calculateAngle();
-    void detectPointerFromCenter();  // 从圆心开始检测指针的新方法
-    
-    // 白色指针检测专用方法
-    cv::Vec4i detectWhitePointer(const cv::Mat& gray, const cv::Point2f& center, float radius);
-    cv::Vec4i detectWhitePointerByBrightness(const cv::Mat& gray, const cv::Point2f& center, float radius);
-    
-    // BYQ指针检测专用方法
-    cv::Vec4i detectBYQPointer(const cv::Mat& gray, const cv::Point2f& center, float radius);
-    cv::Point2f detectBYQAxis(const cv::Mat& gray, const cv::Point2f& dialCenter, float dialRadius);
-    cv::Vec4i detectSilverPointerEnd(const cv::Mat& gray, const cv::Point2f& axisCenter, const cv::Point2f& dialCenter, float dialRadius);
-};
-
 #endif // MAINWINDOW_H
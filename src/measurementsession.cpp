@@ -0,0 +1,106 @@
+#include "measurementsession.h"
+
+MeasurementSession::MeasurementSession(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void MeasurementSession::reset(int rounds, int slots)
+{
+    m_store.reset(qMax(0, slots), qMax(0, rounds));
+    m_completed.fill(false, m_store.rounds());
+    emit layoutReset();
+}
+
+void MeasurementSession::load(const QVector<SessionRound>& rounds)
+{
+    int slots = 0;
+    for (const SessionRound& r : rounds) {
+        slots = qMax(slots, int(qMax(r.forwardAngles.size(), r.backwardAngles.size())));
+    }
+    m_store.reset(slots, rounds.size());
+    m_completed.fill(false, rounds.size());
+    for (int round = 0; round < rounds.size(); ++round) {
+        const SessionRound& r = rounds[round];
+        for (int i = 0; i < r.forwardAngles.size() && i < r.forwardValid.size(); ++i) {
+            if (r.forwardValid[i]) m_store.set(i, round, Forward, r.forwardAngles[i]);
+        }
+        for (int i = 0; i < r.backwardAngles.size() && i < r.backwardValid.size(); ++i) {
+            if (r.backwardValid[i]) m_store.set(i, round, Backward, r.backwardAngles[i]);
+        }
+        m_store.setMaxAngle(round, r.maxAngle);
+        m_completed[round] = r.isCompleted;
+    }
+    emit layoutReset();
+}
+
+QVector<SessionRound> MeasurementSession::data() const
+{
+    QVector<SessionRound> out;
+    out.reserve(rounds());
+    for (int r = 0; r < rounds(); ++r) out.append(round(r));
+    return out;
+}
+
+SessionRound MeasurementSession::round(int round) const
+{
+    SessionRound out;
+    if (!hasRound(round)) return out;
+    const int slots = m_store.points();
+    out.forwardAngles = QVector<double>(m_store.row(round, Forward), m_store.row(round, Forward) + slots);
+    out.backwardAngles = QVector<double>(m_store.row(round, Backward), m_store.row(round, Backward) + slots);
+    out.forwardValid.resize(slots);
+    out.backwardValid.resize(slots);
+    for (int i = 0; i < slots; ++i) {
+        out.forwardValid[i] = m_store.valid(i, round, Forward);
+        out.backwardValid[i] = m_store.valid(i, round, Backward);
+    }
+    out.maxAngle = m_store.maxAngle(round);
+    out.isCompleted = m_completed[round];
+    return out;
+}
+
+double MeasurementSession::angle(int round, int stroke, int slot) const
+{
+    // 无数据的格子在存储里是 0.0（有没有数据看 hasAngle）
+    if (!hasRound(round) || slot < 0 || slot >= m_store.points()) return 0.0;
+    return m_store.angle(slot, round, stroke);
+}
+
+void MeasurementSession::setAngle(int round, int stroke, int slot, double angle)
+{
+    if (!hasRound(round) || slot < 0 || slot >= m_store.points()) return;
+    if (m_store.valid(slot, round, stroke) && m_store.angle(slot, round, stroke) == angle) return;
+    m_store.set(slot, round, stroke, angle);
+    emit angleChanged(round, stroke, slot, angle);
+}
+
+void MeasurementSession::clearAngle(int round, int stroke, int slot)
+{
+    if (!m_store.valid(slot, round, stroke)) return;
+    m_store.clear(slot, round, stroke);
+    emit angleCleared(round, stroke, slot);
+}
+
+void MeasurementSession::setMaxAngle(int round, double angle)
+{
+    if (!hasRound(round) || m_store.maxAngle(round) == angle) return;
+    m_store.setMaxAngle(round, angle);
+    emit maxAngleChanged(round, angle);
+}
+
+void MeasurementSession::setCompleted(int round, bool completed)
+{
+    if (!hasRound(round) || m_completed[round] == completed) return;
+    m_completed[round] = completed;
+    m_store.touch(round);
+    emit roundCompletedChanged(round, completed);
+}
+
+void MeasurementSession::clearRound(int round)
+{
+    if (!hasRound(round)) return;
+    m_store.clearRound(round);
+    m_completed[round] = false;
+    emit roundCleared(round);
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <QObject>
+#include <QVector>
+
+#include "analysis/measurementstore.h"
+
+// ================== 采集数据（主界面与误差表格共用） ==================
+// 一块表每一轮每个采集位的角度只在这里存一份：主界面写，误差表格等窗口通过访问函数读、订阅变化信号。
+// 每次写入只发"第 r 轮 / 某行程 / 第 i 个采集位"这一格的信号，观察者只更新对应的行，
+// 不再把全部轮次拷成数组再整表重建。
+// 采集位 i 就是第 i 个检测点（正行程从前往后填，反行程从后往前填，位置都按检测点顺序）。
+// 有没有数据看有效位（hasAngle），0° 是正常读数（归位那一格就是 0°）；清空单格用 clearAngle。
+// 数据直接存在 MeasurementStore 里（采集位 = 存储的检测点），误差表格的完成判断、最终角度、误差核都在它上面算。
+
+struct SessionRound {
+    QVector<double> forwardAngles;    // 正行程角度数据（存"归位后的连续相对角"）
+    QVector<double> backwardAngles;   // 反行程角度数据（存"归位后的连续相对角"）
+    QVector<bool> forwardValid;       // 该采集位有读数（与角度数组等长；没有的位置角度为 0.0）
+    QVector<bool> backwardValid;
+    double maxAngle = 0.0;            // 该轮最大角度（通常取相对角绝对值）
+    bool isCompleted = false;         // 该轮是否完成
+};
+
+class MeasurementSession : public QObject {
+    Q_OBJECT
+public:
+    enum Stroke { Forward = MeasurementStore::Forward, Backward = MeasurementStore::Backward };
+
+    explicit MeasurementSession(QObject* parent = nullptr);
+
+    // 重新分配为 rounds 轮、每轮 slots 个采集位的空会话
+    void reset(int rounds, int slots);
+    // 整份换入（日志/文件恢复），形状以传入数据为准；按 forwardValid/backwardValid 判断哪些格有读数
+    void load(const QVector<SessionRound>& rounds);
+    // 整份拷出（日志快照、存盘用）；平时读单格用下面的访问函数
+    QVector<SessionRound> data() const;
+
+    int rounds() const { return m_store.rounds(); }
+    int slotsPerRound() const { return m_store.points(); }
+    bool hasRound(int round) const { return round >= 0 && round < m_store.rounds(); }
+    SessionRound round(int round) const;   // 拷出一轮
+
+    double angle(int round, int stroke, int slot) const;   // 没数据时为 0.0，先用 hasAngle 判断
+    bool hasAngle(int round, int stroke, int slot) const { return m_store.valid(slot, round, stroke); }
+    int angleCount(int round, int stroke) const { return hasRound(round) ? m_store.count(round, stroke) : 0; }
+    // 该轮该行程的采集位都有读数
+    bool strokeComplete(int round, int stroke) const { return hasRound(round) && m_store.count(round, stroke) == m_store.points(); }
+    double maxAngle(int round) const { return m_store.maxAngle(round); }
+    bool isCompleted(int round) const { return hasRound(round) && m_completed[round]; }
+    // 计算用的只读视图：汇总量（成对平均、完成计数、每轮版本号）都在写入时增量维护
+    const MeasurementStore& store() const { return m_store; }
+
+    // 写入单个采集位（任何角度都是读数，包括 0°）；值没变时不发信号
+    void setAngle(int round, int stroke, int slot, double angle);
+    void clearAngle(int round, int stroke, int slot);
+    void setMaxAngle(int round, double angle);
+    void setCompleted(int round, bool completed);
+    // 清空一轮的角度、最大角度和完成标记
+    void clearRound(int round);
+
+signals:
+    void angleChanged(int round, int stroke, int slot, double angle);
+    void angleCleared(int round, int stroke, int slot);
+    void maxAngleChanged(int round, double angle);
+    void roundCompletedChanged(int round, bool completed);
+    void roundCleared(int round);
+    void layoutReset();   // 轮数/采集位数变了或整份换入，观察者需要整体重读
+
+private:
+    MeasurementStore m_store;       // [stroke][round][slot]
+    QVector<bool> m_completed;      // 每轮完成标记
+};
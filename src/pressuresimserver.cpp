@@ -0,0 +1,153 @@
+// 压力控制器模拟进程：没有实验台时代替真实控制器。
+// 用法：
+//   pressure_sim [--port 5025] [--rate 0.2] [--freq 0.8] [--damping 0.45] [--noise 0.002] [--pty]
+// 默认在 TCP 端口上说文本行协议（见 analysis/pressurecontroller.h），
+// 程序里压力源地址填 127.0.0.1:5025 即可；--pty（仅 Linux/macOS）额外开一个伪终端，
+// 打印出的 /dev/pts/N 可当作串口，用 serial:/dev/pts/N 连接，走串口那条路径。
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSocketNotifier>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTextStream>
+
+#include "analysis/pressurecontroller.h"
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 所有连接共用一个控制器：按真实时间推进后再处理命令
+class SimController {
+public:
+    explicit SimController(const PressureControllerParams& params) : m_model(params, 12345u) {
+        m_model.reset(0.0);
+        m_clock.start();
+    }
+
+    QByteArray handle(const QByteArray& line) {
+        m_model.step(m_clock.restart() / 1000.0);
+        const std::string reply = PressureProtocol::handleCommand(line.toStdString(), m_model);
+        if (line.trimmed().toUpper().startsWith("SETP ")) {
+            QTextStream(stdout) << "目标压力 -> " << m_model.target() << " MPa" << Qt::endl;
+        }
+        return QByteArray::fromStdString(reply) + "\n";
+    }
+
+private:
+    PressureControllerModel m_model;
+    QElapsedTimer m_clock;
+};
+
+// 从缓冲里切出完整的行，逐行处理
+QByteArray consumeLines(QByteArray& buffer, SimController& sim) {
+    QByteArray out;
+    int nl;
+    while ((nl = buffer.indexOf('\n')) >= 0) {
+        const QByteArray line = buffer.left(nl).trimmed();
+        buffer.remove(0, nl + 1);
+        if (!line.isEmpty()) out += sim.handle(line);
+    }
+    if (buffer.size() > 4096) buffer.clear();
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("pressure_sim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("压力控制器模拟器（文本行协议）");
+    parser.addHelpOption();
+    QCommandLineOption portOpt("port", "TCP 端口", "port", "5025");
+    QCommandLineOption rateOpt("rate", "升降速率 MPa/s", "rate", "0.2");
+    QCommandLineOption freqOpt("freq", "固有频率 Hz（越大稳定越快）", "hz", "0.8");
+    QCommandLineOption dampOpt("damping", "阻尼比（越小超调越大）", "zeta", "0.45");
+    QCommandLineOption noiseOpt("noise", "读数噪声 MPa", "mpa", "0.002");
+    QCommandLineOption ptyOpt("pty", "同时开一个伪终端当串口用");
+    parser.addOptions({portOpt, rateOpt, freqOpt, dampOpt, noiseOpt, ptyOpt});
+    parser.process(app);
+
+    PressureControllerParams params;
+    params.rampPerSec = parser.value(rateOpt).toDouble();
+    params.naturalFreqHz = parser.value(freqOpt).toDouble();
+    params.damping = parser.value(dampOpt).toDouble();
+    params.noiseMPa = parser.value(noiseOpt).toDouble();
+    SimController sim(params);
+
+    QTextStream out(stdout);
+
+    QTcpServer server;
+    const quint16 port = parser.value(portOpt).toUShort();
+    if (!server.listen(QHostAddress::Any, port)) {
+        out << "监听端口 " << port << " 失败: " << server.errorString() << Qt::endl;
+        return 1;
+    }
+    out << "压力控制器模拟器已启动，TCP 端口 " << server.serverPort()
+        << "（速率 " << params.rampPerSec << " MPa/s，阻尼 " << params.damping << "）" << Qt::endl;
+
+    QObject::connect(&server, &QTcpServer::newConnection, [&]() {
+        while (QTcpSocket* sock = server.nextPendingConnection()) {
+            out << "客户端接入: " << sock->peerAddress().toString() << Qt::endl;
+            auto* buffer = new QByteArray;
+            QObject::connect(sock, &QTcpSocket::readyRead, sock, [sock, buffer, &sim]() {
+                *buffer += sock->readAll();
+                const QByteArray reply = consumeLines(*buffer, sim);
+                if (!reply.isEmpty()) sock->write(reply);
+            });
+            QObject::connect(sock, &QTcpSocket::disconnected, sock, [sock, buffer]() {
+                delete buffer;
+                sock->deleteLater();
+            });
+        }
+    });
+
+#ifdef Q_OS_UNIX
+    QByteArray ptyBuffer;
+    if (parser.isSet(ptyOpt)) {
+        const int master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            out << "创建伪终端失败" << Qt::endl;
+            return 1;
+        }
+        // 原始模式：不回显、不做行编辑，与真实串口设备一致
+        termios tio;
+        if (tcgetattr(master, &tio) == 0) {
+            cfmakeraw(&tio);
+            tcsetattr(master, TCSANOW, &tio);
+        }
+        // 自己先占住从端：没有客户端打开时主端读到的是 EIO，通知器会空转
+        if (::open(ptsname(master), O_RDWR | O_NOCTTY) < 0) {
+            out << "打开伪终端从端失败" << Qt::endl;
+            return 1;
+        }
+        out << "伪终端: " << ptsname(master) << "（程序中填 serial:" << ptsname(master) << "）" << Qt::endl;
+
+        auto* notifier = new QSocketNotifier(master, QSocketNotifier::Read, &app);
+        QObject::connect(notifier, &QSocketNotifier::activated, [master, &ptyBuffer, &sim]() {
+            char buf[512];
+            const ssize_t n = ::read(master, buf, sizeof(buf));
+            if (n <= 0) return;
+            ptyBuffer.append(buf, int(n));
+            const QByteArray reply = consumeLines(ptyBuffer, sim);
+            if (!reply.isEmpty() && ::write(master, reply.constData(), reply.size()) < 0) {
+                // 对端已关闭，丢弃
+            }
+        });
+    }
+#else
+    if (parser.isSet(ptyOpt)) out << "当前平台不支持 --pty，请用 TCP 或虚拟串口工具" << Qt::endl;
+#endif
+
+    return app.exec();
+}
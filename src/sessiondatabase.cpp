@@ -0,0 +1,499 @@
+#include "sessiondatabase.h"
+
+#include <QDebug>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QVariant>
+
+namespace {
+
+const int kSchemaVersion = 1;
+
+QString joinNumbers(const QVector<double>& values)
+{
+    QStringList parts;
+    for (double v : values) parts << QString::number(v, 'g', 10);
+    return parts.join(',');
+}
+
+QVector<double> splitNumbers(const QString& text)
+{
+    QVector<double> out;
+    for (const QString& part : text.split(',', Qt::SkipEmptyParts)) out.append(part.toDouble());
+    return out;
+}
+
+} // namespace
+
+SessionDatabase::SessionDatabase(const QString& connectionName)
+    : m_connectionName(connectionName)
+{
+}
+
+SessionDatabase::~SessionDatabase()
+{
+    close();
+}
+
+QString SessionDatabase::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/PressureGauge_Sessions.db";
+}
+
+bool SessionDatabase::fail(const QString& where, const QString& error)
+{
+    m_lastError = where + ": " + error;
+    qDebug() << "检测记录数据库错误 -" << m_lastError;
+    return false;
+}
+
+bool SessionDatabase::isOpen() const
+{
+    return QSqlDatabase::contains(m_connectionName) && QSqlDatabase::database(m_connectionName, false).isOpen();
+}
+
+bool SessionDatabase::open(const QString& path)
+{
+    if (isOpen()) return true;
+
+    QSqlDatabase db = QSqlDatabase::contains(m_connectionName) ? QSqlDatabase::database(m_connectionName, false)
+                                                               : QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    db.setDatabaseName(path);
+    if (!db.open()) return fail("打开 " + path, db.lastError().text());
+
+    // WAL：写入时不挡住查询；NORMAL 同步在 WAL 下断电也不会损坏库
+    QSqlQuery q(db);
+    q.exec("PRAGMA journal_mode=WAL");
+    q.exec("PRAGMA synchronous=NORMAL");
+    q.exec("PRAGMA foreign_keys=ON");
+    if (!ensureSchema()) {
+        db.close();
+        return false;
+    }
+    qDebug() << "检测记录数据库已打开:" << path;
+    return true;
+}
+
+void SessionDatabase::close()
+{
+    if (!QSqlDatabase::contains(m_connectionName)) return;
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+        if (db.isOpen()) db.close();
+    }
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+bool SessionDatabase::ensureSchema()
+{
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+    QSqlQuery q(db);
+    q.exec("PRAGMA user_version");
+    const int version = q.next() ? q.value(0).toInt() : 0;
+    if (version >= kSchemaVersion) return true;
+
+    const char* ddl[] = {
+        "CREATE TABLE IF NOT EXISTS products ("
+        " id INTEGER PRIMARY KEY,"
+        " model TEXT NOT NULL,"
+        " name TEXT NOT NULL DEFAULT '',"
+        " dial_drawing_no TEXT NOT NULL DEFAULT '',"
+        " max_pressure REAL,"
+        " UNIQUE(model, name, dial_drawing_no))",
+
+        "CREATE TABLE IF NOT EXISTS gauges ("
+        " id INTEGER PRIMARY KEY,"
+        " product_id INTEGER NOT NULL REFERENCES products(id),"
+        " group_no TEXT NOT NULL DEFAULT '',"
+        " serial TEXT NOT NULL,"
+        " UNIQUE(product_id, group_no, serial))",
+
+        "CREATE TABLE IF NOT EXISTS sessions ("
+        " id INTEGER PRIMARY KEY,"
+        " gauge_id INTEGER NOT NULL REFERENCES gauges(id),"
+        " started_at INTEGER NOT NULL,"          // 毫秒时间戳
+        " saved_at INTEGER NOT NULL,"
+        " day TEXT NOT NULL,"                    // yyyy-MM-dd，按天统计用
+        " total_rounds INTEGER NOT NULL,"
+        " current_round INTEGER NOT NULL,"
+        " detection_points TEXT NOT NULL,"       // 逗号分隔的检测点压力
+        " avg_max_angle REAL,"
+        " max_abs_err_mpa REAL,"
+        " passed INTEGER NOT NULL DEFAULT -1)",
+
+        "CREATE TABLE IF NOT EXISTS rounds ("
+        " session_id INTEGER NOT NULL REFERENCES sessions(id) ON DELETE CASCADE,"
+        " round_index INTEGER NOT NULL,"
+        " max_angle REAL,"
+        " PRIMARY KEY(session_id, round_index))",
+
+        "CREATE TABLE IF NOT EXISTS readings ("
+        " session_id INTEGER NOT NULL REFERENCES sessions(id) ON DELETE CASCADE,"
+        " round_index INTEGER NOT NULL,"
+        " point_index INTEGER NOT NULL,"
+        " pressure REAL NOT NULL,"
+        " stroke INTEGER NOT NULL,"
+        " seq INTEGER NOT NULL,"
+        " angle REAL NOT NULL,"
+        " error_mpa REAL)",
+
+        "CREATE INDEX IF NOT EXISTS idx_products_model ON products(model)",
+        "CREATE INDEX IF NOT EXISTS idx_gauges_group ON gauges(group_no)",
+        "CREATE INDEX IF NOT EXISTS idx_sessions_day ON sessions(day)",
+        "CREATE INDEX IF NOT EXISTS idx_sessions_gauge ON sessions(gauge_id)",
+        "CREATE INDEX IF NOT EXISTS idx_readings_session ON readings(session_id, point_index)",
+    };
+
+    if (!db.transaction()) return fail("建表", db.lastError().text());
+    for (const char* sql : ddl) {
+        if (!q.exec(sql)) {
+            db.rollback();
+            return fail("建表", q.lastError().text());
+        }
+    }
+    q.exec(QString("PRAGMA user_version=%1").arg(kSchemaVersion));
+    return db.commit() || fail("建表", db.lastError().text());
+}
+
+qint64 SessionDatabase::productId(const SessionRecord& rec)
+{
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+    QSqlQuery q(db);
+    q.prepare("INSERT OR IGNORE INTO products(model, name, dial_drawing_no, max_pressure) VALUES(?, ?, ?, ?)");
+    q.addBindValue(rec.productModel);
+    q.addBindValue(rec.productName);
+    q.addBindValue(rec.dialDrawingNo);
+    q.addBindValue(rec.maxPressure);
+    if (!q.exec()) {
+        fail("写入型号", q.lastError().text());
+        return -1;
+    }
+
+    q.prepare("SELECT id FROM products WHERE model = ? AND name = ? AND dial_drawing_no = ?");
+    q.addBindValue(rec.productModel);
+    q.addBindValue(rec.productName);
+    q.addBindValue(rec.dialDrawingNo);
+    if (!q.exec() || !q.next()) {
+        fail("查询型号", q.lastError().text());
+        return -1;
+    }
+    return q.value(0).toLongLong();
+}
+
+qint64 SessionDatabase::gaugeId(qint64 product, const SessionRecord& rec)
+{
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+    QSqlQuery q(db);
+    q.prepare("INSERT OR IGNORE INTO gauges(product_id, group_no, serial) VALUES(?, ?, ?)");
+    q.addBindValue(product);
+    q.addBindValue(rec.groupNo);
+    q.addBindValue(rec.gaugeSerial);
+    if (!q.exec()) {
+        fail("写入表号", q.lastError().text());
+        return -1;
+    }
+
+    q.prepare("SELECT id FROM gauges WHERE product_id = ? AND group_no = ? AND serial = ?");
+    q.addBindValue(product);
+    q.addBindValue(rec.groupNo);
+    q.addBindValue(rec.gaugeSerial);
+    if (!q.exec() || !q.next()) {
+        fail("查询表号", q.lastError().text());
+        return -1;
+    }
+    return q.value(0).toLongLong();
+}
+
+bool SessionDatabase::writeSession(SessionRecord& rec)
+{
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+    if (!rec.startedAt.isValid()) rec.startedAt = QDateTime::currentDateTime();
+    if (!rec.savedAt.isValid()) rec.savedAt = QDateTime::currentDateTime();
+    if (rec.gaugeSerial.isEmpty()) rec.gaugeSerial = rec.startedAt.toString("yyyyMMdd-HHmmss-zzz");
+
+    const qint64 product = productId(rec);
+    if (product < 0) return false;
+    const qint64 gauge = gaugeId(product, rec);
+    if (gauge < 0) return false;
+
+    QSqlQuery q(db);
+    if (rec.id < 0) {
+        q.prepare("INSERT INTO sessions(gauge_id, started_at, saved_at, day, total_rounds, current_round,"
+                  " detection_points, avg_max_angle, max_abs_err_mpa, passed) VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    } else {
+        q.prepare("UPDATE sessions SET gauge_id = ?, started_at = ?, saved_at = ?, day = ?, total_rounds = ?,"
+                  " current_round = ?, detection_points = ?, avg_max_angle = ?, max_abs_err_mpa = ?, passed = ?"
+                  " WHERE id = ?");
+    }
+    q.addBindValue(gauge);
+    q.addBindValue(rec.startedAt.toMSecsSinceEpoch());
+    q.addBindValue(rec.savedAt.toMSecsSinceEpoch());
+    q.addBindValue(rec.startedAt.date().toString("yyyy-MM-dd"));
+    q.addBindValue(rec.totalRounds);
+    q.addBindValue(rec.currentRound);
+    q.addBindValue(joinNumbers(rec.detectionPoints));
+    q.addBindValue(rec.avgMaxAngle);
+    q.addBindValue(rec.maxAbsErrMPa);
+    q.addBindValue(rec.passed);
+    if (rec.id >= 0) q.addBindValue(rec.id);
+    if (!q.exec()) return fail("写入检测记录", q.lastError().text());
+
+    if (rec.id < 0) {
+        rec.id = q.lastInsertId().toLongLong();
+    } else {
+        // 更新：本次检测的轮次/读数整体替换
+        QSqlQuery del(db);
+        del.prepare("DELETE FROM readings WHERE session_id = ?");
+        del.addBindValue(rec.id);
+        if (!del.exec()) return fail("清除旧读数", del.lastError().text());
+        del.prepare("DELETE FROM rounds WHERE session_id = ?");
+        del.addBindValue(rec.id);
+        if (!del.exec()) return fail("清除旧轮次", del.lastError().text());
+    }
+
+    // 轮次与读数用 execBatch 一次绑定整列
+    QVariantList sid, ridx, rmax;
+    for (int r = 0; r < rec.roundMaxAngles.size(); ++r) {
+        sid << rec.id;
+        ridx << r;
+        rmax << rec.roundMaxAngles[r];
+    }
+    if (!sid.isEmpty()) {
+        q.prepare("INSERT INTO rounds(session_id, round_index, max_angle) VALUES(?, ?, ?)");
+        q.addBindValue(sid);
+        q.addBindValue(ridx);
+        q.addBindValue(rmax);
+        if (!q.execBatch()) return fail("写入轮次", q.lastError().text());
+    }
+
+    if (!rec.readings.isEmpty()) {
+        QVariantList s, round, point, pressure, stroke, seq, angle, err;
+        for (const SessionReading& r : rec.readings) {
+            s << rec.id;
+            round << r.round;
+            point << r.pointIndex;
+            pressure << r.pressure;
+            stroke << r.stroke;
+            seq << r.seq;
+            angle << r.angle;
+            err << (r.hasError ? QVariant(r.errorMPa) : QVariant());
+        }
+        q.prepare("INSERT INTO readings(session_id, round_index, point_index, pressure, stroke, seq, angle, error_mpa)"
+                  " VALUES(?, ?, ?, ?, ?, ?, ?, ?)");
+        for (QVariantList* col : {&s, &round, &point, &pressure, &stroke, &seq, &angle, &err}) q.addBindValue(*col);
+        if (!q.execBatch()) return fail("写入读数", q.lastError().text());
+    }
+    return true;
+}
+
+bool SessionDatabase::saveSession(SessionRecord& rec)
+{
+    QVector<SessionRecord> one{rec};
+    if (!saveSessions(one)) return false;
+    rec = one.first();
+    return true;
+}
+
+bool SessionDatabase::saveSessions(QVector<SessionRecord>& recs)
+{
+    if (!isOpen() && !open()) return false;
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+    if (!db.transaction()) return fail("开始事务", db.lastError().text());
+
+    QVector<qint64> oldIds;
+    for (SessionRecord& rec : recs) {
+        oldIds << rec.id;
+        if (!writeSession(rec)) {
+            db.rollback();
+            // 回滚后新分配的 id 作废
+            for (int i = 0; i < oldIds.size(); ++i) recs[i].id = oldIds[i];
+            return false;
+        }
+    }
+    return db.commit() || fail("提交事务", db.lastError().text());
+}
+
+bool SessionDatabase::loadSession(qint64 id, SessionRecord& out)
+{
+    if (!isOpen() && !open()) return false;
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+    QSqlQuery q(db);
+    q.prepare("SELECT p.model, p.name, p.dial_drawing_no, p.max_pressure, g.group_no, g.serial,"
+              " s.started_at, s.saved_at, s.total_rounds, s.current_round, s.detection_points,"
+              " s.avg_max_angle, s.max_abs_err_mpa, s.passed"
+              " FROM sessions s JOIN gauges g ON g.id = s.gauge_id JOIN products p ON p.id = g.product_id"
+              " WHERE s.id = ?");
+    q.addBindValue(id);
+    if (!q.exec() || !q.next()) return fail("读取检测记录", q.lastError().text());
+
+    out = SessionRecord();
+    out.id = id;
+    out.productModel = q.value(0).toString();
+    out.productName = q.value(1).toString();
+    out.dialDrawingNo = q.value(2).toString();
+    out.maxPressure = q.value(3).toDouble();
+    out.groupNo = q.value(4).toString();
+    out.gaugeSerial = q.value(5).toString();
+    out.startedAt = QDateTime::fromMSecsSinceEpoch(q.value(6).toLongLong());
+    out.savedAt = QDateTime::fromMSecsSinceEpoch(q.value(7).toLongLong());
+    out.totalRounds = q.value(8).toInt();
+    out.currentRound = q.value(9).toInt();
+    out.detectionPoints = splitNumbers(q.value(10).toString());
+    out.avgMaxAngle = q.value(11).toDouble();
+    out.maxAbsErrMPa = q.value(12).toDouble();
+    out.passed = q.value(13).toInt();
+
+    q.prepare("SELECT round_index, max_angle FROM rounds WHERE session_id = ? ORDER BY round_index");
+    q.addBindValue(id);
+    if (!q.exec()) return fail("读取轮次", q.lastError().text());
+    out.roundMaxAngles.fill(0.0, out.totalRounds);
+    while (q.next()) {
+        const int r = q.value(0).toInt();
+        if (r >= 0 && r < out.roundMaxAngles.size()) out.roundMaxAngles[r] = q.value(1).toDouble();
+    }
+
+    q.prepare("SELECT round_index, point_index, pressure, stroke, seq, angle, error_mpa FROM readings"
+              " WHERE session_id = ? ORDER BY round_index, stroke DESC, seq");
+    q.addBindValue(id);
+    if (!q.exec()) return fail("读取读数", q.lastError().text());
+    while (q.next()) {
+        SessionReading r;
+        r.round = q.value(0).toInt();
+        r.pointIndex = q.value(1).toInt();
+        r.pressure = q.value(2).toDouble();
+        r.stroke = q.value(3).toInt();
+        r.seq = q.value(4).toInt();
+        r.angle = q.value(5).toDouble();
+        r.hasError = !q.value(6).isNull();
+        r.errorMPa = q.value(6).toDouble();
+        out.readings.append(r);
+    }
+    return true;
+}
+
+// WHERE 子句：只用有索引的列（型号、支组编号、日期）
+QString SessionDatabase::filterSql(const SessionFilter& filter, QVariantList& binds) const
+{
+    QStringList where;
+    if (!filter.productModel.isEmpty()) {
+        where << "p.model = ?";
+        binds << filter.productModel;
+    }
+    if (!filter.groupNo.isEmpty()) {
+        where << "g.group_no = ?";
+        binds << filter.groupNo;
+    }
+    if (filter.from.isValid()) {
+        where << "s.day >= ?";
+        binds << filter.from.toString("yyyy-MM-dd");
+    }
+    if (filter.to.isValid()) {
+        where << "s.day <= ?";
+        binds << filter.to.toString("yyyy-MM-dd");
+    }
+    return where.isEmpty() ? QString() : " WHERE " + where.join(" AND ");
+}
+
+QVector<SessionSummary> SessionDatabase::querySessions(const SessionFilter& filter, int limit)
+{
+    QVector<SessionSummary> out;
+    if (!isOpen() && !open()) return out;
+
+    QVariantList binds;
+    const QString sql = "SELECT s.id, s.saved_at, p.model, p.name, p.dial_drawing_no, g.group_no, g.serial,"
+                        " s.avg_max_angle, s.max_abs_err_mpa, s.passed"
+                        " FROM sessions s JOIN gauges g ON g.id = s.gauge_id JOIN products p ON p.id = g.product_id"
+                        + filterSql(filter, binds) + " ORDER BY s.saved_at DESC LIMIT ?";
+    binds << limit;
+
+    QSqlQuery q(QSqlDatabase::database(m_connectionName, false));
+    q.setForwardOnly(true);
+    q.prepare(sql);
+    for (const QVariant& v : binds) q.addBindValue(v);
+    if (!q.exec()) {
+        fail("查询检测记录", q.lastError().text());
+        return out;
+    }
+    while (q.next()) {
+        SessionSummary s;
+        s.id = q.value(0).toLongLong();
+        s.savedAt = QDateTime::fromMSecsSinceEpoch(q.value(1).toLongLong());
+        s.productModel = q.value(2).toString();
+        s.productName = q.value(3).toString();
+        s.dialDrawingNo = q.value(4).toString();
+        s.groupNo = q.value(5).toString();
+        s.gaugeSerial = q.value(6).toString();
+        s.avgMaxAngle = q.value(7).toDouble();
+        s.maxAbsErrMPa = q.value(8).toDouble();
+        s.passed = q.value(9).toInt();
+        out.append(s);
+    }
+    return out;
+}
+
+QVector<YieldStat> SessionDatabase::yieldByDay(const SessionFilter& filter)
+{
+    QVector<YieldStat> out;
+    if (!isOpen() && !open()) return out;
+
+    QVariantList binds;
+    QString where = filterSql(filter, binds);
+    where += where.isEmpty() ? " WHERE s.passed >= 0" : " AND s.passed >= 0";   // 只统计已完成的
+    const QString sql = "SELECT s.day, COUNT(*), SUM(s.passed)"
+                        " FROM sessions s JOIN gauges g ON g.id = s.gauge_id JOIN products p ON p.id = g.product_id"
+                        + where + " GROUP BY s.day ORDER BY s.day";
+
+    QSqlQuery q(QSqlDatabase::database(m_connectionName, false));
+    q.setForwardOnly(true);
+    q.prepare(sql);
+    for (const QVariant& v : binds) q.addBindValue(v);
+    if (!q.exec()) {
+        fail("统计合格率", q.lastError().text());
+        return out;
+    }
+    while (q.next()) {
+        YieldStat y;
+        y.day = QDate::fromString(q.value(0).toString(), "yyyy-MM-dd");
+        y.total = q.value(1).toInt();
+        y.passed = q.value(2).toInt();
+        out.append(y);
+    }
+    return out;
+}
+
+QVector<PointErrorTrend> SessionDatabase::pointErrorTrend(const SessionFilter& filter)
+{
+    QVector<PointErrorTrend> out;
+    if (!isOpen() && !open()) return out;
+
+    QVariantList binds;
+    QString where = filterSql(filter, binds);
+    where += where.isEmpty() ? " WHERE r.error_mpa IS NOT NULL" : " AND r.error_mpa IS NOT NULL";
+    const QString sql = "SELECT s.day, r.point_index, MIN(r.pressure), COUNT(*), AVG(r.error_mpa), MAX(ABS(r.error_mpa))"
+                        " FROM sessions s JOIN gauges g ON g.id = s.gauge_id JOIN products p ON p.id = g.product_id"
+                        " JOIN readings r ON r.session_id = s.id"
+                        + where + " GROUP BY s.day, r.point_index ORDER BY s.day, r.point_index";
+
+    QSqlQuery q(QSqlDatabase::database(m_connectionName, false));
+    q.setForwardOnly(true);
+    q.prepare(sql);
+    for (const QVariant& v : binds) q.addBindValue(v);
+    if (!q.exec()) {
+        fail("统计检测点误差", q.lastError().text());
+        return out;
+    }
+    while (q.next()) {
+        PointErrorTrend t;
+        t.day = QDate::fromString(q.value(0).toString(), "yyyy-MM-dd");
+        t.pointIndex = q.value(1).toInt();
+        t.pressure = q.value(2).toDouble();
+        t.count = q.value(3).toInt();
+        t.meanErrMPa = q.value(4).toDouble();
+        t.maxAbsErrMPa = q.value(5).toDouble();
+        out.append(t);
+    }
+    return out;
+}
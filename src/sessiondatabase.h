@@ -0,0 +1,116 @@
+#pragma once
+#include <QDate>
+#include <QDateTime>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+// ================== 检测记录数据库（SQLite） ==================
+// 每次保存的一块表就是一条 session，不再覆盖上一块表的数据。
+// 表结构：products(型号/名称/图号) → gauges(支组编号/表号) → sessions(一次检测) → rounds / readings。
+// 型号、支组编号、日期上有索引，按天查几千块表的历史、合格率和各检测点误差趋势都走索引，
+// 不需要把数据全部读进内存。写入在一个事务里完成，读数用预编译语句批量插入。
+
+struct SessionReading {
+    int round = 0;            // 轮次 0..
+    int pointIndex = 0;       // 检测点下标
+    double pressure = 0.0;    // 检测点压力 MPa
+    int stroke = 1;           // 1=正行程 -1=反行程
+    int seq = 0;              // 本轮该行程内的第几次
+    double angle = 0.0;       // 相对角(°)
+    bool hasError = false;    // 全部轮次完成后才有误差
+    double errorMPa = 0.0;
+};
+
+struct SessionRecord {
+    qint64 id = -1;           // <0 表示新记录，保存后回填
+    QString productModel;
+    QString productName;
+    QString dialDrawingNo;
+    QString groupNo;
+    QString gaugeSerial;      // 表号；为空时按开始时间生成
+    double maxPressure = 0.0;
+    QDateTime startedAt;
+    QDateTime savedAt;
+    int totalRounds = 0;
+    int currentRound = 0;
+    QVector<double> detectionPoints;
+    QVector<double> roundMaxAngles;
+    double avgMaxAngle = 0.0;
+    double maxAbsErrMPa = 0.0;
+    int passed = -1;          // -1=未完成 0=不合格 1=合格
+    QVector<SessionReading> readings;
+};
+
+// 查询条件：空字符串/无效日期表示不限
+struct SessionFilter {
+    QString productModel;
+    QString groupNo;
+    QDate from;
+    QDate to;
+};
+
+struct SessionSummary {
+    qint64 id = -1;
+    QDateTime savedAt;
+    QString productModel;
+    QString productName;
+    QString dialDrawingNo;
+    QString groupNo;
+    QString gaugeSerial;
+    double avgMaxAngle = 0.0;
+    double maxAbsErrMPa = 0.0;
+    int passed = -1;
+};
+
+struct YieldStat {
+    QDate day;
+    int total = 0;            // 已完成检测的表数
+    int passed = 0;
+};
+
+struct PointErrorTrend {
+    QDate day;
+    int pointIndex = 0;
+    double pressure = 0.0;
+    int count = 0;
+    double meanErrMPa = 0.0;
+    double maxAbsErrMPa = 0.0;
+};
+
+class SessionDatabase {
+public:
+    explicit SessionDatabase(const QString& connectionName = "pressure_sessions");
+    ~SessionDatabase();
+    SessionDatabase(const SessionDatabase&) = delete;
+    SessionDatabase& operator=(const SessionDatabase&) = delete;
+
+    // 文档目录下的 PressureGauge_Sessions.db
+    static QString defaultPath();
+
+    bool open(const QString& path = defaultPath());
+    void close();
+    bool isOpen() const;
+    QString lastError() const { return m_lastError; }
+
+    // 新建或更新一条检测记录（rec.id 回填），整条记录一个事务
+    bool saveSession(SessionRecord& rec);
+    // 批量保存（导入/离线批处理），全部在一个事务里
+    bool saveSessions(QVector<SessionRecord>& recs);
+    bool loadSession(qint64 id, SessionRecord& out);
+
+    QVector<SessionSummary> querySessions(const SessionFilter& filter, int limit = 1000);
+    QVector<YieldStat> yieldByDay(const SessionFilter& filter);
+    QVector<PointErrorTrend> pointErrorTrend(const SessionFilter& filter);
+
+private:
+    bool ensureSchema();
+    bool writeSession(SessionRecord& rec);   // 调用方负责事务
+    qint64 productId(const SessionRecord& rec);
+    qint64 gaugeId(qint64 productId, const SessionRecord& rec);
+    QString filterSql(const SessionFilter& filter, QVariantList& binds) const;
+    bool fail(const QString& where, const QString& error);
+
+    QString m_connectionName;
+    QString m_lastError;
+};
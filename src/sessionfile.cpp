@@ -0,0 +1,469 @@
+#include "sessionfile.h"
+
+#include <QCborMap>
+#include <QCborValue>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr char kMagic[4] = {'P', 'G', 'S', 'F'};
+// 版本 2 起带各格的有效位；版本 1 没有，读的时候按 0 = 空位补出来
+constexpr quint16 kVersion = 2;
+constexpr int kPreambleSize = 16;
+// 头部只有几十个字节，超过这个数当作文件损坏，免得按坏长度去读一大块
+constexpr quint32 kMaxHeaderSize = 64 * 1024;
+
+QByteArray packDoubles(const QVector<double>& v)
+{
+    QByteArray bytes(v.size() * qsizetype(sizeof(double)), Qt::Uninitialized);
+    qToLittleEndian<double>(v.constData(), v.size(), bytes.data());
+    return bytes;
+}
+
+bool unpackDoubles(const QCborValue& value, qsizetype count, QVector<double>& out)
+{
+    const QByteArray bytes = value.toByteArray();
+    if (bytes.size() != count * qsizetype(sizeof(double))) return false;
+    out.resize(count);
+    qFromLittleEndian<double>(bytes.constData(), count, out.data());
+    return true;
+}
+
+QByteArray packFlags(const QVector<quint8>& v)
+{
+    return QByteArray(reinterpret_cast<const char*>(v.constData()), v.size());
+}
+
+bool unpackFlags(const QCborValue& value, qsizetype count, QVector<quint8>& out)
+{
+    const QByteArray bytes = value.toByteArray();
+    if (bytes.size() != count) return false;
+    out.resize(count);
+    std::copy(bytes.cbegin(), bytes.cend(), out.begin());
+    return true;
+}
+
+// 旧文件没有有效位：原来的约定是 0 = 空位
+void flagsFromNonZero(const QVector<double>& angles, QVector<quint8>& valid)
+{
+    valid.resize(angles.size());
+    for (qsizetype i = 0; i < angles.size(); ++i) valid[i] = angles[i] != 0.0;
+}
+
+QCborMap headerToCbor(const SessionFileHeader& h)
+{
+    QCborMap m;
+    m.insert(QStringLiteral("model"), h.productModel);
+    m.insert(QStringLiteral("group"), h.groupNo);
+    m.insert(QStringLiteral("points"), h.pointCount);
+    m.insert(QStringLiteral("dataPoints"), h.dataPoints);
+    m.insert(QStringLiteral("rounds"), h.rounds);
+    m.insert(QStringLiteral("slots"), h.slots);
+    m.insert(QStringLiteral("currentRound"), h.currentRound);
+    m.insert(QStringLiteral("readings"), h.readingCount);
+    m.insert(QStringLiteral("avgMaxAngle"), h.avgMaxAngle);
+    return m;
+}
+
+void headerFromCbor(const QCborMap& m, SessionFileHeader& h)
+{
+    h.productModel = m.value(QStringLiteral("model")).toString();
+    h.groupNo = m.value(QStringLiteral("group")).toString();
+    h.pointCount = int(m.value(QStringLiteral("points")).toInteger());
+    h.dataPoints = int(m.value(QStringLiteral("dataPoints")).toInteger());
+    h.rounds = int(m.value(QStringLiteral("rounds")).toInteger());
+    h.slots = int(m.value(QStringLiteral("slots")).toInteger());
+    h.currentRound = int(m.value(QStringLiteral("currentRound")).toInteger());
+    h.readingCount = int(m.value(QStringLiteral("readings")).toInteger());
+    h.avgMaxAngle = m.value(QStringLiteral("avgMaxAngle")).toDouble();
+}
+
+// 读前 16 字节；不是二进制会话文件时 isBinary=false 且不算错误
+bool readPreamble(QFile& file, bool& isBinary, quint32& headerSize, quint32& bodySize, int& version, QString& error)
+{
+    const QByteArray pre = file.read(kPreambleSize);
+    isBinary = pre.size() == kPreambleSize && memcmp(pre.constData(), kMagic, sizeof(kMagic)) == 0;
+    if (!isBinary) return true;
+    version = qFromLittleEndian<quint16>(pre.constData() + 4);
+    headerSize = qFromLittleEndian<quint32>(pre.constData() + 8);
+    bodySize = qFromLittleEndian<quint32>(pre.constData() + 12);
+    if (version > kVersion) {
+        error = QString("会话文件版本 %1 过新").arg(version);
+        return false;
+    }
+    if (headerSize > kMaxHeaderSize || kPreambleSize + qint64(headerSize) + bodySize > file.size()) {
+        error = "会话文件不完整";
+        return false;
+    }
+    return true;
+}
+
+bool parseJsonFile(QFile& file, QJsonObject& config, QString& error)
+{
+    file.seek(0);
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        error = QString("解析 %1 失败: %2").arg(file.fileName(), parseError.errorString());
+        return false;
+    }
+    config = doc.object();
+    return true;
+}
+
+} // namespace
+
+void SessionFileData::resizeData(int points, int roundCount, int slotCount)
+{
+    dataPoints = qMax(0, points);
+    rounds = qMax(0, roundCount);
+    slots = qMax(0, slotCount);
+    const qsizetype cells = qsizetype(dataPoints) * rounds * slots;
+    pressures.fill(0.0, dataPoints);
+    forwardAngles.fill(0.0, cells);
+    backwardAngles.fill(0.0, cells);
+    forwardValid.fill(0, cells);
+    backwardValid.fill(0, cells);
+    pointRoundMax.fill(0.0, qsizetype(dataPoints) * rounds);
+    legacyForward.fill(0.0, dataPoints);
+    legacyBackward.fill(0.0, dataPoints);
+    legacyFlags.fill(0, dataPoints);
+}
+
+SessionFileHeader summarizeSession(const SessionFileData& data)
+{
+    SessionFileHeader h;
+    h.binary = true;
+    h.version = kVersion;
+    h.productModel = data.productModel;
+    h.groupNo = data.groupNo;
+    h.pointCount = data.detectionPoints.size();
+    h.dataPoints = data.dataPoints;
+    h.rounds = data.rounds;
+    h.slots = data.slots;
+    h.currentRound = data.currentRound;
+    for (quint8 v : data.forwardValid) h.readingCount += v;
+    for (quint8 v : data.backwardValid) h.readingCount += v;
+    // 与误差表格一致：只算到当前轮为止、已采集的轮次
+    double sum = 0.0;
+    int count = 0;
+    for (int r = 0; r <= data.currentRound && r < data.maxAngles.size(); ++r) {
+        if (data.maxAngles[r] == 0.0) continue;
+        sum += data.maxAngles[r];
+        ++count;
+    }
+    h.avgMaxAngle = count > 0 ? sum / count : 0.0;
+    return h;
+}
+
+bool readSessionFileHeader(const QString& path, SessionFileHeader& header, QString& error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("无法读取 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    bool isBinary = false;
+    quint32 headerSize = 0, bodySize = 0;
+    int version = 0;
+    if (!readPreamble(file, isBinary, headerSize, bodySize, version, error)) return false;
+
+    header = SessionFileHeader();
+    if (!isBinary) {
+        // 旧 JSON 文件没有头部，只能整个解析一遍；下次保存就换成二进制了
+        QJsonObject config;
+        if (!parseJsonFile(file, config, error)) return false;
+        header = summarizeSession(sessionFromJson(config));
+        header.binary = false;
+        header.version = 0;
+        return true;
+    }
+
+    QCborParserError parseError;
+    const QCborValue value = QCborValue::fromCbor(file.read(headerSize), &parseError);
+    if (parseError.error != QCborError::NoError || !value.isMap()) {
+        error = QString("会话文件头损坏: %1").arg(parseError.errorString());
+        return false;
+    }
+    headerFromCbor(value.toMap(), header);
+    header.binary = true;
+    header.version = version;
+    return true;
+}
+
+bool readSessionFile(const QString& path, SessionFileData& data, QString& error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("无法读取 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    bool isBinary = false;
+    quint32 headerSize = 0, bodySize = 0;
+    int version = 0;
+    if (!readPreamble(file, isBinary, headerSize, bodySize, version, error)) return false;
+
+    if (!isBinary) {
+        QJsonObject config;
+        if (!parseJsonFile(file, config, error)) return false;
+        data = sessionFromJson(config);
+        return true;
+    }
+
+    file.seek(kPreambleSize + qint64(headerSize));
+    QCborParserError parseError;
+    const QCborValue value = QCborValue::fromCbor(file.read(bodySize), &parseError);
+    if (parseError.error != QCborError::NoError || !value.isMap()) {
+        error = QString("会话文件损坏: %1").arg(parseError.errorString());
+        return false;
+    }
+    const QCborMap m = value.toMap();
+
+    data = SessionFileData();
+    data.productModel = m.value(QStringLiteral("productModel")).toString();
+    data.productName = m.value(QStringLiteral("productName")).toString();
+    data.dialDrawingNo = m.value(QStringLiteral("dialDrawingNo")).toString();
+    data.groupNo = m.value(QStringLiteral("groupNo")).toString();
+    data.maxPressure = m.value(QStringLiteral("maxPressure")).toDouble();
+    data.maxAngle = m.value(QStringLiteral("maxAngle")).toDouble();
+    data.currentRound = int(m.value(QStringLiteral("currentRound")).toInteger());
+    data.maxMeasurementsPerRound = int(m.value(QStringLiteral("maxMeasurementsPerRound")).toInteger());
+    data.dbSessionId = m.value(QStringLiteral("dbSessionId")).toInteger(-1);
+    const QString startedAt = m.value(QStringLiteral("sessionStartedAt")).toString();
+    if (!startedAt.isEmpty()) data.startedAt = QDateTime::fromString(startedAt, Qt::ISODateWithMs);
+
+    const qint64 points = m.value(QStringLiteral("dataPoints")).toInteger();
+    const qint64 rounds = m.value(QStringLiteral("rounds")).toInteger();
+    const qint64 slots = m.value(QStringLiteral("slots")).toInteger();
+    // 维度乘起来不能超过正文本身能装下的 double 个数，防止坏文件让 resize 申请巨量内存
+    auto inRange = [](qint64 n) { return n >= 0 && n <= 0xFFFF; };
+    if (!inRange(points) || !inRange(rounds) || !inRange(slots)
+        || points * rounds * slots > bodySize / qint64(sizeof(double))) {
+        error = "会话文件维度无效";
+        return false;
+    }
+    data.resizeData(int(points), int(rounds), int(slots));
+    const qsizetype cells = data.forwardAngles.size();
+
+    const QByteArray flags = m.value(QStringLiteral("legacyFlags")).toByteArray();
+    const QByteArray detectionPoints = m.value(QStringLiteral("detectionPoints")).toByteArray();
+    const qsizetype pointCount = detectionPoints.size() / qsizetype(sizeof(double));
+    bool ok = detectionPoints.size() % qsizetype(sizeof(double)) == 0
+              && unpackDoubles(m.value(QStringLiteral("detectionPoints")), pointCount, data.detectionPoints)
+              && unpackDoubles(m.value(QStringLiteral("pressures")), data.dataPoints, data.pressures)
+              && unpackDoubles(m.value(QStringLiteral("forwardAngles")), cells, data.forwardAngles)
+              && unpackDoubles(m.value(QStringLiteral("backwardAngles")), cells, data.backwardAngles)
+              && unpackDoubles(m.value(QStringLiteral("pointRoundMax")), data.pointRoundMax.size(), data.pointRoundMax)
+              && unpackDoubles(m.value(QStringLiteral("legacyForward")), data.dataPoints, data.legacyForward)
+              && unpackDoubles(m.value(QStringLiteral("legacyBackward")), data.dataPoints, data.legacyBackward)
+              && flags.size() == data.dataPoints;
+    const QByteArray maxAngles = m.value(QStringLiteral("maxAngles")).toByteArray();
+    ok = ok && maxAngles.size() % qsizetype(sizeof(double)) == 0
+         && unpackDoubles(m.value(QStringLiteral("maxAngles")), maxAngles.size() / qsizetype(sizeof(double)), data.maxAngles);
+    if (version >= 2) {
+        ok = ok && unpackFlags(m.value(QStringLiteral("forwardValid")), cells, data.forwardValid)
+             && unpackFlags(m.value(QStringLiteral("backwardValid")), cells, data.backwardValid);
+    } else {
+        flagsFromNonZero(data.forwardAngles, data.forwardValid);
+        flagsFromNonZero(data.backwardAngles, data.backwardValid);
+    }
+    if (!ok) {
+        error = "会话文件数据长度不符";
+        return false;
+    }
+    std::copy(flags.cbegin(), flags.cend(), data.legacyFlags.begin());
+    return true;
+}
+
+bool writeSessionFile(const QString& path, const SessionFileData& data, QString& error)
+{
+    QCborMap m;
+    m.insert(QStringLiteral("productModel"), data.productModel);
+    m.insert(QStringLiteral("productName"), data.productName);
+    m.insert(QStringLiteral("dialDrawingNo"), data.dialDrawingNo);
+    m.insert(QStringLiteral("groupNo"), data.groupNo);
+    m.insert(QStringLiteral("maxPressure"), data.maxPressure);
+    m.insert(QStringLiteral("maxAngle"), data.maxAngle);
+    m.insert(QStringLiteral("detectionPoints"), packDoubles(data.detectionPoints));
+    m.insert(QStringLiteral("dataPoints"), data.dataPoints);
+    m.insert(QStringLiteral("rounds"), data.rounds);
+    m.insert(QStringLiteral("slots"), data.slots);
+    m.insert(QStringLiteral("pressures"), packDoubles(data.pressures));
+    m.insert(QStringLiteral("forwardAngles"), packDoubles(data.forwardAngles));
+    m.insert(QStringLiteral("backwardAngles"), packDoubles(data.backwardAngles));
+    m.insert(QStringLiteral("forwardValid"), packFlags(data.forwardValid));
+    m.insert(QStringLiteral("backwardValid"), packFlags(data.backwardValid));
+    m.insert(QStringLiteral("pointRoundMax"), packDoubles(data.pointRoundMax));
+    m.insert(QStringLiteral("legacyForward"), packDoubles(data.legacyForward));
+    m.insert(QStringLiteral("legacyBackward"), packDoubles(data.legacyBackward));
+    m.insert(QStringLiteral("legacyFlags"), packFlags(data.legacyFlags));
+    m.insert(QStringLiteral("currentRound"), data.currentRound);
+    m.insert(QStringLiteral("maxMeasurementsPerRound"), data.maxMeasurementsPerRound);
+    m.insert(QStringLiteral("maxAngles"), packDoubles(data.maxAngles));
+    m.insert(QStringLiteral("dbSessionId"), data.dbSessionId);
+    if (data.startedAt.isValid()) m.insert(QStringLiteral("sessionStartedAt"), data.startedAt.toString(Qt::ISODateWithMs));
+
+    const QByteArray header = QCborValue(headerToCbor(summarizeSession(data))).toCbor();
+    const QByteArray body = QCborValue(m).toCbor();
+
+    char pre[kPreambleSize] = {};
+    memcpy(pre, kMagic, sizeof(kMagic));
+    qToLittleEndian<quint16>(kVersion, pre + 4);
+    qToLittleEndian<quint32>(quint32(header.size()), pre + 8);
+    qToLittleEndian<quint32>(quint32(body.size()), pre + 12);
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = QString("无法写入 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    file.write(pre, kPreambleSize);
+    file.write(header);
+    file.write(body);
+    if (!file.commit()) {
+        error = QString("写入 %1 失败: %2").arg(path, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool writeSessionJson(const QString& path, const SessionFileData& data, QString& error)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = QString("无法写入 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    file.write(QJsonDocument(sessionToJson(data)).toJson());
+    if (!file.commit()) {
+        error = QString("写入 %1 失败: %2").arg(path, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+QJsonObject sessionToJson(const SessionFileData& data)
+{
+    QJsonObject config;
+    config["productModel"] = data.productModel;
+    config["productName"] = data.productName;
+    config["dialDrawingNo"] = data.dialDrawingNo;
+    config["groupNo"] = data.groupNo;
+    config["maxPressure"] = data.maxPressure;
+    config["maxAngle"] = data.maxAngle;
+
+    QJsonArray points;
+    for (double pressure : data.detectionPoints) points.append(pressure);
+    config["detectionPoints"] = points;
+
+    QJsonArray detectionData;
+    for (int i = 0; i < data.dataPoints; ++i) {
+        QJsonObject pointObj;
+        pointObj["pressure"] = data.pressures[i];
+        pointObj["forwardAngle"] = data.legacyForward[i];
+        pointObj["backwardAngle"] = data.legacyBackward[i];
+        pointObj["hasForward"] = (data.legacyFlags[i] & 1) != 0;
+        pointObj["hasBackward"] = (data.legacyFlags[i] & 2) != 0;
+
+        QJsonArray roundDataArray;
+        for (int round = 0; round < data.rounds; ++round) {
+            QJsonArray forwardAngles, backwardAngles, forwardValid, backwardValid;
+            for (int k = 0; k < data.slots; ++k) {
+                const qsizetype cell = data.slotIndex(i, round, k);
+                forwardAngles.append(data.forwardAngles[cell]);
+                backwardAngles.append(data.backwardAngles[cell]);
+                forwardValid.append(data.forwardValid[cell] != 0);
+                backwardValid.append(data.backwardValid[cell] != 0);
+            }
+            QJsonObject roundObj;
+            roundObj["forwardAngles"] = forwardAngles;
+            roundObj["backwardAngles"] = backwardAngles;
+            roundObj["forwardValid"] = forwardValid;
+            roundObj["backwardValid"] = backwardValid;
+            roundObj["maxAngle"] = data.pointRoundMax[qsizetype(i) * data.rounds + round];
+            roundDataArray.append(roundObj);
+        }
+        pointObj["roundData"] = roundDataArray;
+        detectionData.append(pointObj);
+    }
+    config["detectionData"] = detectionData;
+
+    config["currentRound"] = data.currentRound;
+    config["maxMeasurementsPerRound"] = data.maxMeasurementsPerRound;
+    QJsonArray maxAnglesArray;
+    for (double maxAngle : data.maxAngles) maxAnglesArray.append(maxAngle);
+    config["maxAngles"] = maxAnglesArray;
+
+    // 记录号用字符串存，JSON 的 double 装不下完整的 64 位整数
+    config["dbSessionId"] = QString::number(data.dbSessionId);
+    if (data.startedAt.isValid()) config["sessionStartedAt"] = data.startedAt.toString(Qt::ISODateWithMs);
+    return config;
+}
+
+SessionFileData sessionFromJson(const QJsonObject& config)
+{
+    SessionFileData data;
+    data.productModel = config["productModel"].toString();
+    data.productName = config["productName"].toString();
+    data.dialDrawingNo = config["dialDrawingNo"].toString();
+    data.groupNo = config["groupNo"].toString();
+    data.maxPressure = config["maxPressure"].toDouble();
+    data.maxAngle = config["maxAngle"].toDouble();
+    for (const QJsonValue& v : config["detectionPoints"].toArray()) data.detectionPoints.append(v.toDouble());
+
+    // JSON 里各轮、各行程的数组长度可以不一样，按最长的分配，缺的位置是空位
+    const QJsonArray detectionData = config["detectionData"].toArray();
+    int rounds = 0, slots = 0;
+    for (const QJsonValue& v : detectionData) {
+        const QJsonArray roundData = v.toObject()["roundData"].toArray();
+        rounds = qMax(rounds, int(roundData.size()));
+        for (const QJsonValue& r : roundData) {
+            const QJsonObject roundObj = r.toObject();
+            slots = qMax(slots, int(roundObj["forwardAngles"].toArray().size()));
+            slots = qMax(slots, int(roundObj["backwardAngles"].toArray().size()));
+        }
+    }
+    data.resizeData(detectionData.size(), rounds, slots);
+    for (int i = 0; i < detectionData.size(); ++i) {
+        const QJsonObject pointObj = detectionData[i].toObject();
+        data.pressures[i] = pointObj["pressure"].toDouble();
+        data.legacyForward[i] = pointObj["forwardAngle"].toDouble();
+        data.legacyBackward[i] = pointObj["backwardAngle"].toDouble();
+        data.legacyFlags[i] = quint8((pointObj["hasForward"].toBool() ? 1 : 0) | (pointObj["hasBackward"].toBool() ? 2 : 0));
+        const QJsonArray roundData = pointObj["roundData"].toArray();
+        for (int round = 0; round < roundData.size(); ++round) {
+            const QJsonObject roundObj = roundData[round].toObject();
+            const QJsonArray forwardAngles = roundObj["forwardAngles"].toArray();
+            const QJsonArray backwardAngles = roundObj["backwardAngles"].toArray();
+            // 没有 forwardValid/backwardValid 的旧文件按 0 = 空位
+            const QJsonArray forwardValid = roundObj["forwardValid"].toArray();
+            const QJsonArray backwardValid = roundObj["backwardValid"].toArray();
+            const bool hasValid = roundObj.contains("forwardValid") || roundObj.contains("backwardValid");
+            for (int k = 0; k < forwardAngles.size(); ++k) {
+                const qsizetype cell = data.slotIndex(i, round, k);
+                data.forwardAngles[cell] = forwardAngles[k].toDouble();
+                data.forwardValid[cell] = hasValid ? forwardValid[k].toBool() : data.forwardAngles[cell] != 0.0;
+            }
+            for (int k = 0; k < backwardAngles.size(); ++k) {
+                const qsizetype cell = data.slotIndex(i, round, k);
+                data.backwardAngles[cell] = backwardAngles[k].toDouble();
+                data.backwardValid[cell] = hasValid ? backwardValid[k].toBool() : data.backwardAngles[cell] != 0.0;
+            }
+            data.pointRoundMax[qsizetype(i) * rounds + round] = roundObj["maxAngle"].toDouble();
+        }
+    }
+
+    data.currentRound = config["currentRound"].toInt();
+    data.maxMeasurementsPerRound = config["maxMeasurementsPerRound"].toInt();
+    for (const QJsonValue& v : config["maxAngles"].toArray()) data.maxAngles.append(v.toDouble());
+    data.dbSessionId = config["dbSessionId"].toString("-1").toLongLong();
+    const QString startedAt = config["sessionStartedAt"].toString();
+    if (!startedAt.isEmpty()) data.startedAt = QDateTime::fromString(startedAt, Qt::ISODateWithMs);
+    return data;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <QDateTime>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+// ================== 会话文件（自动保存 / 恢复） ==================
+// 二进制格式（.pgs），全部小端：
+//   0   4  魔数 "PGSF"
+//   4   2  版本号
+//   6   2  保留（0）
+//   8   4  头部 CBOR 长度
+//   12  4  正文 CBOR 长度
+//   16  …  头部 CBOR：型号、支组、各项计数和摘要（几十个字节）
+//   …   …  正文 CBOR：配置 + 检测数据，角度数组是紧排的 double 字节串，读写就是一次拷贝
+// 判断"有没有数据、是不是同一型号"只读前 16 字节和头部，不用解析正文。
+// JSON（原来的 PressureGauge_AutoSave.json 格式）继续支持：读取时按内容自动识别，导出交换用 writeSessionJson。
+
+struct SessionFileHeader {
+    bool binary = false;           // false = 旧 JSON 文件
+    int version = 0;
+    QString productModel;
+    QString groupNo;
+    int pointCount = 0;            // 配置的检测点数
+    int dataPoints = 0;            // 有检测数据的点数
+    int rounds = 0;
+    int slots = 0;                 // 每轮每个行程的次数
+    int currentRound = 0;
+    int readingCount = 0;          // 非零读数个数
+    double avgMaxAngle = 0.0;      // 到当前轮为止的平均最大角度
+
+    bool hasData() const { return pointCount > 0 || dataPoints > 0; }
+};
+
+struct SessionFileData {
+    QString productModel;
+    QString productName;
+    QString dialDrawingNo;
+    QString groupNo;
+    double maxPressure = 0.0;
+    double maxAngle = 0.0;
+    QVector<double> detectionPoints;
+
+    // 检测数据：dataPoints 个点 × rounds 轮 × slots 次，按 [点][轮][次] 紧排；
+    // 有没有读数看 forwardValid/backwardValid（0° 也是读数）。旧文件没有这两项，按原来的约定 0 = 空位
+    int dataPoints = 0;
+    int rounds = 0;
+    int slots = 0;
+    QVector<double> pressures;           // [点]
+    QVector<double> forwardAngles;       // [点][轮][次]
+    QVector<double> backwardAngles;      // [点][轮][次]
+    QVector<quint8> forwardValid;        // [点][轮][次]，1 = 有读数
+    QVector<quint8> backwardValid;       // [点][轮][次]
+    QVector<double> pointRoundMax;       // [点][轮]，各点各轮记的最大角度
+    QVector<double> legacyForward;       // [点]，向后兼容的单次角度
+    QVector<double> legacyBackward;      // [点]
+    QVector<quint8> legacyFlags;         // [点]，bit0 = hasForward，bit1 = hasBackward
+
+    int currentRound = 0;
+    int maxMeasurementsPerRound = 0;
+    QVector<double> maxAngles;           // 各轮最大角度
+    qint64 dbSessionId = -1;
+    QDateTime startedAt;
+
+    // 按维度分配好检测数据（全部置 0，全部空位）
+    void resizeData(int points, int roundCount, int slotCount);
+    qsizetype slotIndex(int point, int round, int slot) const { return (qsizetype(point) * rounds + round) * slots + slot; }
+};
+
+SessionFileHeader summarizeSession(const SessionFileData& data);
+
+// 只读头部；二进制文件只读开头几十个字节，旧 JSON 文件只能整个解析
+bool readSessionFileHeader(const QString& path, SessionFileHeader& header, QString& error);
+// 读整个文件，二进制和 JSON 按内容自动识别
+bool readSessionFile(const QString& path, SessionFileData& data, QString& error);
+// 写二进制文件（先写临时文件再替换，中途断电不会留下半个文件）
+bool writeSessionFile(const QString& path, const SessionFileData& data, QString& error);
+// 写 JSON（与原 PressureGauge_AutoSave.json 字段一致），用于导出交换
+bool writeSessionJson(const QString& path, const SessionFileData& data, QString& error);
+
+QJsonObject sessionToJson(const SessionFileData& data);
+SessionFileData sessionFromJson(const QJsonObject& config);
@@ -0,0 +1,185 @@
+#include "sessionhistorydialog.h"
+
+#include <QComboBox>
+#include <QDateEdit>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QTabWidget>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include "xlsxexportjob.h"
+
+namespace {
+
+QTableWidget* makeTable(const QStringList& headers)
+{
+    auto* table = new QTableWidget(0, headers.size());
+    table->setHorizontalHeaderLabels(headers);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->verticalHeader()->setVisible(false);
+    return table;
+}
+
+void setRowTexts(QTableWidget* table, int row, const QStringList& texts)
+{
+    for (int c = 0; c < texts.size(); ++c) table->setItem(row, c, new QTableWidgetItem(texts[c]));
+}
+
+QString passedText(int passed)
+{
+    return passed < 0 ? QString("未完成") : (passed ? QString("合格") : QString("不合格"));
+}
+
+} // namespace
+
+SessionHistoryDialog::SessionHistoryDialog(SessionDatabase* db, QWidget* parent)
+    : QDialog(parent), m_db(db)
+{
+    setWindowTitle("检测记录查询");
+    resize(900, 600);
+    buildUi();
+}
+
+void SessionHistoryDialog::buildUi()
+{
+    auto* layout = new QVBoxLayout(this);
+
+    auto* filterRow = new QHBoxLayout();
+    m_modelEdit = new QLineEdit();
+    m_modelEdit->setPlaceholderText("全部");
+    m_groupEdit = new QLineEdit();
+    m_groupEdit->setPlaceholderText("全部");
+    m_fromEdit = new QDateEdit(QDate::currentDate().addDays(-30));
+    m_toEdit = new QDateEdit(QDate::currentDate());
+    m_fromEdit->setCalendarPopup(true);
+    m_toEdit->setCalendarPopup(true);
+    m_fromEdit->setDisplayFormat("yyyy-MM-dd");
+    m_toEdit->setDisplayFormat("yyyy-MM-dd");
+    auto* queryBtn = new QPushButton("查询");
+
+    filterRow->addWidget(new QLabel("产品型号:"));
+    filterRow->addWidget(m_modelEdit);
+    filterRow->addWidget(new QLabel("支组编号:"));
+    filterRow->addWidget(m_groupEdit);
+    filterRow->addWidget(new QLabel("日期:"));
+    filterRow->addWidget(m_fromEdit);
+    filterRow->addWidget(new QLabel("至"));
+    filterRow->addWidget(m_toEdit);
+    filterRow->addWidget(queryBtn);
+    layout->addLayout(filterRow);
+
+    auto* tabs = new QTabWidget();
+    m_sessionTable = makeTable({"编号", "保存时间", "产品型号", "产品名称", "图号", "支组编号", "表号",
+                                "平均最大角度(°)", "最大误差(MPa)", "结论"});
+    m_yieldTable = makeTable({"日期", "检测数", "合格数", "合格率"});
+    m_trendTable = makeTable({"日期", "检测点", "压力(MPa)", "读数数", "平均误差(MPa)", "最大|误差|(MPa)"});
+    tabs->addTab(m_sessionTable, "检测记录");
+    tabs->addTab(m_yieldTable, "每日合格率");
+    tabs->addTab(m_trendTable, "检测点误差趋势");
+    layout->addWidget(tabs, 1);
+
+    m_infoLabel = new QLabel();
+    m_layoutCombo = new QComboBox();
+    m_layoutCombo->addItem("每块表一张工作表", XlsxExportJob::SheetPerGauge);
+    m_layoutCombo->addItem("每个支组一张工作表", XlsxExportJob::SheetPerBatch);
+    auto* exportBtn = new QPushButton("导出Excel");
+    auto* closeBtn = new QPushButton("关闭");
+    auto* bottom = new QHBoxLayout();
+    bottom->addWidget(m_infoLabel, 1);
+    bottom->addWidget(m_layoutCombo);
+    bottom->addWidget(exportBtn);
+    bottom->addWidget(closeBtn);
+    layout->addLayout(bottom);
+
+    connect(queryBtn, &QPushButton::clicked, this, &SessionHistoryDialog::refresh);
+    connect(m_modelEdit, &QLineEdit::returnPressed, this, &SessionHistoryDialog::refresh);
+    connect(m_groupEdit, &QLineEdit::returnPressed, this, &SessionHistoryDialog::refresh);
+    connect(exportBtn, &QPushButton::clicked, this, &SessionHistoryDialog::exportExcel);
+    connect(closeBtn, &QPushButton::clicked, this, &QDialog::accept);
+}
+
+void SessionHistoryDialog::setFilter(const QString& productModel, const QString& groupNo)
+{
+    m_modelEdit->setText(productModel);
+    m_groupEdit->setText(groupNo);
+    refresh();
+}
+
+SessionFilter SessionHistoryDialog::currentFilter() const
+{
+    SessionFilter f;
+    f.productModel = m_modelEdit->text().trimmed();
+    f.groupNo = m_groupEdit->text().trimmed();
+    f.from = m_fromEdit->date();
+    f.to = m_toEdit->date();
+    return f;
+}
+
+void SessionHistoryDialog::refresh()
+{
+    if (!m_db || (!m_db->isOpen() && !m_db->open())) {
+        m_infoLabel->setText("数据库打开失败: " + (m_db ? m_db->lastError() : QString()));
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const SessionFilter f = currentFilter();
+    const QVector<SessionSummary> sessions = m_db->querySessions(f);
+    const QVector<YieldStat> yields = m_db->yieldByDay(f);
+    const QVector<PointErrorTrend> trends = m_db->pointErrorTrend(f);
+    const qint64 queryMs = timer.elapsed();
+
+    m_sessionTable->setRowCount(sessions.size());
+    for (int r = 0; r < sessions.size(); ++r) {
+        const SessionSummary& s = sessions[r];
+        setRowTexts(m_sessionTable, r, {QString::number(s.id), s.savedAt.toString("yyyy-MM-dd HH:mm:ss"),
+                                        s.productModel, s.productName, s.dialDrawingNo, s.groupNo, s.gaugeSerial,
+                                        QString::number(s.avgMaxAngle, 'f', 2),
+                                        s.passed < 0 ? QString("--") : QString::number(s.maxAbsErrMPa, 'f', 3),
+                                        passedText(s.passed)});
+    }
+
+    int total = 0, passed = 0;
+    m_yieldTable->setRowCount(yields.size());
+    for (int r = 0; r < yields.size(); ++r) {
+        const YieldStat& y = yields[r];
+        total += y.total;
+        passed += y.passed;
+        setRowTexts(m_yieldTable, r, {y.day.toString("yyyy-MM-dd"), QString::number(y.total), QString::number(y.passed),
+                                      QString("%1%").arg(y.total ? 100.0 * y.passed / y.total : 0.0, 0, 'f', 1)});
+    }
+
+    m_trendTable->setRowCount(trends.size());
+    for (int r = 0; r < trends.size(); ++r) {
+        const PointErrorTrend& t = trends[r];
+        setRowTexts(m_trendTable, r, {t.day.toString("yyyy-MM-dd"), QString::number(t.pointIndex + 1),
+                                      QString::number(t.pressure, 'f', 1), QString::number(t.count),
+                                      QString::number(t.meanErrMPa, 'f', 4), QString::number(t.maxAbsErrMPa, 'f', 4)});
+    }
+
+    m_infoLabel->setText(QString("共 %1 条记录，已完成 %2 块，合格 %3 块（%4%），查询耗时 %5 ms")
+                             .arg(sessions.size()).arg(total).arg(passed)
+                             .arg(total ? 100.0 * passed / total : 0.0, 0, 'f', 1)
+                             .arg(queryMs));
+}
+
+// 按当前筛选条件导出整批检测记录；读库、排版、写文件都在后台线程里，几千块表也不卡界面
+void SessionHistoryDialog::exportExcel()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "导出Excel文件", "", "Excel工作簿 (*.xlsx)");
+    if (fileName.isEmpty()) return;
+    if (!fileName.endsWith(".xlsx", Qt::CaseInsensitive)) fileName += ".xlsx";
+
+    const auto layout = XlsxExportJob::Layout(m_layoutCombo->currentData().toInt());
+    (new XlsxExportJob(fileName, SessionDatabase::defaultPath(), currentFilter(), layout))->start(this);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <QDialog>
+
+#include "sessiondatabase.h"
+
+class QComboBox;
+class QDateEdit;
+class QLabel;
+class QLineEdit;
+class QTableWidget;
+
+// 检测记录查询：按型号/支组编号/日期筛选，列出检测记录、每天合格率和各检测点误差趋势
+// 筛选结果可以整批导出成 Excel 工作簿（后台线程写，按表或按支组分工作表）
+class SessionHistoryDialog : public QDialog {
+    Q_OBJECT
+public:
+    SessionHistoryDialog(SessionDatabase* db, QWidget* parent = nullptr);
+    ~SessionHistoryDialog() override = default;
+
+    void setFilter(const QString& productModel, const QString& groupNo);
+
+private slots:
+    void refresh();
+    void exportExcel();
+
+private:
+    void buildUi();
+    SessionFilter currentFilter() const;
+
+    SessionDatabase* m_db = nullptr;
+    QLineEdit* m_modelEdit = nullptr;
+    QLineEdit* m_groupEdit = nullptr;
+    QDateEdit* m_fromEdit = nullptr;
+    QDateEdit* m_toEdit = nullptr;
+    QTableWidget* m_sessionTable = nullptr;
+    QTableWidget* m_yieldTable = nullptr;
+    QTableWidget* m_trendTable = nullptr;
+    QLabel* m_infoLabel = nullptr;
+    QComboBox* m_layoutCombo = nullptr;
+};
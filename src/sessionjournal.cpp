@@ -0,0 +1,374 @@
+#include "sessionjournal.h"
+
+#include <QDebug>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kMagic[8] = {'P', 'G', 'J', 'O', 'U', 'R', 'N', '1'};
+const quint32 kVersion = 1;
+const int kHeaderSize = 24;          // magic(8) + version(4) + reserved(4) + generation(8)
+const int kSyncDelayMs = 100;        // 组提交窗口：100ms 内的记录合并一次 fsync
+const int kMaxPayload = 300;
+
+quint32 crc32(const char* data, int size)
+{
+    static quint32 table[256];
+    static bool init = false;
+    if (!init) {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        init = true;
+    }
+    quint32 crc = 0xFFFFFFFFu;
+    for (int i = 0; i < size; ++i) crc = table[(crc ^ quint8(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void putDouble(QByteArray& out, double v)
+{
+    quint64 bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    char buf[8];
+    qToLittleEndian(bits, buf);
+    out.append(buf, 8);
+}
+
+double getDouble(const char* p)
+{
+    const quint64 bits = qFromLittleEndian<quint64>(p);
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+void putInt64(QByteArray& out, qint64 v)
+{
+    char buf[8];
+    qToLittleEndian(v, buf);
+    out.append(buf, 8);
+}
+
+// 参考压力 + 时间戳，共 16 字节
+constexpr int kReferenceSize = 16;
+
+void putReference(QByteArray& out, const JournalEntry& e)
+{
+    if (!e.hasReference) return;
+    putDouble(out, e.refPressure);
+    putInt64(out, e.refTimestampUs);
+}
+
+void getReference(const char* p, int size, int offset, JournalEntry& e)
+{
+    if (size < offset + kReferenceSize) return;
+    e.hasReference = true;
+    e.refPressure = getDouble(p + offset);
+    e.refTimestampUs = qFromLittleEndian<qint64>(p + offset + 8);
+}
+
+} // namespace
+
+SessionJournal::SessionJournal(QObject* parent)
+    : QObject(parent)
+{
+    m_syncTimer.setSingleShot(true);
+    m_syncTimer.setInterval(kSyncDelayMs);
+    connect(&m_syncTimer, &QTimer::timeout, this, &SessionJournal::sync);
+}
+
+SessionJournal::~SessionJournal()
+{
+    close();
+}
+
+bool SessionJournal::open(const QString& path)
+{
+    close();
+    m_file.setFileName(path);
+    m_snapshotPath = path + ".snapshot";
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        m_lastError = QString("打开会话日志失败: %1").arg(m_file.errorString());
+        qDebug() << m_lastError;
+        return false;
+    }
+    m_file.seek(m_file.size());
+    m_hasHeader = false;   // replay 核对过文件头（或重写过）之后才接受追加
+    return true;
+}
+
+void SessionJournal::close()
+{
+    if (!m_file.isOpen()) return;
+    sync();
+    m_file.close();
+}
+
+bool SessionJournal::fsyncFile()
+{
+    if (!m_file.flush()) return false;
+#ifdef Q_OS_WIN
+    return _commit(m_file.handle()) == 0;
+#else
+    return ::fsync(m_file.handle()) == 0;
+#endif
+}
+
+void SessionJournal::sync()
+{
+    m_syncTimer.stop();
+    if (!m_dirty || !m_file.isOpen()) return;
+    if (!fsyncFile()) {
+        m_lastError = "会话日志落盘失败: " + m_file.errorString();
+        qDebug() << m_lastError;
+    }
+    m_dirty = false;
+}
+
+QByteArray SessionJournal::header(quint64 generation)
+{
+    QByteArray h(kHeaderSize, '\0');
+    std::memcpy(h.data(), kMagic, 8);
+    qToLittleEndian(kVersion, h.data() + 8);
+    qToLittleEndian(generation, h.data() + 16);
+    return h;
+}
+
+bool SessionJournal::readHeader(const QByteArray& data, quint64& generation)
+{
+    if (data.size() < kHeaderSize || std::memcmp(data.constData(), kMagic, 8) != 0) return false;
+    if (qFromLittleEndian<quint32>(data.constData() + 8) != kVersion) return false;
+    generation = qFromLittleEndian<quint64>(data.constData() + 16);
+    return true;
+}
+
+// 记录 = 负载长度(u16) + 负载 + CRC32(负载)；负载第一个字节是操作类型
+QByteArray SessionJournal::encode(const JournalEntry& e)
+{
+    QByteArray p;
+    p.append(char(e.op));
+    switch (e.op) {
+    case JournalOp::Begin: {
+        const QByteArray name = e.dialType.toUtf8().left(64);
+        p.append(char(e.totalRounds));
+        p.append(char(e.perRound));
+        p.append(char(e.slotCount));
+        p.append(char(name.size()));
+        p.append(name);
+        break;
+    }
+    case JournalOp::Reading:
+    case JournalOp::Edit:
+        p.append(char(e.slot));
+        p.append(char(e.round));
+        p.append(char(e.stroke));
+        p.append(char(e.index));
+        putDouble(p, e.value);
+        putReference(p, e);
+        break;
+    case JournalOp::MaxAngle:
+        p.append(char(e.slot));
+        p.append(char(e.round));
+        putDouble(p, e.value);
+        putReference(p, e);
+        break;
+    case JournalOp::RoundReset:
+        p.append(char(e.slot));
+        p.append(char(e.round));
+        break;
+    case JournalOp::RoundChange:
+        p.append(char(e.round));
+        p.append(char(e.completed));
+        break;
+    case JournalOp::ActiveSlot:
+        p.append(char(e.slot));
+        break;
+    }
+
+    QByteArray rec(2, '\0');
+    qToLittleEndian(quint16(p.size()), rec.data());
+    rec.append(p);
+    char crc[4];
+    qToLittleEndian(crc32(p.constData(), p.size()), crc);
+    rec.append(crc, 4);
+    return rec;
+}
+
+bool SessionJournal::decode(const char* p, int size, JournalEntry& e)
+{
+    if (size < 1) return false;
+    e = JournalEntry();
+    e.op = JournalOp(quint8(p[0]));
+    switch (e.op) {
+    case JournalOp::Begin: {
+        if (size < 5 || size < 5 + quint8(p[4])) return false;
+        e.totalRounds = quint8(p[1]);
+        e.perRound = quint8(p[2]);
+        e.slotCount = quint8(p[3]);
+        e.dialType = QString::fromUtf8(p + 5, quint8(p[4]));
+        return true;
+    }
+    case JournalOp::Reading:
+    case JournalOp::Edit:
+        if (size < 13) return false;
+        e.slot = quint8(p[1]);
+        e.round = quint8(p[2]);
+        e.stroke = qint8(p[3]);
+        e.index = quint8(p[4]);
+        e.value = getDouble(p + 5);
+        getReference(p, size, 13, e);
+        return true;
+    case JournalOp::MaxAngle:
+        if (size < 11) return false;
+        e.slot = quint8(p[1]);
+        e.round = quint8(p[2]);
+        e.value = getDouble(p + 3);
+        getReference(p, size, 11, e);
+        return true;
+    case JournalOp::RoundReset:
+        if (size < 3) return false;
+        e.slot = quint8(p[1]);
+        e.round = quint8(p[2]);
+        return true;
+    case JournalOp::RoundChange:
+        if (size < 3) return false;
+        e.round = quint8(p[1]);
+        e.completed = qint8(p[2]);
+        return true;
+    case JournalOp::ActiveSlot:
+        if (size < 2) return false;
+        e.slot = quint8(p[1]);
+        return true;
+    }
+    return false;   // 未知类型：当作损坏处理
+}
+
+qint64 SessionJournal::parseRecords(const QByteArray& data, qint64 offset,
+                                    const std::function<void(const JournalEntry&)>& apply, int& count)
+{
+    const char* base = data.constData();
+    while (offset + 2 <= data.size()) {
+        const int len = qFromLittleEndian<quint16>(base + offset);
+        if (len < 1 || len > kMaxPayload || offset + 2 + len + 4 > data.size()) break;
+        const char* payload = base + offset + 2;
+        if (qFromLittleEndian<quint32>(payload + len) != crc32(payload, len)) break;
+        JournalEntry e;
+        if (!decode(payload, len, e)) break;
+        apply(e);
+        ++count;
+        offset += 2 + len + 4;
+    }
+    return offset;
+}
+
+int SessionJournal::replay(const std::function<void(const JournalEntry&)>& apply)
+{
+    if (!m_file.isOpen()) return 0;
+    int count = 0;
+
+    // 快照（QSaveFile 原子替换，正常情况下总是完整的）
+    quint64 snapshotGen = 0;
+    QFile snap(m_snapshotPath);
+    if (snap.open(QIODevice::ReadOnly)) {
+        const QByteArray data = snap.readAll();
+        if (readHeader(data, snapshotGen)) {
+            parseRecords(data, kHeaderSize, apply, count);
+        } else {
+            qDebug() << "会话快照文件头无效，忽略:" << m_snapshotPath;
+        }
+    }
+    m_generation = snapshotGen;
+
+    // 日志：代号与快照一致才回放，坏尾巴截掉
+    m_file.seek(0);
+    const QByteArray data = m_file.readAll();
+    quint64 journalGen = 0;
+    if (!readHeader(data, journalGen) || journalGen != snapshotGen) {
+        if (!data.isEmpty()) qDebug() << "会话日志与快照代号不一致（压缩中断），以快照为准";
+        if (!resetJournal(snapshotGen)) qDebug() << m_lastError;
+        return count;
+    }
+
+    int journalCount = 0;
+    const qint64 valid = parseRecords(data, kHeaderSize, apply, journalCount);
+    if (valid < data.size()) {
+        qDebug() << "会话日志尾部" << (data.size() - valid) << "字节不完整，已截断";
+        m_file.resize(valid);
+        fsyncFile();
+    }
+    m_file.seek(valid);
+    m_hasHeader = true;
+    m_recordsSinceCompact = journalCount;
+    qDebug() << "会话日志回放完成：快照+日志共" << (count + journalCount) << "条记录";
+    return count + journalCount;
+}
+
+void SessionJournal::append(const JournalEntry& entry)
+{
+    if (!m_file.isOpen()) return;
+    if (!m_hasHeader) {
+        // 文件头没写成功：记录写进去也恢复不了，不如不写，等下一次压缩重写文件头
+        m_lastError = "会话日志没有有效的文件头，记录未写入";
+        qDebug() << m_lastError;
+        return;
+    }
+    const QByteArray rec = encode(entry);
+    if (m_file.write(rec) != rec.size()) {
+        m_lastError = "写入会话日志失败: " + m_file.errorString();
+        qDebug() << m_lastError;
+        return;
+    }
+    ++m_recordsSinceCompact;
+    m_dirty = true;
+    if (!m_syncTimer.isActive()) m_syncTimer.start();
+}
+
+bool SessionJournal::resetJournal(quint64 generation)
+{
+    m_syncTimer.stop();
+    m_hasHeader = false;
+    if (!m_file.resize(0) || !m_file.seek(0)) {
+        m_lastError = "清空会话日志失败: " + m_file.errorString();
+        return false;
+    }
+    const QByteArray h = header(generation);
+    if (m_file.write(h) != h.size() || !fsyncFile()) {
+        m_lastError = "写入会话日志文件头失败: " + m_file.errorString();
+        qDebug() << m_lastError;
+        return false;
+    }
+    m_hasHeader = true;
+    m_generation = generation;
+    m_recordsSinceCompact = 0;
+    m_dirty = false;
+    return true;
+}
+
+bool SessionJournal::compact(const QVector<JournalEntry>& snapshot)
+{
+    if (!m_file.isOpen()) return false;
+
+    const quint64 next = m_generation + 1;
+    QByteArray data = header(next);
+    for (const JournalEntry& e : snapshot) data += encode(e);
+
+    QSaveFile out(m_snapshotPath);
+    if (!out.open(QIODevice::WriteOnly) || out.write(data) != data.size() || !out.commit()) {
+        m_lastError = "写入会话快照失败: " + out.errorString();
+        qDebug() << m_lastError;
+        return false;
+    }
+    // 快照已经落地，日志里的内容都包含在内了
+    return resetJournal(next);
+}
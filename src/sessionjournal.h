@@ -0,0 +1,92 @@
+#pragma once
+#include <QByteArray>
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include <cstdint>
+#include <functional>
+
+// ================== 采集会话日志（只追加、掉电安全） ==================
+// 每确认一个读数、采一次最大角度、改一个角度、换一轮，就往日志尾部追加一条十几字节的记录，
+// 不再整份重写 JSON。记录带 CRC32，写入后约 100ms 内合并一次 fsync（组提交），
+// 掉电最多丢最后这一批；读到半条/校验不过的尾巴就截断，前面的记录照常恢复。
+//
+// 快照 = 同样格式的记录序列（当前状态的最小表示），用 QSaveFile 原子替换。
+// 快照与日志文件头各带一个代号：压缩时先写代号+1 的快照，再把日志清空成代号+1；
+// 中途掉电时日志代号落后于快照，恢复时整份忽略（内容已经在快照里）。
+
+enum class JournalOp : std::uint8_t {
+    Begin = 1,        // 新会话：表盘类型、轮数、每轮次数、表位数
+    Reading = 2,      // 确认的读数（写入某轮某行程第 index 个采集位）；逐点步进时带参考压力
+    Edit = 3,         // 手动修改采集位的角度
+    MaxAngle = 4,     // 某轮最大角度
+    RoundReset = 5,   // 某轮清空（归位）
+    RoundChange = 6,  // 轮次切换：completed 轮标记完成，当前轮改为 round
+    ActiveSlot = 7    // 切换当前表位（slot）
+};
+
+struct JournalEntry {
+    JournalOp op = JournalOp::Reading;
+    std::uint8_t slot = 0;       // 表位（ActiveSlot：切换到的表位）
+    std::uint8_t round = 0;
+    std::int8_t stroke = 1;      // 1=正行程 -1=反行程
+    std::uint8_t index = 0;      // 采集位
+    std::int8_t completed = -1;  // RoundChange：完成的轮次，-1=无
+    double value = 0.0;          // 角度
+    // Reading/Edit/MaxAngle：逐点步进时与读数配对的参考压力，接在记录末尾（旧程序读到会忽略）
+    bool hasReference = false;
+    double refPressure = 0.0;            // MPa
+    std::int64_t refTimestampUs = 0;     // 压力到点的时间戳
+    // Begin
+    QString dialType;
+    std::uint8_t totalRounds = 0;
+    std::uint8_t perRound = 0;
+    std::uint8_t slotCount = 1;
+};
+
+class SessionJournal : public QObject {
+    Q_OBJECT
+public:
+    explicit SessionJournal(QObject* parent = nullptr);
+    ~SessionJournal() override;
+
+    // 打开日志（快照文件名为 path + ".snapshot"）；不存在则新建
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString lastError() const { return m_lastError; }
+
+    // 依次回放快照和日志里的有效记录，返回条数；日志尾部的坏记录会被截掉
+    int replay(const std::function<void(const JournalEntry&)>& apply);
+
+    // 追加一条记录（写进文件缓冲，稍后批量 fsync）；open 之后要先 replay，文件头写失败时记录会被拒绝
+    void append(const JournalEntry& entry);
+    // 立即落盘
+    void sync();
+
+    // 用当前状态重写快照并清空日志
+    bool compact(const QVector<JournalEntry>& snapshot);
+    int pendingRecords() const { return m_recordsSinceCompact; }
+
+private:
+    static QByteArray encode(const JournalEntry& entry);
+    static bool decode(const char* data, int size, JournalEntry& out);
+    static QByteArray header(quint64 generation);
+    static bool readHeader(const QByteArray& data, quint64& generation);
+    // 解析记录区，返回有效部分的字节数
+    static qint64 parseRecords(const QByteArray& data, qint64 offset,
+                               const std::function<void(const JournalEntry&)>& apply, int& count);
+    bool resetJournal(quint64 generation);   // 文件头写入/落盘失败返回 false（lastError 说明原因）
+    bool fsyncFile();
+
+    QFile m_file;
+    QString m_snapshotPath;
+    QTimer m_syncTimer;
+    quint64 m_generation = 0;
+    int m_recordsSinceCompact = 0;
+    bool m_dirty = false;
+    bool m_hasHeader = false;    // 日志文件头有效，可以追加
+    QString m_lastError;
+};
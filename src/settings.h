@@ -47,6 +47,11 @@ public:
     int type;
     
     int totalRounds = 2;  // 默认2轮
+
+    // 自动采集：指针稳定后自动"采集+确定"
+    double autoCaptureMaxStdDeg = 0.15;  // 窗口圆标准差阈值（度）
+    int autoCaptureStableFrames = 8;     // 连续稳定帧数
+    int autoCaptureDwellMs = 1500;       // 稳定后的等待倒计时
 };
 
 #endif // SETTINGS_H
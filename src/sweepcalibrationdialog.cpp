@@ -0,0 +1,432 @@
+#include "sweepcalibrationdialog.h"
+#include "linepressuresource.h"
+#include "analysis/pressurecontroller.h"
+
+#include <QComboBox>
+#include <QDateTime>
+#include <QDebug>
+#include <QDoubleSpinBox>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <cmath>
+#include <limits>
+
+SweepCalibrationDialog::SweepCalibrationDialog(const QString& dialType, const QVector<double>& detectionPoints,
+                                               double fullScalePressure, QWidget* parent)
+    : QDialog(parent), m_dialType(dialType), m_detectionPoints(detectionPoints)
+{
+    setWindowTitle(QString("扫描标定 - %1").arg(dialType));
+    resize(820, 560);
+    buildUi();
+    m_fullScaleSpin->setValue(fullScalePressure);
+    m_rampSpin->setValue(fullScalePressure / 30.0);  // 默认约30秒升到满量程
+    m_toleranceSpin->setValue(0.0025 * fullScalePressure);  // 到点容差默认满量程的 0.25%
+}
+
+SweepCalibrationDialog::~SweepCalibrationDialog()
+{
+    if (m_source) m_source->stop();
+}
+
+void SweepCalibrationDialog::buildUi()
+{
+    auto* layout = new QVBoxLayout(this);
+
+    auto* cfgGroup = new QGroupBox("扫描设置", this);
+    auto* grid = new QGridLayout(cfgGroup);
+    grid->addWidget(new QLabel("压力源:"), 0, 0);
+    m_sourceCombo = new QComboBox(cfgGroup);
+    m_sourceCombo->addItem("扫描模拟器");
+    m_sourceCombo->addItem("控制器模拟器");
+    m_sourceCombo->addItem("压力控制器(TCP/串口)");
+    grid->addWidget(m_sourceCombo, 0, 1);
+
+    grid->addWidget(new QLabel("满量程(MPa):"), 0, 2);
+    m_fullScaleSpin = new QDoubleSpinBox(cfgGroup);
+    m_fullScaleSpin->setRange(0.1, 100.0);
+    m_fullScaleSpin->setDecimals(2);
+    grid->addWidget(m_fullScaleSpin, 0, 3);
+
+    grid->addWidget(new QLabel("升降速率(MPa/s):"), 1, 0);
+    m_rampSpin = new QDoubleSpinBox(cfgGroup);
+    m_rampSpin->setRange(0.001, 10.0);
+    m_rampSpin->setDecimals(3);
+    m_rampSpin->setSingleStep(0.01);
+    grid->addWidget(m_rampSpin, 1, 1);
+
+    grid->addWidget(new QLabel("曲线拟合阶数:"), 1, 2);
+    m_degreeSpin = new QSpinBox(cfgGroup);
+    m_degreeSpin->setRange(1, 5);
+    m_degreeSpin->setValue(3);
+    grid->addWidget(m_degreeSpin, 1, 3);
+
+    grid->addWidget(new QLabel("控制器地址:"), 2, 0);
+    m_addressEdit = new QLineEdit("127.0.0.1:5025", cfgGroup);
+    m_addressEdit->setToolTip(LinePressureSource::serialSupported()
+                                  ? "TCP: 主机:端口；串口: serial:COM3@9600 或 serial:/dev/pts/3"
+                                  : "TCP: 主机:端口（当前构建不支持串口）");
+    m_addressEdit->setEnabled(false);
+    grid->addWidget(m_addressEdit, 2, 1);
+
+    grid->addWidget(new QLabel("模式:"), 2, 2);
+    m_modeCombo = new QComboBox(cfgGroup);
+    m_modeCombo->addItem("连续扫描");
+    m_modeCombo->addItem("逐点步进(自动采集)");
+    grid->addWidget(m_modeCombo, 2, 3);
+
+    grid->addWidget(new QLabel("到点容差(MPa):"), 3, 0);
+    m_toleranceSpin = new QDoubleSpinBox(cfgGroup);
+    m_toleranceSpin->setRange(0.001, 1.0);
+    m_toleranceSpin->setDecimals(3);
+    m_toleranceSpin->setSingleStep(0.005);
+    grid->addWidget(m_toleranceSpin, 3, 1);
+
+    grid->addWidget(new QLabel("到点稳定时间(ms):"), 3, 2);
+    m_dwellSpin = new QSpinBox(cfgGroup);
+    m_dwellSpin->setRange(200, 30000);
+    m_dwellSpin->setSingleStep(500);
+    m_dwellSpin->setValue(2000);
+    grid->addWidget(m_dwellSpin, 3, 3);
+    layout->addWidget(cfgGroup);
+
+    auto* btnRow = new QHBoxLayout;
+    m_startBtn = new QPushButton("开始", this);
+    m_stopBtn = new QPushButton("停止", this);
+    m_applyBtn = new QPushButton("写入当前轮次", this);
+    m_stopBtn->setEnabled(false);
+    m_applyBtn->setEnabled(false);
+    btnRow->addWidget(m_startBtn);
+    btnRow->addWidget(m_stopBtn);
+    btnRow->addStretch();
+    btnRow->addWidget(m_applyBtn);
+    layout->addLayout(btnRow);
+
+    m_statusLabel = new QLabel("请先在主界面归位，并保持预览运行", this);
+    layout->addWidget(m_statusLabel);
+
+    m_resultTable = new QTableWidget(0, 7, this);
+    m_resultTable->setHorizontalHeaderLabels(QStringList() << "检测点(MPa)" << "正行程角度(°)" << "反行程角度(°)"
+                                                           << "正行程误差(MPa)" << "反行程误差(MPa)"
+                                                           << "迟滞误差(MPa)" << "样本数(正/反)");
+    m_resultTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_resultTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    layout->addWidget(m_resultTable, 1);
+
+    // 逐点步进的采集记录：每个点的角度与到点时的参考压力、时间戳
+    m_stepTable = new QTableWidget(0, 6, this);
+    m_stepTable->setHorizontalHeaderLabels(QStringList() << "步骤" << "行程" << "目标压力(MPa)"
+                                                         << "参考压力(MPa)" << "到点时间" << "相对角(°)");
+    m_stepTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_stepTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_stepTable->hide();
+    layout->addWidget(m_stepTable, 1);
+
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setWordWrap(true);
+    layout->addWidget(m_summaryLabel);
+
+    connect(m_startBtn, &QPushButton::clicked, this, [this]() {
+        if (m_modeCombo->currentIndex() == 1) startStepping();
+        else startSweep();
+    });
+    connect(m_stopBtn, &QPushButton::clicked, this, [this]() {
+        if (m_stepping) stopStepping("已手动停止");
+        else stopSweep();
+    });
+    connect(m_applyBtn, &QPushButton::clicked, this, &SweepCalibrationDialog::applyResult);
+    connect(m_sourceCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SweepCalibrationDialog::onSourceChanged);
+    connect(m_modeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int mode) {
+        m_resultTable->setVisible(mode == 0);
+        m_stepTable->setVisible(mode == 1);
+        m_applyBtn->setVisible(mode == 0);
+    });
+
+    m_tickTimer = new QTimer(this);
+    m_tickTimer->setInterval(200);
+    connect(m_tickTimer, &QTimer::timeout, this, &SweepCalibrationDialog::onTick);
+}
+
+void SweepCalibrationDialog::onSourceChanged(int index)
+{
+    m_addressEdit->setEnabled(index == 2);
+}
+
+std::unique_ptr<PressureSource> SweepCalibrationDialog::createSource()
+{
+    switch (m_sourceCombo->currentIndex()) {
+    case 1: {
+        PressureControllerParams params;
+        params.rampPerSec = m_rampSpin->value();
+        params.settleBand = m_toleranceSpin->value();
+        return std::make_unique<SimulatedControllerSource>(params);
+    }
+    case 2:
+        return std::make_unique<LinePressureSource>(m_addressEdit->text());
+    default:
+        return std::make_unique<SweepSimulatorSource>(m_fullScaleSpin->value(), m_rampSpin->value(), 1.0);
+    }
+}
+
+bool SweepCalibrationDialog::startSource()
+{
+    m_source = createSource();
+    if (!m_source || !m_source->start()) {
+        QString msg = "压力源启动失败";
+        if (m_source && !m_source->lastError().empty()) msg += "：\n" + QString::fromStdString(m_source->lastError());
+        QMessageBox::warning(this, "错误", msg);
+        m_source.reset();
+        return false;
+    }
+    // 外部控制器的升降速率以界面设置为准
+    if (auto* line = dynamic_cast<LinePressureSource*>(m_source.get())) line->setRampRate(m_rampSpin->value());
+    return true;
+}
+
+void SweepCalibrationDialog::startSweep()
+{
+    if (!startSource()) return;
+
+    // 可控压力源：由程序下发目标，先升到满量程，onTick 里到顶后再降回 0
+    m_descending = false;
+    if (m_source->canControl()) m_source->setTarget(m_fullScaleSpin->value());
+
+    // 压力抖动在满量程 0.5% 以内不换向
+    m_recorder.setDeadband(0.005 * m_fullScaleSpin->value());
+    m_recorder.clear();
+    m_result = SweepResult();
+    m_resultTable->setRowCount(0);
+    m_summaryLabel->clear();
+
+    m_sweeping = true;
+    m_startBtn->setEnabled(false);
+    m_stopBtn->setEnabled(true);
+    m_applyBtn->setEnabled(false);
+    m_tickTimer->start();
+    qDebug() << "开始扫描标定，压力源:" << QString::fromStdString(m_source->name())
+             << "满量程:" << m_fullScaleSpin->value() << "速率:" << m_rampSpin->value() << "MPa/s";
+}
+
+void SweepCalibrationDialog::addAngleSample(double relativeDeg)
+{
+    if (!m_sweeping || !m_source) return;
+
+    // 每个角度样本配一次当前参考压力（同一时钟的时间戳）
+    PressureReading reading;
+    if (!m_source->read(reading) || !reading.valid) return;
+    m_lastReading = reading;
+    m_recorder.add(reading.timestampUs, reading.pressure, relativeDeg);
+}
+
+void SweepCalibrationDialog::onTick()
+{
+    if (!m_sweeping || !m_source) return;
+
+    PressureReading reading = m_lastReading;
+    m_source->read(reading);
+    if (m_stepping) {
+        tickStepping(reading);
+        return;
+    }
+
+    m_statusLabel->setText(QString("压力: %1 MPa | %2 | 已记录 %3 帧")
+                               .arg(reading.pressure, 0, 'f', 3)
+                               .arg(m_recorder.direction() > 0 ? "升压(正行程)" : "降压(反行程)")
+                               .arg(m_recorder.samples().size()));
+
+    if (m_source->sweepFinished()) {
+        stopSweep();
+        return;
+    }
+
+    if (m_source->canControl() && reading.valid) {
+        const double tol = m_toleranceSpin->value();
+        if (!m_descending && reading.pressure >= m_fullScaleSpin->value() - tol) {
+            m_descending = true;
+            m_source->setTarget(0.0);
+            qDebug() << "已到满量程，开始降压";
+        } else if (m_descending && reading.pressure <= tol) {
+            stopSweep();
+        }
+    }
+}
+
+void SweepCalibrationDialog::stopSweep()
+{
+    if (!m_sweeping) return;
+    m_sweeping = false;
+    m_tickTimer->stop();
+    if (m_source) m_source->stop();
+    m_startBtn->setEnabled(true);
+    m_stopBtn->setEnabled(false);
+
+    std::vector<double> points(m_detectionPoints.begin(), m_detectionPoints.end());
+    m_result = fitSweep(m_recorder.samples(), points, m_fullScaleSpin->value(), m_degreeSpin->value());
+    qDebug() << "扫描结束，样本数:" << m_recorder.samples().size() << "拟合" << (m_result.ok ? "成功" : "失败");
+
+    if (!m_result.ok) {
+        m_statusLabel->setText(QString("扫描结束，但数据不足以拟合（%1 帧）。请确认已归位且预览在运行").arg(m_recorder.samples().size()));
+        return;
+    }
+    m_statusLabel->setText(QString("扫描结束：正行程 %1 帧，反行程 %2 帧").arg(m_result.forwardCount).arg(m_result.backwardCount));
+    showResult();
+    m_applyBtn->setEnabled(true);
+}
+
+void SweepCalibrationDialog::showResult()
+{
+    auto cell = [](bool has, double v, int prec) {
+        return new QTableWidgetItem(has ? QString::number(v, 'f', prec) : QString("--"));
+    };
+
+    m_resultTable->setRowCount(int(m_result.points.size()));
+    for (int i = 0; i < int(m_result.points.size()); ++i) {
+        const SweepPointResult& p = m_result.points[i];
+        m_resultTable->setItem(i, 0, new QTableWidgetItem(QString::number(p.pressure, 'f', 2)));
+        m_resultTable->setItem(i, 1, cell(p.hasForward, p.forwardAngle, 2));
+        m_resultTable->setItem(i, 2, cell(p.hasBackward, p.backwardAngle, 2));
+        m_resultTable->setItem(i, 3, cell(p.hasForward, p.forwardErrMPa, 3));
+        m_resultTable->setItem(i, 4, cell(p.hasBackward, p.backwardErrMPa, 3));
+        m_resultTable->setItem(i, 5, cell(p.hasForward && p.hasBackward, p.hysteresisMPa, 3));
+        m_resultTable->setItem(i, 6, new QTableWidgetItem(QString("%1 / %2").arg(p.forwardSamples).arg(p.backwardSamples)));
+    }
+
+    QStringList terms;
+    for (size_t k = 0; k < m_result.coeffs.size(); ++k) {
+        terms << (k == 0 ? QString::number(m_result.coeffs[k], 'f', 3)
+                         : QString("%1·x^%2").arg(m_result.coeffs[k], 0, 'f', 3).arg(k));
+    }
+    m_summaryLabel->setText(QString("标定曲线 θ(x) = %1 （x = 压力/满量程）\n"
+                                    "拟合残差 RMS: %2° | 满量程角度: %3° | 最大基本误差: %4 MPa | 最大迟滞: %5 MPa")
+                                .arg(terms.join(" + "))
+                                .arg(m_result.rmsResidualDeg, 0, 'f', 3)
+                                .arg(m_result.fullScaleAngle, 0, 'f', 2)
+                                .arg(m_result.maxAbsErrMPa, 0, 'f', 3)
+                                .arg(m_result.maxHysteresisMPa, 0, 'f', 3));
+}
+
+void SweepCalibrationDialog::applyResult()
+{
+    if (!m_result.ok) return;
+
+    QVector<double> forward, backward;
+    for (const SweepPointResult& p : m_result.points) {
+        forward.append(p.hasForward ? p.forwardAngle : std::numeric_limits<double>::quiet_NaN());
+        backward.append(p.hasBackward ? p.backwardAngle : std::numeric_limits<double>::quiet_NaN());
+    }
+    emit applyToRound(forward, backward, m_result.fullScaleAngle);
+    m_applyBtn->setEnabled(false);
+}
+
+// ---------------- 逐点步进 ----------------
+
+void SweepCalibrationDialog::startStepping()
+{
+    if (!startSource()) return;
+    if (!m_source->canControl()) {
+        QMessageBox::warning(this, "提示", "逐点步进需要可控压力源（控制器模拟器或压力控制器）");
+        m_source->stop();
+        m_source.reset();
+        return;
+    }
+
+    std::vector<double> points(m_detectionPoints.begin(), m_detectionPoints.end());
+    m_sequencer = PressurePointSequencer(points, m_fullScaleSpin->value(), m_toleranceSpin->value(), m_dwellSpin->value());
+    m_stepTable->setRowCount(0);
+    m_waitingCapture = false;
+    m_stepping = true;
+    m_startBtn->setEnabled(false);
+    m_stopBtn->setEnabled(true);
+    m_tickTimer->setInterval(100);
+    m_tickTimer->start();
+    qDebug() << "开始逐点步进，压力源:" << QString::fromStdString(m_source->name())
+             << "共" << m_sequencer.stepCount() << "步";
+    commandCurrentStep();
+}
+
+void SweepCalibrationDialog::commandCurrentStep()
+{
+    const PointStep* step = m_sequencer.current();
+    if (!step || !m_source) return;
+    m_source->setTarget(step->target);
+    qDebug() << "步骤" << (m_sequencer.stepIndex() + 1) << "目标压力:" << step->target << "MPa"
+             << (step->isMax ? "(满量程)" : step->forward ? "(正行程)" : "(反行程)");
+}
+
+void SweepCalibrationDialog::tickStepping(const PressureReading& reading)
+{
+    const PointStep* step = m_sequencer.current();
+    if (!step) return;
+
+    m_statusLabel->setText(QString("步骤 %1/%2 %3 | 目标 %4 MPa | 压力 %5 MPa | %6")
+                               .arg(m_sequencer.stepIndex() + 1)
+                               .arg(m_sequencer.stepCount())
+                               .arg(step->isMax ? "满量程" : step->forward ? "正行程" : "反行程")
+                               .arg(step->target, 0, 'f', 3)
+                               .arg(reading.valid ? QString::number(reading.pressure, 'f', 3) : QString("--"))
+                               .arg(m_waitingCapture ? QString("采集中...")
+                                                     : QString("已稳定 %1 s").arg(m_sequencer.stableMs() / 1000.0, 0, 'f', 1)));
+
+    if (m_waitingCapture || !reading.valid) return;
+    if (m_sequencer.update(reading)) {
+        m_waitingCapture = true;
+        m_pointReading = reading;
+        emit pointReached(step->pointIndex, step->forward, step->isMax, reading.pressure, reading.timestampUs);
+    }
+}
+
+void SweepCalibrationDialog::confirmPoint(bool ok, double relativeDeg)
+{
+    if (!m_stepping || !m_waitingCapture) return;
+    m_waitingCapture = false;
+
+    const PointStep* step = m_sequencer.current();
+    if (!step) return;
+    if (!ok) {
+        qDebug() << "检测点采集失败，等压力重新稳定后重试";
+        m_sequencer.retry();
+        return;
+    }
+
+    const int row = m_stepTable->rowCount();
+    m_stepTable->insertRow(row);
+    m_stepTable->setItem(row, 0, new QTableWidgetItem(QString::number(m_sequencer.stepIndex() + 1)));
+    m_stepTable->setItem(row, 1, new QTableWidgetItem(step->isMax ? "满量程" : step->forward ? "正行程" : "反行程"));
+    m_stepTable->setItem(row, 2, new QTableWidgetItem(QString::number(step->target, 'f', 3)));
+    m_stepTable->setItem(row, 3, new QTableWidgetItem(QString::number(m_pointReading.pressure, 'f', 4)));
+    m_stepTable->setItem(row, 4, new QTableWidgetItem(
+        QDateTime::fromMSecsSinceEpoch(m_pointReading.timestampUs / 1000).toString("hh:mm:ss.zzz")));
+    m_stepTable->setItem(row, 5, new QTableWidgetItem(QString::number(relativeDeg, 'f', 2)));
+    m_stepTable->scrollToBottom();
+
+    m_sequencer.advance();
+    if (m_sequencer.finished()) {
+        m_source->setTarget(0.0);
+        stopStepping("全部检测点采集完成，压力回零");
+        return;
+    }
+    commandCurrentStep();
+}
+
+void SweepCalibrationDialog::stopStepping(const QString& reason)
+{
+    if (!m_stepping) return;
+    m_stepping = false;
+    m_waitingCapture = false;
+    m_tickTimer->stop();
+    m_tickTimer->setInterval(200);
+    if (m_source) m_source->stop();
+    m_startBtn->setEnabled(true);
+    m_stopBtn->setEnabled(false);
+    m_statusLabel->setText(reason);
+    qDebug() << "逐点步进结束:" << reason;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <QDialog>
+#include <QVector>
+#include <memory>
+
+#include "analysis/pointsequencer.h"
+#include "analysis/pressuresource.h"
+#include "analysis/sweepcalibration.h"
+
+class QComboBox;
+class QLineEdit;
+class QDoubleSpinBox;
+class QSpinBox;
+class QLabel;
+class QPushButton;
+class QTableWidget;
+class QTimer;
+
+// 连续扫描标定：压力连续升降，逐帧把相对角与参考压力配对，结束后拟合曲线并给出各检测点误差。
+// 逐点步进：压力源可控时按检测点顺序下发目标压力，到点稳定后通知主窗口采集，采完自动走下一个点。
+class SweepCalibrationDialog : public QDialog {
+    Q_OBJECT
+public:
+    SweepCalibrationDialog(const QString& dialType, const QVector<double>& detectionPoints,
+                           double fullScalePressure, QWidget* parent = nullptr);
+    ~SweepCalibrationDialog() override;
+
+    bool isSweeping() const { return m_sweeping; }
+    bool isStepping() const { return m_stepping; }
+
+    // 主窗口每处理一帧调用一次（相对角，已展开）
+    void addAngleSample(double relativeDeg);
+
+    // 主窗口处理完 pointReached 后回报：成功则记录并前往下一个点，失败则原地重新等稳定
+    void confirmPoint(bool ok, double relativeDeg);
+
+signals:
+    // 把扫描结果写入当前轮次：forward/backward 与检测点一一对应，没扫到的点为 NaN
+    void applyToRound(const QVector<double>& forward, const QVector<double>& backward, double maxAngle);
+
+    // 逐点步进：压力已稳定在目标点。pointIndex 为检测点下标（满量程步为 -1，isMax=true），
+    // pressure/timestampUs 是到点时的参考压力读数
+    void pointReached(int pointIndex, bool forward, bool isMax, double pressure, qint64 timestampUs);
+
+private slots:
+    void startSweep();
+    void stopSweep();
+    void onTick();
+    void applyResult();
+    void onSourceChanged(int index);
+
+private:
+    void buildUi();
+    std::unique_ptr<PressureSource> createSource();
+    void showResult();
+    bool startSource();
+    void startStepping();
+    void stopStepping(const QString& reason);
+    void commandCurrentStep();
+    void tickStepping(const PressureReading& reading);
+
+    QString m_dialType;
+    QVector<double> m_detectionPoints;
+
+    QComboBox* m_sourceCombo = nullptr;
+    QComboBox* m_modeCombo = nullptr;
+    QLineEdit* m_addressEdit = nullptr;
+    QDoubleSpinBox* m_toleranceSpin = nullptr;
+    QSpinBox* m_dwellSpin = nullptr;
+    QDoubleSpinBox* m_fullScaleSpin = nullptr;
+    QDoubleSpinBox* m_rampSpin = nullptr;
+    QSpinBox* m_degreeSpin = nullptr;
+    QPushButton* m_startBtn = nullptr;
+    QPushButton* m_stopBtn = nullptr;
+    QPushButton* m_applyBtn = nullptr;
+    QLabel* m_statusLabel = nullptr;
+    QLabel* m_summaryLabel = nullptr;
+    QTableWidget* m_resultTable = nullptr;
+    QTableWidget* m_stepTable = nullptr;
+    QTimer* m_tickTimer = nullptr;
+
+    std::unique_ptr<PressureSource> m_source;
+    SweepRecorder m_recorder;
+    SweepResult m_result;
+    bool m_sweeping = false;
+    bool m_descending = false;          // 可控压力源的连续扫描：已到满量程、正在降压
+    PressureReading m_lastReading;
+
+    PressurePointSequencer m_sequencer;
+    bool m_stepping = false;
+    bool m_waitingCapture = false;      // 已发 pointReached，等主窗口回报
+    PressureReading m_pointReading;     // 到点时的参考压力
+};
@@ -0,0 +1,63 @@
+#include "tiledrender.h"
+
+#include <QPainter>
+#include <QThread>
+#include <QThreadPool>
+
+namespace {
+
+// 横条太矮时每条重放整张列表的开销比省下的光栅化还多
+constexpr int kMinTileRows = 128;
+
+void replay(QImage& device, const DisplayList& steps, const QRect& clip)
+{
+    QPainter p(&device);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setRenderHint(QPainter::TextAntialiasing, true);
+    if (!clip.isNull()) p.setClipRect(clip);
+    for (const auto& step : steps) step(p);
+    p.end();
+}
+
+} // namespace
+
+void renderDisplayList(QImage& img, const DisplayList& steps)
+{
+    replay(img, steps, QRect());
+}
+
+void renderDisplayListTiled(QImage& img, const DisplayList& steps)
+{
+    const int threads = QThread::idealThreadCount();
+    const int w = img.width();
+    const int h = img.height();
+    if (threads <= 1 || h < kMinTileRows * 2) {
+        renderDisplayList(img, steps);
+        return;
+    }
+
+    // 横条数取核数的两倍，文字多的那几条慢一点也能摊开
+    const int tileCount = qMin(threads * 2, h / kMinTileRows);
+    const int tileRows = (h + tileCount - 1) / tileCount;
+
+    // 先在调用线程里拿到可写指针（有共享时在这里 detach），之后各线程只往自己那几行写
+    uchar* bits = img.bits();
+    const qsizetype bpl = img.bytesPerLine();
+    const QImage::Format format = img.format();
+    const int dpmX = img.dotsPerMeterX();
+    const int dpmY = img.dotsPerMeterY();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for (int y0 = 0; y0 < h; y0 += tileRows) {
+        const QRect clip(0, y0, w, qMin(tileRows, h - y0));
+        pool.start([=, &steps]() {
+            // 不拥有内存的整图视图：坐标系和原图一致，字体度量也要用同样的 DPI
+            QImage view(bits, w, h, bpl, format);
+            view.setDotsPerMeterX(dpmX);
+            view.setDotsPerMeterY(dpmY);
+            replay(view, steps, clip);
+        });
+    }
+    pool.waitForDone();
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <QImage>
+#include <QVector>
+#include <functional>
+
+class QPainter;
+
+// ================== 大图分块并行光栅化 ==================
+// 表盘这种几千像素见方的图：先把绘制步骤录成一张显示列表（每步一个 lambda，几何参数和要贴的图在录制时就算好），
+// 再按横条分给线程池，每个横条自己一个 QPainter 重放整张列表。
+// 所有横条画在同一块图像内存上，只设裁剪矩形、不做平移，每个图元的设备坐标、抗锯齿覆盖率和单线程绘制完全一样；
+// 裁剪外的像素一律不写，横条之间按行互不重叠，所以不用加锁，输出逐像素一致。
+// 步骤里只能用能在工作线程用的东西（QImage、QFont、QPen……），QPixmap 要在录制前在界面线程转成 QImage；
+// 步骤不能依赖"之前画过什么"以外的共享状态，每个横条都从头重放。
+
+using DisplayList = QVector<std::function<void(QPainter&)>>;
+
+// img 须已分配好并填好底色；每个 QPainter 都打开抗锯齿和文字抗锯齿，DPI 取 img 当前的设置
+void renderDisplayListTiled(QImage& img, const DisplayList& steps);
+// 单线程重放（图太小或只有一个核时 renderDisplayListTiled 也走这里）
+void renderDisplayList(QImage& img, const DisplayList& steps);
@@ -0,0 +1,170 @@
+#include "xlsxexportjob.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMessageBox>
+#include <QPointer>
+#include <QProgressDialog>
+#include <QThread>
+#include <algorithm>
+#include <limits>
+
+#include "gaugereport.h"
+#include "xlsxwriter.h"
+
+namespace {
+
+QString passedText(int passed)
+{
+    return passed < 0 ? QString("未完成") : (passed ? QString("合格") : QString("不合格"));
+}
+
+} // namespace
+
+XlsxExportJob::XlsxExportJob(const QString& path, const QVector<Sheet>& sheets)
+    : m_path(path), m_sheets(sheets)
+{
+}
+
+XlsxExportJob::XlsxExportJob(const QString& path, const QString& dbPath, const SessionFilter& filter, Layout layout)
+    : m_path(path), m_dbPath(dbPath), m_filter(filter), m_layout(layout), m_fromDatabase(true)
+{
+}
+
+void XlsxExportJob::start(QWidget* parent)
+{
+    auto* thread = new QThread();
+    moveToThread(thread);
+    connect(thread, &QThread::started, this, &XlsxExportJob::run);
+    connect(this, &XlsxExportJob::finished, thread, &QThread::quit);
+    connect(thread, &QThread::finished, this, &QObject::deleteLater);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+
+    auto* dialog = new QProgressDialog("正在导出Excel...", "取消", 0, 0, parent);
+    dialog->setWindowTitle("导出Excel");
+    dialog->setWindowModality(Qt::WindowModal);
+    dialog->setAutoClose(false);
+    dialog->setAutoReset(false);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+
+    auto canceled = m_canceled;
+    connect(dialog, &QProgressDialog::canceled, dialog, [canceled]() { *canceled = true; });
+    connect(this, &XlsxExportJob::progress, dialog, [dialog](int done, int total) {
+        dialog->setMaximum(total);
+        dialog->setValue(done);
+        dialog->setLabelText(QString("正在导出Excel... %1/%2").arg(done).arg(total));
+    });
+    QPointer<QWidget> owner(parent);
+    connect(this, &XlsxExportJob::finished, dialog, [dialog, owner](bool ok, const QString& message) {
+        dialog->close();
+        if (!owner) return;
+        if (ok) {
+            QMessageBox::information(owner, "成功", message);
+        } else {
+            QMessageBox::warning(owner, "导出Excel", message);
+        }
+    });
+
+    dialog->show();
+    thread->start();
+}
+
+void XlsxExportJob::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    XlsxWriter writer;
+    QString message;
+    bool ok = writer.open(m_path);
+    if (ok && m_fromDatabase) {
+        ok = writeSessions(writer, message);
+    } else if (ok) {
+        for (int i = 0; i < m_sheets.size() && !*m_canceled; ++i) {
+            writer.beginSheet(m_sheets[i].name);
+            for (const QStringList& row : m_sheets[i].rows) writer.writeRow(row);
+            writer.endSheet();
+            emit progress(i + 1, m_sheets.size());
+        }
+        ok = writer.ok();
+    }
+
+    if (*m_canceled) {
+        writer.abort();
+        emit finished(false, "导出已取消");
+        return;
+    }
+    if (ok) {
+        ok = writer.close();
+    } else {
+        writer.abort();
+    }
+    if (ok) {
+        qDebug() << "Excel 导出完成:" << writer.sheetCount() << "张工作表，耗时" << timer.elapsed() << "ms";
+        message = QString("已导出 %1 张工作表到:\n%2").arg(writer.sheetCount()).arg(m_path);
+    } else if (message.isEmpty()) {
+        message = writer.errorString();
+    }
+    emit finished(ok, message);
+}
+
+bool XlsxExportJob::writeSessions(XlsxWriter& writer, QString& message)
+{
+    // 数据库连接不能跨线程，工作线程里单独开一个
+    SessionDatabase db(QString("xlsx_export_%1").arg(quintptr(this)));
+    if (!db.open(m_dbPath)) {
+        message = db.lastError();
+        return false;
+    }
+    QVector<SessionSummary> list = db.querySessions(m_filter, std::numeric_limits<int>::max());
+    if (list.isEmpty()) {
+        message = db.lastError().isEmpty() ? QString("没有符合条件的检测记录") : db.lastError();
+        return false;
+    }
+
+    // 按时间正序；按批次导出时同一支组排在一起，这样每张表只需要开一次
+    std::stable_sort(list.begin(), list.end(), [](const SessionSummary& a, const SessionSummary& b) {
+        return a.savedAt < b.savedAt;
+    });
+    if (m_layout == SheetPerBatch) {
+        std::stable_sort(list.begin(), list.end(), [](const SessionSummary& a, const SessionSummary& b) {
+            return a.groupNo < b.groupNo;
+        });
+    }
+
+    const int total = list.size();
+    emit progress(0, total);
+    QString currentGroup;
+    for (int i = 0; i < total; ++i) {
+        if (*m_canceled) return false;
+
+        SessionRecord rec;
+        if (!db.loadSession(list[i].id, rec)) {
+            message = db.lastError();
+            return false;
+        }
+        // 数据库里没有存配置的满量程角度，没有成对数据的检测点用平均最大角度作名义满量程
+        const QVector<QStringList> rows = buildGaugeReport(rec, rec.avgMaxAngle, rec.maxPressure).rows;
+
+        if (m_layout == SheetPerGauge) {
+            writer.beginSheet(rec.gaugeSerial.isEmpty() ? QString("#%1").arg(rec.id) : rec.gaugeSerial);
+        } else if (i == 0 || rec.groupNo != currentGroup) {
+            currentGroup = rec.groupNo;
+            writer.beginSheet(currentGroup.isEmpty() ? QString("未分组") : currentGroup);
+        } else {
+            writer.writeRow(QStringList());   // 同一张表里各块表之间空一行
+        }
+        if (m_layout == SheetPerBatch) {
+            writer.writeRow({"表号：", rec.gaugeSerial, "", "保存时间：", rec.savedAt.toString("yyyy-MM-dd HH:mm:ss"),
+                             "", "结论：", passedText(rec.passed)});
+        }
+        for (const QStringList& row : rows) writer.writeRow(row);
+
+        if (!writer.ok()) {
+            message = writer.errorString();
+            return false;
+        }
+        emit progress(i + 1, total);
+    }
+    return true;
+}
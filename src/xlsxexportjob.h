@@ -0,0 +1,57 @@
+#pragma once
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+#include "sessiondatabase.h"
+
+class QWidget;
+class XlsxWriter;
+
+// ================== 后台导出 Excel 工作簿 ==================
+// 在单独的线程里用 XlsxWriter 一块表一块表地写，界面线程只收进度；可以中途取消（半成品文件会删掉）。
+// 两种来源：
+//  - 当前误差表格里的一块表：界面线程先排好行，这里只负责写文件；
+//  - 检测记录数据库里按条件查出的一批表：工作线程自己开数据库连接，逐条读出、排版、写出，
+//    内存里同时只有一块表的数据。
+// 批量导出可以每块表一张工作表，也可以每个支组（批次）一张工作表、各块表上下排列。
+
+class XlsxExportJob : public QObject {
+    Q_OBJECT
+public:
+    enum Layout { SheetPerGauge, SheetPerBatch };
+
+    struct Sheet {
+        QString name;
+        QVector<QStringList> rows;
+    };
+
+    XlsxExportJob(const QString& path, const QVector<Sheet>& sheets);
+    XlsxExportJob(const QString& path, const QString& dbPath, const SessionFilter& filter, Layout layout);
+    ~XlsxExportJob() override = default;
+
+    // 移到新线程里运行，在 parent 上显示可取消的进度框，结束后提示结果；任务和线程结束后自动释放
+    void start(QWidget* parent);
+    void cancel() { *m_canceled = true; }
+
+signals:
+    void progress(int done, int total);
+    void finished(bool ok, const QString& message);
+
+private slots:
+    void run();
+
+private:
+    bool writeSessions(XlsxWriter& writer, QString& message);
+
+    QString m_path;
+    QVector<Sheet> m_sheets;
+    QString m_dbPath;
+    SessionFilter m_filter;
+    Layout m_layout = SheetPerGauge;
+    bool m_fromDatabase = false;
+    // 取消标志单独共享：进度框的取消按钮在界面线程里置位，不用碰可能已经释放的任务对象
+    std::shared_ptr<std::atomic<bool>> m_canceled = std::make_shared<std::atomic<bool>>(false);
+};
@@ -0,0 +1,413 @@
+#include "xlsxwriter.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QtEndian>
+#include <array>
+
+namespace {
+
+const int kDeflateLimit = 1 << 20;        // 单个条目不超过 1MB 时整块压缩，否则不压缩直写
+const int kMaxRows = 1048576;             // Excel 单表行数上限
+const int kMaxSheetName = 31;
+const qint64 kMaxZipSize = 0xFFFFFFFFll;  // 不写 zip64，单文件 4GB 以内
+
+const char kXmlHead[] = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+const char kMainNs[] = "http://schemas.openxmlformats.org/spreadsheetml/2006/main";
+const char kRelNs[] = "http://schemas.openxmlformats.org/officeDocument/2006/relationships";
+
+quint32 crc32Update(quint32 crc, const char* data, int size)
+{
+    // 导出任务在工作线程里跑，表用局部静态初始化，线程安全
+    static const std::array<quint32, 256> table = [] {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    crc ^= 0xFFFFFFFFu;
+    for (int i = 0; i < size; ++i) crc = table[(crc ^ quint8(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void put16(QByteArray& out, quint16 v)
+{
+    char buf[2];
+    qToLittleEndian(v, buf);
+    out.append(buf, 2);
+}
+
+void put32(QByteArray& out, quint32 v)
+{
+    char buf[4];
+    qToLittleEndian(v, buf);
+    out.append(buf, 4);
+}
+
+QByteArray xmlEscape(const QString& text)
+{
+    QString s;
+    s.reserve(text.size());
+    for (QChar c : text) {
+        const ushort u = c.unicode();
+        if (u < 0x20 && u != '\t' && u != '\n' && u != '\r') continue;   // XML 里不允许的控制字符
+        switch (u) {
+        case '&': s += "&amp;"; break;
+        case '<': s += "&lt;"; break;
+        case '>': s += "&gt;"; break;
+        case '"': s += "&quot;"; break;
+        default: s += c;
+        }
+    }
+    return s.toUtf8();
+}
+
+// "-12.34" 这类写法才当数字（不含前导零、指数、空格，整数部分不超过 15 位）；decimals 回填小数位数
+bool isPlainNumber(const QString& text, int& decimals)
+{
+    int i = 0;
+    const int n = text.size();
+    if (i < n && text[i] == '-') ++i;
+    const int intStart = i;
+    while (i < n && text[i].isDigit() && text[i].unicode() < 128) ++i;
+    const int intLen = i - intStart;
+    if (intLen == 0 || intLen > 15 || (intLen > 1 && text[intStart] == '0')) return false;
+    decimals = 0;
+    if (i < n && text[i] == '.') {
+        ++i;
+        const int fracStart = i;
+        while (i < n && text[i].isDigit() && text[i].unicode() < 128) ++i;
+        decimals = i - fracStart;
+        if (decimals == 0) return false;
+    }
+    return i == n;
+}
+
+QByteArray columnName(int col)
+{
+    QByteArray name;
+    for (++col; col > 0; col = (col - 1) / 26) name.prepend(char('A' + (col - 1) % 26));
+    return name;
+}
+
+// cellXfs 下标：1=0.0 2=0.00 3=0.000，其余用常规格式
+int numberStyle(int decimals)
+{
+    return (decimals >= 1 && decimals <= 3) ? decimals : 0;
+}
+
+const char kStyles[] =
+    "<styleSheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\">"
+    "<numFmts count=\"2\"><numFmt numFmtId=\"164\" formatCode=\"0.0\"/><numFmt numFmtId=\"165\" formatCode=\"0.000\"/></numFmts>"
+    "<fonts count=\"1\"><font><sz val=\"11\"/><name val=\"Calibri\"/></font></fonts>"
+    "<fills count=\"2\"><fill><patternFill patternType=\"none\"/></fill><fill><patternFill patternType=\"gray125\"/></fill></fills>"
+    "<borders count=\"1\"><border><left/><right/><top/><bottom/><diagonal/></border></borders>"
+    "<cellStyleXfs count=\"1\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\"/></cellStyleXfs>"
+    "<cellXfs count=\"4\">"
+    "<xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\"/>"
+    "<xf numFmtId=\"164\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+    "<xf numFmtId=\"2\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+    "<xf numFmtId=\"165\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+    "</cellXfs>"
+    "<cellStyles count=\"1\"><cellStyle name=\"Normal\" xfId=\"0\" builtinId=\"0\"/></cellStyles>"
+    "</styleSheet>";
+
+} // namespace
+
+XlsxWriter::~XlsxWriter()
+{
+    if (m_file.isOpen()) abort();
+}
+
+void XlsxWriter::fail(const QString& error)
+{
+    if (!m_error.isEmpty()) return;   // 只记第一个错误
+    m_error = error;
+    qDebug() << "XLSX 写入失败:" << error;
+}
+
+bool XlsxWriter::open(const QString& path)
+{
+    m_entries.clear();
+    m_sheets.clear();
+    m_error.clear();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        fail(QString("无法创建文件 %1: %2").arg(path, m_file.errorString()));
+        return false;
+    }
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDate d = now.date();
+    const QTime t = now.time();
+    m_dosTime = quint16((t.hour() << 11) | (t.minute() << 5) | (t.second() / 2));
+    m_dosDate = quint16(((qMax(1980, d.year()) - 1980) << 9) | (d.month() << 5) | d.day());
+    return true;
+}
+
+void XlsxWriter::writeRaw(const QByteArray& data)
+{
+    if (!ok()) return;
+    if (m_file.pos() + data.size() > kMaxZipSize) {
+        fail("导出文件超过 4GB，请按支组分开导出");
+        return;
+    }
+    if (m_file.write(data) != data.size()) fail("写入文件失败: " + m_file.errorString());
+}
+
+void XlsxWriter::writeLocalHeader(const Entry& e)
+{
+    QByteArray h;
+    h.reserve(30 + e.name.size());
+    put32(h, 0x04034b50u);
+    put16(h, 20);             // 解压所需版本 2.0
+    put16(h, 0x0800);         // 文件名是 UTF-8
+    put16(h, e.method);
+    put16(h, m_dosTime);
+    put16(h, m_dosDate);
+    put32(h, e.crc);
+    put32(h, e.packed);
+    put32(h, e.size);
+    put16(h, quint16(e.name.size()));
+    put16(h, 0);
+    h.append(e.name);
+    writeRaw(h);
+}
+
+void XlsxWriter::beginEntry(const QString& name)
+{
+    m_cur = Entry();
+    m_cur.name = name.toUtf8();
+    m_buf.clear();
+    m_streaming = false;
+    m_inEntry = true;
+}
+
+void XlsxWriter::entryData(const QByteArray& data)
+{
+    if (!m_inEntry || !ok()) return;
+    m_cur.crc = crc32Update(m_cur.crc, data.constData(), data.size());
+    m_cur.size += quint32(data.size());
+    m_buf.append(data);
+    if (m_buf.size() < kDeflateLimit) return;
+
+    // 条目太大：先写一个长度待定的本地头，之后不压缩直写，缓冲只留一小块
+    if (!m_streaming) {
+        m_cur.method = 0;
+        m_cur.offset = quint32(m_file.pos());
+        writeLocalHeader(m_cur);
+        m_streaming = true;
+    }
+    writeRaw(m_buf);
+    m_buf.clear();
+}
+
+void XlsxWriter::endEntry()
+{
+    if (!m_inEntry) return;
+    m_inEntry = false;
+    if (!ok()) return;
+
+    if (m_streaming) {
+        writeRaw(m_buf);
+        m_cur.packed = m_cur.size;
+        // 回填本地头里的 CRC 和长度（偏移 14 起 12 字节）
+        const qint64 end = m_file.pos();
+        QByteArray patch;
+        put32(patch, m_cur.crc);
+        put32(patch, m_cur.packed);
+        put32(patch, m_cur.size);
+        if (!m_file.seek(m_cur.offset + 14) || m_file.write(patch) != patch.size() || !m_file.seek(end)) {
+            fail("回填 zip 条目头失败: " + m_file.errorString());
+        }
+    } else {
+        // qCompress 的输出是 4 字节长度 + zlib 流（2 字节头 + deflate + 4 字节 adler32），中间就是 zip 要的 deflate 数据
+        QByteArray data = m_buf;
+        m_cur.method = 0;
+        if (!m_buf.isEmpty()) {
+            const QByteArray z = qCompress(m_buf, 6);
+            if (z.size() > 10 && z.size() - 10 < m_buf.size()) {
+                data = z.mid(6, z.size() - 10);
+                m_cur.method = 8;
+            }
+        }
+        m_cur.packed = quint32(data.size());
+        m_cur.offset = quint32(m_file.pos());
+        writeLocalHeader(m_cur);
+        writeRaw(data);
+    }
+    m_buf.clear();
+    m_entries.append(m_cur);
+}
+
+void XlsxWriter::addSmallEntry(const QString& name, const QByteArray& data)
+{
+    beginEntry(name);
+    entryData(data);
+    endEntry();
+}
+
+QString XlsxWriter::beginSheet(const QString& name)
+{
+    if (m_inSheet) endSheet();
+
+    QString clean;
+    for (QChar c : name) {
+        if (c.unicode() < 0x20 || QStringLiteral("[]:*?/\\").contains(c)) continue;
+        clean += c;
+    }
+    clean = clean.trimmed();
+    while (clean.startsWith('\'')) clean.remove(0, 1);
+    while (clean.endsWith('\'')) clean.chop(1);
+    if (clean.isEmpty()) clean = QString("Sheet%1").arg(m_sheets.size() + 1);
+    clean = clean.left(kMaxSheetName);
+
+    // Excel 里表名不区分大小写
+    const QString base = clean;
+    for (int k = 2; m_sheets.contains(clean, Qt::CaseInsensitive); ++k) {
+        const QString suffix = QString("(%1)").arg(k);
+        clean = base.left(kMaxSheetName - suffix.size()) + suffix;
+    }
+    m_sheets.append(clean);
+
+    beginEntry(QString("xl/worksheets/sheet%1.xml").arg(m_sheets.size()));
+    entryData(QByteArray(kXmlHead) + "<worksheet xmlns=\"" + kMainNs + "\"><sheetData>");
+    m_row = 0;
+    m_inSheet = true;
+    return clean;
+}
+
+void XlsxWriter::writeRow(const QStringList& cells)
+{
+    if (!m_inSheet || !ok()) return;
+    if (m_row >= kMaxRows) {
+        fail(QString("工作表 %1 超过 Excel 行数上限").arg(m_sheets.last()));
+        return;
+    }
+    ++m_row;
+    if (cells.isEmpty()) return;   // 空行跳过行号即可
+
+    const QByteArray rowNo = QByteArray::number(m_row);
+    QByteArray xml;
+    xml.reserve(32 + cells.size() * 48);
+    xml += "<row r=\"" + rowNo + "\">";
+    for (int c = 0; c < cells.size(); ++c) {
+        const QString& text = cells[c];
+        if (text.isEmpty()) continue;
+        xml += "<c r=\"" + columnName(c) + rowNo + "\"";
+        int decimals = 0;
+        if (isPlainNumber(text, decimals)) {
+            const int style = numberStyle(decimals);
+            if (style) xml += " s=\"" + QByteArray::number(style) + "\"";
+            xml += "><v>" + text.toLatin1() + "</v></c>";
+        } else {
+            xml += " t=\"inlineStr\"><is><t xml:space=\"preserve\">" + xmlEscape(text) + "</t></is></c>";
+        }
+    }
+    xml += "</row>";
+    entryData(xml);
+}
+
+void XlsxWriter::endSheet()
+{
+    if (!m_inSheet) return;
+    entryData("</sheetData></worksheet>");
+    endEntry();
+    m_inSheet = false;
+}
+
+bool XlsxWriter::close()
+{
+    if (!m_file.isOpen()) return false;
+    if (m_inSheet) endSheet();
+    if (m_sheets.isEmpty()) {   // 工作簿至少要有一张表
+        beginSheet("Sheet1");
+        endSheet();
+    }
+
+    const int n = m_sheets.size();
+    QByteArray workbook = QByteArray(kXmlHead) + "<workbook xmlns=\"" + kMainNs + "\" xmlns:r=\"" + kRelNs + "\"><sheets>";
+    QByteArray workbookRels = QByteArray(kXmlHead)
+        + "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">";
+    QByteArray types = QByteArray(kXmlHead)
+        + "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+          "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+          "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+          "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+          "<Override PartName=\"/xl/styles.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml\"/>";
+    for (int i = 1; i <= n; ++i) {
+        const QByteArray id = QByteArray::number(i);
+        workbook += "<sheet name=\"" + xmlEscape(m_sheets[i - 1]) + "\" sheetId=\"" + id + "\" r:id=\"rId" + id + "\"/>";
+        workbookRels += "<Relationship Id=\"rId" + id + "\" Type=\"" + kRelNs + "/worksheet\" Target=\"worksheets/sheet" + id + ".xml\"/>";
+        types += "<Override PartName=\"/xl/worksheets/sheet" + id
+               + ".xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>";
+    }
+    workbook += "</sheets></workbook>";
+    workbookRels += "<Relationship Id=\"rId" + QByteArray::number(n + 1) + "\" Type=\"" + kRelNs
+                  + "/styles\" Target=\"styles.xml\"/></Relationships>";
+    types += "</Types>";
+
+    addSmallEntry("xl/workbook.xml", workbook);
+    addSmallEntry("xl/_rels/workbook.xml.rels", workbookRels);
+    addSmallEntry("xl/styles.xml", QByteArray(kXmlHead) + kStyles);
+    addSmallEntry("[Content_Types].xml", types);
+    addSmallEntry("_rels/.rels", QByteArray(kXmlHead)
+        + "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+          "<Relationship Id=\"rId1\" Type=\"" + kRelNs + "/officeDocument\" Target=\"xl/workbook.xml\"/>"
+          "</Relationships>");
+
+    if (m_entries.size() > 0xFFFF) fail("工作表数量超过 zip 条目上限，请分批导出");
+
+    // 中央目录 + 目录结束记录
+    const quint32 dirOffset = quint32(m_file.pos());
+    QByteArray dir;
+    for (const Entry& e : m_entries) {
+        put32(dir, 0x02014b50u);
+        put16(dir, 20);
+        put16(dir, 20);
+        put16(dir, 0x0800);
+        put16(dir, e.method);
+        put16(dir, m_dosTime);
+        put16(dir, m_dosDate);
+        put32(dir, e.crc);
+        put32(dir, e.packed);
+        put32(dir, e.size);
+        put16(dir, quint16(e.name.size()));
+        put16(dir, 0);
+        put16(dir, 0);
+        put16(dir, 0);
+        put16(dir, 0);
+        put32(dir, 0);
+        put32(dir, e.offset);
+        dir.append(e.name);
+    }
+    const quint32 dirSize = quint32(dir.size());
+    put32(dir, 0x06054b50u);
+    put16(dir, 0);
+    put16(dir, 0);
+    put16(dir, quint16(m_entries.size()));
+    put16(dir, quint16(m_entries.size()));
+    put32(dir, dirSize);
+    put32(dir, dirOffset);
+    put16(dir, 0);
+    writeRaw(dir);
+
+    if (!m_file.flush()) fail("写入文件失败: " + m_file.errorString());
+    if (!ok()) {
+        abort();
+        return false;
+    }
+    m_file.close();
+    return true;
+}
+
+void XlsxWriter::abort()
+{
+    m_inEntry = false;
+    m_inSheet = false;
+    m_buf.clear();
+    if (m_file.isOpen()) m_file.close();
+    m_file.remove();
+}
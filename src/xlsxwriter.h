@@ -0,0 +1,66 @@
+#pragma once
+#include <QFile>
+#include <QStringList>
+#include <QVector>
+
+// ================== 流式 XLSX 写入 ==================
+// 直接拼 zip + 工作表 XML，一行一行写出，不在内存里建文档树，几千块表的工作簿也只占很少内存。
+// 字符串用内联字符串（inlineStr），不需要共享字符串表；看起来是数字的单元格（不含前导零）写成数值，
+// 并按小数位数套 0.0 / 0.00 / 0.000 格式，Excel 里显示和 CSV 一样。
+// 单张工作表不大时整张在内存里 deflate 压缩后写出；超过阈值就改为不压缩边写边出，
+// 结束后回填 zip 本地头里的 CRC 和长度。
+// 只能在一个线程里使用（导出任务在工作线程里创建和销毁它）。
+
+class XlsxWriter {
+public:
+    XlsxWriter() = default;
+    ~XlsxWriter();
+    XlsxWriter(const XlsxWriter&) = delete;
+    XlsxWriter& operator=(const XlsxWriter&) = delete;
+
+    bool open(const QString& path);
+    // 开始一张新工作表；名称按 Excel 规则清理（去掉 []:*?/\、截到 31 字、不区分大小写去重），返回实际名称
+    QString beginSheet(const QString& name);
+    void writeRow(const QStringList& cells);   // 空列表 = 空行
+    void endSheet();
+    // 写工作簿目录和 zip 中央目录；返回 false 时文件已删除
+    bool close();
+    // 放弃并删除半成品文件
+    void abort();
+
+    bool ok() const { return m_error.isEmpty(); }
+    QString errorString() const { return m_error; }
+    int sheetCount() const { return m_sheets.size(); }
+
+private:
+    struct Entry {
+        QByteArray name;
+        quint32 crc = 0;
+        quint32 size = 0;
+        quint32 packed = 0;
+        quint32 offset = 0;
+        quint16 method = 0;    // 0=store 8=deflate
+    };
+
+    void beginEntry(const QString& name);
+    void entryData(const QByteArray& data);
+    void endEntry();
+    void writeLocalHeader(const Entry& e);
+    void writeRaw(const QByteArray& data);
+    void addSmallEntry(const QString& name, const QByteArray& data);
+    void fail(const QString& error);
+
+    QFile m_file;
+    quint16 m_dosTime = 0;
+    quint16 m_dosDate = 0;
+    QVector<Entry> m_entries;
+    Entry m_cur;
+    bool m_inEntry = false;
+    bool m_streaming = false;   // 当前条目已开始不压缩直写
+    QByteArray m_buf;
+
+    QStringList m_sheets;       // 实际工作表名，顺序即 sheet1..N
+    bool m_inSheet = false;
+    int m_row = 0;
+    QString m_error;
+};
@@ -0,0 +1,160 @@
+// RGB→CMYK 查表回归测试：全部 2^24 种颜色经 rgbRowsToCmyk 查表，与逐像素调用 rgbToCmyk 逐字节一致；
+// 16 位格式（成图用的 RGBA64，含半透明像素）与整张图 convertToFormat(Format_RGB32) 后再 rgbToCmyk 逐字节一致；
+// 有 libtiff 时再按条带写一张多条带的 CMYK TIFF，读回来逐像素比较（并行 / 单线程各一次）。
+#include "dialrenderer.h"
+#include "testcheck.h"
+
+#include <QTemporaryDir>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#ifdef HAS_LIBTIFF
+#include <tiffio.h>
+#endif
+
+namespace {
+
+// 4096×4096 正好铺满所有颜色：r 取行号高 8 位，g 由行号低 4 位和列号高 4 位拼成，b 为列号低 8 位
+QImage allColors()
+{
+    QImage img(4096, 4096, QImage::Format_RGB32);
+    for (int y = 0; y < img.height(); ++y) {
+        QRgb* row = reinterpret_cast<QRgb*>(img.scanLine(y));
+        for (int x = 0; x < img.width(); ++x) {
+            row[x] = qRgb(y >> 4, ((y & 15) << 4) | (x >> 8), x & 255);
+        }
+    }
+    return img;
+}
+
+bool matchesRgbToCmyk(QRgb pixel, const uint8_t* cmyk)
+{
+    int c, m, y, k;
+    DialRenderer::rgbToCmyk(qRed(pixel), qGreen(pixel), qBlue(pixel), c, m, y, k);
+    return cmyk[0] == c && cmyk[1] == m && cmyk[2] == y && cmyk[3] == k;
+}
+
+void checkLookupTable(const QImage& img)
+{
+    const int width = img.width();
+    std::vector<uint8_t> cmyk(size_t(width) * 4);
+    int mismatches = 0;
+    for (int y = 0; y < img.height(); ++y) {
+        DialRenderer::rgbRowsToCmyk(img, y, y + 1, cmyk.data());
+        const QRgb* src = reinterpret_cast<const QRgb*>(img.constScanLine(y));
+        for (int x = 0; x < width; ++x) {
+            if (!matchesRgbToCmyk(src[x], cmyk.data() + size_t(x) * 4)) ++mismatches;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+// 16 位格式的随机图：alpha 有全透明、半透明和不透明，预乘格式的颜色不超过 alpha
+QImage wideImage(QImage::Format format, unsigned seed)
+{
+    QImage img(1000, 700, format);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> channel(0, 65535);
+    std::uniform_int_distribution<int> pickAlpha(0, 3);
+    const bool opaque = format == QImage::Format_RGBX64;
+    const bool premultiplied = format == QImage::Format_RGBA64_Premultiplied;
+    for (int y = 0; y < img.height(); ++y) {
+        QRgba64* row = reinterpret_cast<QRgba64*>(img.scanLine(y));
+        for (int x = 0; x < img.width(); ++x) {
+            const int kind = opaque ? 3 : pickAlpha(rng);
+            const quint16 a = quint16(kind == 0 ? 0 : kind == 3 ? 65535 : channel(rng));
+            quint16 c[3];
+            for (quint16& v : c) v = quint16(premultiplied ? channel(rng) * a / 65535 : channel(rng));
+            row[x] = QRgba64::fromRgba64(c[0], c[1], c[2], a);
+        }
+    }
+    return img;
+}
+
+// 分段（段高不一）转换，与整张图转成 RGB32 后逐像素 rgbToCmyk 比较
+void checkWideFormat(QImage::Format format)
+{
+    const QImage img = wideImage(format, unsigned(format));
+    const QImage reference = img.convertToFormat(QImage::Format_RGB32);
+    const int width = img.width();
+    int mismatches = 0;
+    int y0 = 0;
+    for (int rows = 1; y0 < img.height(); rows = rows % 37 + 1) {
+        const int y1 = std::min(img.height(), y0 + rows);
+        std::vector<uint8_t> cmyk(size_t(width) * 4 * (y1 - y0));
+        DialRenderer::rgbRowsToCmyk(img, y0, y1, cmyk.data());
+        for (int y = y0; y < y1; ++y) {
+            const QRgb* src = reinterpret_cast<const QRgb*>(reference.constScanLine(y));
+            const uint8_t* out = cmyk.data() + size_t(y - y0) * width * 4;
+            for (int x = 0; x < width; ++x) {
+                if (!matchesRgbToCmyk(src[x], out + size_t(x) * 4)) ++mismatches;
+            }
+        }
+        y0 = y1;
+    }
+    CHECK(mismatches == 0);
+}
+
+#ifdef HAS_LIBTIFF
+// 按条带写出再逐行读回，与 reference（RGB32）逐像素 rgbToCmyk 比较
+void checkTiffRoundTrip(const QImage& img, const QImage& reference, const QString& path, bool parallel)
+{
+    CHECK(DialRenderer::saveCmykTiff(img, path, 2400.0, parallel));
+    TIFF* tif = TIFFOpen(path.toUtf8().constData(), "r");
+    CHECK(tif != nullptr);
+    if (!tif) return;
+
+    uint32_t width = 0, height = 0;
+    uint16_t samples = 0, photometric = 0;
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &width);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &height);
+    TIFFGetField(tif, TIFFTAG_SAMPLESPERPIXEL, &samples);
+    TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric);
+    CHECK(int(width) == img.width() && int(height) == img.height());
+    CHECK(samples == 4 && photometric == PHOTOMETRIC_SEPARATED);
+    CHECK(TIFFNumberOfStrips(tif) > 1);
+
+    std::vector<uint8_t> line(TIFFScanlineSize(tif));
+    int mismatches = 0;
+    for (uint32_t y = 0; y < height && y < uint32_t(img.height()); ++y) {
+        if (TIFFReadScanline(tif, line.data(), y) < 0) {
+            ++mismatches;
+            continue;
+        }
+        const QRgb* src = reinterpret_cast<const QRgb*>(reference.constScanLine(int(y)));
+        for (int x = 0; x < img.width(); ++x) {
+            if (!matchesRgbToCmyk(src[x], line.data() + size_t(x) * 4)) ++mismatches;
+        }
+    }
+    CHECK(mismatches == 0);
+    TIFFClose(tif);
+}
+#endif
+
+} // namespace
+
+int main()
+{
+    const QImage colors = allColors();
+    checkLookupTable(colors);
+    checkWideFormat(QImage::Format_RGBA64);
+    checkWideFormat(QImage::Format_RGBA64_Premultiplied);
+    checkWideFormat(QImage::Format_RGBX64);
+
+#ifdef HAS_LIBTIFF
+    // 只取上面 1100 行（约 18MB 的 CMYK），按 4MB 一个条带会分成好几条，最后一条不满
+    QTemporaryDir dir;
+    CHECK(dir.isValid());
+    const QImage part = colors.copy(0, 0, colors.width(), 1100);
+    checkTiffRoundTrip(part, part, dir.filePath("parallel.tif"), true);
+    checkTiffRoundTrip(part, part, dir.filePath("serial.tif"), false);
+    // 成图实际的格式：RGBA64 整张交给 saveCmykTiff
+    const QImage wide = wideImage(QImage::Format_RGBA64, 7).scaled(4000, 1400);
+    checkTiffRoundTrip(wide, wide.convertToFormat(QImage::Format_RGB32), dir.filePath("wide.tif"), true);
+#else
+    std::cout << "cmyktest: 未启用 libtiff，跳过 TIFF 写出检查\n";
+#endif
+
+    return testResult("cmyktest");
+}
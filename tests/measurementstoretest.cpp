@@ -0,0 +1,200 @@
+// MeasurementStore 回归测试：
+// 一串录入/修改/清空直接写进存储，与只把最终数据重新回放进新存储相比，所有汇总量必须逐位一致；
+// 汇总量和误差核再与逐格直接计算（原来误差表格的算法）逐位比较。
+#include "measurementstore.h"
+#include "testcheck.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr int kPoints = 6;
+constexpr int kRounds = 5;
+
+// 逐位相等（0.0 和 -0.0 也要区分开）
+bool sameBits(double a, double b)
+{
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// 参照数据：每格一个角度 + 是否有数据，和存储的语义一样
+struct Reference {
+    double angle[MeasurementStore::StrokeCount][kRounds][kPoints] = {};
+    bool valid[MeasurementStore::StrokeCount][kRounds][kPoints] = {};
+    double maxAngle[kRounds] = {};
+};
+
+// 与 angleToPressureByFS 相同
+double toPressure(double angleErrDeg, double fsAngleDeg, double fsPressureMPa)
+{
+    if (fsAngleDeg <= 0.0) return 0.0;
+    return (angleErrDeg / fsAngleDeg) * fsPressureMPa;
+}
+
+// 直接录入：随机的确认读数、改角度、清单格、清整轮、改最大角度，同时更新参照数据
+void recordDirect(MeasurementStore& store, Reference& ref, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> pickPoint(0, kPoints - 1);
+    std::uniform_int_distribution<int> pickRound(0, kRounds - 1);
+    std::uniform_int_distribution<int> pickStroke(0, 1);
+    std::uniform_int_distribution<int> pickOp(0, 99);
+    std::uniform_real_distribution<double> pickAngle(0.1, 270.0);
+
+    for (int step = 0; step < 20000; ++step) {
+        const int op = pickOp(rng);
+        const int p = pickPoint(rng), r = pickRound(rng), s = pickStroke(rng);
+        if (op < 70) {
+            const double a = pickAngle(rng);
+            store.set(p, r, s, a);
+            ref.angle[s][r][p] = a;
+            ref.valid[s][r][p] = true;
+        } else if (op < 90) {
+            store.clear(p, r, s);
+            ref.angle[s][r][p] = 0.0;
+            ref.valid[s][r][p] = false;
+        } else if (op < 92) {
+            store.clearRound(r);
+            for (int st = 0; st < 2; ++st) {
+                for (int q = 0; q < kPoints; ++q) {
+                    ref.angle[st][r][q] = 0.0;
+                    ref.valid[st][r][q] = false;
+                }
+            }
+            ref.maxAngle[r] = 0.0;
+        } else {
+            // 偶尔写 0（= 没采），<=0 的最大角度不计入
+            const double a = (op < 95) ? 0.0 : pickAngle(rng);
+            store.setMaxAngle(r, a);
+            ref.maxAngle[r] = a;
+        }
+    }
+}
+
+// 回放：只把最终数据按和录入无关的顺序（倒序）写进新存储
+void replay(const Reference& ref, MeasurementStore& store)
+{
+    store.reset(kPoints, kRounds);
+    for (int s = 1; s >= 0; --s) {
+        for (int r = kRounds - 1; r >= 0; --r) {
+            for (int p = kPoints - 1; p >= 0; --p) {
+                if (ref.valid[s][r][p]) store.set(p, r, s, ref.angle[s][r][p]);
+            }
+        }
+    }
+    for (int r = kRounds - 1; r >= 0; --r) store.setMaxAngle(r, ref.maxAngle[r]);
+}
+
+void compareStores(const MeasurementStore& a, const MeasurementStore& b)
+{
+    CHECK(a.points() == b.points() && a.rounds() == b.rounds());
+    for (int s = 0; s < 2; ++s) {
+        for (int r = 0; r < kRounds; ++r) {
+            CHECK(a.count(r, s) == b.count(r, s));
+            for (int p = 0; p < kPoints; ++p) {
+                CHECK(a.valid(p, r, s) == b.valid(p, r, s));
+                CHECK(sameBits(a.angle(p, r, s), b.angle(p, r, s)));
+            }
+        }
+    }
+    for (int p = 0; p < kPoints; ++p) {
+        CHECK(a.pairCount(p) == b.pairCount(p));
+        CHECK(sameBits(a.pairMean(p), b.pairMean(p)));
+    }
+    for (int r = 0; r < kRounds; ++r) {
+        CHECK(a.roundHasData(r) == b.roundHasData(r));
+        CHECK(a.roundComplete(r) == b.roundComplete(r));
+        CHECK(a.hasMaxAngle(r) == b.hasMaxAngle(r));
+        CHECK(sameBits(a.maxAngle(r), b.maxAngle(r)));
+        CHECK(sameBits(a.averageMaxAngle(r), b.averageMaxAngle(r)));
+    }
+    CHECK(a.maxAngleCount() == b.maxAngleCount());
+    CHECK(a.allCellsHaveData() == b.allCellsHaveData());
+    CHECK(a.validCount() == b.validCount());
+}
+
+// 汇总量与逐格直接计算比较（跨轮成对平均按轮次顺序累加后除以个数）
+void compareWithReference(const MeasurementStore& store, const Reference& ref)
+{
+    int validCount = 0;
+    bool allCells = true;
+    for (int p = 0; p < kPoints; ++p) {
+        double sum = 0.0;
+        int pairs = 0;
+        for (int r = 0; r < kRounds; ++r) {
+            const bool f = ref.valid[MeasurementStore::Forward][r][p];
+            const bool b = ref.valid[MeasurementStore::Backward][r][p];
+            validCount += int(f) + int(b);
+            allCells = allCells && (f || b);
+            if (f && b) {
+                sum += (ref.angle[MeasurementStore::Forward][r][p] + ref.angle[MeasurementStore::Backward][r][p]) / 2.0;
+                ++pairs;
+            }
+        }
+        CHECK(store.pairCount(p) == pairs);
+        CHECK(sameBits(store.pairMean(p), pairs > 0 ? sum / pairs : 0.0));
+    }
+    CHECK(store.validCount() == validCount);
+    CHECK(store.allCellsHaveData() == allCells);
+
+    double maxSum = 0.0;
+    int maxCount = 0;
+    for (int r = 0; r < kRounds; ++r) {
+        if (ref.maxAngle[r] > 0.0) {
+            maxSum += ref.maxAngle[r];
+            ++maxCount;
+        }
+        CHECK(sameBits(store.averageMaxAngle(r), maxCount > 0 ? maxSum / maxCount : 0.0));
+    }
+    CHECK(store.maxAngleCount() == maxCount);
+}
+
+// 误差核与逐格直接计算比较（有数据的格子）
+void compareErrors(const MeasurementStore& store, double fsAngle)
+{
+    std::vector<double> expected(kPoints);
+    for (int p = 0; p < kPoints; ++p) expected[p] = 10.0 + 47.3 * p;
+    const double fsPressure = 25.0;
+
+    ErrorField errors;
+    computeErrors(store, expected, fsAngle, fsPressure, errors);
+    for (int r = 0; r < kRounds; ++r) {
+        for (int p = 0; p < kPoints; ++p) {
+            for (int s = 0; s < 2; ++s) {
+                if (!store.valid(p, r, s)) continue;
+                const double angleErr = store.angle(p, r, s) - expected[p];
+                CHECK(sameBits(errors.angleError(p, r, s), angleErr));
+                CHECK(sameBits(errors.pressureError(p, r, s), toPressure(angleErr, fsAngle, fsPressure)));
+            }
+            if (store.valid(p, r, MeasurementStore::Forward) && store.valid(p, r, MeasurementStore::Backward)) {
+                const double diff = std::abs(store.angle(p, r, MeasurementStore::Forward)
+                                             - store.angle(p, r, MeasurementStore::Backward));
+                CHECK(sameBits(errors.hysteresisAngleAt(p, r), diff));
+                CHECK(sameBits(errors.hysteresisPressureAt(p, r), toPressure(diff, fsAngle, fsPressure)));
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    for (unsigned seed = 1; seed <= 20; ++seed) {
+        std::mt19937 rng(seed);
+        MeasurementStore direct(kPoints, kRounds);
+        Reference ref;
+        recordDirect(direct, ref, rng);
+
+        MeasurementStore replayed;
+        replay(ref, replayed);
+
+        compareStores(direct, replayed);
+        compareWithReference(direct, ref);
+        compareErrors(direct, direct.averageMaxAngle(kRounds - 1));
+        compareErrors(direct, 0.0);   // 没有满量程角度：压力误差全为 0
+    }
+    return testResult("measurementstoretest");
+}
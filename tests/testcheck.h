@@ -0,0 +1,27 @@
+#pragma once
+#include <iostream>
+
+// 回归测试用的最小断言：失败时打印位置并计数，main 最后返回 testFailures() 是否为 0
+inline int& testFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": 检查失败: " #cond << "\n"; \
+            ++testFailures();                                                         \
+        }                                                                             \
+    } while (0)
+
+inline int testResult(const char* name)
+{
+    if (testFailures() == 0) {
+        std::cout << name << ": 通过\n";
+        return 0;
+    }
+    std::cerr << name << ": " << testFailures() << " 项失败\n";
+    return 1;
+}